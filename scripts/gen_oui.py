@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+"""
+==============================================================================
+                         PORKCHOP OUI TABLE GENERATOR
+==============================================================================
+
+    --[ 0x00 - What This Does
+
+        Builds src/core/oui_table.h, the vendor table behind OUI::getVendor():
+
+        * every IEEE MA-L assignment (tens of thousands of prefixes),
+          sorted by 24-bit prefix so the firmware can binary search it
+        * vendor names shortened ("Cisco Systems, Inc" -> "Cisco") and
+          deduplicated into one string pool; each entry stores a 24-bit
+          offset into it, so lookups hand back a pointer into flash
+
+        scripts/oui_seed.csv holds our curated short names. Any IEEE
+        organization whose seed prefixes all carry the same name gets that
+        name for all of its prefixes; if they disagree, its unseeded
+        prefixes keep the shortened IEEE name. With no IEEE data the seed
+        alone becomes the table.
+
+
+    --[ 0x01 - Usage
+
+        python scripts/gen_oui.py                 # fetch/cache IEEE, generate
+        python scripts/gen_oui.py --ieee oui.csv  # use a local registry dump
+        python scripts/gen_oui.py --offline       # seed table only
+
+        pre_build.py runs this on every pio build. The registry download is
+        cached in .pio/oui.csv, so only the first build needs the network.
+        A failed download is retried after a day. Set PORKCHOP_OUI_OFFLINE=1
+        to never touch the network.
+
+
+==[EOF]==
+"""
+
+import argparse
+import csv
+import io
+import os
+import re
+import sys
+import time
+import urllib.request
+
+IEEE_URL = "https://standards-oui.ieee.org/oui/oui.csv"
+MAX_NAME = 20  # Spectrum detail view shows 24, the client list 9
+
+# Words that say nothing about who made the thing
+NOISE = {
+    "inc", "incorporated", "co", "ltd", "limited", "corp", "corporation",
+    "corporate", "company", "gmbh", "ag", "llc", "sa", "bv", "plc", "pte",
+    "pty", "kg", "oy", "ab", "as", "srl", "spa", "kk", "nv", "sas", "the",
+    "technologies", "technology", "tech", "electronics", "electronic",
+    "international", "communications", "communication", "industrial",
+    "industries", "industry", "precision", "ind", "holdings", "holding",
+    "group", "systems", "system", "networks", "network", "devices",
+    "device", "semiconductor", "semiconductors", "products", "mobile",
+    "telecom", "digital", "information", "manufacturing", "solutions",
+    "enterprise", "enterprises", "trading", "development", "intelligent",
+}
+
+
+def short_name(org):
+    """Trim an IEEE organization name down to something that fits the UI."""
+    org = org.encode("ascii", "ignore").decode()
+    org = re.split(r"[,(]", org, 1)[0]
+    words = [w.strip(".") for w in org.split() if w.strip(".")]
+
+    kept = []
+    for w in words:
+        if kept and w.lower().strip("&-/") in NOISE:
+            break
+        kept.append(w)
+    while len(kept) > 1 and kept[-1].lower() in NOISE:
+        kept.pop()
+
+    name = ""
+    for w in kept[:3]:
+        candidate = (name + " " + w).strip()
+        if len(candidate) > MAX_NAME:
+            break
+        name = candidate
+    if not name:
+        name = (kept[0] if kept else org)[:MAX_NAME]
+    return name.replace("\\", "").replace('"', "").strip() or "?"
+
+
+def parse_prefix(text):
+    digits = re.sub(r"[^0-9A-Fa-f]", "", text)
+    if len(digits) != 6:
+        return None
+    return int(digits, 16)
+
+
+def load_seed(path):
+    seed = {}
+    with open(path, newline="") as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            prefix, name = line.split(",", 1)
+            key = parse_prefix(prefix)
+            if key is not None and key not in seed:
+                seed[key] = name.strip()
+    return seed
+
+
+def load_ieee(path):
+    ieee = {}
+    with open(path, newline="", encoding="utf-8", errors="replace") as f:
+        for row in csv.DictReader(f):
+            key = parse_prefix(row.get("Assignment", ""))
+            org = (row.get("Organization Name") or "").strip()
+            if key is not None and org:
+                ieee[key] = org
+    return ieee
+
+
+def fetch_ieee(cache):
+    """Download the MA-L registry once. Returns the cached path or None."""
+    if os.path.exists(cache) and os.path.getsize(cache) > 0:
+        return cache
+    # Don't stall every offline build on the same timeout
+    failed = cache + ".failed"
+    if os.path.exists(failed) and time.time() - os.path.getmtime(failed) < 24 * 3600:
+        return None
+    try:
+        print("[OUI] Fetching IEEE registry...")
+        req = urllib.request.Request(IEEE_URL, headers={"User-Agent": "porkchop-build"})
+        with urllib.request.urlopen(req, timeout=20) as resp:
+            data = resp.read()
+        os.makedirs(os.path.dirname(cache), exist_ok=True)
+        with open(cache, "wb") as f:
+            f.write(data)
+        return cache
+    except Exception as e:
+        print(f"[OUI] IEEE registry unavailable ({e}), using seed table only")
+        os.makedirs(os.path.dirname(cache), exist_ok=True)
+        open(failed, "w").close()
+        return None
+
+
+def build_table(seed, ieee):
+    names = {}
+    seed_by_org = {}
+    for key, name in seed.items():
+        if key in ieee:
+            seed_by_org.setdefault(ieee[key], set()).add(name)
+
+    # Only spread a seed name the org's seed prefixes all agree on; a
+    # mismatch is a seed typo or a shared registry name, and either way
+    # the registry knows better
+    disputed = sorted(org for org, found in seed_by_org.items() if len(found) > 1)
+    if disputed:
+        print(f"[OUI] Seed names disagree for {len(disputed)} organizations, "
+              f"using IEEE names: {', '.join(disputed[:5])}")
+
+    for key, org in ieee.items():
+        found = seed_by_org.get(org, ())
+        names[key] = next(iter(found)) if len(found) == 1 else short_name(org)
+    for key, name in seed.items():
+        names[key] = name  # Seed always wins for its own prefixes
+
+    entries = sorted(names.items())
+    pool = bytearray()
+    offsets = {}
+    for _, name in entries:
+        if name not in offsets:
+            offsets[name] = len(pool)
+            pool += name.encode("ascii") + b"\0"
+    if len(pool) >= 1 << 24:
+        sys.exit("[OUI] String pool exceeds 24-bit offsets")
+    return entries, offsets, len(pool)
+
+
+def render(entries, offsets, pool_size, source):
+    out = io.StringIO()
+    out.write("// Auto-generated by scripts/gen_oui.py - do not edit\n")
+    out.write(f"// {len(entries)} prefixes, {len(offsets)} vendor names ({source})\n")
+    out.write("#pragma once\n\n#include <stdint.h>\n\n")
+    out.write(f"#define OUI_TABLE_ENTRIES {len(entries)}\n")
+    out.write(f'#define OUI_TABLE_SOURCE "{source}"\n\n')
+
+    def rows(values, per_line):
+        for i in range(0, len(values), per_line):
+            out.write("    " + " ".join(values[i:i + per_line]) + "\n")
+
+    out.write("// Sorted 24-bit prefixes\n")
+    out.write("static const uint8_t OUI_PREFIXES[OUI_TABLE_ENTRIES][3] = {\n")
+    rows(["{0x%02X,0x%02X,0x%02X}," % (k >> 16, (k >> 8) & 0xFF, k & 0xFF)
+          for k, _ in entries], 6)
+    out.write("};\n\n")
+
+    out.write("// Offset of each prefix's vendor in OUI_NAMES (little-endian 24-bit)\n")
+    out.write("static const uint8_t OUI_NAME_OFFSETS[OUI_TABLE_ENTRIES][3] = {\n")
+    rows(["{0x%02X,0x%02X,0x%02X}," % (o & 0xFF, (o >> 8) & 0xFF, o >> 16)
+          for o in (offsets[name] for _, name in entries)], 6)
+    out.write("};\n\n")
+
+    out.write(f"// Deduplicated vendor names, NUL-separated ({pool_size} bytes)\n")
+    out.write("static const char OUI_NAMES[] =\n")
+    pool_names = sorted(offsets, key=offsets.get)
+    line = "   "
+    for name in pool_names:
+        lit = ' "%s\\0"' % name
+        if len(line) + len(lit) > 96:
+            out.write(line + "\n")
+            line = "   "
+        line += lit
+    out.write(line + ";\n")
+    return out.getvalue()
+
+
+def generate(project_dir, ieee_path=None, offline=False, output=None):
+    seed = load_seed(os.path.join(project_dir, "scripts", "oui_seed.csv"))
+    offline = offline or os.environ.get("PORKCHOP_OUI_OFFLINE") == "1"
+    if not ieee_path and not offline:
+        ieee_path = fetch_ieee(os.path.join(project_dir, ".pio", "oui.csv"))
+    ieee = load_ieee(ieee_path) if ieee_path else {}
+
+    entries, offsets, pool_size = build_table(seed, ieee)
+    text = render(entries, offsets, pool_size, "ieee+seed" if ieee else "seed")
+
+    output = output or os.path.join(project_dir, "src", "core", "oui_table.h")
+    # Only touch the file when it changes, so builds stay incremental
+    if os.path.exists(output):
+        with open(output) as f:
+            if f.read() == text:
+                return output
+    with open(output, "w") as f:
+        f.write(text)
+    print(f"[OUI] Wrote {output}: {len(entries)} prefixes, {len(offsets)} names, "
+          f"{len(entries) * 6 + pool_size} bytes")
+    return output
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Generate src/core/oui_table.h")
+    parser.add_argument("--ieee", help="local copy of the IEEE MA-L oui.csv")
+    parser.add_argument("--offline", action="store_true", help="seed table only")
+    parser.add_argument("-o", "--output", help="output header path")
+    args = parser.parse_args()
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    generate(root, args.ieee, args.offline, args.output)
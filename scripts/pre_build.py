@@ -1,11 +1,18 @@
 # Porkchop pre-build script
-# Ensures model files exist and generates version info
+# Ensures model files exist and generates version info and the OUI table
 
 Import("env")
 import os
+import sys
 import subprocess
 from datetime import datetime
 
+# OUI vendor table has to exist before anything compiles, so generate it
+# now rather than in a pre-action (scripts/gen_oui.py)
+sys.path.insert(0, os.path.join(env.subst("$PROJECT_DIR"), "scripts"))
+import gen_oui
+gen_oui.generate(env.subst("$PROJECT_DIR"))
+
 def get_git_commit():
     """Get short git commit hash, or 'unknown' if not in a git repo"""
     try:
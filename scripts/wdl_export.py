@@ -0,0 +1,269 @@
+#!/usr/bin/env python3
+"""
+==============================================================================
+                         PORKCHOP WARDRIVE LOG EXPORTER
+==============================================================================
+
+    --[ 0x00 - What This Does
+
+        Warhog logs each session as one binary file,
+        /wardriving/warhog_<time>.wdl (format: src/core/wardrive_format.h).
+        This renders it on a computer as the text files Warhog used to write:
+
+        * wigle  - WiGLE CSV v1.6, ready for wigle.net
+        * csv    - internal CSV (BSSID,SSID,RSSI,...,Timestamp)
+        * ml     - ML training CSV for scripts/prepare_ml_data.py
+
+        Rows are byte-for-byte what the firmware's WardriveLog exporter
+        produces. ML rows carry FeatureExtractor::toFeatureVector() as the
+        device computes it: float32 values, no normalization (the firmware
+        never loads any). test/scripts/test_wdl_export.py checks all three
+        formats against rows the firmware code wrote from the same log.
+
+        A torn last record (power lost mid-write) is ignored.
+
+
+    --[ 0x01 - Usage
+
+        python scripts/wdl_export.py warhog_X.wdl              # all three
+        python scripts/wdl_export.py warhog_X.wdl -f wigle     # just one
+        python scripts/wdl_export.py *.wdl -d out/             # many logs
+
+        Outputs land next to each log (or in -d) as warhog_X.wigle.csv,
+        warhog_X.csv and ml_training_X.ml.csv.
+
+
+==[EOF]==
+"""
+
+import argparse
+import datetime
+import os
+import struct
+import sys
+
+WDL_MAGIC = 0x474C4457
+WDL_VERSION = 1
+
+REC_SSID = 1
+REC_OBS = 2
+REC_FEATURES = 3
+
+OBS_GPS = 0x01
+OBS_FEATURES = 0x02
+
+FEAT_WPS, FEAT_WPA, FEAT_WPA2, FEAT_WPA3, FEAT_HIDDEN, FEAT_PROBE = (1 << i for i in range(6))
+
+ML_VALUES = 32
+
+# Little-endian mirrors of the structs in wardrive_format.h
+HEADER = struct.Struct("<IHH16s")
+SSID = struct.Struct("<BBH")
+OBS = struct.Struct("<BB6sHbBiiiIIHBB")
+FEATURES = struct.Struct("<BBbBHHIHHfffBBBBbB2x")
+FLOAT32 = struct.Struct("<f")
+
+CSV_HEADER = "BSSID,SSID,RSSI,Channel,AuthMode,Latitude,Longitude,Altitude,Timestamp\r\n"
+
+ML_HEADER = (
+    "bssid,ssid,"
+    "rssi,noise,snr,channel,secondary_ch,beacon_interval,"
+    "capability_lo,capability_hi,has_wps,has_wpa,has_wpa2,has_wpa3,"
+    "is_hidden,response_time,beacon_count,beacon_jitter,"
+    "responds_probe,probe_response_time,vendor_ie_count,"
+    "supported_rates,ht_cap,vht_cap,anomaly_score,"
+    "f23,f24,f25,f26,f27,f28,f29,f30,f31,"
+    "label,latitude,longitude\r\n"
+)
+
+WIGLE_COLUMNS = (
+    "MAC,SSID,AuthMode,FirstSeen,Channel,Frequency,RSSI,CurrentLatitude,"
+    "CurrentLongitude,AltitudeMeters,AccuracyMeters,RCOIs,MfgrId,Type\r\n"
+)
+
+# Indexed by wifi_auth_mode_t
+AUTH_NAMES = ["OPEN", "WEP", "WPA", "WPA2", "WPA/WPA2", "UNKNOWN", "WPA3", "WPA2/WPA3", "WAPI"]
+AUTH_WIGLE = [
+    "[ESS]", "[WEP][ESS]", "[WPA-PSK-CCMP][ESS]", "[WPA2-PSK-CCMP][ESS]",
+    "[WPA-PSK-CCMP+TKIP][WPA2-PSK-CCMP+TKIP][ESS]", "[ESS]", "[WPA3-SAE][ESS]",
+    "[WPA2-PSK-CCMP][WPA3-SAE][ESS]", "[WAPI-PSK][ESS]",
+]
+
+
+class Observation:
+    def __init__(self, data):
+        (_, self.flags, self.bssid, self.ssid_id, self.rssi, self.channel, self.lat,
+         self.lon, self.alt_dm, self.time, self.uptime_ms, self.accuracy_dm,
+         self.auth, self.label) = OBS.unpack(data)
+
+
+def read_log(path):
+    """(appRelease, records); each record is ('ssid'|'obs'|'features', ...)"""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if len(data) < HEADER.size:
+        raise ValueError(f"{path}: too short for a header")
+    magic, version, header_size, release = HEADER.unpack_from(data)
+    if magic != WDL_MAGIC or version != WDL_VERSION or header_size < HEADER.size:
+        raise ValueError(f"{path}: not a v{WDL_VERSION} wardrive log")
+    release = release.split(b"\0", 1)[0].decode("ascii", "replace")
+
+    records = []
+    pos = header_size
+    while pos < len(data):
+        kind = data[pos]
+        if kind == REC_SSID and pos + SSID.size <= len(data):
+            _, length, ssid_id = SSID.unpack_from(data, pos)
+            end = pos + SSID.size + length
+            if length > 32 or end > len(data):
+                break
+            records.append(("ssid", ssid_id, data[pos + SSID.size:end]))
+            pos = end
+        elif kind == REC_OBS and pos + OBS.size <= len(data):
+            records.append(("obs", Observation(data[pos:pos + OBS.size])))
+            pos += OBS.size
+        elif kind == REC_FEATURES and pos + FEATURES.size <= len(data):
+            records.append(("features", FEATURES.unpack_from(data, pos)))
+            pos += FEATURES.size
+        else:
+            break  # Torn or corrupt tail
+    if pos < len(data):
+        print(f"[WDL] {path}: ignored {len(data) - pos} bytes of torn tail", file=sys.stderr)
+    return release, records
+
+
+def csv_field(ssid):
+    """Quoted SSID, internal quotes doubled, control chars stripped"""
+    out = bytearray(b'"')
+    for b in ssid[:32]:
+        if b == ord('"'):
+            out += b'""'
+        elif b >= 32:
+            out.append(b)
+    out += b'"'
+    return bytes(out)
+
+
+def prefix(o, ssid):
+    return ("%02X:%02X:%02X:%02X:%02X:%02X," % tuple(o.bssid)).encode() + csv_field(ssid)
+
+
+def wigle_row(o, ssid):
+    if o.time > 0:
+        when = datetime.datetime.fromtimestamp(o.time, datetime.timezone.utc).strftime("%Y-%m-%d %H:%M:%S")
+    else:
+        when = "1970-01-01 00:00:%02u" % ((o.uptime_ms // 1000) % 60)
+    freq = 2484 if o.channel == 14 else 2412 + (o.channel - 1) * 5
+    auth = AUTH_WIGLE[o.auth] if o.auth < len(AUTH_WIGLE) else "[ESS]"
+    accuracy = o.accuracy_dm / 10.0 if o.accuracy_dm > 0 else 10.0
+    return prefix(o, ssid) + (",%s,%s,%d,%d,%d,%.6f,%.6f,%.1f,%.1f,,,WIFI\r\n" % (
+        auth, when, o.channel, freq, o.rssi, o.lat / 1e7, o.lon / 1e7, o.alt_dm / 10.0, accuracy)).encode()
+
+
+def csv_row(o, ssid):
+    auth = AUTH_NAMES[o.auth] if o.auth < len(AUTH_NAMES) else "UNKNOWN"
+    return prefix(o, ssid) + (",%d,%d,%s,%.6f,%.6f,%.1f,%u\n" % (
+        o.rssi, o.channel, auth, o.lat / 1e7, o.lon / 1e7, o.alt_dm / 10.0, o.uptime_ms)).encode()
+
+
+def float32(v):
+    """v as the device's float holds it (response times past 2^24 round)"""
+    return FLOAT32.unpack(FLOAT32.pack(v))[0]
+
+
+def feature_vector(f):
+    """FeatureExtractor::toFeatureVector() without normalization"""
+    (_, bits, noise, secondary, interval, capability, response_time, beacon_count,
+     probe_time, snr, jitter, anomaly, vendor_ies, rates, ht, vht, rssi, channel) = f
+    values = [
+        rssi, noise, snr, channel, secondary, interval,
+        capability & 0xFF, (capability >> 8) & 0xFF,
+        1 if bits & FEAT_WPS else 0, 1 if bits & FEAT_WPA else 0,
+        1 if bits & FEAT_WPA2 else 0, 1 if bits & FEAT_WPA3 else 0,
+        1 if bits & FEAT_HIDDEN else 0, response_time, beacon_count, jitter,
+        1 if bits & FEAT_PROBE else 0, probe_time, vendor_ies, rates, ht, vht, anomaly,
+    ]
+    return [float32(v) for v in values] + [0.0] * (ML_VALUES - len(values))
+
+
+def ml_row(o, ssid, features):
+    gps = o.flags & OBS_GPS
+    values = "".join(",%.4f" % v for v in feature_vector(features))
+    return prefix(o, ssid) + (values + ",%d,%.6f,%.6f\n" % (
+        o.label, o.lat / 1e7 if gps else 0.0, o.lon / 1e7 if gps else 0.0)).encode()
+
+
+def export(release, records, fmt):
+    if fmt == "wigle":
+        out = [("WigleWifi-1.6,appRelease=%s,model=M5Cardputer,release=ESP32-S3,device=PORKCHOP,"
+                "display=240x135,board=m5stack,brand=M5Stack,star=Sol,body=3,subBody=0\n%s"
+                % (release or "0.1.x", WIGLE_COLUMNS)).encode()]
+    else:
+        out = [(CSV_HEADER if fmt == "csv" else ML_HEADER).encode()]
+
+    ssids = {}
+    pending = None
+    rows = 0
+    for rec in records:
+        if rec[0] == "ssid":
+            ssids[rec[1]] = rec[2]  # Later definitions replace earlier ones
+        elif rec[0] == "obs":
+            o = rec[1]
+            pending = None
+            if fmt == "ml":
+                pending = o if o.flags & OBS_FEATURES else None
+            elif o.flags & OBS_GPS:
+                ssid = ssids.get(o.ssid_id, b"") if o.ssid_id else b""
+                out.append(wigle_row(o, ssid) if fmt == "wigle" else csv_row(o, ssid))
+                rows += 1
+        elif rec[0] == "features" and pending is not None:
+            ssid = ssids.get(pending.ssid_id, b"") if pending.ssid_id else b""
+            out.append(ml_row(pending, ssid, rec[1]))
+            rows += 1
+            pending = None
+    return b"".join(out), rows
+
+
+def output_path(log_path, fmt, out_dir):
+    directory, name = os.path.split(log_path)
+    stem = os.path.splitext(name)[0]
+    if fmt == "wigle":
+        name = stem + ".wigle.csv"
+    elif fmt == "csv":
+        name = stem + ".csv"
+    else:
+        name = stem.replace("warhog_", "ml_training_", 1) + ".ml.csv"
+    return os.path.join(out_dir or directory, name)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export Warhog .wdl logs as CSV")
+    parser.add_argument("logs", nargs="+", help=".wdl files")
+    parser.add_argument("-f", "--format", choices=["wigle", "csv", "ml", "all"], default="all")
+    parser.add_argument("-d", "--dir", help="output directory (default: next to each log)")
+    args = parser.parse_args()
+
+    formats = ["wigle", "csv", "ml"] if args.format == "all" else [args.format]
+    if args.dir:
+        os.makedirs(args.dir, exist_ok=True)
+
+    failed = 0
+    for log in args.logs:
+        try:
+            release, records = read_log(log)
+        except (OSError, ValueError) as e:
+            print(f"[WDL] {e}", file=sys.stderr)
+            failed += 1
+            continue
+        for fmt in formats:
+            text, rows = export(release, records, fmt)
+            path = output_path(log, fmt, args.dir)
+            with open(path, "wb") as f:
+                f.write(text)
+            print(f"[WDL] {path}: {rows} rows")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,203 @@
+// Beacon View - single-pass, bounds-checked 802.11 IE parser
+// Beacons and probe responses are walked once; every consumer (OINK, DNH,
+// Spectrum, FeatureExtractor) reads the parsed fields instead of re-walking.
+// Zero-copy: SSID/RSN pointers reference the frame, so the view is only
+// valid while the frame buffer is.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// 802.11 management frame layout
+static const uint16_t BEACON_BSSID_OFFSET = 16;
+static const uint16_t BEACON_INTERVAL_OFFSET = 32;
+static const uint16_t BEACON_CAPABILITY_OFFSET = 34;
+static const uint16_t BEACON_IE_OFFSET = 36;  // 24 header + 8 timestamp + 2 interval + 2 capability
+
+// Element IDs we care about
+enum : uint8_t {
+    IE_SSID = 0,
+    IE_SUPPORTED_RATES = 1,
+    IE_DS_PARAMS = 3,
+    IE_HT_CAPS = 45,
+    IE_RSN = 48,
+    IE_EXT_RATES = 50,
+    IE_VHT_CAPS = 191,
+    IE_VENDOR = 221
+};
+
+// RSN AKM suites seen (bitmask, 00-0F-AC:n)
+enum : uint16_t {
+    AKM_8021X     = 1 << 0,   // 1
+    AKM_PSK       = 1 << 1,   // 2
+    AKM_FT_8021X  = 1 << 2,   // 3
+    AKM_FT_PSK    = 1 << 3,   // 4
+    AKM_PSK_256   = 1 << 5,   // 6
+    AKM_SAE       = 1 << 7,   // 8
+    AKM_FT_SAE    = 1 << 8,   // 9
+    AKM_OWE       = 1 << 13,  // 18
+    AKM_OTHER     = 1 << 15
+};
+
+// Walks (id, len, data) triples; stops at the first truncated element
+class IEIterator {
+public:
+    IEIterator(const uint8_t* ies, uint16_t len) : p(ies), end(ies + len) {}
+
+    bool next(uint8_t& id, uint8_t& len, const uint8_t*& data) {
+        if (end - p < 2) return false;
+        uint8_t l = p[1];
+        if (end - p - 2 < l) return false;  // Truncated element
+        id = p[0];
+        len = l;
+        data = p + 2;
+        p += 2 + l;
+        return true;
+    }
+
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+};
+
+struct BeaconView {
+    const uint8_t* bssid;
+    uint16_t beaconInterval;
+    uint16_t capability;
+
+    // SSID IE (points into the frame)
+    const uint8_t* ssid;
+    uint8_t ssidLen;
+    bool hasSSIDIE;
+    bool isHidden;        // Zero-length or all-null SSID
+
+    uint8_t dsChannel;    // 0 = no DS Parameter Set IE
+
+    // RSN IE (WPA2/WPA3)
+    bool hasRSN;
+    bool rsnCapsPresent;
+    uint16_t rsnCaps;
+    uint16_t akmMask;
+    bool pmfCapable;      // MFPC
+    bool pmfRequired;     // MFPR - deauth won't work
+
+    // Vendor IEs
+    bool hasWPA;          // 00:50:F2:01
+    bool hasWPS;          // 00:50:F2:04
+    uint8_t vendorIECount;
+
+    uint8_t supportedRates;  // Rate count incl. extended rates
+    bool hasHT;
+    bool hasVHT;
+
+    // Parse a beacon/probe response. Returns false if too short to be one.
+    bool parse(const uint8_t* frame, uint16_t len) {
+        memset(this, 0, sizeof(*this));
+        if (len < BEACON_IE_OFFSET) return false;
+
+        bssid = frame + BEACON_BSSID_OFFSET;
+        beaconInterval = frame[BEACON_INTERVAL_OFFSET] | (frame[BEACON_INTERVAL_OFFSET + 1] << 8);
+        capability = frame[BEACON_CAPABILITY_OFFSET] | (frame[BEACON_CAPABILITY_OFFSET + 1] << 8);
+
+        IEIterator it(frame + BEACON_IE_OFFSET, len - BEACON_IE_OFFSET);
+        uint8_t id, ieLen;
+        const uint8_t* data;
+        while (it.next(id, ieLen, data)) {
+            switch (id) {
+                case IE_SSID:
+                    if (hasSSIDIE) break;  // First SSID IE wins
+                    hasSSIDIE = true;
+                    if (ieLen == 0) {
+                        isHidden = true;
+                    } else if (ieLen <= 32) {
+                        ssid = data;
+                        ssidLen = ieLen;
+                        isHidden = true;
+                        for (uint8_t i = 0; i < ieLen; i++) {
+                            if (data[i] != 0) { isHidden = false; break; }
+                        }
+                    }
+                    // > 32 bytes is malformed, ignore
+                    break;
+
+                case IE_SUPPORTED_RATES:
+                case IE_EXT_RATES:
+                    supportedRates += ieLen;
+                    break;
+
+                case IE_DS_PARAMS:
+                    if (ieLen >= 1 && dsChannel == 0) dsChannel = data[0];
+                    break;
+
+                case IE_HT_CAPS:
+                    hasHT = true;
+                    break;
+
+                case IE_VHT_CAPS:
+                    hasVHT = true;
+                    break;
+
+                case IE_RSN:
+                    if (ieLen >= 2) {
+                        hasRSN = true;
+                        parseRSN(data, ieLen);
+                    }
+                    break;
+
+                case IE_VENDOR:
+                    vendorIECount++;
+                    if (ieLen >= 4 && data[0] == 0x00 && data[1] == 0x50 && data[2] == 0xF2) {
+                        if (data[3] == 0x01) hasWPA = true;
+                        else if (data[3] == 0x04) hasWPS = true;
+                    }
+                    break;
+            }
+        }
+        return true;
+    }
+
+    // Copy SSID as a C string (empty for hidden/missing)
+    void copySSID(char* out) const {
+        if (ssid && !isHidden) {
+            memcpy(out, ssid, ssidLen);
+            out[ssidLen] = 0;
+        } else {
+            out[0] = 0;
+        }
+    }
+
+    bool hasSAE() const { return (akmMask & (AKM_SAE | AKM_FT_SAE)) != 0; }
+    bool hasPSK() const { return (akmMask & (AKM_PSK | AKM_FT_PSK | AKM_PSK_256)) != 0; }
+
+private:
+    // version(2) group(4) pairwise count(2)+n*4 AKM count(2)+n*4 caps(2)
+    void parseRSN(const uint8_t* rsn, uint8_t len) {
+        uint32_t off = 2 + 4;  // 32-bit: counts come off the air
+        if (off + 2 > len) return;
+        uint16_t pairwiseCount = rsn[off] | (rsn[off + 1] << 8);
+        off += 2 + pairwiseCount * 4;
+        if (off + 2 > len) return;
+
+        uint16_t akmCount = rsn[off] | (rsn[off + 1] << 8);
+        off += 2;
+        for (uint16_t i = 0; i < akmCount; i++, off += 4) {
+            if (off + 4 > len) return;
+            const uint8_t* s = rsn + off;
+            if (s[0] == 0x00 && s[1] == 0x0F && s[2] == 0xAC) {
+                uint8_t t = s[3];
+                if (t == 18) akmMask |= AKM_OWE;
+                else if (t >= 1 && t <= 9) akmMask |= (uint16_t)(1 << (t - 1));
+                else akmMask |= AKM_OTHER;
+            } else {
+                akmMask |= AKM_OTHER;
+            }
+        }
+        if (off + 2 > len) return;
+
+        rsnCapsPresent = true;
+        rsnCaps = rsn[off] | (rsn[off + 1] << 8);
+        pmfCapable = (rsnCaps >> 6) & 0x01;
+        pmfRequired = (rsnCaps >> 7) & 0x01;
+    }
+};
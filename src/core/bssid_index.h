@@ -0,0 +1,89 @@
+// BSSID Index - open-addressing hash index over a network table
+// Maps a BSSID to its position in a vector of structs carrying `uint8_t bssid[6]`.
+// Slots only hold (position + 1); the key is read back from the table itself,
+// so the index costs 2 bytes per slot and can never disagree on the BSSID.
+// Positions shift on erase/sort - call rebuild() after reordering the table.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+template <size_t SLOTS>
+class BssidIndex {
+    static_assert(SLOTS >= 16 && (SLOTS & (SLOTS - 1)) == 0, "BssidIndex slots must be a power of two");
+    static_assert(SLOTS <= 32768, "BssidIndex positions are 16-bit");
+
+public:
+    BssidIndex() { clear(); }
+
+    // Same packing as OinkMode::bssidToUint64 (big-endian 48-bit)
+    static uint64_t key(const uint8_t* bssid) {
+        uint64_t k = 0;
+        for (int i = 0; i < 6; i++) {
+            k = (k << 8) | bssid[i];
+        }
+        return k;
+    }
+
+    void clear() {
+        memset(slots, 0, sizeof(slots));
+        used = 0;
+    }
+
+    // Position of bssid in table, or -1
+    template <typename T>
+    int find(const uint8_t* bssid, const T* table, size_t count) const {
+        size_t s = home(bssid);
+        for (size_t probes = 0; probes < SLOTS; probes++) {
+            uint16_t v = slots[s];
+            if (v == 0) return -1;
+            size_t pos = v - 1;
+            if (pos < count && memcmp(table[pos].bssid, bssid, 6) == 0) {
+                return (int)pos;
+            }
+            s = (s + 1) & (SLOTS - 1);
+        }
+        return -1;
+    }
+
+    // Record a newly appended entry. Caller must have checked find() first.
+    // Refuses past 75% load so probe chains stay short.
+    bool insert(const uint8_t* bssid, size_t pos) {
+        if (used >= MAX_LOAD || pos >= SLOTS) return false;
+        size_t s = home(bssid);
+        while (slots[s] != 0) {
+            s = (s + 1) & (SLOTS - 1);
+        }
+        slots[s] = (uint16_t)(pos + 1);
+        used++;
+        return true;
+    }
+
+    // Re-index the whole table (after erase or sort shifted positions)
+    template <typename T>
+    void rebuild(const T* table, size_t count) {
+        clear();
+        for (size_t i = 0; i < count; i++) {
+            if (!insert(table[i].bssid, i)) break;
+        }
+    }
+
+    size_t size() const { return used; }
+    static constexpr size_t capacity() { return MAX_LOAD; }
+
+private:
+    static constexpr size_t MAX_LOAD = SLOTS * 3 / 4;
+
+    static constexpr uint32_t bits(size_t n) { return n <= 1 ? 0 : 1 + bits(n >> 1); }
+
+    // Fibonacci hash of the folded 48-bit key (vendor OUI alone is a bad hash)
+    static size_t home(const uint8_t* bssid) {
+        uint64_t k = key(bssid);
+        uint32_t h = (uint32_t)k ^ (uint32_t)(k >> 24);
+        return (size_t)((h * 0x9E3779B1u) >> (32 - bits(SLOTS)));
+    }
+
+    uint16_t slots[SLOTS];
+    uint16_t used;
+};
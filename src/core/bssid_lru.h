@@ -0,0 +1,200 @@
+// BSSID LRU - fixed-capacity BSSID -> value table with per-entry aging
+// Open addressing (linear probing) over one calloc'd slot array, sized once
+// by init(). Nothing allocates after that, so it is safe to update from the
+// promiscuous callback (under the caller's lock). At 3/4 load the stalest
+// entry in a rotating window of slots is evicted - sampled LRU, O(1) per
+// insert - and expire() drops whatever hasn't been seen for a while.
+// Removal uses backward-shift deletion, so there are no tombstones.
+// Not thread-safe on its own.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+template <typename V>
+class BssidLru {
+public:
+    BssidLru() : slots(nullptr), slotCount(0), shift(32), used(0), hand(0), evicted(0) {}
+    ~BssidLru() { release(); }
+    BssidLru(const BssidLru&) = delete;
+    BssidLru& operator=(const BssidLru&) = delete;
+
+    // Same packing as bssidToKey() (big-endian 48-bit)
+    static uint64_t key(const uint8_t* bssid) {
+        uint64_t k = 0;
+        for (int i = 0; i < 6; i++) {
+            k = (k << 8) | bssid[i];
+        }
+        return k;
+    }
+
+    // slotCount: power of two >= 16. Holds up to 3/4 of that.
+    bool init(size_t count) {
+        release();
+        if (count < 16 || (count & (count - 1)) != 0) return false;
+        slots = (Slot*)calloc(count, sizeof(Slot));
+        if (!slots) return false;
+        slotCount = count;
+        shift = 32;
+        while (count > 1) {
+            count >>= 1;
+            shift--;
+        }
+        return true;
+    }
+
+    void release() {
+        free(slots);
+        slots = nullptr;
+        slotCount = 0;
+        used = 0;
+        hand = 0;
+    }
+
+    void clear() {
+        if (slots) memset(slots, 0, slotCount * sizeof(Slot));
+        used = 0;
+        hand = 0;
+    }
+
+    // Value for k, or nullptr. Doesn't count as a use.
+    V* find(uint64_t k) {
+        if (!slots) return nullptr;
+        size_t s = home(k);
+        while (slots[s].tag != 0) {
+            if (slots[s].tag == k + 1) return &slots[s].value;
+            s = (s + 1) & (slotCount - 1);
+        }
+        return nullptr;
+    }
+
+    // Value for k, stamped as used at `now`. A new entry (isNew) is
+    // zeroed for the caller to fill; one stale entry makes room if needed.
+    // nullptr only before init().
+    V* touch(uint64_t k, uint32_t now, bool& isNew) {
+        isNew = false;
+        if (!slots) return nullptr;
+
+        size_t s = home(k);
+        while (slots[s].tag != 0) {
+            if (slots[s].tag == k + 1) {
+                slots[s].lastSeen = now;
+                return &slots[s].value;
+            }
+            s = (s + 1) & (slotCount - 1);
+        }
+
+        if (used >= maxLoad()) {
+            eraseAt(stalest(now));
+            evicted++;
+            // The shift may have moved things into our chain: probe again
+            s = home(k);
+            while (slots[s].tag != 0) {
+                s = (s + 1) & (slotCount - 1);
+            }
+        }
+
+        memset(&slots[s].value, 0, sizeof(V));
+        slots[s].tag = k + 1;
+        slots[s].lastSeen = now;
+        used++;
+        isNew = true;
+        return &slots[s].value;
+    }
+
+    bool erase(uint64_t k) {
+        if (!slots) return false;
+        size_t s = home(k);
+        while (slots[s].tag != 0) {
+            if (slots[s].tag == k + 1) {
+                eraseAt(s);
+                return true;
+            }
+            s = (s + 1) & (slotCount - 1);
+        }
+        return false;
+    }
+
+    // Drop entries not seen in the last maxAge ms. Returns how many.
+    size_t expire(uint32_t now, uint32_t maxAge) {
+        size_t dropped = 0;
+        for (size_t s = 0; s < slotCount; ) {
+            if (slots[s].tag != 0 && now - slots[s].lastSeen > maxAge) {
+                eraseAt(s);  // Next entry may have shifted into s: look again
+                dropped++;
+            } else {
+                s++;
+            }
+        }
+        return dropped;
+    }
+
+    size_t size() const { return used; }
+    size_t capacity() const { return maxLoad(); }
+    uint32_t evictions() const { return evicted; }
+    size_t memoryBytes() const { return slotCount * sizeof(Slot); }
+
+private:
+    static const size_t WINDOW = 16;  // Slots sampled per eviction
+
+    struct Slot {
+        uint64_t tag;       // key + 1, 0 = empty
+        uint32_t lastSeen;
+        V value;
+    };
+
+    Slot* slots;
+    size_t slotCount;
+    uint8_t shift;          // 32 - log2(slotCount)
+    size_t used;
+    size_t hand;            // Where the next eviction window starts
+    uint32_t evicted;
+
+    size_t maxLoad() const { return slotCount / 4 * 3; }
+
+    // Fibonacci hash of the folded 48-bit key (vendor OUI alone is a bad hash)
+    size_t home(uint64_t k) const {
+        uint32_t h = (uint32_t)k ^ (uint32_t)(k >> 24);
+        return (size_t)((h * 0x9E3779B1u) >> shift);
+    }
+
+    // Least recently used occupied slot in the next window (which reads on
+    // past WINDOW if it happens to be empty). The hand moves on so every
+    // part of the table gets its turn.
+    size_t stalest(uint32_t now) {
+        size_t best = slotCount;
+        uint32_t bestAge = 0;
+        for (size_t n = 0; n < slotCount && (n < WINDOW || best == slotCount); n++) {
+            size_t s = (hand + n) & (slotCount - 1);
+            if (slots[s].tag == 0) continue;
+            uint32_t age = now - slots[s].lastSeen;
+            if (best == slotCount || age > bestAge) {
+                best = s;
+                bestAge = age;
+            }
+        }
+        hand = (hand + WINDOW) & (slotCount - 1);
+        return best;
+    }
+
+    // Backward-shift delete: pull later members of the cluster into the
+    // hole when that doesn't move them before their home slot
+    void eraseAt(size_t hole) {
+        size_t s = hole;
+        for (;;) {
+            s = (s + 1) & (slotCount - 1);
+            if (slots[s].tag == 0) break;
+            size_t h = home(slots[s].tag - 1);
+            // Movable unless h lies cyclically in (hole, s]
+            bool stays = hole <= s ? (h > hole && h <= s) : (h > hole || h <= s);
+            if (!stays) {
+                slots[hole] = slots[s];
+                hole = s;
+            }
+        }
+        slots[hole].tag = 0;
+        used--;
+    }
+};
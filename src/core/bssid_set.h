@@ -0,0 +1,160 @@
+// BSSID Set - compact "seen before?" set for long wardriving sessions
+// BSSIDs are stored as raw 6-byte big-endian keys, so memcmp order is
+// numeric order and the same sorted layout works in RAM and on SD. A bloom
+// filter sits in front: most new APs are rejected by one bit test without
+// touching the sorted keys (or the SD checkpoint behind them, BssidStore).
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+// SD checkpoint: header, then `count` sorted unique 6-byte keys
+static const uint32_t BSSID_STORE_MAGIC = 0x4E455353;  // "SSEN"
+static const uint16_t BSSID_STORE_VERSION = 1;
+static const uint16_t BSSID_KEY_BYTES = 6;
+static const uint16_t BSSID_BLOCK_KEYS = 170;  // Keys per SD lookup read (1020 bytes)
+static const uint8_t BSSID_BLOOM_HASHES = 3;
+
+struct BssidStoreHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t keySize;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+// First position in `keys` (n sorted 6-byte keys) not less than bssid
+inline uint32_t bssidLowerBound(const uint8_t* keys, uint32_t n, const uint8_t* bssid) {
+    uint32_t lo = 0, hi = n;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (memcmp(keys + mid * BSSID_KEY_BYTES, bssid, BSSID_KEY_BYTES) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+inline bool bssidSortedContains(const uint8_t* keys, uint32_t n, const uint8_t* bssid) {
+    uint32_t pos = bssidLowerBound(keys, n, bssid);
+    return pos < n && memcmp(keys + pos * BSSID_KEY_BYTES, bssid, BSSID_KEY_BYTES) == 0;
+}
+
+class BssidSet {
+public:
+    BssidSet() : keys(nullptr), cap(0), count(0), bloom(nullptr), bloomMask(0) {}
+    ~BssidSet() { release(); }
+    BssidSet(const BssidSet&) = delete;
+    BssidSet& operator=(const BssidSet&) = delete;
+
+    // capacity: sorted keys held in RAM (6 bytes each). bloomBytes must be
+    // a power of two; size it for every key the set will ever see,
+    // including ones that only live on SD.
+    bool init(uint32_t capacity, uint32_t bloomBytes) {
+        release();
+        if (capacity == 0 || bloomBytes < 8 || (bloomBytes & (bloomBytes - 1)) != 0) return false;
+        keys = (uint8_t*)malloc((size_t)capacity * BSSID_KEY_BYTES);
+        bloom = (uint8_t*)malloc(bloomBytes);
+        if (!keys || !bloom) {
+            release();
+            return false;
+        }
+        cap = capacity;
+        bloomMask = bloomBytes * 8 - 1;
+        clearAll();
+        return true;
+    }
+
+    void release() {
+        free(keys);
+        free(bloom);
+        keys = nullptr;
+        bloom = nullptr;
+        cap = 0;
+        count = 0;
+        bloomMask = 0;
+    }
+
+    // Drop the sorted keys but remember them in the bloom filter (they
+    // have just been written to SD)
+    void clear() { count = 0; }
+
+    void clearAll() {
+        count = 0;
+        if (bloom) memset(bloom, 0, bloomMask / 8 + 1);
+    }
+
+    void bloomAdd(const uint8_t* bssid) {
+        uint32_t h1, h2;
+        hash(bssid, h1, h2);
+        for (uint8_t i = 0; i < BSSID_BLOOM_HASHES; i++) {
+            uint32_t bit = (h1 + i * h2) & bloomMask;
+            bloom[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+        }
+    }
+
+    // False means definitely never added
+    bool mayContain(const uint8_t* bssid) const {
+        if (!bloom) return false;
+        uint32_t h1, h2;
+        hash(bssid, h1, h2);
+        for (uint8_t i = 0; i < BSSID_BLOOM_HASHES; i++) {
+            uint32_t bit = (h1 + i * h2) & bloomMask;
+            if (!(bloom[bit >> 3] & (1 << (bit & 7)))) return false;
+        }
+        return true;
+    }
+
+    // Exact lookup in the RAM keys only
+    bool contains(const uint8_t* bssid) const {
+        return bssidSortedContains(keys, count, bssid);
+    }
+
+    // Add to the sorted keys and the bloom filter. False if already
+    // present or full (full keys still reach the bloom filter).
+    bool insert(const uint8_t* bssid) {
+        if (!keys) return false;
+        bloomAdd(bssid);
+        uint32_t pos = bssidLowerBound(keys, count, bssid);
+        uint8_t* at = keys + pos * BSSID_KEY_BYTES;
+        if (pos < count && memcmp(at, bssid, BSSID_KEY_BYTES) == 0) return false;
+        if (count >= cap) return false;
+        memmove(at + BSSID_KEY_BYTES, at, (size_t)(count - pos) * BSSID_KEY_BYTES);
+        memcpy(at, bssid, BSSID_KEY_BYTES);
+        count++;
+        return true;
+    }
+
+    bool full() const { return count >= cap; }
+    uint32_t size() const { return count; }
+    uint32_t capacity() const { return cap; }
+    const uint8_t* data() const { return keys; }
+    size_t memoryBytes() const { return (size_t)cap * BSSID_KEY_BYTES + (bloom ? bloomMask / 8 + 1 : 0); }
+
+private:
+    // Double hashing from one 64-bit mix of the key (splitmix64 finalizer);
+    // the vendor OUI bytes alone would cluster badly
+    static void hash(const uint8_t* bssid, uint32_t& h1, uint32_t& h2) {
+        uint64_t k = 0;
+        for (int i = 0; i < BSSID_KEY_BYTES; i++) {
+            k = (k << 8) | bssid[i];
+        }
+        k ^= k >> 30;
+        k *= 0xBF58476D1CE4E5B9ULL;
+        k ^= k >> 27;
+        k *= 0x94D049BB133111EBULL;
+        k ^= k >> 31;
+        h1 = (uint32_t)k;
+        h2 = (uint32_t)(k >> 32) | 1;
+    }
+
+    uint8_t* keys;
+    uint32_t cap;
+    uint32_t count;
+    uint8_t* bloom;
+    uint32_t bloomMask;
+};
@@ -0,0 +1,302 @@
+// BSSID Store implementation
+
+#include "bssid_store.h"
+#include "config.h"
+#include <SD.h>
+
+// 4096 RAM keys (24KB) between merges; 64KB of bloom keeps false positives
+// (each one a single SD block read) under ~10% at 100k BSSIDs. The bloom
+// is halved while it would take more than a third of the free heap.
+static const uint32_t RAM_KEYS = 4096;
+static const uint32_t BLOOM_BYTES = 65536;
+static const uint32_t BLOOM_MIN_BYTES = 4096;
+static const uint8_t MERGE_OUT_KEYS = 85;   // 510-byte writes
+
+static const char* TMP_FILE = BSSID_STORE_FILE ".tmp";
+
+BssidSet BssidStore::ram;
+File BssidStore::disk;
+bool BssidStore::sdOk = false;
+uint32_t BssidStore::diskCount = 0;
+uint8_t* BssidStore::fences = nullptr;
+uint32_t BssidStore::fenceCount = 0;
+uint8_t BssidStore::block[BSSID_BLOCK_KEYS * BSSID_KEY_BYTES];
+int32_t BssidStore::cachedBlock = -1;
+uint8_t BssidStore::journal[JOURNAL_BATCH * BSSID_KEY_BYTES];
+uint8_t BssidStore::journalCount = 0;
+
+bool BssidStore::begin() {
+    end();
+
+    uint32_t bloomBytes = BLOOM_BYTES;
+    while (bloomBytes > BLOOM_MIN_BYTES && RAM_KEYS * BSSID_KEY_BYTES + bloomBytes > ESP.getFreeHeap() / 3) {
+        bloomBytes /= 2;
+    }
+    while (!ram.init(RAM_KEYS, bloomBytes)) {
+        bloomBytes /= 2;
+        if (bloomBytes < BLOOM_MIN_BYTES) {
+            Serial.println("[SEEN] Out of memory, duplicates will be re-logged");
+            return false;
+        }
+    }
+
+    sdOk = Config::isSDAvailable();
+    if (sdOk) {
+        if (!SD.exists("/wardriving")) SD.mkdir("/wardriving");
+        // Crashed between removing the old checkpoint and the rename
+        if (!SD.exists(BSSID_STORE_FILE) && SD.exists(TMP_FILE)) {
+            SD.rename(TMP_FILE, BSSID_STORE_FILE);
+        }
+        openDisk();
+        replayJournal();
+    }
+
+    Serial.printf("[SEEN] %lu known BSSIDs (%lu on SD), %u bytes RAM\n",
+                  (unsigned long)size(), (unsigned long)diskCount, (unsigned)memoryBytes());
+    return true;
+}
+
+void BssidStore::end() {
+    if (ram.capacity() > 0 && sdOk) {
+        checkpoint();  // In case the merge fails
+        merge();
+    }
+    closeDisk();
+    ram.release();
+    journalCount = 0;
+    sdOk = false;
+}
+
+void BssidStore::forget() {
+    closeDisk();
+    ram.clearAll();
+    journalCount = 0;
+    if (Config::isSDAvailable()) {
+        SD.remove(BSSID_STORE_FILE);
+        SD.remove(BSSID_JOURNAL_FILE);
+        SD.remove(TMP_FILE);
+    }
+    Serial.println("[SEEN] Forgot all BSSIDs");
+}
+
+bool BssidStore::contains(const uint8_t* bssid) {
+    if (ram.capacity() == 0 || !ram.mayContain(bssid)) return false;
+    if (ram.contains(bssid)) return true;
+    if (diskContains(bssid)) return true;
+    // No SD to spill to: past capacity the bloom filter is all we have
+    return !sdOk && ram.full();
+}
+
+bool BssidStore::insert(const uint8_t* bssid) {
+    if (ram.capacity() == 0) return true;
+    if (contains(bssid)) return false;
+
+    if (ram.full() && sdOk) {
+        merge();
+    }
+    if (ram.insert(bssid) && sdOk) {
+        memcpy(journal + journalCount * BSSID_KEY_BYTES, bssid, BSSID_KEY_BYTES);
+        if (++journalCount >= JOURNAL_BATCH) {
+            checkpoint();
+        }
+    }
+    return true;
+}
+
+void BssidStore::checkpoint() {
+    if (journalCount == 0) return;
+
+    File f = SD.open(BSSID_JOURNAL_FILE, FILE_APPEND);
+    if (f) {
+        f.write(journal, journalCount * BSSID_KEY_BYTES);
+        f.close();
+    }
+    journalCount = 0;
+}
+
+bool BssidStore::openDisk() {
+    closeDisk();
+    disk = SD.open(BSSID_STORE_FILE, FILE_READ);
+    if (!disk) return false;
+
+    BssidStoreHeader hdr;
+    bool ok = disk.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              hdr.magic == BSSID_STORE_MAGIC && hdr.version == BSSID_STORE_VERSION &&
+              hdr.keySize == BSSID_KEY_BYTES &&
+              disk.size() == sizeof(hdr) + (size_t)hdr.count * BSSID_KEY_BYTES;
+
+    uint32_t blocks = ok ? (hdr.count + BSSID_BLOCK_KEYS - 1) / BSSID_BLOCK_KEYS : 0;
+    if (blocks > 0) {
+        fences = (uint8_t*)malloc(blocks * BSSID_KEY_BYTES);
+        ok = fences != nullptr;
+    }
+
+    // One pass: seed the bloom filter, take each block's first key as its
+    // fence, and make sure the file really is sorted
+    diskCount = ok ? hdr.count : 0;
+    uint8_t prev[BSSID_KEY_BYTES];
+    for (uint32_t b = 0; ok && b < blocks; b++) {
+        uint32_t n = readBlock(b);
+        ok = n > 0;
+        for (uint32_t i = 0; ok && i < n; i++) {
+            const uint8_t* key = block + i * BSSID_KEY_BYTES;
+            if ((b > 0 || i > 0) && memcmp(prev, key, BSSID_KEY_BYTES) >= 0) ok = false;
+            memcpy(prev, key, BSSID_KEY_BYTES);
+            ram.bloomAdd(key);
+        }
+        if (ok) memcpy(fences + b * BSSID_KEY_BYTES, block, BSSID_KEY_BYTES);
+    }
+
+    if (!ok) {
+        Serial.println("[SEEN] Checkpoint unreadable, starting fresh");
+        closeDisk();
+        ram.clearAll();
+        SD.remove(BSSID_STORE_FILE);
+        return false;
+    }
+    fenceCount = blocks;
+    return true;
+}
+
+void BssidStore::closeDisk() {
+    if (disk) disk.close();
+    free(fences);
+    fences = nullptr;
+    fenceCount = 0;
+    diskCount = 0;
+    cachedBlock = -1;
+}
+
+uint32_t BssidStore::readBlock(uint32_t index) {
+    uint32_t first = index * BSSID_BLOCK_KEYS;
+    if (first >= diskCount) return 0;
+    uint32_t n = diskCount - first < BSSID_BLOCK_KEYS ? diskCount - first : BSSID_BLOCK_KEYS;
+    if (cachedBlock == (int32_t)index) return n;
+
+    cachedBlock = -1;
+    size_t bytes = n * BSSID_KEY_BYTES;
+    if (!disk.seek(sizeof(BssidStoreHeader) + (size_t)first * BSSID_KEY_BYTES) ||
+        disk.read(block, bytes) != bytes) {
+        return 0;
+    }
+    cachedBlock = (int32_t)index;
+    return n;
+}
+
+bool BssidStore::diskContains(const uint8_t* bssid) {
+    if (fenceCount == 0) return false;
+
+    // Last block whose first key is <= bssid
+    uint32_t pos = bssidLowerBound(fences, fenceCount, bssid);
+    if (pos < fenceCount && memcmp(fences + pos * BSSID_KEY_BYTES, bssid, BSSID_KEY_BYTES) == 0) {
+        return true;
+    }
+    if (pos == 0) return false;
+
+    uint32_t n = readBlock(pos - 1);
+    return bssidSortedContains(block, n, bssid);
+}
+
+void BssidStore::replayJournal() {
+    File f = SD.open(BSSID_JOURNAL_FILE, FILE_READ);
+    if (!f) return;
+
+    // A merge deletes the journal, so it never holds more than RAM_KEYS
+    // new keys. A torn final key (power loss mid-append) is not read.
+    uint8_t buf[32 * BSSID_KEY_BYTES];
+    uint32_t replayed = 0;
+    int got;
+    while ((got = f.read(buf, sizeof(buf))) >= BSSID_KEY_BYTES) {
+        for (int i = 0; i + BSSID_KEY_BYTES <= got; i += BSSID_KEY_BYTES) {
+            const uint8_t* key = buf + i;
+            if (ram.mayContain(key) && (ram.contains(key) || diskContains(key))) continue;
+            if (ram.insert(key)) replayed++;
+        }
+    }
+    f.close();
+    if (replayed > 0) {
+        Serial.printf("[SEEN] Replayed %lu journaled BSSIDs\n", (unsigned long)replayed);
+    }
+}
+
+// Stream the checkpoint and the RAM keys (both sorted) into a new
+// checkpoint, then swap it in. The old file stays intact until the new
+// one is complete.
+bool BssidStore::merge() {
+    if (ram.size() == 0) return true;
+
+    if (SD.exists(TMP_FILE)) SD.remove(TMP_FILE);
+    File out = SD.open(TMP_FILE, FILE_WRITE);
+    if (!out) return false;
+
+    BssidStoreHeader hdr = {BSSID_STORE_MAGIC, BSSID_STORE_VERSION, BSSID_KEY_BYTES, 0, 0};
+    bool ok = out.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+
+    uint8_t buf[MERGE_OUT_KEYS * BSSID_KEY_BYTES];
+    uint8_t buffered = 0;
+    uint32_t written = 0;
+    const uint8_t* mem = ram.data();
+    uint32_t memLeft = ram.size();
+    uint32_t blockIndex = 0;
+    uint32_t blockLen = readBlock(0);
+    uint32_t blockPos = 0;
+
+    while (ok && (memLeft > 0 || blockPos < blockLen)) {
+        const uint8_t* next;
+        bool fromDisk = blockPos < blockLen &&
+                        (memLeft == 0 || memcmp(block + blockPos * BSSID_KEY_BYTES, mem, BSSID_KEY_BYTES) <= 0);
+        if (fromDisk) {
+            next = block + blockPos * BSSID_KEY_BYTES;
+            if (memLeft > 0 && memcmp(next, mem, BSSID_KEY_BYTES) == 0) {
+                mem += BSSID_KEY_BYTES;  // Same key in both tiers
+                memLeft--;
+            }
+        } else {
+            next = mem;
+        }
+        memcpy(buf + buffered * BSSID_KEY_BYTES, next, BSSID_KEY_BYTES);
+        written++;
+        if (++buffered == MERGE_OUT_KEYS) {
+            ok = out.write(buf, sizeof(buf)) == sizeof(buf);
+            buffered = 0;
+        }
+
+        if (fromDisk) {
+            if (++blockPos == blockLen) {
+                blockLen = readBlock(++blockIndex);
+                blockPos = 0;
+            }
+        } else {
+            mem += BSSID_KEY_BYTES;
+            memLeft--;
+        }
+    }
+    if (ok && buffered > 0) {
+        ok = out.write(buf, buffered * BSSID_KEY_BYTES) == (size_t)buffered * BSSID_KEY_BYTES;
+    }
+    // A short disk read ends the loop early; don't swap in a truncated file
+    ok = ok && blockIndex * BSSID_BLOCK_KEYS + blockPos >= diskCount;
+    if (ok) {
+        hdr.count = written;
+        ok = out.seek(0) && out.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+    }
+    out.close();
+
+    if (!ok) {
+        Serial.println("[SEEN] Checkpoint merge failed");
+        SD.remove(TMP_FILE);
+        return false;
+    }
+
+    closeDisk();
+    SD.remove(BSSID_STORE_FILE);
+    SD.rename(TMP_FILE, BSSID_STORE_FILE);
+    SD.remove(BSSID_JOURNAL_FILE);
+    journalCount = 0;
+    ram.clear();
+
+    // Reopening re-seeds the bloom filter with the same keys; rebuilds fences
+    openDisk();
+    Serial.printf("[SEEN] Checkpointed %lu BSSIDs\n", (unsigned long)diskCount);
+    return true;
+}
@@ -0,0 +1,54 @@
+// BSSID Store - Warhog's persistent "already logged" set
+// Recent BSSIDs live in a sorted RAM array (BssidSet, 6 bytes each). When
+// it fills, or the session ends, they are merged into a sorted checkpoint
+// on SD and RAM starts over. The bloom filter covers both tiers, so only
+// likely repeats cost an SD read - one block, found via in-RAM fences.
+// New keys are journaled every scan so a crash loses at most one scan.
+// Warhog records a BSSID once it has a geotagged row, so APs heard
+// without a fix are tried again on the next session.
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include "bssid_set.h"
+
+#define BSSID_STORE_FILE "/wardriving/seen.bin"
+#define BSSID_JOURNAL_FILE "/wardriving/seen.jnl"
+
+class BssidStore {
+public:
+    static bool begin();       // Allocate and load the checkpoint + journal
+    static void end();         // Merge RAM keys into the checkpoint and free
+    static void checkpoint();  // Journal keys added since the last call
+
+    static void forget();      // Drop every key, in RAM and on SD
+
+    // True if bssid was recorded before (this session or an earlier one)
+    static bool contains(const uint8_t* bssid);
+    // True if bssid was never seen before (and records it)
+    static bool insert(const uint8_t* bssid);
+
+    static uint32_t size() { return diskCount + ram.size(); }
+    static size_t memoryBytes() { return ram.memoryBytes() + fenceCount * BSSID_KEY_BYTES; }
+
+private:
+    static const uint8_t JOURNAL_BATCH = 64;
+
+    static BssidSet ram;
+    static File disk;
+    static bool sdOk;
+    static uint32_t diskCount;
+    static uint8_t* fences;        // First key of each checkpoint block
+    static uint32_t fenceCount;
+    static uint8_t block[BSSID_BLOCK_KEYS * BSSID_KEY_BYTES];
+    static int32_t cachedBlock;
+    static uint8_t journal[JOURNAL_BATCH * BSSID_KEY_BYTES];
+    static uint8_t journalCount;
+
+    static bool openDisk();
+    static void closeDisk();
+    static uint32_t readBlock(uint32_t index);
+    static bool diskContains(const uint8_t* bssid);
+    static void replayJournal();
+    static bool merge();
+};
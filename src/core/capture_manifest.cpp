@@ -0,0 +1,122 @@
+// Capture Manifest implementation
+
+#include "capture_manifest.h"
+#include "config.h"
+#include <Arduino.h>
+#include <SD.h>
+#include <time.h>
+
+static const uint8_t LOAD_BATCH = 16;  // Records per read (16 * 56 bytes)
+
+static bool writeHeader(File& f) {
+    CaptureManifestHeader hdr = {CAPTURE_MANIFEST_MAGIC, CAPTURE_MANIFEST_VERSION,
+                                 (uint16_t)sizeof(CaptureRecord)};
+    return f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+}
+
+void CaptureManifest::append(const CaptureRecord& r) {
+    if (!Config::isSDAvailable()) return;
+
+    File f = SD.open(CAPTURE_MANIFEST_FILE, FILE_APPEND);
+    if (!f) {
+        Serial.println("[MANIFEST] Failed to open for append");
+        return;
+    }
+    if (f.size() == 0) {
+        writeHeader(f);
+    }
+    f.write((const uint8_t*)&r, sizeof(r));
+    f.close();
+}
+
+void CaptureManifest::recordSaved(const uint8_t* bssid, const char* ssid, CaptureKind kind,
+                                  uint8_t files, const char* sizePath) {
+    CaptureRecord r;
+    memset(&r, 0, sizeof(r));
+    memcpy(r.bssid, bssid, 6);
+    r.kind = (uint8_t)kind;
+    r.files = files;
+    r.op = CAPTURE_OP_SAVED;
+    r.time = (uint32_t)time(nullptr);
+    if (ssid) {
+        strncpy(r.ssid, ssid, sizeof(r.ssid) - 1);
+    }
+
+    File f = SD.open(sizePath, FILE_READ);
+    if (f) {
+        r.size = f.size();
+        f.close();
+    }
+    append(r);
+}
+
+bool CaptureManifest::load(std::vector<CaptureRecord>& out) {
+    out.clear();
+    if (!Config::isSDAvailable() || !SD.exists(CAPTURE_MANIFEST_FILE)) return false;
+
+    File f = SD.open(CAPTURE_MANIFEST_FILE, FILE_READ);
+    if (!f) return false;
+
+    CaptureManifestHeader hdr;
+    if (f.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr) ||
+        hdr.magic != CAPTURE_MANIFEST_MAGIC || hdr.version != CAPTURE_MANIFEST_VERSION ||
+        hdr.recordSize != sizeof(CaptureRecord)) {
+        f.close();
+        Serial.println("[MANIFEST] Bad header, ignoring manifest");
+        return false;
+    }
+
+    // A torn final record (power loss mid-append) is simply not read
+    uint32_t records = (f.size() - sizeof(hdr)) / sizeof(CaptureRecord);
+    CaptureRecord batch[LOAD_BATCH];
+    uint32_t done = 0;
+    while (done < records) {
+        uint32_t n = records - done < LOAD_BATCH ? records - done : LOAD_BATCH;
+        if (f.read((uint8_t*)batch, n * sizeof(CaptureRecord)) != n * sizeof(CaptureRecord)) break;
+        for (uint32_t i = 0; i < n; i++) {
+            batch[i].ssid[sizeof(batch[i].ssid) - 1] = '\0';
+            captureManifestApply(out, batch[i]);
+        }
+        done += n;
+    }
+    f.close();
+
+    if (records > out.size() * 2 + 32) {
+        Serial.printf("[MANIFEST] Compacting %lu records -> %u\n",
+                      (unsigned long)records, (unsigned)out.size());
+        rewrite(out);
+    }
+    return true;
+}
+
+bool CaptureManifest::rewrite(const std::vector<CaptureRecord>& live) {
+    if (!Config::isSDAvailable()) return false;
+
+    // Write beside the old one so a crash leaves one of them intact
+    static const char* TMP_FILE = CAPTURE_MANIFEST_FILE ".tmp";
+    if (SD.exists(TMP_FILE)) SD.remove(TMP_FILE);
+    File f = SD.open(TMP_FILE, FILE_WRITE);
+    if (!f) return false;
+
+    bool ok = writeHeader(f);
+    for (const auto& r : live) {
+        if (!ok) break;
+        CaptureRecord out = r;
+        out.op = CAPTURE_OP_SET;
+        ok = f.write((const uint8_t*)&out, sizeof(out)) == sizeof(out);
+    }
+    f.close();
+
+    if (!ok) {
+        SD.remove(TMP_FILE);
+        return false;
+    }
+    if (SD.exists(CAPTURE_MANIFEST_FILE)) SD.remove(CAPTURE_MANIFEST_FILE);
+    return SD.rename(TMP_FILE, CAPTURE_MANIFEST_FILE);
+}
+
+void CaptureManifest::remove() {
+    if (SD.exists(CAPTURE_MANIFEST_FILE)) {
+        SD.remove(CAPTURE_MANIFEST_FILE);
+    }
+}
@@ -0,0 +1,127 @@
+// Capture Manifest - append-only index of /handshakes for the Captures menu
+// Save paths append a record per capture; the menu replays the file (later
+// records win) instead of opening every capture and companion .txt. The
+// directory is still the source of truth: the menu reconciles against it in
+// the background and rewrites (compacts) the manifest when they disagree.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#define CAPTURE_MANIFEST_FILE "/captures.idx"
+
+static const uint32_t CAPTURE_MANIFEST_MAGIC = 0x464D4350;  // "PCMF"
+static const uint16_t CAPTURE_MANIFEST_VERSION = 1;
+
+enum class CaptureKind : uint8_t {
+    HANDSHAKE = 0,  // BSSID.pcap and/or BSSID_hs.22000
+    PMKID = 1       // BSSID.22000
+};
+
+// Files present for a capture
+static const uint8_t CAPTURE_FILE_PCAP = 0x01;     // BSSID.pcap
+static const uint8_t CAPTURE_FILE_HS22000 = 0x02;  // BSSID_hs.22000
+static const uint8_t CAPTURE_FILE_PMKID = 0x04;    // BSSID.22000
+
+// How a record combines with an earlier one for the same capture
+static const uint8_t CAPTURE_OP_SAVED = 0;  // Save path: add files, keep status
+static const uint8_t CAPTURE_OP_SET = 1;    // Menu: replace; files == 0 deletes
+
+struct CaptureManifestHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+};
+
+struct CaptureRecord {
+    uint8_t bssid[6];
+    uint8_t kind;       // CaptureKind
+    uint8_t files;      // CAPTURE_FILE_* bits
+    uint8_t status;     // CaptureStatus (captures_menu.h)
+    uint8_t op;         // CAPTURE_OP_*
+    uint8_t reserved[2];
+    uint32_t size;      // Bytes of the file the menu lists
+    uint32_t time;      // Unix seconds at save, 0 if unknown
+    char ssid[33];
+    uint8_t pad[3];
+};
+
+inline bool captureSameKey(const CaptureRecord& a, const CaptureRecord& b) {
+    return a.kind == b.kind && memcmp(a.bssid, b.bssid, 6) == 0;
+}
+
+// Fold one manifest record into the live set
+inline void captureManifestApply(std::vector<CaptureRecord>& live, const CaptureRecord& r) {
+    for (size_t i = 0; i < live.size(); i++) {
+        if (!captureSameKey(live[i], r)) continue;
+        if (r.op == CAPTURE_OP_SET) {
+            if (r.files == 0) {
+                live.erase(live.begin() + i);
+            } else {
+                live[i] = r;
+            }
+            return;
+        }
+        CaptureRecord& cur = live[i];
+        cur.files |= r.files;
+        cur.size = r.size;
+        cur.time = r.time;
+        if (r.ssid[0] != 0) memcpy(cur.ssid, r.ssid, sizeof(cur.ssid));
+        return;
+    }
+    if (r.files != 0) {
+        live.push_back(r);
+        live.back().op = CAPTURE_OP_SET;
+    }
+}
+
+// Recognize a capture file name in /handshakes. Companion .txt files and
+// anything else return false.
+inline bool parseCaptureName(const char* name, uint8_t bssid[6], CaptureKind& kind, uint8_t& fileBit) {
+    for (int i = 0; i < 12; i++) {
+        char c = name[i];
+        uint8_t v;
+        if (c >= '0' && c <= '9') v = c - '0';
+        else if (c >= 'A' && c <= 'F') v = c - 'A' + 10;
+        else if (c >= 'a' && c <= 'f') v = c - 'a' + 10;
+        else return false;
+        if (i & 1) bssid[i / 2] = (bssid[i / 2] << 4) | v;
+        else bssid[i / 2] = v;
+    }
+    const char* ext = name + 12;
+    if (strcmp(ext, ".pcap") == 0) {
+        kind = CaptureKind::HANDSHAKE;
+        fileBit = CAPTURE_FILE_PCAP;
+    } else if (strcmp(ext, "_hs.22000") == 0) {
+        kind = CaptureKind::HANDSHAKE;
+        fileBit = CAPTURE_FILE_HS22000;
+    } else if (strcmp(ext, ".22000") == 0) {
+        kind = CaptureKind::PMKID;
+        fileBit = CAPTURE_FILE_PMKID;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+class CaptureManifest {
+public:
+    // Save paths: `files` were just written for this BSSID. sizePath is the
+    // file the menu will list (its size is read once, here).
+    static void recordSaved(const uint8_t* bssid, const char* ssid, CaptureKind kind,
+                            uint8_t files, const char* sizePath);
+
+    // Replace one capture's record (status change, deletion)
+    static void append(const CaptureRecord& r);
+
+    // Replay into `out`. False if there is no usable manifest. Compacts the
+    // file when it has grown well past the live set.
+    static bool load(std::vector<CaptureRecord>& out);
+
+    // Replace the manifest with exactly these records
+    static bool rewrite(const std::vector<CaptureRecord>& live);
+
+    static void remove();
+};
@@ -50,6 +50,7 @@ struct WiFiConfig {
     uint16_t lockTime = 12000;          // Time to discover clients before attacking (12s optimal, buffed 13s)
     bool enableDeauth = true;
     bool randomizeMAC = true;           // Randomize MAC on mode start for stealth
+    bool sessionCapture = false;        // Full-session PCAPNG in OINK (/pcap)
     String otaSSID = "";
     String otaPassword = "";
     bool autoConnect = false;
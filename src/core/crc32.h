@@ -0,0 +1,66 @@
+// CRC32 - the one checksum for ZIP, gzip, CALL PAPA and anything after
+// Standard CRC-32 (IEEE 802.3, reflected, poly 0xEDB88320), the one zlib,
+// ZIP and PNG use. Device builds call the ESP32 ROM's crc32_le; native
+// builds (and -DCRC32_SOFTWARE) use slice-by-8: eight 1KB tables built
+// on first use, eight bytes per step. Both give identical results.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(ESP_PLATFORM) && !defined(CRC32_SOFTWARE)
+#include <esp_rom_crc.h>
+#define CRC32_USE_ROM 1
+#endif
+
+static const uint32_t CRC32_POLY = 0xEDB88320;  // Reflected 0x04C11DB7
+
+struct Crc32Tables {
+    uint32_t t[8][256];
+
+    Crc32Tables() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c >> 1) ^ (CRC32_POLY & (0u - (c & 1)));
+            t[0][i] = c;
+        }
+        // t[n][i]: byte i followed by n zero bytes
+        for (int n = 1; n < 8; n++) {
+            for (uint32_t i = 0; i < 256; i++) t[n][i] = (t[n - 1][i] >> 8) ^ t[0][t[n - 1][i] & 0xFF];
+        }
+    }
+};
+
+// Built once, shared by every caller (function-local static of an inline)
+inline const Crc32Tables& crc32Tables() {
+    static const Crc32Tables tables;
+    return tables;
+}
+
+// Slice-by-8 in portable C++: words are assembled from bytes, so any
+// alignment and byte order works (little-endian compilers fuse the loads)
+inline uint32_t crc32Slice8(uint32_t crc, const uint8_t* data, size_t len) {
+    const uint32_t (*t)[256] = crc32Tables().t;
+    crc = ~crc;
+    while (len >= 8) {
+        uint32_t lo = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24));
+        uint32_t hi = data[4] | (data[5] << 8) | (data[6] << 16) | ((uint32_t)data[7] << 24);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        data += 8;
+        len -= 8;
+    }
+    while (len--) crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    return ~crc;
+}
+
+// CRC-32 continued from a previous result (0 to start):
+// crc32Update(crc32Update(0, a), b) == crc32Update(0, a + b)
+inline uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+    if (len == 0) return crc;
+#ifdef CRC32_USE_ROM
+    return esp_rom_crc32_le(crc, data, (uint32_t)len);
+#else
+    return crc32Slice8(crc, data, len);
+#endif
+}
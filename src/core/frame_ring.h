@@ -0,0 +1,145 @@
+// Frame Ring - lock-free single-producer/single-consumer frame queue
+// Producer: promiscuous callback (WiFi task). Consumer: mode update() (main loop).
+// Variable-length records live in one fixed arena, so short data-frame headers
+// don't waste a full slot and long beacons still fit.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+
+// Compact frame descriptor, payload bytes follow immediately after
+struct FrameRecord {
+    uint16_t recSize;    // Total record bytes incl. header (4-aligned), 0 = wrap marker
+    uint16_t len;        // Captured (possibly trimmed) payload bytes
+    uint16_t origLen;    // On-air length before trimming
+    uint8_t type;        // wifi_promiscuous_pkt_type_t
+    uint8_t channel;     // Channel the frame was received on
+    int8_t rssi;
+    int8_t noise;        // rx_ctrl noise floor (dBm)
+    uint8_t reserved[2];
+    uint32_t timestamp;  // millis() at capture
+
+    const uint8_t* payload() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+};
+
+template <size_t CAPACITY>
+class FrameRing {
+    static_assert(CAPACITY % 4 == 0, "FrameRing capacity must be 4-byte aligned");
+    static_assert(CAPACITY < 65536, "FrameRing records use 16-bit sizes");
+
+public:
+    FrameRing() { reset(); }
+
+    // Consumer-side reset (only call while producer is quiet)
+    void reset() {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        pushed = 0;
+        dropped = 0;
+        highWater = 0;
+    }
+
+    // Producer: copy a frame into the ring. Non-priority frames must leave
+    // CAPACITY/4 free so bursts of beacons can't starve EAPOL frames.
+    bool push(uint8_t type, int8_t rssi, int8_t noise, uint8_t channel, uint32_t timestamp,
+              const uint8_t* data, uint16_t len, uint16_t origLen, bool priority) {
+        uint32_t need = (sizeof(FrameRecord) + len + 3) & ~3u;
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t t = tail.load(std::memory_order_acquire);
+
+        uint32_t used = (h >= t) ? (h - t) : (CAPACITY - t + h);
+        uint32_t reserve = priority ? 0 : CAPACITY / 4;
+        if (used + need + reserve >= CAPACITY) {
+            dropped++;
+            return false;
+        }
+
+        uint32_t at;
+        if (h >= t) {
+            // Free space is [h, CAPACITY) then [0, t)
+            if (need < CAPACITY - h || (need == CAPACITY - h && t != 0)) {
+                at = h;
+            } else if (need < t) {
+                // Not enough contiguous room at the end - leave a wrap marker
+                reinterpret_cast<FrameRecord*>(arena + h)->recSize = 0;
+                at = 0;
+            } else {
+                dropped++;
+                return false;
+            }
+        } else {
+            // Free space is [h, t) - must not close the gap completely
+            if (need >= t - h) {
+                dropped++;
+                return false;
+            }
+            at = h;
+        }
+
+        FrameRecord* rec = reinterpret_cast<FrameRecord*>(arena + at);
+        rec->recSize = (uint16_t)need;
+        rec->len = len;
+        rec->origLen = origLen;
+        rec->type = type;
+        rec->channel = channel;
+        rec->rssi = rssi;
+        rec->noise = noise;
+        rec->timestamp = timestamp;
+        memcpy(arena + at + sizeof(FrameRecord), data, len);
+
+        uint32_t next = at + need;
+        if (next == CAPACITY) next = 0;
+        head.store(next, std::memory_order_release);
+
+        pushed++;
+        used += need;
+        if (used > highWater) highWater = used;
+        return true;
+    }
+
+    // Consumer: oldest record, or nullptr when empty
+    const FrameRecord* peek() {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t h = head.load(std::memory_order_acquire);
+        if (t == h) return nullptr;
+
+        const FrameRecord* rec = reinterpret_cast<const FrameRecord*>(arena + t);
+        if (rec->recSize == 0) {
+            // Wrap marker - producer continued at the start of the arena
+            t = 0;
+            tail.store(0, std::memory_order_release);
+            if (t == h) return nullptr;
+            rec = reinterpret_cast<const FrameRecord*>(arena);
+        }
+        return rec;
+    }
+
+    // Consumer: release the record returned by peek()
+    void pop() {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        const FrameRecord* rec = reinterpret_cast<const FrameRecord*>(arena + t);
+        uint32_t next = t + rec->recSize;
+        if (next == CAPACITY) next = 0;
+        tail.store(next, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    // Stats (written by producer only, safe to read anywhere)
+    uint32_t getPushed() const { return pushed; }
+    uint32_t getDropped() const { return dropped; }
+    uint32_t getHighWater() const { return highWater; }
+    static constexpr size_t capacity() { return CAPACITY; }
+
+private:
+    alignas(4) uint8_t arena[CAPACITY];
+    std::atomic<uint32_t> head;   // Producer write offset
+    std::atomic<uint32_t> tail;   // Consumer read offset
+    volatile uint32_t pushed;
+    volatile uint32_t dropped;
+    volatile uint32_t highWater;  // Peak bytes in use
+};
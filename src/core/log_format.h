@@ -0,0 +1,47 @@
+// Log Format - on-SD layout of the log line index, plus line parsing
+// porkchop.idx is a 16-byte header plus one uint32 per line: the log offset
+// just past that line's '\n'. Pure helpers, shared with the native tests.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+static const uint32_t LOG_INDEX_MAGIC = 0x58494C50;  // "PLIX"
+static const uint16_t LOG_INDEX_VERSION = 1;
+static const uint16_t LOG_INDEX_FP_BYTES = 64;       // Log prefix that identifies the file
+static const uint8_t LOG_INDEX_PENDING = 32;         // Offsets buffered before a write
+
+struct LogIndexHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t fpLen;        // Bytes of the log covered by fingerprint
+    uint32_t fingerprint;  // FNV-1a of the first fpLen log bytes
+    uint32_t reserved;
+};
+
+// FNV-1a, used to notice the log was rotated or replaced under the index
+inline uint32_t logIndexFingerprint(const uint8_t* data, size_t len, uint32_t hash = 2166136261u) {
+    for (size_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Tag of a "[millis][TAG] message" line. Returns false if the line has none.
+inline bool logLineTag(const char* line, size_t len, char* tag, size_t tagSize) {
+    if (tagSize == 0 || len < 4 || line[0] != '[') return false;
+    size_t i = 1;
+    while (i < len && line[i] != ']') i++;
+    if (i + 2 >= len || line[i + 1] != '[') return false;
+    size_t start = i + 2;
+    size_t end = start;
+    while (end < len && line[end] != ']') end++;
+    if (end >= len || end == start) return false;
+    size_t n = end - start;
+    if (n >= tagSize) n = tagSize - 1;
+    memcpy(tag, line + start, n);
+    tag[n] = '\0';
+    return true;
+}
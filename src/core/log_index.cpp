@@ -0,0 +1,190 @@
+// Log Index implementation
+
+#include "log_index.h"
+#include <SD.h>
+
+File LogIndex::writer;
+File LogIndex::reader;
+uint32_t LogIndex::lineCount = 0;
+uint32_t LogIndex::indexedBytes = 0;
+uint32_t LogIndex::pending[LOG_INDEX_PENDING];
+uint8_t LogIndex::pendingCount = 0;
+
+bool LogIndex::validate(File& log, uint32_t logSize) {
+    File f = SD.open(LOG_INDEX_FILE, FILE_READ);
+    if (!f) return false;
+
+    uint32_t idxSize = f.size();
+    LogIndexHeader hdr;
+    bool ok = idxSize >= sizeof(hdr) && (idxSize - sizeof(hdr)) % 4 == 0 &&
+              f.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              hdr.magic == LOG_INDEX_MAGIC && hdr.version == LOG_INDEX_VERSION &&
+              hdr.fpLen > 0 && hdr.fpLen <= LOG_INDEX_FP_BYTES && hdr.fpLen <= logSize;
+
+    uint32_t entries = ok ? (idxSize - sizeof(hdr)) / 4 : 0;
+    uint32_t last = 0;
+    if (ok && entries > 0) {
+        ok = f.seek(idxSize - 4) && f.read((uint8_t*)&last, 4) == 4 && last <= logSize;
+    }
+    f.close();
+    if (!ok) return false;
+
+    // Same log? Prefix must hash the same and the last entry must end a line
+    uint8_t prefix[LOG_INDEX_FP_BYTES];
+    log.seek(0);
+    if (log.read(prefix, hdr.fpLen) != hdr.fpLen) return false;
+    if (logIndexFingerprint(prefix, hdr.fpLen) != hdr.fingerprint) return false;
+    if (last > 0) {
+        uint8_t c = 0;
+        if (!log.seek(last - 1) || log.read(&c, 1) != 1 || c != '\n') return false;
+    }
+
+    lineCount = entries;
+    indexedBytes = last;
+    return true;
+}
+
+bool LogIndex::rebuildHeader(File& log, uint32_t logSize) {
+    Serial.println("[LOGIDX] Rebuilding index");
+
+    LogIndexHeader hdr;
+    uint8_t prefix[LOG_INDEX_FP_BYTES];
+    hdr.magic = LOG_INDEX_MAGIC;
+    hdr.version = LOG_INDEX_VERSION;
+    hdr.fpLen = logSize < LOG_INDEX_FP_BYTES ? logSize : LOG_INDEX_FP_BYTES;
+    hdr.reserved = 0;
+    log.seek(0);
+    if (log.read(prefix, hdr.fpLen) != hdr.fpLen) return false;
+    hdr.fingerprint = logIndexFingerprint(prefix, hdr.fpLen);
+
+    File f = SD.open(LOG_INDEX_FILE, FILE_WRITE);
+    if (!f) return false;
+    bool ok = f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+    f.close();
+
+    lineCount = 0;
+    indexedBytes = 0;
+    return ok;
+}
+
+bool LogIndex::sync(const char* logPath, bool keepOpen) {
+    close();
+    closeReader();
+
+    File log = SD.open(logPath, FILE_READ);
+    if (!log) {
+        lineCount = 0;
+        indexedBytes = 0;
+        return false;
+    }
+
+    uint32_t logSize = log.size();
+    if (logSize == 0) {
+        log.close();
+        remove();
+        return true;
+    }
+
+    if (!validate(log, logSize) && !rebuildHeader(log, logSize)) {
+        log.close();
+        return false;
+    }
+
+    writer = SD.open(LOG_INDEX_FILE, FILE_APPEND);
+    if (!writer) {
+        log.close();
+        return false;
+    }
+
+    // Index whatever was written since (or everything, after a rebuild)
+    uint8_t buf[512];
+    uint32_t pos = indexedBytes;
+    log.seek(pos);
+    while (pos < logSize) {
+        uint32_t want = logSize - pos < sizeof(buf) ? logSize - pos : sizeof(buf);
+        size_t n = log.read(buf, want);
+        if (n == 0) break;
+        onAppend(pos, (const char*)buf, n);
+        pos += n;
+    }
+    log.close();
+
+    commit();
+    if (!keepOpen) {
+        writer.close();
+    }
+    return true;
+}
+
+void LogIndex::onAppend(uint32_t offset, const char* data, size_t len) {
+    if (!writer) return;  // Not tracking - the next sync() catches up
+
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] != '\n') continue;
+        pending[pendingCount++] = offset + i + 1;
+        lineCount++;
+        indexedBytes = offset + i + 1;
+        if (pendingCount == LOG_INDEX_PENDING) {
+            writer.write((const uint8_t*)pending, pendingCount * sizeof(uint32_t));
+            pendingCount = 0;
+        }
+    }
+}
+
+void LogIndex::commit() {
+    if (!writer) {
+        pendingCount = 0;
+        return;
+    }
+    if (pendingCount > 0) {
+        writer.write((const uint8_t*)pending, pendingCount * sizeof(uint32_t));
+        pendingCount = 0;
+    }
+    writer.flush();
+}
+
+void LogIndex::close() {
+    commit();
+    if (writer) {
+        writer.close();
+    }
+}
+
+void LogIndex::remove() {
+    close();
+    closeReader();
+    if (SD.exists(LOG_INDEX_FILE)) {
+        SD.remove(LOG_INDEX_FILE);
+    }
+    lineCount = 0;
+    indexedBytes = 0;
+}
+
+bool LogIndex::readSpans(uint32_t first, uint32_t count, uint32_t* out) {
+    if (count == 0 || first + count > lineCount) return false;
+    if (!reader) {
+        reader = SD.open(LOG_INDEX_FILE, FILE_READ);
+        if (!reader) return false;
+    }
+
+    // Entry i is the end of line i, so line `first` starts at entry first-1
+    uint32_t pos = sizeof(LogIndexHeader);
+    uint8_t* dst = (uint8_t*)out;
+    uint32_t want = count + 1;
+    if (first == 0) {
+        out[0] = 0;
+        dst += sizeof(uint32_t);
+        want = count;
+    } else {
+        pos += (first - 1) * sizeof(uint32_t);
+    }
+
+    if (!reader.seek(pos)) return false;
+    return reader.read(dst, want * sizeof(uint32_t)) == want * sizeof(uint32_t);
+}
+
+void LogIndex::closeReader() {
+    if (reader) {
+        reader.close();
+    }
+}
@@ -0,0 +1,43 @@
+// Log Index - persisted line-offset index for the SD log
+// The index (format in log_format.h) is append-only, so SDLog extends it as
+// it flushes and the log viewer can seek straight to any line without
+// reading the log from the top.
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include "log_format.h"
+
+#define LOG_INDEX_FILE "/logs/porkchop.idx"
+
+class LogIndex {
+public:
+    // Check the index against the log, rebuild it if the log was replaced,
+    // and index any lines written since. keepOpen leaves the writer open
+    // for onAppend() (SDLog); the viewer closes it again.
+    static bool sync(const char* logPath, bool keepOpen);
+
+    // SDLog hooks: `len` bytes were just written to the log at `offset`
+    static void onAppend(uint32_t offset, const char* data, size_t len);
+    static void commit();  // Write buffered offsets out
+    static void close();   // Commit and close the writer
+    static void remove();  // Log rotated - drop the index
+
+    static uint32_t getLineCount() { return lineCount; }
+
+    // Byte spans of lines [first, first+count): out[0..count] are the
+    // start of each line plus the end of the last. Uses its own read handle.
+    static bool readSpans(uint32_t first, uint32_t count, uint32_t* out);
+    static void closeReader();
+
+private:
+    static File writer;
+    static File reader;
+    static uint32_t lineCount;
+    static uint32_t indexedBytes;
+    static uint32_t pending[LOG_INDEX_PENDING];
+    static uint8_t pendingCount;
+
+    static bool validate(File& log, uint32_t logSize);
+    static bool rebuildHeader(File& log, uint32_t logSize);
+};
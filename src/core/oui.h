@@ -2,12 +2,34 @@
 // Maps first 3 bytes of MAC address to vendor name
 #pragma once
 
-#include <Arduino.h>
+#include <cstdint>
+#include <cstddef>
 
 namespace OUI {
-    // Get vendor name for MAC address (returns "Unknown" if not found)
+    // Get vendor name for MAC address (returns "UNKNOWN" if not found).
+    // The pointer is into the flash table and stays valid forever.
     const char* getVendor(const uint8_t* mac);
     
     // Self-test: verify table integrity at startup [P7]
     bool selfTest();
+    
+    // Binary search a sorted table of 3-byte big-endian prefixes.
+    // Returns the index of `key` or -1.
+    inline int32_t find(const uint8_t (*prefixes)[3], size_t count, uint32_t key) {
+        size_t lo = 0;
+        size_t hi = count;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            uint32_t k = ((uint32_t)prefixes[mid][0] << 16) |
+                         ((uint32_t)prefixes[mid][1] << 8) | prefixes[mid][2];
+            if (k < key) {
+                lo = mid + 1;
+            } else if (k > key) {
+                hi = mid;
+            } else {
+                return (int32_t)mid;
+            }
+        }
+        return -1;
+    }
 }
@@ -0,0 +1,181 @@
+// PCAPNG - block encoders + sector-aligned double buffer for session captures
+// Little-endian on-disk format (ESP32 and x86 hosts are both LE).
+// Spec: https://www.ietf.org/archive/id/draft-ietf-opsawg-pcapng-02.html
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+static const uint32_t PCAPNG_SHB_TYPE = 0x0A0D0D0A;
+static const uint32_t PCAPNG_IDB_TYPE = 0x00000001;
+static const uint32_t PCAPNG_EPB_TYPE = 0x00000006;
+static const uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+static const uint16_t PCAPNG_LINKTYPE_RADIOTAP = 127;  // LINKTYPE_IEEE802_11_RADIOTAP
+
+static const size_t PCAPNG_SHB_LEN = 28;
+static const size_t PCAPNG_IDB_LEN = 20;
+static const size_t PCAPNG_EPB_OVERHEAD = 32;   // Header(28) + trailing length(4)
+static const size_t PCAPNG_RADIOTAP_LEN = 16;
+
+inline void pcapngPut16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF; p[1] = v >> 8;
+}
+
+inline void pcapngPut32(uint8_t* p, uint32_t v) {
+    p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; p[2] = (v >> 16) & 0xFF; p[3] = v >> 24;
+}
+
+inline uint32_t pcapngPad4(uint32_t n) { return (n + 3) & ~3u; }
+
+// Section Header Block (no options, section length unknown)
+inline size_t pcapngSHB(uint8_t* out) {
+    pcapngPut32(out, PCAPNG_SHB_TYPE);
+    pcapngPut32(out + 4, PCAPNG_SHB_LEN);
+    pcapngPut32(out + 8, PCAPNG_BYTE_ORDER_MAGIC);
+    pcapngPut16(out + 12, 1);   // Major
+    pcapngPut16(out + 14, 0);   // Minor
+    pcapngPut32(out + 16, 0xFFFFFFFF);  // Section length -1
+    pcapngPut32(out + 20, 0xFFFFFFFF);
+    pcapngPut32(out + 24, PCAPNG_SHB_LEN);
+    return PCAPNG_SHB_LEN;
+}
+
+// IDB snaplen for frames trimmed to maxFrame bytes: packet data is the
+// radiotap header plus the frame
+inline uint32_t pcapngSnapLen(uint16_t maxFrame) {
+    return PCAPNG_RADIOTAP_LEN + maxFrame;
+}
+
+// Interface Description Block (default if_tsresol = microseconds)
+inline size_t pcapngIDB(uint8_t* out, uint16_t linkType, uint32_t snapLen) {
+    pcapngPut32(out, PCAPNG_IDB_TYPE);
+    pcapngPut32(out + 4, PCAPNG_IDB_LEN);
+    pcapngPut16(out + 8, linkType);
+    pcapngPut16(out + 10, 0);   // Reserved
+    pcapngPut32(out + 12, snapLen);
+    pcapngPut32(out + 16, PCAPNG_IDB_LEN);
+    return PCAPNG_IDB_LEN;
+}
+
+// Radiotap header with rx_ctrl metadata: Flags, Channel, dBm signal, dBm noise
+inline size_t pcapngRadiotap(uint8_t* out, uint8_t channel, int8_t rssi, int8_t noise, bool hasFCS) {
+    out[0] = 0;                       // Revision
+    out[1] = 0;                       // Pad
+    pcapngPut16(out + 2, PCAPNG_RADIOTAP_LEN);
+    pcapngPut32(out + 4, (1u << 1) | (1u << 3) | (1u << 5) | (1u << 6));
+    out[8] = hasFCS ? 0x10 : 0x00;    // Flags: frame includes FCS
+    out[9] = 0;                       // Pad - channel is 2-byte aligned
+    uint16_t freq = 0;
+    if (channel >= 1 && channel <= 13) freq = 2407 + channel * 5;
+    else if (channel == 14) freq = 2484;
+    pcapngPut16(out + 10, freq);
+    pcapngPut16(out + 12, 0x0080 | 0x0400);  // 2 GHz + dynamic CCK-OFDM
+    out[14] = (uint8_t)rssi;
+    out[15] = (uint8_t)noise;
+    return PCAPNG_RADIOTAP_LEN;
+}
+
+inline size_t pcapngEPBSize(uint32_t capLen) {
+    return PCAPNG_EPB_OVERHEAD + pcapngPad4(capLen);
+}
+
+// Enhanced Packet Block: [radiotap][frame] as one packet, origLen is on-air 802.11 length
+inline size_t pcapngEPB(uint8_t* out, uint64_t tsUs,
+                        const uint8_t* radiotap, uint16_t rtLen,
+                        const uint8_t* frame, uint16_t capLen, uint16_t origLen) {
+    uint32_t pktLen = rtLen + capLen;
+    uint32_t total = pcapngEPBSize(pktLen);
+    pcapngPut32(out, PCAPNG_EPB_TYPE);
+    pcapngPut32(out + 4, total);
+    pcapngPut32(out + 8, 0);    // Interface 0
+    pcapngPut32(out + 12, (uint32_t)(tsUs >> 32));
+    pcapngPut32(out + 16, (uint32_t)tsUs);
+    pcapngPut32(out + 20, pktLen);
+    pcapngPut32(out + 24, (uint32_t)rtLen + (origLen > capLen ? origLen : capLen));
+    memcpy(out + 28, radiotap, rtLen);
+    memcpy(out + 28 + rtLen, frame, capLen);
+    memset(out + 28 + pktLen, 0, pcapngPad4(pktLen) - pktLen);
+    pcapngPut32(out + total - 4, total);
+    return total;
+}
+
+// EPB for a frame from the OINK ring. Its FCS is already gone (the
+// promiscuous callback takes 4 bytes off sig_len), trimmed or not, so the
+// radiotap flags never claim one. out needs pcapngEPBSize(RADIOTAP + capLen).
+inline size_t pcapngFrameEPB(uint8_t* out, uint64_t tsUs, const uint8_t* frame, uint16_t capLen, uint16_t origLen,
+                             uint8_t channel, int8_t rssi, int8_t noise) {
+    uint8_t rt[PCAPNG_RADIOTAP_LEN];
+    pcapngRadiotap(rt, channel, rssi, noise, false);
+    return pcapngEPB(out, tsUs, rt, sizeof(rt), frame, capLen, origLen);
+}
+
+// Two BLOCK-sized buffers, each mapping to one BLOCK-aligned region of the
+// file. The producer fills one while the other waits to be written, so SD
+// writes are always whole aligned blocks - except partial flushes, which
+// write the unflushed tail and keep the next write on the same boundary.
+template <size_t BLOCK>
+class PcapngBlockBuffer {
+    static_assert(BLOCK % 512 == 0, "PCAPNG blocks must be whole SD sectors");
+
+public:
+    PcapngBlockBuffer() { reset(); }
+
+    void reset() {
+        fillIdx = 0;
+        fillUsed = 0;
+        fillFlushed = 0;
+        fullReady = false;
+        fullFlushed = 0;
+    }
+
+    // Record must be appended whole - refuse if it would need a third buffer
+    bool fits(size_t n) const {
+        size_t room = BLOCK - fillUsed;
+        if (n <= room) return true;
+        return !fullReady && (n - room) < BLOCK;
+    }
+
+    void put(const uint8_t* p, size_t n) {
+        while (n > 0) {
+            size_t c = BLOCK - fillUsed;
+            if (c > n) c = n;
+            memcpy(buf[fillIdx] + fillUsed, p, c);
+            fillUsed += c;
+            p += c;
+            n -= c;
+            if (fillUsed == BLOCK) {
+                fullReady = true;
+                fullFlushed = fillFlushed;
+                fillIdx ^= 1;
+                fillUsed = 0;
+                fillFlushed = 0;
+            }
+        }
+    }
+
+    // Completed block waiting for SD (unflushed part only)
+    bool hasFullBlock() const { return fullReady; }
+    const uint8_t* fullBlock(size_t& n) const {
+        n = BLOCK - fullFlushed;
+        return buf[fillIdx ^ 1] + fullFlushed;
+    }
+    void releaseFullBlock() { fullReady = false; }
+
+    // Unflushed tail of the block being filled (periodic / final flush)
+    const uint8_t* partial(size_t& n) const {
+        n = fillUsed - fillFlushed;
+        return buf[fillIdx] + fillFlushed;
+    }
+    void markPartialFlushed() { fillFlushed = fillUsed; }
+
+    static constexpr size_t blockSize() { return BLOCK; }
+
+private:
+    uint8_t buf[2][BLOCK];
+    uint8_t fillIdx;
+    size_t fillUsed;
+    size_t fillFlushed;
+    bool fullReady;
+    size_t fullFlushed;
+};
@@ -0,0 +1,145 @@
+// PCAPNG Session Writer implementation
+
+#include "pcapng_session.h"
+#include "pcapng.h"
+#include "config.h"
+#include "sdlog.h"
+#include <SD.h>
+#include <new>
+
+static const size_t PCAPNG_BLOCK = 4096;            // 8 SD sectors per write
+static const uint32_t PCAPNG_FLUSH_INTERVAL = 10000; // Partial flush so a crash loses <10s
+static const uint16_t PCAPNG_MAX_FRAME = 1500;       // Larger frames are trimmed
+
+typedef PcapngBlockBuffer<PCAPNG_BLOCK> SessionBuffer;
+
+static SessionBuffer* blockBuf = nullptr;
+static uint8_t* scratch = nullptr;  // One encoded EPB
+static File sessionFile;
+static uint16_t sessionSnap = PCAPNG_MAX_FRAME;  // Longest frame kept this session
+
+bool PcapngSession::active = false;
+char PcapngSession::filename[48] = {0};
+uint32_t PcapngSession::packets = 0;
+uint32_t PcapngSession::bytesWritten = 0;
+uint32_t PcapngSession::dropped = 0;
+uint32_t PcapngSession::lastFlushTime = 0;
+
+bool PcapngSession::start(const char* tag, uint16_t snapLen) {
+    if (active) return true;
+    if (!Config::isSDAvailable()) return false;
+
+    if (!SD.exists("/pcap")) {
+        SD.mkdir("/pcap");
+    }
+
+    // Next free session number
+    for (int n = 0; n < 10000; n++) {
+        snprintf(filename, sizeof(filename), "/pcap/%s_%04d.pcapng", tag, n);
+        if (!SD.exists(filename)) break;
+    }
+
+    blockBuf = new (std::nothrow) SessionBuffer();
+    scratch = (uint8_t*)malloc(PCAPNG_EPB_OVERHEAD + PCAPNG_RADIOTAP_LEN + PCAPNG_MAX_FRAME + 4);
+    if (!blockBuf || !scratch) {
+        Serial.println("[PCAPNG] Out of memory for session buffers");
+        stop();
+        return false;
+    }
+
+    sessionFile = SD.open(filename, FILE_WRITE);
+    if (!sessionFile) {
+        Serial.printf("[PCAPNG] Failed to create %s\n", filename);
+        stop();
+        return false;
+    }
+
+    packets = 0;
+    bytesWritten = 0;
+    dropped = 0;
+    lastFlushTime = millis();
+    sessionSnap = (snapLen > 0 && snapLen < PCAPNG_MAX_FRAME) ? snapLen : PCAPNG_MAX_FRAME;
+
+    uint8_t hdr[PCAPNG_SHB_LEN + PCAPNG_IDB_LEN];
+    size_t n = pcapngSHB(hdr);
+    n += pcapngIDB(hdr + n, PCAPNG_LINKTYPE_RADIOTAP, pcapngSnapLen(sessionSnap));
+    blockBuf->put(hdr, n);
+
+    active = true;
+    Serial.printf("[PCAPNG] Session capture: %s\n", filename);
+    SDLog::log("PCAPNG", "Session capture started: %s", filename);
+    return true;
+}
+
+void PcapngSession::stop() {
+    if (active && blockBuf) {
+        // Full block first, then the tail, so file order matches buffer order
+        size_t n;
+        if (blockBuf->hasFullBlock()) {
+            const uint8_t* p = blockBuf->fullBlock(n);
+            writeOut(p, n);
+            blockBuf->releaseFullBlock();
+        }
+        const uint8_t* p = blockBuf->partial(n);
+        if (n > 0) writeOut(p, n);
+
+        Serial.printf("[PCAPNG] Session closed: %lu packets, %lu bytes, %lu dropped\n",
+                      (unsigned long)packets, (unsigned long)bytesWritten, (unsigned long)dropped);
+        SDLog::log("PCAPNG", "Session closed: %s (%lu packets, %lu dropped)",
+                   filename, (unsigned long)packets, (unsigned long)dropped);
+    }
+
+    if (sessionFile) sessionFile.close();
+    delete blockBuf;
+    blockBuf = nullptr;
+    free(scratch);
+    scratch = nullptr;
+    active = false;
+}
+
+void PcapngSession::logFrame(const uint8_t* frame, uint16_t capLen, uint16_t origLen,
+                             uint8_t channel, int8_t rssi, int8_t noise, uint32_t timestampMs) {
+    if (!active) return;
+    if (capLen > sessionSnap) capLen = sessionSnap;
+
+    size_t total = pcapngFrameEPB(scratch, (uint64_t)timestampMs * 1000, frame, capLen, origLen,
+                                  channel, rssi, noise);
+
+    if (!blockBuf->fits(total)) {
+        dropped++;  // SD behind - both buffers busy
+        return;
+    }
+    blockBuf->put(scratch, total);
+    packets++;
+}
+
+void PcapngSession::service() {
+    if (!active) return;
+
+    size_t n;
+    if (blockBuf->hasFullBlock()) {
+        const uint8_t* p = blockBuf->fullBlock(n);
+        bool ok = writeOut(p, n);
+        blockBuf->releaseFullBlock();
+        if (!ok) {
+            Serial.println("[PCAPNG] SD write failed - stopping session capture");
+            stop();
+        }
+        return;  // One block per update keeps the loop responsive
+    }
+
+    if (millis() - lastFlushTime > PCAPNG_FLUSH_INTERVAL) {
+        lastFlushTime = millis();
+        const uint8_t* p = blockBuf->partial(n);
+        if (n > 0 && writeOut(p, n)) {
+            blockBuf->markPartialFlushed();
+            sessionFile.flush();
+        }
+    }
+}
+
+bool PcapngSession::writeOut(const uint8_t* data, size_t len) {
+    size_t written = sessionFile.write(data, len);
+    bytesWritten += written;
+    return written == len;
+}
@@ -0,0 +1,42 @@
+// PCAPNG Session Writer - continuous full-session capture to SD
+// Frames are encoded into a RAM double buffer and written in 4KB
+// sector-aligned blocks from the main loop; the file stays open all session.
+// Frames arrive already trimmed by the mode's frame ring: every EPB keeps
+// the on-air length, and the IDB snaplen is the longest trim in use.
+#pragma once
+
+#include <Arduino.h>
+
+class PcapngSession {
+public:
+    // Open /pcap/<tag>_NNNN.pcapng and write SHB + IDB. Allocates 8KB.
+    // snapLen: the most bytes of any frame the caller will pass (its
+    // longest ring trim), recorded as the IDB snaplen.
+    static bool start(const char* tag, uint16_t snapLen);
+
+    // Flush everything, close file, free buffers
+    static void stop();
+
+    // Queue one 802.11 frame (main thread). capLen may be trimmed below origLen.
+    static void logFrame(const uint8_t* frame, uint16_t capLen, uint16_t origLen,
+                         uint8_t channel, int8_t rssi, int8_t noise, uint32_t timestampMs);
+
+    // Write at most one pending block (call from update())
+    static void service();
+
+    static bool isActive() { return active; }
+    static const char* getFilename() { return filename; }
+    static uint32_t getPacketCount() { return packets; }
+    static uint32_t getBytesWritten() { return bytesWritten; }
+    static uint32_t getDropped() { return dropped; }
+
+private:
+    static bool active;
+    static char filename[48];
+    static uint32_t packets;
+    static uint32_t bytesWritten;
+    static uint32_t dropped;
+    static uint32_t lastFlushTime;
+
+    static bool writeOut(const uint8_t* data, size_t len);
+};
@@ -0,0 +1,82 @@
+// Perf Trace implementation
+
+#include "perf_trace.h"
+#include <Arduino.h>
+
+static const uint32_t PERF_PRINT_INTERVAL_MS = 60000;
+
+PerfHistogram PerfTrace::histograms[PERF_SECTION_COUNT];
+uint32_t PerfTrace::lastPrint = 0;
+
+#ifdef ARDUINO
+static uint32_t cpuMHz = 240;
+#endif
+
+void PerfTrace::init() {
+#ifdef ARDUINO
+    cpuMHz = ESP.getCpuFreqMHz();
+    if (cpuMHz == 0) cpuMHz = 240;
+#endif
+    reset();
+    lastPrint = millis();
+}
+
+void PerfTrace::reset() {
+    for (uint8_t i = 0; i < PERF_SECTION_COUNT; i++) {
+        histograms[i].reset();
+    }
+}
+
+uint32_t PerfTrace::ticksToNs(uint32_t ticks) {
+#ifdef ARDUINO
+    return (uint32_t)((uint64_t)ticks * 1000 / cpuMHz);
+#else
+    return ticks;
+#endif
+}
+
+PerfStats PerfTrace::getStats(PerfSection s) {
+    PerfStats st = histograms[(uint8_t)s].stats();
+    st.min = ticksToNs(st.min);
+    st.max = ticksToNs(st.max);
+    st.p50 = ticksToNs(st.p50);
+    st.p99 = ticksToNs(st.p99);
+    st.avg = ticksToNs(st.avg);
+    return st;
+}
+
+void PerfTrace::update() {
+    if (millis() - lastPrint < PERF_PRINT_INTERVAL_MS) return;
+    lastPrint = millis();
+    printSerial();
+}
+
+void PerfTrace::printSerial() {
+    Serial.println("[PERF] section        count     min     p50     p99     max (us)");
+    for (uint8_t i = 0; i < PERF_SECTION_COUNT; i++) {
+        PerfStats st = getStats((PerfSection)i);
+        if (st.count == 0) continue;
+        Serial.printf("[PERF] %-12s %8lu %7.1f %7.1f %7.1f %7.1f\n",
+                      perfSectionName((PerfSection)i), (unsigned long)st.count,
+                      st.min / 1000.0f, st.p50 / 1000.0f, st.p99 / 1000.0f, st.max / 1000.0f);
+    }
+}
+
+void PerfTrace::toJSON(String& out) {
+    out = "{\"uptime\":";
+    out += String((unsigned long)millis());
+    out += ",\"unit\":\"ns\",\"sections\":[";
+    bool first = true;
+    for (uint8_t i = 0; i < PERF_SECTION_COUNT; i++) {
+        PerfStats st = getStats((PerfSection)i);
+        char buf[160];
+        snprintf(buf, sizeof(buf),
+                 "%s{\"name\":\"%s\",\"count\":%lu,\"min\":%lu,\"p50\":%lu,\"p99\":%lu,\"max\":%lu,\"avg\":%lu}",
+                 first ? "" : ",", perfSectionName((PerfSection)i), (unsigned long)st.count,
+                 (unsigned long)st.min, (unsigned long)st.p50, (unsigned long)st.p99,
+                 (unsigned long)st.max, (unsigned long)st.avg);
+        out += buf;
+        first = false;
+    }
+    out += "]}";
+}
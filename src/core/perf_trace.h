@@ -0,0 +1,195 @@
+// Perf Trace - scoped hot-path timers with per-section latency histograms
+// PERF_SCOPE(PerfSection::X) times the rest of the enclosing block. Device
+// builds count CPU cycles (ccount), native builds use steady_clock ns; ticks
+// are only converted to ns when reported, so the hot path is two counter
+// reads and a bucket increment.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#ifdef ARDUINO
+#include <Esp.h>
+#else
+#include <chrono>
+#endif
+
+class String;
+
+// Named sections. Fixed list: no registration, no locking, fixed RAM.
+enum class PerfSection : uint8_t {
+    LOOP = 0,           // Whole loop() body (minus the frame delay)
+    PORKCHOP_UPDATE,    // Mode/input controller
+    DISPLAY_UPDATE,
+    MOOD_UPDATE,
+    OINK_CALLBACK,      // Shared OINK/DNH promiscuous callback (WiFi task)
+    OINK_DRAIN,         // Frame ring drain in OinkMode::update()
+    OINK_EAPOL,         // processEAPOL (nested inside drain)
+    SPECTRUM_CALLBACK,
+    WARHOG_CALLBACK,
+    ML_CLASSIFY,
+    COUNT
+};
+
+static const uint8_t PERF_SECTION_COUNT = (uint8_t)PerfSection::COUNT;
+
+inline const char* perfSectionName(PerfSection s) {
+    static const char* const NAMES[PERF_SECTION_COUNT] = {
+        "loop", "porkchop", "display", "mood", "oink.cb",
+        "oink.drain", "oink.eapol", "spectrum.cb", "warhog.cb", "ml.classify"
+    };
+    uint8_t i = (uint8_t)s;
+    return i < PERF_SECTION_COUNT ? NAMES[i] : "?";
+}
+
+// Log-linear histogram: 4 sub-buckets per power of two (~19% wide), which
+// keeps p50/p99 honest without storing samples. Counts are 16-bit and the
+// whole histogram halves when one saturates, so it leans toward recent data.
+static const uint8_t PERF_SUB_BUCKETS = 4;
+static const uint8_t PERF_MAX_OCTAVE = 29;  // 2^30 ticks ~ 4.4s @ 240MHz
+static const uint8_t PERF_BUCKETS = (PERF_MAX_OCTAVE - 1) * PERF_SUB_BUCKETS + PERF_SUB_BUCKETS;
+
+struct PerfStats {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t p50;
+    uint32_t p99;
+    uint32_t avg;
+};
+
+class PerfHistogram {
+public:
+    PerfHistogram() { reset(); }
+
+    void reset() {
+        count = 0;
+        total = 0;
+        minTicks = UINT32_MAX;
+        maxTicks = 0;
+        memset(buckets, 0, sizeof(buckets));
+    }
+
+    void record(uint32_t ticks) {
+        count++;
+        total += ticks;
+        if (ticks < minTicks) minTicks = ticks;
+        if (ticks > maxTicks) maxTicks = ticks;
+        uint8_t idx = bucketFor(ticks);
+        if (++buckets[idx] == 0xFFFF) {
+            for (uint8_t i = 0; i < PERF_BUCKETS; i++) buckets[i] >>= 1;
+        }
+    }
+
+    // p in [0,1]. Returns the bucket midpoint, clamped to the observed range.
+    uint32_t percentile(float p) const {
+        uint32_t sum = 0;
+        for (uint8_t i = 0; i < PERF_BUCKETS; i++) sum += buckets[i];
+        if (sum == 0) return 0;
+
+        uint32_t target = (uint32_t)(p * sum + 0.5f);
+        if (target < 1) target = 1;
+        uint32_t seen = 0;
+        for (uint8_t i = 0; i < PERF_BUCKETS; i++) {
+            seen += buckets[i];
+            if (seen >= target) {
+                uint32_t lo = bucketLow(i);
+                uint32_t mid = lo + (bucketLow(i + 1) - lo) / 2;
+                if (mid < minTicks) mid = minTicks;
+                if (mid > maxTicks) mid = maxTicks;
+                return mid;
+            }
+        }
+        return maxTicks;
+    }
+
+    // Stats in ticks; caller converts
+    PerfStats stats() const {
+        PerfStats s;
+        s.count = count;
+        s.min = count ? minTicks : 0;
+        s.max = maxTicks;
+        s.p50 = percentile(0.50f);
+        s.p99 = percentile(0.99f);
+        s.avg = count ? (uint32_t)(total / count) : 0;
+        return s;
+    }
+
+    uint32_t getCount() const { return count; }
+
+    static uint8_t bucketFor(uint32_t v) {
+        if (v < PERF_SUB_BUCKETS) return (uint8_t)v;
+        uint8_t msb = 31 - __builtin_clz(v);
+        if (msb > PERF_MAX_OCTAVE) return PERF_BUCKETS - 1;
+        uint8_t sub = (v >> (msb - 2)) & (PERF_SUB_BUCKETS - 1);
+        return (msb - 1) * PERF_SUB_BUCKETS + sub;
+    }
+
+    // Smallest value that lands in bucket idx (idx == PERF_BUCKETS is the end)
+    static uint32_t bucketLow(uint8_t idx) {
+        if (idx < PERF_SUB_BUCKETS) return idx;
+        uint8_t msb = idx / PERF_SUB_BUCKETS + 1;
+        uint8_t sub = idx % PERF_SUB_BUCKETS;
+        return (uint32_t)(PERF_SUB_BUCKETS + sub) << (msb - 2);
+    }
+
+private:
+    uint32_t count;
+    uint64_t total;
+    uint32_t minTicks;
+    uint32_t maxTicks;
+    uint16_t buckets[PERF_BUCKETS];
+};
+
+// Raw timestamp in ticks (cycles on device, ns on native)
+inline uint32_t perfNow() {
+#ifdef ARDUINO
+    return ESP.getCycleCount();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+class PerfTrace {
+public:
+    static void init();
+    static void reset();
+
+    // Record one sample. Each section should only be recorded from one task;
+    // readers may see a torn update, which is fine for stats.
+    static void record(PerfSection s, uint32_t ticks) {
+        histograms[(uint8_t)s].record(ticks);
+    }
+
+    // Stats converted to nanoseconds
+    static PerfStats getStats(PerfSection s);
+    static uint32_t ticksToNs(uint32_t ticks);
+
+    // Periodic serial dump (call from loop())
+    static void update();
+    static void printSerial();
+
+    // {"uptime":ms,"unit":"ns","sections":[{name,count,min,p50,p99,max,avg},...]}
+    static void toJSON(String& out);
+
+private:
+    static PerfHistogram histograms[PERF_SECTION_COUNT];
+    static uint32_t lastPrint;
+};
+
+// RAII timer used by PERF_SCOPE
+class PerfScope {
+public:
+    explicit PerfScope(PerfSection s) : section(s), start(perfNow()) {}
+    ~PerfScope() { PerfTrace::record(section, perfNow() - start); }
+
+private:
+    PerfSection section;
+    uint32_t start;
+};
+
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+#define PERF_SCOPE(section) PerfScope PERF_CONCAT(perfScope_, __LINE__)(section)
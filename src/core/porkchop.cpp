@@ -25,6 +25,7 @@
 #include "xp.h"
 #include "sdlog.h"
 #include "challenges.h"
+#include "perf_trace.h"
 
 Porkchop::Porkchop() 
     : currentMode(PorkchopMode::IDLE)
@@ -130,6 +131,8 @@ void Porkchop::init() {
 }
 
 void Porkchop::update() {
+    PERF_SCOPE(PerfSection::PORKCHOP_UPDATE);
+    
     processEvents();
     handleInput();
     updateMode();
@@ -227,6 +230,9 @@ void Porkchop::setMode(PorkchopMode mode) {
             break;
     }
     
+    // Get the old mode's buffered log lines onto the card
+    SDLog::flush();
+    
     // Init new mode
     switch (currentMode) {
         case PorkchopMode::IDLE:
@@ -2,12 +2,24 @@
 
 #include "sdlog.h"
 #include "config.h"
+#include "log_index.h"
 #include <SD.h>
 #include <stdarg.h>
+#include <freertos/FreeRTOS.h>
 
 bool SDLog::logEnabled = false;
 bool SDLog::initialized = false;
-String SDLog::currentLogFile = "";
+File SDLog::logFile;
+char* SDLog::ring = nullptr;
+volatile uint32_t SDLog::ringHead = 0;
+volatile uint32_t SDLog::ringTail = 0;
+volatile uint32_t SDLog::droppedLines = 0;
+uint32_t SDLog::reportedDrops = 0;
+uint32_t SDLog::lastFlushTime = 0;
+uint32_t SDLog::logBytes = 0;
+
+// Producers can be any task (WiFi callback, scan task, main loop)
+static portMUX_TYPE ringMux = portMUX_INITIALIZER_UNLOCKED;
 
 void SDLog::init() {
     initialized = true;
@@ -15,48 +27,95 @@ void SDLog::init() {
 }
 
 void SDLog::setEnabled(bool enabled) {
-    Serial.printf("[SDLOG] setEnabled(%s), SD available: %s\n", 
-                  enabled ? "true" : "false", 
+    Serial.printf("[SDLOG] setEnabled(%s), SD available: %s\n",
+                  enabled ? "true" : "false",
                   Config::isSDAvailable() ? "true" : "false");
     
-    logEnabled = enabled && Config::isSDAvailable();
+    bool wanted = enabled && Config::isSDAvailable();
+    if (wanted == logEnabled) return;  // Settings save re-applies every toggle
     
-    if (logEnabled && currentLogFile.length() == 0) {
-        ensureLogFile();
+    if (!wanted) {
+        close();
+        Serial.printf("[SDLOG] Logging DISABLED\n");
+        return;
     }
     
-    if (logEnabled) {
-        Serial.printf("[SDLOG] Logging now ENABLED to: %s\n", currentLogFile.c_str());
-        log("SDLOG", "SD logging enabled");
-    } else {
-        Serial.printf("[SDLOG] Logging DISABLED\n");
+    if (!ring) {
+        ring = (char*)malloc(SDLOG_BUFFER_SIZE);
+        if (!ring) {
+            Serial.println("[SDLOG] No heap for log buffer");
+            return;
+        }
+    }
+    ringHead = ringTail = 0;
+    
+    if (!openLogFile()) {
+        free(ring);
+        ring = nullptr;
+        return;
     }
+    
+    logEnabled = true;
+    lastFlushTime = millis();
+    Serial.printf("[SDLOG] Logging now ENABLED to: %s\n", SDLOG_FILE);
+    log("SDLOG", "SD logging enabled");
 }
 
-void SDLog::ensureLogFile() {
-    if (currentLogFile.length() > 0) return;
-    if (!Config::isSDAvailable()) return;
+bool SDLog::openLogFile() {
+    if (logFile) return true;
+    if (!Config::isSDAvailable()) return false;
     
     // Create logs directory if needed
     if (!SD.exists("/logs")) {
         SD.mkdir("/logs");
     }
     
-    // Use fixed filename - easier to find and read
-    currentLogFile = "/logs/porkchop.log";
+    // Append, so the previous session stays readable until rotation
+    logFile = SD.open(SDLOG_FILE, FILE_APPEND);
+    if (!logFile) {
+        Serial.printf("[SDLOG] Failed to open: %s\n", SDLOG_FILE);
+        return false;
+    }
+    
+    logBytes = logFile.size();
+    
+    char header[96];
+    int n = snprintf(header, sizeof(header),
+                     "=== PORKCHOP LOG ===\nStarted at millis: %lu\n====================\n", millis());
+    writeOut(header, n);
+    logFile.flush();
+    
+    // Index writer isn't open yet, so sync() picks the header up too
+    LogIndex::sync(SDLOG_FILE, true);
+    Serial.printf("[SDLOG] Log file: %s\n", SDLOG_FILE);
+    return true;
+}
+
+void SDLog::writeOut(const char* data, size_t len) {
+    size_t written = logFile.write((const uint8_t*)data, len);
+    if (written != len) {
+        Serial.println("[SDLOG] Write failed, dropping buffered lines");
+    }
+    LogIndex::onAppend(logBytes, data, written);
+    logBytes += written;
+}
+
+void SDLog::append(const char* data, size_t len) {
+    if (len == 0 || len > SDLOG_BUFFER_SIZE) return;
     
-    // Create file with header
-    File f = SD.open(currentLogFile.c_str(), FILE_WRITE);
-    if (f) {
-        f.println("=== PORKCHOP LOG ===");
-        f.printf("Started at millis: %lu\n", millis());
-        f.println("====================");
-        f.close();
-        Serial.printf("[SDLOG] Log file: %s\n", currentLogFile.c_str());
-    } else {
-        Serial.printf("[SDLOG] Failed to create: %s\n", currentLogFile.c_str());
-        currentLogFile = "";
+    taskENTER_CRITICAL(&ringMux);
+    if (!ring || ringHead - ringTail + len > SDLOG_BUFFER_SIZE) {
+        droppedLines++;
+        taskEXIT_CRITICAL(&ringMux);
+        return;
     }
+    uint32_t pos = ringHead & (SDLOG_BUFFER_SIZE - 1);
+    size_t first = SDLOG_BUFFER_SIZE - pos;
+    if (first > len) first = len;
+    memcpy(ring + pos, data, first);
+    memcpy(ring, data + first, len - first);
+    ringHead += len;
+    taskEXIT_CRITICAL(&ringMux);
 }
 
 void SDLog::log(const char* tag, const char* format, ...) {
@@ -64,71 +123,112 @@ void SDLog::log(const char* tag, const char* format, ...) {
     if (!logEnabled) {
         return;
     }
-    if (currentLogFile.length() == 0) {
-        // Try to create log file if it doesn't exist
-        ensureLogFile();
-        if (currentLogFile.length() == 0) {
-            Serial.printf("[SDLOG] ERROR: Could not create log file\n");
-            return;
-        }
-    }
     
-    // Format the message first (before SD operations)
-    char buffer[256];
+    // Format the whole line on the stack, then one short copy into the ring
+    char line[288];
+    int n = snprintf(line, sizeof(line), "[%lu][%s] ", millis(), tag);
+    if (n < 0 || n >= (int)sizeof(line) - 1) return;
+    
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    int m = vsnprintf(line + n, sizeof(line) - n - 1, format, args);
     va_end(args);
+    if (m < 0) return;
     
-    // Debug: show what we're logging
-    Serial.printf("[SDLOG->SD] [%s] %s\n", tag, buffer);
-    
-    // Try to open file with retry on failure (SD can be busy with other operations)
-    File f;
-    for (int retry = 0; retry < 3; retry++) {
-        f = SD.open(currentLogFile.c_str(), FILE_APPEND);
-        if (f) break;
-        delay(5);  // Brief delay before retry
-    }
-    
-    if (!f) {
-        Serial.printf("[SDLOG] Failed to open log file for append\n");
-        return;
-    }
-    
-    // Write timestamp, tag, and message
-    f.printf("[%lu][%s] %s\n", millis(), tag, buffer);
-    f.close();
+    size_t len = n + m;
+    if (len > sizeof(line) - 2) len = sizeof(line) - 2;  // Truncated
+    line[len++] = '\n';
+    append(line, len);
 }
 
 void SDLog::logRaw(const char* message) {
     if (!logEnabled) return;
-    if (currentLogFile.length() == 0) {
-        ensureLogFile();
-        if (currentLogFile.length() == 0) return;
+    append(message, strlen(message));
+    append("\n", 1);
+}
+
+void SDLog::update() {
+    if (!logEnabled) return;
+    uint32_t pending = ringHead - ringTail;
+    if (pending == 0) return;
+    if (pending >= SDLOG_FLUSH_THRESHOLD || millis() - lastFlushTime >= SDLOG_FLUSH_INTERVAL_MS) {
+        flush();
+    }
+}
+
+void SDLog::flush() {
+    lastFlushTime = millis();
+    if (!ring || !logFile) return;
+    
+    // Only the consumer moves ringTail, so [tail, head) is stable while we write
+    uint32_t head = ringHead;
+    uint32_t tail = ringTail;
+    while (tail != head) {
+        uint32_t pos = tail & (SDLOG_BUFFER_SIZE - 1);
+        size_t chunk = SDLOG_BUFFER_SIZE - pos;
+        if (chunk > head - tail) chunk = head - tail;
+        writeOut(ring + pos, chunk);
+        tail += chunk;
     }
     
-    // Try to open file with retry on failure
-    File f;
-    for (int retry = 0; retry < 3; retry++) {
-        f = SD.open(currentLogFile.c_str(), FILE_APPEND);
-        if (f) break;
-        delay(5);
+    taskENTER_CRITICAL(&ringMux);
+    ringTail = tail;
+    uint32_t drops = droppedLines;
+    taskEXIT_CRITICAL(&ringMux);
+    
+    if (drops != reportedDrops) {
+        char marker[64];
+        int n = snprintf(marker, sizeof(marker), "[%lu][SDLOG] %lu lines dropped (buffer full)\n",
+                         millis(), (unsigned long)(drops - reportedDrops));
+        writeOut(marker, n);
+        reportedDrops = drops;
     }
+    logFile.flush();
+    LogIndex::commit();
     
-    if (f) {
-        f.println(message);
-        f.close();
+    if (logBytes >= SDLOG_MAX_FILE_SIZE) {
+        rotate();
     }
 }
 
-void SDLog::flush() {
-    // Files are closed after each write, so nothing to flush
+// porkchop.log -> porkchop.1.log -> ... -> porkchop.N.log (oldest deleted)
+void SDLog::rotate() {
+    logFile.close();
+    LogIndex::remove();  // Rebuilt for the fresh file by openLogFile()
+    
+    char from[40];
+    char to[40];
+    snprintf(to, sizeof(to), "/logs/porkchop.%u.log", SDLOG_MAX_ROTATIONS);
+    if (SD.exists(to)) SD.remove(to);
+    for (uint8_t i = SDLOG_MAX_ROTATIONS - 1; i >= 1; i--) {
+        snprintf(from, sizeof(from), "/logs/porkchop.%u.log", i);
+        snprintf(to, sizeof(to), "/logs/porkchop.%u.log", i + 1);
+        if (SD.exists(from)) SD.rename(from, to);
+    }
+    SD.rename(SDLOG_FILE, "/logs/porkchop.1.log");
+    
+    if (!openLogFile()) {
+        Serial.println("[SDLOG] Reopen after rotation failed, logging off");
+        logEnabled = false;
+    }
 }
 
 void SDLog::close() {
-    if (logEnabled && currentLogFile.length() > 0) {
+    if (logEnabled) {
+        flush();  // Make room so the closing line isn't dropped
         log("SDLOG", "Log closed");
     }
-    currentLogFile = "";
+    flush();
+    logEnabled = false;
+    if (logFile) {
+        logFile.close();
+    }
+    LogIndex::close();
+    
+    taskENTER_CRITICAL(&ringMux);
+    char* old = ring;
+    ring = nullptr;
+    ringHead = ringTail = 0;
+    taskEXIT_CRITICAL(&ringMux);
+    free(old);
 }
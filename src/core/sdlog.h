@@ -1,7 +1,20 @@
 // SD Card Logger
+// log() only formats into a RAM ring; update() writes it out in batches to a
+// log file that stays open, rotating /logs/porkchop.log -> porkchop.1.log ...
+// once it passes SDLOG_MAX_FILE_SIZE. Every write also extends the line
+// index (log_index.h) so the viewer never has to scan the log.
 #pragma once
 
 #include <Arduino.h>
+#include <FS.h>
+
+#define SDLOG_FILE "/logs/porkchop.log"
+
+static const size_t SDLOG_BUFFER_SIZE = 4096;          // RAM ring (power of 2)
+static const size_t SDLOG_FLUSH_THRESHOLD = 2048;      // Flush when this full...
+static const uint32_t SDLOG_FLUSH_INTERVAL_MS = 2000;  // ...or this old
+static const size_t SDLOG_MAX_FILE_SIZE = 256 * 1024;  // Rotate past this
+static const uint8_t SDLOG_MAX_ROTATIONS = 3;          // porkchop.1.log .. .3.log
 
 class SDLog {
 public:
@@ -9,22 +22,38 @@ public:
     static void setEnabled(bool enabled);
     static bool isEnabled() { return logEnabled; }
     
-    // Log functions - mirror Serial.printf behavior
+    // Log functions - mirror Serial.printf behavior. Safe from any task;
+    // lines are dropped (and counted) if the ring is full.
     static void log(const char* tag, const char* format, ...);
     static void logRaw(const char* message);
     
-    // Flush to ensure data is written
+    // Write out buffered lines when the ring is half full or stale (main loop)
+    static void update();
+    
+    // Write everything buffered to the card now (main loop only)
     static void flush();
     
-    // Close current log file (call on shutdown)
+    // Flush and close the log file (call on shutdown)
     static void close();
     
+    static uint32_t getDroppedLines() { return droppedLines; }
+
 private:
     static bool logEnabled;
     static bool initialized;
-    static String currentLogFile;
+    static File logFile;
+    static char* ring;
+    static volatile uint32_t ringHead;  // Producer (log) position, monotonic
+    static volatile uint32_t ringTail;  // Consumer (flush) position, monotonic
+    static volatile uint32_t droppedLines;
+    static uint32_t reportedDrops;
+    static uint32_t lastFlushTime;
+    static uint32_t logBytes;  // Current log size, tracked instead of size()
     
-    static void ensureLogFile();
+    static bool openLogFile();
+    static void writeOut(const char* data, size_t len);
+    static void append(const char* data, size_t len);
+    static void rotate();
 };
 
 // Convenience macro - logs to both Serial and SD if enabled
@@ -0,0 +1,127 @@
+// Slab Pool - variable-length byte slices carved out of fixed-size pages
+// Each page is 64 cells of CELL bytes with a 64-bit occupancy mask. A slice
+// takes a contiguous run of cells inside one page, so the waste per slice is
+// under one cell instead of a worst-case fixed array. Pages are malloc'd on
+// demand (up to MAX_PAGES) and handed back to the heap as soon as they empty.
+// Not thread-safe - main thread only.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+template <size_t CELL, size_t MAX_PAGES>
+class SlabPool {
+    static_assert(CELL >= 8 && (CELL & (CELL - 1)) == 0, "SlabPool cell size must be a power of two");
+    static_assert(MAX_PAGES > 0, "SlabPool needs at least one page");
+
+public:
+    static constexpr size_t CELLS_PER_PAGE = 64;
+    static constexpr size_t PAGE_SIZE = CELL * CELLS_PER_PAGE;
+
+    SlabPool() : pageCount(0), cellsUsed(0), failures(0) {
+        memset(pages, 0, sizeof(pages));
+    }
+    ~SlabPool() { releaseAll(); }
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    // First fit across existing pages, then a new page if grow is allowed.
+    // Returns nullptr when len is 0 or > PAGE_SIZE, or the pool is exhausted.
+    uint8_t* alloc(size_t len, bool grow = true) {
+        if (len == 0 || len > PAGE_SIZE) {
+            failures++;
+            return nullptr;
+        }
+        size_t cells = cellsFor(len);
+
+        for (size_t i = 0; i < MAX_PAGES; i++) {
+            if (!pages[i].mem || pages[i].used == ~0ull) continue;
+            int at = findRun(pages[i].used, cells);
+            if (at >= 0) return take(i, (size_t)at, cells);
+        }
+
+        if (grow) {
+            for (size_t i = 0; i < MAX_PAGES; i++) {
+                if (pages[i].mem) continue;
+                pages[i].mem = (uint8_t*)malloc(PAGE_SIZE);
+                if (!pages[i].mem) break;  // Heap exhausted
+                pages[i].used = 0;
+                pageCount++;
+                return take(i, 0, cells);
+            }
+        }
+
+        failures++;
+        return nullptr;
+    }
+
+    // len must be the length passed to alloc()
+    void release(uint8_t* p, size_t len) {
+        if (!p || len == 0) return;
+        for (size_t i = 0; i < MAX_PAGES; i++) {
+            uint8_t* mem = pages[i].mem;
+            if (!mem || p < mem || p >= mem + PAGE_SIZE) continue;
+
+            size_t cells = cellsFor(len);
+            pages[i].used &= ~runMask((size_t)(p - mem) / CELL, cells);
+            cellsUsed -= cells;
+            if (pages[i].used == 0) {
+                free(mem);
+                pages[i].mem = nullptr;
+                pageCount--;
+            }
+            return;
+        }
+    }
+
+    void releaseAll() {
+        for (size_t i = 0; i < MAX_PAGES; i++) {
+            free(pages[i].mem);
+            pages[i].mem = nullptr;
+            pages[i].used = 0;
+        }
+        pageCount = 0;
+        cellsUsed = 0;
+    }
+
+    size_t getPageCount() const { return pageCount; }
+    size_t getBytesReserved() const { return pageCount * PAGE_SIZE; }  // Heap held by the pool
+    size_t getBytesUsed() const { return cellsUsed * CELL; }           // Rounded up to cells
+    uint32_t getFailures() const { return failures; }
+    static constexpr size_t maxSlice() { return PAGE_SIZE; }
+    static constexpr size_t capacity() { return MAX_PAGES * PAGE_SIZE; }
+
+private:
+    struct Page {
+        uint8_t* mem;
+        uint64_t used;  // Bit n = cell n taken
+    };
+
+    static size_t cellsFor(size_t len) { return (len + CELL - 1) / CELL; }
+
+    static uint64_t runMask(size_t at, size_t cells) {
+        uint64_t run = cells >= 64 ? ~0ull : ((1ull << cells) - 1);
+        return run << at;
+    }
+
+    static int findRun(uint64_t used, size_t cells) {
+        for (size_t at = 0; at + cells <= CELLS_PER_PAGE; at++) {
+            if ((used & runMask(at, cells)) == 0) return (int)at;
+        }
+        return -1;
+    }
+
+    uint8_t* take(size_t page, size_t at, size_t cells) {
+        pages[page].used |= runMask(at, cells);
+        cellsUsed += cells;
+        return pages[page].mem + at * CELL;
+    }
+
+    Page pages[MAX_PAGES];
+    size_t pageCount;
+    size_t cellsUsed;
+    uint32_t failures;
+};
@@ -0,0 +1,363 @@
+// Wardrive Log Format - Warhog's binary observation log (.wdl)
+// One file per session: a header, then a stream of records. Observations
+// are fixed-width; SSIDs are stored in dictionary records and referenced
+// by id. Readers go front to back: an SSID record defines its id from that
+// point on, replacing any earlier one with the same id. The WiGLE CSV,
+// internal CSV and ML CSV are rendered from this on demand (WardriveLog on
+// device, scripts/wdl_export.py on a host) - the row formatters below
+// produce exactly what Warhog used to write.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define WDL_EXT "wdl"
+
+static const uint32_t WDL_MAGIC = 0x474C4457;  // "WDLG"
+static const uint16_t WDL_VERSION = 1;
+
+// Record types (first byte of every record)
+static const uint8_t WDL_REC_SSID = 1;      // Variable: 4 + len bytes
+static const uint8_t WDL_REC_OBS = 2;       // WdlObservation
+static const uint8_t WDL_REC_FEATURES = 3;  // WdlFeatures, follows its OBS
+
+// WdlObservation::flags
+static const uint8_t WDL_OBS_GPS = 0x01;       // Has a fix: CSV + WiGLE rows
+static const uint8_t WDL_OBS_FEATURES = 0x02;  // ML row (features record follows)
+
+// WdlFeatures::bits
+static const uint8_t WDL_FEAT_WPS = 0x01;
+static const uint8_t WDL_FEAT_WPA = 0x02;
+static const uint8_t WDL_FEAT_WPA2 = 0x04;
+static const uint8_t WDL_FEAT_WPA3 = 0x08;
+static const uint8_t WDL_FEAT_HIDDEN = 0x10;
+static const uint8_t WDL_FEAT_PROBE = 0x20;
+
+static const uint16_t WDL_SSID_NONE = 0;  // Hidden / empty, never stored
+static const uint8_t WDL_ML_VALUES = 32;  // FEATURE_VECTOR_SIZE
+
+struct WdlHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    char appRelease[16];  // Firmware version for the WiGLE pre-header
+};
+
+struct WdlSsidRecord {
+    uint8_t type;  // WDL_REC_SSID
+    uint8_t len;   // Bytes of SSID that follow (<= 32)
+    uint16_t id;
+};
+
+struct WdlObservation {
+    uint8_t type;         // WDL_REC_OBS
+    uint8_t flags;        // WDL_OBS_*
+    uint8_t bssid[6];
+    uint16_t ssidId;
+    int8_t rssi;
+    uint8_t channel;
+    int32_t lat;          // Degrees * 1e7
+    int32_t lon;
+    int32_t altDm;        // Altitude, decimeters
+    uint32_t time;        // Unix seconds from GPS, 0 if no GPS time
+    uint32_t uptimeMs;    // millis() at the scan
+    uint16_t accuracyDm;  // Estimated accuracy, decimeters
+    uint8_t auth;         // wifi_auth_mode_t
+    uint8_t label;        // ML label
+};
+
+// Raw WiFiFeatures (ml/features.h), packed. Floats are kept bit-exact.
+struct WdlFeatures {
+    uint8_t type;  // WDL_REC_FEATURES
+    uint8_t bits;  // WDL_FEAT_*
+    int8_t noise;
+    uint8_t secondaryChannel;
+    uint16_t beaconInterval;
+    uint16_t capability;
+    uint32_t responseTime;
+    uint16_t beaconCount;
+    uint16_t probeResponseTime;
+    float snr;
+    float beaconJitter;
+    float anomalyScore;
+    uint8_t vendorIECount;
+    uint8_t supportedRates;
+    uint8_t htCapabilities;
+    uint8_t vhtCapabilities;
+    int8_t rssi;
+    uint8_t channel;
+    uint8_t reserved[2];
+};
+
+static_assert(sizeof(WdlHeader) == 24, "WdlHeader layout");
+static_assert(sizeof(WdlObservation) == 36, "WdlObservation layout");
+static_assert(sizeof(WdlFeatures) == 36, "WdlFeatures layout");
+
+// Length of the record at p, 0 if it is torn (not all `avail` bytes there)
+// or not a record at all
+inline size_t wdlRecordLength(const uint8_t* p, size_t avail) {
+    if (avail < 1) return 0;
+    size_t len;
+    switch (p[0]) {
+        case WDL_REC_SSID:
+            if (avail < sizeof(WdlSsidRecord)) return 0;
+            if (p[1] > 32) return 0;
+            len = sizeof(WdlSsidRecord) + p[1];
+            break;
+        case WDL_REC_OBS:
+            len = sizeof(WdlObservation);
+            break;
+        case WDL_REC_FEATURES:
+            len = sizeof(WdlFeatures);
+            break;
+        default:
+            return 0;
+    }
+    return len <= avail ? len : 0;
+}
+
+// ============ Encoding helpers ============
+
+inline int32_t wdlFixed(double v, double scale) {
+    double x = v * scale;
+    return (int32_t)(x < 0 ? x - 0.5 : x + 0.5);
+}
+
+inline uint32_t wdlDaysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = (unsigned)(y - era * 400);
+    unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (uint32_t)(era * 146097 + (int)doe - 719468);
+}
+
+// GPS date DDMMYY + time HHMMSSCC -> unix seconds (0 if either is unset)
+inline uint32_t wdlUnixFromGps(uint32_t date, uint32_t time) {
+    if (date == 0 || time == 0) return 0;
+    unsigned day = date / 10000, month = (date / 100) % 100, year = date % 100;
+    unsigned hour = time / 1000000, minute = (time / 10000) % 100, second = (time / 100) % 100;
+    if (month < 1 || month > 12 || day < 1) return 0;
+    return wdlDaysFromCivil(2000 + year, month, day) * 86400u + hour * 3600u + minute * 60u + second;
+}
+
+// FNV-1a over the SSID bytes, for the writer's dictionary
+inline uint64_t wdlSsidHash(const char* ssid, size_t len) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ (uint8_t)ssid[i]) * 0x100000001B3ULL;
+    }
+    return h ? h : 1;  // 0 marks an empty slot
+}
+
+// SSID -> dictionary id for one log file. Open addressing on a 64-bit
+// hash; past 3/4 load it stops remembering and the writer just emits
+// another dictionary record (a repeat costs a few bytes, nothing breaks).
+class WdlSsidDict {
+public:
+    WdlSsidDict() : hashes(nullptr), ids(nullptr), slots(0), used(0), nextId(1) {}
+    ~WdlSsidDict() { release(); }
+    WdlSsidDict(const WdlSsidDict&) = delete;
+    WdlSsidDict& operator=(const WdlSsidDict&) = delete;
+
+    bool init(uint16_t slotCount) {
+        release();
+        if (slotCount < 16 || (slotCount & (slotCount - 1)) != 0) return false;
+        hashes = (uint64_t*)calloc(slotCount, sizeof(uint64_t));
+        ids = (uint16_t*)calloc(slotCount, sizeof(uint16_t));
+        if (!hashes || !ids) {
+            release();
+            return false;
+        }
+        slots = slotCount;
+        return true;
+    }
+
+    void release() {
+        free(hashes);
+        free(ids);
+        hashes = nullptr;
+        ids = nullptr;
+        slots = 0;
+        reset();
+    }
+
+    // New file: ids start over
+    void reset() {
+        if (hashes) memset(hashes, 0, slots * sizeof(uint64_t));
+        used = 0;
+        nextId = 1;
+    }
+
+    // Id for this SSID. isNew says a dictionary record must be written
+    // first. WDL_SSID_NONE for empty SSIDs or when ids are exhausted.
+    uint16_t lookup(const char* ssid, size_t len, bool& isNew) {
+        isNew = false;
+        if (len == 0) return WDL_SSID_NONE;
+        uint64_t h = wdlSsidHash(ssid, len);
+        if (slots > 0) {
+            size_t s = (size_t)(h ^ (h >> 32)) & (slots - 1);
+            while (hashes[s] != 0) {
+                if (hashes[s] == h) return ids[s];
+                s = (s + 1) & (slots - 1);
+            }
+            if (used < slots / 4 * 3 && nextId != 0) {
+                hashes[s] = h;
+                ids[s] = nextId;
+                used++;
+            }
+        }
+        if (nextId == 0) return WDL_SSID_NONE;  // Wrapped: 65535 SSIDs in one file
+        isNew = true;
+        return nextId++;
+    }
+
+    uint16_t idsUsed() const { return (uint16_t)(nextId - 1); }
+
+private:
+    uint64_t* hashes;
+    uint16_t* ids;
+    uint16_t slots;
+    uint16_t used;
+    uint16_t nextId;
+};
+
+// ============ Text rendering ============
+
+static const char* const WDL_CSV_HEADER =
+    "BSSID,SSID,RSSI,Channel,AuthMode,Latitude,Longitude,Altitude,Timestamp\r\n";
+
+static const char* const WDL_ML_HEADER =
+    "bssid,ssid,"
+    "rssi,noise,snr,channel,secondary_ch,beacon_interval,"
+    "capability_lo,capability_hi,has_wps,has_wpa,has_wpa2,has_wpa3,"
+    "is_hidden,response_time,beacon_count,beacon_jitter,"
+    "responds_probe,probe_response_time,vendor_ie_count,"
+    "supported_rates,ht_cap,vht_cap,anomaly_score,"
+    "f23,f24,f25,f26,f27,f28,f29,f30,f31,"
+    "label,latitude,longitude\r\n";
+
+static const char* const WDL_WIGLE_COLUMNS =
+    "MAC,SSID,AuthMode,FirstSeen,Channel,Frequency,RSSI,CurrentLatitude,"
+    "CurrentLongitude,AltitudeMeters,AccuracyMeters,RCOIs,MfgrId,Type\r\n";
+
+// Internal CSV auth column
+inline const char* wdlAuthName(uint8_t auth) {
+    static const char* const NAMES[] = {
+        "OPEN", "WEP", "WPA", "WPA2", "WPA/WPA2", "UNKNOWN", "WPA3", "WPA2/WPA3", "WAPI"
+    };
+    return auth < sizeof(NAMES) / sizeof(NAMES[0]) ? NAMES[auth] : "UNKNOWN";
+}
+
+// WiGLE capability string
+inline const char* wdlAuthWigle(uint8_t auth) {
+    static const char* const NAMES[] = {
+        "[ESS]", "[WEP][ESS]", "[WPA-PSK-CCMP][ESS]", "[WPA2-PSK-CCMP][ESS]",
+        "[WPA-PSK-CCMP+TKIP][WPA2-PSK-CCMP+TKIP][ESS]", "[ESS]", "[WPA3-SAE][ESS]",
+        "[WPA2-PSK-CCMP][WPA3-SAE][ESS]", "[WAPI-PSK][ESS]"
+    };
+    return auth < sizeof(NAMES) / sizeof(NAMES[0]) ? NAMES[auth] : "[ESS]";
+}
+
+// Quoted SSID, internal quotes doubled, control chars stripped (UTF-8
+// bytes kept whatever char's signedness). Needs up to 66 bytes plus the
+// terminator.
+inline size_t wdlCsvField(char* out, const char* ssid) {
+    size_t n = 0;
+    out[n++] = '"';
+    for (int i = 0; i < 32 && ssid[i]; i++) {
+        if (ssid[i] == '"') {
+            out[n++] = '"';
+            out[n++] = '"';
+        } else if ((uint8_t)ssid[i] >= 32) {  // Skip control characters (newlines, etc)
+            out[n++] = ssid[i];
+        }
+    }
+    out[n++] = '"';
+    out[n] = '\0';
+    return n;
+}
+
+inline size_t wdlBssidPrefix(char* out, size_t cap, const WdlObservation& o, const char* ssid) {
+    int n = snprintf(out, cap, "%02X:%02X:%02X:%02X:%02X:%02X,",
+                     o.bssid[0], o.bssid[1], o.bssid[2], o.bssid[3], o.bssid[4], o.bssid[5]);
+    if (n < 0 || (size_t)n + 68 > cap) return 0;
+    n += (int)wdlCsvField(out + n, ssid);
+    return (size_t)n;
+}
+
+inline size_t wdlFinish(int n, size_t used, size_t cap) {
+    return (n < 0 || used + (size_t)n >= cap) ? 0 : used + (size_t)n;
+}
+
+// Rows return their length, 0 if they didn't fit. Each is one line.
+inline size_t wdlWigleHeader(char* out, size_t cap, const WdlHeader& hdr) {
+    char release[sizeof(hdr.appRelease) + 1];
+    memcpy(release, hdr.appRelease, sizeof(hdr.appRelease));
+    release[sizeof(hdr.appRelease)] = '\0';
+    int n = snprintf(out, cap,
+                     "WigleWifi-1.6,appRelease=%s,model=M5Cardputer,release=ESP32-S3,device=PORKCHOP,"
+                     "display=240x135,board=m5stack,brand=M5Stack,star=Sol,body=3,subBody=0\n%s",
+                     release[0] ? release : "0.1.x", WDL_WIGLE_COLUMNS);
+    return wdlFinish(n, 0, cap);
+}
+
+inline size_t wdlWigleRow(char* out, size_t cap, const WdlObservation& o, const char* ssid) {
+    size_t used = wdlBssidPrefix(out, cap, o, ssid);
+    if (used == 0) return 0;
+
+    char when[40];
+    if (o.time > 0) {
+        // Civil date from days since 1970 (inverse of wdlDaysFromCivil)
+        uint32_t days = o.time / 86400, secs = o.time % 86400;
+        uint32_t z = days + 719468;
+        uint32_t era = z / 146097;
+        uint32_t doe = z - era * 146097;
+        uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        uint32_t mp = (5 * doy + 2) / 153;
+        uint32_t d = doy - (153 * mp + 2) / 5 + 1;
+        uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+        uint32_t y = yoe + era * 400 + (m <= 2);
+        snprintf(when, sizeof(when), "%04u-%02u-%02u %02u:%02u:%02u", (unsigned)y, (unsigned)m,
+                 (unsigned)d, (unsigned)(secs / 3600), (unsigned)(secs / 60 % 60), (unsigned)(secs % 60));
+    } else {
+        // No GPS time - same boot-relative fallback as always
+        snprintf(when, sizeof(when), "1970-01-01 00:00:%02u", (unsigned)((o.uptimeMs / 1000) % 60));
+    }
+
+    int freq = o.channel == 14 ? 2484 : 2412 + (o.channel - 1) * 5;
+    int n = snprintf(out + used, cap - used, ",%s,%s,%d,%d,%d,%.6f,%.6f,%.1f,%.1f,,,WIFI\r\n",
+                     wdlAuthWigle(o.auth), when, o.channel, freq, o.rssi,
+                     o.lat / 1e7, o.lon / 1e7, o.altDm / 10.0,
+                     o.accuracyDm > 0 ? o.accuracyDm / 10.0 : 10.0);
+    return wdlFinish(n, used, cap);
+}
+
+inline size_t wdlCsvRow(char* out, size_t cap, const WdlObservation& o, const char* ssid) {
+    size_t used = wdlBssidPrefix(out, cap, o, ssid);
+    if (used == 0) return 0;
+    int n = snprintf(out + used, cap - used, ",%d,%d,%s,%.6f,%.6f,%.1f,%lu\n",
+                     o.rssi, o.channel, wdlAuthName(o.auth),
+                     o.lat / 1e7, o.lon / 1e7, o.altDm / 10.0, (unsigned long)o.uptimeMs);
+    return wdlFinish(n, used, cap);
+}
+
+// values: the WDL_ML_VALUES model inputs for this observation
+inline size_t wdlMlRow(char* out, size_t cap, const WdlObservation& o, const char* ssid,
+                       const float* values) {
+    size_t used = wdlBssidPrefix(out, cap, o, ssid);
+    if (used == 0) return 0;
+    for (uint8_t i = 0; i < WDL_ML_VALUES; i++) {
+        int n = snprintf(out + used, cap - used, ",%.4f", values[i]);
+        used = wdlFinish(n, used, cap);
+        if (used == 0) return 0;
+    }
+    bool gps = (o.flags & WDL_OBS_GPS) != 0;
+    int n = snprintf(out + used, cap - used, ",%d,%.6f,%.6f\n",
+                     o.label, gps ? o.lat / 1e7 : 0.0, gps ? o.lon / 1e7 : 0.0);
+    return wdlFinish(n, used, cap);
+}
@@ -0,0 +1,289 @@
+// Wardrive Log implementation
+
+#include "wardrive_log.h"
+#include <SD.h>
+#include <new>
+#include <vector>
+
+static const size_t READ_CHUNK = 1024;
+static const size_t OUT_BUFFER = 2048;
+static const size_t ROW_MAX = 640;  // ML row: 32 values + BSSID/SSID/GPS
+
+enum class ExportFormat : uint8_t { WIGLE, CSV, ML };
+
+typedef bool (*RecordVisitor)(const uint8_t* rec, size_t len, void* ctx);
+
+// Walk every complete record in a log. Returns the offset just past the
+// last one (where a torn or corrupt tail starts), 0 if the header is bad.
+static uint32_t walkRecords(File& f, WdlHeader& hdr, RecordVisitor visit, void* ctx) {
+    f.seek(0);
+    if (f.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr) || hdr.magic != WDL_MAGIC ||
+        hdr.version != WDL_VERSION || hdr.headerSize < sizeof(hdr) || !f.seek(hdr.headerSize)) {
+        return 0;
+    }
+
+    uint8_t buf[READ_CHUNK];
+    size_t have = 0;
+    uint32_t offset = hdr.headerSize;
+    for (;;) {
+        size_t got = f.read(buf + have, sizeof(buf) - have);
+        have += got;
+        size_t pos = 0;
+        size_t len;
+        while ((len = wdlRecordLength(buf + pos, have - pos)) > 0) {
+            if (visit && !visit(buf + pos, len, ctx)) return offset;
+            pos += len;
+            offset += len;
+        }
+        memmove(buf, buf + pos, have - pos);
+        have -= pos;
+        if (got == 0) break;  // Whatever is left is torn or not a record
+    }
+    return offset;
+}
+
+void WardriveLog::packFeatures(const WiFiFeatures& in, WdlFeatures& out) {
+    memset(&out, 0, sizeof(out));
+    out.type = WDL_REC_FEATURES;
+    out.bits = (in.hasWPS ? WDL_FEAT_WPS : 0) | (in.hasWPA ? WDL_FEAT_WPA : 0) |
+               (in.hasWPA2 ? WDL_FEAT_WPA2 : 0) | (in.hasWPA3 ? WDL_FEAT_WPA3 : 0) |
+               (in.isHidden ? WDL_FEAT_HIDDEN : 0) | (in.respondsToProbe ? WDL_FEAT_PROBE : 0);
+    out.noise = in.noise;
+    out.secondaryChannel = in.secondaryChannel;
+    out.beaconInterval = in.beaconInterval;
+    out.capability = in.capability;
+    out.responseTime = in.responseTime;
+    out.beaconCount = in.beaconCount;
+    out.probeResponseTime = in.probeResponseTime;
+    out.snr = in.snr;
+    out.beaconJitter = in.beaconJitter;
+    out.anomalyScore = in.anomalyScore;
+    out.vendorIECount = in.vendorIECount;
+    out.supportedRates = in.supportedRates;
+    out.htCapabilities = in.htCapabilities;
+    out.vhtCapabilities = in.vhtCapabilities;
+    out.rssi = in.rssi;
+    out.channel = in.channel;
+}
+
+void WardriveLog::unpackFeatures(const WdlFeatures& in, WiFiFeatures& out) {
+    memset(&out, 0, sizeof(out));
+    out.rssi = in.rssi;
+    out.noise = in.noise;
+    out.snr = in.snr;
+    out.channel = in.channel;
+    out.secondaryChannel = in.secondaryChannel;
+    out.beaconInterval = in.beaconInterval;
+    out.capability = in.capability;
+    out.hasWPS = in.bits & WDL_FEAT_WPS;
+    out.hasWPA = in.bits & WDL_FEAT_WPA;
+    out.hasWPA2 = in.bits & WDL_FEAT_WPA2;
+    out.hasWPA3 = in.bits & WDL_FEAT_WPA3;
+    out.isHidden = in.bits & WDL_FEAT_HIDDEN;
+    out.responseTime = in.responseTime;
+    out.beaconCount = in.beaconCount;
+    out.beaconJitter = in.beaconJitter;
+    out.respondsToProbe = in.bits & WDL_FEAT_PROBE;
+    out.probeResponseTime = in.probeResponseTime;
+    out.vendorIECount = in.vendorIECount;
+    out.supportedRates = in.supportedRates;
+    out.htCapabilities = in.htCapabilities;
+    out.vhtCapabilities = in.vhtCapabilities;
+    out.anomalyScore = in.anomalyScore;
+}
+
+String WardriveLog::siblingPath(const char* wdlPath, const char* ext) {
+    String path = wdlPath;
+    int dot = path.lastIndexOf('.');
+    if (dot > 0) path = path.substring(0, dot);
+    return path + "." + ext;
+}
+
+String WardriveLog::mlPath(const char* wdlPath) {
+    String stem = wdlPath;
+    stem = stem.substring(stem.lastIndexOf('/') + 1);
+    int dot = stem.lastIndexOf('.');
+    if (dot > 0) stem = stem.substring(0, dot);
+    if (stem.startsWith("warhog_")) stem = String("ml_training_") + stem.substring(7);
+    return String("/mldata/") + stem + ".ml.csv";
+}
+
+// ============ Export ============
+
+struct ExportState {
+    File* out;
+    ExportFormat format;
+    bool ok;
+    uint32_t rows;
+    std::vector<char> pool;        // NUL-terminated SSIDs
+    std::vector<uint32_t> ssidAt;  // Dictionary id -> offset in pool
+    WdlObservation pending;        // ML: observation waiting for its features
+    bool havePending;
+    size_t len;
+    char buf[OUT_BUFFER];
+};
+
+static void flushOut(ExportState& st) {
+    if (st.len == 0 || !st.ok) return;
+    st.ok = st.out->write((const uint8_t*)st.buf, st.len) == st.len;
+    st.len = 0;
+}
+
+static void emit(ExportState& st, size_t n) {
+    if (n == 0) return;  // Row didn't fit - can't happen with ROW_MAX headroom
+    st.len += n;
+    st.rows++;
+    if (st.len + ROW_MAX > sizeof(st.buf)) flushOut(st);
+}
+
+static const char* ssidFor(const ExportState& st, uint16_t id) {
+    if (id == WDL_SSID_NONE || id >= st.ssidAt.size() || st.ssidAt[id] == UINT32_MAX) return "";
+    return &st.pool[st.ssidAt[id]];
+}
+
+static bool exportVisitor(const uint8_t* rec, size_t len, void* ctx) {
+    ExportState& st = *(ExportState*)ctx;
+
+    if (rec[0] == WDL_REC_SSID) {
+        WdlSsidRecord r;
+        memcpy(&r, rec, sizeof(r));
+        if (r.id >= st.ssidAt.size()) st.ssidAt.resize(r.id + 1, UINT32_MAX);
+        st.ssidAt[r.id] = st.pool.size();
+        st.pool.insert(st.pool.end(), rec + sizeof(r), rec + len);
+        st.pool.push_back('\0');
+    } else if (rec[0] == WDL_REC_OBS) {
+        WdlObservation o;
+        memcpy(&o, rec, sizeof(o));
+        st.havePending = false;
+        if (st.format == ExportFormat::ML) {
+            st.pending = o;
+            st.havePending = (o.flags & WDL_OBS_FEATURES) != 0;
+        } else if (o.flags & WDL_OBS_GPS) {
+            char* row = st.buf + st.len;
+            const char* ssid = ssidFor(st, o.ssidId);
+            emit(st, st.format == ExportFormat::WIGLE ? wdlWigleRow(row, ROW_MAX, o, ssid)
+                                                      : wdlCsvRow(row, ROW_MAX, o, ssid));
+        }
+    } else if (rec[0] == WDL_REC_FEATURES && st.havePending) {
+        WdlFeatures packed;
+        memcpy(&packed, rec, sizeof(packed));
+        WiFiFeatures features;
+        WardriveLog::unpackFeatures(packed, features);
+        float values[FEATURE_VECTOR_SIZE];
+        FeatureExtractor::toFeatureVector(features, values);
+        emit(st, wdlMlRow(st.buf + st.len, ROW_MAX, st.pending, ssidFor(st, st.pending.ssidId), values));
+        st.havePending = false;
+    }
+    return st.ok;
+}
+
+static bool exportAs(const char* wdlPath, const char* outPath, ExportFormat format) {
+    File in = SD.open(wdlPath, FILE_READ);
+    if (!in) return false;
+
+    File out = SD.open(outPath, FILE_WRITE);
+    if (!out) {
+        in.close();
+        return false;
+    }
+
+    ExportState* st = new (std::nothrow) ExportState();
+    if (!st) {
+        out.close();
+        in.close();
+        SD.remove(outPath);
+        return false;
+    }
+    st->out = &out;
+    st->format = format;
+    st->ok = true;
+    st->rows = 0;
+    st->havePending = false;
+    st->len = 0;
+    st->ssidAt.push_back(UINT32_MAX);  // WDL_SSID_NONE
+
+    // Header needs the log header, so read it before the first row
+    WdlHeader hdr;
+    bool valid = in.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) && hdr.magic == WDL_MAGIC;
+    if (valid) {
+        if (format == ExportFormat::WIGLE) {
+            st->len = wdlWigleHeader(st->buf, sizeof(st->buf), hdr);
+        } else {
+            const char* header = format == ExportFormat::CSV ? WDL_CSV_HEADER : WDL_ML_HEADER;
+            st->len = strlen(header);
+            memcpy(st->buf, header, st->len);
+        }
+        valid = walkRecords(in, hdr, exportVisitor, st) > 0;
+    }
+    flushOut(*st);
+    bool ok = valid && st->ok;
+    uint32_t rows = st->rows;
+    delete st;
+    out.close();
+    in.close();
+
+    if (!ok) {
+        SD.remove(outPath);
+        Serial.printf("[WDL] Export of %s failed\n", wdlPath);
+        return false;
+    }
+    Serial.printf("[WDL] Exported %lu rows to %s\n", (unsigned long)rows, outPath);
+    return true;
+}
+
+bool WardriveLog::exportWigle(const char* wdlPath, const char* outPath) {
+    return exportAs(wdlPath, outPath, ExportFormat::WIGLE);
+}
+
+bool WardriveLog::exportCSV(const char* wdlPath, const char* outPath) {
+    return exportAs(wdlPath, outPath, ExportFormat::CSV);
+}
+
+bool WardriveLog::exportML(const char* wdlPath, const char* outPath) {
+    return exportAs(wdlPath, outPath, ExportFormat::ML);
+}
+
+// ============ Recovery ============
+
+void WardriveLog::repairTail(const char* path) {
+    File f = SD.open(path, FILE_READ);
+    if (!f) return;
+    uint32_t size = f.size();
+    WdlHeader hdr;
+    uint32_t valid = walkRecords(f, hdr, nullptr, nullptr);
+    f.close();
+
+    // Bad header: not ours to cut
+    if (valid == 0 || valid >= size) return;
+    truncate(path, valid);
+}
+
+// FS has no truncate, so the kept prefix is copied out and renamed over
+// the original - only ever needed after a failure
+bool WardriveLog::truncate(const char* path, uint32_t keep) {
+    File f = SD.open(path, FILE_READ);
+    if (!f) return false;
+    uint32_t size = f.size();
+
+    String tmpPath = String(path) + ".tmp";
+    File out = SD.open(tmpPath.c_str(), FILE_WRITE);
+    bool ok = (bool)out;
+    uint8_t buf[512];
+    for (uint32_t done = 0; ok && done < keep; ) {
+        size_t n = keep - done < sizeof(buf) ? keep - done : sizeof(buf);
+        ok = f.read(buf, n) == n && out.write(buf, n) == n;
+        done += n;
+    }
+    f.close();
+    if (out) out.close();
+
+    if (ok) {
+        SD.remove(path);
+        ok = SD.rename(tmpPath.c_str(), path);
+    } else {
+        SD.remove(tmpPath.c_str());
+    }
+    Serial.printf("[WDL] %s %s (%lu -> %lu bytes)\n", ok ? "Cut torn tail of" : "Failed to cut",
+                  path, (unsigned long)size, (unsigned long)keep);
+    return ok;
+}
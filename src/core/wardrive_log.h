@@ -0,0 +1,32 @@
+// Wardrive Log - .wdl files on SD (format in wardrive_format.h)
+// Warhog appends binary observations; these render a finished log as the
+// WiGLE CSV, internal CSV or ML training CSV when one is actually wanted
+// (WiGLE upload, export). Logs are streamed - only the SSID dictionary is
+// held in RAM.
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include "wardrive_format.h"
+#include "../ml/features.h"
+
+class WardriveLog {
+public:
+    static void packFeatures(const WiFiFeatures& in, WdlFeatures& out);
+    static void unpackFeatures(const WdlFeatures& in, WiFiFeatures& out);
+
+    static bool exportWigle(const char* wdlPath, const char* outPath);
+    static bool exportCSV(const char* wdlPath, const char* outPath);
+    static bool exportML(const char* wdlPath, const char* outPath);
+
+    // "/wardriving/warhog_X.wdl" -> "/wardriving/warhog_X.<ext>"
+    static String siblingPath(const char* wdlPath, const char* ext);
+    // "/wardriving/warhog_X.wdl" -> "/mldata/ml_training_X.ml.csv", the
+    // name scripts/wdl_export.py gives the same export
+    static String mlPath(const char* wdlPath);
+
+    // Cut a torn final record (crash mid-write) so the log can be read to
+    // the end. truncate() keeps the first `keep` bytes of any file.
+    static void repairTail(const char* path);
+    static bool truncate(const char* path, uint32_t keep);
+};
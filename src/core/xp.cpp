@@ -3,6 +3,7 @@
 #include "xp.h"
 #include "sdlog.h"
 #include "config.h"
+#include "crc32.h"
 #include "challenges.h"
 #include "../ui/display.h"
 #include "../ui/swine_stats.h"
@@ -235,22 +236,9 @@ static uint32_t calculateDeviceBoundCRC(const PorkXPData* xpData) {
     esp_efuse_mac_get_default(mac);
     
     // the polynomial of trust
-    uint32_t crc = 0xFFFFFFFF;
-    const uint8_t* bytes = (const uint8_t*)xpData;
-    for (size_t i = 0; i < sizeof(PorkXPData); i++) {
-        crc ^= bytes[i];
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
-        }
-    }
+    uint32_t crc = crc32Update(0, (const uint8_t*)xpData, sizeof(PorkXPData));
     // the binding ritual
-    for (int i = 0; i < 6; i++) {
-        crc ^= mac[i];
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
-        }
-    }
-    return crc ^ 0xFFFFFFFF;
+    return crc32Update(crc, mac, sizeof(mac));
 }
 
 bool XP::backupToSD() {
@@ -7,6 +7,7 @@
 #include "core/porkchop.h"
 #include "core/config.h"
 #include "core/sdlog.h"
+#include "core/perf_trace.h"
 #include "ui/display.h"
 #include "gps/gps.h"
 #include "piglet/avatar.h"
@@ -40,6 +41,9 @@ void setup() {
     // Init SD logging (will be enabled via settings if user wants)
     SDLog::init();
     
+    // Hot-path timers (serial dump every minute, /api/perf, SWINE STATS)
+    PerfTrace::init();
+    
     // Init display system
     Display::init();
     
@@ -89,6 +93,8 @@ void setup() {
 }
 
 void loop() {
+    uint32_t loopStart = perfNow();
+    
     M5.update();
     M5Cardputer.update();
     
@@ -106,9 +112,15 @@ void loop() {
     // Update ML (process any pending callbacks)
     MLInference::update();
     
+    // Write buffered log lines to SD (batched)
+    SDLog::update();
+    
     // Update display
     Display::update();
     
+    PerfTrace::record(PerfSection::LOOP, perfNow() - loopStart);
+    PerfTrace::update();
+    
     // Slower update rate for smoother animation
     delay(50);
 }
@@ -4,6 +4,8 @@
 #include <Arduino.h>
 #include <esp_wifi.h>
 #include <vector>
+#include "../core/beacon_view.h"
+#include "ml_batch.h"
 
 // Feature vector size for Edge Impulse model
 #define FEATURE_VECTOR_SIZE 32
@@ -62,6 +64,7 @@ public:
     // Extract features from raw WiFi scan
     static WiFiFeatures extractFromScan(const wifi_ap_record_t* ap);
     static WiFiFeatures extractFromBeacon(const uint8_t* frame, uint16_t len, int8_t rssi);
+    static WiFiFeatures extractFromBeacon(const BeaconView& view, int8_t rssi);  // Already-parsed frame
     
     // Extract basic features when only Arduino WiFi accessors are available
     static WiFiFeatures extractBasic(int8_t rssi, uint8_t channel, wifi_auth_mode_t authmode);
@@ -76,6 +79,10 @@ public:
     // Batch feature extraction
     static std::vector<float> extractBatchFeatures(const std::vector<WiFiFeatures>& networks);
     
+    // Append to a structure-of-arrays batch (no heap) - false when it's full
+    static bool addToBatch(const WiFiFeatures& features, MLFloatBatch& batch);
+    static bool addToBatch(const WiFiFeatures& features, MLFixedBatch& batch);
+    
     // Normalization (must be called after model training)
     static void setNormalizationParams(const float* means, const float* stds);
     
@@ -84,9 +91,7 @@ private:
     static float featureStds[FEATURE_VECTOR_SIZE];
     static bool normParamsLoaded;
     
-    static uint16_t parseBeaconInterval(const uint8_t* frame, uint16_t len);
-    static uint16_t parseCapability(const uint8_t* frame, uint16_t len);
-    static void parseIEs(const uint8_t* frame, uint16_t len, WiFiFeatures& features);
+    static void parseIEs(const BeaconView& view, WiFiFeatures& features);
     static bool isRandomMAC(const uint8_t* mac);
     static float normalize(float value, float mean, float std);
 };
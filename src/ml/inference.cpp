@@ -5,6 +5,7 @@
 #include "inference.h"
 #include "edge_impulse.h"
 #include "../core/config.h"
+#include "../core/perf_trace.h"
 #include "../ui/display.h"
 #include "../piglet/mood.h"
 #include <SPIFFS.h>
@@ -17,6 +18,8 @@ uint32_t MLInference::inferenceCount = 0;
 uint32_t MLInference::avgInferenceTime = 0;
 const char* MLInference::MODEL_PATH = "/models/porkchop_model.bin";
 
+static_assert(ML_BATCH_FEATURES == FEATURE_VECTOR_SIZE, "ml_batch.h column count out of step with features.h");
+
 // Edge Impulse will generate these - placeholder structure
 struct ei_impulse_result_t {
     float classification[5];
@@ -53,6 +56,8 @@ void MLInference::update() {
 }
 
 MLResult MLInference::classify(const float* features, size_t featureCount) {
+    PERF_SCOPE(PerfSection::ML_CLASSIFY);
+    
     MLResult result = {
         .label = MLLabel::UNKNOWN,
         .confidence = 0.0f,
@@ -109,6 +114,16 @@ void MLInference::classifyAsync(const float* features, size_t featureCount, MLCa
     }
 }
 
+// Heuristic scores to the MLResult shape (shares of the total)
+static void fromScores(const MLScores& s, MLResult& result) {
+    for (int i = 0; i < ML_CLASSES; i++) {
+        result.scores[i] = mlScoreShare(s, i);
+    }
+    result.label = (MLLabel)s.label;
+    result.confidence = result.scores[s.label];
+    result.valid = true;
+}
+
 MLResult MLInference::runInference(const float* input, size_t size) {
     uint32_t startTime = micros();
     
@@ -125,152 +140,85 @@ MLResult MLInference::runInference(const float* input, size_t size) {
         return result;
     }
     
-    // ========================================
-    // ENHANCED HEURISTIC CLASSIFIER
-    // Feature indices from features.cpp:
-    //  0: rssi, 1: noise, 2: snr, 3: channel, 4: secondary_ch
-    //  5: beacon_interval, 6: capability_lo, 7: capability_hi
-    //  8: hasWPS, 9: hasWPA, 10: hasWPA2, 11: hasWPA3
-    // 12: isHidden, 13: responseTime, 14: beaconCount, 15: beaconJitter
-    // 16: respondsToProbe, 17: probeResponseTime, 18: vendorIECount
-    // 19: supportedRates, 20: htCapabilities, 21: vhtCapabilities
-    // 22: anomalyScore
-    // ========================================
-    
-    float rssi = input[0];
-    float snr = input[2];
-    uint8_t channel = (uint8_t)input[3];
-    float beaconInterval = input[5];
-    bool hasWPS = input[8] > 0.5f;
-    bool hasWPA = input[9] > 0.5f;
-    bool hasWPA2 = input[10] > 0.5f;
-    bool hasWPA3 = input[11] > 0.5f;
-    bool isHidden = input[12] > 0.5f;
-    float beaconJitter = input[15];
-    uint8_t vendorIECount = (uint8_t)input[18];
-    uint8_t supportedRates = (uint8_t)input[19];
-    bool hasHT = input[20] > 0.5f;
-    bool hasVHT = input[21] > 0.5f;
-    
-    float anomalyScore = 0.0f;
-    
-    // ---- ROGUE AP DETECTION ----
-    // 1. Suspiciously strong signal (someone nearby with laptop hotspot)
-    if (rssi > -30) {
-        anomalyScore += 0.3f;
-    }
-    
-    // 2. Non-standard beacon interval (default is 100ms, 102.4 TU)
-    if (beaconInterval < 50 || beaconInterval > 200) {
-        anomalyScore += 0.2f;
-    }
-    
-    // 3. High beacon jitter (inconsistent timing = software AP)
-    if (beaconJitter > 10.0f) {
-        anomalyScore += 0.15f;
-    }
-    
-    // 4. Missing vendor-specific IEs (real routers have many)
-    if (vendorIECount < 2) {
-        anomalyScore += 0.1f;
-    }
-    
-    // 5. Open network with WPS enabled (honeypot pattern)
-    if (!hasWPA && !hasWPA2 && !hasWPA3 && hasWPS) {
-        anomalyScore += 0.25f;
-    }
-    
-    // 6. Channel anomaly - using unusual channels (non-1,6,11 for 2.4GHz)
-    if (channel <= 14 && channel != 1 && channel != 6 && channel != 11) {
-        anomalyScore += 0.05f;
-    }
-    
-    // 7. Claims VHT (WiFi 5) but no HT (WiFi 4) - inconsistent
-    if (hasVHT && !hasHT) {
-        anomalyScore += 0.2f;
-    }
-    
-    // 8. Very few supported rates (minimal AP implementation)
-    if (supportedRates < 4) {
-        anomalyScore += 0.1f;
-    }
-    
-    // ---- EVIL TWIN DETECTION ----
-    // Would need SSID comparison with known networks
-    // For now, flag hidden networks copying popular names
-    float evilTwinScore = 0.0f;
-    if (isHidden && rssi > -50) {
-        evilTwinScore += 0.2f;
-    }
-    
-    // ---- VULNERABLE NETWORK DETECTION ----
-    float vulnScore = 0.0f;
-    
-    // Open network
-    if (!hasWPA && !hasWPA2 && !hasWPA3) {
-        vulnScore += 0.5f;
-    }
-    
-    // WPA1 only (TKIP vulnerable)
-    if (hasWPA && !hasWPA2 && !hasWPA3) {
-        vulnScore += 0.4f;
-    }
-    
-    // WPS enabled (PIN attack vulnerable)
-    if (hasWPS) {
-        vulnScore += 0.2f;
-    }
+    // ENHANCED HEURISTIC CLASSIFIER - the rules live in ml_batch.h so a
+    // single network and a whole table score exactly the same
+    float columns[FEATURE_VECTOR_SIZE];
+    MLFloatBatch one;
+    one.attach(columns, 1);
+    one.add(input);
     
-    // Hidden SSID with weak security
-    if (isHidden && vulnScore > 0.3f) {
-        vulnScore += 0.1f;
-    }
-    
-    // ---- DEAUTH TARGET SCORING ----
-    float deauthScore = 0.0f;
+    MLScores scores;
+    mlClassifyHeuristic(one, 0, 1, &scores);
+    fromScores(scores, result);
+    result.inferenceTimeUs = micros() - startTime;
     
-    // Good signal for reliable deauth
-    if (rssi > -70 && rssi < -30) {
-        deauthScore += 0.2f;
-    }
+    return result;
+}
+
+template <typename T>
+void MLInference::runBatch(const MLFeatureBatch<T>& batch, MLResult* results) {
+    // One sample for the whole batch
+    PERF_SCOPE(PerfSection::ML_CLASSIFY);
     
-    // Not WPA3 (PMF protected)
-    if (!hasWPA3) {
-        deauthScore += 0.3f;
-    }
+    uint16_t count = batch.size();
+    if (count == 0 || !results) return;
+    uint32_t startTime = micros();
     
-    // Has active clients (would need client tracking)
-    // deauthScore += clientCount > 0 ? 0.2f : 0.0f;
-    
-    // ---- CLASSIFICATION ----
-    result.scores[0] = 1.0f - (anomalyScore + evilTwinScore + vulnScore) / 3.0f;  // NORMAL
-    result.scores[1] = min(1.0f, anomalyScore);  // ROGUE_AP
-    result.scores[2] = min(1.0f, evilTwinScore);  // EVIL_TWIN
-    result.scores[3] = min(1.0f, deauthScore);  // DEAUTH_TARGET
-    result.scores[4] = min(1.0f, vulnScore);  // VULNERABLE
-    
-    // Normalize scores
-    float sum = 0.0f;
-    for (int i = 0; i < 5; i++) sum += result.scores[i];
-    if (sum > 0) {
-        for (int i = 0; i < 5; i++) result.scores[i] /= sum;
+    MLScores scores[ML_TILE];
+    float bestConfidence = 0.0f;
+    for (uint16_t at = 0; at < count; at += ML_TILE) {
+        uint16_t len = min((uint16_t)ML_TILE, (uint16_t)(count - at));
+        
+        if (EdgeImpulse::isEnabled()) {
+            // The SDK takes one feature vector at a time
+            float row[FEATURE_VECTOR_SIZE];
+            for (uint16_t i = 0; i < len; i++) {
+                MLResult& r = results[at + i];
+                batch.row(at + i, row);
+                EIResult eiResult = EdgeImpulse::classify(row, FEATURE_VECTOR_SIZE);
+                if (eiResult.success) {
+                    r.label = (MLLabel)eiResult.predictedClass;
+                    r.confidence = eiResult.confidence;
+                    for (int k = 0; k < 5; k++) {
+                        r.scores[k] = eiResult.predictions[k];
+                    }
+                    r.valid = true;
+                } else {
+                    // Fallback to heuristic classifier
+                    mlClassifyHeuristic(batch, at + i, 1, scores);
+                    fromScores(scores[0], r);
+                }
+            }
+        } else {
+            mlClassifyHeuristic(batch, at, len, scores);
+            for (uint16_t i = 0; i < len; i++) {
+                fromScores(scores[i], results[at + i]);
+            }
+        }
+        
+        for (uint16_t i = 0; i < len; i++) {
+            if (results[at + i].confidence > bestConfidence) bestConfidence = results[at + i].confidence;
+        }
     }
     
-    // Find highest score
-    int maxIdx = 0;
-    float maxScore = result.scores[0];
-    for (int i = 1; i < 5; i++) {
-        if (result.scores[i] > maxScore) {
-            maxScore = result.scores[i];
-            maxIdx = i;
-        }
+    uint32_t elapsed = micros() - startTime;
+    for (uint16_t i = 0; i < count; i++) {
+        results[i].inferenceTimeUs = elapsed / count;
     }
     
-    result.label = (MLLabel)maxIdx;
-    result.confidence = maxScore;
-    result.inferenceTimeUs = micros() - startTime;
+    inferenceCount += count;
+    avgInferenceTime = (avgInferenceTime * (inferenceCount - count) + elapsed) / inferenceCount;
     
-    return result;
+    // One mood nudge per batch, not one per network
+    Mood::onMLPrediction(bestConfidence);
+}
+
+void MLInference::classifyBatch(const MLFloatBatch& batch, MLResult* results) {
+    runBatch(batch, results);
+}
+
+void MLInference::classifyBatch(const MLFixedBatch& batch, MLResult* results) {
+    runBatch(batch, results);
 }
 
 bool MLInference::loadModel(const char* path) {
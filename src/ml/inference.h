@@ -34,6 +34,12 @@ public:
     static MLResult classify(const float* features, size_t featureCount);
     static MLResult classifyNetwork(const WiFiFeatures& network);
     
+    // Batch inference over a whole network table, filled with
+    // FeatureExtractor::addToBatch. results needs batch.size() entries.
+    // Fixed-point batches run the heuristic in integer arithmetic.
+    static void classifyBatch(const MLFloatBatch& batch, MLResult* results);
+    static void classifyBatch(const MLFixedBatch& batch, MLResult* results);
+    
     // Async inference with callback
     static void classifyAsync(const float* features, size_t featureCount, MLCallback callback);
     
@@ -66,5 +72,7 @@ private:
     static const char* MODEL_PATH;
     
     static MLResult runInference(const float* input, size_t size);
+    template <typename T>
+    static void runBatch(const MLFeatureBatch<T>& batch, MLResult* results);
     static bool validateModel(const uint8_t* data, size_t size);
 };
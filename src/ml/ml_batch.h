@@ -0,0 +1,208 @@
+// ML Batch - a whole network table as structure-of-arrays features
+// One column per feature (features.cpp's vector order), `capacity` values
+// each, in a caller-owned buffer: nothing allocates per scan. Columns are
+// float, or int16 fixed point at half the size. The heuristic classifier
+// runs a column at a time over 32-network tiles and keeps its per-class
+// scores as small integers, so on fixed-point columns it is integer-only.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+static const uint8_t ML_BATCH_FEATURES = 32;  // FEATURE_VECTOR_SIZE
+static const uint8_t ML_CLASSES = 5;          // MLLabel NORMAL..VULNERABLE
+
+// Columns the heuristic reads (see toFeatureVector)
+enum MLFeature : uint8_t {
+    ML_F_RSSI = 0,
+    ML_F_SNR = 2,
+    ML_F_CHANNEL = 3,
+    ML_F_BEACON_INTERVAL = 5,
+    ML_F_WPS = 8,
+    ML_F_WPA = 9,
+    ML_F_WPA2 = 10,
+    ML_F_WPA3 = 11,
+    ML_F_HIDDEN = 12,
+    ML_F_BEACON_JITTER = 15,
+    ML_F_VENDOR_IES = 18,
+    ML_F_RATES = 19,
+    ML_F_HT = 20,
+    ML_F_VHT = 21,
+    ML_F_ANOMALY = 22
+};
+
+// Fixed point: value * 2^shift, saturated to int16. Everything features.cpp
+// produces is integral except SNR, beacon jitter and the anomaly score;
+// counters past 32767 (response time, beacon count) saturate. Jitter is
+// kept to 1/16ms, so within 1/32ms of the rule's 10ms cut a fixed-point
+// batch can disagree with the float one.
+inline uint8_t mlFixedShift(uint8_t feature) {
+    switch (feature) {
+        case ML_F_SNR: return 4;
+        case ML_F_BEACON_JITTER: return 4;
+        case ML_F_ANOMALY: return 12;
+        default: return 0;
+    }
+}
+
+inline int16_t mlToFixed(float v, uint8_t feature) {
+    float scaled = v * (float)(1 << mlFixedShift(feature));
+    if (scaled >= 32767.0f) return 32767;
+    if (scaled <= -32768.0f) return -32768;
+    return (int16_t)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+}
+
+inline float mlFromFixed(int16_t v, uint8_t feature) {
+    return (float)v / (float)(1 << mlFixedShift(feature));
+}
+
+// Column element conversions, so one template serves both batch types
+inline void mlStore(float& dst, float v, uint8_t) { dst = v; }
+inline void mlStore(int16_t& dst, float v, uint8_t feature) { dst = mlToFixed(v, feature); }
+inline float mlLoad(float v, uint8_t) { return v; }
+inline float mlLoad(int16_t v, uint8_t feature) { return mlFromFixed(v, feature); }
+
+template <typename T>
+class MLFeatureBatch {
+public:
+    MLFeatureBatch() : data(nullptr), capacity(0), count(0) {}
+
+    static size_t bytesFor(uint16_t networks) {
+        return sizeof(T) * ML_BATCH_FEATURES * networks;
+    }
+
+    // buffer must hold bytesFor(networks)
+    void attach(T* buffer, uint16_t networks) {
+        data = buffer;
+        capacity = buffer ? networks : 0;
+        count = 0;
+    }
+
+    void clear() { count = 0; }
+
+    // Append one network's feature vector. False when full.
+    bool add(const float* row) {
+        if (count >= capacity) return false;
+        for (uint8_t f = 0; f < ML_BATCH_FEATURES; f++) mlStore(data[(size_t)f * capacity + count], row[f], f);
+        count++;
+        return true;
+    }
+
+    // Network i back as a feature vector (for Edge Impulse)
+    void row(uint16_t i, float* out) const {
+        for (uint8_t f = 0; f < ML_BATCH_FEATURES; f++) out[f] = mlLoad(data[(size_t)f * capacity + i], f);
+    }
+
+    const T* column(uint8_t feature) const { return data + (size_t)feature * capacity; }
+    uint16_t size() const { return count; }
+    uint16_t getCapacity() const { return capacity; }
+
+private:
+    T* data;
+    uint16_t capacity;
+    uint16_t count;
+};
+
+typedef MLFeatureBatch<float> MLFloatBatch;
+typedef MLFeatureBatch<int16_t> MLFixedBatch;
+
+// Heuristic scores count in 1/60ths: every weight is a multiple of 0.05,
+// and NORMAL = 1 - (rogue + twin + vulnerable) / 3 comes out exact
+static const uint8_t ML_SCORE_ONE = 60;
+
+struct MLScores {
+    uint8_t label;                 // MLLabel, highest score (first on a tie)
+    uint8_t score[ML_CLASSES];     // 0..ML_SCORE_ONE
+};
+
+// Share of the total, like MLResult::scores after normalizing
+inline float mlScoreShare(const MLScores& s, uint8_t cls) {
+    uint16_t sum = 0;
+    for (uint8_t c = 0; c < ML_CLASSES; c++) sum += s.score[c];
+    return sum ? (float)s.score[cls] / sum : 0.0f;
+}
+
+inline float mlConfidence(const MLScores& s) {
+    return mlScoreShare(s, s.label);
+}
+
+// Threshold in a column's units: flags compare "> 0.5", which for whole
+// numbers is "> 0"; jitter is the one scaled column the rules read
+inline float mlFlagCut(const float*) { return 0.5f; }
+inline int16_t mlFlagCut(const int16_t*) { return 0; }
+inline float mlJitterCut(const float*) { return 10.0f; }
+inline int16_t mlJitterCut(const int16_t*) { return 10 << 4; }
+
+static const uint8_t ML_TILE = 32;
+
+// The heuristic classifier (MLInference::runInference) over a batch
+// range [first, first + n), one column pass per rule
+template <typename T>
+void mlClassifyHeuristic(const MLFeatureBatch<T>& batch, uint16_t first, uint16_t n, MLScores* out) {
+    const T flag = mlFlagCut((const T*)nullptr);
+    const T jitterCut = mlJitterCut((const T*)nullptr);
+
+    for (uint16_t base = 0; base < n; base += ML_TILE) {
+        uint8_t len = (uint8_t)(n - base < ML_TILE ? n - base : ML_TILE);
+        uint16_t at = first + base;
+        uint8_t rogue[ML_TILE], twin[ML_TILE], deauth[ML_TILE], vuln[ML_TILE];
+        memset(rogue, 0, len);
+        memset(twin, 0, len);
+        memset(deauth, 0, len);
+        memset(vuln, 0, len);
+
+        const T* c = batch.column(ML_F_RSSI) + at;
+        const T* hidden = batch.column(ML_F_HIDDEN) + at;
+        for (uint8_t i = 0; i < len; i++) {
+            rogue[i] += (c[i] > -30) * 18;                      // Suspiciously strong
+            twin[i] += (hidden[i] > flag && c[i] > -50) * 12;   // Hidden and close
+            deauth[i] += (c[i] > -70 && c[i] < -30) * 12;       // Good enough to deauth
+        }
+        c = batch.column(ML_F_BEACON_INTERVAL) + at;
+        for (uint8_t i = 0; i < len; i++) rogue[i] += (c[i] < 50 || c[i] > 200) * 12;
+        c = batch.column(ML_F_BEACON_JITTER) + at;
+        for (uint8_t i = 0; i < len; i++) rogue[i] += (c[i] > jitterCut) * 9;
+        c = batch.column(ML_F_VENDOR_IES) + at;
+        for (uint8_t i = 0; i < len; i++) rogue[i] += ((uint8_t)c[i] < 2) * 6;
+        c = batch.column(ML_F_RATES) + at;
+        for (uint8_t i = 0; i < len; i++) rogue[i] += ((uint8_t)c[i] < 4) * 6;
+        c = batch.column(ML_F_CHANNEL) + at;
+        for (uint8_t i = 0; i < len; i++) {
+            uint8_t ch = (uint8_t)c[i];
+            rogue[i] += (ch <= 14 && ch != 1 && ch != 6 && ch != 11) * 3;
+        }
+        const T* ht = batch.column(ML_F_HT) + at;
+        c = batch.column(ML_F_VHT) + at;
+        for (uint8_t i = 0; i < len; i++) rogue[i] += (c[i] > flag && !(ht[i] > flag)) * 12;
+
+        const T* wpa = batch.column(ML_F_WPA) + at;
+        const T* wpa2 = batch.column(ML_F_WPA2) + at;
+        const T* wpa3 = batch.column(ML_F_WPA3) + at;
+        const T* wps = batch.column(ML_F_WPS) + at;
+        for (uint8_t i = 0; i < len; i++) {
+            bool hasWPA = wpa[i] > flag;
+            bool hasWPA3 = wpa3[i] > flag;
+            bool modern = wpa2[i] > flag || hasWPA3;
+            bool hasWPS = wps[i] > flag;
+            bool open = !hasWPA && !modern;
+            rogue[i] += (open && hasWPS) * 15;                  // Open + WPS honeypot
+            vuln[i] += open * 30 + (hasWPA && !modern) * 24 + hasWPS * 12;
+            vuln[i] += (hidden[i] > flag && vuln[i] > 18) * 6;  // Hidden, weak security
+            deauth[i] += !hasWPA3 * 18;                         // No PMF
+        }
+
+        for (uint8_t i = 0; i < len; i++) {
+            MLScores& s = out[base + i];
+            s.score[0] = (uint8_t)(ML_SCORE_ONE - (rogue[i] + twin[i] + vuln[i]) / 3);
+            s.score[1] = rogue[i] < ML_SCORE_ONE ? rogue[i] : ML_SCORE_ONE;
+            s.score[2] = twin[i];
+            s.score[3] = deauth[i];
+            s.score[4] = vuln[i] < ML_SCORE_ONE ? vuln[i] : ML_SCORE_ONE;
+            s.label = 0;
+            for (uint8_t k = 1; k < ML_CLASSES; k++) {
+                if (s.score[k] > s.score[s.label]) s.label = k;
+            }
+        }
+    }
+}
@@ -13,7 +13,9 @@
 #include <WiFi.h>
 #include <atomic>
 #include "../core/config.h"
+#include "../core/crc32.h"
 #include "../core/sdlog.h"
+#include "../core/capture_manifest.h"
 #include "../piglet/mood.h"
 #include "../ui/display.h"
 
@@ -31,6 +33,8 @@
 #define CMD_ABORT           0x05
 #define CMD_MARK_SYNCED     0x06
 #define CMD_PURGE_SYNCED    0x07
+// 0x08 CMD_ACK_WINDOW replaces CMD_ACK_CHUNK on revision 2 (papa_protocol.h)
+// 0x09 CMD_GET_MANIFEST / 0x88 RSP_MANIFEST carry capture digests on revision 3
 
 // Responses (Sirloin -> Porkchop)
 #define RSP_HELLO           0x81
@@ -41,9 +45,6 @@
 #define RSP_ABORTED         0x86
 #define RSP_PURGED          0x87
 
-// Chunk size (must match Sirloin)
-#define CHUNK_SIZE          17
-
 // Protocol magic bytes (must match Sirloin)
 #define STATUS_MAGIC_P      0x50  // 'P'
 #define STATUS_MAGIC_C      0x43  // 'C'
@@ -65,6 +66,7 @@ uint16_t CallPapaMode::remoteHSCount = 0;
 uint16_t CallPapaMode::totalSynced = 0;
 uint16_t CallPapaMode::syncedPMKIDs = 0;
 uint16_t CallPapaMode::syncedHandshakes = 0;
+uint16_t CallPapaMode::skippedCaptures = 0;
 
 bool CallPapaMode::readyFlagReceived = false;
 uint16_t CallPapaMode::remotePendingCount = 0;
@@ -80,6 +82,21 @@ uint16_t CallPapaMode::currentIndex = 0;
 uint16_t CallPapaMode::totalChunks = 0;
 uint16_t CallPapaMode::receivedChunks = 0;
 
+PapaLink CallPapaMode::link = papaLegacyLink();
+uint16_t CallPapaMode::helloOfferChunk = PAPA_LEGACY_CHUNK;
+uint32_t CallPapaMode::helloSentTime = 0;
+bool CallPapaMode::helloLegacyRetry = false;
+PapaRxWindow CallPapaMode::rxWindow;
+uint32_t CallPapaMode::lastChunkTime = 0;
+
+PapaManifest CallPapaMode::manifest;
+bool CallPapaMode::manifestPending = false;
+bool CallPapaMode::manifestWanted = false;
+PapaDigest CallPapaMode::currentDigest = {0};
+uint16_t CallPapaMode::resumeOffset = 0;
+PapaResumePoint CallPapaMode::resumePoint = {false};
+NimBLEAddress CallPapaMode::resumeDevice;
+
 SyncProgress CallPapaMode::progress = {0};
 uint8_t CallPapaMode::rxBuffer[2048];
 uint16_t CallPapaMode::rxBufferLen = 0;
@@ -157,25 +174,6 @@ static const char* PAPA_ROAST_RESPONSES[] = {
     "SHOULD HAVE COMPILED YOU OUT"
 };
 
-// ============================================================================
-// CRC32 VERIFICATION
-// ============================================================================
-
-uint32_t CallPapaMode::calculateCRC32(const uint8_t* data, uint16_t len) {
-    uint32_t crc = 0xFFFFFFFF;
-    for (uint16_t i = 0; i < len; i++) {
-        crc ^= data[i];
-        for (int j = 0; j < 8; j++) {
-            if (crc & 1) {
-                crc = (crc >> 1) ^ 0xEDB88320;
-            } else {
-                crc >>= 1;
-            }
-        }
-    }
-    return ~crc;
-}
-
 // ============================================================================
 // NOTIFICATION CALLBACKS
 // ============================================================================
@@ -193,7 +191,11 @@ void ctrlNotifyCallback(NimBLERemoteCharacteristic* pChar,
         case RSP_HELLO:
             if (length >= 6) {
                 // Parse RSP_HELLO: [rsp][version][pmkid_lo][pmkid_hi][hs_lo][hs_hi][flags][dialogue_id]
+                // Revision 2 appends [chunk_lo][chunk_hi][window]
                 uint8_t version = (length >= 2) ? pData[1] : 0;
+                CallPapaMode::link = papaParseHelloRsp(pData, length, CallPapaMode::helloOfferChunk,
+                                                       PAPA_WINDOW_DEFAULT);
+                CallPapaMode::helloSentTime = 0;
                 
                 // Store in pending variables - will be processed in main loop
                 // Protected by mutex for safe cross-context access
@@ -210,13 +212,15 @@ void ctrlNotifyCallback(NimBLERemoteCharacteristic* pChar,
                 pendingHelloReceived = true;
                 taskEXIT_CRITICAL(&pendingMux);
                 
-                // Protocol version check (spec expects 0x01)
-                if (version != 0x01) {
-                    Serial.printf("[SON-OF-PIG] WARNING: Protocol version mismatch! Expected 0x01, got 0x%02X\n", version);
+                // Protocol version check (revision 1 to 3)
+                if (version < PAPA_PROTO_LEGACY || version > PAPA_PROTO_LATEST) {
+                    Serial.printf("[SON-OF-PIG] WARNING: Unknown protocol version 0x%02X, using 0x01\n", version);
                 }
                 
                 Serial.printf("[SON-OF-PIG] HELLO: version=0x%02X, %d PMKIDs, %d Handshakes, dialogue=%d\n", 
                               version, pendingPMKIDCount, pendingHSCount, pendingDialogueId);
+                Serial.printf("[SON-OF-PIG] Link: revision %d, %d-byte chunks, window %d\n",
+                              CallPapaMode::link.version, CallPapaMode::link.chunkSize, CallPapaMode::link.window);
             }
             break;
             
@@ -239,9 +243,34 @@ void ctrlNotifyCallback(NimBLERemoteCharacteristic* pChar,
                 CallPapaMode::progress.inProgress = true;
                 CallPapaMode::state = CallPapaMode::State::WAITING_CHUNKS;
                 Serial.printf("[SON-OF-PIG] SYNC_START: %d chunks expected\n", CallPapaMode::totalChunks);
+                
+                if (CallPapaMode::link.version >= PAPA_PROTO_WINDOWED) {
+                    // A resumed transfer lands behind the prefix we kept; anything
+                    // else overwrites it
+                    uint16_t offset = CallPapaMode::resumeOffset;
+                    uint32_t crcSoFar = offset ? CallPapaMode::resumePoint.crc : 0;
+                    if (offset == 0) CallPapaMode::resumePoint.valid = false;
+                    CallPapaMode::lastChunkTime = millis();
+                    if (!CallPapaMode::rxWindow.begin(CallPapaMode::rxBuffer + offset,
+                                                      CallPapaMode::RX_BUFFER_SIZE - offset,
+                                                      CallPapaMode::link.chunkSize, CallPapaMode::totalChunks,
+                                                      CallPapaMode::link.window, crcSoFar)) {
+                        // Can't hold it - skip this capture rather than stall the sync
+                        Serial.printf("[SON-OF-PIG] Capture too large (%d chunks), skipping\n", CallPapaMode::totalChunks);
+                        snprintf(CallPapaMode::lastError, sizeof(CallPapaMode::lastError), "Capture too large");
+                        CallPapaMode::sendCommand(CMD_ABORT);
+                        CallPapaMode::currentIndex++;
+                        CallPapaMode::progress.inProgress = false;
+                        CallPapaMode::requestNextCapture();
+                    }
+                }
             }
             break;
             
+        case PAPA_RSP_MANIFEST:
+            CallPapaMode::onManifest(pData, length);
+            break;
+            
         case RSP_OK:
             Serial.println("[SON-OF-PIG] OK");
             break;
@@ -276,57 +305,25 @@ void dataNotifyCallback(NimBLERemoteCharacteristic* pChar,
     if (length < 2) return;
     if (!CallPapaMode::isRunning()) return;  // Guard: don't process if stopped
     
+    if (CallPapaMode::link.version >= PAPA_PROTO_WINDOWED) {
+        CallPapaMode::onWindowedData(pData, length);
+        return;
+    }
+    
     uint16_t seq = pData[0] | (pData[1] << 8);
     
     // Check for end marker (0xFFFF)
-    if (seq == 0xFFFF && length >= 6) {
+    if (seq == PAPA_SEQ_END && length >= 6) {
         // End of transfer - verify CRC
         uint32_t receivedCRC = pData[2] | (pData[3] << 8) | (pData[4] << 16) | (pData[5] << 24);
-        uint32_t calculatedCRC = CallPapaMode::calculateCRC32(CallPapaMode::rxBuffer, CallPapaMode::rxBufferLen);
-        
-        if (receivedCRC == calculatedCRC) {
-            Serial.printf("[SON-OF-PIG] Transfer complete! CRC OK, %d bytes\n", CallPapaMode::rxBufferLen);
-            
-            // Save capture based on type
-            bool success = false;
-            if (CallPapaMode::currentType == 0x01) {
-                success = CallPapaMode::savePMKID(CallPapaMode::rxBuffer, CallPapaMode::rxBufferLen);
-                if (success) CallPapaMode::syncedPMKIDs++;
-            } else {
-                success = CallPapaMode::saveHandshake(CallPapaMode::rxBuffer, CallPapaMode::rxBufferLen);
-                if (success) CallPapaMode::syncedHandshakes++;
-            }
-            
-            if (success) {
-                CallPapaMode::totalSynced++;
-                // Mood celebration removed - happens after dialogue completes
-                // Silent transfer prevents dialogue message corruption
-            }
-            
-            // Mark synced on Sirloin
-            Serial.printf("[SON-OF-PIG] ===== SENDING CMD_MARK_SYNCED: type=0x%02X index=%d totalSynced=%d =====\n",
-                          CallPapaMode::currentType, CallPapaMode::currentIndex, CallPapaMode::totalSynced);
-            CallPapaMode::sendCommand(CMD_MARK_SYNCED, CallPapaMode::currentType, CallPapaMode::currentIndex);
-            
-            // Request next capture
-            CallPapaMode::currentIndex++;
-            CallPapaMode::progress.inProgress = false;
-            CallPapaMode::requestNextCapture();
-        } else {
-            Serial.printf("[SON-OF-PIG] CRC MISMATCH! Got 0x%08X, expected 0x%08X\n",
-                          receivedCRC, calculatedCRC);
-            snprintf(CallPapaMode::lastError, sizeof(CallPapaMode::lastError), "CRC mismatch");
-            // Retry same capture
-            CallPapaMode::rxBufferLen = 0;
-            CallPapaMode::receivedChunks = 0;
-            CallPapaMode::sendCommand(CMD_START_SYNC, CallPapaMode::currentType, CallPapaMode::currentIndex);
-        }
+        uint32_t calculatedCRC = crc32Update(0, CallPapaMode::rxBuffer, CallPapaMode::rxBufferLen);
+        CallPapaMode::onCaptureReceived(receivedCRC == calculatedCRC, receivedCRC, calculatedCRC);
         return;
     }
     
     // Regular data chunk
     uint8_t dataLen = length - 2;
-    uint16_t offset = seq * CHUNK_SIZE;
+    uint16_t offset = seq * CallPapaMode::link.chunkSize;
     
     if (offset + dataLen <= sizeof(CallPapaMode::rxBuffer)) {
         memcpy(CallPapaMode::rxBuffer + offset, pData + 2, dataLen);
@@ -390,7 +387,7 @@ void statusNotifyCallback(NimBLERemoteCharacteristic* pChar,
         Mood::setStatusMessage("CALL ACCEPTED!");
         
         // Send CMD_HELLO now that we're ready (no delay in callback!)
-        CallPapaMode::sendCommand(CMD_HELLO);
+        CallPapaMode::sendHello();
     }
 }
 
@@ -537,6 +534,10 @@ class ClientCallbacks : public NimBLEClientCallbacks {
         Serial.printf("[DEBUG-CB] Disconnect reason code: %d\n", reason);
         Serial.printf("[DEBUG-CB] Time since boot: %lu ms\n", millis());
         Serial.printf("[SON-OF-PIG] Disconnected from Sirloin (reason: %d)\n", reason);
+        CallPapaMode::saveResumePoint();
+        CallPapaMode::manifest.clear();  // Sirloin's list may change before we're back
+        CallPapaMode::manifestPending = false;
+        CallPapaMode::manifestWanted = false;
         CallPapaMode::state = CallPapaMode::State::IDLE;
         CallPapaMode::pCtrlChar = nullptr;
         CallPapaMode::pDataChar = nullptr;
@@ -603,13 +604,17 @@ void CallPapaMode::requestNextCapture() {
         return;
     }
     
+    // Revision 3: whatever the manifest page says is already on SD gets
+    // marked synced right here, no round trip each
+    while (skipKnownCapture()) {}
+    
     // First sync all PMKIDs, then all Handshakes
     if (currentType == 0x01) {
         // Still doing PMKIDs
         if (currentIndex < remotePMKIDCount) {
             rxBufferLen = 0;
             receivedChunks = 0;
-            sendCommand(CMD_START_SYNC, 0x01, currentIndex);
+            requestCapture(0x01, currentIndex);
             state = State::SYNCING;
             progress.captureType = 0;
             progress.captureIndex = currentIndex;
@@ -625,15 +630,15 @@ void CallPapaMode::requestNextCapture() {
         if (currentIndex < remoteHSCount) {
             rxBufferLen = 0;
             receivedChunks = 0;
-            sendCommand(CMD_START_SYNC, 0x02, currentIndex);
+            requestCapture(0x02, currentIndex);
             state = State::SYNCING;
             progress.captureType = 1;
             progress.captureIndex = currentIndex;
             Serial.printf("[SON-OF-PIG] Requesting Handshake %d/%d\n", currentIndex + 1, remoteHSCount);
         } else {
             // All done!
-            Serial.printf("[SON-OF-PIG] SYNC COMPLETE! %d PMKIDs, %d Handshakes\n",
-                          syncedPMKIDs, syncedHandshakes);
+            Serial.printf("[SON-OF-PIG] SYNC COMPLETE! %d PMKIDs, %d Handshakes (%d already on SD)\n",
+                          syncedPMKIDs, syncedHandshakes, skippedCaptures);
             state = State::SYNC_COMPLETE;
             progress.inProgress = false;
             
@@ -659,6 +664,241 @@ void CallPapaMode::requestNextCapture() {
     }
 }
 
+void CallPapaMode::sendHello() {
+    if (!pCtrlChar) return;
+    
+    if (helloLegacyRetry) {
+        // The revision 2 offer went unanswered - ask the way old Papa did
+        helloOfferChunk = PAPA_LEGACY_CHUNK;
+        sendCommand(CMD_HELLO);
+    } else {
+        // Offer revision 2 with chunks as big as the negotiated MTU allows.
+        // Sirloin firmware without it answers version 0x01 and we stay there.
+        helloOfferChunk = papaChunkForMtu(pClient ? pClient->getMTU() : 0);
+        uint8_t hello[PAPA_HELLO_LEN];
+        size_t n = papaBuildHello(hello, helloOfferChunk, PAPA_WINDOW_DEFAULT);
+        pCtrlChar->writeValue(hello, n, false);
+    }
+    link = papaLegacyLink();
+    helloSentTime = millis();
+    if (helloSentTime == 0) helloSentTime = 1;
+}
+
+void CallPapaMode::sendWindowAck() {
+    if (!pCtrlChar) return;
+    uint8_t ack[PAPA_ACK_LEN];
+    size_t n = rxWindow.takeAck(ack);
+    pCtrlChar->writeValue(ack, n, false);
+}
+
+// Revision 2 DATA: chunks arrive back to back, ACKs go out per half window
+// or when a hole shows up
+void CallPapaMode::onWindowedData(const uint8_t* pData, size_t length) {
+    uint16_t seq = pData[0] | (pData[1] << 8);
+    
+    if (seq == PAPA_SEQ_END) {
+        if (length < 6) return;
+        uint32_t crc = pData[2] | (pData[3] << 8) | (pData[4] << 16) | ((uint32_t)pData[5] << 24);
+        if (!rxWindow.onEnd(crc)) return;
+    } else if (!rxWindow.onChunk(seq, pData + 2, (uint16_t)(length - 2))) {
+        return;  // Duplicate, resend we already had, or a stale capture
+    }
+    
+    lastChunkTime = millis();
+    receivedChunks = rxWindow.receivedCount();
+    progress.currentChunk = receivedChunks;
+    progress.bytesReceived = resumeOffset + rxWindow.length();
+    
+    if (rxWindow.complete()) {
+        // CRC was folded in as the chunks landed (from the resumed prefix on)
+        rxBufferLen = resumeOffset + rxWindow.length();
+        bool ok = rxWindow.crcOk();
+        uint32_t receivedCRC = rxWindow.expectedCrc();
+        uint32_t calculatedCRC = rxWindow.crcValue();
+        rxWindow.reset();
+        onCaptureReceived(ok, receivedCRC, calculatedCRC);
+    } else if (rxWindow.ackDue()) {
+        sendWindowAck();
+    }
+}
+
+// Whole capture is in rxBuffer: save it and move on, or ask again on a bad CRC
+void CallPapaMode::onCaptureReceived(bool crcOk, uint32_t receivedCRC, uint32_t calculatedCRC) {
+    if (crcOk) {
+        Serial.printf("[SON-OF-PIG] Transfer complete! CRC OK, %d bytes\n", rxBufferLen);
+        
+        // Save capture based on type
+        bool success = false;
+        if (currentType == 0x01) {
+            success = savePMKID(rxBuffer, rxBufferLen);
+            if (success) syncedPMKIDs++;
+        } else {
+            success = saveHandshake(rxBuffer, rxBufferLen);
+            if (success) syncedHandshakes++;
+        }
+        
+        if (success) {
+            totalSynced++;
+            // Mood celebration removed - happens after dialogue completes
+            // Silent transfer prevents dialogue message corruption
+        }
+        
+        // Mark synced on Sirloin
+        Serial.printf("[SON-OF-PIG] ===== SENDING CMD_MARK_SYNCED: type=0x%02X index=%d totalSynced=%d =====\n",
+                      currentType, currentIndex, totalSynced);
+        sendCommand(CMD_MARK_SYNCED, currentType, currentIndex);
+        
+        // Request next capture
+        resumePoint.valid = false;
+        resumeOffset = 0;
+        currentIndex++;
+        progress.inProgress = false;
+        requestNextCapture();
+    } else {
+        Serial.printf("[SON-OF-PIG] CRC MISMATCH! Got 0x%08X, expected 0x%08X\n",
+                      receivedCRC, calculatedCRC);
+        snprintf(lastError, sizeof(lastError), "CRC mismatch");
+        // Retry same capture from the start - the kept prefix may be the bad part
+        rxBufferLen = 0;
+        receivedChunks = 0;
+        resumePoint.valid = false;
+        resumeOffset = 0;
+        sendStartSync(0);
+    }
+}
+
+// Revision 3 decides from the capture's manifest entry, asking for the
+// page first if it isn't here yet; older ones just ask for the capture
+void CallPapaMode::requestCapture(uint8_t type, uint16_t index) {
+    resumeOffset = 0;
+    if (link.version < PAPA_PROTO_RESUME || !pCtrlChar) {
+        sendCommand(CMD_START_SYNC, type, index);
+        return;
+    }
+    
+    const PapaDigest* d = manifest.find(type, index);
+    if (d) {
+        startCapture(*d);
+        return;
+    }
+    // A prefetch may already be on its way - onManifest() picks up from here
+    manifestWanted = true;
+    if (!manifestPending) sendGetManifest(type, index);
+}
+
+void CallPapaMode::sendStartSync(uint16_t offset) {
+    if (link.version >= PAPA_PROTO_RESUME && pCtrlChar) {
+        uint8_t cmd[PAPA_START_SYNC_LEN];
+        size_t n = papaBuildStartSync(cmd, currentType, currentIndex, offset);
+        pCtrlChar->writeValue(cmd, n, false);
+    } else {
+        sendCommand(CMD_START_SYNC, (uint8_t)currentType, currentIndex);
+    }
+}
+
+// One page: as many digests from `first` on as fit a notification
+void CallPapaMode::sendGetManifest(uint8_t type, uint16_t first) {
+    uint16_t count = type == 0x01 ? remotePMKIDCount : remoteHSCount;
+    if (!pCtrlChar || first >= count) return;
+    uint8_t fit = papaManifestFit(pClient ? pClient->getMTU() : 0);
+    uint8_t n = count - first < fit ? (uint8_t)(count - first) : fit;
+    uint8_t cmd[PAPA_GET_MANIFEST_LEN];
+    size_t len = papaBuildGetManifest(cmd, type, first, n);
+    pCtrlChar->writeValue(cmd, len, false);
+    manifestPending = true;
+}
+
+void CallPapaMode::onManifest(const uint8_t* data, size_t len) {
+    if (!manifest.parse(data, len)) return;
+    manifestPending = false;
+    if (!manifestWanted || state != State::SYNCING) return;  // Prefetch, kept for later
+    manifestWanted = false;
+    
+    if (manifest.count == 0 && manifest.type == currentType && manifest.first == currentIndex) {
+        // Sirloin has no digest for it: fetch it whole rather than ask forever
+        memset(&currentDigest, 0, sizeof(currentDigest));
+        sendStartSync(0);
+        return;
+    }
+    requestNextCapture();
+}
+
+// Current capture is in the manifest page and already on SD: count it as
+// synced, same as a save that found the file already there
+bool CallPapaMode::skipKnownCapture() {
+    if (link.version < PAPA_PROTO_RESUME) return false;
+    if (currentType == 0x01 && currentIndex >= remotePMKIDCount) {
+        currentType = 0x02;
+        currentIndex = 0;
+    }
+    const PapaDigest* d = manifest.find(currentType, currentIndex);
+    if (!d || !hasCapture(*d)) return false;
+    
+    Serial.printf("[SON-OF-PIG] Already have %02X%02X%02X%02X%02X%02X (%s), skipping transfer\n",
+                  d->bssid[0], d->bssid[1], d->bssid[2], d->bssid[3], d->bssid[4], d->bssid[5],
+                  d->type == 0x01 ? "PMKID" : "Handshake");
+    if (d->type == 0x01) syncedPMKIDs++;
+    else syncedHandshakes++;
+    totalSynced++;
+    skippedCaptures++;
+    sendCommand(CMD_MARK_SYNCED, currentType, currentIndex);
+    currentIndex++;
+    return true;
+}
+
+// Fetch a capture we don't have, from where a cut transfer left off
+void CallPapaMode::startCapture(const PapaDigest& d) {
+    currentDigest = d;
+    uint16_t offset = 0;
+    if (pClient && pClient->getPeerAddress() == resumeDevice) {
+        offset = papaResumeOffset(resumePoint, d);
+    }
+    if (offset > 0) {
+        Serial.printf("[SON-OF-PIG] Resuming capture at byte %d of %d\n", offset, d.length);
+    }
+    resumeOffset = offset;
+    sendStartSync(offset);
+    
+    // Last one on the page: its answer comes back while this transfers
+    if (manifest.endsAt(d.type, d.index)) {
+        if (d.type == 0x01 && d.index + 1 >= remotePMKIDCount) sendGetManifest(0x02, 0);
+        else sendGetManifest(d.type, d.index + 1);
+    }
+}
+
+// Same files savePMKID()/saveHandshake() would write - if it's there, they
+// would only have thrown the transfer away
+bool CallPapaMode::hasCapture(const PapaDigest& d) {
+    if (!Config::isSDAvailable()) return false;
+    
+    char filename[64];
+    if (d.type == 0x01) {
+        snprintf(filename, sizeof(filename), "/handshakes/%02X%02X%02X%02X%02X%02X.22000",
+                 d.bssid[0], d.bssid[1], d.bssid[2], d.bssid[3], d.bssid[4], d.bssid[5]);
+    } else {
+        snprintf(filename, sizeof(filename), "/handshakes/%02X%02X%02X%02X%02X%02X.pcap",
+                 d.bssid[0], d.bssid[1], d.bssid[2], d.bssid[3], d.bssid[4], d.bssid[5]);
+    }
+    return SD.exists(filename);
+}
+
+// Link going away mid-transfer: keep the in-order prefix so the next call
+// to this Sirloin picks up from there instead of byte 0
+void CallPapaMode::saveResumePoint() {
+    if (link.version < PAPA_PROTO_RESUME || !rxWindow.isActive()) return;
+    uint32_t bytes = resumeOffset + rxWindow.contiguousLength();
+    if (bytes > 0 && pClient) {
+        resumePoint.valid = true;
+        resumePoint.digest = currentDigest;
+        resumePoint.bytes = (uint16_t)bytes;
+        resumePoint.crc = rxWindow.crcValue();
+        resumeDevice = pClient->getPeerAddress();
+        Serial.printf("[SON-OF-PIG] Transfer cut at %lu/%d bytes, will resume\n",
+                      (unsigned long)bytes, currentDigest.length);
+    }
+    rxWindow.reset();
+}
+
 // ============================================================================
 // PUBLIC API
 // ============================================================================
@@ -678,6 +918,16 @@ void CallPapaMode::init() {
     progress = {0};
     currentType = 0;
     currentIndex = 0;
+    link = papaLegacyLink();
+    helloSentTime = 0;
+    helloLegacyRetry = false;
+    rxWindow.reset();
+    manifest.clear();
+    manifestPending = false;
+    manifestWanted = false;
+    resumePoint.valid = false;
+    resumeOffset = 0;
+    skippedCaptures = 0;
     state = State::IDLE;
     lastError[0] = '\0';
     dialogueState = DialogueState::IDLE;
@@ -707,6 +957,8 @@ void CallPapaMode::start() {
         Serial.println("[SON-OF-PIG] Initializing NimBLE...");
         NimBLEDevice::init("PORKCHOP");
         NimBLEDevice::setPower(ESP_PWR_LVL_P9);  // Max power for range
+        // Exchanged on connect; revision 2 sizes its chunks to whatever we get
+        NimBLEDevice::setMTU(PAPA_MTU_PREFERRED);
         bleInitialized = true;
     }
     
@@ -866,6 +1118,25 @@ void CallPapaMode::update() {
         }
     }
     
+    // === HELLO FALLBACK ===
+    // Sirloin firmware that doesn't understand the revision 2 offer may not
+    // answer it at all - ask again with the bare revision 1 HELLO
+    if (state == State::CONNECTED && helloSentTime != 0 && !helloLegacyRetry &&
+        (millis() - helloSentTime) > HELLO_OFFER_TIMEOUT_MS) {
+        Serial.println("[SON-OF-PIG] No answer to revision 2 HELLO, retrying as revision 1");
+        helloLegacyRetry = true;
+        sendHello();
+    }
+    
+    // === WINDOW ACK WATCHDOG ===
+    // Chunks stopped arriving mid-capture: our last ACK or the tail may be
+    // lost, so tell Sirloin again what we have
+    if (state == State::WAITING_CHUNKS && link.version >= PAPA_PROTO_WINDOWED && rxWindow.isActive() &&
+        (millis() - lastChunkTime) > ACK_STALL_MS) {
+        lastChunkTime = millis();
+        sendWindowAck();
+    }
+    
     // === PROCESS PENDING EVENTS FROM BLE CALLBACKS ===
     // This safely moves state changes from callback context to main loop
     // Protected by mutex to prevent race with BLE callback
@@ -1264,10 +1535,14 @@ bool CallPapaMode::connectTo(uint8_t deviceIndex) {
     // We will send CMD_HELLO only after receiving READY flag in statusNotifyCallback
     Serial.printf("[DEBUG] T+%lu: === ALL SUBSCRIPTIONS COMPLETE ===\n", millis() - connTime);
     Serial.printf("[DEBUG] T+%lu: Final connection check: %d\n", millis() - connTime, pClient->isConnected());
+    Serial.printf("[DEBUG] T+%lu: ATT MTU: %d\n", millis() - connTime, pClient->getMTU());
     Serial.printf("[DEBUG] T+%lu: Setting state to CONNECTED_WAITING_READY\n", millis() - connTime);
     
     state = State::CONNECTED_WAITING_READY;
     readyFlagReceived = false;
+    link = papaLegacyLink();
+    helloSentTime = 0;
+    helloLegacyRetry = false;
     connectionStartTime = millis();
     device.syncing = true;
     
@@ -1287,6 +1562,8 @@ void CallPapaMode::disconnect() {
     Serial.printf("[SON-OF-PIG] DISCONNECT: pClient=%p, isConnected=%d, state=%d\n", 
                   pClient, pClient ? pClient->isConnected() : -1, (int)state);
     
+    saveResumePoint();
+    
     // CRITICAL FIX: Unsubscribe from all characteristics BEFORE disconnect
     // This prevents mbuf pool exhaustion by freeing notification resources
     if (pClient && pClient->isConnected()) {
@@ -1379,8 +1656,12 @@ bool CallPapaMode::startSync() {
     totalSynced = 0;
     syncedPMKIDs = 0;
     syncedHandshakes = 0;
+    skippedCaptures = 0;
     currentType = 0x01;  // Start with PMKIDs
     currentIndex = 0;
+    manifest.clear();
+    manifestPending = false;
+    manifestWanted = false;
     
     Serial.printf("[SON-OF-PIG] Starting sync: %d PMKIDs, %d Handshakes\n",
                   remotePMKIDCount, remoteHSCount);
@@ -1512,15 +1793,17 @@ bool CallPapaMode::savePMKID(const uint8_t* data, uint16_t len) {
     snprintf(txtFilename, sizeof(txtFilename), "/handshakes/%02X%02X%02X%02X%02X%02X_pmkid.txt",
              bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
     
+    char ssidCopy[33];
+    strncpy(ssidCopy, ssid, ssidLen);
+    ssidCopy[ssidLen] = '\0';
     File txtFile = SD.open(txtFilename, FILE_WRITE);
     if (txtFile) {
-        char ssidCopy[33];
-        strncpy(ssidCopy, ssid, ssidLen);
-        ssidCopy[ssidLen] = '\0';
         txtFile.println(ssidCopy);
         txtFile.close();
     }
     
+    CaptureManifest::recordSaved(bssid, ssidCopy, CaptureKind::PMKID, CAPTURE_FILE_PMKID, filename);
+    
     Serial.printf("[SON-OF-PIG] PMKID saved: %s (SSID: %.*s)\n", filename, ssidLen, ssid);
     SDLog::log("SON-OF-PIG", "PMKID synced from Sirloin: %.*s", ssidLen, ssid);
     
@@ -1727,15 +2010,17 @@ bool CallPapaMode::saveHandshake(const uint8_t* data, uint16_t len) {
     snprintf(txtFilename, sizeof(txtFilename), "/handshakes/%02X%02X%02X%02X%02X%02X.txt",
              bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
     
+    char ssidCopy[33];
+    strncpy(ssidCopy, ssid, ssidLen);
+    ssidCopy[ssidLen] = '\0';
     File txtFile = SD.open(txtFilename, FILE_WRITE);
     if (txtFile) {
-        char ssidCopy[33];
-        strncpy(ssidCopy, ssid, ssidLen);
-        ssidCopy[ssidLen] = '\0';
         txtFile.println(ssidCopy);
         txtFile.close();
     }
     
+    CaptureManifest::recordSaved(bssid, ssidCopy, CaptureKind::HANDSHAKE, CAPTURE_FILE_PCAP, pcapFilename);
+    
     Serial.printf("[SON-OF-PIG] Handshake saved: %s (SSID: %.*s)\n", pcapFilename, ssidLen, ssid);
     SDLog::log("SON-OF-PIG", "Handshake synced from Sirloin: %.*s", ssidLen, ssid);
     
@@ -6,6 +6,9 @@
  * 
  * Protocol: PRKCHAP3LINKSYNK
  * Data flow: Sirloin (child) -> Papa (parent)
+ * Revision 2 (windowed, MTU-sized chunks) and 3 (digest skip, resume)
+ * are negotiated in HELLO, see papa_protocol.h; older Sirloins stay on
+ * revision 1.
  * 
  * READY TO PCAP YOUR PHONE. LOL.
  */
@@ -14,6 +17,7 @@
 #include <Arduino.h>
 #include <NimBLEDevice.h>
 #include <vector>
+#include "papa_protocol.h"
 
 // Connection state for discovered Sirloin devices
 struct SirloinDevice {
@@ -76,7 +80,9 @@ public:
     static uint16_t getRemoteHandshakeCount() { return remoteHSCount; }
     static uint16_t getTotalSynced() { return totalSynced; }
     static uint16_t getSyncedCount() { return syncedPMKIDs + syncedHandshakes; }
+    static uint16_t getSkippedCount() { return skippedCaptures; }  // Already on SD, not transferred
     static uint16_t getTotalToSync() { return remotePMKIDCount + remoteHSCount; }
+    static const PapaLink& getLink() { return link; }
     
     // UI selection
     static void selectDevice(uint8_t index);
@@ -128,6 +134,7 @@ private:
     static uint16_t totalSynced;
     static uint16_t syncedPMKIDs;
     static uint16_t syncedHandshakes;
+    static uint16_t skippedCaptures;
     
     // Status characteristic state
     static bool readyFlagReceived;
@@ -157,6 +164,25 @@ private:
     static uint16_t totalChunks;
     static uint16_t receivedChunks;
     
+    // Protocol revision agreed in HELLO
+    static PapaLink link;
+    static uint16_t helloOfferChunk;
+    static uint32_t helloSentTime;        // 0 once RSP_HELLO arrived
+    static bool helloLegacyRetry;         // Offer went unanswered, sent a bare HELLO
+    static PapaRxWindow rxWindow;         // Revision 2 receive state
+    static uint32_t lastChunkTime;
+    
+    // Revision 3: digests of the captures around this one, what the
+    // current capture is, and where an interrupted one left off (its
+    // prefix stays in rxBuffer)
+    static PapaManifest manifest;
+    static bool manifestPending;          // CMD_GET_MANIFEST sent, no answer yet
+    static bool manifestWanted;           // Sync is waiting on that answer
+    static PapaDigest currentDigest;
+    static uint16_t resumeOffset;         // Where the current transfer started
+    static PapaResumePoint resumePoint;
+    static NimBLEAddress resumeDevice;
+    
     // Transfer state
     static SyncProgress progress;
     static uint8_t rxBuffer[];
@@ -172,7 +198,18 @@ private:
     static void sendCommand(uint8_t cmd, uint8_t param1, uint8_t param2);
     static void sendCommand(uint8_t cmd, uint8_t type, uint16_t index);
     static void requestNextCapture();
-    static uint32_t calculateCRC32(const uint8_t* data, uint16_t len);
+    static void requestCapture(uint8_t type, uint16_t index);
+    static void sendStartSync(uint16_t offset);
+    static void sendGetManifest(uint8_t type, uint16_t first);
+    static void onManifest(const uint8_t* data, size_t len);
+    static bool skipKnownCapture();
+    static void startCapture(const PapaDigest& d);
+    static bool hasCapture(const PapaDigest& d);
+    static void saveResumePoint();
+    static void sendHello();
+    static void sendWindowAck();
+    static void onWindowedData(const uint8_t* data, size_t len);
+    static void onCaptureReceived(bool crcOk, uint32_t receivedCRC, uint32_t calculatedCRC);
     
     // Saving
     static bool savePMKID(const uint8_t* data, uint16_t len);
@@ -181,4 +218,6 @@ private:
     // Constants
     static const uint16_t RX_BUFFER_SIZE = 2048;
     static const uint16_t SCAN_DURATION = 2;  // seconds - auto-retry every 2s until Sirloin found
+    static const uint32_t HELLO_OFFER_TIMEOUT_MS = 3000;  // Then retry with a bare revision 1 HELLO
+    static const uint32_t ACK_STALL_MS = 250;             // Re-send the window ACK if chunks stop
 };
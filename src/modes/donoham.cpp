@@ -9,6 +9,9 @@
 #include "../core/sdlog.h"
 #include "../core/xp.h"
 #include "../core/wsl_bypasser.h"
+#include "../core/bssid_index.h"
+#include "../core/beacon_view.h"
+#include "../core/capture_manifest.h"
 #include "../ui/display.h"
 #include "../piglet/mood.h"
 #include "../piglet/avatar.h"
@@ -67,6 +70,9 @@ uint8_t DoNoHamMode::lastCycleActivity = 0;
 // Guard flag for race condition prevention
 static volatile bool dnhBusy = false;
 
+// BSSID -> networks[] position (rebuilt after age-out)
+static BssidIndex<256> networkIndex;
+
 // Single-slot deferred network add (same pattern as OINK)
 static volatile bool pendingNetworkAdd = false;
 static DetectedNetwork pendingNetwork;
@@ -86,11 +92,19 @@ static PendingPMKIDCreate pendingPMKIDCreate;
 // Single-slot deferred handshake frame add (now stores all 4 frames)
 static volatile bool pendingHandshakeAdd = false;
 static volatile bool pendingHandshakeBusy = false;
+// Callback-side staging copy - moved into the frame pool on the main thread
+struct PendingEAPOLFrame {
+    uint8_t data[EAPOL_MAX_PAYLOAD];
+    uint8_t fullFrame[EAPOL_MAX_FRAME];
+    uint16_t len;
+    uint16_t fullFrameLen;
+    int8_t rssi;
+};
 struct PendingHandshakeFrame {
     uint8_t bssid[6];
     uint8_t station[6];
     uint8_t messageNum;  // DEPRECATED - kept for compatibility
-    EAPOLFrame frames[4];  // Store all 4 EAPOL frames (M1-M4)
+    PendingEAPOLFrame frames[4];  // Store all 4 EAPOL frames (M1-M4)
     uint8_t capturedMask;  // Bitmask: bit0=M1, bit1=M2, bit2=M3, bit3=M4
 };
 static PendingHandshakeFrame pendingHandshake;
@@ -124,8 +138,12 @@ void DoNoHamMode::start() {
     // Clear previous session data
     networks.clear();
     networks.shrink_to_fit();
+    networkIndex.clear();
     pmkids.clear();
     pmkids.shrink_to_fit();
+    for (auto& hs : handshakes) {
+        OinkMode::releaseHandshake(hs);
+    }
     handshakes.clear();
     handshakes.shrink_to_fit();
     incompleteHandshakes.clear();
@@ -249,18 +267,16 @@ void DoNoHamMode::stop() {
     saveAllPMKIDs();
     saveAllHandshakes();
     
-    // Free per-handshake beacon memory to prevent leaks
+    // Free per-handshake frame and beacon memory to prevent leaks
     for (auto& hs : handshakes) {
-        if (hs.beaconData) {
-            free(hs.beaconData);
-            hs.beaconData = nullptr;
-        }
+        OinkMode::releaseHandshake(hs);
     }
     
     // Clear vectors
     dnhBusy = true;
     networks.clear();
     networks.shrink_to_fit();
+    networkIndex.clear();
     pmkids.clear();
     pmkids.shrink_to_fit();
     handshakes.clear();
@@ -329,6 +345,7 @@ void DoNoHamMode::update() {
             } else {
                 // Add new
                 networks.push_back(pendingNetwork);
+                networkIndex.insert(pendingNetwork.bssid, networks.size() - 1);
                 XP::addXP(XPEvent::DNH_NETWORK_PASSIVE);
             }
         }
@@ -413,22 +430,15 @@ void DoNoHamMode::update() {
             for (int msgIdx = 0; msgIdx < 4; msgIdx++) {
                 if (pendingHandshake.capturedMask & (1 << msgIdx)) {
                     // Frame is present in the queued data
-                    if (hs.frames[msgIdx].len == 0) {  // Not already captured
-                        uint16_t copyLen = pendingHandshake.frames[msgIdx].len;
-                        if (copyLen > 0 && copyLen <= 512) {
-                            // EAPOL payload for hashcat 22000
-                            memcpy(hs.frames[msgIdx].data, pendingHandshake.frames[msgIdx].data, copyLen);
-                            hs.frames[msgIdx].len = copyLen;
+                    if (hs.frames[msgIdx].len == 0 && !hs.saved) {  // Not already captured
+                        const PendingEAPOLFrame& pf = pendingHandshake.frames[msgIdx];
+                        // EAPOL payload for hashcat 22000 + full 802.11 frame for PCAP export
+                        if (pf.len > 0 &&
+                            OinkMode::storeEAPOLFrame(hs.frames[msgIdx], pf.data, pf.len,
+                                                      pf.fullFrame, pf.fullFrameLen)) {
                             hs.frames[msgIdx].messageNum = msgIdx + 1;
                             hs.frames[msgIdx].timestamp = now;
-                            
-                            // Full 802.11 frame for PCAP export (radiotap + WPA-SEC)
-                            uint16_t fullCopyLen = pendingHandshake.frames[msgIdx].fullFrameLen;
-                            if (fullCopyLen > 0 && fullCopyLen <= 300) {
-                                memcpy(hs.frames[msgIdx].fullFrame, pendingHandshake.frames[msgIdx].fullFrame, fullCopyLen);
-                                hs.frames[msgIdx].fullFrameLen = fullCopyLen;
-                                hs.frames[msgIdx].rssi = pendingHandshake.frames[msgIdx].rssi;
-                            }
+                            hs.frames[msgIdx].rssi = pf.rssi;
                             
                             hs.capturedMask |= (1 << msgIdx);
                             hs.lastSeen = now;
@@ -711,6 +721,7 @@ void DoNoHamMode::ageOutStaleNetworks() {
             ++it;
         }
     }
+    networkIndex.rebuild(networks.data(), networks.size());
 }
 
 void DoNoHamMode::saveAllPMKIDs() {
@@ -833,6 +844,8 @@ void DoNoHamMode::saveAllPMKIDs() {
             txtFile.close();
         }
         
+        CaptureManifest::recordSaved(p.bssid, p.ssid, CaptureKind::PMKID, CAPTURE_FILE_PMKID, filename);
+        
         p.saved = true;
         Serial.printf("[DNH] PMKID saved: %s\\n", filename);
         SDLog::log("DNH", "PMKID saved: %s (%s)", p.ssid, filename);
@@ -1004,6 +1017,7 @@ void DoNoHamMode::saveAllHandshakes() {
             hs.bssid[0], hs.bssid[1], hs.bssid[2], hs.bssid[3], hs.bssid[4], hs.bssid[5]);
         
         File pcapFile = SD.open(pcapFilename, FILE_WRITE);
+        bool pcapOk = false;
         if (pcapFile) {
             // Write PCAP global header
             DNH_PCAPHeader hdr = {
@@ -1041,7 +1055,7 @@ void DoNoHamMode::saveAllHandshakes() {
                 if (frame.len == 0) continue;
                 
                 // Prefer fullFrame if available
-                if (frame.fullFrameLen > 0 && frame.fullFrameLen <= 300) {
+                if (frame.fullFrameLen > 0) {
                     uint32_t totalLen = sizeof(DNH_RADIOTAP_HEADER) + frame.fullFrameLen;
                     DNH_PCAPPacketHeader pkt = {
                         .ts_sec = frame.timestamp / 1000,
@@ -1057,22 +1071,22 @@ void DoNoHamMode::saveAllHandshakes() {
             }
             
             pcapFile.close();
+            pcapOk = true;
             Serial.printf("[DNH] PCAP saved: %s (%d packets)\n", pcapFilename, packetCount);
         }
         
+        CaptureManifest::recordSaved(hs.bssid, hs.ssid, CaptureKind::HANDSHAKE,
+                                     CAPTURE_FILE_HS22000 | (pcapOk ? CAPTURE_FILE_PCAP : 0), filename);
+        
         hs.saved = true;
+        OinkMode::releaseHandshake(hs);  // On SD now - give the frame bytes back
         Serial.printf("[DNH] Handshake saved: %s\\n", filename);
         SDLog::log("DNH", "Handshake saved: %s (%s)", hs.ssid, filename);
     }
 }
 
 int DoNoHamMode::findNetwork(const uint8_t* bssid) {
-    for (size_t i = 0; i < networks.size(); i++) {
-        if (memcmp(networks[i].bssid, bssid, 6) == 0) {
-            return i;
-        }
-    }
-    return -1;
+    return networkIndex.find(bssid, networks.data(), networks.size());
 }
 
 int DoNoHamMode::findOrCreatePMKID(const uint8_t* bssid) {
@@ -1100,21 +1114,34 @@ int DoNoHamMode::findOrCreateHandshake(const uint8_t* bssid, const uint8_t* stat
             return i;
         }
     }
+    // At the limit, recycle the stalest partial handshake (complete ones are kept)
+    int slot = -1;
+    if (OinkMode::handshakeTableFull(handshakes, DNH_MAX_HANDSHAKES)) {
+        for (size_t i = 0; i < handshakes.size(); i++) {
+            if (handshakes[i].hasValidPair()) continue;
+            if (slot < 0 || handshakes[i].lastSeen < handshakes[slot].lastSeen) {
+                slot = i;
+            }
+        }
+        if (slot < 0) return -1;
+        OinkMode::releaseHandshake(handshakes[slot]);
+    }
     // Create new
-    if (handshakes.size() < DNH_MAX_HANDSHAKES) {
-        CapturedHandshake hs = {};
-        memcpy(hs.bssid, bssid, 6);
-        memcpy(hs.station, station, 6);
-        hs.capturedMask = 0;
-        hs.firstSeen = millis();
-        hs.lastSeen = hs.firstSeen;
-        hs.saved = false;
-        hs.beaconData = nullptr;
-        hs.beaconLen = 0;
-        handshakes.push_back(hs);
-        return handshakes.size() - 1;
+    CapturedHandshake hs = {};
+    memcpy(hs.bssid, bssid, 6);
+    memcpy(hs.station, station, 6);
+    hs.capturedMask = 0;
+    hs.firstSeen = millis();
+    hs.lastSeen = hs.firstSeen;
+    hs.saved = false;
+    hs.beaconData = nullptr;
+    hs.beaconLen = 0;
+    if (slot >= 0) {
+        handshakes[slot] = hs;
+        return slot;
     }
-    return -1;
+    handshakes.push_back(hs);
+    return handshakes.size() - 1;
 }
 
 // Frame handlers - called from shared promiscuous callback
@@ -1122,32 +1149,13 @@ void DoNoHamMode::handleBeacon(const uint8_t* frame, uint16_t len, int8_t rssi)
     if (!running) return;
     if (dnhBusy) return;  // Skip if update() is processing vectors
     
-    // Beacon frame structure:
-    // [0-1] Frame Control, [2-3] Duration, [4-9] DA, [10-15] SA (BSSID), [16-21] BSSID
-    // [22-23] Seq, [24-35] Timestamp, [36-37] Beacon Interval, [38-39] Capability
-    // [40+] IEs
-    
-    if (len < 40) return;
+    // Single pass over the IEs (starts at 36, after the 12 bytes of fixed fields)
+    BeaconView view;
+    if (!view.parse(frame, len)) return;
     
-    const uint8_t* bssid = frame + 16;
-    
-    // Parse SSID from IE 0
-    char ssid[33] = {0};
-    uint16_t offset = 36;  // Start of fixed fields after header
-    offset += 12;  // Skip timestamp(8) + beacon_interval(2) + capability(2)
-    
-    while (offset + 2 < len) {
-        uint8_t ieType = frame[offset];
-        uint8_t ieLen = frame[offset + 1];
-        if (offset + 2 + ieLen > len) break;
-        
-        if (ieType == 0 && ieLen > 0 && ieLen <= 32) {
-            memcpy(ssid, frame + offset + 2, ieLen);
-            ssid[ieLen] = 0;
-            break;
-        }
-        offset += 2 + ieLen;
-    }
+    const uint8_t* bssid = view.bssid;
+    char ssid[33];
+    view.copySSID(ssid);
     
     // Check if this resolves a pending PMKID dwell
     if (state == DNHState::DWELLING && ssid[0] != 0) {
@@ -1378,12 +1386,12 @@ void DoNoHamMode::handleEAPOL(const uint8_t* frame, uint16_t len, int8_t rssi) {
             uint8_t frameIdx = messageNum - 1;
             if (frameIdx < 4) {
                 // EAPOL payload for hashcat 22000
-                uint16_t copyLen = min((uint16_t)512, eapolLen);
+                uint16_t copyLen = min(EAPOL_MAX_PAYLOAD, eapolLen);
                 memcpy(pendingHandshake.frames[frameIdx].data, eapol, copyLen);
                 pendingHandshake.frames[frameIdx].len = copyLen;
                 
                 // Full 802.11 frame for PCAP export (radiotap + WPA-SEC compatibility)
-                uint16_t fullCopyLen = min((uint16_t)300, len);
+                uint16_t fullCopyLen = min(EAPOL_MAX_FRAME, len);
                 memcpy(pendingHandshake.frames[frameIdx].fullFrame, frame, fullCopyLen);
                 pendingHandshake.frames[frameIdx].fullFrameLen = fullCopyLen;
                 pendingHandshake.frames[frameIdx].rssi = rssi;
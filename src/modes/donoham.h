@@ -10,7 +10,7 @@
 // DNH-specific constants
 static const size_t DNH_MAX_NETWORKS = 100;
 static const size_t DNH_MAX_PMKIDS = 50;
-static const size_t DNH_MAX_HANDSHAKES = 25;
+static const size_t DNH_MAX_HANDSHAKES = MAX_POOLED_HANDSHAKES;  // What the frame pool can back, stale partials recycled
 static const uint32_t DNH_STALE_TIMEOUT = 30000;  // 30s
 static const uint16_t DNH_HOP_INTERVAL = 200;     // Legacy default (now adaptive)
 static const uint16_t DNH_DWELL_TIME = 300;       // 300ms dwell for SSID
@@ -7,6 +7,13 @@
 #include "../core/wsl_bypasser.h"
 #include "../core/sdlog.h"
 #include "../core/xp.h"
+#include "../core/frame_ring.h"
+#include "../core/bssid_index.h"
+#include "../core/beacon_view.h"
+#include "../core/pcapng_session.h"
+#include "../core/slab_pool.h"
+#include "../core/perf_trace.h"
+#include "../core/capture_manifest.h"
 #include "../ui/display.h"
 #include "../piglet/mood.h"
 #include "../piglet/avatar.h"
@@ -16,90 +23,35 @@
 #include <esp_wifi.h>
 #include <SD.h>
 #include <algorithm>
-#include <cstdarg>  // For va_list in deferred logging
-
-// Simple flag to avoid concurrent access between promiscuous callback and main thread
-// The promiscuous callback runs in WiFi task context (not true ISR), but still needs
-// synchronization to prevent race conditions on networks/handshakes vectors
-static volatile bool oinkBusy = false;
 
 // Minimum free heap to allow network additions (30KB safety margin)
 static const size_t HEAP_MIN_THRESHOLD = 30000;
 
-// ============ Deferred Event System ============
-// Callback sets flags/data, update() processes them in main thread context
-// This avoids heap operations, String allocations, and Serial.printf in callback
-
-// Pending network to add (callback copies data here, update() does push_back)
-static volatile bool pendingNetworkAdd = false;
-static DetectedNetwork pendingNetwork;
-
-// Pending mood events (callback sets flag, update() calls Mood functions)
-static volatile bool pendingNewNetwork = false;
-static char pendingNetworkSSID[33] = {0};
-static int8_t pendingNetworkRSSI = 0;
-static uint8_t pendingNetworkChannel = 0;
-
-static volatile bool pendingDeauthSuccess = false;
-static uint8_t pendingDeauthStation[6] = {0};
-
-static volatile bool pendingHandshakeComplete = false;
-static char pendingHandshakeSSID[33] = {0};
-static volatile bool pendingAutoSave = false;  // Trigger autoSaveCheck from main loop
-
-static volatile bool pendingPMKIDCapture = false;
-static char pendingPMKIDSSID[33] = {0};
-
-// Pending handshake/PMKID creation (callback queues, update() does push_back)
-// This avoids vector reallocation in callback context
-struct PendingHandshakeCreate {
-    uint8_t bssid[6];
-    uint8_t station[6];
-    uint8_t messageNum;        // DEPRECATED - used only for logging now
-    EAPOLFrame frames[4];      // Store all 4 EAPOL frames (M1-M4)
-    uint8_t capturedMask;      // Bitmask: bit0=M1, bit1=M2, bit2=M3, bit3=M4
-    uint8_t pmkid[16];         // If M1, may contain PMKID
-    bool hasPMKID;
-};
-static volatile bool pendingHandshakeCreateBusy = false;
-static volatile bool pendingHandshakeCreateReady = false;
-static PendingHandshakeCreate pendingHandshakeCreate;
-
-struct PendingPMKIDCreate {
-    uint8_t bssid[6];
-    uint8_t station[6];
-    uint8_t pmkid[16];
-    char ssid[33];
-};
-static volatile bool pendingPMKIDCreateBusy = false;
-static volatile bool pendingPMKIDCreateReady = false;
-static PendingPMKIDCreate pendingPMKIDCreate;
-
-// Pending log messages (simple ring buffer for debug output)
-#define PENDING_LOG_SIZE 4
-#define PENDING_LOG_LEN 96
-static char pendingLogs[PENDING_LOG_SIZE][PENDING_LOG_LEN];
-static volatile uint8_t pendingLogHead = 0;
-static volatile uint8_t pendingLogTail = 0;
-
-static void queueLog(const char* fmt, ...) {
-    // Lock-free single-producer (callback) queue
-    uint8_t next = (pendingLogHead + 1) % PENDING_LOG_SIZE;
-    if (next == pendingLogTail) return;  // Full, drop message
-    
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(pendingLogs[pendingLogHead], PENDING_LOG_LEN, fmt, args);
-    va_end(args);
-    pendingLogHead = next;
-}
-
-static void flushLogs() {
-    while (pendingLogTail != pendingLogHead) {
-        Serial.println(pendingLogs[pendingLogTail]);
-        pendingLogTail = (pendingLogTail + 1) % PENDING_LOG_SIZE;
-    }
-}
+// ============ Frame Ring ============
+// Promiscuous callback only copies frames into this SPSC ring; update() drains
+// it in main thread context. All networks/handshakes/pmkids access happens on
+// the main thread, so there is no busy flag and no frame is dropped just
+// because update() happens to be touching the vectors.
+static const size_t OINK_RING_BYTES = 12288;       // ~40 beacons or ~300 data headers
+static const uint16_t RING_MGMT_SNAP = 1500;       // Beacon/probe resp kept whole (MAX_BEACON_SIZE) for the PCAP
+static const uint16_t RING_EAPOL_SNAP = 600;       // EAPOL frames kept whole (512 payload + headers)
+static const uint16_t RING_DATA_SNAP = 32;         // Plain data frames: header + LLC (client tracking)
+static const uint16_t RING_MAX_SNAP = RING_MGMT_SNAP > RING_EAPOL_SNAP ? RING_MGMT_SNAP : RING_EAPOL_SNAP;  // Session PCAPNG snaplen
+static const uint32_t DRAIN_BUDGET_MS = 20;        // Max time per update() spent draining
+static FrameRing<OINK_RING_BYTES> frameRing;
+
+// BSSID -> networks[] position, rebuilt whenever the vector is reordered
+static BssidIndex<512> networkIndex;
+
+// Set while draining when a capture needs SD I/O (run once after the drain)
+static bool saveRequested = false;
+
+// ============ Handshake Frame Pool ============
+// EAPOL frames live in 32-byte cells instead of fixed 812-byte arrays, so a
+// partial handshake costs its captured bytes (~200 per message) rather than
+// 3.3KB. Shared with DNH; pages only grow while the heap is above threshold.
+static SlabPool<EAPOL_POOL_CELL, EAPOL_POOL_PAGES> framePool;
+static_assert(decltype(framePool)::PAGE_SIZE * EAPOL_POOL_PAGES == EAPOL_POOL_BYTES, "EAPOL_POOL_BYTES out of date");
 
 // Static members
 bool OinkMode::running = false;
@@ -136,9 +88,10 @@ uint8_t currentHopIndex = 0;
 
 // Memory limits to prevent OOM
 const size_t MAX_NETWORKS = 200;       // Max tracked networks
-const size_t MAX_HANDSHAKES = 50;      // Max handshakes (each can be large)
+const size_t MAX_HANDSHAKES = MAX_POOLED_HANDSHAKES;  // What the frame pool can back (stale partials evicted)
 const size_t MAX_PMKIDS = 50;          // Max PMKIDs (smaller than handshakes)
 const uint16_t MAX_BEACON_SIZE = 1500; // IEEE 802.11 practical limit (protect against oversized/malformed frames)
+static_assert(RING_MGMT_SNAP >= MAX_BEACON_SIZE, "Stored beacons must come out of the ring untrimmed");
 
 // Deauth timing
 static uint32_t lastDeauthTime = 0;
@@ -189,32 +142,22 @@ static bool boredStateReset = true;  // Flag to reset on start()
 static String lastPwnedSSID = "";
 
 void OinkMode::init() {
-    // Reset busy flag in case of abnormal stop
-    oinkBusy = false;
-    
-    // Reset deferred event system
-    pendingNetworkAdd = false;
-    pendingNewNetwork = false;
-    pendingDeauthSuccess = false;
-    pendingHandshakeComplete = false;
-    pendingPMKIDCapture = false;
-    pendingLogHead = 0;
-    pendingLogTail = 0;
+    // Drop any frames left over from a previous session
+    frameRing.reset();
+    saveRequested = false;
     
     // Reset bored state tracking
     consecutiveFailedScans = 0;
     lastBoredUpdate = 0;
     boredStateReset = true;
     
-    // Free per-handshake beacon memory
+    // Free per-handshake frame and beacon memory
     for (auto& hs : handshakes) {
-        if (hs.beaconData) {
-            free(hs.beaconData);
-            hs.beaconData = nullptr;
-        }
+        releaseHandshake(hs);
     }
     
     networks.clear();
+    networkIndex.clear();
     handshakes.clear();
     pmkids.clear();
     targetIndex = -1;
@@ -290,6 +233,11 @@ void OinkMode::start() {
     stateStartTime = millis();
     selectionIndex = 0;
     
+    // Optional full-session capture (Settings > PCAPNG)
+    if (Config::wifi().sessionCapture) {
+        PcapngSession::start("oink", RING_MAX_SNAP);
+    }
+    
     Mood::setStatusMessage("hunting truffles");
     Display::setWiFiStatus(true);
     Serial.println("[OINK] Auto-attack running");
@@ -306,11 +254,17 @@ void OinkMode::stop() {
     // Stop grass animation
     Avatar::setGrassMoving(false);
     
+    // Save complete handshakes while their frames are still pooled
+    autoSaveCheck();
+    
     esp_wifi_set_promiscuous(false);
     
     // Process any deferred XP saves now that WiFi is off
     XP::processPendingSave();
     
+    // Close session capture (flushes buffered blocks)
+    PcapngSession::stop();
+    
     // Free beacon frame
     if (beaconFrame) {
         free(beaconFrame);
@@ -319,12 +273,14 @@ void OinkMode::stop() {
     beaconFrameLen = 0;
     beaconCaptured = false;
     
-    // Free per-handshake beacon memory to prevent leaks on repeated start/stop
+    // Give handshake frames back to the pool and beacons to the heap. A
+    // complete one not on SD yet (no card, save backoff) keeps its frames;
+    // a partial can't be finished from a released entry, so it starts over
+    // if its AP shows up again.
     for (auto& hs : handshakes) {
-        if (hs.beaconData) {
-            free(hs.beaconData);
-            hs.beaconData = nullptr;
-        }
+        if (hs.isComplete() && !hs.saved) continue;
+        releaseHandshake(hs);
+        if (!hs.saved) hs.capturedMask = 0;
     }
     
     // Log heap status for debugging memory issues
@@ -357,6 +313,10 @@ void OinkMode::startSeamless() {
     Avatar::setGrassSpeed(120);  // ~8 FPS casual trot
     
     // Toast already shown by D key handler in porkchop.cpp
+    if (Config::wifi().sessionCapture) {
+        PcapngSession::start("oink", RING_MAX_SNAP);
+    }
+    
     Avatar::setState(AvatarState::HUNTING);
     Mood::setStatusMessage("hunting truffles");
     Display::setWiFiStatus(true);
@@ -370,12 +330,13 @@ void OinkMode::stopSeamless() {
     running = false;
     deauthing = false;
     scanning = false;
-    oinkBusy = false;  // Reset busy flag for clean handoff
     
     // DON'T disable promiscuous mode - DNH will take over
     // DON'T clear vectors - let them die naturally
     // DON'T free beacon frames - keep them for continuity
     
+    PcapngSession::stop();
+    
     // Stop grass animation
     Avatar::setGrassMoving(false);
 }
@@ -385,192 +346,18 @@ void OinkMode::update() {
     
     uint32_t now = millis();
     
-    // Guard access to networks/handshakes vectors from promiscuous callback
-    oinkBusy = true;
-    
-    // ============ Process Deferred Events from Callback ============
-    // These events were queued in promiscuous callback to avoid heap/String ops there
-    
-    // Flush any pending log messages from callback
-    flushLogs();
-    
-    // Process pending network add
-    if (pendingNetworkAdd) {
-        // Check heap before allocating - skip if memory critically low
-        if (ESP.getFreeHeap() >= HEAP_MIN_THRESHOLD) {
-            networks.push_back(pendingNetwork);
-            
-            // Backfill SSID into any PMKID waiting for this network
-            if (pendingNetwork.ssid[0] != 0) {
-                for (auto& p : pmkids) {
-                    if (p.ssid[0] == 0 && memcmp(p.bssid, pendingNetwork.bssid, 6) == 0) {
-                        strncpy(p.ssid, pendingNetwork.ssid, 32);
-                        p.ssid[32] = 0;
-                        Serial.printf("[OINK] PMKID SSID backfill (deferred): %s\n", p.ssid);
-                    }
-                }
-            }
-        }
-        pendingNetworkAdd = false;
-    }
-    
-    // Process pending mood: new network discovered
-    if (pendingNewNetwork) {
-        Mood::onNewNetwork(pendingNetworkSSID, pendingNetworkRSSI, pendingNetworkChannel);
-        pendingNewNetwork = false;
-    }
-    
-    // Process pending mood: deauth success
-    if (pendingDeauthSuccess) {
-        Mood::onDeauthSuccess(pendingDeauthStation);
-        pendingDeauthSuccess = false;
-    }
+    // ============ Drain Frame Ring ============
+    // Callback only queued frames; all table updates happen here in main thread
+    drainFrames();
     
-    // Process pending mood: handshake complete
-    if (pendingHandshakeComplete) {
-        Mood::onHandshakeCaptured(pendingHandshakeSSID);
-        lastPwnedSSID = String(pendingHandshakeSSID);
-        Display::showLoot(lastPwnedSSID);  // Show PWNED banner in top bar
-        pendingHandshakeComplete = false;
-    }
-    
-    // Process pending mood: PMKID captured (clientless attack - extra special!)
-    if (pendingPMKIDCapture) {
-        Mood::onPMKIDCaptured(pendingPMKIDSSID);
-        lastPwnedSSID = String(pendingPMKIDSSID);  // PMKID counts as pwned!
-        Display::showLoot(lastPwnedSSID);  // Show PWNED banner in top bar
-        SDLog::log("OINK", "PMKID captured: %s", pendingPMKIDSSID);
-        pendingPMKIDCapture = false;
-        
-        // BUG FIX: Trigger auto-save for PMKID (was missing, causing beeps but no file)
-        pendingAutoSave = true;
-    }
-    
-    // Process pending auto-save (callback set flag, we do SD I/O here)
-    if (pendingAutoSave) {
+    // Captures that need SD I/O were flagged while draining
+    if (saveRequested) {
+        saveRequested = false;
         autoSaveCheck();
-        pendingAutoSave = false;
-    }
-    
-    // Process pending handshake creation (callback queued, we do push_back here)
-    if (pendingHandshakeCreateReady && !pendingHandshakeCreateBusy) {
-        pendingHandshakeCreateBusy = true;  // Prevent callback from overwriting
-        
-        // Create or find handshake entry in main thread context
-        int idx = findOrCreateHandshakeSafe(pendingHandshakeCreate.bssid, pendingHandshakeCreate.station);
-        if (idx >= 0) {
-            CapturedHandshake& hs = handshakes[idx];
-            
-            // Process ALL queued frames (M1-M4) from capturedMask
-            for (int msgIdx = 0; msgIdx < 4; msgIdx++) {
-                if (pendingHandshakeCreate.capturedMask & (1 << msgIdx)) {
-                    // Frame is present in the queued data
-                    if (hs.frames[msgIdx].len == 0) {  // Not already captured
-                        uint16_t copyLen = pendingHandshakeCreate.frames[msgIdx].len;
-                        if (copyLen > 0 && copyLen <= 512) {
-                            // EAPOL payload
-                            memcpy(hs.frames[msgIdx].data, pendingHandshakeCreate.frames[msgIdx].data, copyLen);
-                            hs.frames[msgIdx].len = copyLen;
-                            hs.frames[msgIdx].messageNum = msgIdx + 1;
-                            hs.frames[msgIdx].timestamp = millis();
-                            
-                            // Full 802.11 frame for PCAP
-                            uint16_t fullLen = pendingHandshakeCreate.frames[msgIdx].fullFrameLen;
-                            if (fullLen > 0 && fullLen <= 300) {
-                                memcpy(hs.frames[msgIdx].fullFrame, pendingHandshakeCreate.frames[msgIdx].fullFrame, fullLen);
-                                hs.frames[msgIdx].fullFrameLen = fullLen;
-                                hs.frames[msgIdx].rssi = pendingHandshakeCreate.frames[msgIdx].rssi;
-                            }
-                            
-                            hs.capturedMask |= (1 << msgIdx);
-                            hs.lastSeen = millis();
-                            
-                            queueLog("[OINK] M%d captured (deferred)", msgIdx + 1);
-                        }
-                    }
-                }
-            }
-            
-            // Get SSID for this BSSID
-            for (const auto& net : networks) {
-                if (memcmp(net.bssid, pendingHandshakeCreate.bssid, 6) == 0) {
-                    strncpy(hs.ssid, net.ssid, 32);
-                    hs.ssid[32] = 0;
-                    break;
-                }
-            }
-            
-            // Check if handshake is now complete
-            if (hs.isComplete() && !hs.saved) {
-                pendingHandshakeComplete = true;
-                strncpy(pendingHandshakeSSID, hs.ssid, 32);
-                pendingHandshakeSSID[32] = 0;
-                
-                // Auto-save complete handshake (safe here - main thread context)
-                autoSaveCheck();
-            }
-            
-            // Handle PMKID from M1 if present
-            if (pendingHandshakeCreate.hasPMKID) {
-                int pIdx = findOrCreatePMKIDSafe(pendingHandshakeCreate.bssid, pendingHandshakeCreate.station);
-                if (pIdx >= 0 && !pmkids[pIdx].saved) {
-                    memcpy(pmkids[pIdx].pmkid, pendingHandshakeCreate.pmkid, 16);
-                    // Get SSID
-                    for (const auto& net : networks) {
-                        if (memcmp(net.bssid, pendingHandshakeCreate.bssid, 6) == 0) {
-                            strncpy(pmkids[pIdx].ssid, net.ssid, 32);
-                            pmkids[pIdx].ssid[32] = 0;
-                            break;
-                        }
-                    }
-                }
-            }
-        }
-        
-        // Clear slot for next handshake
-        pendingHandshakeCreate.capturedMask = 0;
-        pendingHandshakeCreate.hasPMKID = false;
-        pendingHandshakeCreateReady = false;
-        pendingHandshakeCreateBusy = false;
     }
     
-    // Process pending PMKID creation (callback queued, we do push_back here)
-    if (pendingPMKIDCreateReady && !pendingPMKIDCreateBusy) {
-        pendingPMKIDCreateBusy = true;  // Prevent callback from overwriting
-        
-        // Create PMKID entry in main thread context
-        int idx = findOrCreatePMKIDSafe(pendingPMKIDCreate.bssid, pendingPMKIDCreate.station);
-        if (idx >= 0 && !pmkids[idx].saved) {
-            memcpy(pmkids[idx].pmkid, pendingPMKIDCreate.pmkid, 16);
-            pmkids[idx].timestamp = millis();
-            
-            // SSID lookup: try callback value first, then lookup from networks
-            if (pendingPMKIDCreate.ssid[0] != 0) {
-                strncpy(pmkids[idx].ssid, pendingPMKIDCreate.ssid, 32);
-                pmkids[idx].ssid[32] = 0;
-            } else {
-                // Try to find SSID from networks vector
-                for (const auto& net : networks) {
-                    if (memcmp(net.bssid, pendingPMKIDCreate.bssid, 6) == 0) {
-                        strncpy(pmkids[idx].ssid, net.ssid, 32);
-                        pmkids[idx].ssid[32] = 0;
-                        Serial.printf("[OINK] PMKID SSID backfilled: %s\n", net.ssid);
-                        break;
-                    }
-                }
-            }
-            queueLog("[OINK] PMKID created (deferred)");
-        }
-        
-        pendingPMKIDCreateReady = false;
-        pendingPMKIDCreateBusy = false;
-    }
-    
-    // ============ End Deferred Event Processing ============
-    
-    // RELEASE LOCK EARLY - state machine doesn't need exclusive vector access
-    // This minimizes packet drop window from ~10ms to ~0.5ms
-    oinkBusy = false;
+    // Write out a completed session capture block, if any
+    PcapngSession::service();
     
     // Sync grass animation with channel hopping state
     Avatar::setGrassMoving(channelHopping);
@@ -985,10 +772,7 @@ void OinkMode::update() {
     }
     
     // Periodic network cleanup - remove stale entries
-    // Brief lock for vector erase operations
     if (now - lastCleanupTime > 30000) {
-        oinkBusy = true;  // Brief lock for cleanup
-        
         // Dynamic stale timeout: detect high churn (wardriving) and reduce timeout
         // High churn = 15+ new networks in last 30s, switch to 30s timeout
         static uint16_t networksLastCleanup = 0;
@@ -1016,6 +800,8 @@ void OinkMode::update() {
                 ++it;
             }
         }
+        networkIndex.rebuild(networks.data(), networks.size());
+        
         // Revalidate targetIndex after cleanup using stored BSSID
         if (targetIndex >= 0) {
             targetIndex = findNetwork(targetBssid);
@@ -1044,6 +830,7 @@ void OinkMode::update() {
                 // Remove oldest network (front of vector = oldest lastSeen after sort)
                 networks.erase(networks.begin());
             }
+            networkIndex.rebuild(networks.data(), networks.size());
             
             // Reset all indices after aggressive cleanup
             targetIndex = -1;
@@ -1059,11 +846,18 @@ void OinkMode::update() {
         lastCleanupTime = now;
         
         // Periodic heap monitoring for debugging memory issues
-        Serial.printf("[OINK] Heap: %lu free, Networks: %d, Handshakes: %d\n",
+        Serial.printf("[OINK] Heap: %lu free, Networks: %d, Handshakes: %d, Ring: %lu/%lu peak, %lu dropped\n",
                      (unsigned long)ESP.getFreeHeap(), 
                      (int)networks.size(), 
-                     (int)handshakes.size());
-        oinkBusy = false;  // Release cleanup lock
+                     (int)handshakes.size(),
+                     (unsigned long)frameRing.getHighWater(),
+                     (unsigned long)frameRing.capacity(),
+                     (unsigned long)frameRing.getDropped());
+        Serial.printf("[OINK] Frame pool: %lu/%lu bytes used, %lu pages, %lu failed\n",
+                     (unsigned long)framePool.getBytesUsed(),
+                     (unsigned long)framePool.getBytesReserved(),
+                     (unsigned long)framePool.getPageCount(),
+                     (unsigned long)framePool.getFailures());
     }
 }
 
@@ -1171,6 +965,8 @@ void OinkMode::hopChannel() {
 }
 
 void OinkMode::promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t type) {
+    PERF_SCOPE(PerfSection::OINK_CALLBACK);
+    
     // Dispatch to DNH mode if active (shared callback)
     if (DoNoHamMode::isRunning()) {
         wifi_promiscuous_pkt_t* pkt = (wifi_promiscuous_pkt_t*)buf;
@@ -1194,10 +990,6 @@ void OinkMode::promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t type)
     
     if (!running) return;
     
-    // Skip if main thread is accessing networks/handshakes vectors
-    // This prevents race conditions - we'll catch this packet on next beacon
-    if (oinkBusy) return;
-    
     wifi_promiscuous_pkt_t* pkt = (wifi_promiscuous_pkt_t*)buf;
     uint16_t len = pkt->rx_ctrl.sig_len;
     int8_t rssi = pkt->rx_ctrl.rssi;
@@ -1212,34 +1004,161 @@ void OinkMode::promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t type)
     
     const uint8_t* payload = pkt->payload;
     uint8_t frameSubtype = (payload[0] >> 4) & 0x0F;
+    uint16_t snap = 0;
+    bool priority = false;
     
+    // Classify and trim here; everything else happens in update()
     switch (type) {
         case WIFI_PKT_MGMT:
-            if (frameSubtype == 0x08) {  // Beacon
-                processBeacon(payload, len, rssi);
-            } else if (frameSubtype == 0x05) {  // Probe Response
-                processProbeResponse(payload, len, rssi);
-            }
+            if (frameSubtype != 0x08 && frameSubtype != 0x05) return;  // Beacon / Probe Response only
+            snap = RING_MGMT_SNAP;
             break;
             
         case WIFI_PKT_DATA:
-            processDataFrame(payload, len, rssi);
+            {
+                // Locate LLC/SNAP to spot EAPOL without parsing anything else
+                uint16_t offset = 24;
+                if ((payload[1] & 0x03) == 0x03) offset += 6;          // Address 4
+                bool isQoS = (frameSubtype & 0x08) != 0;
+                if (isQoS) offset += 2;                               // QoS control
+                if (isQoS && (payload[1] & 0x80)) offset += 4;        // HTC
+                
+                if (offset + 8 <= len &&
+                    payload[offset] == 0xAA && payload[offset+1] == 0xAA &&
+                    payload[offset+6] == 0x88 && payload[offset+7] == 0x8E) {
+                    snap = RING_EAPOL_SNAP;
+                    priority = true;  // Handshake frames may use the reserved headroom
+                } else {
+                    snap = RING_DATA_SNAP;
+                }
+            }
             break;
             
         default:
-            break;
+            return;
     }
-    // Deauth moved to update() for reliable timing
+    
+    uint16_t keep = (len < snap) ? len : snap;
+    frameRing.push((uint8_t)type, rssi, pkt->rx_ctrl.noise_floor, pkt->rx_ctrl.channel, millis(),
+                   payload, keep, len, priority);
 }
 
-void OinkMode::processBeacon(const uint8_t* payload, uint16_t len, int8_t rssi) {
-    if (len < 36) return;
+void OinkMode::drainFrames() {
+    PERF_SCOPE(PerfSection::OINK_DRAIN);
     
-    // BSSID is at offset 16
-    const uint8_t* bssid = payload + 16;
+    uint32_t start = millis();
+    const FrameRecord* rec;
     
-    // Detect PMF before anything else
-    bool hasPMF = detectPMF(payload, len);
+    while ((rec = frameRing.peek()) != nullptr) {
+        const uint8_t* payload = rec->payload();
+        uint16_t len = rec->len;
+        uint8_t frameSubtype = (payload[0] >> 4) & 0x0F;
+        
+        // Full-session PCAPNG (no-op unless enabled)
+        PcapngSession::logFrame(payload, len, rec->origLen, rec->channel,
+                                rec->rssi, rec->noise, rec->timestamp);
+        
+        if (rec->type == WIFI_PKT_MGMT) {
+            if (frameSubtype == 0x08) {  // Beacon
+                processBeacon(payload, len, rec->origLen, rec->rssi, rec->channel);
+            } else if (frameSubtype == 0x05) {  // Probe Response
+                processProbeResponse(payload, len, rec->rssi);
+            }
+        } else if (rec->type == WIFI_PKT_DATA) {
+            processDataFrame(payload, len, rec->rssi);
+        }
+        
+        frameRing.pop();
+        
+        // Leave the rest for next update() rather than stalling the UI
+        if (millis() - start > DRAIN_BUDGET_MS) break;
+    }
+}
+
+uint32_t OinkMode::getRingDropped() {
+    return frameRing.getDropped();
+}
+
+uint32_t OinkMode::getRingHighWater() {
+    return frameRing.getHighWater();
+}
+
+uint32_t OinkMode::getRingCapacity() {
+    return frameRing.capacity();
+}
+
+bool OinkMode::storeEAPOLFrame(EAPOLFrame& frame, const uint8_t* payload, uint16_t len,
+                               const uint8_t* fullFrame, uint16_t fullFrameLen) {
+    if (len > EAPOL_MAX_PAYLOAD) len = EAPOL_MAX_PAYLOAD;
+    if (fullFrameLen > EAPOL_MAX_FRAME) fullFrameLen = EAPOL_MAX_FRAME;
+    if (!fullFrame) fullFrameLen = 0;
+    
+    // Payload is normally the tail of the full frame - store those bytes once
+    bool aliased = fullFrameLen >= len &&
+                   memcmp(fullFrame + fullFrameLen - len, payload, len) == 0;
+    uint16_t sliceLen = fullFrameLen + (aliased ? 0 : len);
+    
+    uint8_t* slice = framePool.alloc(sliceLen, ESP.getFreeHeap() > HEAP_MIN_THRESHOLD);
+    if (!slice) return false;  // Keep whatever was stored before
+    
+    releaseEAPOLFrame(frame);
+    if (fullFrameLen > 0) memcpy(slice, fullFrame, fullFrameLen);
+    if (!aliased) memcpy(slice + fullFrameLen, payload, len);
+    
+    frame.fullFrame = fullFrameLen > 0 ? slice : nullptr;
+    frame.fullFrameLen = fullFrameLen;
+    frame.data = aliased ? slice + fullFrameLen - len : slice + fullFrameLen;
+    frame.len = len;
+    frame.sliceLen = sliceLen;
+    return true;
+}
+
+void OinkMode::releaseEAPOLFrame(EAPOLFrame& frame) {
+    if (frame.sliceLen > 0) {
+        // Slice always starts at fullFrame, or at data when there is no full frame
+        framePool.release(frame.fullFrame ? frame.fullFrame : frame.data, frame.sliceLen);
+    }
+    frame.fullFrame = nullptr;
+    frame.data = nullptr;
+    frame.len = 0;
+    frame.fullFrameLen = 0;
+    frame.sliceLen = 0;
+}
+
+void OinkMode::releaseHandshake(CapturedHandshake& hs) {
+    for (int i = 0; i < 4; i++) {
+        releaseEAPOLFrame(hs.frames[i]);
+    }
+    if (hs.beaconData) {
+        free(hs.beaconData);
+        hs.beaconData = nullptr;
+    }
+    hs.beaconLen = 0;
+}
+
+bool OinkMode::handshakeTableFull(const std::vector<CapturedHandshake>& table, size_t limit) {
+    if (table.size() >= limit) return true;
+    if (table.size() < table.capacity()) return false;
+    // push_back reallocates: old and new arrays coexist during the copy
+    size_t grown = (table.capacity() ? table.capacity() * 2 : 1) * sizeof(CapturedHandshake);
+    return ESP.getFreeHeap() < HEAP_MIN_THRESHOLD + grown;
+}
+
+size_t OinkMode::getFramePoolBytes() {
+    return framePool.getBytesReserved();
+}
+
+uint32_t OinkMode::getFramePoolFailures() {
+    return framePool.getFailures();
+}
+
+void OinkMode::processBeacon(const uint8_t* payload, uint16_t len, uint16_t origLen, int8_t rssi, uint8_t channel) {
+    // Walk the IEs once - everything below reads from the view
+    BeaconView view;
+    if (!view.parse(payload, len)) return;
+    
+    const uint8_t* bssid = view.bssid;
+    bool hasPMF = view.pmfRequired;
     
     // Capture beacon for target AP (needed for PCAP/hashcat)
     if (targetIndex >= 0 && targetIndex < (int)networks.size() && !beaconCaptured) {
@@ -1250,9 +1169,10 @@ void OinkMode::processBeacon(const uint8_t* payload, uint16_t len, int8_t rssi)
                 free(beaconFrame);
                 beaconFrame = nullptr;
             }
-            // Validate beacon size before allocation (protect against oversized/malformed frames)
-            if (len > MAX_BEACON_SIZE) {
-                queueLog("[OINK] Beacon too large (%d bytes), skipping", len);
+            // Validate beacon size before allocation (protect against oversized/malformed
+            // frames). Anything bigger was also trimmed by the ring - never store a cut copy.
+            if (origLen > MAX_BEACON_SIZE || len < origLen) {
+                Serial.printf("[OINK] Beacon too large (%d bytes), skipping\n", origLen);
                 return;  // Drop oversized beacon, not a crash risk
             }
             // Allocate and copy beacon frame
@@ -1261,7 +1181,7 @@ void OinkMode::processBeacon(const uint8_t* payload, uint16_t len, int8_t rssi)
                 memcpy(beaconFrame, payload, len);
                 beaconFrameLen = len;
                 beaconCaptured = true;
-                queueLog("[OINK] Beacon captured for %s (%d bytes)", target->ssid, len);
+                Serial.printf("[OINK] Beacon captured for %s (%d bytes)\n", target->ssid, len);
             }
         }
     }
@@ -1282,124 +1202,67 @@ void OinkMode::processBeacon(const uint8_t* payload, uint16_t len, int8_t rssi)
         net.isHidden = false;
         net.clientCount = 0;
         
-        // Parse SSID from IE
-        uint16_t offset = 36;
-        while (offset + 2 < len) {
-            uint8_t id = payload[offset];
-            uint8_t ieLen = payload[offset + 1];
-            
-            if (offset + 2 + ieLen > len) break;
-            
-            if (id == 0) {
-                if (ieLen > 0 && ieLen <= 32) {
-                    memcpy(net.ssid, payload + offset + 2, ieLen);
-                    net.ssid[ieLen] = 0;
-                    
-                    // Check for all-null SSID (also hidden)
-                    bool allNull = true;
-                    for (uint8_t i = 0; i < ieLen; i++) {
-                        if (net.ssid[i] != 0) { allNull = false; break; }
-                    }
-                    if (allNull) {
-                        net.isHidden = true;
-                    }
-                } else if (ieLen == 0) {
-                    // Hidden network (zero-length SSID)
-                    net.isHidden = true;
-                }
-                // If ieLen > 32, ignore malformed SSID
-                break;
-            }
-            
-            offset += 2 + ieLen;
-        }
+        view.copySSID(net.ssid);
+        net.isHidden = view.isHidden;
         
         // Check if we already have a handshake for this network
         net.hasHandshake = hasHandshakeFor(bssid);
         
         // Extract features for ML
-        net.features = FeatureExtractor::extractFromBeacon(payload, len, rssi);
+        net.features = FeatureExtractor::extractFromBeacon(view, rssi);
         
-        // Get channel from DS Parameter Set IE
-        offset = 36;
-        while (offset + 2 < len) {
-            uint8_t id = payload[offset];
-            uint8_t ieLen = payload[offset + 1];
-            
-            if (id == 3 && ieLen == 1) {  // DS Parameter Set
-                net.channel = payload[offset + 2];
-                break;
-            }
-            
-            offset += 2 + ieLen;
-        }
+        // Channel from DS Parameter Set IE
+        net.channel = view.dsChannel;
         
-        // Parse auth mode from RSN (0x30) and WPA (0xDD) IEs
-        net.authmode = WIFI_AUTH_OPEN;  // Default to open
-        offset = 36;
-        while (offset + 2 < len) {
-            uint8_t id = payload[offset];
-            uint8_t ieLen = payload[offset + 1];
-            
-            if (offset + 2 + ieLen > len) break;
-            
-            if (id == 0x30 && ieLen >= 2) {  // RSN IE = WPA2/WPA3
-                // Check for WPA3 (SAE in AKM suite)
-                // For simplicity, assume RSN = WPA2, PMF = WPA3
-                if (net.hasPMF) {
-                    net.authmode = WIFI_AUTH_WPA3_PSK;
-                } else {
-                    net.authmode = WIFI_AUTH_WPA2_PSK;
-                }
-            } else if (id == 0xDD && ieLen >= 8) {  // Vendor specific
-                // Check for WPA1 OUI: 00:50:F2:01
-                if (payload[offset + 2] == 0x00 && payload[offset + 3] == 0x50 &&
-                    payload[offset + 4] == 0xF2 && payload[offset + 5] == 0x01) {
-                    // WPA1 - only set if not already WPA2
-                    if (net.authmode == WIFI_AUTH_OPEN) {
-                        net.authmode = WIFI_AUTH_WPA_PSK;
-                    } else if (net.authmode == WIFI_AUTH_WPA2_PSK) {
-                        net.authmode = WIFI_AUTH_WPA_WPA2_PSK;
-                    }
-                }
+        // Auth mode from RSN / WPA IEs (PMF required = WPA3)
+        net.authmode = WIFI_AUTH_OPEN;
+        if (view.hasRSN) {
+            net.authmode = net.hasPMF ? WIFI_AUTH_WPA3_PSK : WIFI_AUTH_WPA2_PSK;
+        }
+        if (view.hasWPA) {
+            if (net.authmode == WIFI_AUTH_OPEN) {
+                net.authmode = WIFI_AUTH_WPA_PSK;
+            } else if (net.authmode == WIFI_AUTH_WPA2_PSK) {
+                net.authmode = WIFI_AUTH_WPA_WPA2_PSK;
             }
-            
-            offset += 2 + ieLen;
         }
         
         if (net.channel == 0) {
-            net.channel = currentChannel;
+            // No DS IE - use the channel the frame was received on (we may have hopped since)
+            net.channel = channel ? channel : currentChannel;
         }
         
         // Limit network count to prevent OOM
-        // NOTE: Don't do vector erase in callback - just drop if at capacity
         // The update() loop handles cleanup of stale networks
         if (networks.size() >= MAX_NETWORKS) {
-            // At capacity - skip adding new network (update() will clean stale ones)
             return;
         }
         
-        // Also check heap - ESP.getFreeHeap() is safe to call from callback
+        // Check heap before allocating - skip if memory critically low
         if (ESP.getFreeHeap() < HEAP_MIN_THRESHOLD) {
-            return;  // Memory critically low - skip network add
+            return;
         }
         
-        // DEFERRED: Queue network add for main thread (avoids vector realloc in callback)
-        if (!pendingNetworkAdd) {
-            memcpy(&pendingNetwork, &net, sizeof(DetectedNetwork));
-            
-            // Queue mood event data - pass empty string for hidden networks so XP system tracks ghosts
-            strncpy(pendingNetworkSSID, net.ssid, 32);
-            pendingNetworkSSID[32] = 0;
-            pendingNetworkRSSI = net.rssi;
-            pendingNetworkChannel = net.channel;
-            pendingNewNetwork = true;
-            pendingNetworkAdd = true;
-            
-            queueLog("[OINK] New network: %s (ch%d, %ddBm%s)", 
-                     net.ssid[0] ? net.ssid : "<hidden>", net.channel, net.rssi,
-                     net.hasPMF ? " PMF" : "");
+        networks.push_back(net);
+        networkIndex.insert(net.bssid, networks.size() - 1);
+        
+        // Backfill SSID into any PMKID waiting for this network
+        if (net.ssid[0] != 0) {
+            for (auto& p : pmkids) {
+                if (p.ssid[0] == 0 && memcmp(p.bssid, net.bssid, 6) == 0) {
+                    strncpy(p.ssid, net.ssid, 32);
+                    p.ssid[32] = 0;
+                    Serial.printf("[OINK] PMKID SSID backfill: %s\n", p.ssid);
+                }
+            }
         }
+        
+        // Mood event - pass empty string for hidden networks so XP system tracks ghosts
+        Mood::onNewNetwork(net.ssid, net.rssi, net.channel);
+        
+        Serial.printf("[OINK] New network: %s (ch%d, %ddBm%s)\n", 
+                      net.ssid[0] ? net.ssid : "<hidden>", net.channel, net.rssi,
+                      net.hasPMF ? " PMF" : "");
     } else {
         // Update existing
         networks[idx].rssi = rssi;
@@ -1408,12 +1271,12 @@ void OinkMode::processBeacon(const uint8_t* payload, uint16_t len, int8_t rssi)
         networks[idx].hasPMF = hasPMF;  // Update PMF status
         
         // Backfill SSID into any matching PMKID that needs it
-        if (networks[idx].ssid[0] != 0 && !oinkBusy) {
+        if (networks[idx].ssid[0] != 0) {
             for (auto& p : pmkids) {
                 if (p.ssid[0] == 0 && memcmp(p.bssid, bssid, 6) == 0) {
                     strncpy(p.ssid, networks[idx].ssid, 32);
                     p.ssid[32] = 0;
-                    queueLog("[OINK] PMKID SSID backfill (beacon): %s", p.ssid);
+                    Serial.printf("[OINK] PMKID SSID backfill (beacon): %s\n", p.ssid);
                 }
             }
         }
@@ -1431,31 +1294,13 @@ void OinkMode::processProbeResponse(const uint8_t* payload, uint16_t len, int8_t
     
     // If network has hidden SSID, try to extract from probe response
     if (networks[idx].ssid[0] == 0 || networks[idx].isHidden) {
-        uint16_t offset = 36;
-        while (offset + 2 < len) {
-            uint8_t id = payload[offset];
-            uint8_t ieLen = payload[offset + 1];
-            
-            if (offset + 2 + ieLen > len) break;
-            
-            if (id == 0 && ieLen > 0 && ieLen <= 32) {
-                memcpy(networks[idx].ssid, payload + offset + 2, ieLen);
-                networks[idx].ssid[ieLen] = 0;
-                networks[idx].isHidden = false;
-                
-                // DEFERRED: Queue mood event for main thread
-                if (!pendingNewNetwork) {
-                    strncpy(pendingNetworkSSID, networks[idx].ssid, 32);
-                    pendingNetworkSSID[32] = 0;
-                    pendingNetworkRSSI = rssi;
-                    pendingNetworkChannel = networks[idx].channel;
-                    pendingNewNetwork = true;
-                }
-                queueLog("[OINK] Hidden SSID revealed: %s", networks[idx].ssid);
-                break;
-            }
+        BeaconView view;
+        if (view.parse(payload, len) && view.ssid && !view.isHidden) {
+            view.copySSID(networks[idx].ssid);
+            networks[idx].isHidden = false;
             
-            offset += 2 + ieLen;
+            Mood::onNewNetwork(networks[idx].ssid, rssi, networks[idx].channel);
+            Serial.printf("[OINK] Hidden SSID revealed: %s\n", networks[idx].ssid);
         }
     }
     
@@ -1538,6 +1383,7 @@ void OinkMode::processDataFrame(const uint8_t* payload, uint16_t len, int8_t rss
 void OinkMode::processEAPOL(const uint8_t* payload, uint16_t len, 
                              const uint8_t* srcMac, const uint8_t* dstMac,
                              const uint8_t* fullFrame, uint16_t fullFrameLen, int8_t rssi) {
+    PERF_SCOPE(PerfSection::OINK_EAPOL);
     if (len < 4) return;
     
     // EAPOL: version(1) + type(1) + length(2) + descriptor(...)
@@ -1579,13 +1425,9 @@ void OinkMode::processEAPOL(const uint8_t* payload, uint16_t len,
     // If we're deauthing this target, our deauth worked!
     if (messageNum == 1 && deauthing && targetIndex >= 0 && targetIndex < (int)networks.size()) {
         if (memcmp(bssid, networks[targetIndex].bssid, 6) == 0) {
-            // DEFERRED: Queue deauth success for main thread
-            if (!pendingDeauthSuccess) {
-                memcpy(pendingDeauthStation, station, 6);
-                pendingDeauthSuccess = true;
-            }
-            queueLog("[OINK] Deauth confirmed! Client %02X:%02X:%02X:%02X:%02X:%02X reconnecting",
-                     station[0], station[1], station[2], station[3], station[4], station[5]);
+            Mood::onDeauthSuccess(station);
+            Serial.printf("[OINK] Deauth confirmed! Client %02X:%02X:%02X:%02X:%02X:%02X reconnecting\n",
+                          station[0], station[1], station[2], station[3], station[4], station[5]);
         }
     }
     
@@ -1622,63 +1464,33 @@ void OinkMode::processEAPOL(const uint8_t* payload, uint16_t len,
                         break;  // Skip invalid PMKID
                     }
                     
-                    // Check if we already have this PMKID (lookup only - no push_back)
                     int pmkIdx = findOrCreatePMKID(bssid, station);
                     if (pmkIdx >= 0 && !pmkids[pmkIdx].saved) {
-                        // Existing PMKID entry - update it directly (field writes are safe)
                         CapturedPMKID& p = pmkids[pmkIdx];
+                        bool isNew = memcmp(p.pmkid, pmkidData, 16) != 0;
                         memcpy(p.pmkid, pmkidData, 16);
                         p.timestamp = millis();
                         
-                        // Look up SSID
+                        // Look up SSID (backfilled later from beacons if not known yet)
                         if (p.ssid[0] == 0) {
                             int netIdx = findNetwork(bssid);
-                            // Double-check bounds to prevent TOCTOU race
-                            if (netIdx >= 0 && netIdx < (int)networks.size()) {
+                            if (netIdx >= 0) {
                                 strncpy(p.ssid, networks[netIdx].ssid, 32);
                                 p.ssid[32] = 0;
                             }
                         }
                         
-                        queueLog("[OINK] PMKID captured! SSID:%s BSSID:%02X:%02X:%02X:%02X:%02X:%02X",
-                                 p.ssid[0] ? p.ssid : "?",
-                                 bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
-                        
-                        // DEFERRED: Queue PMKID event for main thread (3 beeps!)
-                        if (!pendingPMKIDCapture) {
-                            strncpy(pendingPMKIDSSID, p.ssid, 32);
-                            pendingPMKIDSSID[32] = 0;
-                            pendingPMKIDCapture = true;
-                        }
-                    } else if (pmkIdx < 0) {
-                        // New PMKID - queue for creation in main thread
-                        if (!pendingPMKIDCreateBusy && !pendingPMKIDCreateReady) {
-                            memcpy(pendingPMKIDCreate.bssid, bssid, 6);
-                            memcpy(pendingPMKIDCreate.station, station, 6);
-                            memcpy(pendingPMKIDCreate.pmkid, pmkidData, 16);
-                            // Get SSID from networks if available
-                            int netIdx = findNetwork(bssid);
-                            // Double-check bounds to prevent TOCTOU race (network could be removed between lookup and access)
-                            if (netIdx >= 0 && netIdx < (int)networks.size()) {
-                                strncpy(pendingPMKIDCreate.ssid, networks[netIdx].ssid, 32);
-                                pendingPMKIDCreate.ssid[32] = 0;
-                            } else {
-                                // SSID not known yet - will be backfilled when beacon arrives
-                                pendingPMKIDCreate.ssid[0] = 0;
-                            }
-                            pendingPMKIDCreateReady = true;
-                            
-                            queueLog("[OINK] PMKID queued for creation");
+                        if (isNew) {
+                            Serial.printf("[OINK] PMKID captured! SSID:%s BSSID:%02X:%02X:%02X:%02X:%02X:%02X\n",
+                                          p.ssid[0] ? p.ssid : "?",
+                                          bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
                             
-                            // Trigger auto-save for PMKID (with backfill retry)
-                            pendingAutoSave = true;
-                            
-                            // Queue the mood event
-                            if (!pendingPMKIDCapture) {
-                                strncpy(pendingPMKIDSSID, pendingPMKIDCreate.ssid, 32);
-                                pendingPMKIDSSID[32] = 0;
-                                pendingPMKIDCapture = true;
-                            }
+                            // Clientless attack - extra special!
+                            Mood::onPMKIDCaptured(p.ssid);
+                            lastPwnedSSID = String(p.ssid);  // PMKID counts as pwned!
+                            Display::showLoot(lastPwnedSSID);  // Show PWNED banner in top bar
+                            SDLog::log("OINK", "PMKID captured: %s", p.ssid);
+                            saveRequested = true;
                         }
                     }
                     break;  // Found it, stop searching
@@ -1687,138 +1499,61 @@ void OinkMode::processEAPOL(const uint8_t* payload, uint16_t len,
         }
     }
     
-    // Find or create handshake entry (lookup only - no push_back)
     int hsIdx = findOrCreateHandshake(bssid, station);
+    if (hsIdx < 0) return;  // At MAX_HANDSHAKES
     
-    if (hsIdx >= 0) {
-        // Existing handshake entry - update it directly (field writes are safe)
-        CapturedHandshake& hs = handshakes[hsIdx];
-        
-        // Store this frame (EAPOL payload for hashcat 22000)
-        uint8_t frameIdx = messageNum - 1;
-        uint16_t copyLen = min((uint16_t)512, len);
-        memcpy(hs.frames[frameIdx].data, payload, copyLen);
-        hs.frames[frameIdx].len = copyLen;
-        hs.frames[frameIdx].messageNum = messageNum;
-        hs.frames[frameIdx].timestamp = millis();
-        hs.frames[frameIdx].rssi = rssi;
-        
-        // Store full 802.11 frame for PCAP export (radiotap + WPA-SEC compatibility)
-        uint16_t fullCopyLen = min((uint16_t)300, fullFrameLen);
-        memcpy(hs.frames[frameIdx].fullFrame, fullFrame, fullCopyLen);
-        hs.frames[frameIdx].fullFrameLen = fullCopyLen;
-        
-        // Update mask
-        hs.capturedMask |= (1 << frameIdx);
+    CapturedHandshake& hs = handshakes[hsIdx];
+    bool wasComplete = hs.isComplete();
+    
+    // Already on SD and its frames released - nothing more to keep
+    if (hs.saved) {
         hs.lastSeen = millis();
-        
-        // Look up SSID from networks if not set
-        if (hs.ssid[0] == 0) {
-            int netIdx = findNetwork(bssid);
-            // Double-check bounds to prevent TOCTOU race
-            if (netIdx >= 0 && netIdx < (int)networks.size()) {
-                strncpy(hs.ssid, networks[netIdx].ssid, 32);
-                hs.ssid[32] = 0;  // Ensure null termination
-            }
-        }
-        
-        queueLog("[OINK] EAPOL M%d captured! SSID:%s BSSID:%02X:%02X:%02X:%02X:%02X:%02X [%s%s%s%s]",
-                 messageNum, 
-                 hs.ssid[0] ? hs.ssid : "?",
-                 bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5],
-                 hs.hasM1() ? "1" : "-",
-                 hs.hasM2() ? "2" : "-",
-                 hs.hasM3() ? "3" : "-",
-                 hs.hasM4() ? "4" : "-");
-        
-        // Only trigger mood + beep when handshake becomes complete (not for each frame)
-        // DEFERRED: Queue handshake event for main thread (avoids String ops in callback)
-        // NOTE: autoSaveCheck() is called from main loop, not here (callback context)
-        if (hs.isComplete() && !hs.saved) {
-            if (!pendingHandshakeComplete) {
-                strncpy(pendingHandshakeSSID, hs.ssid, 32);
-                pendingHandshakeSSID[32] = 0;
-                pendingHandshakeComplete = true;
-            }
-            pendingAutoSave = true;  // Queue auto-save for main loop
-        }
-    } else {
-        // New handshake - queue for creation in main thread
-        // BUT: if frames arrive in quick succession (M1→M2→M3→M4 within ms),
-        // we can't queue them all (single slot). Solution: process immediately
-        // in callback by writing to static buffer that main thread will consume.
-        // This is safe because we're just copying data, not allocating.
-        
-        if (!pendingHandshakeCreateBusy) {
-            // Check if slot already has a frame for this handshake
-            bool sameHandshake = pendingHandshakeCreateReady &&
-                                 memcmp(pendingHandshakeCreate.bssid, bssid, 6) == 0 &&
-                                 memcmp(pendingHandshakeCreate.station, station, 6) == 0;
-            
-            if (!pendingHandshakeCreateReady || sameHandshake) {
-                // Either slot is free, or it's for the same handshake (update it)
-                if (!pendingHandshakeCreateReady) {
-                    // First frame for this handshake - init the slot
-                    memcpy(pendingHandshakeCreate.bssid, bssid, 6);
-                    memcpy(pendingHandshakeCreate.station, station, 6);
-                    pendingHandshakeCreate.messageNum = messageNum;  // Will be ignored, we have all frames
-                    pendingHandshakeCreate.capturedMask = 0;  // Clear mask
-                    pendingHandshakeCreate.hasPMKID = false;
-                }
-                
-                // Store this frame in the appropriate slot (M1-M4 → index 0-3)
-                uint8_t frameIdx = messageNum - 1;
-                if (frameIdx < 4) {
-                    // EAPOL payload for hashcat 22000
-                    uint16_t copyLen = min((uint16_t)512, len);
-                    memcpy(pendingHandshakeCreate.frames[frameIdx].data, payload, copyLen);
-                    pendingHandshakeCreate.frames[frameIdx].len = copyLen;
-                    
-                    // Full 802.11 frame for PCAP export
-                    uint16_t fullCopyLen = min((uint16_t)300, fullFrameLen);
-                    memcpy(pendingHandshakeCreate.frames[frameIdx].fullFrame, fullFrame, fullCopyLen);
-                    pendingHandshakeCreate.frames[frameIdx].fullFrameLen = fullCopyLen;
-                    pendingHandshakeCreate.frames[frameIdx].rssi = rssi;
-                    
-                    pendingHandshakeCreate.capturedMask |= (1 << frameIdx);
-                }
-                
-                pendingHandshakeCreateReady = true;
-                queueLog("[OINK] EAPOL M%d queued for creation", messageNum);
-            }
-            // else: slot full with different handshake, drop this frame (rare race)
-        }
+        return;
     }
-}
-
-int OinkMode::findOrCreateHandshake(const uint8_t* bssid, const uint8_t* station) {
-    // CALLBACK VERSION: Lookup only, no push_back
-    // If not found, returns -1 and caller must queue to pendingHandshakeCreate
-    for (int i = 0; i < (int)handshakes.size(); i++) {
-        if (memcmp(handshakes[i].bssid, bssid, 6) == 0 &&
-            memcmp(handshakes[i].station, station, 6) == 0) {
-            return i;
-        }
+    
+    // Store EAPOL payload (hashcat 22000) + full 802.11 frame (PCAP/WPA-SEC)
+    uint8_t frameIdx = messageNum - 1;
+    if (!storeEAPOLFrame(hs.frames[frameIdx], payload, len, fullFrame, fullFrameLen)) {
+        Serial.printf("[OINK] Frame pool full - M%d dropped\n", messageNum);
+        return;
     }
-    return -1;  // Not found - caller must queue for creation in main thread
-}
-
-int OinkMode::findOrCreatePMKID(const uint8_t* bssid, const uint8_t* station) {
-    // CALLBACK VERSION: Lookup only, no push_back
-    // If not found, returns -1 and caller must queue to pendingPMKIDCreate
-    for (int i = 0; i < (int)pmkids.size(); i++) {
-        if (memcmp(pmkids[i].bssid, bssid, 6) == 0 &&
-            memcmp(pmkids[i].station, station, 6) == 0) {
-            return i;
+    hs.frames[frameIdx].messageNum = messageNum;
+    hs.frames[frameIdx].timestamp = millis();
+    hs.frames[frameIdx].rssi = rssi;
+    
+    // Update mask
+    hs.capturedMask |= (1 << frameIdx);
+    hs.lastSeen = millis();
+    
+    // Look up SSID from networks if not set
+    if (hs.ssid[0] == 0) {
+        int netIdx = findNetwork(bssid);
+        if (netIdx >= 0) {
+            strncpy(hs.ssid, networks[netIdx].ssid, 32);
+            hs.ssid[32] = 0;  // Ensure null termination
         }
     }
-    return -1;  // Not found - caller must queue for creation in main thread
+    
+    Serial.printf("[OINK] EAPOL M%d captured! SSID:%s BSSID:%02X:%02X:%02X:%02X:%02X:%02X [%s%s%s%s]\n",
+                  messageNum, 
+                  hs.ssid[0] ? hs.ssid : "?",
+                  bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5],
+                  hs.hasM1() ? "1" : "-",
+                  hs.hasM2() ? "2" : "-",
+                  hs.hasM3() ? "3" : "-",
+                  hs.hasM4() ? "4" : "-");
+    
+    // Only trigger mood + beep when handshake becomes complete (not for each frame)
+    if (hs.isComplete() && !wasComplete && !hs.saved) {
+        Mood::onHandshakeCaptured(hs.ssid);
+        lastPwnedSSID = String(hs.ssid);
+        Display::showLoot(lastPwnedSSID);  // Show PWNED banner in top bar
+        saveRequested = true;  // autoSaveCheck() runs after the drain
+    }
 }
 
-// Safe versions for main thread use (does vector operations safely)
-int OinkMode::findOrCreateHandshakeSafe(const uint8_t* bssid, const uint8_t* station) {
-    // This version is ONLY called from update() in main loop context
-    // It's safe to do vector operations here
+int OinkMode::findOrCreateHandshake(const uint8_t* bssid, const uint8_t* station) {
+    // Main thread only (called while draining the frame ring)
     
     // Look for existing
     for (int i = 0; i < (int)handshakes.size(); i++) {
@@ -1828,9 +1563,17 @@ int OinkMode::findOrCreateHandshakeSafe(const uint8_t* bssid, const uint8_t* sta
         }
     }
     
-    // Limit check
-    if (handshakes.size() >= MAX_HANDSHAKES) {
-        return -1;
+    // At the limit, recycle the stalest partial handshake (complete ones are kept)
+    int slot = -1;
+    if (handshakeTableFull(handshakes, MAX_HANDSHAKES)) {
+        for (int i = 0; i < (int)handshakes.size(); i++) {
+            if (handshakes[i].isComplete()) continue;
+            if (slot < 0 || handshakes[i].lastSeen < handshakes[slot].lastSeen) {
+                slot = i;
+            }
+        }
+        if (slot < 0) return -1;
+        releaseHandshake(handshakes[slot]);
     }
     
     // Create new entry
@@ -1857,12 +1600,16 @@ int OinkMode::findOrCreateHandshakeSafe(const uint8_t* bssid, const uint8_t* sta
         }
     }
     
+    if (slot >= 0) {
+        handshakes[slot] = hs;
+        return slot;
+    }
     handshakes.push_back(hs);
     return handshakes.size() - 1;
 }
 
-int OinkMode::findOrCreatePMKIDSafe(const uint8_t* bssid, const uint8_t* station) {
-    // This version is ONLY called from update() in main loop context
+int OinkMode::findOrCreatePMKID(const uint8_t* bssid, const uint8_t* station) {
+    // Main thread only (called while draining the frame ring)
     
     // Look for existing
     for (int i = 0; i < (int)pmkids.size(); i++) {
@@ -1997,6 +1744,7 @@ void OinkMode::autoSaveCheck() {
             
             if (pcapOk || hs22kOk) {
                 hs.saved = true;
+                releaseHandshake(hs);  // On SD now - give the frame bytes back
                 Serial.printf("[OINK] Handshake saved: %s (pcap:%s 22000:%s)\n", 
                               filename, pcapOk ? "OK" : "FAIL", hs22kOk ? "OK" : "FAIL");
                 SDLog::log("OINK", "Handshake saved: %s (pcap:%s 22000:%s)", 
@@ -2012,6 +1760,10 @@ void OinkMode::autoSaveCheck() {
                     txtFile.println(hs.ssid);
                     txtFile.close();
                 }
+                
+                CaptureManifest::recordSaved(hs.bssid, hs.ssid, CaptureKind::HANDSHAKE,
+                                             (pcapOk ? CAPTURE_FILE_PCAP : 0) | (hs22kOk ? CAPTURE_FILE_HS22000 : 0),
+                                             hs22kOk ? filename22000 : filename);
             } else if (hs.saveAttempts >= 3) {
                 // Failed 3 times - give up to prevent infinite retry
                 Serial.printf("[OINK] Failed to save %s after 3 attempts (SD issue?)\n", hs.ssid);
@@ -2126,7 +1878,7 @@ bool OinkMode::saveHandshakePCAP(const CapturedHandshake& hs, const char* path)
         if (frame.len == 0) continue;
         
         // Prefer stored fullFrame (real 802.11 capture) over reconstruction
-        if (frame.fullFrameLen > 0 && frame.fullFrameLen <= 300) {
+        if (frame.fullFrameLen > 0) {
             // Use the actual captured 802.11 frame (best quality)
             writePCAPPacket(f, frame.fullFrame, frame.fullFrameLen, frame.timestamp);
             packetCount++;
@@ -2422,6 +2174,8 @@ bool OinkMode::saveAllPMKIDs() {
                     txtFile.println(p.ssid);
                     txtFile.close();
                 }
+                
+                CaptureManifest::recordSaved(p.bssid, p.ssid, CaptureKind::PMKID, CAPTURE_FILE_PMKID, filename);
             } else if (p.saveAttempts >= 3) {
                 // Failed 3 times - give up to prevent infinite retry
                 Serial.printf("[OINK] Failed to save PMKID %s after 3 attempts (SD issue?)\n", p.ssid);
@@ -2625,70 +2379,15 @@ void OinkMode::trackClient(const uint8_t* bssid, const uint8_t* clientMac, int8_
         net.clients[net.clientCount].lastSeen = millis();
         net.clientCount++;
         
-        queueLog("[OINK] Client tracked: %02X:%02X:%02X:%02X:%02X:%02X -> %s",
-                 clientMac[0], clientMac[1], clientMac[2],
-                 clientMac[3], clientMac[4], clientMac[5],
-                 net.ssid);
-    }
-}
-
-bool OinkMode::detectPMF(const uint8_t* payload, uint16_t len) {
-    // Parse RSN IE to detect PMF (Protected Management Frames)
-    // RSN IE starts with tag 0x30
-    uint16_t offset = 36;  // After fixed beacon fields
-    
-    while (offset + 2 < len) {
-        uint8_t tag = payload[offset];
-        uint8_t tagLen = payload[offset + 1];
-        
-        if (offset + 2 + tagLen > len) break;
-        
-        if (tag == 0x30 && tagLen >= 8) {  // RSN IE
-            // RSN IE structure: version(2) + group cipher(4) + pairwise count(2) + ...
-            // RSN capabilities are at the end, look for MFPC/MFPR bits
-            uint16_t rsnOffset = offset + 2;
-            uint16_t rsnEnd = rsnOffset + tagLen;
-            
-            // Skip version (2), group cipher (4)
-            rsnOffset += 6;
-            if (rsnOffset + 2 > rsnEnd) break;
-            
-            // Pairwise cipher count and suites
-            uint16_t pairwiseCount = payload[rsnOffset] | (payload[rsnOffset + 1] << 8);
-            rsnOffset += 2 + (pairwiseCount * 4);
-            if (rsnOffset + 2 > rsnEnd) break;
-            
-            // AKM count and suites
-            uint16_t akmCount = payload[rsnOffset] | (payload[rsnOffset + 1] << 8);
-            rsnOffset += 2 + (akmCount * 4);
-            if (rsnOffset + 2 > rsnEnd) break;
-            
-            // RSN Capabilities (2 bytes)
-            uint16_t rsnCaps = payload[rsnOffset] | (payload[rsnOffset + 1] << 8);
-            
-            // IEEE 802.11-2016 standard:
-            // Bit 6: MFPC (Management Frame Protection Capable)
-            // Bit 7: MFPR (Management Frame Protection Required)
-            bool mfpr = (rsnCaps >> 7) & 0x01;
-            
-            if (mfpr) {
-                return true;  // PMF required - deauth won't work
-            }
-        }
-        
-        offset += 2 + tagLen;
+        Serial.printf("[OINK] Client tracked: %02X:%02X:%02X:%02X:%02X:%02X -> %s\n",
+                      clientMac[0], clientMac[1], clientMac[2],
+                      clientMac[3], clientMac[4], clientMac[5],
+                      net.ssid);
     }
-    
-    return false;
 }
 
 int OinkMode::findNetwork(const uint8_t* bssid) {
-    for (int i = 0; i < (int)networks.size(); i++) {
-        if (memcmp(networks[i].bssid, bssid, 6) == 0) {
-            return i;
-        }
-    }
-    return -1;
+    return networkIndex.find(bssid, networks.data(), networks.size());
 }
 
 bool OinkMode::hasHandshakeFor(const uint8_t* bssid) {
@@ -2745,6 +2444,9 @@ void OinkMode::sortNetworksByPriority() {
         
         return getPriority(a) < getPriority(b);
     });
+    
+    // Positions changed - re-index
+    networkIndex.rebuild(networks.data(), networks.size());
 }
 
 int OinkMode::getNextTarget() {
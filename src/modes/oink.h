@@ -36,17 +36,35 @@ struct DetectedNetwork {
     uint8_t clientCount;
 };
 
-// Frame storage for PCAP export - stores full 802.11 frame with headers
+// Frame storage for PCAP export - one slice of the handshake frame pool.
+// The EAPOL payload is the tail of the 802.11 frame, so data normally points
+// into fullFrame; it only gets its own bytes when the two don't line up.
 struct EAPOLFrame {
-    uint8_t data[512];       // EAPOL payload only (for hashcat 22000)
-    uint8_t fullFrame[300];  // Full 802.11 frame for PCAP (header + LLC + EAPOL)
+    uint8_t* fullFrame;      // Full 802.11 frame for PCAP (header + LLC + EAPOL)
+    uint8_t* data;           // EAPOL payload only (for hashcat 22000)
     uint16_t len;            // EAPOL payload length
     uint16_t fullFrameLen;   // Full 802.11 frame length
+    uint16_t sliceLen;       // Bytes held in the pool (0 = nothing stored)
     uint8_t messageNum;      // 1-4
     uint32_t timestamp;
     int8_t rssi;             // Signal strength for radiotap header
 };
 
+// Upper bounds for pooled EAPOL frames (the frame ring trims to 600 anyway)
+static const uint16_t EAPOL_MAX_PAYLOAD = 512;
+static const uint16_t EAPOL_MAX_FRAME = 600;
+
+// Handshake frame pool: 32-byte cells in 2KB pages, 48KB max
+static const size_t EAPOL_POOL_CELL = 32;
+static const size_t EAPOL_POOL_PAGES = 24;
+static const size_t EAPOL_POOL_BYTES = EAPOL_POOL_CELL * 64 * EAPOL_POOL_PAGES;
+
+// Handshake table limit: as many partials as the pool can back with an
+// M1+M2 pair each (~2 x 190 bytes). Past that, new entries would only
+// fail their frame allocations while the table itself eats heap.
+static const size_t EAPOL_PAIR_BYTES = 384;
+static const size_t MAX_POOLED_HANDSHAKES = EAPOL_POOL_BYTES / EAPOL_PAIR_BYTES;  // 128
+
 struct CapturedHandshake {
     uint8_t bssid[6];
     uint8_t station[6];
@@ -125,6 +143,17 @@ public:
     static bool saveAllHandshakes();
     static void autoSaveCheck();
     
+    // Pooled EAPOL frame storage (shared with DNH, main thread only)
+    static bool storeEAPOLFrame(EAPOLFrame& frame, const uint8_t* payload, uint16_t len,
+                                const uint8_t* fullFrame, uint16_t fullFrameLen);
+    static void releaseEAPOLFrame(EAPOLFrame& frame);
+    static void releaseHandshake(CapturedHandshake& hs);  // Frames + beacon
+    // True when another entry would pass `limit` or regrow the table into
+    // the heap safety margin - recycle a stale one instead
+    static bool handshakeTableFull(const std::vector<CapturedHandshake>& table, size_t limit);
+    static size_t getFramePoolBytes();
+    static uint32_t getFramePoolFailures();
+    
     // PMKID capture (clientless attack)
     static const std::vector<CapturedPMKID>& getPMKIDs() { return pmkids; }
     static uint16_t getPMKIDCount() { return pmkids.size(); }
@@ -144,6 +173,11 @@ public:
     static uint32_t getDeauthCount() { return deauthCount; }
     static uint16_t getNetworkCount() { return networks.size(); }
     
+    // Frame ring health (callback -> update() queue)
+    static uint32_t getRingDropped();
+    static uint32_t getRingHighWater();
+    static uint32_t getRingCapacity();
+    
     // LOCKING state info (for display)
     static bool isLocking();
     static const char* getTargetSSID();
@@ -193,8 +227,9 @@ private:
     static uint16_t beaconFrameLen;
     static bool beaconCaptured;
     
-    // Private processing functions (callback dispatches here)
-    static void processBeacon(const uint8_t* payload, uint16_t len, int8_t rssi);
+    // Frame processing (update() drains the frame ring and dispatches here)
+    static void drainFrames();
+    static void processBeacon(const uint8_t* payload, uint16_t len, uint16_t origLen, int8_t rssi, uint8_t channel);
     static void processProbeResponse(const uint8_t* payload, uint16_t len, int8_t rssi);
     static void processDataFrame(const uint8_t* payload, uint16_t len, int8_t rssi);
     static void processEAPOL(const uint8_t* payload, uint16_t len, const uint8_t* srcMac, const uint8_t* dstMac,
@@ -206,13 +241,10 @@ private:
     static void sendAssociationRequest(const uint8_t* bssid, const char* ssid, uint8_t ssidLen);
     static void hopChannel();
     static void trackClient(const uint8_t* bssid, const uint8_t* clientMac, int8_t rssi);
-    static bool detectPMF(const uint8_t* payload, uint16_t len);
 
     static int findNetwork(const uint8_t* bssid);
     static int findOrCreateHandshake(const uint8_t* bssid, const uint8_t* station);
     static int findOrCreatePMKID(const uint8_t* bssid, const uint8_t* station);
-    static int findOrCreateHandshakeSafe(const uint8_t* bssid, const uint8_t* station);  // Main thread only
-    static int findOrCreatePMKIDSafe(const uint8_t* bssid, const uint8_t* station);      // Main thread only
     static void sortNetworksByPriority();
     static bool hasHandshakeFor(const uint8_t* bssid);
     static int getNextTarget();  // Smart target selection
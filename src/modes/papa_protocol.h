@@ -0,0 +1,604 @@
+// CALL PAPA Protocol - windowed capture sync (revision 2), no BLE in here
+// Revision 1 moves each capture in 17-byte chunks and waits for a
+// CMD_ACK_CHUNK after every one, so a handshake costs two connection
+// events per chunk. Revision 2 keeps the DATA packet format
+// ([seq:2][payload], end marker seq 0xFFFF + [crc32:4]) and changes pacing:
+//
+//   - Papa offers it in CMD_HELLO: [0x01][rev][chunk:2][window]. A Sirloin
+//     that knows it answers RSP_HELLO version 2 with the chunk size and
+//     window it picked in bytes 8-10. Any other answer means revision 1.
+//   - Chunks are sized to the negotiated ATT MTU (up to 242 bytes).
+//   - Sirloin keeps up to `window` chunks unacknowledged in flight.
+//   - Papa answers with CMD_ACK_WINDOW [0x08][next:2][mask:4][flags]:
+//     every chunk below `next` landed, bit i of mask = chunk next+1+i
+//     landed. Unset bits under the highest set one are a selective NACK.
+//     PAPA_ACK_END says the end marker was seen, so anything still
+//     missing is lost rather than in flight.
+//   - Papa folds the CRC32 over the in-order prefix as chunks land, so
+//     the end marker check is a compare.
+//
+// Revision 3 adds:
+//
+//   - CMD_GET_MANIFEST [0x09][type][first:2][count] -> RSP_MANIFEST [0x88]
+//     [type][first:2][n] + n x [len:2][crc32:4][bssid:6]: digests of up to
+//     `count` captures in one notification (19 at MTU 247). Papa skips
+//     (marks synced without transferring) the ones it already has on SD,
+//     so a page costs one round trip instead of one per capture, and it
+//     asks for the next page while the last transfer of this one runs.
+//   - CMD_START_SYNC grows an offset: [0x03][type][index:2][offset:2].
+//     Sirloin sends only bytes from offset on, seq counted from there,
+//     and the end marker CRC still covers the whole capture. Papa keeps
+//     the in-order prefix of a transfer cut short by a disconnect and
+//     resumes it when the same device offers a capture with the same
+//     digest.
+//
+// Both ends are here: PapaRxWindow is what CallPapaMode runs, PapaTxWindow
+// is the Sirloin side. The host simulator in test/bench drives one against
+// the other.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "../core/crc32.h"
+
+static const uint8_t PAPA_PROTO_LEGACY = 0x01;
+static const uint8_t PAPA_PROTO_WINDOWED = 0x02;
+static const uint8_t PAPA_PROTO_RESUME = 0x03;
+static const uint8_t PAPA_PROTO_LATEST = PAPA_PROTO_RESUME;
+
+static const uint8_t PAPA_CMD_HELLO = 0x01;
+static const uint8_t PAPA_CMD_START_SYNC = 0x03;
+static const uint8_t PAPA_CMD_ACK_WINDOW = 0x08;
+static const uint8_t PAPA_CMD_GET_MANIFEST = 0x09;
+static const uint8_t PAPA_RSP_HELLO = 0x81;
+static const uint8_t PAPA_RSP_MANIFEST = 0x88;
+
+static const uint16_t PAPA_LEGACY_CHUNK = 17;
+static const uint16_t PAPA_MTU_PREFERRED = 247;  // Fills one 251-byte LL packet (DLE)
+static const uint16_t PAPA_PACKET_OVERHEAD = 5;  // ATT notify header + seq
+static const uint16_t PAPA_CHUNK_MAX = PAPA_MTU_PREFERRED - PAPA_PACKET_OVERHEAD;
+static const uint8_t PAPA_WINDOW_DEFAULT = 16;
+static const uint8_t PAPA_WINDOW_MAX = 32;       // Bits in the ACK mask
+static const uint16_t PAPA_MAX_CHUNKS = 256;     // Chunks per capture
+static const uint16_t PAPA_SEQ_END = 0xFFFF;
+
+static const size_t PAPA_HELLO_LEN = 5;
+static const size_t PAPA_HELLO_RSP_LEN = 11;
+static const size_t PAPA_ACK_LEN = 8;
+static const size_t PAPA_GET_MANIFEST_LEN = 5;
+static const size_t PAPA_MANIFEST_HEADER = 5;
+static const size_t PAPA_MANIFEST_ENTRY = 12;
+static const uint16_t PAPA_ATT_NOTIFY_HEADER = 3;
+static const uint8_t PAPA_MANIFEST_MAX = 19;     // Entries in one notification at MTU 247
+static const size_t PAPA_START_SYNC_LEN = 6;
+static const uint8_t PAPA_ACK_END = 0x01;        // ACK flag: end marker seen
+
+// What both ends agreed on in HELLO
+struct PapaLink {
+    uint8_t version;
+    uint16_t chunkSize;
+    uint8_t window;
+};
+
+inline PapaLink papaLegacyLink() {
+    PapaLink link = {PAPA_PROTO_LEGACY, PAPA_LEGACY_CHUNK, 1};
+    return link;
+}
+
+// Largest chunk one notification carries at this ATT MTU
+inline uint16_t papaChunkForMtu(uint16_t mtu) {
+    if (mtu <= PAPA_LEGACY_CHUNK + PAPA_PACKET_OVERHEAD) return PAPA_LEGACY_CHUNK;
+    uint16_t chunk = mtu - PAPA_PACKET_OVERHEAD;
+    return chunk > PAPA_CHUNK_MAX ? PAPA_CHUNK_MAX : chunk;
+}
+
+// CMD_HELLO carrying the offer: the newest revision we speak
+inline size_t papaBuildHello(uint8_t* out, uint16_t maxChunk, uint8_t window) {
+    out[0] = PAPA_CMD_HELLO;
+    out[1] = PAPA_PROTO_LATEST;
+    out[2] = (uint8_t)(maxChunk & 0xFF);
+    out[3] = (uint8_t)(maxChunk >> 8);
+    out[4] = window;
+    return PAPA_HELLO_LEN;
+}
+
+// Sirloin side: what to answer a CMD_HELLO with. A bare HELLO (old Papa)
+// or an offer we can't meet gets revision 1; otherwise the older of the
+// two revisions.
+inline PapaLink papaAnswerHello(const uint8_t* cmd, size_t len, uint16_t maxChunk, uint8_t window,
+                                uint8_t maxVersion = PAPA_PROTO_LATEST) {
+    PapaLink link = papaLegacyLink();
+    if (len < PAPA_HELLO_LEN || cmd[0] != PAPA_CMD_HELLO || cmd[1] < PAPA_PROTO_WINDOWED) return link;
+    uint16_t offerChunk = cmd[2] | (cmd[3] << 8);
+    uint8_t offerWindow = cmd[4];
+    uint16_t chunk = offerChunk < maxChunk ? offerChunk : maxChunk;
+    uint8_t win = offerWindow < window ? offerWindow : window;
+    if (win > PAPA_WINDOW_MAX) win = PAPA_WINDOW_MAX;
+    if (chunk < PAPA_LEGACY_CHUNK || win == 0 || maxVersion < PAPA_PROTO_WINDOWED) return link;
+    link.version = cmd[1] < maxVersion ? cmd[1] : maxVersion;
+    link.chunkSize = chunk;
+    link.window = win;
+    return link;
+}
+
+// The three extra RSP_HELLO bytes a revision 2+ Sirloin appends
+inline void papaPutHelloLink(uint8_t* rsp, const PapaLink& link) {
+    rsp[1] = link.version;
+    rsp[8] = (uint8_t)(link.chunkSize & 0xFF);
+    rsp[9] = (uint8_t)(link.chunkSize >> 8);
+    rsp[10] = link.window;
+}
+
+// Papa side: read RSP_HELLO [0x81][ver][pmkid:2][hs:2][flags][dialogue]
+// [chunk:2][window]. Anything not matching what we offered is revision 1.
+inline PapaLink papaParseHelloRsp(const uint8_t* rsp, size_t len, uint16_t offeredChunk, uint8_t offeredWindow) {
+    PapaLink link = papaLegacyLink();
+    if (len < PAPA_HELLO_RSP_LEN || rsp[0] != PAPA_RSP_HELLO) return link;
+    if (rsp[1] < PAPA_PROTO_WINDOWED || rsp[1] > PAPA_PROTO_LATEST) return link;
+    uint16_t chunk = rsp[8] | (rsp[9] << 8);
+    uint8_t win = rsp[10];
+    if (chunk < PAPA_LEGACY_CHUNK || chunk > offeredChunk) return link;
+    if (win == 0 || win > offeredWindow || win > PAPA_WINDOW_MAX) return link;
+    link.version = rsp[1];
+    link.chunkSize = chunk;
+    link.window = win;
+    return link;
+}
+
+inline size_t papaBuildAck(uint8_t* out, uint16_t next, uint32_t mask, uint8_t flags) {
+    out[0] = PAPA_CMD_ACK_WINDOW;
+    out[1] = (uint8_t)(next & 0xFF);
+    out[2] = (uint8_t)(next >> 8);
+    out[3] = (uint8_t)(mask & 0xFF);
+    out[4] = (uint8_t)(mask >> 8);
+    out[5] = (uint8_t)(mask >> 16);
+    out[6] = (uint8_t)(mask >> 24);
+    out[7] = flags;
+    return PAPA_ACK_LEN;
+}
+
+inline bool papaParseAck(const uint8_t* in, size_t len, uint16_t& next, uint32_t& mask, uint8_t& flags) {
+    if (len < PAPA_ACK_LEN || in[0] != PAPA_CMD_ACK_WINDOW) return false;
+    next = in[1] | (in[2] << 8);
+    mask = in[3] | (in[4] << 8) | ((uint32_t)in[5] << 16) | ((uint32_t)in[6] << 24);
+    flags = in[7];
+    return true;
+}
+
+// What a capture is, before any of it moves: which AP it's for (first six
+// bytes of both capture formats) plus length and CRC32 of the bytes
+struct PapaDigest {
+    uint8_t type;       // 0x01=PMKID, 0x02=Handshake
+    uint16_t index;
+    uint16_t length;
+    uint32_t crc;
+    uint8_t bssid[6];
+};
+
+// Sirloin side
+inline PapaDigest papaDigestOf(uint8_t type, uint16_t index, const uint8_t* data, uint16_t len) {
+    PapaDigest d;
+    d.type = type;
+    d.index = index;
+    d.length = len;
+    d.crc = crc32Update(0, data, len);
+    memset(d.bssid, 0, sizeof(d.bssid));
+    memcpy(d.bssid, data, len < 6 ? len : 6);
+    return d;
+}
+
+// Same content, wherever it sits in Sirloin's list
+inline bool papaSameCapture(const PapaDigest& a, const PapaDigest& b) {
+    return a.type == b.type && a.length == b.length && a.crc == b.crc && memcmp(a.bssid, b.bssid, 6) == 0;
+}
+
+// Digests one RSP_MANIFEST carries at this ATT MTU (at least one: MTU 23
+// leaves 15 bytes after the header)
+inline uint8_t papaManifestFit(uint16_t mtu) {
+    if (mtu <= PAPA_ATT_NOTIFY_HEADER + PAPA_MANIFEST_HEADER + PAPA_MANIFEST_ENTRY) return 1;
+    uint16_t fit = (mtu - PAPA_ATT_NOTIFY_HEADER - PAPA_MANIFEST_HEADER) / PAPA_MANIFEST_ENTRY;
+    return fit > PAPA_MANIFEST_MAX ? PAPA_MANIFEST_MAX : (uint8_t)fit;
+}
+
+inline size_t papaBuildGetManifest(uint8_t* out, uint8_t type, uint16_t first, uint8_t count) {
+    out[0] = PAPA_CMD_GET_MANIFEST;
+    out[1] = type;
+    out[2] = (uint8_t)(first & 0xFF);
+    out[3] = (uint8_t)(first >> 8);
+    out[4] = count;
+    return PAPA_GET_MANIFEST_LEN;
+}
+
+// Sirloin side: which page was asked for
+inline bool papaParseGetManifest(const uint8_t* cmd, size_t len, uint8_t& type, uint16_t& first, uint8_t& count) {
+    if (len < PAPA_GET_MANIFEST_LEN || cmd[0] != PAPA_CMD_GET_MANIFEST) return false;
+    type = cmd[1];
+    first = cmd[2] | (cmd[3] << 8);
+    count = cmd[4];
+    return true;
+}
+
+// Sirloin side: RSP_MANIFEST for digests[0..n) of captures first.. of one
+// type. out needs PAPA_MANIFEST_HEADER + n * PAPA_MANIFEST_ENTRY bytes.
+inline size_t papaBuildManifest(uint8_t* out, uint8_t type, uint16_t first, const PapaDigest* digests, uint8_t n) {
+    out[0] = PAPA_RSP_MANIFEST;
+    out[1] = type;
+    out[2] = (uint8_t)(first & 0xFF);
+    out[3] = (uint8_t)(first >> 8);
+    out[4] = n;
+    uint8_t* e = out + PAPA_MANIFEST_HEADER;
+    for (uint8_t i = 0; i < n; i++, e += PAPA_MANIFEST_ENTRY) {
+        const PapaDigest& d = digests[i];
+        e[0] = (uint8_t)(d.length & 0xFF);
+        e[1] = (uint8_t)(d.length >> 8);
+        e[2] = (uint8_t)(d.crc & 0xFF);
+        e[3] = (uint8_t)(d.crc >> 8);
+        e[4] = (uint8_t)(d.crc >> 16);
+        e[5] = (uint8_t)(d.crc >> 24);
+        memcpy(e + 6, d.bssid, 6);
+    }
+    return PAPA_MANIFEST_HEADER + (size_t)n * PAPA_MANIFEST_ENTRY;
+}
+
+// Papa side: the last manifest page Sirloin sent
+struct PapaManifest {
+    uint8_t type;
+    uint16_t first;
+    uint8_t count;
+    PapaDigest entries[PAPA_MANIFEST_MAX];
+
+    PapaManifest() : type(0), first(0), count(0) {}
+
+    void clear() { count = 0; }
+
+    // Replaces the page. False (page unchanged) if malformed.
+    bool parse(const uint8_t* in, size_t len) {
+        if (len < PAPA_MANIFEST_HEADER || in[0] != PAPA_RSP_MANIFEST) return false;
+        uint8_t n = in[4];
+        if (n > PAPA_MANIFEST_MAX || len < PAPA_MANIFEST_HEADER + (size_t)n * PAPA_MANIFEST_ENTRY) return false;
+        type = in[1];
+        first = in[2] | (in[3] << 8);
+        count = n;
+        const uint8_t* e = in + PAPA_MANIFEST_HEADER;
+        for (uint8_t i = 0; i < n; i++, e += PAPA_MANIFEST_ENTRY) {
+            PapaDigest& d = entries[i];
+            d.type = type;
+            d.index = (uint16_t)(first + i);
+            d.length = e[0] | (e[1] << 8);
+            d.crc = e[2] | (e[3] << 8) | ((uint32_t)e[4] << 16) | ((uint32_t)e[5] << 24);
+            memcpy(d.bssid, e + 6, 6);
+        }
+        return true;
+    }
+
+    bool covers(uint8_t t, uint16_t index) const {
+        return count > 0 && t == type && index >= first && index - first < count;
+    }
+
+    // Digest of capture (t, index) if this page has it
+    const PapaDigest* find(uint8_t t, uint16_t index) const {
+        return covers(t, index) ? &entries[index - first] : nullptr;
+    }
+
+    // The page is down to its last capture: time to ask for the next one
+    bool endsAt(uint8_t t, uint16_t index) const {
+        return covers(t, index) && index == first + count - 1;
+    }
+};
+
+// Revision 3 CMD_START_SYNC. Older Sirloins read the first four bytes.
+inline size_t papaBuildStartSync(uint8_t* out, uint8_t type, uint16_t index, uint16_t offset) {
+    out[0] = PAPA_CMD_START_SYNC;
+    out[1] = type;
+    out[2] = (uint8_t)(index & 0xFF);
+    out[3] = (uint8_t)(index >> 8);
+    out[4] = (uint8_t)(offset & 0xFF);
+    out[5] = (uint8_t)(offset >> 8);
+    return PAPA_START_SYNC_LEN;
+}
+
+// Offset carried by a CMD_START_SYNC, 0 without one
+inline uint16_t papaStartSyncOffset(const uint8_t* cmd, size_t len) {
+    if (len < PAPA_START_SYNC_LEN || cmd[0] != PAPA_CMD_START_SYNC) return 0;
+    return cmd[4] | (cmd[5] << 8);
+}
+
+// The in-order prefix of a transfer that was cut short
+struct PapaResumePoint {
+    bool valid;
+    PapaDigest digest;
+    uint16_t bytes;     // Already in the receive buffer
+    uint32_t crc;       // CRC32 of those bytes
+};
+
+// Where to pick this capture up: the saved prefix if it's the same
+// capture and some of it is still to come, else the start
+inline uint16_t papaResumeOffset(const PapaResumePoint& point, const PapaDigest& d) {
+    if (!point.valid || !papaSameCapture(point.digest, d)) return 0;
+    if (point.bytes == 0 || point.bytes >= d.length) return 0;
+    return point.bytes;
+}
+
+// One bit per chunk of a capture
+struct PapaChunkBits {
+    uint32_t words[PAPA_MAX_CHUNKS / 32];
+
+    void clear() { memset(words, 0, sizeof(words)); }
+    bool get(uint16_t i) const { return (words[i >> 5] >> (i & 31)) & 1; }
+    void set(uint16_t i) { words[i >> 5] |= (uint32_t)1 << (i & 31); }
+    void unset(uint16_t i) { words[i >> 5] &= ~((uint32_t)1 << (i & 31)); }
+};
+
+// Papa's receive side for one capture. Chunks may land in any order and
+// more than once; the buffer is complete once every chunk and the end
+// marker are in.
+class PapaRxWindow {
+public:
+    PapaRxWindow() { reset(); }
+
+    void reset() {
+        buf = nullptr;
+        capacity = 0;
+        chunk = 0;
+        total = 0;
+        window = 1;
+        next = 0;
+        highest = 0;
+        received = 0;
+        lastLen = 0;
+        crc = 0;
+        endCrc = 0;
+        endSeen = false;
+        active = false;
+        ackPending = false;
+        sinceAck = 0;
+        bits.clear();
+    }
+
+    // False (and inactive) if the capture can't fit the buffer. When
+    // resuming, buffer points past the bytes already held and crcSoFar is
+    // their CRC, so the end marker check still covers the whole capture.
+    bool begin(uint8_t* buffer, uint16_t bufferSize, uint16_t chunkSize, uint16_t totalChunks, uint8_t win,
+               uint32_t crcSoFar = 0) {
+        reset();
+        crc = crcSoFar;
+        if (chunkSize == 0 || totalChunks > PAPA_MAX_CHUNKS) return false;
+        if (totalChunks > 0 && (uint32_t)(totalChunks - 1) * chunkSize >= bufferSize) return false;
+        buf = buffer;
+        capacity = bufferSize;
+        chunk = chunkSize;
+        total = totalChunks;
+        window = win ? win : 1;
+        active = true;
+        return true;
+    }
+
+    // Store a chunk. False for duplicates, bad sizes and anything out of range.
+    bool onChunk(uint16_t seq, const uint8_t* data, uint16_t len) {
+        if (!active || seq >= total || bits.get(seq)) return false;
+        bool last = (seq == total - 1);
+        if (last ? (len == 0 || len > chunk) : (len != chunk)) return false;
+        uint32_t offset = (uint32_t)seq * chunk;
+        if (offset + len > capacity) return false;
+
+        memcpy(buf + offset, data, len);
+        bits.set(seq);
+        received++;
+        if (last) lastLen = len;
+
+        // A chunk past a hole we haven't reported yet: NACK now
+        if (seq > next && seq > highest && !bits.get(seq - 1)) ackPending = true;
+        if (seq > highest) highest = seq;
+
+        while (next < total && bits.get(next)) {
+            crc = crc32Update(crc, buf + (uint32_t)next * chunk, chunkLength(next));
+            next++;
+        }
+        if (++sinceAck >= (window + 1) / 2) ackPending = true;
+        return true;
+    }
+
+    bool onEnd(uint32_t crc32) {
+        if (!active) return false;
+        endSeen = true;
+        endCrc = crc32;
+        if (!allReceived()) ackPending = true;
+        return true;
+    }
+
+    bool isActive() const { return active; }
+    bool allReceived() const { return next >= total; }
+    bool complete() const { return active && endSeen && allReceived(); }
+    bool crcOk() const { return complete() && crc == endCrc; }
+    uint32_t crcValue() const { return crc; }
+    uint32_t expectedCrc() const { return endCrc; }
+    uint16_t receivedCount() const { return received; }
+    uint16_t nextMissing() const { return next; }
+
+    // Bytes at the start of the buffer that the CRC covers
+    uint32_t contiguousLength() const {
+        return next >= total ? length() : (uint32_t)next * chunk;
+    }
+
+    // Bytes written so far (the whole capture once complete)
+    uint32_t length() const {
+        if (total == 0) return 0;
+        return (uint32_t)(received - (lastLen ? 1 : 0)) * chunk + lastLen;
+    }
+
+    // Chunks landed beyond the first missing one
+    uint32_t mask() const {
+        uint32_t m = 0;
+        for (uint16_t i = 0; i < 32 && next + 1 + i < total; i++) {
+            if (bits.get(next + 1 + i)) m |= (uint32_t)1 << i;
+        }
+        return m;
+    }
+
+    // An ACK is owed: half a window landed, a hole opened, or the end
+    // marker arrived with chunks missing
+    bool ackDue() const { return active && ackPending; }
+
+    size_t buildAck(uint8_t* out) const {
+        return papaBuildAck(out, next, mask(), endSeen ? PAPA_ACK_END : 0);
+    }
+
+    size_t takeAck(uint8_t* out) {
+        ackPending = false;
+        sinceAck = 0;
+        return buildAck(out);
+    }
+
+private:
+    uint16_t chunkLength(uint16_t seq) const {
+        return seq == total - 1 ? lastLen : chunk;
+    }
+
+    uint8_t* buf;
+    uint32_t capacity;
+    uint16_t chunk;
+    uint16_t total;
+    uint8_t window;
+    uint16_t next;       // First chunk not yet received; CRC covers all below
+    uint16_t highest;
+    uint16_t received;
+    uint16_t lastLen;
+    uint32_t crc;
+    uint32_t endCrc;
+    bool endSeen;
+    bool active;
+    bool ackPending;
+    uint16_t sinceAck;
+    PapaChunkBits bits;
+};
+
+// Sirloin's send side for one capture: new chunks while the window has
+// room, NACKed chunks first, the end marker once everything went out.
+class PapaTxWindow {
+public:
+    PapaTxWindow() : data(nullptr), len(0), chunk(PAPA_LEGACY_CHUNK), total(0), window(1), base(0),
+                     sendNext(0), crc(0), endOwed(false), sent(0), resent(0) {
+        acked.clear();
+        resend.clear();
+    }
+
+    // False if the capture needs more than PAPA_MAX_CHUNKS chunks. To
+    // resume, pass the bytes from the offset on and the CRC of the ones
+    // before it.
+    bool begin(const uint8_t* capture, uint16_t length, uint16_t chunkSize, uint8_t win, uint32_t crcSoFar = 0) {
+        if (chunkSize == 0 || (length + chunkSize - 1) / chunkSize > PAPA_MAX_CHUNKS) return false;
+        data = capture;
+        len = length;
+        chunk = chunkSize;
+        total = (uint16_t)((length + chunkSize - 1) / chunkSize);
+        window = win ? win : 1;
+        base = 0;
+        sendNext = 0;
+        crc = crc32Update(crcSoFar, capture, length);
+        endOwed = (total == 0);
+        sent = 0;
+        resent = 0;
+        acked.clear();
+        resend.clear();
+        return true;
+    }
+
+    uint16_t totalChunks() const { return total; }
+    bool allAcked() const { return base >= total; }
+    uint32_t chunksSent() const { return sent; }
+    uint32_t chunksResent() const { return resent; }
+
+    // Next DATA notification into out (chunk + 2 bytes), 0 if the window
+    // is full or nothing is owed right now
+    size_t nextPacket(uint8_t* out) {
+        for (uint16_t seq = base; seq < sendNext; seq++) {
+            if (resend.get(seq)) {
+                resend.unset(seq);
+                resent++;
+                return chunkPacket(seq, out);
+            }
+        }
+        if (sendNext < total && sendNext < base + window) {
+            return chunkPacket(sendNext++, out);
+        }
+        if (endOwed) {
+            endOwed = false;
+            out[0] = 0xFF;
+            out[1] = 0xFF;
+            out[2] = (uint8_t)(crc & 0xFF);
+            out[3] = (uint8_t)(crc >> 8);
+            out[4] = (uint8_t)(crc >> 16);
+            out[5] = (uint8_t)(crc >> 24);
+            return 6;
+        }
+        return 0;
+    }
+
+    void onAck(uint16_t next, uint32_t mask, uint8_t flags) {
+        if (next > sendNext) next = sendNext;
+        for (uint16_t seq = base; seq < next; seq++) markAcked(seq);
+        if (next > base) base = next;
+
+        int top = -1;
+        for (int i = 0; i < 32 && next + 1 + i < sendNext; i++) {
+            if (mask & ((uint32_t)1 << i)) {
+                markAcked(next + 1 + i);
+                top = next + 1 + i;
+            }
+        }
+        // Below the highest chunk Papa has, anything missing was lost.
+        // After the end marker everything still missing was.
+        uint16_t lostBelow = (flags & PAPA_ACK_END) ? sendNext : (uint16_t)(top < 0 ? 0 : top);
+        for (uint16_t seq = base; seq < lostBelow; seq++) {
+            if (!acked.get(seq)) resend.set(seq);
+        }
+    }
+
+    // Nothing heard for a while: the tail or the end marker went missing
+    void onTimeout() {
+        for (uint16_t seq = base; seq < sendNext; seq++) {
+            if (!acked.get(seq)) resend.set(seq);
+        }
+        if (sendNext >= total) endOwed = true;
+    }
+
+private:
+    size_t chunkPacket(uint16_t seq, uint8_t* out) {
+        uint32_t offset = (uint32_t)seq * chunk;
+        uint16_t n = (uint16_t)(len - offset < chunk ? len - offset : chunk);
+        out[0] = (uint8_t)(seq & 0xFF);
+        out[1] = (uint8_t)(seq >> 8);
+        memcpy(out + 2, data + offset, n);
+        sent++;
+        // Last chunk out and nothing left to repeat: follow with the end marker
+        if (sendNext >= total && !pendingResend()) endOwed = true;
+        return n + 2;
+    }
+
+    bool pendingResend() const {
+        for (uint16_t seq = base; seq < sendNext; seq++) {
+            if (resend.get(seq)) return true;
+        }
+        return false;
+    }
+
+    void markAcked(uint16_t seq) {
+        acked.set(seq);
+        resend.unset(seq);
+    }
+
+    const uint8_t* data;
+    uint16_t len;
+    uint16_t chunk;
+    uint16_t total;
+    uint8_t window;
+    uint16_t base;       // First chunk not yet acknowledged
+    uint16_t sendNext;   // First chunk never sent
+    uint32_t crc;
+    bool endOwed;
+    uint32_t sent;
+    uint32_t resent;
+    PapaChunkBits acked;
+    PapaChunkBits resend;
+};
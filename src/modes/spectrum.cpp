@@ -5,6 +5,9 @@
 #include "../core/config.h"
 #include "../core/oui.h"
 #include "../core/wsl_bypasser.h"
+#include "../core/bssid_index.h"
+#include "../core/beacon_view.h"
+#include "../core/perf_trace.h"
 #include "../core/xp.h"
 #include "../ui/display.h"
 #include <M5Cardputer.h>
@@ -39,6 +42,9 @@ const uint32_t UPDATE_INTERVAL_MS = 100;   // 10 FPS update rate
 // Memory limits
 const size_t MAX_SPECTRUM_NETWORKS = 100;  // Cap networks to prevent OOM
 
+// BSSID -> networks[] position (callback appends, pruneStale() rebuilds)
+static BssidIndex<256> networkIndex;
+
 // Static members
 bool SpectrumMode::running = false;
 volatile bool SpectrumMode::busy = false;
@@ -78,6 +84,7 @@ uint8_t SpectrumMode::detailClientMAC[6] = {0};  // MAC of client being viewed
 void SpectrumMode::init() {
     networks.clear();
     networks.shrink_to_fit();  // Release vector capacity
+    networkIndex.clear();
     viewCenterMHz = DEFAULT_CENTER_MHZ;
     viewWidthMHz = DEFAULT_WIDTH_MHZ;
     selectedIndex = -1;
@@ -190,7 +197,7 @@ void SpectrumMode::update() {
         bool networkLost = false;
         
         // Check if network got shuffled out
-        if (monitoredNetworkIndex >= (int)networks.size() ||
+        if (monitoredNetworkIndex < 0 || monitoredNetworkIndex >= (int)networks.size() ||
             !macEqual(networks[monitoredNetworkIndex].bssid, monitoredBSSID)) {
             networkLost = true;
         }
@@ -793,21 +800,21 @@ void SpectrumMode::pruneStale() {
             }),
         networks.end()
     );
+    networkIndex.rebuild(networks.data(), networks.size());
     
     // Restore selection by finding BSSID in new vector
     if (hadSelection) {
-        selectedIndex = -1;  // Assume lost
-        for (size_t i = 0; i < networks.size(); i++) {
-            if (memcmp(networks[i].bssid, selectedBSSID, 6) == 0) {
-                selectedIndex = (int)i;
-                break;
-            }
-        }
+        selectedIndex = networkIndex.find(selectedBSSID, networks.data(), networks.size());
     } else if (selectedIndex >= (int)networks.size()) {
         // No prior selection, just bounds-check
         selectedIndex = networks.empty() ? -1 : 0;
     }
     
+    // Follow the monitored network to its new position (-1 = lost)
+    if (monitoringNetwork) {
+        monitoredNetworkIndex = networkIndex.find(monitoredBSSID, networks.data(), networks.size());
+    }
+    
     busy = false;
 }
 
@@ -818,33 +825,33 @@ void SpectrumMode::onBeacon(const uint8_t* bssid, uint8_t channel, int8_t rssi,
     bool hasSSID = (ssid && ssid[0] != 0);
     
     // Look for existing network
-    for (auto& net : networks) {
-        if (memcmp(net.bssid, bssid, 6) == 0) {
-            // Update existing
-            net.rssi = rssi;
-            net.lastSeen = millis();
-            net.authmode = authmode;  // Update auth mode
-            net.hasPMF = hasPMF;      // Update PMF status
-            
-            // Probe response can reveal hidden SSID
-            if (hasSSID && net.isHidden && net.ssid[0] == 0) {
-                strncpy(net.ssid, ssid, 32);
-                net.ssid[32] = 0;
-                net.wasRevealed = true;
-                // Defer logging to main thread (avoid Serial in WiFi callback)
-                if (!pendingReveal) {
-                    strncpy(pendingRevealSSID, ssid, 32);
-                    pendingRevealSSID[32] = 0;
-                    pendingReveal = true;
-                }
-            }
-            // Also update if we had no SSID before
-            else if (hasSSID && net.ssid[0] == 0) {
-                strncpy(net.ssid, ssid, 32);
-                net.ssid[32] = 0;
+    int idx = networkIndex.find(bssid, networks.data(), networks.size());
+    if (idx >= 0) {
+        SpectrumNetwork& net = networks[idx];
+        // Update existing
+        net.rssi = rssi;
+        net.lastSeen = millis();
+        net.authmode = authmode;  // Update auth mode
+        net.hasPMF = hasPMF;      // Update PMF status
+        
+        // Probe response can reveal hidden SSID
+        if (hasSSID && net.isHidden && net.ssid[0] == 0) {
+            strncpy(net.ssid, ssid, 32);
+            net.ssid[32] = 0;
+            net.wasRevealed = true;
+            // Defer logging to main thread (avoid Serial in WiFi callback)
+            if (!pendingReveal) {
+                strncpy(pendingRevealSSID, ssid, 32);
+                pendingRevealSSID[32] = 0;
+                pendingReveal = true;
             }
-            return;
         }
+        // Also update if we had no SSID before
+        else if (hasSSID && net.ssid[0] == 0) {
+            strncpy(net.ssid, ssid, 32);
+            net.ssid[32] = 0;
+        }
+        return;
     }
     
     // Add new network (limit to prevent OOM)
@@ -873,6 +880,7 @@ void SpectrumMode::onBeacon(const uint8_t* bssid, uint8_t channel, int8_t rssi,
     }
     
     networks.push_back(net);
+    networkIndex.insert(net.bssid, networks.size() - 1);
     
     // Defer XP to main loop (onBeacon runs in WiFi callback - can't call Display::showLevelUp)
     // If pendingNetworkXP overflows (255), we just miss some +1 XP - acceptable
@@ -935,6 +943,8 @@ String SpectrumMode::getSelectedInfo() {
 
 // Promiscuous callback - extract beacon info
 void SpectrumMode::promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t type) {
+    PERF_SCOPE(PerfSection::SPECTRUM_CALLBACK);
+    
     if (!running) return;
     if (busy) return;  // [P1] Main thread is iterating
     
@@ -952,67 +962,29 @@ void SpectrumMode::promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t ty
     
     if (type != WIFI_PKT_MGMT) return;
     
-    if (len < 36) return;
-    
     // Check frame type - beacon (0x80) or probe response (0x50)
     uint8_t frameType = payload[0];
     if (frameType != 0x80 && frameType != 0x50) return;
     
     bool isProbeResponse = (frameType == 0x50);
     
-    // BSSID is at offset 16
-    const uint8_t* bssid = payload + 16;
-    
-    // Parse SSID from tagged parameters (starts at offset 36)
-    char ssid[33] = {0};
-    uint16_t offset = 36;
+    // Single pass over the IEs
+    BeaconView view;
+    if (!view.parse(payload, len)) return;
     
-    while (offset + 2 < len) {
-        uint8_t tagNum = payload[offset];
-        uint8_t tagLen = payload[offset + 1];
-        
-        if (offset + 2 + tagLen > len) break;
-        
-        if (tagNum == 0 && tagLen <= 32) {  // SSID tag
-            memcpy(ssid, payload + offset + 2, tagLen);
-            ssid[tagLen] = 0;
-            break;
-        }
-        
-        offset += 2 + tagLen;
-    }
+    char ssid[33];
+    view.copySSID(ssid);
     
-    // Parse auth mode from RSN (0x30) and WPA (0xDD) IEs
-    wifi_auth_mode_t authmode = WIFI_AUTH_OPEN;  // Default to open
-    bool hasRSN = false;
-    offset = 36;
-    while (offset + 2 < len) {
-        uint8_t tagNum = payload[offset];
-        uint8_t tagLen = payload[offset + 1];
-        
-        if (offset + 2 + tagLen > len) break;
-        
-        if (tagNum == 0x30 && tagLen >= 2) {  // RSN IE = WPA2/WPA3
-            hasRSN = true;
-            authmode = WIFI_AUTH_WPA2_PSK;
-        } else if (tagNum == 0xDD && tagLen >= 8) {  // Vendor specific
-            // Check for WPA1 OUI: 00:50:F2:01
-            if (payload[offset + 2] == 0x00 && payload[offset + 3] == 0x50 &&
-                payload[offset + 4] == 0xF2 && payload[offset + 5] == 0x01) {
-                // WPA1 - only set if not already WPA2
-                if (!hasRSN) {
-                    authmode = WIFI_AUTH_WPA_PSK;
-                } else {
-                    authmode = WIFI_AUTH_WPA_WPA2_PSK;
-                }
-            }
-        }
-        
-        offset += 2 + tagLen;
+    // Auth mode from RSN / WPA IEs
+    wifi_auth_mode_t authmode = WIFI_AUTH_OPEN;
+    if (view.hasRSN) {
+        authmode = view.hasWPA ? WIFI_AUTH_WPA_WPA2_PSK : WIFI_AUTH_WPA2_PSK;
+    } else if (view.hasWPA) {
+        authmode = WIFI_AUTH_WPA_PSK;
     }
     
-    // Detect PMF (Protected Management Frames)
-    bool hasPMF = detectPMF(payload, len);
+    // PMF required (MFPR=1) - immune to deauth
+    bool hasPMF = view.pmfRequired;
     
     // If PMF is required and we have RSN, it's WPA3 (or WPA2/3 transitional)
     if (hasPMF && authmode == WIFI_AUTH_WPA2_PSK) {
@@ -1020,7 +992,7 @@ void SpectrumMode::promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t ty
     }
     
     // Update spectrum data
-    onBeacon(bssid, channel, rssi, ssid, authmode, hasPMF, isProbeResponse);
+    onBeacon(view.bssid, channel, rssi, ssid, authmode, hasPMF, isProbeResponse);
 }
 
 // Check if auth mode is considered vulnerable (OPEN, WEP, WPA1)
@@ -1050,53 +1022,6 @@ const char* SpectrumMode::authModeToShortString(wifi_auth_mode_t mode) {
     }
 }
 
-// Detect PMF (Protected Management Frames) from RSN IE
-// Networks with PMF required (MFPR=1) are immune to deauth attacks
-bool SpectrumMode::detectPMF(const uint8_t* payload, uint16_t len) {
-    uint16_t offset = 36;  // After fixed beacon fields
-    
-    while (offset + 2 < len) {
-        uint8_t tag = payload[offset];
-        uint8_t tagLen = payload[offset + 1];
-        
-        if (offset + 2 + tagLen > len) break;
-        
-        if (tag == 0x30 && tagLen >= 8) {  // RSN IE
-            // RSN IE structure: version(2) + group cipher(4) + pairwise count(2) + ...
-            uint16_t rsnOffset = offset + 2;
-            uint16_t rsnEnd = rsnOffset + tagLen;
-            
-            // Skip version (2), group cipher (4)
-            rsnOffset += 6;
-            if (rsnOffset + 2 > rsnEnd) break;
-            
-            // Pairwise cipher count and suites
-            uint16_t pairwiseCount = payload[rsnOffset] | (payload[rsnOffset + 1] << 8);
-            rsnOffset += 2 + (pairwiseCount * 4);
-            if (rsnOffset + 2 > rsnEnd) break;
-            
-            // AKM count and suites
-            uint16_t akmCount = payload[rsnOffset] | (payload[rsnOffset + 1] << 8);
-            rsnOffset += 2 + (akmCount * 4);
-            if (rsnOffset + 2 > rsnEnd) break;
-            
-            // RSN Capabilities (2 bytes)
-            uint16_t rsnCaps = payload[rsnOffset] | (payload[rsnOffset + 1] << 8);
-            
-            // Bit 7: MFPR (Management Frame Protection Required)
-            bool mfpr = (rsnCaps >> 7) & 0x01;
-            
-            if (mfpr) {
-                return true;  // PMF required - deauth won't work
-            }
-        }
-        
-        offset += 2 + tagLen;
-    }
-    
-    return false;
-}
-
 // Process data frame to extract client MAC
 void SpectrumMode::processDataFrame(const uint8_t* payload, uint16_t len, int8_t rssi) {
     if (len < 24) return;  // Too short for valid data frame
@@ -1168,7 +1093,7 @@ void SpectrumMode::trackClient(const uint8_t* bssid, const uint8_t* clientMac, i
         memcpy(newClient.mac, clientMac, 6);
         newClient.rssi = rssi;
         newClient.lastSeen = now;
-        newClient.vendor = OUI::getVendor(clientMac);  // Cache once
+        newClient.vendor = OUI::getVendor(clientMac);  // Points into flash, safe to keep
         net.clientCount++;
         
         // Request beep for first few clients (avoid spamming)
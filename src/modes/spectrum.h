@@ -55,6 +55,7 @@ public:
     
     // Bottom bar info
     static String getSelectedInfo();
+    static size_t getNetworkCount() { return networks.size(); }
     
     // Client monitoring accessors [P3]
     static bool isMonitoring() { return monitoringNetwork; }
@@ -128,7 +129,6 @@ private:
     // Security helpers
     static bool isVulnerable(wifi_auth_mode_t mode);
     static const char* authModeToShortString(wifi_auth_mode_t mode);
-    static bool detectPMF(const uint8_t* payload, uint16_t len);
     
     // Promiscuous mode
     static void promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t type);
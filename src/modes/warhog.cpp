@@ -3,8 +3,11 @@
 // Key changes from original:
 // - No entries[] vector - data goes directly to disk
 // - No "waiting for GPS" state - either GPS or ML-only
-// - Simpler memory management - just seenBSSIDs for duplicate detection
-// - Per-network file writes instead of batch saves
+// - Simpler memory management - BssidStore for duplicate detection
+// - One binary observation log (.wdl) per session; the WiGLE, CSV and ML
+//   text formats are exported from it on demand (core/wardrive_log.h)
+// - Each scan's records are built in RAM, then written with one open and
+//   one write
 
 #include "warhog.h"
 #include "../build_info.h"
@@ -12,6 +15,9 @@
 #include "../core/wsl_bypasser.h"
 #include "../core/sdlog.h"
 #include "../core/xp.h"
+#include "../core/perf_trace.h"
+#include "../core/bssid_store.h"
+#include "../core/wardrive_log.h"
 #include "../ui/display.h"
 #include "../piglet/mood.h"
 #include "../piglet/avatar.h"
@@ -24,11 +30,6 @@
 #include <freertos/task.h>
 #include <math.h>
 
-// Maximum BSSIDs tracked in seenBSSIDs set
-// Each std::set node = 24 bytes (8 byte key + 16 byte tree overhead)
-// 5000 entries = ~120KB - leaves headroom for other allocations
-static const size_t MAX_SEEN_BSSIDS = 5000;
-
 // Heap threshold for emergency cleanup (bytes)
 static const size_t HEAP_WARNING_THRESHOLD = 40000;
 static const size_t HEAP_CRITICAL_THRESHOLD = 25000;
@@ -38,9 +39,32 @@ static const int SD_RETRY_COUNT = 3;
 static const int SD_RETRY_DELAY_MS = 10;
 
 // WiGLE file size limit for upload compatibility (400KB - leave room for headers)
-// Files larger than this will be rotated to a new file
+// Logs whose WiGLE export would be larger than this are rotated to a new file
 static const size_t WIGLE_FILE_MAX_SIZE = 400000;
 
+// Enhanced-mode feature table: 512 slots (~32KB) hold the 384 most recently
+// heard BSSIDs. Entries unheard for a minute are dropped at each scan.
+static const size_t FEATURE_SLOTS = 512;
+static const uint32_t FEATURE_MAX_AGE_MS = 60000;
+
+// Guards beaconFeatures between the promiscuous callback and the scan
+// processing - held only for a table update or one entry copy
+static portMUX_TYPE featureMux = portMUX_INITIALIZER_UNLOCKED;
+
+// SSID dictionary slots per log (10KB); past 3/4 load SSIDs are re-emitted
+static const uint16_t SSID_DICT_SLOTS = 1024;
+
+// BssidStore only holds APs with a geotagged row. This session-only set
+// (2048 keys + 4KB bloom, ~16KB) counts the others once - stats, XP, the
+// ML-only row - while they wait for a fix. Once full, newcomers without
+// a fix are no longer counted.
+static const uint32_t SESSION_SEEN_KEYS = 2048;
+static const uint32_t SESSION_SEEN_BLOOM = 4096;
+
+// Session marker: paths of the files this session appends to. Left behind
+// by a crash, it tells the next start() which files may have a torn record.
+#define WARHOG_SESSION_FILE "/wardriving/.session"
+
 // Graceful stop request flag for background scan task
 static volatile bool stopRequested = false;
 
@@ -55,6 +79,46 @@ static File openFileWithRetry(const char* path, const char* mode) {
     return f;  // Returns invalid File if all retries failed
 }
 
+// One scan's records, built in RAM and written with a single open + write
+// instead of an open/close per network
+struct RowBuffer {
+    uint8_t* data;
+    size_t len;
+    size_t cap;
+    
+    bool reserve(size_t extra) {
+        if (len + extra <= cap) return true;
+        size_t want = cap ? cap : 2048;
+        while (want < len + extra) want *= 2;
+        uint8_t* grown = (uint8_t*)realloc(data, want);
+        if (!grown) return false;
+        data = grown;
+        cap = want;
+        return true;
+    }
+    
+    bool append(const void* src, size_t n) {
+        if (!reserve(n)) return false;
+        memcpy(data + len, src, n);
+        len += n;
+        return true;
+    }
+    
+    void release() {
+        free(data);
+        data = nullptr;
+        len = 0;
+        cap = 0;
+    }
+};
+
+static RowBuffer logRows = {nullptr, 0, 0};
+static RowBuffer pendingSeen = {nullptr, 0, 0};  // Geotagged BSSIDs in logRows, 6 bytes each
+static WdlSsidDict ssidDict;
+static BssidSet sessionSeen;
+static uint32_t logSize = 0;       // Tracked so a failed batch can be cut off
+static uint32_t wigleBytes = 0;    // Size the log's WiGLE export will have
+
 // Haversine formula for GPS distance calculation
 static double haversineMeters(double lat1, double lon1, double lat2, double lon2) {
     const double R = 6371000.0;  // Earth radius in meters
@@ -78,7 +142,6 @@ static uint32_t lastDistanceCheck = 0;
 bool WarhogMode::running = false;
 uint32_t WarhogMode::lastScanTime = 0;
 uint32_t WarhogMode::scanInterval = 5000;
-std::set<uint64_t> WarhogMode::seenBSSIDs;
 uint32_t WarhogMode::totalNetworks = 0;
 uint32_t WarhogMode::openNetworks = 0;
 uint32_t WarhogMode::wepNetworks = 0;
@@ -86,8 +149,6 @@ uint32_t WarhogMode::wpaNetworks = 0;
 uint32_t WarhogMode::savedCount = 0;      // Geotagged networks (CSV)
 uint32_t WarhogMode::mlOnlyCount = 0;     // Networks without GPS (ML only)
 String WarhogMode::currentFilename = "";
-String WarhogMode::currentMLFilename = "";
-String WarhogMode::currentWigleFilename = "";
 
 // Scan state
 bool WarhogMode::scanInProgress = false;
@@ -95,9 +156,8 @@ uint32_t WarhogMode::scanStartTime = 0;
 
 // Enhanced mode statics
 bool WarhogMode::enhancedMode = false;
-std::map<uint64_t, WiFiFeatures> WarhogMode::beaconFeatures;
+BssidLru<WiFiFeatures> WarhogMode::beaconFeatures;
 uint32_t WarhogMode::beaconCount = 0;
-volatile bool WarhogMode::beaconMapBusy = false;
 
 // Background scan task statics
 TaskHandle_t WarhogMode::scanTaskHandle = NULL;
@@ -108,21 +168,32 @@ static inline bool shouldAbortScan() {
     return stopRequested || !WarhogMode::isRunning();
 }
 
-// Helper to write CSV-escaped SSID field (quoted, doubles internal quotes, strips control chars)
-static void writeCSVField(File& f, const char* ssid) {
-    f.print("\"");
-    for (int i = 0; i < 32 && ssid[i]; i++) {
-        if (ssid[i] == '"') {
-            f.print("\"\"");
-        } else if (ssid[i] >= 32) {  // Skip control characters (newlines, etc)
-            f.print(ssid[i]);
+// Record which files this session appends to (see WARHOG_SESSION_FILE)
+void WarhogMode::writeSessionMarker() {
+    File f = SD.open(WARHOG_SESSION_FILE, FILE_WRITE);
+    if (!f) return;
+    if (currentFilename.length() > 0) f.println(currentFilename);
+    f.close();
+}
+
+// Previous session didn't stop cleanly: make sure its logs end on a record
+void WarhogMode::recoverSessionFiles() {
+    if (!Config::isSDAvailable() || !SD.exists(WARHOG_SESSION_FILE)) return;
+    
+    File f = SD.open(WARHOG_SESSION_FILE, FILE_READ);
+    if (f) {
+        Serial.println("[WARHOG] Recovering files from unclean stop");
+        while (f.available()) {
+            String path = f.readStringUntil('\n');
+            path.trim();
+            if (path.length() > 0) WardriveLog::repairTail(path.c_str());
         }
+        f.close();
     }
-    f.print("\"");
+    SD.remove(WARHOG_SESSION_FILE);
 }
 
 void WarhogMode::init() {
-    seenBSSIDs.clear();
     totalNetworks = 0;
     openNetworks = 0;
     wepNetworks = 0;
@@ -130,15 +201,13 @@ void WarhogMode::init() {
     savedCount = 0;
     mlOnlyCount = 0;
     currentFilename = "";
-    currentMLFilename = "";
-    currentWigleFilename = "";
     
     // Check if Enhanced ML mode is enabled
     enhancedMode = (Config::ml().collectionMode == MLCollectionMode::ENHANCED);
-    // Guard beacon map in case callback still registered from abnormal shutdown
-    beaconMapBusy = true;
+    // Lock in case callback still registered from abnormal shutdown
+    taskENTER_CRITICAL(&featureMux);
     beaconFeatures.clear();
-    beaconMapBusy = false;
+    taskEXIT_CRITICAL(&featureMux);
     beaconCount = 0;
     
     scanInterval = Config::gps().updateInterval * 1000;
@@ -152,8 +221,9 @@ void WarhogMode::start() {
     
     Serial.println("[WARHOG] Starting...");
     
-    // Clear previous session data
-    seenBSSIDs.clear();
+    // Clear previous session data (seen BSSIDs persist across sessions)
+    recoverSessionFiles();
+    BssidStore::begin();
     totalNetworks = 0;
     openNetworks = 0;
     wepNetworks = 0;
@@ -161,13 +231,19 @@ void WarhogMode::start() {
     savedCount = 0;
     mlOnlyCount = 0;
     currentFilename = "";
-    currentMLFilename = "";
-    currentWigleFilename = "";
+    logSize = 0;
+    wigleBytes = 0;
+    if (!ssidDict.init(SSID_DICT_SLOTS)) {
+        Serial.println("[WARHOG] No memory for SSID dictionary, SSIDs will repeat");
+    }
+    if (!sessionSeen.init(SESSION_SEEN_KEYS, SESSION_SEEN_BLOOM)) {
+        Serial.println("[WARHOG] No memory for session BSSID set, APs without a fix won't count");
+    }
     
-    // Guard beacon map in case callback still registered from previous session
-    beaconMapBusy = true;
+    // Lock in case callback still registered from previous session
+    taskENTER_CRITICAL(&featureMux);
     beaconFeatures.clear();
-    beaconMapBusy = false;
+    taskEXIT_CRITICAL(&featureMux);
     beaconCount = 0;
     
     // Reset distance tracking for XP
@@ -263,6 +339,19 @@ void WarhogMode::stop() {
     
     running = false;
     
+    // Fold this session's BSSIDs into the SD checkpoint
+    BssidStore::end();
+    
+    // Every batch is already on disk; a clean stop needs no recovery
+    flushRows();
+    logRows.release();
+    pendingSeen.release();
+    ssidDict.release();
+    sessionSeen.release();
+    if (Config::isSDAvailable()) {
+        SD.remove(WARHOG_SESSION_FILE);
+    }
+    
     // Log final statistics
     Serial.printf("[WARHOG] Session complete - Total: %lu, Geotagged: %lu, ML-only: %lu\n",
                   totalNetworks, savedCount, mlOnlyCount);
@@ -353,17 +442,13 @@ void WarhogMode::update() {
     if (now - lastHeapCheck >= 30000) {
         uint32_t freeHeap = ESP.getFreeHeap();
         Serial.printf("[WARHOG] Heap: %lu free, SeenBSSIDs: %lu, BeaconCache: %lu\n",
-                      freeHeap, seenBSSIDs.size(), beaconFeatures.size());
+                      freeHeap, BssidStore::size(), beaconFeatures.size());
         
         if (freeHeap < HEAP_CRITICAL_THRESHOLD) {
             Serial.println("[WARHOG] CRITICAL: Low heap! Emergency cleanup...");
             Display::showToast("LOW MEMORY!");
-            // Emergency: clear tracking data to prevent crash
-            // Guard beacon map from promiscuous callback during clear
-            beaconMapBusy = true;
-            seenBSSIDs.clear();
-            beaconFeatures.clear();
-            beaconMapBusy = false;
+            // Nothing of ours to free: BssidStore and the beacon feature
+            // table are allocated once at start and never grow
         } else if (freeHeap < HEAP_WARNING_THRESHOLD) {
             Serial.println("[WARHOG] WARNING: Heap getting low");
         }
@@ -479,8 +564,8 @@ void WarhogMode::performScan() {
     }
 }
 
-// Ensure CSV file exists with header
-bool WarhogMode::ensureCSVFileReady() {
+// Ensure the session log exists with its header
+bool WarhogMode::ensureLogFileReady() {
     if (currentFilename.length() > 0) return true;
     
     // Ensure wardriving directory exists
@@ -491,248 +576,144 @@ bool WarhogMode::ensureCSVFileReady() {
         }
     }
     
-    currentFilename = generateFilename("csv");
+    currentFilename = generateFilename(WDL_EXT);
     
     File f = openFileWithRetry(currentFilename.c_str(), FILE_WRITE);
     if (!f) {
-        Serial.printf("[WARHOG] Failed to create CSV: %s\n", currentFilename.c_str());
+        Serial.printf("[WARHOG] Failed to create log: %s\n", currentFilename.c_str());
         currentFilename = "";
         return false;
     }
     
-    f.println("BSSID,SSID,RSSI,Channel,AuthMode,Latitude,Longitude,Altitude,Timestamp");
+    WdlHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = WDL_MAGIC;
+    hdr.version = WDL_VERSION;
+    hdr.headerSize = sizeof(hdr);
+    #ifdef BUILD_VERSION
+    strncpy(hdr.appRelease, BUILD_VERSION, sizeof(hdr.appRelease));
+    #endif
+    bool ok = f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
     f.close();
-    
-    Serial.printf("[WARHOG] Created CSV: %s\n", currentFilename.c_str());
-    return true;
-}
-
-// Ensure ML file exists with header
-bool WarhogMode::ensureMLFileReady() {
-    if (currentMLFilename.length() > 0) return true;
-    
-    // Ensure mldata directory exists
-    if (!SD.exists("/mldata")) {
-        if (!SD.mkdir("/mldata")) {
-            Serial.println("[WARHOG] Failed to create /mldata directory");
-            return false;
-        }
-    }
-    
-    currentMLFilename = generateFilename("ml.csv");
-    // Put ML files in /mldata folder
-    currentMLFilename.replace("/wardriving/warhog_", "/mldata/ml_training_");
-    
-    File f = openFileWithRetry(currentMLFilename.c_str(), FILE_WRITE);
-    if (!f) {
-        Serial.printf("[WARHOG] Failed to create ML file: %s\n", currentMLFilename.c_str());
-        currentMLFilename = "";
+    if (!ok) {
+        Serial.printf("[WARHOG] Failed to write log header: %s\n", currentFilename.c_str());
+        SD.remove(currentFilename.c_str());
+        currentFilename = "";
         return false;
     }
+    logSize = sizeof(hdr);
+    wigleBytes = 0;
+    writeSessionMarker();
     
-    // CSV header - all 32 feature vector values + label + metadata
-    f.print("bssid,ssid,");
-    f.print("rssi,noise,snr,channel,secondary_ch,beacon_interval,");
-    f.print("capability_lo,capability_hi,has_wps,has_wpa,has_wpa2,has_wpa3,");
-    f.print("is_hidden,response_time,beacon_count,beacon_jitter,");
-    f.print("responds_probe,probe_response_time,vendor_ie_count,");
-    f.print("supported_rates,ht_cap,vht_cap,anomaly_score,");
-    f.print("f23,f24,f25,f26,f27,f28,f29,f30,f31,");
-    f.println("label,latitude,longitude");
-    f.close();
-    
-    Serial.printf("[WARHOG] Created ML file: %s\n", currentMLFilename.c_str());
+    Serial.printf("[WARHOG] Created log: %s\n", currentFilename.c_str());
     return true;
 }
 
-// Append single network to CSV file
-void WarhogMode::appendCSVEntry(const uint8_t* bssid, const char* ssid,
-                                 int8_t rssi, uint8_t channel, wifi_auth_mode_t auth,
-                                 double lat, double lon, double alt) {
-    if (!ensureCSVFileReady()) return;
-    
-    File f = openFileWithRetry(currentFilename.c_str(), FILE_APPEND);
-    if (!f) return;
-    
-    f.printf("%02X:%02X:%02X:%02X:%02X:%02X,",
-            bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
-    writeCSVField(f, ssid);
-    f.print(",");
-    f.printf("%d,%d,%s,%.6f,%.6f,%.1f,%lu\n",
-            rssi, channel, authModeToString(auth).c_str(),
-            lat, lon, alt, millis());
-    f.close();
-}
-
-// Append single network to ML file
-void WarhogMode::appendMLEntry(const uint8_t* bssid, const char* ssid,
-                                const WiFiFeatures& features, uint8_t label,
-                                double lat, double lon) {
-    if (!ensureMLFileReady()) return;
-    
-    File f = openFileWithRetry(currentMLFilename.c_str(), FILE_APPEND);
-    if (!f) return;
-    
-    // BSSID
-    f.printf("%02X:%02X:%02X:%02X:%02X:%02X,",
-            bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
-    
-    // SSID (escaped)
-    writeCSVField(f, ssid);
-    f.print(",");
-    
-    // Convert features to vector and write
-    float featureVec[FEATURE_VECTOR_SIZE];
-    FeatureExtractor::toFeatureVector(features, featureVec);
-    
-    for (int i = 0; i < FEATURE_VECTOR_SIZE; i++) {
-        f.printf("%.4f,", featureVec[i]);
-    }
-    
-    // Label and GPS
-    f.printf("%d,%.6f,%.6f\n", label, lat, lon);
-    f.close();
-}
-
-// Check if WiGLE file needs rotation due to size
-void WarhogMode::checkWigleFileRotation() {
-    if (currentWigleFilename.length() == 0) return;
-    
-    File f = SD.open(currentWigleFilename.c_str(), FILE_READ);
-    if (!f) return;
-    
-    size_t fileSize = f.size();
-    f.close();
+// Start a new log once this one's WiGLE export would outgrow an upload.
+// Runs before a scan queues anything: SSID ids are per file.
+void WarhogMode::checkLogRotation() {
+    if (currentFilename.length() == 0) return;
     
-    if (fileSize >= WIGLE_FILE_MAX_SIZE) {
-        Serial.printf("[WARHOG] WiGLE file rotated at %d bytes\n", fileSize);
-        currentWigleFilename = "";  // Force new file creation on next append
+    if (wigleBytes >= WIGLE_FILE_MAX_SIZE) {
+        Serial.printf("[WARHOG] Log rotated at %u WiGLE bytes\n", (unsigned)wigleBytes);
+        currentFilename = "";  // Force new file creation on next flush
+        ssidDict.reset();
+        wigleBytes = 0;
     }
 }
 
-// Ensure WiGLE file exists with header
-bool WarhogMode::ensureWigleFileReady() {
-    // Check if current file needs rotation
-    checkWigleFileRotation();
-    
-    if (currentWigleFilename.length() > 0) return true;
-    
-    // Ensure wardriving directory exists
-    if (!SD.exists("/wardriving")) {
-        if (!SD.mkdir("/wardriving")) {
-            Serial.println("[WARHOG] Failed to create /wardriving directory");
-            return false;
-        }
-    }
-    
-    currentWigleFilename = generateFilename("wigle.csv");
-    
-    File f = openFileWithRetry(currentWigleFilename.c_str(), FILE_WRITE);
-    if (!f) {
-        Serial.printf("[WARHOG] Failed to create WiGLE CSV: %s\n", currentWigleFilename.c_str());
-        currentWigleFilename = "";
-        return false;
+// Queue one observation (plus its SSID and features records as needed).
+// False if it was dropped for lack of memory.
+bool WarhogMode::appendObservation(const uint8_t* bssid, const char* ssid,
+                                   int8_t rssi, uint8_t channel, wifi_auth_mode_t auth,
+                                   const GPSData* gps, const WiFiFeatures* features) {
+    size_t ssidLen = strnlen(ssid, 32);
+    if (!logRows.reserve(sizeof(WdlSsidRecord) + ssidLen + sizeof(WdlObservation) + sizeof(WdlFeatures))) {
+        return false;  // Out of memory: drop this one rather than log half of it
+    }
+    
+    bool isNew;
+    uint16_t ssidId = ssidDict.lookup(ssid, ssidLen, isNew);
+    if (isNew) {
+        WdlSsidRecord rec = {WDL_REC_SSID, (uint8_t)ssidLen, ssidId};
+        logRows.append(&rec, sizeof(rec));
+        logRows.append(ssid, ssidLen);
+    }
+    
+    WdlObservation obs;
+    memset(&obs, 0, sizeof(obs));
+    obs.type = WDL_REC_OBS;
+    memcpy(obs.bssid, bssid, 6);
+    obs.ssidId = ssidId;
+    obs.rssi = rssi;
+    obs.channel = channel;
+    obs.auth = (uint8_t)auth;
+    obs.uptimeMs = millis();
+    if (gps) {
+        obs.flags |= WDL_OBS_GPS;
+        obs.lat = wdlFixed(gps->latitude, 1e7);
+        obs.lon = wdlFixed(gps->longitude, 1e7);
+        obs.altDm = wdlFixed(gps->altitude, 10);
+        // HDOP * 5 as rough accuracy estimate in meters
+        double accuracy = gps->hdop > 0 ? gps->hdop * 5.0 : 10.0;
+        int32_t accuracyDm = wdlFixed(accuracy, 10);
+        obs.accuracyDm = accuracyDm > 65535 ? 65535 : (uint16_t)accuracyDm;
+        obs.time = wdlUnixFromGps(gps->date, gps->time);
+    }
+    if (features) obs.flags |= WDL_OBS_FEATURES;
+    logRows.append(&obs, sizeof(obs));
+    
+    if (features) {
+        WdlFeatures packed;
+        WardriveLog::packFeatures(*features, packed);
+        logRows.append(&packed, sizeof(packed));
+    }
+    
+    // Keep count of the WiGLE export so rotation matches the old 400KB files
+    if (gps) {
+        char row[256];
+        wigleBytes += wdlWigleRow(row, sizeof(row), obs, ssid);
     }
-    
-    // WiGLE format v1.6 pre-header
-    f.print("WigleWifi-1.6,appRelease=");
-    #ifdef BUILD_VERSION
-    f.print(BUILD_VERSION);
-    #else
-    f.print("0.1.x");
-    #endif
-    f.print(",model=M5Cardputer,release=ESP32-S3,device=PORKCHOP,display=240x135,board=m5stack,brand=M5Stack,star=Sol,body=3,subBody=0\n");
-    
-    // WiGLE format header
-    f.println("MAC,SSID,AuthMode,FirstSeen,Channel,Frequency,RSSI,CurrentLatitude,CurrentLongitude,AltitudeMeters,AccuracyMeters,RCOIs,MfgrId,Type");
-    f.close();
-    
-    Serial.printf("[WARHOG] Created WiGLE CSV: %s\n", currentWigleFilename.c_str());
     return true;
 }
 
-// Convert auth mode to WiGLE capability string format
-String WarhogMode::authModeToWigleString(wifi_auth_mode_t mode) {
-    switch (mode) {
-        case WIFI_AUTH_OPEN:
-            return "[ESS]";
-        case WIFI_AUTH_WEP:
-            return "[WEP][ESS]";
-        case WIFI_AUTH_WPA_PSK:
-            return "[WPA-PSK-CCMP][ESS]";
-        case WIFI_AUTH_WPA2_PSK:
-            return "[WPA2-PSK-CCMP][ESS]";
-        case WIFI_AUTH_WPA_WPA2_PSK:
-            return "[WPA-PSK-CCMP+TKIP][WPA2-PSK-CCMP+TKIP][ESS]";
-        case WIFI_AUTH_WPA3_PSK:
-            return "[WPA3-SAE][ESS]";
-        case WIFI_AUTH_WPA2_WPA3_PSK:
-            return "[WPA2-PSK-CCMP][WPA3-SAE][ESS]";
-        case WIFI_AUTH_WAPI_PSK:
-            return "[WAPI-PSK][ESS]";
-        default:
-            return "[ESS]";
+// Write out this scan's records - one open and one write. False if the
+// batch was dropped.
+bool WarhogMode::flushRows() {
+    if (logRows.len == 0) return true;
+    
+    bool ok = ensureLogFileReady();
+    if (ok) {
+        File f = openFileWithRetry(currentFilename.c_str(), FILE_APPEND);
+        if (f) {
+            size_t written = f.write(logRows.data, logRows.len);
+            f.close();
+            ok = written == logRows.len;
+            if (ok) {
+                logSize += written;
+            } else {
+                Serial.printf("[WARHOG] Short write to %s (%u of %u)\n", currentFilename.c_str(),
+                              (unsigned)written, (unsigned)logRows.len);
+                WardriveLog::truncate(currentFilename.c_str(), logSize);
+            }
+        } else {
+            Serial.printf("[WARHOG] Failed to open %s, dropped %u bytes\n",
+                          currentFilename.c_str(), (unsigned)logRows.len);
+            ok = false;
+        }
     }
+    // A dropped batch may have held SSID definitions - start the dictionary
+    // over so later records redefine what they use
+    if (!ok) ssidDict.reset();
+    logRows.len = 0;
+    return ok;
 }
 
-// Append single network to WiGLE file
-void WarhogMode::appendWigleEntry(const uint8_t* bssid, const char* ssid,
-                                   int8_t rssi, uint8_t channel, wifi_auth_mode_t auth,
-                                   double lat, double lon, double alt, double accuracy) {
-    if (!ensureWigleFileReady()) return;
-    
-    File f = openFileWithRetry(currentWigleFilename.c_str(), FILE_APPEND);
-    if (!f) return;
-    
-    // MAC (BSSID with colons)
-    f.printf("%02X:%02X:%02X:%02X:%02X:%02X,",
-            bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
-    
-    // SSID (escaped)
-    writeCSVField(f, ssid);
-    f.print(",");
-    
-    // AuthMode (WiGLE capability string)
-    f.print(authModeToWigleString(auth));
-    f.print(",");
-    
-    // FirstSeen (timestamp) - use GPS time if available, else millis
-    GPSData gps = GPS::getData();
-    if (gps.date > 0 && gps.time > 0) {
-        // date format: DDMMYY, time format: HHMMSSCC
-        uint8_t day = gps.date / 10000;
-        uint8_t month = (gps.date / 100) % 100;
-        uint8_t year = gps.date % 100;
-        uint8_t hour = gps.time / 1000000;
-        uint8_t minute = (gps.time / 10000) % 100;
-        uint8_t second = (gps.time / 100) % 100;
-        f.printf("20%02d-%02d-%02d %02d:%02d:%02d,", year, month, day, hour, minute, second);
-    } else {
-        // Fallback - use boot time reference
-        f.printf("1970-01-01 00:00:%02d,", (millis() / 1000) % 60);
+static bool isPendingSeen(const uint8_t* bssid) {
+    for (size_t off = 0; off < pendingSeen.len; off += 6) {
+        if (memcmp(pendingSeen.data + off, bssid, 6) == 0) return true;
     }
-    
-    // Channel
-    f.printf("%d,", channel);
-    
-    // Frequency (calculate from channel for 2.4GHz)
-    int freq = 2412 + (channel - 1) * 5;
-    if (channel == 14) freq = 2484;  // Special case for channel 14
-    f.printf("%d,", freq);
-    
-    // RSSI
-    f.printf("%d,", rssi);
-    
-    // Latitude, Longitude, Altitude
-    f.printf("%.6f,%.6f,%.1f,", lat, lon, alt);
-    
-    // AccuracyMeters (GPS HDOP as accuracy estimate, or default 10m)
-    f.printf("%.1f,", accuracy > 0 ? accuracy : 10.0);
-    
-    // RCOIs (empty), MfgrId (empty), Type (WIFI)
-    f.println(",,WIFI");
-    
-    f.close();
+    return false;
 }
 
 void WarhogMode::processScanResults() {
@@ -750,8 +731,19 @@ void WarhogMode::processScanResults() {
     
     SDLOG("WARHOG", "Processing %d networks (GPS: %s)", n, hasGPS ? "yes" : "no");
     
-    // Guard beacon map access from promiscuous callback
-    beaconMapBusy = true;
+    if (Config::isSDAvailable()) {
+        checkLogRotation();
+    }
+    
+    // Forget BSSIDs we haven't heard for a while
+    if (enhancedMode) {
+        taskENTER_CRITICAL(&featureMux);
+        size_t expired = beaconFeatures.expire(millis(), FEATURE_MAX_AGE_MS);
+        taskEXIT_CRITICAL(&featureMux);
+        if (expired > 0) {
+            Serial.printf("[WARHOG] Aged out %u beacon entries\n", (unsigned)expired);
+        }
+    }
     
     uint32_t newThisScan = 0;
     uint32_t geotaggedThisScan = 0;
@@ -762,14 +754,16 @@ void WarhogMode::processScanResults() {
         
         uint64_t bssidKey = bssidToKey(bssidPtr);
         
-        // Skip if already processed this session
-        if (seenBSSIDs.count(bssidKey) > 0) {
+        // Skip if already logged with coordinates (this session or an
+        // earlier one). Without a fix to log it now, also skip it once
+        // it has been counted this session.
+        if (BssidStore::contains(bssidPtr) || isPendingSeen(bssidPtr)) {
             continue;
         }
-        
-        // Add to seen set immediately (before any file writes)
-        if (seenBSSIDs.size() < MAX_SEEN_BSSIDS) {
-            seenBSSIDs.insert(bssidKey);
+        bool firstSighting = sessionSeen.insert(bssidPtr);
+        bool logsGeotagged = hasGPS && Config::isSDAvailable();
+        if (!firstSighting && !logsGeotagged) {
+            continue;
         }
         
         // Extract network info
@@ -781,70 +775,67 @@ void WarhogMode::processScanResults() {
         
         // Extract ML features
         WiFiFeatures features;
+        bool haveBeacon = false;
         if (enhancedMode) {
-            auto it = beaconFeatures.find(bssidKey);
-            if (it != beaconFeatures.end()) {
-                features = it->second;
-                features.rssi = rssi;
-                features.snr = (float)(rssi - features.noise);
-            } else {
-                features = FeatureExtractor::extractBasic(rssi, channel, authmode);
+            taskENTER_CRITICAL(&featureMux);
+            WiFiFeatures* cached = beaconFeatures.find(bssidKey);
+            if (cached) {
+                features = *cached;
+                haveBeacon = true;
             }
+            taskEXIT_CRITICAL(&featureMux);
+        }
+        if (haveBeacon) {
+            features.rssi = rssi;
+            features.snr = (float)(rssi - features.noise);
         } else {
             features = FeatureExtractor::extractBasic(rssi, channel, authmode);
         }
         
-        // Update statistics
-        totalNetworks++;
-        newThisScan++;
-        
-        // Track auth types
-        switch (authmode) {
-            case WIFI_AUTH_OPEN:
-                openNetworks++;
-                XP::addXP(XPEvent::NETWORK_OPEN);
-                break;
-            case WIFI_AUTH_WEP:
-                wepNetworks++;
-                XP::addXP(XPEvent::NETWORK_WEP);
-                break;
-            case WIFI_AUTH_WPA3_PSK:
-            case WIFI_AUTH_WPA2_WPA3_PSK:
-                wpaNetworks++;
-                XP::addXP(XPEvent::NETWORK_WPA3);
-                break;
-            default:
-                wpaNetworks++;
-                XP::addXP(XPEvent::NETWORK_FOUND);
-                break;
+        // Update statistics (once per session, even if the geotagged
+        // row only comes on a later scan)
+        if (firstSighting) {
+            totalNetworks++;
+            newThisScan++;
+            
+            // Track auth types
+            switch (authmode) {
+                case WIFI_AUTH_OPEN:
+                    openNetworks++;
+                    XP::addXP(XPEvent::NETWORK_OPEN);
+                    break;
+                case WIFI_AUTH_WEP:
+                    wepNetworks++;
+                    XP::addXP(XPEvent::NETWORK_WEP);
+                    break;
+                case WIFI_AUTH_WPA3_PSK:
+                case WIFI_AUTH_WPA2_WPA3_PSK:
+                    wpaNetworks++;
+                    XP::addXP(XPEvent::NETWORK_WPA3);
+                    break;
+                default:
+                    wpaNetworks++;
+                    XP::addXP(XPEvent::NETWORK_FOUND);
+                    break;
+            }
         }
         
-        // Write to files based on GPS status
+        // Log based on GPS status: geotagged rows feed CSV + WiGLE, the
+        // features record feeds ML (Enhanced mode only). A queued
+        // geotagged row waits in pendingSeen until the flush lands.
         if (Config::isSDAvailable()) {
             if (hasGPS) {
-                // Full wardriving: both CSV, WiGLE, and ML
-                appendCSVEntry(bssidPtr, ssid, rssi, channel, authmode,
-                              gpsData.latitude, gpsData.longitude, gpsData.altitude);
-                
-                // WiGLE format export (HDOP * 5 as rough accuracy estimate in meters)
-                double accuracy = gpsData.hdop > 0 ? gpsData.hdop * 5.0 : 10.0;
-                appendWigleEntry(bssidPtr, ssid, rssi, channel, authmode,
-                                gpsData.latitude, gpsData.longitude, gpsData.altitude, accuracy);
-                
-                savedCount++;
-                geotaggedThisScan++;
-                XP::addXP(XPEvent::WARHOG_LOGGED);  // +2 XP for geotagged network
-                
-                if (enhancedMode) {
-                    appendMLEntry(bssidPtr, ssid, features, 0,
-                                 gpsData.latitude, gpsData.longitude);
-                }
-            } else {
-                // No GPS: ML only (if Enhanced mode)
-                if (enhancedMode) {
-                    appendMLEntry(bssidPtr, ssid, features, 0, 0, 0);
-                    mlOnlyCount++;
+                // Room to track it first, so a queued row is never untracked
+                if (pendingSeen.reserve(6) &&
+                    appendObservation(bssidPtr, ssid, rssi, channel, authmode,
+                                      &gpsData, enhancedMode ? &features : nullptr)) {
+                    pendingSeen.append(bssidPtr, 6);
                 }
+            } else if (enhancedMode) {
+                // No GPS: ML only
+                appendObservation(bssidPtr, ssid, rssi, channel, authmode,
+                                  nullptr, &features);
+                mlOnlyCount++;
             }
         }
         
@@ -853,8 +844,23 @@ void WarhogMode::processScanResults() {
                      hasGPS ? " [GPS]" : "");
     }
     
-    // Release beacon map guard
-    beaconMapBusy = false;
+    // One write for the whole scan. Only rows that reached the log mark
+    // their BSSIDs done; after a dropped batch the next scan logs them again.
+    if (Config::isSDAvailable() && flushRows()) {
+        for (size_t off = 0; off < pendingSeen.len; off += 6) {
+            BssidStore::insert(pendingSeen.data + off);
+            savedCount++;
+            geotaggedThisScan++;
+            XP::addXP(XPEvent::WARHOG_LOGGED);  // +2 XP for geotagged network
+        }
+    } else if (pendingSeen.len > 0) {
+        Serial.printf("[WARHOG] %u geotagged rows dropped, will log again\n",
+                      (unsigned)(pendingSeen.len / 6));
+    }
+    pendingSeen.len = 0;
+    
+    // Journal this scan's new BSSIDs so a crash doesn't re-log them
+    BssidStore::checkpoint();
     
     // Trigger mood update if we found new networks
     if (newThisScan > 0) {
@@ -878,14 +884,12 @@ GPSData WarhogMode::getGPSData() {
     return GPS::getData();
 }
 
-// Export functions - data is already on disk, these are for format conversion
-// They now read from the session CSV and convert format
+// Export functions - render the session log as text on demand
 
 bool WarhogMode::exportCSV(const char* path) {
-    // Data is already in currentFilename as CSV
-    // This function would copy/rename, but for now just log
-    Serial.printf("[WARHOG] CSV data already in: %s\n", currentFilename.c_str());
-    return currentFilename.length() > 0;
+    if (currentFilename.length() == 0) return false;
+    flushRows();
+    return WardriveLog::exportCSV(currentFilename.c_str(), path);
 }
 
 // Helper to escape XML special characters
@@ -905,23 +909,13 @@ static String escapeXML(const char* str) {
 }
 
 bool WarhogMode::exportMLTraining(const char* path) {
-    // ML data is already on disk in currentMLFilename
-    Serial.printf("[WARHOG] ML data already in: %s\n", currentMLFilename.c_str());
-    return currentMLFilename.length() > 0;
+    if (currentFilename.length() == 0) return false;
+    flushRows();
+    return WardriveLog::exportML(currentFilename.c_str(), path);
 }
 
 String WarhogMode::authModeToString(wifi_auth_mode_t mode) {
-    switch (mode) {
-        case WIFI_AUTH_OPEN: return "OPEN";
-        case WIFI_AUTH_WEP: return "WEP";
-        case WIFI_AUTH_WPA_PSK: return "WPA";
-        case WIFI_AUTH_WPA2_PSK: return "WPA2";
-        case WIFI_AUTH_WPA_WPA2_PSK: return "WPA/WPA2";
-        case WIFI_AUTH_WPA3_PSK: return "WPA3";
-        case WIFI_AUTH_WPA2_WPA3_PSK: return "WPA2/WPA3";
-        case WIFI_AUTH_WAPI_PSK: return "WAPI";
-        default: return "UNKNOWN";
-    }
+    return wdlAuthName((uint8_t)mode);
 }
 
 String WarhogMode::generateFilename(const char* ext) {
@@ -951,8 +945,9 @@ String WarhogMode::generateFilename(const char* ext) {
 // Enhanced ML Mode - Promiscuous beacon capture
 
 void WarhogMode::promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t type) {
+    PERF_SCOPE(PerfSection::WARHOG_CALLBACK);
+    
     if (type != WIFI_PKT_MGMT) return;
-    if (beaconMapBusy) return;
     
     wifi_promiscuous_pkt_t* pkt = (wifi_promiscuous_pkt_t*)buf;
     const uint8_t* frame = pkt->payload;
@@ -971,24 +966,37 @@ void WarhogMode::promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t type
     const uint8_t* bssid = frame + 16;
     uint64_t key = bssidToKey(bssid);
     
+    uint32_t now = millis();
+    
+    // Parse outside the lock; the table update itself never allocates
+    // and, when full, evicts the stalest entry instead of dropping frames
     WiFiFeatures features = FeatureExtractor::extractFromBeacon(frame, len, rssi);
     
-    if (beaconFeatures.size() < 500) {
-        auto it = beaconFeatures.find(key);
-        if (it != beaconFeatures.end()) {
-            it->second.beaconCount++;
+    taskENTER_CRITICAL(&featureMux);
+    bool isNew;
+    WiFiFeatures* entry = beaconFeatures.touch(key, now, isNew);
+    if (entry) {
+        if (isNew) {
+            *entry = features;
+            entry->beaconCount = 1;
         } else {
-            features.beaconCount = 1;
-            beaconFeatures[key] = features;
+            entry->beaconCount++;
         }
-        beaconCount++;
     }
+    taskEXIT_CRITICAL(&featureMux);
+    beaconCount++;
 }
 
 void WarhogMode::startEnhancedCapture() {
     Serial.println("[WARHOG] Starting Enhanced ML capture (promiscuous mode)");
     
+    // Allocated once here; the callback only ever updates it in place
+    taskENTER_CRITICAL(&featureMux);
     beaconFeatures.clear();
+    taskEXIT_CRITICAL(&featureMux);
+    if (beaconFeatures.memoryBytes() == 0 && !beaconFeatures.init(FEATURE_SLOTS)) {
+        Serial.println("[WARHOG] No memory for beacon features, using scan data only");
+    }
     beaconCount = 0;
     
     wifi_promiscuous_filter_t filter = {
@@ -1008,6 +1016,8 @@ void WarhogMode::stopEnhancedCapture() {
     esp_wifi_set_promiscuous(false);
     esp_wifi_set_promiscuous_rx_cb(nullptr);
     
-    Serial.printf("[WARHOG] Captured %d beacons from %d BSSIDs\n", 
-                  beaconCount, beaconFeatures.size());
+    Serial.printf("[WARHOG] Captured %lu beacons, %u BSSIDs cached, %lu evicted\n",
+                  (unsigned long)beaconCount, (unsigned)beaconFeatures.size(),
+                  (unsigned long)beaconFeatures.evictions());
+    beaconFeatures.release();
 }
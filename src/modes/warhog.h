@@ -3,13 +3,12 @@
 #pragma once
 
 #include <Arduino.h>
-#include <map>
-#include <set>
 #include <esp_wifi.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include "../gps/gps.h"
 #include "../ml/features.h"
+#include "../core/bssid_lru.h"
 
 // BSSID key for map lookup (6 bytes as uint64_t)
 inline uint64_t bssidToKey(const uint8_t* bssid) {
@@ -30,7 +29,7 @@ public:
     static void triggerScan();
     static bool isScanComplete();
     
-    // Export (data already on disk, these are for format info)
+    // Export the session log as internal CSV / ML training CSV
     static bool exportCSV(const char* path);
     static bool exportMLTraining(const char* path);
     
@@ -45,6 +44,7 @@ public:
     static uint32_t getWPANetworks() { return wpaNetworks; }
     static uint32_t getSavedCount() { return savedCount; }  // Geotagged networks (CSV)
     static uint32_t getMLOnlyCount() { return mlOnlyCount; } // ML-only networks (no GPS)
+    static uint32_t getBeaconCount() { return beaconCount; }  // Enhanced-mode beacons captured
     
 private:
     static bool running;
@@ -53,8 +53,6 @@ private:
     static bool scanInProgress;
     static uint32_t scanStartTime;
     
-    static std::set<uint64_t> seenBSSIDs;  // Duplicate tracking for session
-    
     // Statistics
     static uint32_t totalNetworks;   // All unique networks seen
     static uint32_t openNetworks;
@@ -62,15 +60,12 @@ private:
     static uint32_t wpaNetworks;
     static uint32_t savedCount;      // Networks saved with GPS to CSV
     static uint32_t mlOnlyCount;     // Networks saved to ML file without GPS
-    static String currentFilename;   // Current session CSV file
-    static String currentMLFilename; // Current session ML training file
-    static String currentWigleFilename; // Current session WiGLE CSV file
+    static String currentFilename;   // Current session log (.wdl)
     
     // Enhanced ML mode - beacon capture
     static bool enhancedMode;
-    static std::map<uint64_t, WiFiFeatures> beaconFeatures;
+    static BssidLru<WiFiFeatures> beaconFeatures;  // Shared with the callback: featureMux
     static uint32_t beaconCount;
-    static volatile bool beaconMapBusy;
     
     // Background scan task
     static TaskHandle_t scanTaskHandle;
@@ -80,23 +75,17 @@ private:
     static void scanTask(void* pvParameters);
     static void processScanResults();
     
-    // File helpers - write directly per-network
-    static bool ensureCSVFileReady();
-    static bool ensureMLFileReady();
-    static bool ensureWigleFileReady();
-    static void checkWigleFileRotation();
-    static void appendCSVEntry(const uint8_t* bssid, const char* ssid,
-                               int8_t rssi, uint8_t channel, wifi_auth_mode_t auth,
-                               double lat, double lon, double alt);
-    static void appendMLEntry(const uint8_t* bssid, const char* ssid,
-                              const WiFiFeatures& features, uint8_t label,
-                              double lat, double lon);
-    static void appendWigleEntry(const uint8_t* bssid, const char* ssid,
-                                 int8_t rssi, uint8_t channel, wifi_auth_mode_t auth,
-                                 double lat, double lon, double alt, double accuracy);
+    // File helpers - appendObservation() queues records, flushRows() writes once per scan
+    static bool ensureLogFileReady();
+    static void checkLogRotation();
+    static bool flushRows();
+    static void writeSessionMarker();
+    static void recoverSessionFiles();
+    static bool appendObservation(const uint8_t* bssid, const char* ssid,
+                                  int8_t rssi, uint8_t channel, wifi_auth_mode_t auth,
+                                  const GPSData* gps, const WiFiFeatures* features);
     
     static String authModeToString(wifi_auth_mode_t mode);
-    static String authModeToWigleString(wifi_auth_mode_t mode);
     static String generateFilename(const char* ext);
     
     // Enhanced mode promiscuous callback
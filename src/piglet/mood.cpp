@@ -4,6 +4,7 @@
 #include "../core/config.h"
 #include "../core/xp.h"
 #include "../core/porkchop.h"
+#include "../core/perf_trace.h"
 #include "../ui/display.h"
 #include "../modes/oink.h"
 #include <Preferences.h>
@@ -739,6 +740,8 @@ void Mood::saveMood() {
 }
 
 void Mood::update() {
+    PERF_SCOPE(PerfSection::MOOD_UPDATE);
+    
     uint32_t now = millis();
     
     // Phase 6: Process phrase queue first
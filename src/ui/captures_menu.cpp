@@ -10,8 +10,9 @@
 
 // Static member initialization
 std::vector<CaptureInfo> CapturesMenu::captures;
-uint8_t CapturesMenu::selectedIndex = 0;
-uint8_t CapturesMenu::scrollOffset = 0;
+uint16_t CapturesMenu::shownCount = 0;
+uint16_t CapturesMenu::selectedIndex = 0;
+uint16_t CapturesMenu::scrollOffset = 0;
 bool CapturesMenu::active = false;
 bool CapturesMenu::keyWasPressed = false;
 bool CapturesMenu::nukeConfirmActive = false;
@@ -19,9 +20,17 @@ bool CapturesMenu::detailViewActive = false;
 bool CapturesMenu::connectingWiFi = false;
 bool CapturesMenu::uploadingFile = false;
 bool CapturesMenu::refreshingResults = false;
+CaptureSort CapturesMenu::sortMode = CaptureSort::NEWEST;
+CaptureFilter CapturesMenu::filterMode = CaptureFilter::ALL;
+File CapturesMenu::reconcileDir;
+bool CapturesMenu::reconcileDirty = false;
+
+static const char* SORT_NAMES[] = {"N3W3ST F1RST", "SS1D A-Z", "CR4CK3D F1RST"};
+static const char* FILTER_NAMES[] = {"4LL L00T", "H4NDSH4K3S", "PMK1DS", "CR4CK3D"};
 
 void CapturesMenu::init() {
     captures.clear();
+    shownCount = 0;
     selectedIndex = 0;
     scrollOffset = 0;
 }
@@ -36,12 +45,45 @@ void CapturesMenu::show() {
 
 void CapturesMenu::hide() {
     active = false;
+    stopReconcile();
+    saveManifest();
     captures.clear();
     captures.shrink_to_fit();  // Release vector memory
+    shownCount = 0;
+}
+
+void CapturesMenu::fillInfo(CaptureInfo& info) {
+    const CaptureRecord& r = info.rec;
+    char hex[13];
+    char mac[18];
+    snprintf(hex, sizeof(hex), "%02X%02X%02X%02X%02X%02X",
+             r.bssid[0], r.bssid[1], r.bssid[2], r.bssid[3], r.bssid[4], r.bssid[5]);
+    snprintf(mac, sizeof(mac), "%02X:%02X:%02X:%02X:%02X:%02X",
+             r.bssid[0], r.bssid[1], r.bssid[2], r.bssid[3], r.bssid[4], r.bssid[5]);
+    
+    info.bssid = mac;
+    info.isPMKID = r.kind == (uint8_t)CaptureKind::PMKID;
+    // We prefer showing _hs.22000 because it's hashcat-ready
+    if (info.isPMKID) {
+        info.filename = String(hex) + ".22000";
+    } else if (r.files & CAPTURE_FILE_HS22000) {
+        info.filename = String(hex) + "_hs.22000";
+    } else {
+        info.filename = String(hex) + ".pcap";
+    }
+    info.ssid = r.ssid[0] ? String(r.ssid) : String("[UNKNOWN]");
+    info.fileSize = r.size;
+    info.captureTime = r.time;
+    info.status = r.status <= (uint8_t)CaptureStatus::CRACKED ? (CaptureStatus)r.status : CaptureStatus::LOCAL;
+    info.password = "";
 }
 
+// Opening the menu only replays the manifest; the directory walk that used
+// to happen here now runs a few entries per update() in stepReconcile().
 void CapturesMenu::scanCaptures() {
+    stopReconcile();
     captures.clear();
+    shownCount = 0;
     
     // Guard: Skip if no SD card available
     if (!Config::isSDAvailable()) {
@@ -49,101 +91,223 @@ void CapturesMenu::scanCaptures() {
         return;
     }
     
+    std::vector<CaptureRecord> records;
+    bool haveManifest = CaptureManifest::load(records);
+    captures.reserve(records.size());
+    for (const auto& r : records) {
+        CaptureInfo info;
+        info.rec = r;
+        fillInfo(info);
+        captures.push_back(info);
+    }
+    
+    // Update WPA-SEC status for all captures
+    updateWPASecStatus();
+    sortCaptures();
+    
+    // No manifest yet (first run, or nuked) - write one once the walk is done
+    if (!haveManifest) reconcileDirty = true;
+    startReconcile();
+    
+    Serial.printf("[CAPTURES] %d captures from manifest\n", captures.size());
+}
+
+void CapturesMenu::startReconcile() {
+    for (auto& cap : captures) {
+        cap.seenFiles = 0;
+        cap.seenSize = 0;
+    }
+    
     if (!SD.exists("/handshakes")) {
-        Serial.println("[CAPTURES] No handshakes directory");
+        finishReconcile();  // Nothing on the card - drop whatever the manifest says
         return;
     }
     
-    File dir = SD.open("/handshakes");
-    if (!dir || !dir.isDirectory()) {
+    reconcileDir = SD.open("/handshakes");
+    if (!reconcileDir || !reconcileDir.isDirectory()) {
         Serial.println("[CAPTURES] Failed to open handshakes directory");
-        return;
+        reconcileDir.close();
+    }
+}
+
+void CapturesMenu::stopReconcile() {
+    if (reconcileDir) {
+        reconcileDir.close();
     }
+}
+
+void CapturesMenu::stepReconcile() {
+    if (!reconcileDir) return;
     
-    File file = dir.openNextFile();
-    while (file) {
-        String name = file.name();
-        bool isPCAP = name.endsWith(".pcap");
-        bool isPMKID = name.endsWith(".22000") && !name.endsWith("_hs.22000");
-        bool isHS22000 = name.endsWith("_hs.22000");
+    for (uint8_t n = 0; n < RECONCILE_BATCH; n++) {
+        File file = reconcileDir.openNextFile();
+        if (!file) {
+            finishReconcile();
+            return;
+        }
+        
+        uint8_t mac[6];
+        CaptureKind kind;
+        uint8_t fileBit;
+        if (file.isDirectory() || !parseCaptureName(file.name(), mac, kind, fileBit)) {
+            file.close();
+            continue;
+        }
+        uint32_t size = file.size();
+        time_t mtime = file.getLastWrite();
+        char hex[13];
+        strncpy(hex, file.name(), 12);
+        hex[12] = '\0';
+        file.close();
         
-        // Skip PCAP if we have the corresponding _hs.22000 (avoid duplicates)
-        // We prefer showing _hs.22000 because it's hashcat-ready
-        if (isPCAP) {
-            String baseName = name.substring(0, name.indexOf('.'));
-            String hs22kPath = "/handshakes/" + baseName + "_hs.22000";
-            if (SD.exists(hs22kPath)) {
-                file = dir.openNextFile();
-                continue;  // Skip this PCAP, _hs.22000 will be shown instead
+        CaptureInfo* cap = nullptr;
+        for (auto& c : captures) {
+            if (c.rec.kind == (uint8_t)kind && memcmp(c.rec.bssid, mac, 6) == 0) {
+                cap = &c;
+                break;
             }
         }
         
-        if (isPCAP || isPMKID || isHS22000) {
+        if (!cap) {
+            // Not in the manifest (copied onto the card, or saved by an older build)
             CaptureInfo info;
-            info.filename = name;
-            info.fileSize = file.size();
-            info.captureTime = file.getLastWrite();
-            info.isPMKID = isPMKID;  // Only true for actual PMKID files
+            memset(&info.rec, 0, sizeof(info.rec));
+            memcpy(info.rec.bssid, mac, 6);
+            info.rec.kind = (uint8_t)kind;
+            info.rec.op = CAPTURE_OP_SET;
+            info.rec.time = mtime;
+            info.seenFiles = 0;
+            info.seenSize = 0;
             
-            // Extract BSSID from filename (e.g., "64EEB7208286.pcap" or "64EEB7208286_hs.22000")
-            String baseName = name.substring(0, name.indexOf('.'));
-            // Handle _hs suffix for handshake 22000 files
-            if (baseName.endsWith("_hs")) {
-                baseName = baseName.substring(0, baseName.length() - 3);
+            // SSID from companion .txt file - PMKID uses _pmkid.txt suffix, handshake uses .txt
+            char txtPath[48];
+            snprintf(txtPath, sizeof(txtPath), "/handshakes/%s%s",
+                     hex, kind == CaptureKind::PMKID ? "_pmkid.txt" : ".txt");
+            File txtFile = SD.open(txtPath, FILE_READ);
+            if (txtFile) {
+                String ssid = txtFile.readStringUntil('\n');
+                ssid.trim();
+                strncpy(info.rec.ssid, ssid.c_str(), sizeof(info.rec.ssid) - 1);
+                txtFile.close();
             }
-            if (baseName.length() >= 12) {
-                info.bssid = baseName.substring(0, 2) + ":" +
-                             baseName.substring(2, 4) + ":" +
-                             baseName.substring(4, 6) + ":" +
-                             baseName.substring(6, 8) + ":" +
-                             baseName.substring(8, 10) + ":" +
-                             baseName.substring(10, 12);
-            } else {
-                info.bssid = baseName;
-            }
-            
-            // Try to get SSID from companion .txt file if exists
-            // PMKID uses _pmkid.txt suffix, handshake uses .txt
-            String txtPath = isPMKID ? 
-                "/handshakes/" + baseName + "_pmkid.txt" :
-                "/handshakes/" + baseName + ".txt";
-            if (SD.exists(txtPath)) {
-                File txtFile = SD.open(txtPath, FILE_READ);
-                if (txtFile) {
-                    info.ssid = txtFile.readStringUntil('\n');
-                    info.ssid.trim();
-                    txtFile.close();
-                }
-            }
-            if (info.ssid.isEmpty()) {
-                info.ssid = "[UNKNOWN]";
-            }
-            
-            // Check WPA-SEC status
-            info.status = CaptureStatus::LOCAL;
-            info.password = "";
             
-            captures.push_back(info);
+            fillInfo(info);
+            captures.push_back(info);  // Past shownCount until the walk finishes
+            cap = &captures.back();
+            reconcileDirty = true;
         }
-        file = dir.openNextFile();
+        
+        // Listed size is the _hs.22000 one when both handshake files exist
+        if (fileBit != CAPTURE_FILE_PCAP || !(cap->seenFiles & CAPTURE_FILE_HS22000)) {
+            cap->seenSize = size;
+        }
+        cap->seenFiles |= fileBit;
+    }
+}
+
+void CapturesMenu::finishReconcile() {
+    stopReconcile();
+    
+    for (size_t i = 0; i < captures.size();) {
+        CaptureInfo& cap = captures[i];
+        if (cap.seenFiles == 0) {
+            // Deleted (file manager, PC) since the manifest was written
+            captures.erase(captures.begin() + i);
+            reconcileDirty = true;
+            continue;
+        }
+        if (cap.seenFiles != cap.rec.files || cap.seenSize != cap.rec.size) {
+            cap.rec.files = cap.seenFiles;
+            cap.rec.size = cap.seenSize;
+            fillInfo(cap);
+            reconcileDirty = true;
+        }
+        i++;
     }
-    dir.close();
     
-    // Update WPA-SEC status for all captures
+    if (!reconcileDirty) return;
+    
     updateWPASecStatus();
+    saveManifest();
+    sortCaptures();
+    Serial.printf("[CAPTURES] Reconciled with /handshakes: %d captures\n", captures.size());
+}
+
+// Compact the manifest to the current list. Deferred while the walk runs.
+void CapturesMenu::saveManifest() {
+    if (!reconcileDirty || reconcileDir) return;
+    
+    std::vector<CaptureRecord> live;
+    live.reserve(captures.size());
+    for (const auto& cap : captures) {
+        live.push_back(cap.rec);
+    }
+    if (CaptureManifest::rewrite(live)) {
+        reconcileDirty = false;
+    }
+}
+
+void CapturesMenu::persist(CaptureInfo& cap) {
+    cap.rec.status = (uint8_t)cap.status;
+    cap.rec.op = CAPTURE_OP_SET;
+    CaptureManifest::append(cap.rec);
+}
+
+bool CapturesMenu::matchesFilter(const CaptureInfo& cap) {
+    switch (filterMode) {
+        case CaptureFilter::HANDSHAKE: return !cap.isPMKID;
+        case CaptureFilter::PMKID:     return cap.isPMKID;
+        case CaptureFilter::CRACKED:   return cap.status == CaptureStatus::CRACKED;
+        default:                       return true;
+    }
+}
+
+// Filter matches sort first and only those are shown, so the rest of the
+// menu can keep indexing captures[] directly.
+void CapturesMenu::sortCaptures() {
+    // Keep the selected capture selected across re-sorts
+    bool hadSelection = selectedIndex < shownCount;
+    CaptureRecord selected;
+    if (hadSelection) selected = captures[selectedIndex].rec;
     
-    // Sort by capture time (newest first)
     std::sort(captures.begin(), captures.end(), [](const CaptureInfo& a, const CaptureInfo& b) {
-        return a.captureTime > b.captureTime;
+        bool ma = matchesFilter(a);
+        bool mb = matchesFilter(b);
+        if (ma != mb) return ma;
+        if (sortMode == CaptureSort::SSID) {
+            int c = strcasecmp(a.rec.ssid, b.rec.ssid);
+            if (c != 0) return c < 0;
+        } else if (sortMode == CaptureSort::STATUS && a.status != b.status) {
+            return a.status > b.status;
+        }
+        return a.captureTime > b.captureTime;  // Newest first
     });
     
-    Serial.printf("[CAPTURES] Found %d captures\n", captures.size());
+    shownCount = 0;
+    while (shownCount < captures.size() && matchesFilter(captures[shownCount])) {
+        shownCount++;
+    }
+    
+    selectedIndex = 0;
+    scrollOffset = 0;
+    if (hadSelection) {
+        for (uint16_t i = 0; i < shownCount; i++) {
+            if (captureSameKey(captures[i].rec, selected)) {
+                selectedIndex = i;
+                break;
+            }
+        }
+        if (selectedIndex >= VISIBLE_ITEMS) {
+            scrollOffset = selectedIndex - VISIBLE_ITEMS + 1;
+        }
+    }
 }
 
-void CapturesMenu::updateWPASecStatus() {
+bool CapturesMenu::updateWPASecStatus() {
     // Load WPA-SEC cache (lazy, only loads once)
     WPASec::loadCache();
     
+    bool changed = false;
     for (auto& cap : captures) {
         // Normalize BSSID for lookup (remove colons)
         String normalBssid = cap.bssid;
@@ -157,12 +321,24 @@ void CapturesMenu::updateWPASecStatus() {
         } else {
             cap.status = CaptureStatus::LOCAL;
         }
+        
+        if (cap.rec.status != (uint8_t)cap.status) {
+            cap.rec.status = (uint8_t)cap.status;
+            changed = true;
+        }
     }
+    if (changed) reconcileDirty = true;  // Saved with the next compaction
+    return changed;
 }
 
 void CapturesMenu::update() {
     if (!active) return;
     handleInput();
+    
+    // Keep walking the directory while the user browses
+    if (active && !nukeConfirmActive) {
+        stepReconcile();
+    }
 }
 
 void CapturesMenu::handleInput() {
@@ -202,7 +378,7 @@ void CapturesMenu::handleInput() {
         // Allow U/R in modal - close modal and trigger action
         if (M5Cardputer.Keyboard.isKeyPressed('u') || M5Cardputer.Keyboard.isKeyPressed('U')) {
             detailViewActive = false;
-            if (!captures.empty() && selectedIndex < captures.size()) {
+            if (selectedIndex < shownCount) {
                 uploadSelected();
             }
             return;
@@ -226,7 +402,7 @@ void CapturesMenu::handleInput() {
     }
     
     if (M5Cardputer.Keyboard.isKeyPressed('.')) {
-        if (!captures.empty() && selectedIndex < captures.size() - 1) {
+        if (selectedIndex + 1 < shownCount) {
             selectedIndex++;
             if (selectedIndex >= scrollOffset + VISIBLE_ITEMS) {
                 scrollOffset = selectedIndex - VISIBLE_ITEMS + 1;
@@ -234,9 +410,24 @@ void CapturesMenu::handleInput() {
         }
     }
     
+    // S cycles sort order, F cycles filter - no SD access, just a re-sort
+    if (M5Cardputer.Keyboard.isKeyPressed('s') || M5Cardputer.Keyboard.isKeyPressed('S')) {
+        sortMode = (CaptureSort)(((uint8_t)sortMode + 1) % 3);
+        sortCaptures();
+        Display::showToast(SORT_NAMES[(uint8_t)sortMode]);
+        delay(300);
+    }
+    
+    if (M5Cardputer.Keyboard.isKeyPressed('f') || M5Cardputer.Keyboard.isKeyPressed('F')) {
+        filterMode = (CaptureFilter)(((uint8_t)filterMode + 1) % 4);
+        sortCaptures();
+        Display::showToast(FILTER_NAMES[(uint8_t)filterMode]);
+        delay(300);
+    }
+    
     // Enter shows detail view (password if cracked)
     if (keys.enter) {
-        if (!captures.empty() && selectedIndex < captures.size()) {
+        if (selectedIndex < shownCount) {
             detailViewActive = true;
         }
     }
@@ -251,7 +442,7 @@ void CapturesMenu::handleInput() {
     
     // U key uploads selected capture to WPA-SEC
     if (M5Cardputer.Keyboard.isKeyPressed('u') || M5Cardputer.Keyboard.isKeyPressed('U')) {
-        if (!captures.empty() && selectedIndex < captures.size()) {
+        if (selectedIndex < shownCount) {
             uploadSelected();
         }
     }
@@ -286,11 +477,19 @@ void CapturesMenu::draw(M5Canvas& canvas) {
     canvas.setTextColor(COLOR_FG);
     canvas.setTextSize(1);
     
-    if (captures.empty()) {
+    if (shownCount == 0) {
         canvas.setCursor(4, 40);
-        canvas.print("No captures found");
-        canvas.setCursor(4, 55);
-        canvas.print("[O] to hunt.");
+        if (!captures.empty()) {
+            canvas.print("Nothing matches filter");
+            canvas.setCursor(4, 55);
+            canvas.print("[F] for more.");
+        } else if (reconcileDir) {
+            canvas.print("Sniffing the loot...");
+        } else {
+            canvas.print("No captures found");
+            canvas.setCursor(4, 55);
+            canvas.print("[O] to hunt.");
+        }
         return;
     }
     
@@ -298,7 +497,7 @@ void CapturesMenu::draw(M5Canvas& canvas) {
     int y = 2;
     int lineHeight = 18;
     
-    for (uint8_t i = scrollOffset; i < captures.size() && i < scrollOffset + VISIBLE_ITEMS; i++) {
+    for (uint16_t i = scrollOffset; i < shownCount && i < scrollOffset + VISIBLE_ITEMS; i++) {
         const CaptureInfo& cap = captures[i];
         
         // Highlight selected
@@ -346,7 +545,7 @@ void CapturesMenu::draw(M5Canvas& canvas) {
         canvas.setTextColor(COLOR_FG);
         canvas.print("^");
     }
-    if (scrollOffset + VISIBLE_ITEMS < captures.size()) {
+    if (scrollOffset + VISIBLE_ITEMS < shownCount) {
         canvas.setCursor(canvas.width() - 10, 16 + (VISIBLE_ITEMS - 1) * lineHeight);
         canvas.setTextColor(COLOR_FG);
         canvas.print("v");
@@ -396,6 +595,8 @@ void CapturesMenu::drawNukeConfirm(M5Canvas& canvas) {
 
 void CapturesMenu::nukeLoot() {
     Serial.println("[CAPTURES] Nuking all loot...");
+    stopReconcile();
+    CaptureManifest::remove();
     
     if (!SD.exists("/handshakes")) {
         return;
@@ -429,10 +630,11 @@ void CapturesMenu::nukeLoot() {
     selectedIndex = 0;
     scrollOffset = 0;
     captures.clear();
+    shownCount = 0;
 }
 
 String CapturesMenu::getSelectedBSSID() {
-    if (selectedIndex < captures.size()) {
+    if (selectedIndex < shownCount) {
         const CaptureInfo& cap = captures[selectedIndex];
         // PMKIDs can't be uploaded to WPA-SEC (requires PCAP)
         if (cap.isPMKID) {
@@ -443,7 +645,7 @@ String CapturesMenu::getSelectedBSSID() {
     return "CR4CK TH3 L00T: [U] [R] [D]";
 }
 void CapturesMenu::drawDetailView(M5Canvas& canvas) {
-    if (selectedIndex >= captures.size()) return;
+    if (selectedIndex >= shownCount) return;
     
     const CaptureInfo& cap = captures[selectedIndex];
     
@@ -523,7 +725,7 @@ void CapturesMenu::drawConnecting(M5Canvas& canvas) {
 }
 
 void CapturesMenu::uploadSelected() {
-    if (selectedIndex >= captures.size()) return;
+    if (selectedIndex >= shownCount) return;
     
     const CaptureInfo& cap = captures[selectedIndex];
     
@@ -591,6 +793,7 @@ void CapturesMenu::uploadSelected() {
         delay(500);
         // Update status
         captures[selectedIndex].status = CaptureStatus::UPLOADED;
+        persist(captures[selectedIndex]);
     } else {
         Display::showToast(WPASec::getLastError());
         delay(500);
@@ -639,7 +842,10 @@ void CapturesMenu::refreshResults() {
         Display::showToast(WPASec::getStatus());
         delay(500);
         // Update status for all captures
-        updateWPASecStatus();
+        if (updateWPASecStatus()) {
+            saveManifest();
+            sortCaptures();
+        }
     } else {
         Display::showToast(WPASec::getLastError());
         delay(500);
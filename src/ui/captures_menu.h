@@ -3,7 +3,9 @@
 
 #include <Arduino.h>
 #include <M5Unified.h>
+#include <FS.h>
 #include <vector>
+#include "../core/capture_manifest.h"
 
 // WPA-SEC status for display
 enum class CaptureStatus {
@@ -12,12 +14,28 @@ enum class CaptureStatus {
     CRACKED     // Password found!
 };
 
+enum class CaptureSort : uint8_t {
+    NEWEST,
+    SSID,
+    STATUS
+};
+
+enum class CaptureFilter : uint8_t {
+    ALL,
+    HANDSHAKE,
+    PMKID,
+    CRACKED
+};
+
 struct CaptureInfo {
+    CaptureRecord rec;   // Manifest record this row came from
+    uint8_t seenFiles;   // Reconcile: files found this pass
+    uint32_t seenSize;
     String filename;
     String ssid;
     String bssid;
     uint32_t fileSize;
-    time_t captureTime;  // File modification time
+    time_t captureTime;  // Save time (file mtime if found by reconcile)
     bool isPMKID;        // true = .22000 PMKID, false = .pcap handshake
     CaptureStatus status; // WPA-SEC status
     String password;      // Cracked password (if status == CRACKED)
@@ -35,9 +53,10 @@ public:
     static size_t getCount() { return captures.size(); }
     
 private:
-    static std::vector<CaptureInfo> captures;
-    static uint8_t selectedIndex;
-    static uint8_t scrollOffset;
+    static std::vector<CaptureInfo> captures;  // Filter matches first, shownCount of them
+    static uint16_t shownCount;
+    static uint16_t selectedIndex;
+    static uint16_t scrollOffset;
     static bool active;
     static bool keyWasPressed;
     static bool nukeConfirmActive;  // Nuke confirmation modal
@@ -45,16 +64,32 @@ private:
     static bool connectingWiFi;     // WiFi connection in progress
     static bool uploadingFile;      // Upload in progress
     static bool refreshingResults;  // Fetching WPA-SEC results
+    static CaptureSort sortMode;
+    static CaptureFilter filterMode;
+    
+    // Background reconcile of the manifest against /handshakes
+    static File reconcileDir;
+    static bool reconcileDirty;
     
     static const uint8_t VISIBLE_ITEMS = 5;
+    static const uint8_t RECONCILE_BATCH = 8;  // Directory entries per update()
     
     static void scanCaptures();
+    static void startReconcile();
+    static void stepReconcile();
+    static void finishReconcile();
+    static void stopReconcile();
+    static void fillInfo(CaptureInfo& info);
+    static bool matchesFilter(const CaptureInfo& cap);
+    static void sortCaptures();
+    static void persist(CaptureInfo& cap);
+    static void saveManifest();
     static void handleInput();
     static void drawNukeConfirm(M5Canvas& canvas);
     static void drawDetailView(M5Canvas& canvas);
     static void drawConnecting(M5Canvas& canvas);
     static void nukeLoot();
-    static void updateWPASecStatus();
+    static bool updateWPASecStatus();
     static void uploadSelected();
     static void refreshResults();
     static String formatTime(time_t t);
@@ -6,6 +6,7 @@
 #include "../core/porkchop.h"
 #include "../core/config.h"
 #include "../core/xp.h"
+#include "../core/perf_trace.h"
 #include "../build_info.h"
 #include "../piglet/mood.h"
 #include "../piglet/avatar.h"
@@ -101,6 +102,8 @@ void Display::init() {
 }
 
 void Display::update() {
+    PERF_SCOPE(PerfSection::DISPLAY_UPDATE);
+    
     // Check for screen dimming
     updateDimming();
     
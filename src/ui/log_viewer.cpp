@@ -3,111 +3,262 @@
 #include "log_viewer.h"
 #include "display.h"
 #include "../core/config.h"
+#include "../core/sdlog.h"
+#include "../core/log_index.h"
 #include <M5Cardputer.h>
 #include <SD.h>
 
 // Static members
 bool LogViewer::active = false;
-std::vector<String> LogViewer::logLines;
-uint16_t LogViewer::scrollOffset = 0;
-uint16_t LogViewer::totalLines = 0;
+File LogViewer::logFile;
+char* LogViewer::scanBuf = nullptr;
+std::vector<String> LogViewer::pageLines;
+uint32_t LogViewer::scrollOffset = 0;
+uint32_t LogViewer::totalLines = 0;
 bool LogViewer::keyWasPressed = false;
+std::vector<String> LogViewer::tags;
+uint8_t LogViewer::filterIdx = 0;
+std::vector<uint32_t> LogViewer::matches;
+uint32_t LogViewer::scanFloor = 0;
 
-static const uint16_t MAX_LOG_LINES = 100;
-static const uint8_t VISIBLE_LINES = 9;  // Lines visible on screen (no header now)
+static const uint8_t VISIBLE_LINES = 9;     // Lines visible on screen (no header now)
+static const uint8_t LINE_CHARS = 39;       // Columns that fit on screen
+static const uint8_t SCAN_LINES = 32;       // Lines per index/log read
+static const size_t SCAN_BYTES = 4096;      // Read a block in one go up to this
+static const uint32_t SCAN_BUDGET = 1024;   // Lines scanned per filter keypress
+static const uint16_t MAX_MATCHES = 2000;   // Filtered rows kept (8 KB)
+static const uint8_t MAX_TAGS = 8;
+static const uint8_t TAG_SAMPLE_LINES = 64; // Tail lines sampled for filter tags
+
+// Visitor context - the viewer is single-instance, main loop only
+static uint32_t pageBase = 0;
+static char filterTag[16];
+
+static String displayText(const char* line, size_t len) {
+    char buf[LINE_CHARS + 1];
+    while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r' || line[len - 1] == ' ')) len--;
+    if (len > LINE_CHARS) {
+        // Truncate long lines to fit screen
+        memcpy(buf, line, LINE_CHARS - 1);
+        buf[LINE_CHARS - 1] = '~';
+        len = LINE_CHARS;
+    } else {
+        memcpy(buf, line, len);
+    }
+    buf[len] = '\0';
+    return String(buf);
+}
 
 void LogViewer::init() {
-    logLines.clear();
+    pageLines.clear();
     scrollOffset = 0;
     totalLines = 0;
 }
 
-String LogViewer::findLatestLogFile() {
-    if (!Config::isSDAvailable()) {
-        Serial.println("[LOGVIEW] SD not available");
-        return "";
-    }
-    
-    // Use fixed filename - always the same file
-    const char* logFile = "/logs/porkchop.log";
+void LogViewer::setMessage(const char* a, const char* b) {
+    pageLines.clear();
+    pageLines.push_back(a);
+    if (b) pageLines.push_back(b);
+    totalLines = 0;
+    scrollOffset = 0;
+}
+
+// Calls fn for lines [first, first+count), newest first. fn sees at least the
+// first SCAN_BYTES / SCAN_LINES bytes of each line - plenty for a tag or a row.
+bool LogViewer::visitLines(uint32_t first, uint32_t count, LineVisitor fn) {
+    uint32_t spans[SCAN_LINES + 1];
+    if (count > SCAN_LINES || !LogIndex::readSpans(first, count, spans)) return false;
     
-    if (SD.exists(logFile)) {
-        Serial.printf("[LOGVIEW] Found: %s\n", logFile);
-        return String(logFile);
+    bool whole = spans[count] - spans[0] <= SCAN_BYTES;
+    if (whole) {
+        size_t total = spans[count] - spans[0];
+        if (!logFile.seek(spans[0]) || logFile.read((uint8_t*)scanBuf, total) != total) return false;
     }
     
-    Serial.println("[LOGVIEW] Log file not found");
-    return "";
+    for (int32_t i = count - 1; i >= 0; i--) {
+        size_t len = spans[i + 1] - spans[i];
+        const char* p = scanBuf + (spans[i] - spans[0]);
+        if (!whole) {
+            if (len > SCAN_BYTES / SCAN_LINES) len = SCAN_BYTES / SCAN_LINES;
+            if (!logFile.seek(spans[i])) return false;
+            len = logFile.read((uint8_t*)scanBuf, len);
+            p = scanBuf;
+        }
+        fn(first + i, p, len);
+    }
+    return true;
 }
 
-void LogViewer::loadLogFile() {
-    logLines.clear();
+void LogViewer::openLog() {
+    tags.clear();
+    filterIdx = 0;
+    matches.clear();
+    scanFloor = 0;
+    
+    if (!Config::isSDAvailable() || !SD.exists(SDLOG_FILE)) {
+        Serial.println("[LOGVIEW] Log file not found");
+        setMessage("No log files found", "Enable SD Log in Settings");
+        return;
+    }
+    
+    // Cheap unless the log grew while logging was off (or the index is gone)
+    uint32_t start = millis();
+    if (!LogIndex::sync(SDLOG_FILE, SDLog::isEnabled())) {
+        setMessage("Failed to index log file", SDLOG_FILE);
+        return;
+    }
+    
+    logFile = SD.open(SDLOG_FILE, FILE_READ);
+    scanBuf = (char*)malloc(SCAN_BYTES);
+    if (!logFile || !scanBuf) {
+        setMessage("Failed to open log file", SDLOG_FILE);
+        return;
+    }
     
-    String filename = findLatestLogFile();
-    if (filename.length() == 0) {
-        logLines.push_back("No log files found");
-        logLines.push_back("Enable SD Log in Settings");
-        totalLines = logLines.size();
-        Serial.printf("[LOGVIEW] No log files, totalLines=%d\n", totalLines);
+    totalLines = LogIndex::getLineCount();
+    Serial.printf("[LOGVIEW] %lu lines indexed in %lums\n",
+                  (unsigned long)totalLines, (unsigned long)(millis() - start));
+    if (totalLines == 0) {
+        setMessage("Log file is empty", nullptr);
         return;
     }
     
-    Serial.printf("[LOGVIEW] Opening: %s\n", filename.c_str());
-    File f = SD.open(filename.c_str(), FILE_READ);
-    if (!f) {
-        logLines.push_back("Failed to open log file");
-        logLines.push_back(filename);
-        totalLines = logLines.size();
-        Serial.printf("[LOGVIEW] Failed to open, totalLines=%d\n", totalLines);
+    // Start scrolled to bottom (most recent)
+    scrollOffset = totalLines > VISIBLE_LINES ? totalLines - VISIBLE_LINES : 0;
+    collectTags();
+    loadPage();
+}
+
+void LogViewer::collectTags() {
+    uint32_t lines = LogIndex::getLineCount();
+    uint32_t from = lines > TAG_SAMPLE_LINES ? lines - TAG_SAMPLE_LINES : 0;
+    for (uint32_t first = from; first < lines; first += SCAN_LINES) {
+        uint32_t n = lines - first < SCAN_LINES ? lines - first : SCAN_LINES;
+        visitLines(first, n, [](uint32_t, const char* line, size_t len) {
+            char tag[sizeof(filterTag)];
+            if (tags.size() >= MAX_TAGS || !logLineTag(line, len, tag, sizeof(tag))) return;
+            for (const String& t : tags) {
+                if (t == tag) return;
+            }
+            tags.push_back(tag);
+        });
+    }
+}
+
+void LogViewer::applyFilter() {
+    matches.clear();
+    if (filterIdx == 0) {
+        matches.shrink_to_fit();
+        totalLines = LogIndex::getLineCount();
+        scrollOffset = totalLines > VISIBLE_LINES ? totalLines - VISIBLE_LINES : 0;
         return;
     }
     
-    Serial.printf("[LOGVIEW] File size: %d bytes\n", f.size());
+    strncpy(filterTag, tags[filterIdx - 1].c_str(), sizeof(filterTag) - 1);
+    filterTag[sizeof(filterTag) - 1] = '\0';
+    scanFloor = LogIndex::getLineCount();
+    totalLines = 0;
+    scanMore(VISIBLE_LINES);
+    scrollOffset = totalLines > VISIBLE_LINES ? totalLines - VISIBLE_LINES : 0;
+}
+
+// Scan further back for filter matches. Returns how many rows were added
+// above the current view; the caller shifts scrollOffset by that much.
+uint32_t LogViewer::scanMore(uint32_t wanted) {
+    uint32_t before = matches.size();
+    uint32_t scanned = 0;
     
-    // Read all lines into a circular buffer (keep last MAX_LOG_LINES)
-    std::vector<String> allLines;
-    while (f.available()) {
-        String line = f.readStringUntil('\n');
-        line.trim();
-        if (line.length() > 0) {
-            allLines.push_back(line);
-            // Keep only last MAX_LOG_LINES
-            if (allLines.size() > MAX_LOG_LINES) {
-                allLines.erase(allLines.begin());
+    while (scanFloor > 0 && matches.size() - before < wanted &&
+           scanned < SCAN_BUDGET && matches.size() < MAX_MATCHES) {
+        uint32_t first = scanFloor > SCAN_LINES ? scanFloor - SCAN_LINES : 0;
+        uint32_t n = scanFloor - first;
+        bool ok = visitLines(first, n, [](uint32_t lineNo, const char* line, size_t len) {
+            char tag[sizeof(filterTag)];
+            if (matches.size() >= MAX_MATCHES) return;
+            if (logLineTag(line, len, tag, sizeof(tag)) && strcmp(tag, filterTag) == 0) {
+                matches.push_back(lineNo);
             }
+        });
+        if (!ok) {
+            scanFloor = 0;  // Index unreadable - stop rather than spin
+            break;
         }
+        scanFloor = first;
+        scanned += n;
     }
-    f.close();
     
-    Serial.printf("[LOGVIEW] Read %d lines\n", allLines.size());
+    uint32_t added = matches.size() - before;
+    totalLines = matches.size();
+    return added;
+}
+
+void LogViewer::loadPage() {
+    pageLines.assign(VISIBLE_LINES, String());
+    uint32_t rows = totalLines - scrollOffset;
+    if (rows > VISIBLE_LINES) rows = VISIBLE_LINES;
     
-    logLines = allLines;
-    totalLines = logLines.size();
+    LineVisitor store = [](uint32_t lineNo, const char* line, size_t len) {
+        pageLines[lineNo - pageBase] = displayText(line, len);
+    };
     
-    // Start scrolled to bottom (most recent)
-    if (totalLines > VISIBLE_LINES) {
-        scrollOffset = totalLines - VISIBLE_LINES;
-    } else {
-        scrollOffset = 0;
+    if (filterIdx != 0 && totalLines == 0) {
+        pageLines[0] = scanFloor > 0 ? "Searching... (;/, for more)" : "No matching lines";
+        return;
+    }
+    
+    if (filterIdx == 0) {
+        // Contiguous - one index read and one log read for the whole page
+        pageBase = scrollOffset;
+        visitLines(scrollOffset, rows, store);
+        return;
     }
     
-    if (logLines.empty()) {
-        logLines.push_back("Log file is empty");
-        totalLines = 1;
+    for (uint32_t r = 0; r < rows; r++) {
+        uint32_t lineNo = matches[totalLines - 1 - (scrollOffset + r)];
+        pageBase = lineNo - r;
+        visitLines(lineNo, 1, store);
+    }
+}
+
+void LogViewer::scrollBy(int32_t delta) {
+    // Scrolling up past the oldest filtered match pulls in older ones
+    uint32_t added = 0;
+    if (delta < 0 && filterIdx != 0 && scanFloor > 0 && (uint32_t)(-delta) > scrollOffset) {
+        added = scanMore(-delta);
+        scrollOffset += added;
     }
+    if (totalLines == 0 && scanFloor == 0) return;
+    
+    int32_t maxOffset = totalLines > VISIBLE_LINES ? totalLines - VISIBLE_LINES : 0;
+    int32_t target = (int32_t)scrollOffset + delta;
+    if (target < 0) target = 0;
+    if (target > maxOffset) target = maxOffset;
+    if ((uint32_t)target == scrollOffset && added == 0 && filterIdx == 0) return;
+    
+    scrollOffset = target;
+    loadPage();
+    render();
 }
 
 void LogViewer::show() {
     active = true;
     keyWasPressed = true;  // Ignore the key that opened us
-    loadLogFile();
+    SDLog::flush();        // Show lines still sitting in the RAM buffer
+    openLog();
     render();
 }
 
 void LogViewer::hide() {
     active = false;
-    logLines.clear();
-    logLines.shrink_to_fit();  // Release vector memory
+    pageLines.clear();
+    pageLines.shrink_to_fit();  // Release vector memory
+    matches.clear();
+    matches.shrink_to_fit();
+    tags.clear();
+    if (logFile) logFile.close();
+    LogIndex::closeReader();
+    free(scanBuf);
+    scanBuf = nullptr;
 }
 
 void LogViewer::render() {
@@ -124,18 +275,8 @@ void LogViewer::render() {
     uint8_t y = 2;
     uint8_t lineHeight = 11;
     
-    Serial.printf("[LOGVIEW] Rendering %d lines from offset %d\n", totalLines, scrollOffset);
-    
-    for (uint8_t i = 0; i < VISIBLE_LINES && (scrollOffset + i) < totalLines; i++) {
-        String& line = logLines[scrollOffset + i];
-        
-        // Truncate long lines to fit screen
-        String displayLine = line;
-        if (displayLine.length() > 39) {
-            displayLine = displayLine.substring(0, 38) + "~";
-        }
-        
-        canvas.drawString(displayLine, 2, y);
+    for (uint8_t i = 0; i < VISIBLE_LINES && i < pageLines.size(); i++) {
+        canvas.drawString(pageLines[i], 2, y);
         y += lineHeight;
     }
     
@@ -143,8 +284,8 @@ void LogViewer::render() {
     if (totalLines > VISIBLE_LINES) {
         int barHeight = MAIN_H - 14;
         int barY = 12;
-        int thumbHeight = max(10, (int)(barHeight * VISIBLE_LINES / totalLines));
-        int thumbY = barY + (barHeight - thumbHeight) * scrollOffset / (totalLines - VISIBLE_LINES);
+        int thumbHeight = max(10, (int)((uint64_t)barHeight * VISIBLE_LINES / totalLines));
+        int thumbY = barY + (int)((uint64_t)(barHeight - thumbHeight) * scrollOffset / (totalLines - VISIBLE_LINES));
         
         canvas.fillRect(DISPLAY_W - 4, barY, 3, barHeight, 0x2104);  // Dark gray track
         canvas.fillRect(DISPLAY_W - 4, thumbY, 3, thumbHeight, COLOR_FG);  // Pink thumb
@@ -156,11 +297,16 @@ void LogViewer::render() {
     bottom.setTextSize(1);
     bottom.setTextColor(COLOR_FG);
     bottom.setTextDatum(TL_DATUM);
-    char info[24];
-    snprintf(info, sizeof(info), "L:%d", totalLines);
+    char info[32];
+    if (filterIdx == 0) {
+        snprintf(info, sizeof(info), "L:%lu", (unsigned long)totalLines);
+    } else {
+        snprintf(info, sizeof(info), "%s:%lu%s", filterTag, (unsigned long)totalLines,
+                 scanFloor > 0 ? "+" : "");
+    }
     bottom.drawString(info, 2, 3);
     bottom.setTextDatum(TR_DATUM);
-    bottom.drawString(";/. `/Ent", DISPLAY_W - 2, 3);
+    bottom.drawString(";/.,/ F `/Ent", DISPLAY_W - 2, 3);
     
     Display::pushAll();
 }
@@ -179,23 +325,23 @@ void LogViewer::update() {
     
     Keyboard_Class::KeysState keys = M5Cardputer.Keyboard.keysState();
     
-    bool needsRender = false;
-    
     for (auto key : keys.word) {
         keyWasPressed = true;
         
         if (key == ';') {
-            // Scroll up
-            if (scrollOffset > 0) {
-                scrollOffset--;
-                needsRender = true;
-            }
+            scrollBy(-1);
         } else if (key == '.') {
-            // Scroll down - only if we have more lines than visible
-            if (totalLines > VISIBLE_LINES && scrollOffset < totalLines - VISIBLE_LINES) {
-                scrollOffset++;
-                needsRender = true;
-            }
+            scrollBy(1);
+        } else if (key == ',') {
+            scrollBy(-(int32_t)VISIBLE_LINES);
+        } else if (key == '/') {
+            scrollBy(VISIBLE_LINES);
+        } else if ((key == 'f' || key == 'F') && !tags.empty()) {
+            // Cycle ALL -> tag 1 -> ... -> ALL
+            filterIdx = (filterIdx + 1) % (tags.size() + 1);
+            applyFilter();
+            loadPage();
+            render();
         } else if (key == '`' || key == 0x1B) {
             // Exit
             hide();
@@ -209,8 +355,4 @@ void LogViewer::update() {
         hide();
         return;
     }
-    
-    if (needsRender) {
-        render();
-    }
 }
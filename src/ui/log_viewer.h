@@ -1,7 +1,11 @@
 // Log Viewer Menu
+// Pages through the SD log via its line index (core/log_index.h): opening
+// costs the same for a 1 KB log as a 256 KB one, and only the visible page
+// is ever held in RAM.
 #pragma once
 
 #include <Arduino.h>
+#include <FS.h>
 #include <vector>
 
 class LogViewer {
@@ -14,12 +18,29 @@ public:
     
 private:
     static bool active;
-    static std::vector<String> logLines;
-    static uint16_t scrollOffset;
-    static uint16_t totalLines;
+    static File logFile;
+    static char* scanBuf;
+    static std::vector<String> pageLines;  // Only the lines on screen
+    static uint32_t scrollOffset;          // Top row within the current view
+    static uint32_t totalLines;            // Rows in the current view
     static bool keyWasPressed;
     
-    static void loadLogFile();
+    // Tag filter: tags[filterIdx - 1], or everything when filterIdx == 0.
+    // Matches are found lazily, scanning backwards from the tail.
+    static std::vector<String> tags;
+    static uint8_t filterIdx;
+    static std::vector<uint32_t> matches;  // Line numbers, newest first
+    static uint32_t scanFloor;             // Lines below this not scanned yet
+    
+    typedef void (*LineVisitor)(uint32_t lineNo, const char* line, size_t len);
+    
+    static void openLog();
+    static void setMessage(const char* a, const char* b);
+    static bool visitLines(uint32_t first, uint32_t count, LineVisitor fn);
+    static void collectTags();
+    static void applyFilter();
+    static uint32_t scanMore(uint32_t wanted);
+    static void loadPage();
+    static void scrollBy(int32_t delta);
     static void render();
-    static String findLatestLogFile();
 };
@@ -296,6 +296,15 @@ void SettingsMenu::loadFromConfig() {
         50, 200, 25, "ms", "",
         "Per-packet duration"
     });
+    
+    // Full-session PCAPNG capture in OINK
+    items.push_back({
+        "PCAPNG",
+        SettingType::TOGGLE,
+        Config::wifi().sessionCapture ? 1 : 0,
+        0, 1, 1, "", "",
+        "Log all frames to /pcap"
+    });
     // No Save & Exit button - ESC/backtick auto-saves
 }
 
@@ -318,6 +327,7 @@ void SettingsMenu::saveToConfig() {
     w.lockTime = items[13].value;
     w.enableDeauth = items[14].value == 1;
     w.randomizeMAC = items[15].value == 1;
+    w.sessionCapture = items[27].value == 1;  // PCAPNG toggle lives at the end of the list
     Config::setWiFi(w);
     
     // Sound, Brightness, Dimming, and Theme
@@ -4,6 +4,7 @@
 #include "display.h"
 #include "../core/xp.h"
 #include "../core/config.h"
+#include "../core/perf_trace.h"
 #include "../piglet/mood.h"
 #include <M5Cardputer.h>
 
@@ -127,11 +128,23 @@ void SwineStats::handleInput() {
     
     // Tab switching with , (left) and / (right)
     if (M5Cardputer.Keyboard.isKeyPressed(',')) {
-        currentTab = StatsTab::STATS;
+        if (currentTab != StatsTab::STATS) {
+            currentTab = (StatsTab)((uint8_t)currentTab - 1);
+        }
         return;
     }
     if (M5Cardputer.Keyboard.isKeyPressed('/')) {
-        currentTab = StatsTab::BOOSTS;
+        if (currentTab != StatsTab::PERF) {
+            currentTab = (StatsTab)((uint8_t)currentTab + 1);
+        }
+        return;
+    }
+    
+    // Enter on P3RF clears the timers
+    if (M5Cardputer.Keyboard.isKeyPressed(KEY_ENTER) && currentTab == StatsTab::PERF) {
+        PerfTrace::reset();
+        Display::showToast("T1M3RS R3S3T");
+        delay(500);
         return;
     }
     
@@ -464,8 +477,10 @@ void SwineStats::draw(M5Canvas& canvas) {
     // Draw content based on current tab
     if (currentTab == StatsTab::STATS) {
         drawStatsTab(canvas);
-    } else {
+    } else if (currentTab == StatsTab::BOOSTS) {
         drawBuffsTab(canvas);
+    } else {
+        drawPerfTab(canvas);
     }
     
     // Footer hint - use MAIN_H since we're drawing on mainCanvas
@@ -498,6 +513,16 @@ void SwineStats::drawTabBar(M5Canvas& canvas) {
     }
     canvas.drawString("B00STS", 95, 5);
     
+    // Tab 3: P3RF
+    if (currentTab == StatsTab::PERF) {
+        canvas.fillRect(128, 0, 60, 10, COLOR_FG);
+        canvas.setTextColor(COLOR_BG);
+    } else {
+        canvas.drawRect(128, 0, 60, 10, COLOR_FG);
+        canvas.setTextColor(COLOR_FG);
+    }
+    canvas.drawString("P3RF", 158, 5);
+    
     // Reset text color
     canvas.setTextColor(COLOR_FG);
 }
@@ -624,6 +649,35 @@ void SwineStats::drawBuffsTab(M5Canvas& canvas) {
     }
 }
 
+// Hot-path timer table, microseconds. Only sections with samples are shown.
+void SwineStats::drawPerfTab(M5Canvas& canvas) {
+    canvas.setTextSize(1);
+    canvas.setTextDatum(top_left);
+    
+    int y = 14;
+    canvas.drawString("S3CT10N uS      P50    P99    M4X", 5, y);
+    y += 10;
+    
+    int rows = 0;
+    for (uint8_t i = 0; i < PERF_SECTION_COUNT && y <= MAIN_H - 20; i++) {
+        PerfStats st = PerfTrace::getStats((PerfSection)i);
+        if (st.count == 0) continue;
+        
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%-12s %6lu %6lu %6lu",
+                 perfSectionName((PerfSection)i),
+                 (unsigned long)(st.p50 / 1000), (unsigned long)(st.p99 / 1000),
+                 (unsigned long)(st.max / 1000));
+        canvas.drawString(buf, 5, y);
+        y += 10;
+        rows++;
+    }
+    
+    if (rows == 0) {
+        canvas.drawString("[=] N0 S4MPL3S Y3T", 5, y);
+    }
+}
+
 void SwineStats::drawStats(M5Canvas& canvas) {
     const PorkXPData& data = XP::getData();
     
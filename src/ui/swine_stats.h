@@ -46,7 +46,8 @@ struct BuffState {
 // Tab selection for SWINE STATS
 enum class StatsTab : uint8_t {
     STATS = 0,
-    BOOSTS = 1
+    BOOSTS = 1,
+    PERF = 2
 };
 
 class SwineStats {
@@ -93,6 +94,7 @@ private:
     static void handleInput();
     static void drawStatsTab(M5Canvas& canvas);
     static void drawBuffsTab(M5Canvas& canvas);
+    static void drawPerfTab(M5Canvas& canvas);
     static void drawTabBar(M5Canvas& canvas);
     static void drawStats(M5Canvas& canvas);  // Stat grid helper
 };
@@ -6,6 +6,8 @@
 #include "display.h"
 #include "../web/wigle.h"
 #include "../core/config.h"
+#include "../core/wardrive_log.h"
+#include "../core/bssid_store.h"
 
 // Static member initialization
 std::vector<WigleFileInfo> WigleMenu::files;
@@ -15,6 +17,7 @@ bool WigleMenu::active = false;
 bool WigleMenu::keyWasPressed = false;
 bool WigleMenu::detailViewActive = false;
 bool WigleMenu::nukeConfirmActive = false;
+bool WigleMenu::forgetConfirmActive = false;
 bool WigleMenu::connectingWiFi = false;
 bool WigleMenu::uploadingFile = false;
 
@@ -30,6 +33,7 @@ void WigleMenu::show() {
     scrollOffset = 0;
     detailViewActive = false;
     nukeConfirmActive = false;
+    forgetConfirmActive = false;
     connectingWiFi = false;
     uploadingFile = false;
     keyWasPressed = true;  // Ignore enter that brought us here
@@ -51,7 +55,7 @@ void WigleMenu::scanFiles() {
         return;
     }
     
-    // Scan /wardriving/ directory for .wigle.csv files
+    // Scan /wardriving/ for Warhog logs (.wdl) and older .wigle.csv files
     File dir = SD.open("/wardriving");
     if (!dir || !dir.isDirectory()) {
         Serial.println("[WIGLE_MENU] /wardriving directory not found");
@@ -61,17 +65,25 @@ void WigleMenu::scanFiles() {
     while (File entry = dir.openNextFile()) {
         if (!entry.isDirectory()) {
             String name = entry.name();
-            // Only show WiGLE format files (*.wigle.csv)
-            if (name.endsWith(".wigle.csv")) {
+            bool isLog = name.endsWith("." WDL_EXT);
+            if (isLog || name.endsWith(".wigle.csv")) {
                 WigleFileInfo info;
                 info.filename = name;
                 info.fullPath = String("/wardriving/") + name;
+                info.csvPath = isLog ? WardriveLog::siblingPath(info.fullPath.c_str(), "wigle.csv")
+                                     : info.fullPath;
                 info.fileSize = entry.size();
-                // Estimate network count: ~150 bytes per line after header
-                info.networkCount = info.fileSize > 300 ? (info.fileSize - 300) / 150 : 0;
+                // Estimate network count: ~50 bytes per logged network (SSID
+                // record included), ~150 bytes per CSV line after header
+                if (isLog) {
+                    info.networkCount = info.fileSize > sizeof(WdlHeader) ?
+                        (info.fileSize - sizeof(WdlHeader)) / 50 : 0;
+                } else {
+                    info.networkCount = info.fileSize > 300 ? (info.fileSize - 300) / 150 : 0;
+                }
                 
-                // Check upload status
-                info.status = WiGLE::isUploaded(info.fullPath.c_str()) ? 
+                // Check upload status (tracked by WiGLE CSV name)
+                info.status = WiGLE::isUploaded(info.csvPath.c_str()) ? 
                     WigleFileStatus::UPLOADED : WigleFileStatus::LOCAL;
                 
                 files.push_back(info);
@@ -84,6 +96,15 @@ void WigleMenu::scanFiles() {
     }
     dir.close();
     
+    // A .wigle.csv next to its log is a leftover export - list the log only
+    files.erase(std::remove_if(files.begin(), files.end(), [](const WigleFileInfo& f) {
+        if (f.csvPath != f.fullPath) return false;
+        for (const auto& other : files) {
+            if (other.csvPath == f.csvPath && other.fullPath != f.fullPath) return true;
+        }
+        return false;
+    }), files.end());
+    
     // Sort by filename (newest first - filenames include timestamp)
     std::sort(files.begin(), files.end(), [](const WigleFileInfo& a, const WigleFileInfo& b) {
         return a.filename > b.filename;
@@ -135,6 +156,23 @@ void WigleMenu::handleInput() {
         return;  // Ignore other keys when modal active
     }
     
+    // Handle forget confirmation modal
+    if (forgetConfirmActive) {
+        if (M5Cardputer.Keyboard.isKeyPressed('y') || M5Cardputer.Keyboard.isKeyPressed('Y')) {
+            forgetSeen();
+            forgetConfirmActive = false;
+            Display::clearBottomOverlay();
+            return;
+        }
+        if (M5Cardputer.Keyboard.isKeyPressed('n') || M5Cardputer.Keyboard.isKeyPressed('N') ||
+            M5Cardputer.Keyboard.isKeyPressed('`') || M5Cardputer.Keyboard.isKeyPressed(KEY_BACKSPACE)) {
+            forgetConfirmActive = false;  // Cancel
+            Display::clearBottomOverlay();
+            return;
+        }
+        return;  // Ignore other keys when modal active
+    }
+    
     // Handle connecting/uploading states - ignore input
     if (connectingWiFi || uploadingFile) {
         return;
@@ -182,6 +220,11 @@ void WigleMenu::handleInput() {
         delay(500);
     }
     
+    // E key - render the selected log as internal and ML training CSVs
+    if ((M5Cardputer.Keyboard.isKeyPressed('e') || M5Cardputer.Keyboard.isKeyPressed('E')) && !files.empty()) {
+        exportSelected();
+    }
+    
     // D key - nuke selected track
     if ((M5Cardputer.Keyboard.isKeyPressed('d') || M5Cardputer.Keyboard.isKeyPressed('D')) && !files.empty()) {
         if (selectedIndex < files.size()) {
@@ -189,6 +232,12 @@ void WigleMenu::handleInput() {
             Display::setBottomOverlay("PERMANENT | NO UNDO");
         }
     }
+    
+    // F key - forget seen BSSIDs, so the next WARHOG run logs everything again
+    if (M5Cardputer.Keyboard.isKeyPressed('f') || M5Cardputer.Keyboard.isKeyPressed('F')) {
+        forgetConfirmActive = true;
+        Display::setBottomOverlay("PERMANENT | NO UNDO");
+    }
 }
 
 void WigleMenu::uploadSelected() {
@@ -227,18 +276,30 @@ void WigleMenu::uploadSelected() {
     }
     connectingWiFi = false;
     
-    // Upload the file
+    // Upload the file - logs are rendered to WiGLE CSV first, and the
+    // export is removed again afterwards (the log stays the only copy)
     uploadingFile = true;
-    Display::showToast("UPLOADING...");
-    
-    bool success = WiGLE::uploadFile(file.fullPath.c_str());
+    bool exported = file.csvPath != file.fullPath;
+    bool exportOk = true;
+    bool success = false;
+    if (exported) {
+        Display::showToast("EXPORTING...");
+        exportOk = WardriveLog::exportWigle(file.fullPath.c_str(), file.csvPath.c_str());
+    }
+    if (exportOk) {
+        Display::showToast("UPLOADING...");
+        success = WiGLE::uploadFile(file.csvPath.c_str());
+    }
+    if (exported) {
+        SD.remove(file.csvPath.c_str());
+    }
     uploadingFile = false;
     
     if (success) {
         file.status = WigleFileStatus::UPLOADED;
         Display::showToast("UPLOAD OK!");
     } else {
-        Display::showToast(WiGLE::getLastError());
+        Display::showToast(exportOk ? WiGLE::getLastError() : "EXPORT FAILED");
     }
     delay(500);
     
@@ -248,6 +309,31 @@ void WigleMenu::uploadSelected() {
     }
 }
 
+void WigleMenu::exportSelected() {
+    if (files.empty() || selectedIndex >= files.size()) return;
+    
+    const WigleFileInfo& file = files[selectedIndex];
+    
+    // Old .wigle.csv tracks carry no features to export
+    if (!file.fullPath.endsWith("." WDL_EXT)) {
+        Display::showToast("LOGS ONLY (.WDL)");
+        delay(500);
+        return;
+    }
+    
+    Display::showToast("EXPORTING...");
+    
+    String csvPath = WardriveLog::siblingPath(file.fullPath.c_str(), "csv");
+    String mlPath = WardriveLog::mlPath(file.fullPath.c_str());
+    if (!SD.exists("/mldata")) SD.mkdir("/mldata");
+    
+    bool ok = WardriveLog::exportCSV(file.fullPath.c_str(), csvPath.c_str());
+    ok = WardriveLog::exportML(file.fullPath.c_str(), mlPath.c_str()) && ok;
+    
+    Display::showToast(ok ? "EXPORTED TO SD" : "EXPORT FAILED");
+    delay(500);
+}
+
 String WigleMenu::formatSize(uint32_t bytes) {
     if (bytes < 1024) {
         return String(bytes) + "B";
@@ -260,7 +346,7 @@ String WigleMenu::formatSize(uint32_t bytes) {
 
 String WigleMenu::getSelectedInfo() {
     if (files.empty() || selectedIndex >= files.size()) {
-        return "D0PAM1N3 SH0P: [U] [R] [D]";
+        return "D0PAM1N3 SH0P: [U] [E] [R] [D] [F]";
     }
     const WigleFileInfo& file = files[selectedIndex];
     // Show: ~XNETS XKB [OK]/[--]
@@ -288,6 +374,9 @@ void WigleMenu::draw(M5Canvas& canvas) {
         canvas.print("Go wardriving first!");
         canvas.setCursor(4, 65);
         canvas.print("[W] for WARHOG mode.");
+        if (forgetConfirmActive) {
+            drawForgetConfirm(canvas);
+        }
         return;
     }
     
@@ -308,12 +397,14 @@ void WigleMenu::draw(M5Canvas& canvas) {
         
         // Filename first (truncated) - extract just the date/time part
         String displayName = file.filename;
-        // Remove "warhog_" prefix and ".wigle.csv" suffix for cleaner display
+        // Remove "warhog_" prefix and ".wdl"/".wigle.csv" suffix for cleaner display
         if (displayName.startsWith("warhog_")) {
             displayName = displayName.substring(7);
         }
         if (displayName.endsWith(".wigle.csv")) {
             displayName = displayName.substring(0, displayName.length() - 10);
+        } else if (displayName.endsWith("." WDL_EXT)) {
+            displayName = displayName.substring(0, displayName.lastIndexOf('.'));
         }
         if (displayName.length() > 15) {
             displayName = displayName.substring(0, 13) + "..";
@@ -353,6 +444,10 @@ void WigleMenu::draw(M5Canvas& canvas) {
         drawNukeConfirm(canvas);
     }
     
+    if (forgetConfirmActive) {
+        drawForgetConfirm(canvas);
+    }
+    
     if (detailViewActive) {
         drawDetailView(canvas);
     }
@@ -459,6 +554,39 @@ void WigleMenu::drawNukeConfirm(M5Canvas& canvas) {
     canvas.setTextDatum(top_left);
 }
 
+void WigleMenu::drawForgetConfirm(M5Canvas& canvas) {
+    // Modal box dimensions - matches other confirmation dialogs
+    const int boxW = 200;
+    const int boxH = 70;
+    const int boxX = (canvas.width() - boxW) / 2;
+    const int boxY = (canvas.height() - boxH) / 2 - 5;
+    
+    // Black border then pink fill
+    canvas.fillRoundRect(boxX - 2, boxY - 2, boxW + 4, boxH + 4, 8, COLOR_BG);
+    canvas.fillRoundRect(boxX, boxY, boxW, boxH, 8, COLOR_FG);
+    
+    // Black text on pink background
+    canvas.setTextColor(COLOR_BG, COLOR_FG);
+    canvas.setTextDatum(top_center);
+    canvas.setTextSize(1);
+    
+    int centerX = canvas.width() / 2;
+    
+    canvas.drawString("!! FORGET ALL APs !!", centerX, boxY + 8);
+    canvas.drawString("TRACKS ARE KEPT.", centerX, boxY + 24);
+    canvas.drawString("NEXT RUN LOGS ALL.", centerX, boxY + 38);
+    canvas.drawString("[Y] DO IT  [N] ABORT", centerX, boxY + 54);
+    
+    canvas.setTextDatum(top_left);
+}
+
+void WigleMenu::forgetSeen() {
+    // Only the SD files matter here: WARHOG loads them on start
+    BssidStore::forget();
+    Display::showToast("APs FORGOTTEN");
+    delay(500);
+}
+
 void WigleMenu::nukeTrack() {
     if (files.empty() || selectedIndex >= files.size()) return;
     
@@ -466,11 +594,16 @@ void WigleMenu::nukeTrack() {
     
     Serial.printf("[WIGLE_MENU] Nuking track: %s\n", file.fullPath.c_str());
     
-    // Delete the .wigle.csv file
+    // Delete the log (or .wigle.csv file)
     bool deleted = SD.remove(file.fullPath);
     
-    // Also delete matching internal CSV if exists (same name without .wigle)
-    String internalPath = file.fullPath;
+    // Also delete a leftover WiGLE export of a log, and the matching
+    // internal CSV if exists (same name without .wigle)
+    if (file.csvPath != file.fullPath && SD.exists(file.csvPath)) {
+        SD.remove(file.csvPath);
+        Serial.printf("[WIGLE_MENU] Also nuked: %s\n", file.csvPath.c_str());
+    }
+    String internalPath = file.csvPath;
     internalPath.replace(".wigle.csv", ".csv");
     if (SD.exists(internalPath)) {
         SD.remove(internalPath);
@@ -478,7 +611,7 @@ void WigleMenu::nukeTrack() {
     }
     
     // Remove from uploaded tracking if present
-    WiGLE::removeFromUploaded(file.fullPath.c_str());
+    WiGLE::removeFromUploaded(file.csvPath.c_str());
     
     if (deleted) {
         Display::showToast("TRACK NUKED!");
@@ -14,6 +14,7 @@ enum class WigleFileStatus {
 struct WigleFileInfo {
     String filename;
     String fullPath;
+    String csvPath;         // WiGLE CSV uploaded (exported first for .wdl logs)
     uint32_t fileSize;
     uint32_t networkCount;  // Approximate based on file size
     WigleFileStatus status;
@@ -38,6 +39,7 @@ private:
     static bool keyWasPressed;
     static bool detailViewActive;   // File detail view
     static bool nukeConfirmActive;  // Nuke confirmation modal
+    static bool forgetConfirmActive;  // Forget seen BSSIDs confirmation modal
     static bool connectingWiFi;     // WiFi connection in progress
     static bool uploadingFile;      // Upload in progress
     
@@ -47,8 +49,11 @@ private:
     static void handleInput();
     static void drawDetailView(M5Canvas& canvas);
     static void drawNukeConfirm(M5Canvas& canvas);
+    static void drawForgetConfirm(M5Canvas& canvas);
     static void drawConnecting(M5Canvas& canvas);
     static void uploadSelected();
+    static void exportSelected();
     static void nukeTrack();
+    static void forgetSeen();
     static String formatSize(uint32_t bytes);
 };
@@ -0,0 +1,171 @@
+// Directory Listing - JSON rows and bounded sorted pages for /api/ls
+// Pure logic, no SD or WebServer. The file server streams rows from a
+// fixed buffer; a sorted page is picked with one pass over the directory
+// per page-sized step, keeping at most `capacity` entries in memory no
+// matter how many files the directory holds.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <strings.h>
+
+static const size_t DIR_NAME_MAX = 256;  // FAT long name + NUL
+
+enum class DirSort : uint8_t {
+    NONE,   // Directory order
+    NAME,
+    SIZE,
+    TIME
+};
+
+struct DirListEntry {
+    char name[DIR_NAME_MAX];
+    uint32_t size;
+    uint32_t mtime;
+    uint16_t ord;       // Position in directory order - breaks ties
+    bool isDir;
+};
+
+// "name" / "size" / "time", anything else is NONE
+inline DirSort dirSortFromString(const char* s) {
+    if (!s) return DirSort::NONE;
+    if (strcmp(s, "name") == 0) return DirSort::NAME;
+    if (strcmp(s, "size") == 0) return DirSort::SIZE;
+    if (strcmp(s, "time") == 0) return DirSort::TIME;
+    return DirSort::NONE;
+}
+
+// Strict total order for a sorted listing: directories first (whichever
+// way the key runs), then the key, then the name, then directory order
+inline bool dirEntryBefore(const DirListEntry& a, const DirListEntry& b, DirSort sort, bool desc) {
+    if (a.isDir != b.isDir) return a.isDir;
+
+    int c = 0;
+    if (sort == DirSort::SIZE) {
+        c = a.size < b.size ? -1 : (a.size > b.size ? 1 : 0);
+    } else if (sort == DirSort::TIME) {
+        c = a.mtime < b.mtime ? -1 : (a.mtime > b.mtime ? 1 : 0);
+    }
+    if (c == 0 && sort != DirSort::NONE) {
+        c = strcasecmp(a.name, b.name);
+        if (c == 0) c = strcmp(a.name, b.name);
+    }
+    if (c != 0) return desc ? c > 0 : c < 0;
+    return a.ord < b.ord;
+}
+
+// JSON string body of s (no quotes) into out. Returns bytes written,
+// 0 if it doesn't fit (an empty s also returns 0).
+inline size_t jsonEscape(char* out, size_t cap, const char* s) {
+    static const char HEX[] = "0123456789abcdef";
+    size_t n = 0;
+    for (; *s; s++) {
+        unsigned char ch = (unsigned char)*s;
+        if (ch == '"' || ch == '\\') {
+            if (n + 2 > cap) return 0;
+            out[n++] = '\\';
+            out[n++] = (char)ch;
+        } else if (ch < 0x20) {
+            if (n + 6 > cap) return 0;
+            memcpy(out + n, "\\u00", 4);
+            out[n + 4] = HEX[ch >> 4];
+            out[n + 5] = HEX[ch & 0x0F];
+            n += 6;
+        } else {
+            if (n + 1 > cap) return 0;
+            out[n++] = (char)ch;
+        }
+    }
+    return n;
+}
+
+// One listing object, {"name":"..","size":N[,"isDir":b,"mtime":T]},
+// into out. Returns its length, 0 if it doesn't fit.
+inline size_t dirEntryJson(char* out, size_t cap, const DirListEntry& e, bool full) {
+    static const char OPEN[] = "{\"name\":\"";
+    const size_t openLen = sizeof(OPEN) - 1;
+    if (cap < openLen) return 0;
+    memcpy(out, OPEN, openLen);
+    size_t n = openLen;
+
+    size_t nameLen = jsonEscape(out + n, cap - n, e.name);
+    if (nameLen == 0 && e.name[0] != '\0') return 0;
+    n += nameLen;
+
+    int w;
+    if (full) {
+        w = snprintf(out + n, cap - n, "\",\"size\":%lu,\"isDir\":%s,\"mtime\":%lu}",
+                     (unsigned long)e.size, e.isDir ? "true" : "false", (unsigned long)e.mtime);
+    } else {
+        w = snprintf(out + n, cap - n, "\",\"size\":%lu}", (unsigned long)e.size);
+    }
+    if (w < 0 || (size_t)w >= cap - n) return 0;
+    return n + (size_t)w;
+}
+
+// The `capacity` first entries, in sort order, that come after `after`
+// (or from the start when it's null). Feed every directory entry to
+// offer(); the page is then at(0)..at(count()-1). Storage is the
+// caller's: `slots` holds `capacity` entries, `order` `capacity` bytes.
+class DirPage {
+public:
+    static const size_t MAX_CAPACITY = 255;
+
+    DirPage() : slots(nullptr), order(nullptr), cap(0), used(0), sort(DirSort::NAME),
+                desc(false), hasAfter(false) {}
+
+    bool begin(DirListEntry* slotBuf, uint8_t* orderBuf, size_t capacity,
+               DirSort by, bool descending, const DirListEntry* afterEntry) {
+        if (!slotBuf || !orderBuf || capacity == 0 || capacity > MAX_CAPACITY) return false;
+        slots = slotBuf;
+        order = orderBuf;
+        cap = capacity;
+        used = 0;
+        sort = by;
+        desc = descending;
+        hasAfter = afterEntry != nullptr;
+        if (hasAfter) after = *afterEntry;
+        return true;
+    }
+
+    // Keeps e if it belongs on this page (so far). False if it didn't.
+    bool offer(const DirListEntry& e) {
+        if (hasAfter && !dirEntryBefore(after, e, sort, desc)) return false;
+
+        uint8_t slot;
+        if (used < cap) {
+            slot = (uint8_t)used++;
+        } else {
+            // Full: e must beat the current last entry, whose slot it takes
+            if (!dirEntryBefore(e, slots[order[cap - 1]], sort, desc)) return false;
+            slot = order[cap - 1];
+        }
+        slots[slot] = e;
+
+        // Insertion into the order list - moves bytes, not entries
+        size_t i = used - 1;
+        while (i > 0 && dirEntryBefore(e, slots[order[i - 1]], sort, desc)) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = slot;
+        return true;
+    }
+
+    size_t count() const { return used; }
+    bool full() const { return used == cap; }
+    const DirListEntry& at(size_t i) const { return slots[order[i]]; }
+    const DirListEntry& last() const { return slots[order[used - 1]]; }
+
+private:
+    DirListEntry* slots;
+    uint8_t* order;
+    size_t cap;
+    size_t used;
+    DirSort sort;
+    bool desc;
+    bool hasAfter;
+    DirListEntry after;
+};
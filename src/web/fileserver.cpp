@@ -3,6 +3,16 @@
 #include "fileserver.h"
 #include <SD.h>
 #include <ESPmDNS.h>
+#include "../core/crc32.h"
+#include "../core/perf_trace.h"
+#include "dir_listing.h"
+#include "zip_stream.h"
+#include "http_range.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <new>
+#include <vector>
 
 // Static members
 WebServer* FileServer::server = nullptr;
@@ -634,20 +644,26 @@ async function deleteSelected() {
 }
 
 async function downloadSelected() {
-    const items = getSelectedPaths().filter(i => !i.isDir);
+    const items = getSelectedPaths();
     if (items.length === 0) {
-        setStatus('no files marked. dirs need zip. we aint got zip.');
+        setStatus('nothing marked. mark files or dirs first.');
         return;
     }
     
-    setStatus('exfiltrating ' + items.length + ' file(s)...');
+    setStatus('exfiltrating ' + items.length + ' item(s)...');
     
-    // Download files sequentially (browser limitation)
+    // Files one by one, folders as a single streamed zip each
     for (let i = 0; i < items.length; i++) {
         await new Promise(resolve => {
             const a = document.createElement('a');
-            a.href = '/download?f=' + encodeURIComponent(items[i].path);
-            a.download = items[i].path.split('/').pop();
+            const name = items[i].path.split('/').pop();
+            if (items[i].isDir) {
+                a.href = '/download?dir=' + encodeURIComponent(items[i].path);
+                a.download = name + '.zip';
+            } else {
+                a.href = '/download?f=' + encodeURIComponent(items[i].path);
+                a.download = name;
+            }
             a.click();
             setTimeout(resolve, 300); // Small delay between downloads
         });
@@ -929,6 +945,7 @@ void FileServer::startServer() {
     server->on("/", HTTP_GET, handleRoot);
     server->on("/api/ls", HTTP_GET, handleFileList);
     server->on("/api/sdinfo", HTTP_GET, handleSDInfo);
+    server->on("/api/perf", HTTP_GET, handlePerf);
     server->on("/api/bulkdelete", HTTP_POST, handleBulkDelete);
     server->on("/api/rename", HTTP_GET, handleRename);
     server->on("/api/copy", HTTP_POST, handleCopy);
@@ -940,6 +957,10 @@ void FileServer::startServer() {
     server->on("/mkdir", HTTP_GET, handleMkdir);
     server->onNotFound(handleNotFound);
     
+    // Request headers handlers read besides the defaults
+    static const char* wantedHeaders[] = {"Range", "If-Range", "If-None-Match"};
+    server->collectHeaders(wantedHeaders, 3);
+    
     server->begin();
     state = FileServerState::RUNNING;
     lastReconnectCheck = millis();
@@ -1062,6 +1083,61 @@ void FileServer::handleSDInfo() {
     server->send(200, "application/json", json);
 }
 
+void FileServer::handlePerf() {
+    // ?reset=1 clears the histograms after reporting them
+    String json;
+    PerfTrace::toJSON(json);
+    if (server->hasArg("reset")) {
+        PerfTrace::reset();
+    }
+    server->send(200, "application/json", json);
+}
+
+// Listing is streamed as chunked JSON from this buffer - memory use doesn't
+// depend on how many files the directory holds
+static const size_t LIST_CHUNK = 2048;
+static const size_t LIST_ROW_MAX = DIR_NAME_MAX * 6 + 96;  // Worst-case escaped name + fields
+static const size_t LIST_SORTED_MAX = 50;                  // Entries held for a sorted page
+static_assert(LIST_ROW_MAX <= LIST_CHUNK, "a listing row must fit one chunk");
+
+struct ListWriter {
+    WebServer* server;
+    size_t len;
+    char buf[LIST_CHUNK];
+    
+    void flush() {
+        if (len > 0) server->sendContent(buf, len);
+        len = 0;
+    }
+    
+    void put(const char* s) {
+        size_t n = strlen(s);
+        if (len + n > sizeof(buf)) flush();
+        memcpy(buf + len, s, n);
+        len += n;
+    }
+    
+    void row(const DirListEntry& e, bool full, bool first) {
+        if (!first) put(",");
+        if (len + LIST_ROW_MAX > sizeof(buf)) flush();
+        len += dirEntryJson(buf + len, sizeof(buf) - len, e, full);
+    }
+};
+
+static void readListEntry(File& file, uint16_t ord, DirListEntry& e) {
+    strncpy(e.name, file.name(), sizeof(e.name) - 1);
+    e.name[sizeof(e.name) - 1] = '\0';
+    e.isDir = file.isDirectory();
+    e.size = e.isDir ? 0 : file.size();
+    e.mtime = (uint32_t)file.getLastWrite();
+    e.ord = ord;
+}
+
+// GET /api/ls?dir=/x[&full=1]
+//   Plain JSON array of every entry, in directory order (what the UI uses)
+// GET /api/ls?dir=/x&offset=N&limit=M[&sort=name|size|time][&order=desc]
+//   {"entries":[...],"offset":N,"more":bool} - one page. Sorted pages put
+//   directories first and are limited to LIST_SORTED_MAX entries.
 void FileServer::handleFileList() {
     String dir = server->arg("dir");
     bool full = server->arg("full") == "1";
@@ -1073,42 +1149,510 @@ void FileServer::handleFileList() {
         return;
     }
     
+    DirSort sort = dirSortFromString(server->arg("sort").c_str());
+    bool desc = server->arg("order") == "desc";
+    bool paged = server->hasArg("offset") || server->hasArg("limit") || sort != DirSort::NONE;
+    long offsetArg = server->arg("offset").toInt();
+    long limitArg = server->arg("limit").toInt();
+    size_t offset = offsetArg > 0 ? (size_t)offsetArg : 0;
+    size_t limit = limitArg > 0 ? (size_t)limitArg : 0;  // 0 = no limit
+    if (sort != DirSort::NONE && (limit == 0 || limit > LIST_SORTED_MAX)) limit = LIST_SORTED_MAX;
+    
     File root = SD.open(dir);
     if (!root || !root.isDirectory()) {
-        server->send(200, "application/json", "[]");
+        if (root) root.close();
+        server->send(200, "application/json", paged ? "{\"entries\":[],\"offset\":0,\"more\":false}" : "[]");
         return;
     }
     
-    String json = "[";
-    bool first = true;
+    // Sorted pages need their entries held: allocate before committing to a 200
+    DirListEntry* slots = nullptr;
+    uint8_t* order = nullptr;
+    if (sort != DirSort::NONE) {
+        slots = new (std::nothrow) DirListEntry[limit];
+        order = new (std::nothrow) uint8_t[limit];
+        if (!slots || !order) {
+            delete[] slots;
+            delete[] order;
+            root.close();
+            server->send(503, "application/json", "[]");
+            return;
+        }
+    }
+    
+    ListWriter* out = new (std::nothrow) ListWriter();
+    if (!out) {
+        delete[] slots;
+        delete[] order;
+        root.close();
+        server->send(503, "application/json", "[]");
+        return;
+    }
+    out->server = server;
+    out->len = 0;
+    
+    server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server->send(200, "application/json", "");
+    out->put(paged ? "{\"entries\":[" : "[");
+    
+    size_t sent = 0;
+    bool more = false;
+    DirListEntry e;
+    
+    if (sort == DirSort::NONE) {
+        // Directory order: skip, stream, then peek once for "more"
+        size_t index = 0;
+        File file = root.openNextFile();
+        while (file) {
+            if (limit > 0 && sent == limit) {
+                more = true;
+                file.close();
+                break;
+            }
+            if (index >= offset) {
+                readListEntry(file, (uint16_t)index, e);
+                out->row(e, full, sent == 0);
+                sent++;
+            }
+            index++;
+            file.close();
+            file = root.openNextFile();
+        }
+    } else {
+        // Each pass over the directory yields the next `limit` entries in
+        // sort order after the last one of the previous pass
+        DirPage page;
+        DirListEntry* after = nullptr;
+        size_t skip = offset;
+        for (;;) {
+            page.begin(slots, order, limit, sort, desc, after);
+            size_t total = 0;
+            root.rewindDirectory();
+            File file = root.openNextFile();
+            while (file) {
+                readListEntry(file, (uint16_t)total, e);
+                page.offer(e);
+                total++;
+                file.close();
+                file = root.openNextFile();
+            }
+            
+            size_t i = skip < page.count() ? skip : page.count();
+            skip -= i;
+            for (; i < page.count() && sent < limit; i++, sent++) {
+                out->row(page.at(i), full, sent == 0);
+            }
+            if (!page.full() || sent == limit) {
+                more = total > offset + sent;
+                break;
+            }
+            e = page.last();
+            after = &e;
+        }
+    }
+    root.close();
+    
+    if (paged) {
+        char tail[64];
+        snprintf(tail, sizeof(tail), "],\"offset\":%lu,\"more\":%s}",
+                 (unsigned long)offset, more ? "true" : "false");
+        out->put(tail);
+    } else {
+        out->put("]");
+    }
+    out->flush();
+    server->sendContent("");  // Terminating chunk
+    
+    delete out;
+    delete[] slots;
+    delete[] order;
+}
+
+// ============ Folder ZIP ============
+// The archive is planned first (names, sizes, timestamps - also what the
+// central directory needs) so Content-Length is exact, then every file is
+// streamed once with its CRC worked out on the way through.
+
+static const size_t ZIP_IO_CHUNK = 4096;
+static const uint8_t ZIP_MAX_DEPTH = 8;
+static const size_t ZIP_PLAN_MAX_ENTRIES = 4096;    // ~20 bytes + name each, all in RAM
+static const size_t ZIP_HEAP_RESERVE = 24 * 1024;   // Left over for the response itself
+
+enum class ZipPlanStatus : uint8_t {
+    OK,
+    TOO_MANY,       // Over ZIP_PLAN_MAX_ENTRIES: 413, download subfolders
+    NO_MEMORY       // Plan would eat into ZIP_HEAP_RESERVE: 503
+};
+
+struct ZipPlanEntry {
+    uint32_t nameAt;    // Offset in ZipPlan::names
+    uint16_t nameLen;
+    uint16_t dosTime;
+    uint16_t dosDate;
+    uint32_t size;
+    uint32_t crc;       // Filled in while streaming
+    uint32_t offset;    // Of the local header
+};
+
+struct ZipPlan {
+    std::vector<ZipPlanEntry> entries;
+    std::vector<char> names;  // Archive names, NUL-terminated, back to back
+    uint64_t dataBytes;
+    ZipPlanStatus status;
+};
+
+// Whether one more entry fits without the plan's vectors regrowing into
+// the reserve (a regrow briefly needs the old and the doubled block)
+static bool zipPlanHasRoom(const ZipPlan& plan, size_t nameLen) {
+    if (heap_caps_get_free_size(MALLOC_CAP_8BIT) < ZIP_HEAP_RESERVE) return false;
+    size_t need = 0;
+    if (plan.entries.size() == plan.entries.capacity()) {
+        need = (plan.entries.capacity() * 2 + 1) * sizeof(ZipPlanEntry);
+    }
+    if (plan.names.size() + nameLen + 1 > plan.names.capacity()) {
+        size_t grow = plan.names.capacity() * 2 + nameLen + 1;
+        if (grow > need) need = grow;
+    }
+    return need == 0 || heap_caps_get_largest_free_block(MALLOC_CAP_8BIT) >= need + ZIP_HEAP_RESERVE;
+}
+
+static String joinPath(const String& dir, const String& name) {
+    return dir.endsWith("/") ? dir + name : dir + "/" + name;
+}
+
+// Every file under sdDir, named zipDir + relative path in the archive
+static void planZip(const String& sdDir, const String& zipDir, ZipPlan& plan, uint8_t depth) {
+    File root = SD.open(sdDir);
+    if (!root || !root.isDirectory()) {
+        if (root) root.close();
+        return;
+    }
     
-    File file = root.openNextFile();
-    while (file) {
-        if (!first) json += ",";
-        first = false;
+    File entry;
+    while (plan.status == ZipPlanStatus::OK && (entry = root.openNextFile())) {
+        String name = entry.name();
+        int lastSlash = name.lastIndexOf('/');
+        if (lastSlash >= 0) name = name.substring(lastSlash + 1);
         
-        // Escape filename for JSON
-        String fname = file.name();
-        fname.replace("\\", "\\\\");
-        fname.replace("\"", "\\\"");
+        if (entry.isDirectory()) {
+            entry.close();
+            if (depth < ZIP_MAX_DEPTH) {
+                planZip(joinPath(sdDir, name), zipDir + name + "/", plan, depth + 1);
+            }
+            continue;
+        }
         
-        json += "{\"name\":\"";
-        json += fname;
-        json += "\",\"size\":";
-        json += String(file.size());
-        if (full) {
-            json += ",\"isDir\":";
-            json += file.isDirectory() ? "true" : "false";
+        String zipName = zipDir + name;
+        if (zipName.length() > ZIP_NAME_MAX) {
+            Serial.printf("[FILESERVER] ZIP: skipping %s\n", zipName.c_str());
+            entry.close();
+            continue;
+        }
+        if (plan.entries.size() >= ZIP_PLAN_MAX_ENTRIES) {
+            plan.status = ZipPlanStatus::TOO_MANY;
+            entry.close();
+            break;
+        }
+        if (!zipPlanHasRoom(plan, zipName.length())) {
+            plan.status = ZipPlanStatus::NO_MEMORY;
+            entry.close();
+            break;
         }
-        json += "}";
         
-        file.close();
-        file = root.openNextFile();
+        ZipPlanEntry e;
+        e.nameAt = plan.names.size();
+        e.nameLen = zipName.length();
+        e.size = entry.size();
+        e.crc = 0;
+        e.offset = 0;
+        zipDosTime((uint32_t)entry.getLastWrite(), e.dosTime, e.dosDate);
+        entry.close();
+        
+        plan.names.insert(plan.names.end(), zipName.c_str(), zipName.c_str() + e.nameLen + 1);
+        plan.entries.push_back(e);
+        plan.dataBytes += e.size;
+        yield();
     }
-    
     root.close();
-    json += "]";
-    server->send(200, "application/json", json);
+}
+
+void FileServer::streamFolderZip(const String& dir) {
+    // Security: prevent directory traversal
+    if (dir.indexOf("..") >= 0) {
+        server->send(400, "text/plain", "Invalid path");
+        return;
+    }
+    
+    String sdDir = dir;
+    while (sdDir.length() > 1 && sdDir.endsWith("/")) sdDir.remove(sdDir.length() - 1);
+    File check = SD.open(sdDir);
+    bool isDir = check && check.isDirectory();
+    if (check) check.close();
+    if (!isDir) {
+        server->send(404, "text/plain", "Folder not found");
+        return;
+    }
+    
+    // Archive names keep the folder itself as their top level
+    String folder = sdDir.substring(sdDir.lastIndexOf('/') + 1);
+    if (folder.isEmpty()) folder = "sdcard";
+    String zipRoot = sdDir == "/" ? String("") : folder + "/";
+    
+    ZipPlan plan;
+    plan.dataBytes = 0;
+    plan.status = ZipPlanStatus::OK;
+    planZip(sdDir, zipRoot, plan, 0);
+    
+    // Nothing has been sent yet, so a plan that didn't fit can still be refused
+    if (plan.status == ZipPlanStatus::TOO_MANY) {
+        Serial.printf("[FILESERVER] ZIP %s: over %u files, refused\n", sdDir.c_str(), (unsigned)ZIP_PLAN_MAX_ENTRIES);
+        server->send(413, "text/plain", "Too many files for one ZIP - download subfolders");
+        return;
+    }
+    if (plan.status == ZipPlanStatus::NO_MEMORY) {
+        Serial.printf("[FILESERVER] ZIP %s: plan out of heap after %u files\n", sdDir.c_str(),
+                      (unsigned)plan.entries.size());
+        server->send(503, "text/plain", "Not enough memory for this folder - download subfolders");
+        return;
+    }
+    
+    // Pool counts a NUL per name that never goes on the wire
+    uint32_t total = zipArchiveSize(plan.entries.size(), plan.names.size() - plan.entries.size(), plan.dataBytes);
+    if (total == 0) {
+        server->send(413, "text/plain", "Folder too big for one ZIP - download subfolders");
+        return;
+    }
+    
+    uint8_t* buf = new (std::nothrow) uint8_t[ZIP_IO_CHUNK];
+    if (!buf) {
+        server->send(503, "text/plain", "Out of memory");
+        return;
+    }
+    
+    Serial.printf("[FILESERVER] ZIP %s: %u files, %lu bytes\n", sdDir.c_str(),
+                  (unsigned)plan.entries.size(), (unsigned long)total);
+    
+    server->setContentLength(total);
+    server->sendHeader("Content-Disposition", "attachment; filename=\"" + folder + ".zip\"");
+    server->send(200, "application/zip", "");
+    
+    WiFiClient client = server->client();
+    uint32_t written = 0;
+    bool ok = true;
+    
+    // Short write = client went away
+    auto send = [&](const uint8_t* data, size_t len) {
+        if (ok && client.write(data, len) != len) ok = false;
+        written += len;
+        return ok;
+    };
+    
+    String base = sdDir == "/" ? String("/") : sdDir.substring(0, sdDir.lastIndexOf('/') + 1);
+    uint32_t startMs = millis();
+    
+    for (size_t i = 0; ok && i < plan.entries.size(); i++) {
+        ZipPlanEntry& e = plan.entries[i];
+        const char* name = &plan.names[e.nameAt];
+        e.offset = written;
+        
+        File f = SD.open(base + name);
+        if (!f) {
+            // Gone since planning: can't keep the promised length
+            Serial.printf("[FILESERVER] ZIP: %.*s vanished, aborting\n", e.nameLen, name);
+            ok = false;
+            break;
+        }
+        
+        // Local header rides in front of the first data chunk
+        size_t len = zipLocalHeader(buf, name, e.nameLen, e.dosTime, e.dosDate);
+        uint32_t crc = 0;
+        uint32_t left = e.size;
+        while (ok) {
+            size_t want = ZIP_IO_CHUNK - len;
+            if (want > left) want = left;
+            size_t got = want ? f.read(buf + len, want) : 0;
+            if (got != want) {
+                Serial.printf("[FILESERVER] ZIP: short read on %.*s, aborting\n", e.nameLen, name);
+                ok = false;
+                break;
+            }
+            crc = crc32Update(crc, buf + len, got);
+            left -= got;
+            len += got;
+            if (left == 0) {
+                if (len + ZIP_DESCRIPTOR_SIZE > ZIP_IO_CHUNK) {
+                    send(buf, len);
+                    len = 0;
+                }
+                e.crc = crc;
+                len += zipDataDescriptor(buf + len, crc, e.size);
+                send(buf, len);
+                break;
+            }
+            send(buf, len);
+            len = 0;
+        }
+        f.close();
+        yield();
+    }
+    
+    // Central directory, batched into as few writes as fit the buffer
+    uint32_t centralOffset = written;
+    size_t len = 0;
+    for (size_t i = 0; ok && i < plan.entries.size(); i++) {
+        const ZipPlanEntry& e = plan.entries[i];
+        if (len + ZIP_CENTRAL_HEADER_SIZE + e.nameLen > ZIP_IO_CHUNK) {
+            send(buf, len);
+            len = 0;
+        }
+        len += zipCentralHeader(buf + len, &plan.names[e.nameAt], e.nameLen, e.crc, e.size,
+                                e.dosTime, e.dosDate, e.offset);
+    }
+    if (ok) {
+        if (len + ZIP_END_RECORD_SIZE > ZIP_IO_CHUNK) {
+            send(buf, len);
+            len = 0;
+        }
+        uint32_t centralSize = written + len - centralOffset;
+        len += zipEndRecord(buf + len, plan.entries.size(), centralSize, centralOffset);
+        send(buf, len);
+    }
+    delete[] buf;
+    
+    if (!ok) {
+        client.stop();  // Truncated archive must not look complete
+        Serial.printf("[FILESERVER] ZIP %s aborted after %lu bytes\n", sdDir.c_str(), (unsigned long)written);
+        return;
+    }
+    uint32_t elapsed = millis() - startMs;
+    Serial.printf("[FILESERVER] ZIP %s sent in %lu ms (%lu KB/s)\n", sdDir.c_str(), (unsigned long)elapsed,
+                  (unsigned long)(elapsed ? (uint64_t)written / elapsed : 0));
+}
+
+// ============ File streaming ============
+// Downloads read the card in big sector-aligned blocks into two DMA-capable
+// buffers. A reader task fills one while this task writes the other to the
+// socket, so SD and WiFi time overlap instead of adding up.
+
+static const size_t STREAM_BUF_SIZE = 16384;       // Multiple of the sector size
+static const size_t STREAM_BUF_FALLBACK = 4096;    // Single buffer when the heap is tight
+
+struct StreamJob {
+    File* file;
+    uint8_t* buf[2];
+    size_t len[2];
+    uint32_t pos;               // Next file offset to read
+    uint32_t left;              // Bytes still to read
+    volatile bool stop;         // Writer gave up (client gone)
+    SemaphoreHandle_t freeBufs; // Buffers the reader may fill
+    SemaphoreHandle_t fullBufs; // Buffers waiting for the writer
+    SemaphoreHandle_t done;     // Reader has exited
+};
+
+static void streamReadTask(void* arg) {
+    StreamJob* job = (StreamJob*)arg;
+    int i = 0;
+    while (job->left > 0) {
+        xSemaphoreTake(job->freeBufs, portMAX_DELAY);
+        if (job->stop) break;
+        size_t want = alignedReadSize(job->pos, job->left, STREAM_BUF_SIZE);
+        size_t got = job->file->read(job->buf[i], want);
+        job->len[i] = got;
+        job->pos += got;
+        job->left -= got;
+        xSemaphoreGive(job->fullBufs);
+        if (got == 0) break;  // Writer sees the empty buffer as an error
+        i ^= 1;
+    }
+    xSemaphoreGive(job->done);
+    vTaskDelete(NULL);
+}
+
+// One buffer, read then write: small files and low-memory fallback
+static bool streamFileSimple(WiFiClient& client, File& file, uint32_t pos, uint32_t length,
+                             uint8_t* buf, size_t bufSize) {
+    while (length > 0) {
+        size_t want = alignedReadSize(pos, length, bufSize);
+        size_t got = file.read(buf, want);
+        if (got == 0 || client.write(buf, got) != got) return false;
+        pos += got;
+        length -= got;
+    }
+    return true;
+}
+
+// Sends `length` bytes of file (already positioned at `pos`) to client.
+// False if the card or the client gave out part way.
+bool FileServer::streamFileRange(WiFiClient& client, File& file, uint32_t pos, uint32_t length) {
+    if (length == 0) return true;
+    
+    uint8_t* a = nullptr;
+    uint8_t* b = nullptr;
+    if (length > STREAM_BUF_SIZE) {
+        a = (uint8_t*)heap_caps_malloc(STREAM_BUF_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+        b = (uint8_t*)heap_caps_malloc(STREAM_BUF_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    }
+    
+    StreamJob job;
+    job.freeBufs = nullptr;
+    job.fullBufs = nullptr;
+    job.done = nullptr;
+    bool overlapped = false;
+    if (a && b) {
+        job.freeBufs = xSemaphoreCreateCounting(2, 2);
+        job.fullBufs = xSemaphoreCreateCounting(2, 0);
+        job.done = xSemaphoreCreateBinary();
+        if (job.freeBufs && job.fullBufs && job.done) {
+            job.file = &file;
+            job.buf[0] = a;
+            job.buf[1] = b;
+            job.pos = pos;
+            job.left = length;
+            job.stop = false;
+            overlapped = xTaskCreatePinnedToCore(streamReadTask, "sdStream", 4096, &job, 1, NULL, 0) == pdPASS;
+        }
+    }
+    
+    bool ok = true;
+    if (overlapped) {
+        uint32_t sent = 0;
+        int i = 0;
+        while (sent < length) {
+            xSemaphoreTake(job.fullBufs, portMAX_DELAY);
+            size_t n = job.len[i];
+            if (n == 0 || client.write(job.buf[i], n) != n) {
+                ok = false;
+                break;
+            }
+            sent += n;
+            xSemaphoreGive(job.freeBufs);
+            i ^= 1;
+        }
+        if (!ok) {
+            job.stop = true;
+            xSemaphoreGive(job.freeBufs);  // Wake the reader if it's waiting
+        }
+        xSemaphoreTake(job.done, portMAX_DELAY);
+    } else {
+        // Whatever we got, or a small buffer if that was nothing
+        uint8_t* buf = a ? a : b;
+        size_t bufSize = STREAM_BUF_SIZE;
+        uint8_t* own = nullptr;
+        if (!buf) {
+            own = (uint8_t*)heap_caps_malloc(STREAM_BUF_FALLBACK, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+            buf = own;
+            bufSize = STREAM_BUF_FALLBACK;
+        }
+        ok = buf && streamFileSimple(client, file, pos, length, buf, bufSize);
+        if (own) heap_caps_free(own);
+    }
+    
+    if (job.freeBufs) vSemaphoreDelete(job.freeBufs);
+    if (job.fullBufs) vSemaphoreDelete(job.fullBufs);
+    if (job.done) vSemaphoreDelete(job.done);
+    if (a) heap_caps_free(a);
+    if (b) heap_caps_free(b);
+    return ok;
 }
 
 void FileServer::handleDownload() {
@@ -1117,10 +1661,7 @@ void FileServer::handleDownload() {
     
     // ZIP download of folder
     if (!dir.isEmpty()) {
-        // Simple implementation: send files one by one is not possible
-        // Instead, we'll create a simple text manifest for now
-        // Full ZIP requires external library
-        server->send(501, "text/plain", "ZIP download not yet implemented - download files individually");
+        streamFolderZip(dir);
         return;
     }
     
@@ -1155,9 +1696,65 @@ void FileServer::handleDownload() {
     else if (path.endsWith(".json")) contentType = "application/json";
     else if (path.endsWith(".pcap")) contentType = "application/vnd.tcpdump.pcap";
     
+    uint32_t size = file.size();
+    char etag[HTTP_ETAG_SIZE];
+    makeEtag(etag, sizeof(etag), size, (uint32_t)file.getLastWrite());
+    server->sendHeader("Accept-Ranges", "bytes");
+    server->sendHeader("ETag", etag);
+    
+    if (etagListMatches(server->header("If-None-Match").c_str(), etag)) {
+        file.close();
+        server->send(304, contentType, "");
+        return;
+    }
+    
+    // Resume: a Range only counts while If-Range (if any) still matches
+    int code = 200;
+    uint32_t start = 0;
+    uint32_t end = size ? size - 1 : 0;
+    String range = server->header("Range");
+    if (!range.isEmpty() && ifRangeAllows(server->header("If-Range").c_str(), etag)) {
+        RangeResult r = parseRange(range.c_str(), size, start, end);
+        if (r == RangeResult::UNSATISFIABLE) {
+            file.close();
+            server->sendHeader("Content-Range", "bytes */" + String((unsigned long)size));
+            server->send(416, "text/plain", "Range not satisfiable");
+            return;
+        }
+        if (r == RangeResult::PARTIAL) {
+            code = 206;
+            char contentRange[48];
+            snprintf(contentRange, sizeof(contentRange), "bytes %lu-%lu/%lu",
+                     (unsigned long)start, (unsigned long)end, (unsigned long)size);
+            server->sendHeader("Content-Range", contentRange);
+        }
+    }
+    uint32_t length = size ? end - start + 1 : 0;
+    
+    if (start > 0 && !file.seek(start)) {
+        file.close();
+        server->send(500, "text/plain", "Seek failed");
+        return;
+    }
+    
     server->sendHeader("Content-Disposition", "attachment; filename=\"" + filename + "\"");
-    server->streamFile(file, contentType);
+    server->setContentLength(length);
+    server->send(code, contentType, "");
+    
+    WiFiClient client = server->client();
+    uint32_t startMs = millis();
+    bool ok = streamFileRange(client, file, start, length);
     file.close();
+    
+    uint32_t elapsed = millis() - startMs;
+    if (!ok) {
+        client.stop();
+        Serial.printf("[FILESERVER] Download of %s cut short\n", path.c_str());
+    } else if (length >= STREAM_BUF_SIZE * 4) {
+        Serial.printf("[FILESERVER] Sent %lu bytes of %s in %lu ms (%lu KB/s)\n", (unsigned long)length,
+                      path.c_str(), (unsigned long)elapsed,
+                      (unsigned long)(elapsed ? (uint64_t)length / elapsed : 0));
+    }
 }
 
 void FileServer::handleUpload() {
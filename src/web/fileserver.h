@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <WebServer.h>
 #include <WiFi.h>
+#include <FS.h>
 
 enum class FileServerState {
     IDLE,
@@ -51,10 +52,13 @@ private:
     static void handleBulkDelete();
     static void handleMkdir();
     static void handleSDInfo();
+    static void handlePerf();
     static void handleRename();
     static void handleCopy();
     static void handleMove();
     static void handleNotFound();
+    static void streamFolderZip(const String& dir);
+    static bool streamFileRange(WiFiClient& client, File& file, uint32_t pos, uint32_t length);
     
     // File operation helpers
     static bool deletePathRecursive(const String& path);
@@ -0,0 +1,536 @@
+// GZIP Stream - bounded-memory gzip encoder for uploads
+// Deflate (RFC 1951) in a gzip wrapper (RFC 1952), pushed through a sink
+// as it's produced. An 8KB window, lazy hash-chain matching and a
+// dynamic (or fixed, whichever is smaller) Huffman block per 2048
+// symbols: about a quarter of zlib's memory, and on WiGLE CSV a ratio
+// between zlib -1 and -6. No stored blocks, so random data grows ~3%.
+// All state lives in the object (~54KB) - allocate it, don't stack it.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "../core/crc32.h"
+
+class GzipStream {
+public:
+    // Called with each run of output. Return false to abort the stream.
+    typedef bool (*Sink)(const uint8_t* data, size_t len, void* ctx);
+
+    static const size_t WINDOW = 8192;  // Power of two, <= 32768
+
+    void begin(Sink outSink, void* outCtx) {
+        sink = outSink;
+        ctx = outCtx;
+        failed = false;
+        crc = 0;
+        inBytes = 0;
+        outBytes = 0;
+        outLen = 0;
+        bitBuf = 0;
+        bitCount = 0;
+        pos = 0;
+        end = 0;
+        symCount = 0;
+        memset(head, 0, sizeof(head));
+        memset(prev, 0, sizeof(prev));
+        memset(litFreq, 0, sizeof(litFreq));
+        memset(distFreq, 0, sizeof(distFreq));
+        buildSymbolTables();
+
+        // Fixed header: deflate, no name, no mtime, unknown OS
+        static const uint8_t HEADER[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+        for (size_t i = 0; i < sizeof(HEADER); i++) putByte(HEADER[i]);
+    }
+
+    bool write(const uint8_t* data, size_t len) {
+        crc = crc32Update(crc, data, len);
+        inBytes += len;
+        while (len > 0 && !failed) {
+            size_t room = sizeof(win) - end;
+            size_t n = len < room ? len : room;
+            memcpy(win + end, data, n);
+            end += n;
+            data += n;
+            len -= n;
+            if (end == sizeof(win)) {
+                compress(false);
+                slide();
+            }
+        }
+        return !failed;
+    }
+
+    // Final block and trailer. The stream is done after this.
+    bool finish() {
+        compress(true);
+        emitBlock(true);
+        if (bitCount > 0) putBits(0, 8 - bitCount);  // Byte-align
+        for (int i = 0; i < 4; i++) putByte((uint8_t)(crc >> (8 * i)));
+        for (int i = 0; i < 4; i++) putByte((uint8_t)(inBytes >> (8 * i)));
+        flushOut();
+        return !failed;
+    }
+
+    uint32_t bytesIn() const { return inBytes; }
+    uint32_t bytesOut() const { return outBytes + outLen; }
+
+private:
+    static const int HASH_BITS = 12;
+    static const size_t HASH_SIZE = 1 << HASH_BITS;
+    static const size_t MIN_MATCH = 3;
+    static const size_t MAX_MATCH = 258;
+    static const size_t MIN_LOOKAHEAD = MAX_MATCH + MIN_MATCH + 1;
+    static const size_t MAX_DIST = WINDOW - MIN_LOOKAHEAD;  // Survives a slide
+    static const int MAX_CHAIN = 24;        // Candidates tried per position
+    static const size_t NICE_MATCH = 64;    // Good enough: stop looking
+    static const size_t INSERT_MAX = 32;    // Longer matches aren't hashed inside
+    static const size_t LAZY_MAX = 32;      // Longer matches are taken as they are
+    static const size_t SYM_MAX = 2048;     // Symbols per block
+    static const int LIT_CODES = 286;
+    static const int DIST_CODES = 30;
+    static const int CL_CODES = 19;
+
+    static_assert((WINDOW & (WINDOW - 1)) == 0 && WINDOW <= 32768, "window must be a power of two <= 32K");
+
+    Sink sink;
+    void* ctx;
+    bool failed;
+    uint32_t crc;
+    uint32_t inBytes;
+    uint32_t outBytes;
+
+    uint8_t win[2 * WINDOW];
+    size_t pos;                 // Next byte to encode
+    size_t end;                 // End of buffered input
+    uint16_t head[HASH_SIZE];   // Latest position + 1 per hash, 0 = none
+    uint16_t prev[WINDOW];      // Previous position + 1 with the same hash
+
+    uint8_t sym[SYM_MAX * 3];   // dist lo, dist hi, literal or length - 3
+    size_t symCount;
+    uint16_t litFreq[LIT_CODES];
+    uint16_t distFreq[DIST_CODES];
+    uint8_t lenSym[256];        // length - 3 -> length code - 257
+    uint8_t distSym[256 + (WINDOW >> 7)];  // dist - 1 (< 256) or 256 + ((dist - 1) >> 7)
+
+    uint16_t litCode[288];
+    uint8_t litLen[288];
+    uint16_t distCode[DIST_CODES];
+    uint8_t distLen[DIST_CODES];
+
+    uint16_t hOrder[288];       // Huffman construction scratch
+    uint32_t hWeight[2 * 288];
+    uint16_t hParent[2 * 288];
+
+    uint32_t bitBuf;
+    int bitCount;
+    uint8_t out[1024];          // One sink call per ~1KB (a TLS record each)
+    size_t outLen;
+
+    static const uint16_t* lenBase() {
+        static const uint16_t T[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                       35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        return T;
+    }
+    static const uint8_t* lenExtra() {
+        static const uint8_t T[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        return T;
+    }
+    static const uint16_t* distBase() {
+        static const uint16_t T[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                       257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                       8193, 12289, 16385, 24577};
+        return T;
+    }
+    static const uint8_t* distExtra() {
+        static const uint8_t T[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                      7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        return T;
+    }
+
+    void buildSymbolTables() {
+        for (int c = 0; c < 29; c++) {
+            int span = 1 << lenExtra()[c];  // 258 is in 27's span too: 28 wins
+            for (int i = 0; i < span; i++) {
+                int len = lenBase()[c] + i;
+                if (len - 3 < 256) lenSym[len - 3] = (uint8_t)c;
+            }
+        }
+        for (int c = 0; c < DIST_CODES && distBase()[c] <= MAX_DIST; c++) {
+            for (int d = distBase()[c]; d < distBase()[c] + (1 << distExtra()[c]) && d <= (int)MAX_DIST; d++) {
+                if (d - 1 < 256) distSym[d - 1] = (uint8_t)c;
+                else distSym[256 + ((d - 1) >> 7)] = (uint8_t)c;
+            }
+        }
+    }
+
+    // ---- Output ----
+
+    void flushOut() {
+        if (outLen == 0) return;
+        if (!failed && !sink(out, outLen, ctx)) failed = true;
+        outBytes += outLen;
+        outLen = 0;
+    }
+
+    void putByte(uint8_t b) {
+        out[outLen++] = b;
+        if (outLen == sizeof(out)) flushOut();
+    }
+
+    // n <= 16
+    void putBits(uint32_t value, int n) {
+        bitBuf |= value << bitCount;
+        bitCount += n;
+        while (bitCount >= 8) {
+            putByte((uint8_t)bitBuf);
+            bitBuf >>= 8;
+            bitCount -= 8;
+        }
+    }
+
+    // ---- Matching ----
+
+    uint32_t hashAt(size_t p) const {
+        uint32_t v = ((uint32_t)win[p] << 16) | ((uint32_t)win[p + 1] << 8) | win[p + 2];
+        return (v * 0x9E3779B1u) >> (32 - HASH_BITS);
+    }
+
+    void insert(size_t p) {
+        uint32_t h = hashAt(p);
+        prev[p & (WINDOW - 1)] = head[h];
+        head[h] = (uint16_t)(p + 1);
+    }
+
+    // Longest earlier match for p (inserting p). 0 if under MIN_MATCH.
+    size_t findMatch(size_t p, size_t& dist) {
+        size_t limit = end - p < MAX_MATCH ? end - p : MAX_MATCH;
+        uint32_t h = hashAt(p);
+        size_t cand = head[h];
+        prev[p & (WINDOW - 1)] = head[h];
+        head[h] = (uint16_t)(p + 1);
+
+        size_t best = 0;
+        for (int chain = 0; cand != 0 && chain < MAX_CHAIN; chain++) {
+            size_t c = cand - 1;
+            if (c >= p || p - c > MAX_DIST) break;
+            if (win[c + best] == win[p + best] && win[c] == win[p]) {
+                size_t n = 0;
+                while (n < limit && win[c + n] == win[p + n]) n++;
+                if (n > best) {
+                    best = n;
+                    dist = p - c;
+                    if (n >= NICE_MATCH || n == limit) break;
+                }
+            }
+            cand = prev[c & (WINDOW - 1)];
+        }
+        return best >= MIN_MATCH ? best : 0;
+    }
+
+    // Encode buffered input, keeping MIN_LOOKAHEAD back unless flushing.
+    // Lazy matching: a short match is put off by a literal while the next
+    // position has a longer one.
+    void compress(bool flush) {
+        while (!failed) {
+            size_t ahead = end - pos;
+            if (ahead == 0 || (!flush && ahead < MIN_LOOKAHEAD)) break;
+
+            size_t dist = 0;
+            size_t len = ahead >= MIN_MATCH ? findMatch(pos, dist) : 0;
+            if (len == 0) {
+                recordLiteral(win[pos]);
+                pos++;
+                if (symCount == SYM_MAX) emitBlock(false);
+                continue;
+            }
+
+            size_t hashed = 1;  // Positions of this match already in the chains
+            while (len < LAZY_MAX && pos + 1 + MIN_MATCH <= end) {
+                size_t nextDist = 0;
+                size_t nextLen = findMatch(pos + 1, nextDist);
+                if (nextLen <= len) {
+                    hashed = 2;
+                    break;
+                }
+                recordLiteral(win[pos]);
+                pos++;
+                if (symCount == SYM_MAX) emitBlock(false);
+                len = nextLen;
+                dist = nextDist;
+            }
+
+            recordMatch(len, dist);
+            if (len <= INSERT_MAX) {
+                for (size_t i = hashed; i < len && pos + i + MIN_MATCH <= end; i++) insert(pos + i);
+            }
+            pos += len;
+            if (symCount == SYM_MAX) emitBlock(false);
+        }
+    }
+
+    // Drop the older half of the window
+    void slide() {
+        memmove(win, win + WINDOW, WINDOW);
+        pos -= WINDOW;
+        end -= WINDOW;
+        for (size_t i = 0; i < HASH_SIZE; i++) head[i] = head[i] > WINDOW ? head[i] - WINDOW : 0;
+        for (size_t i = 0; i < WINDOW; i++) prev[i] = prev[i] > WINDOW ? prev[i] - WINDOW : 0;
+    }
+
+    void recordLiteral(uint8_t b) {
+        uint8_t* s = sym + symCount++ * 3;
+        s[0] = 0;
+        s[1] = 0;
+        s[2] = b;
+        litFreq[b]++;
+    }
+
+    void recordMatch(size_t len, size_t dist) {
+        uint8_t* s = sym + symCount++ * 3;
+        s[0] = (uint8_t)dist;
+        s[1] = (uint8_t)(dist >> 8);
+        s[2] = (uint8_t)(len - MIN_MATCH);
+        litFreq[257 + lenSym[len - MIN_MATCH]]++;
+        distFreq[distCode_(dist)]++;
+    }
+
+    uint8_t distCode_(size_t dist) const {
+        return dist - 1 < 256 ? distSym[dist - 1] : distSym[256 + ((dist - 1) >> 7)];
+    }
+
+    // ---- Huffman ----
+
+    static uint16_t reverseBits(uint16_t code, int len) {
+        uint16_t r = 0;
+        for (int i = 0; i < len; i++) {
+            r = (uint16_t)((r << 1) | (code & 1));
+            code >>= 1;
+        }
+        return r;
+    }
+
+    // Length-limited code lengths for freq[0..n). Huffman depths from the
+    // two-queue method, then anything over maxLen is folded back in by
+    // fixing up the Kraft sum (as miniz does).
+    void buildLengths(const uint16_t* freq, int n, uint8_t* lens, int maxLen) {
+        uint16_t* order = hOrder;
+        uint32_t* weight = hWeight;
+        uint16_t* parent = hParent;
+        int count = 0;
+        memset(lens, 0, n);
+        for (int i = 0; i < n; i++) {
+            if (freq[i] == 0) continue;
+            // Insertion sort by frequency, ascending
+            int j = count++;
+            while (j > 0 && freq[order[j - 1]] > freq[i]) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = (uint16_t)i;
+        }
+        if (count == 0) return;
+        if (count == 1) {
+            lens[order[0]] = 1;
+            return;
+        }
+
+        for (int i = 0; i < count; i++) weight[i] = freq[order[i]];
+        int leaf = 0, node = count, next = count;
+        for (int k = 0; k < count - 1; k++) {
+            int pick[2];
+            for (int t = 0; t < 2; t++) {
+                if (leaf < count && (node >= next || weight[leaf] <= weight[node])) pick[t] = leaf++;
+                else pick[t] = node++;
+            }
+            weight[next] = weight[pick[0]] + weight[pick[1]];
+            parent[pick[0]] = parent[pick[1]] = (uint16_t)next;
+            next++;
+        }
+        // Parents come after children: turn parent links into depths in place
+        uint16_t* depth = parent;
+        depth[next - 1] = 0;
+        for (int i = next - 2; i >= 0; i--) depth[i] = depth[parent[i]] + 1;
+
+        uint32_t perLen[32] = {0};
+        for (int i = 0; i < count; i++) perLen[depth[i] > maxLen ? maxLen : depth[i]]++;
+        uint32_t total = 0;
+        for (int l = 1; l <= maxLen; l++) total += perLen[l] << (maxLen - l);
+        while (total != (1u << maxLen)) {
+            perLen[maxLen]--;
+            for (int l = maxLen - 1; l > 0; l--) {
+                if (perLen[l]) {
+                    perLen[l]--;
+                    perLen[l + 1] += 2;
+                    break;
+                }
+            }
+            total--;
+        }
+
+        // Rarest symbols get the longest codes
+        int idx = 0;
+        for (int l = maxLen; l > 0; l--) {
+            for (uint32_t k = 0; k < perLen[l]; k++) lens[order[idx++]] = (uint8_t)l;
+        }
+    }
+
+    static void buildCodes(const uint8_t* lens, int n, uint16_t* codes) {
+        uint16_t perLen[16] = {0};
+        uint16_t nextCode[16];
+        for (int i = 0; i < n; i++) perLen[lens[i]]++;
+        perLen[0] = 0;
+        uint16_t code = 0;
+        for (int l = 1; l < 16; l++) {
+            code = (uint16_t)((code + perLen[l - 1]) << 1);
+            nextCode[l] = code;
+        }
+        for (int i = 0; i < n; i++) {
+            if (lens[i]) codes[i] = reverseBits(nextCode[lens[i]]++, lens[i]);
+        }
+    }
+
+    static void padToTwoCodes(uint16_t* freq, int n) {
+        int used = 0;
+        for (int i = 0; i < n; i++) used += freq[i] ? 1 : 0;
+        for (int i = 0; used < 2 && i < n; i++) {
+            if (freq[i] == 0) {
+                freq[i] = 1;
+                used++;
+            }
+        }
+    }
+
+    // Huffman bits of this block's symbols (extra bits are the same either way)
+    uint32_t symbolBits(const uint8_t* ll, const uint8_t* dl) const {
+        uint32_t bits = 0;
+        for (int i = 0; i < LIT_CODES; i++) bits += (uint32_t)litFreq[i] * ll[i];
+        for (int i = 0; i < DIST_CODES; i++) bits += (uint32_t)distFreq[i] * dl[i];
+        return bits;
+    }
+
+    void emitBlock(bool final) {
+        litFreq[256] = 1;  // End of block
+
+        // Fixed code lengths
+        uint8_t fixedLit[288];
+        uint8_t fixedDist[DIST_CODES];
+        for (int i = 0; i < 288; i++) fixedLit[i] = i < 144 ? 8 : (i < 256 ? 9 : (i < 280 ? 7 : 8));
+        memset(fixedDist, 5, sizeof(fixedDist));
+
+        // Dynamic: inflaters want two codes in each tree, so pad rare cases
+        uint16_t lf[LIT_CODES];
+        uint16_t df[DIST_CODES];
+        memcpy(lf, litFreq, sizeof(lf));
+        memcpy(df, distFreq, sizeof(df));
+        padToTwoCodes(lf, LIT_CODES);
+        padToTwoCodes(df, DIST_CODES);
+        uint8_t dynLit[288] = {0};
+        uint8_t dynDist[DIST_CODES];
+        buildLengths(lf, LIT_CODES, dynLit, 15);
+        buildLengths(df, DIST_CODES, dynDist, 15);
+
+        int hlit = LIT_CODES;
+        while (hlit > 257 && dynLit[hlit - 1] == 0) hlit--;
+        int hdist = DIST_CODES;
+        while (hdist > 1 && dynDist[hdist - 1] == 0) hdist--;
+
+        // Run-length code the lengths (16 = repeat, 17/18 = zeros)
+        uint8_t all[LIT_CODES + DIST_CODES];
+        memcpy(all, dynLit, hlit);
+        memcpy(all + hlit, dynDist, hdist);
+        int total = hlit + hdist;
+        uint8_t rle[LIT_CODES + DIST_CODES];
+        uint8_t rleExtra[LIT_CODES + DIST_CODES];
+        int rleCount = 0;
+        uint16_t clFreq[CL_CODES] = {0};
+        for (int i = 0; i < total; ) {
+            uint8_t v = all[i];
+            int run = 1;
+            while (i + run < total && all[i + run] == v) run++;
+            i += run;
+            if (v == 0) {
+                while (run >= 11) {
+                    int n = run > 138 ? 138 : run;
+                    rle[rleCount] = 18; rleExtra[rleCount++] = (uint8_t)(n - 11); clFreq[18]++;
+                    run -= n;
+                }
+                if (run >= 3) {
+                    rle[rleCount] = 17; rleExtra[rleCount++] = (uint8_t)(run - 3); clFreq[17]++;
+                    run = 0;
+                }
+            } else {
+                rle[rleCount] = v; rleExtra[rleCount++] = 0; clFreq[v]++;
+                run--;
+                while (run >= 3) {
+                    int n = run > 6 ? 6 : run;
+                    rle[rleCount] = 16; rleExtra[rleCount++] = (uint8_t)(n - 3); clFreq[16]++;
+                    run -= n;
+                }
+            }
+            while (run-- > 0) {
+                rle[rleCount] = v; rleExtra[rleCount++] = 0; clFreq[v]++;
+            }
+        }
+
+        static const uint8_t CL_ORDER[CL_CODES] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        uint8_t clLen[CL_CODES];
+        uint16_t clCode[CL_CODES];
+        buildLengths(clFreq, CL_CODES, clLen, 7);
+        buildCodes(clLen, CL_CODES, clCode);
+        int hclen = CL_CODES;
+        while (hclen > 4 && clLen[CL_ORDER[hclen - 1]] == 0) hclen--;
+
+        uint32_t dynBits = 14 + 3 * hclen + symbolBits(dynLit, dynDist);
+        for (int i = 0; i < rleCount; i++) {
+            dynBits += clLen[rle[i]] + (rle[i] == 16 ? 2 : rle[i] == 17 ? 3 : rle[i] == 18 ? 7 : 0);
+        }
+        uint32_t fixedBits = symbolBits(fixedLit, fixedDist);
+
+        putBits(final ? 1 : 0, 1);
+        if (fixedBits <= dynBits) {
+            putBits(1, 2);
+            memcpy(litLen, fixedLit, sizeof(litLen));
+            memcpy(distLen, fixedDist, sizeof(distLen));
+            buildCodes(litLen, 288, litCode);
+        } else {
+            putBits(2, 2);
+            putBits(hlit - 257, 5);
+            putBits(hdist - 1, 5);
+            putBits(hclen - 4, 4);
+            for (int i = 0; i < hclen; i++) putBits(clLen[CL_ORDER[i]], 3);
+            for (int i = 0; i < rleCount; i++) {
+                putBits(clCode[rle[i]], clLen[rle[i]]);
+                if (rle[i] == 16) putBits(rleExtra[i], 2);
+                else if (rle[i] == 17) putBits(rleExtra[i], 3);
+                else if (rle[i] == 18) putBits(rleExtra[i], 7);
+            }
+            memset(litLen, 0, sizeof(litLen));
+            memcpy(litLen, dynLit, LIT_CODES);
+            memcpy(distLen, dynDist, sizeof(distLen));
+            buildCodes(litLen, LIT_CODES, litCode);
+        }
+        buildCodes(distLen, DIST_CODES, distCode);
+
+        for (size_t i = 0; i < symCount; i++) {
+            const uint8_t* s = sym + i * 3;
+            size_t dist = s[0] | (s[1] << 8);
+            if (dist == 0) {
+                putBits(litCode[s[2]], litLen[s[2]]);
+                continue;
+            }
+            int lc = lenSym[s[2]];
+            putBits(litCode[257 + lc], litLen[257 + lc]);
+            if (lenExtra()[lc]) putBits(s[2] + MIN_MATCH - lenBase()[lc], lenExtra()[lc]);
+            int dc = distCode_(dist);
+            putBits(distCode[dc], distLen[dc]);
+            if (distExtra()[dc]) putBits((uint32_t)(dist - distBase()[dc]), distExtra()[dc]);
+        }
+        putBits(litCode[256], litLen[256]);
+
+        symCount = 0;
+        memset(litFreq, 0, sizeof(litFreq));
+        memset(distFreq, 0, sizeof(distFreq));
+    }
+};
@@ -0,0 +1,117 @@
+// HTTP Range - byte ranges, ETags and read sizing for file downloads
+// Pure logic, no WebServer. One range per request: a multi-range header
+// is ignored and the whole file sent, which RFC 9110 allows.
+#pragma once
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <strings.h>
+
+static const uint32_t HTTP_SECTOR_SIZE = 512;  // SD/FAT sector
+
+enum class RangeResult : uint8_t {
+    NONE,           // No usable Range: send 200 with everything
+    PARTIAL,        // Send 206 with [start, end]
+    UNSATISFIABLE   // Send 416
+};
+
+// Parses one non-negative decimal; false on no digits. Saturates far
+// past any FAT file size instead of wrapping.
+inline bool rangeNumber(const char*& p, uint64_t& out) {
+    if (*p < '0' || *p > '9') return false;
+    out = 0;
+    while (*p >= '0' && *p <= '9') {
+        if (out < (1ull << 40)) out = out * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+    return true;
+}
+
+// Range header value ("bytes=0-99", "bytes=100-", "bytes=-500") against a
+// file of `size` bytes. start/end are inclusive and only set on PARTIAL.
+inline RangeResult parseRange(const char* header, uint32_t size, uint32_t& start, uint32_t& end) {
+    if (!header) return RangeResult::NONE;
+    const char* p = header;
+    while (*p == ' ') p++;
+    if (strncasecmp(p, "bytes", 5) != 0) return RangeResult::NONE;
+    p += 5;
+    while (*p == ' ') p++;
+    if (*p++ != '=') return RangeResult::NONE;
+    while (*p == ' ') p++;
+    if (strchr(p, ',')) return RangeResult::NONE;
+
+    uint64_t first = 0, last = 0;
+    bool hasFirst = rangeNumber(p, first);
+    if (*p++ != '-') return RangeResult::NONE;
+    bool hasLast = rangeNumber(p, last);
+    while (*p == ' ') p++;
+    if (*p != '\0' || (!hasFirst && !hasLast)) return RangeResult::NONE;
+
+    if (!hasFirst) {
+        // Suffix: the last `last` bytes
+        if (last == 0 || size == 0) return RangeResult::UNSATISFIABLE;
+        start = last >= size ? 0 : size - (uint32_t)last;
+        end = size - 1;
+        return RangeResult::PARTIAL;
+    }
+    if (hasLast && last < first) return RangeResult::NONE;  // Invalid: ignore it
+    if (first >= size) return RangeResult::UNSATISFIABLE;
+    start = (uint32_t)first;
+    end = (!hasLast || last >= size) ? size - 1 : (uint32_t)last;
+    return RangeResult::PARTIAL;
+}
+
+static const size_t HTTP_ETAG_SIZE = 20;  // "xxxxxxxx-xxxxxxxx" + NUL
+
+// Strong validator from what FAT keeps: "<size>-<mtime>" as fixed-width
+// hex, quoted. Returns its length, 0 if out is under HTTP_ETAG_SIZE.
+inline size_t makeEtag(char* out, size_t cap, uint32_t size, uint32_t mtime) {
+    if (cap < HTTP_ETAG_SIZE) return 0;
+    int n = snprintf(out, HTTP_ETAG_SIZE, "\"%08" PRIx32 "-%08" PRIx32 "\"", size, mtime);
+    return n < 0 || (size_t)n >= HTTP_ETAG_SIZE ? 0 : (size_t)n;
+}
+
+// If-None-Match: "*" or a comma list of tags, W/ prefixes compared weakly
+inline bool etagListMatches(const char* header, const char* etag) {
+    if (!header || !*header) return false;
+    size_t etagLen = strlen(etag);
+    const char* p = header;
+    while (*p) {
+        while (*p == ' ' || *p == ',') p++;
+        if (*p == '*') return true;
+        if (strncmp(p, "W/", 2) == 0) p += 2;
+        const char* tagEnd = p;
+        while (*tagEnd && *tagEnd != ',') tagEnd++;
+        const char* trimmed = tagEnd;
+        while (trimmed > p && trimmed[-1] == ' ') trimmed--;
+        if ((size_t)(trimmed - p) == etagLen && strncmp(p, etag, etagLen) == 0) return true;
+        p = tagEnd;
+    }
+    return false;
+}
+
+// If-Range: the range only applies while the client's copy is current.
+// No header = always; a date (we send no Last-Modified) = never.
+inline bool ifRangeAllows(const char* header, const char* etag) {
+    if (!header || !*header) return true;
+    while (*header == ' ') header++;
+    if (strncmp(header, "W/", 2) == 0) return false;  // Strong comparison only
+    size_t etagLen = strlen(etag);
+    if (strncmp(header, etag, etagLen) != 0) return false;
+    const char* rest = header + etagLen;
+    while (*rest == ' ') rest++;
+    return *rest == '\0';
+}
+
+// How much to read at file offset `pos`: up to bufSize, trimmed so the
+// read after this one starts on a sector boundary (FAT then reads whole
+// sectors straight into the buffer instead of through its sector cache)
+inline size_t alignedReadSize(uint32_t pos, uint32_t left, size_t bufSize) {
+    size_t want = bufSize;
+    uint32_t misalign = pos % HTTP_SECTOR_SIZE;
+    if (misalign != 0 && want > HTTP_SECTOR_SIZE) want -= misalign;
+    return left < want ? left : want;
+}
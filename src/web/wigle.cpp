@@ -6,8 +6,10 @@
 #include <HTTPClient.h>
 #include <SD.h>
 #include <base64.h>
+#include <new>
 #include "../core/config.h"
 #include "../core/sdlog.h"
+#include "gzip_stream.h"
 
 // Static member initialization
 char WiGLE::lastError[64] = "";
@@ -180,6 +182,31 @@ bool WiGLE::hasCredentials() {
 // API Operations
 // ============================================================================
 
+static const size_t UPLOAD_CHUNK_SIZE = 4096;
+
+static bool countSink(const uint8_t*, size_t, void*) {
+    return true;
+}
+
+static bool clientSink(const uint8_t* data, size_t len, void* ctx) {
+    return ((WiFiClientSecure*)ctx)->write(data, len) == len;
+}
+
+// Runs the whole file through the encoder into sink. Used twice per
+// upload: once counting (for Content-Length), once into the socket -
+// the output is deterministic, so both passes produce the same bytes.
+static bool gzipFile(File& file, GzipStream* gz, GzipStream::Sink sink, void* ctx, uint8_t* chunk) {
+    if (!file.seek(0)) return false;
+    gz->begin(sink, ctx);
+    while (file.available()) {
+        size_t bytesRead = file.read(chunk, UPLOAD_CHUNK_SIZE);
+        if (bytesRead == 0) return false;
+        if (!gz->write(chunk, bytesRead)) return false;
+        yield();  // Compressing a big file takes a while
+    }
+    return gz->finish();
+}
+
 bool WiGLE::uploadFile(const char* csvPath) {
     if (!isConnected()) {
         strcpy(lastError, "NOT CONNECTED TO WIFI");
@@ -203,15 +230,53 @@ bool WiGLE::uploadFile(const char* csvPath) {
     }
     
     size_t fileSize = csvFile.size();
+    
+    // Stream file in chunks (4KB at a time) - avoid loading entire file in RAM
+    uint8_t chunk[UPLOAD_CHUNK_SIZE];
+    
+    // TLS needs its buffers before the encoder takes ~54KB of heap
+    WiFiClientSecure client;
+    client.setInsecure();  // Skip certificate validation
+    client.setTimeout(60);  // 60 second timeout for large files
+    
+    strcpy(statusMessage, "CONNECTING...");
+    if (!client.connect(API_HOST, 443)) {
+        strcpy(lastError, "Connection failed");
+        csvFile.close();
+        return false;
+    }
+    
+    // Gzip on the fly when the encoder still fits (WiGLE accepts .csv.gz).
+    // A first pass only counts, so the request keeps a Content-Length.
+    GzipStream* gz = new (std::nothrow) GzipStream();
+    size_t payloadSize = fileSize;
+    if (gz) {
+        strcpy(statusMessage, "COMPRESSING...");
+        if (gzipFile(csvFile, gz, countSink, nullptr, chunk)) {
+            payloadSize = gz->bytesOut();
+            Serial.printf("[WIGLE] Gzip: %d -> %d bytes (%.1fx)\n", fileSize, payloadSize,
+                          payloadSize ? (float)fileSize / payloadSize : 0.0f);
+        } else {
+            Serial.println("[WIGLE] Read error while compressing, sending raw");
+            delete gz;
+            gz = nullptr;
+        }
+        csvFile.seek(0);
+    } else {
+        Serial.println("[WIGLE] No heap for gzip after TLS, sending raw");
+    }
+    
     // WiGLE limit is 180MB, but we'll be more conservative on ESP32
-    if (fileSize > 500000) {  // 500KB limit for ESP32 memory safety
+    if (payloadSize > 500000) {  // 500KB of upload, compressed or not
         strcpy(lastError, "FILE TOO LARGE (>500KB)");
+        delete gz;
         csvFile.close();
+        client.stop();
         return false;
     }
     
     strcpy(statusMessage, "UPLOADING...");
-    Serial.printf("[WIGLE] Uploading %s (%d bytes)\n", csvPath, fileSize);
+    Serial.printf("[WIGLE] Uploading %s (%d bytes)\n", csvPath, payloadSize);
     
     // Build multipart form data boundaries
     String boundary = "----PorkchopWiGLE" + String(millis());
@@ -219,12 +284,17 @@ bool WiGLE::uploadFile(const char* csvPath) {
     
     // Build body parts (headers only, file streamed separately)
     String bodyStart = "--" + boundary + "\r\n";
-    bodyStart += "Content-Disposition: form-data; name=\"file\"; filename=\"" + filename + "\"\r\n";
-    bodyStart += "Content-Type: text/csv\r\n\r\n";
+    if (gz) {
+        bodyStart += "Content-Disposition: form-data; name=\"file\"; filename=\"" + filename + ".gz\"\r\n";
+        bodyStart += "Content-Type: application/gzip\r\n\r\n";
+    } else {
+        bodyStart += "Content-Disposition: form-data; name=\"file\"; filename=\"" + filename + "\"\r\n";
+        bodyStart += "Content-Type: text/csv\r\n\r\n";
+    }
     
     String bodyEnd = "\r\n--" + boundary + "--\r\n";
     
-    size_t contentLength = bodyStart.length() + fileSize + bodyEnd.length();
+    size_t contentLength = bodyStart.length() + payloadSize + bodyEnd.length();
     
     // Build Basic Auth header
     String apiName = Config::wifi().wigleApiName;
@@ -232,16 +302,6 @@ bool WiGLE::uploadFile(const char* csvPath) {
     String credentials = apiName + ":" + apiToken;
     String authHeader = "Basic " + base64::encode(credentials);
     
-    WiFiClientSecure client;
-    client.setInsecure();  // Skip certificate validation
-    client.setTimeout(60);  // 60 second timeout for large files
-    
-    if (!client.connect(API_HOST, 443)) {
-        strcpy(lastError, "Connection failed");
-        csvFile.close();
-        return false;
-    }
-    
     // Send HTTP headers
     client.print("POST " + String(UPLOAD_PATH) + " HTTP/1.1\r\n");
     client.print("Host: " + String(API_HOST) + "\r\n");
@@ -253,41 +313,53 @@ bool WiGLE::uploadFile(const char* csvPath) {
     // Send multipart header
     client.print(bodyStart);
     
-    // Stream file in chunks (4KB at a time) - avoid loading entire file in RAM
-    const size_t CHUNK_SIZE = 4096;
-    uint8_t chunk[CHUNK_SIZE];
-    size_t bytesRemaining = fileSize;
     size_t bytesSent = 0;
     
-    while (bytesRemaining > 0 && csvFile.available()) {
-        size_t toRead = (bytesRemaining > CHUNK_SIZE) ? CHUNK_SIZE : bytesRemaining;
-        size_t bytesRead = csvFile.read(chunk, toRead);
-        
-        if (bytesRead == 0) {
-            Serial.println("[WIGLE] Read error during upload");
-            break;
-        }
-        
-        size_t written = client.write(chunk, bytesRead);
-        if (written != bytesRead) {
-            Serial.printf("[WIGLE] Write error: %d of %d bytes\n", written, bytesRead);
-            strcpy(lastError, "WRITE ERROR");
+    if (gz) {
+        bool ok = gzipFile(csvFile, gz, clientSink, &client, chunk);
+        bytesSent = gz->bytesOut();
+        delete gz;
+        if (!ok || bytesSent != payloadSize) {
+            // Content-Length is already out: the request can't be finished
+            Serial.printf("[WIGLE] Compressed upload failed: %d of %d bytes\n", bytesSent, payloadSize);
+            strcpy(lastError, ok ? "FILE CHANGED DURING UPLOAD" : "WRITE ERROR");
             csvFile.close();
             client.stop();
             return false;
         }
+    } else {
+        size_t bytesRemaining = fileSize;
         
-        bytesSent += bytesRead;
-        bytesRemaining -= bytesRead;
-        
-        // Yield to prevent watchdog timeout on large files
-        yield();
+        while (bytesRemaining > 0 && csvFile.available()) {
+            size_t toRead = (bytesRemaining > UPLOAD_CHUNK_SIZE) ? UPLOAD_CHUNK_SIZE : bytesRemaining;
+            size_t bytesRead = csvFile.read(chunk, toRead);
+            
+            if (bytesRead == 0) {
+                Serial.println("[WIGLE] Read error during upload");
+                break;
+            }
+            
+            size_t written = client.write(chunk, bytesRead);
+            if (written != bytesRead) {
+                Serial.printf("[WIGLE] Write error: %d of %d bytes\n", written, bytesRead);
+                strcpy(lastError, "WRITE ERROR");
+                csvFile.close();
+                client.stop();
+                return false;
+            }
+            
+            bytesSent += bytesRead;
+            bytesRemaining -= bytesRead;
+            
+            // Yield to prevent watchdog timeout on large files
+            yield();
+        }
     }
     
     csvFile.close();
     
-    if (bytesSent != fileSize) {
-        Serial.printf("[WIGLE] Incomplete upload: %d of %d bytes\n", bytesSent, fileSize);
+    if (bytesSent != payloadSize) {
+        Serial.printf("[WIGLE] Incomplete upload: %d of %d bytes\n", bytesSent, payloadSize);
         strcpy(lastError, "INCOMPLETE UPLOAD");
         client.stop();
         return false;
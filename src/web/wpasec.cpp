@@ -12,13 +12,20 @@
 bool WPASec::cacheLoaded = false;
 char WPASec::lastError[64] = "";
 char WPASec::statusMessage[64] = "READY";
-std::map<String, WPASec::CacheEntry> WPASec::crackedCache;
-std::map<String, bool> WPASec::uploadedCache;
+File WPASec::indexFile;
+WpaSecIndexReader WPASec::index;
+uint32_t WPASec::crackedCount = 0;
+WpaSecRecord* WPASec::pending = nullptr;
+uint32_t WPASec::pendingCount = 0;
+File WPASec::stringsOut;
 
 void WPASec::init() {
+    flushPending();
+    closeIndex();
+    free(pending);
+    pending = nullptr;
+    pendingCount = 0;
     cacheLoaded = false;
-    crackedCache.clear();
-    uploadedCache.clear();
     strcpy(lastError, "");
     strcpy(statusMessage, "READY");
 }
@@ -80,122 +87,258 @@ bool WPASec::isConnected() {
 }
 
 // ============================================================================
-// BSSID Normalization
+// Results Index
 // ============================================================================
 
-String WPASec::normalizeBSSID(const char* bssid) {
-    // Remove colons/dashes, convert to uppercase
-    String result;
-    for (int i = 0; bssid[i]; i++) {
-        char c = bssid[i];
-        if (c != ':' && c != '-') {
-            result += (char)toupper(c);
+bool WPASec::readIndexAt(uint32_t offset, uint8_t* buf, size_t len, void* ctx) {
+    File* f = (File*)ctx;
+    return f->seek(offset) && f->read(buf, len) == len;
+}
+
+bool WPASec::openIndex() {
+    closeIndex();
+    if (!SD.exists(WPASEC_INDEX_FILE)) return false;
+    indexFile = SD.open(WPASEC_INDEX_FILE, FILE_READ);
+    if (!indexFile) return false;
+    
+    WpaSecIndexHeader hdr;
+    bool ok = indexFile.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              hdr.magic == WPASEC_INDEX_MAGIC && hdr.version == WPASEC_INDEX_VERSION &&
+              hdr.recordSize == sizeof(WpaSecRecord) &&
+              indexFile.size() == sizeof(hdr) + (size_t)hdr.count * sizeof(WpaSecRecord);
+    if (!ok) {
+        Serial.println("[WPASEC] Index unreadable, starting fresh");
+        closeIndex();
+        SD.remove(WPASEC_INDEX_FILE);
+        return false;
+    }
+    
+    index.attach(readIndexAt, &indexFile, hdr.count);
+    crackedCount = hdr.cracked;
+    return true;
+}
+
+void WPASec::closeIndex() {
+    index.detach();
+    if (indexFile) indexFile.close();
+    crackedCount = 0;
+}
+
+bool WPASec::lookupKey(const uint8_t* bssid, WpaSecRecord& out) {
+    bool found = index.find(bssid, out);
+    // Not yet merged: newer than anything on SD
+    uint32_t pos = pending ? wpasecLowerBound(pending, pendingCount, bssid) : 0;
+    if (pending && pos < pendingCount && memcmp(pending[pos].bssid, bssid, 6) == 0) {
+        if (found) {
+            wpasecCombine(out, pending[pos]);
+        } else {
+            out = pending[pos];
         }
+        found = true;
     }
-    return result;
+    return found;
 }
 
-// ============================================================================
-// Cache Management
-// ============================================================================
+bool WPASec::lookup(const char* bssid, WpaSecRecord& out) {
+    uint8_t key[6];
+    if (!bssid || !wpasecParseBssid(bssid, strlen(bssid), key)) return false;
+    loadCache();
+    return lookupKey(key, out);
+}
 
-bool WPASec::loadCache() {
-    if (cacheLoaded) return true;
-    
-    crackedCache.clear();
-    
-    if (!SD.exists(CACHE_FILE)) {
-        cacheLoaded = true;
-        return true;  // No cache yet, that's OK
+// Queue a record for the next merge. A crack's strings go straight to the
+// blob; a later crack for the same BSSID just points somewhere newer.
+bool WPASec::addRecord(const uint8_t* bssid, uint8_t flags, const char* ssid, size_t ssidLen,
+                       const char* pass, size_t passLen) {
+    if (!pending) {
+        pending = (WpaSecRecord*)malloc(PENDING_MAX * sizeof(WpaSecRecord));
+        if (!pending) {
+            strcpy(lastError, "OUT OF MEMORY");
+            return false;
+        }
+        pendingCount = 0;
     }
     
-    File f = SD.open(CACHE_FILE, FILE_READ);
-    if (!f) {
-        strcpy(lastError, "CANNOT OPEN CACHE");
-        return false;
+    WpaSecRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    memcpy(rec.bssid, bssid, 6);
+    rec.flags = flags;
+    if (flags & WPASEC_FLAG_CRACKED) rec.strHash = wpasecStringHash(ssid, ssidLen, pass, passLen);
+    
+    // Already known as is (every fetch returns the whole potfile)
+    WpaSecRecord known;
+    if (lookupKey(bssid, known) && (known.flags & flags) == flags &&
+        (!(flags & WPASEC_FLAG_CRACKED) ||
+         (known.strHash == rec.strHash && known.ssidLen == ssidLen && known.passLen == passLen))) {
+        return true;
     }
     
-    // Format: BSSID:SSID:password (one per line)
-    // Cap at 500 entries to prevent memory exhaustion
-    while (f.available() && crackedCache.size() < 500) {
-        String line = f.readStringUntil('\n');
-        line.trim();
-        if (line.isEmpty()) continue;
-        
-        int firstColon = line.indexOf(':');
-        int lastColon = line.lastIndexOf(':');
-        
-        if (firstColon > 0 && lastColon > firstColon) {
-            String bssid = line.substring(0, firstColon);
-            String ssid = line.substring(firstColon + 1, lastColon);
-            String password = line.substring(lastColon + 1);
-            
-            bssid = normalizeBSSID(bssid.c_str());
-            
-            CacheEntry entry;
-            entry.ssid = ssid;
-            entry.password = password;
-            crackedCache[bssid] = entry;
+    if (flags & WPASEC_FLAG_CRACKED) {
+        if (!stringsOut) {
+            stringsOut = SD.open(WPASEC_STRINGS_FILE, FILE_APPEND);
+            if (!stringsOut) {
+                strcpy(lastError, "CANNOT WRITE CACHE");
+                return false;
+            }
+        }
+        rec.strOffset = stringsOut.size();
+        rec.ssidLen = (uint8_t)ssidLen;
+        rec.passLen = (uint8_t)passLen;
+        if (stringsOut.write((const uint8_t*)ssid, ssidLen) != ssidLen ||
+            stringsOut.write((const uint8_t*)pass, passLen) != passLen) {
+            strcpy(lastError, "CANNOT WRITE CACHE");
+            return false;
         }
     }
     
-    f.close();
-    cacheLoaded = true;
-    
-    // Also load uploaded list
-    loadUploadedList();
-    
-    Serial.printf("[WPASEC] Cache loaded: %d cracked, %d uploaded\n", 
-                  crackedCache.size(), uploadedCache.size());
+    if (!wpasecBatchInsert(pending, pendingCount, PENDING_MAX, rec)) {
+        if (!flushPending()) return false;
+        wpasecBatchInsert(pending, pendingCount, PENDING_MAX, rec);
+    }
     return true;
 }
 
-bool WPASec::saveCache() {
-    File f = SD.open(CACHE_FILE, FILE_WRITE);
-    if (!f) {
+// Stream the index and the pending batch (both sorted) into a new index,
+// then swap it in. The old file stays intact until the new one is complete.
+bool WPASec::flushPending() {
+    // Strings first: records must never point past the end of the blob
+    if (stringsOut) stringsOut.close();
+    if (!pending || pendingCount == 0) return true;
+    
+    if (SD.exists(INDEX_TMP_FILE)) SD.remove(INDEX_TMP_FILE);
+    File out = SD.open(INDEX_TMP_FILE, FILE_WRITE);
+    if (!out) {
         strcpy(lastError, "CANNOT WRITE CACHE");
         return false;
     }
     
-    for (auto& pair : crackedCache) {
-        f.printf("%s:%s:%s\n", pair.first.c_str(), 
-                 pair.second.ssid.c_str(), pair.second.password.c_str());
+    WpaSecIndexHeader hdr = {WPASEC_INDEX_MAGIC, WPASEC_INDEX_VERSION, sizeof(WpaSecRecord), 0, 0};
+    bool ok = out.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+    
+    WpaSecRecord buf[WPASEC_PAGE_RECORDS];
+    uint32_t buffered = 0;
+    uint32_t diskPos = 0;
+    uint32_t memPos = 0;
+    uint32_t diskCount = index.count();
+    WpaSecRecord disk;
+    bool haveDisk = diskCount > 0 && index.record(0, disk);
+    ok = ok && (diskCount == 0 || haveDisk);
+    
+    while (ok && (haveDisk || memPos < pendingCount)) {
+        WpaSecRecord next;
+        int c = !haveDisk ? 1 : (memPos >= pendingCount ? -1 : memcmp(disk.bssid, pending[memPos].bssid, 6));
+        if (c <= 0) {
+            next = disk;
+            if (c == 0) wpasecCombine(next, pending[memPos++]);
+            haveDisk = ++diskPos < diskCount;
+            if (haveDisk) ok = index.record(diskPos, disk);
+        } else {
+            next = pending[memPos++];
+        }
+        
+        buf[buffered++] = next;
+        hdr.count++;
+        if (next.flags & WPASEC_FLAG_CRACKED) hdr.cracked++;
+        if (buffered == WPASEC_PAGE_RECORDS) {
+            ok = ok && out.write((const uint8_t*)buf, sizeof(buf)) == sizeof(buf);
+            buffered = 0;
+        }
+    }
+    if (ok && buffered > 0) {
+        size_t bytes = buffered * sizeof(WpaSecRecord);
+        ok = out.write((const uint8_t*)buf, bytes) == bytes;
+    }
+    if (ok) {
+        ok = out.seek(0) && out.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
     }
+    out.close();
     
-    f.close();
+    if (!ok) {
+        Serial.println("[WPASEC] Index merge failed");
+        strcpy(lastError, "CANNOT WRITE CACHE");
+        SD.remove(INDEX_TMP_FILE);
+        return false;
+    }
+    
+    closeIndex();
+    SD.remove(WPASEC_INDEX_FILE);
+    SD.rename(INDEX_TMP_FILE, WPASEC_INDEX_FILE);
+    pendingCount = 0;
+    openIndex();
     return true;
 }
 
-bool WPASec::loadUploadedList() {
-    uploadedCache.clear();
+bool WPASec::readStrings(const WpaSecRecord& rec, String* ssid, String* password) {
+    if (!(rec.flags & WPASEC_FLAG_CRACKED)) return false;
+    File f = SD.open(WPASEC_STRINGS_FILE, FILE_READ);
+    if (!f) return false;
     
-    if (!SD.exists(UPLOADED_FILE)) return true;
+    char buf[WPASEC_SSID_MAX + WPASEC_PASS_MAX + 1];
+    size_t len = rec.ssidLen + rec.passLen;
+    bool ok = f.seek(rec.strOffset) && f.read((uint8_t*)buf, len) == len;
+    f.close();
+    if (!ok) return false;
     
-    File f = SD.open(UPLOADED_FILE, FILE_READ);
-    if (!f) return false;
+    buf[len] = '\0';
+    if (password) *password = buf + rec.ssidLen;
+    buf[rec.ssidLen] = '\0';
+    if (ssid) *ssid = buf;
+    return true;
+}
+
+// One-time import of the text cache and upload list older builds kept
+void WPASec::importLegacy() {
+    char line[160];
+    uint32_t imported = 0;
+    
+    File f = SD.open(LEGACY_CACHE_FILE, FILE_READ);
+    if (f) {
+        while (f.available()) {
+            size_t len = f.readBytesUntil('\n', line, sizeof(line) - 1);
+            uint8_t bssid[6];
+            const char* ssid;
+            const char* pass;
+            size_t ssidLen, passLen;
+            if (wpasecParseCacheLine(line, len, bssid, ssid, ssidLen, pass, passLen) &&
+                addRecord(bssid, WPASEC_FLAG_CRACKED | WPASEC_FLAG_UPLOADED, ssid, ssidLen, pass, passLen)) {
+                imported++;
+            }
+        }
+        f.close();
+    }
     
-    // Cap at 500 entries to prevent memory exhaustion
-    while (f.available() && uploadedCache.size() < 500) {
-        String line = f.readStringUntil('\n');
-        line.trim();
-        if (!line.isEmpty()) {
-            uploadedCache[normalizeBSSID(line.c_str())] = true;
+    f = SD.open(LEGACY_UPLOADED_FILE, FILE_READ);
+    if (f) {
+        while (f.available()) {
+            size_t len = f.readBytesUntil('\n', line, sizeof(line) - 1);
+            while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == ' ')) len--;
+            uint8_t bssid[6];
+            if (wpasecParseBssid(line, len, bssid) &&
+                addRecord(bssid, WPASEC_FLAG_UPLOADED, nullptr, 0, nullptr, 0)) {
+                imported++;
+            }
         }
+        f.close();
     }
     
-    f.close();
-    return true;
+    if (flushPending()) {
+        SD.remove(LEGACY_CACHE_FILE);
+        SD.remove(LEGACY_UPLOADED_FILE);
+        Serial.printf("[WPASEC] Imported %lu legacy entries into the index\n", (unsigned long)imported);
+    }
 }
 
-bool WPASec::saveUploadedList() {
-    File f = SD.open(UPLOADED_FILE, FILE_WRITE);
-    if (!f) return false;
+bool WPASec::loadCache() {
+    if (cacheLoaded) return true;
+    cacheLoaded = true;
     
-    for (auto& pair : uploadedCache) {
-        f.println(pair.first);
+    bool haveIndex = openIndex();
+    if (!haveIndex && (SD.exists(LEGACY_CACHE_FILE) || SD.exists(LEGACY_UPLOADED_FILE))) {
+        importLegacy();
     }
     
-    f.close();
+    Serial.printf("[WPASEC] Index: %lu entries, %lu cracked\n",
+                  (unsigned long)index.count(), (unsigned long)crackedCount);
     return true;
 }
 
@@ -204,55 +347,98 @@ bool WPASec::saveUploadedList() {
 // ============================================================================
 
 bool WPASec::isCracked(const char* bssid) {
-    loadCache();
-    String key = normalizeBSSID(bssid);
-    return crackedCache.find(key) != crackedCache.end();
+    WpaSecRecord rec;
+    return lookup(bssid, rec) && (rec.flags & WPASEC_FLAG_CRACKED);
 }
 
 String WPASec::getPassword(const char* bssid) {
-    loadCache();
-    String key = normalizeBSSID(bssid);
-    auto it = crackedCache.find(key);
-    if (it != crackedCache.end()) {
-        return it->second.password;
-    }
-    return "";
+    WpaSecRecord rec;
+    String password;
+    if (lookup(bssid, rec)) readStrings(rec, nullptr, &password);
+    return password;
 }
 
 String WPASec::getSSID(const char* bssid) {
-    loadCache();
-    String key = normalizeBSSID(bssid);
-    auto it = crackedCache.find(key);
-    if (it != crackedCache.end()) {
-        return it->second.ssid;
-    }
-    return "";
+    WpaSecRecord rec;
+    String ssid;
+    if (lookup(bssid, rec)) readStrings(rec, &ssid, nullptr);
+    return ssid;
 }
 
 uint16_t WPASec::getCrackedCount() {
     loadCache();
-    return crackedCache.size();
+    return crackedCount > 0xFFFF ? 0xFFFF : (uint16_t)crackedCount;
 }
 
 bool WPASec::isUploaded(const char* bssid) {
-    loadCache();
-    String key = normalizeBSSID(bssid);
     // Cracked implies uploaded
-    if (crackedCache.find(key) != crackedCache.end()) return true;
-    return uploadedCache.find(key) != uploadedCache.end();
+    WpaSecRecord rec;
+    return lookup(bssid, rec) && (rec.flags & (WPASEC_FLAG_UPLOADED | WPASEC_FLAG_CRACKED));
 }
 
 void WPASec::markUploaded(const char* bssid) {
-    loadCache();
-    String key = normalizeBSSID(bssid);
-    uploadedCache[key] = true;
-    saveUploadedList();
+    uint8_t key[6];
+    if (!bssid || !wpasecParseBssid(bssid, strlen(bssid), key)) return;
+    WpaSecRecord rec;
+    if (lookup(bssid, rec) && (rec.flags & WPASEC_FLAG_UPLOADED)) return;
+    if (addRecord(key, WPASEC_FLAG_UPLOADED, nullptr, 0, nullptr, 0)) flushPending();
 }
 
 // ============================================================================
 // API Operations
 // ============================================================================
 
+// Potfile download in progress
+struct FetchState {
+    uint32_t newCracks;
+    uint32_t known;     // Already in the index unchanged - nothing written
+    bool failed;        // SD trouble: stop taking data
+};
+
+// Print side of a Stream, so HTTPClient::writeToStream can push the body
+// into the parser. Refusing a write (after an SD error) ends the download.
+class PotfileStream : public Stream {
+public:
+    PotfileStream(WpaSecPotParser& p, const bool& stop) : parser(p), failed(stop) {}
+    
+    size_t write(const uint8_t* data, size_t len) override {
+        if (failed) return 0;
+        parser.feed(data, len);
+        return failed ? 0 : len;
+    }
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    
+private:
+    WpaSecPotParser& parser;
+    const bool& failed;
+};
+
+void WPASec::onPotEntry(const uint8_t* bssid, const char* ssid, size_t ssidLen,
+                        const char* pass, size_t passLen, void* ctx) {
+    FetchState* state = (FetchState*)ctx;
+    if (state->failed) return;
+    
+    // Only what's new or changed reaches the index
+    WpaSecRecord known;
+    bool have = lookupKey(bssid, known) && (known.flags & WPASEC_FLAG_CRACKED);
+    if (have && known.passLen == passLen && known.ssidLen == ssidLen &&
+        known.strHash == wpasecStringHash(ssid, ssidLen, pass, passLen)) {
+        state->known++;
+        return;
+    }
+    if (!have) {
+        state->newCracks++;
+        // Don't log password for security
+        Serial.printf("[WPASEC] Found: %.*s\n", (int)ssidLen, ssid);
+    }
+    if (!addRecord(bssid, WPASEC_FLAG_CRACKED | WPASEC_FLAG_UPLOADED, ssid, ssidLen, pass, passLen)) {
+        state->failed = true;
+    }
+}
+
 bool WPASec::fetchResults() {
     if (!isConnected()) {
         strcpy(lastError, "NOT CONNECTED TO WIFI");
@@ -294,87 +480,43 @@ bool WPASec::fetchResults() {
         return false;
     }
     
-    // Parse response: BSSID:SSID:password lines
-    String response = http.getString();
-    http.end();
+    // Parse the potfile as it arrives - never held in RAM. writeToStream
+    // undoes chunked encoding and hands over one TCP buffer at a time.
+    loadCache();
+    FetchState state = {0, 0, false};
+    WpaSecPotParser parser;
+    parser.begin(onPotEntry, &state);
+    PotfileStream sink(parser, state.failed);
     
-    Serial.printf("[WPASEC] Response: %d bytes\n", response.length());
+    uint32_t started = millis();
+    int bodyBytes = http.writeToStream(&sink);
+    http.end();
+    parser.finish();
     
-    int newCracks = 0;
-    int lineStart = 0;
+    Serial.printf("[WPASEC] Response: %d bytes, %lu entries (%lu bad lines) in %lums\n", bodyBytes,
+                  (unsigned long)parser.entries(), (unsigned long)parser.rejected(),
+                  (unsigned long)(millis() - started));
     
-    while (lineStart < (int)response.length()) {
-        int lineEnd = response.indexOf('\n', lineStart);
-        if (lineEnd < 0) lineEnd = response.length();
-        
-        String line = response.substring(lineStart, lineEnd);
-        line.trim();
-        lineStart = lineEnd + 1;
-        
-        if (line.isEmpty()) continue;
-        
-        // Parse WPA-SEC potfile format: BSSID:CLIENT_MAC:SSID:PASSWORD
-        // Example: e848b8f87e98:809d6557b0be:pxs.pl_4586:79768559
-        // BSSID = 12 hex chars (no colons in potfile format)
-        // CLIENT_MAC = 12 hex chars (we ignore this)
-        // SSID = network name (may contain colons)
-        // PASSWORD = after the last colon
-        
-        // Potfile BSSIDs are 12 chars without colons
-        if (line.length() < 28) continue;  // At minimum: 12 + 1 + 12 + 1 + 1 + 1 = 28
-        
-        // Extract BSSID (first 12 chars)
-        String bssid = line.substring(0, 12);
-        
-        // Verify it looks like a hex BSSID
-        bool validBssid = true;
-        for (int i = 0; i < 12; i++) {
-            char c = bssid[i];
-            if (!isxdigit(c)) { validBssid = false; break; }
-        }
-        if (!validBssid) continue;
-        
-        // Check for colon after BSSID
-        if (line[12] != ':') continue;
-        
-        // Skip CLIENT_MAC (next 12 chars after colon)
-        if (line.length() < 26 || line[25] != ':') continue;
-        
-        // Everything after CLIENT_MAC colon is SSID:PASSWORD
-        String ssidAndPass = line.substring(26);
-        
-        // Password is after the LAST colon
-        int lastColon = ssidAndPass.lastIndexOf(':');
-        if (lastColon < 1) continue;  // Need at least 1 char for SSID
-        
-        String ssid = ssidAndPass.substring(0, lastColon);
-        String password = ssidAndPass.substring(lastColon + 1);
-        
-        if (password.isEmpty()) continue;
-        
-        String bssidKey = normalizeBSSID(bssid.c_str());
-        
-        // Don't log password for security
-        Serial.printf("[WPASEC] Found: %s (%s)\n", ssid.c_str(), bssidKey.c_str());
-        
-        // Check if this is new
-        if (crackedCache.find(bssidKey) == crackedCache.end()) {
-            newCracks++;
-        }
-        
-        CacheEntry entry;
-        entry.ssid = ssid;
-        entry.password = password;
-        crackedCache[bssidKey] = entry;
+    if (state.failed || bodyBytes < 0) {
+        // Whatever did parse is still good - keep it
+        flushPending();
+        if (!state.failed) snprintf(lastError, sizeof(lastError), "DOWNLOAD FAILED: %d", bodyBytes);
+        strcpy(statusMessage, lastError);
+        return false;
     }
     
-    // Save updated cache
-    saveCache();
+    uint32_t newCracks = state.newCracks;
+    // Merge what's left into the index
+    if (!flushPending()) {
+        strcpy(statusMessage, lastError);
+        return false;
+    }
     
-    snprintf(statusMessage, sizeof(statusMessage), "%d cracked (%d new)", 
-             crackedCache.size(), newCracks);
-    Serial.printf("[WPASEC] Fetched: %d total, %d new\n", crackedCache.size(), newCracks);
-    SDLog::log("WPASEC", "Fetched: %d cracked (%d new)", crackedCache.size(), newCracks);
+    snprintf(statusMessage, sizeof(statusMessage), "%lu cracked (%lu new)", 
+             (unsigned long)crackedCount, (unsigned long)newCracks);
+    Serial.printf("[WPASEC] Fetched: %lu total, %lu new, %lu already known\n", (unsigned long)crackedCount,
+                  (unsigned long)newCracks, (unsigned long)state.known);
+    SDLog::log("WPASEC", "Fetched: %lu cracked (%lu new)", (unsigned long)crackedCount, (unsigned long)newCracks);
     
     return true;
 }
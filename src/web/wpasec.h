@@ -3,7 +3,8 @@
 #pragma once
 
 #include <Arduino.h>
-#include <map>
+#include <FS.h>
+#include "wpasec_index.h"
 
 // Upload status for tracking
 enum class WPASecUploadStatus {
@@ -26,7 +27,7 @@ public:
     static bool uploadCapture(const char* pcapPath); // POST pcap file to WPA-SEC
     
     // Local cache queries (no WiFi needed)
-    static bool loadCache();                         // Load cache from SD
+    static bool loadCache();                         // Open the SD index
     static bool isCracked(const char* bssid);        // Check if BSSID is cracked
     static String getPassword(const char* bssid);    // Get password for BSSID
     static String getSSID(const char* bssid);        // Get SSID for BSSID (from cache)
@@ -45,17 +46,21 @@ private:
     static char lastError[64];
     static char statusMessage[64];
     
-    // Cache: BSSID (no colons, uppercase) -> {ssid, password}
-    struct CacheEntry {
-        String ssid;
-        String password;
-    };
-    static std::map<String, CacheEntry> crackedCache;
-    static std::map<String, bool> uploadedCache;
+    // Results: sorted records on SD (wpasec_index.h), searched through a
+    // page cache. New records collect in a small sorted batch that is
+    // merged into the file when it fills or the operation ends.
+    static const uint16_t PENDING_MAX = 128;
+    static File indexFile;
+    static WpaSecIndexReader index;
+    static uint32_t crackedCount;
+    static WpaSecRecord* pending;
+    static uint32_t pendingCount;
+    static File stringsOut;                          // Blob appends while a batch is open
     
-    // File paths
-    static constexpr const char* CACHE_FILE = "/wpasec_results.txt";
-    static constexpr const char* UPLOADED_FILE = "/wpasec_uploaded.txt";
+    // Text files from before the index - imported once, then removed
+    static constexpr const char* LEGACY_CACHE_FILE = "/wpasec_results.txt";
+    static constexpr const char* LEGACY_UPLOADED_FILE = "/wpasec_uploaded.txt";
+    static constexpr const char* INDEX_TMP_FILE = "/wpasec.tmp";
     
     // API endpoints
     static constexpr const char* API_HOST = "wpa-sec.stanev.org";
@@ -63,8 +68,16 @@ private:
     static constexpr const char* SUBMIT_PATH = "/?submit";
     
     // Helpers
-    static String normalizeBSSID(const char* bssid);  // Remove colons, uppercase
-    static bool saveCache();
-    static bool loadUploadedList();
-    static bool saveUploadedList();
+    static bool openIndex();
+    static void closeIndex();
+    static bool readIndexAt(uint32_t offset, uint8_t* buf, size_t len, void* ctx);
+    static bool lookup(const char* bssid, WpaSecRecord& out);
+    static bool lookupKey(const uint8_t* bssid, WpaSecRecord& out);
+    static bool addRecord(const uint8_t* bssid, uint8_t flags, const char* ssid, size_t ssidLen,
+                          const char* pass, size_t passLen);
+    static bool flushPending();
+    static bool readStrings(const WpaSecRecord& rec, String* ssid, String* password);
+    static void importLegacy();
+    static void onPotEntry(const uint8_t* bssid, const char* ssid, size_t ssidLen,
+                           const char* pass, size_t passLen, void* ctx);
 };
@@ -0,0 +1,382 @@
+// WPA-SEC Index - on-SD lookup table for cracked and uploaded BSSIDs
+// The index file is a header plus fixed 16-byte records sorted by raw
+// 6-byte BSSID (memcmp order, as in bssid_set.h). SSIDs and passwords
+// live in an append-only string blob the records point into, so a merge
+// rewrites only the records. Lookups binary-search the file through a
+// few cached pages: RAM use does not grow with the number of results.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#define WPASEC_INDEX_FILE "/wpasec.idx"
+#define WPASEC_STRINGS_FILE "/wpasec.str"
+
+static const uint32_t WPASEC_INDEX_MAGIC = 0x58535750;  // "PWSX"
+static const uint16_t WPASEC_INDEX_VERSION = 1;
+static const uint16_t WPASEC_PAGE_RECORDS = 32;  // 512-byte pages
+static const uint8_t WPASEC_CACHE_PAGES = 4;
+static const uint16_t WPASEC_TOP_KEYS = 255;     // Search-tree levels 1-8, 6 bytes each
+static const uint8_t WPASEC_SSID_MAX = 32;
+static const uint8_t WPASEC_PASS_MAX = 64;       // 63-char passphrase or 64-hex PSK
+
+// Record flags
+static const uint8_t WPASEC_FLAG_UPLOADED = 0x01;
+static const uint8_t WPASEC_FLAG_CRACKED = 0x02;  // ssid/password are set
+
+struct WpaSecIndexHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t count;
+    uint32_t cracked;   // Records with WPASEC_FLAG_CRACKED
+};
+
+struct WpaSecRecord {
+    uint8_t bssid[6];
+    uint8_t flags;      // WPASEC_FLAG_*
+    uint8_t ssidLen;
+    uint8_t passLen;
+    uint8_t reserved;
+    uint16_t strHash;   // wpasecStringHash of the two, to spot unchanged results
+    uint32_t strOffset; // SSID then password, back to back in the blob
+};
+
+static_assert(sizeof(WpaSecIndexHeader) == 16, "WPA-SEC index header is 16 bytes on SD");
+static_assert(sizeof(WpaSecRecord) == 16, "WPA-SEC index records are 16 bytes on SD");
+
+inline int wpasecHexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 12 hex digits, optionally split by ':' or '-' ("AABBCC112233",
+// "aa:bb:cc:11:22:33"). Nothing else may follow within len.
+inline bool wpasecParseBssid(const char* s, size_t len, uint8_t* out) {
+    size_t digits = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = s[i];
+        if (c == ':' || c == '-') continue;
+        int v = wpasecHexValue(c);
+        if (v < 0 || digits >= 12) return false;
+        if (digits % 2 == 0) {
+            out[digits / 2] = (uint8_t)(v << 4);
+        } else {
+            out[digits / 2] |= (uint8_t)v;
+        }
+        digits++;
+    }
+    return digits == 12;
+}
+
+// FNV-1a of SSID and password, folded to 16 bits. With the lengths it
+// tells a re-downloaded result from a changed one without reading the blob.
+inline uint16_t wpasecStringHash(const char* ssid, size_t ssidLen, const char* pass, size_t passLen) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < ssidLen; i++) h = (h ^ (uint8_t)ssid[i]) * 16777619u;
+    h = (h ^ ':') * 16777619u;
+    for (size_t i = 0; i < passLen; i++) h = (h ^ (uint8_t)pass[i]) * 16777619u;
+    return (uint16_t)(h ^ (h >> 16));
+}
+
+// Newer information about the same BSSID folded into `into`: flags
+// accumulate, and a newer crack replaces the strings
+inline void wpasecCombine(WpaSecRecord& into, const WpaSecRecord& newer) {
+    uint8_t flags = into.flags | newer.flags;
+    if (newer.flags & WPASEC_FLAG_CRACKED) into = newer;
+    into.flags = flags;
+}
+
+// First position in recs (n sorted records) whose BSSID is not less than bssid
+inline uint32_t wpasecLowerBound(const WpaSecRecord* recs, uint32_t n, const uint8_t* bssid) {
+    uint32_t lo = 0, hi = n;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (memcmp(recs[mid].bssid, bssid, 6) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Adds r to a sorted batch of n (capacity cap), combining with an equal
+// BSSID. Returns false only when a new record doesn't fit.
+inline bool wpasecBatchInsert(WpaSecRecord* batch, uint32_t& n, uint32_t cap, const WpaSecRecord& r) {
+    uint32_t pos = wpasecLowerBound(batch, n, r.bssid);
+    if (pos < n && memcmp(batch[pos].bssid, r.bssid, 6) == 0) {
+        wpasecCombine(batch[pos], r);
+        return true;
+    }
+    if (n >= cap) return false;
+    memmove(batch + pos + 1, batch + pos, (n - pos) * sizeof(WpaSecRecord));
+    batch[pos] = r;
+    n++;
+    return true;
+}
+
+// Legacy cache line "BSSID:SSID:password" (SSID may hold colons).
+// Pointers index into line; false if it isn't one.
+inline bool wpasecParseCacheLine(const char* line, size_t len, uint8_t* bssid,
+                                 const char*& ssid, size_t& ssidLen, const char*& pass, size_t& passLen) {
+    while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == ' ')) len--;
+    const char* first = (const char*)memchr(line, ':', len);
+    const char* last = line + len;
+    while (last > line && last[-1] != ':') last--;
+    if (!first || last - 1 <= first) return false;
+    if (!wpasecParseBssid(line, first - line, bssid)) return false;
+    ssid = first + 1;
+    ssidLen = (last - 1) - ssid;
+    pass = last;
+    passLen = (line + len) - last;
+    return passLen > 0 && ssidLen <= WPASEC_SSID_MAX && passLen <= WPASEC_PASS_MAX;
+}
+
+// WPA-SEC potfile line "BSSID:CLIENT_MAC:SSID:PASSWORD", both MACs as 12
+// bare hex digits, e.g. e848b8f87e98:809d6557b0be:pxs.pl_4586:79768559.
+// The password is after the last colon; the SSID may hold colons.
+inline bool wpasecParsePotLine(const char* line, size_t len, uint8_t* bssid,
+                               const char*& ssid, size_t& ssidLen, const char*& pass, size_t& passLen) {
+    while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == ' ')) len--;
+    uint8_t client[6];
+    if (len < 28 || line[12] != ':' || line[25] != ':') return false;
+    if (!wpasecParseBssid(line, 12, bssid) || !wpasecParseBssid(line + 13, 12, client)) return false;
+    const char* rest = line + 26;
+    const char* last = line + len;
+    while (last > rest && last[-1] != ':') last--;
+    if (last - 1 <= rest) return false;  // Need at least 1 char of SSID
+    ssid = rest;
+    ssidLen = (last - 1) - rest;
+    pass = last;
+    passLen = (line + len) - last;
+    return passLen > 0 && ssidLen <= WPASEC_SSID_MAX && passLen <= WPASEC_PASS_MAX;
+}
+
+// Potfile tokenizer for a download in flight: feed() whatever bytes
+// arrived, in pieces of any size, and each complete entry is handed to
+// the callback. Lines live in a fixed buffer sized for the longest valid
+// entry; a longer line can't be one, so it is skipped up to its newline.
+class WpaSecPotParser {
+public:
+    // Pointers are only valid during the call
+    typedef void (*EntryFn)(const uint8_t* bssid, const char* ssid, size_t ssidLen,
+                            const char* pass, size_t passLen, void* ctx);
+
+    // BSSID:CLIENT:SSID:PASSWORD at their longest, plus a '\r'
+    static const size_t LINE_MAX = 12 + 1 + 12 + 1 + WPASEC_SSID_MAX + 1 + WPASEC_PASS_MAX + 1;
+
+    WpaSecPotParser() : onEntry(nullptr), ctx(nullptr) { begin(nullptr, nullptr); }
+
+    void begin(EntryFn fn, void* fnCtx) {
+        onEntry = fn;
+        ctx = fnCtx;
+        len = 0;
+        skipping = false;
+        entryCount = 0;
+        rejectCount = 0;
+    }
+
+    void feed(const uint8_t* data, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            char c = (char)data[i];
+            if (c == '\n') {
+                endLine();
+            } else if (skipping) {
+                continue;
+            } else if (len < LINE_MAX) {
+                line[len++] = c;
+            } else {
+                skipping = true;
+            }
+        }
+    }
+
+    // The body may not end with a newline
+    void finish() {
+        if (len > 0 || skipping) endLine();
+    }
+
+    uint32_t entries() const { return entryCount; }
+    uint32_t rejected() const { return rejectCount; }   // Non-blank lines that weren't entries
+
+private:
+    EntryFn onEntry;
+    void* ctx;
+    char line[LINE_MAX];
+    size_t len;
+    bool skipping;
+    uint32_t entryCount;
+    uint32_t rejectCount;
+
+    void endLine() {
+        uint8_t bssid[6];
+        const char* ssid;
+        const char* pass;
+        size_t ssidLen, passLen;
+        bool blank = !skipping && (len == 0 || (len == 1 && line[0] == '\r'));
+        if (!skipping && wpasecParsePotLine(line, len, bssid, ssid, ssidLen, pass, passLen)) {
+            entryCount++;
+            if (onEntry) onEntry(bssid, ssid, ssidLen, pass, passLen, ctx);
+        } else if (!blank) {
+            rejectCount++;
+        }
+        len = 0;
+        skipping = false;
+    }
+};
+
+// Binary search over the sorted records of an index file. Each step of
+// the search over pages compares a page's first key; the first eight
+// levels of that search tree are remembered (1.5KB), so up to 256 pages
+// (8192 results) a lookup costs one page read, plus one per doubling
+// beyond. Pages themselves go through a small LRU cache. The file is the
+// caller's: reads go through a callback (SD on the device, memory in the
+// tests).
+class WpaSecIndexReader {
+public:
+    // Read len bytes at offset into buf. False on a short read.
+    typedef bool (*ReadFn)(uint32_t offset, uint8_t* buf, size_t len, void* ctx);
+
+    WpaSecIndexReader() : read(nullptr), ctx(nullptr), total(0), tick(0), reads(0) { invalidate(); }
+
+    void attach(ReadFn readFn, void* readCtx, uint32_t count) {
+        read = readFn;
+        ctx = readCtx;
+        total = count;
+        invalidate();
+    }
+
+    void detach() { attach(nullptr, nullptr, 0); }
+
+    // Forget cached pages and keys (the file changed under us)
+    void invalidate() {
+        for (uint8_t i = 0; i < WPASEC_CACHE_PAGES; i++) {
+            slots[i].page = -1;
+            slots[i].used = 0;
+        }
+        memset(topKnown, 0, sizeof(topKnown));
+    }
+
+    uint32_t count() const { return total; }
+    uint32_t pageReads() const { return reads; }
+
+    // Record i, in BSSID order
+    bool record(uint32_t i, WpaSecRecord& out) {
+        uint32_t n;
+        const WpaSecRecord* recs = page(i / WPASEC_PAGE_RECORDS, n);
+        if (!recs || i % WPASEC_PAGE_RECORDS >= n) return false;
+        out = recs[i % WPASEC_PAGE_RECORDS];
+        return true;
+    }
+
+    // First record not less than bssid (count() if none). False on a read error.
+    bool lowerBound(const uint8_t* bssid, uint32_t& pos) {
+        if (total == 0) {
+            pos = 0;
+            return true;
+        }
+        uint32_t p, n;
+        const WpaSecRecord* recs = searchPage(bssid, p, n);
+        if (!recs) return false;
+        pos = p * WPASEC_PAGE_RECORDS + wpasecLowerBound(recs, n, bssid);
+        return true;
+    }
+
+    // Only ever reads the one page the key would be on
+    bool find(const uint8_t* bssid, WpaSecRecord& out) {
+        if (total == 0) return false;
+        uint32_t p, n;
+        const WpaSecRecord* recs = searchPage(bssid, p, n);
+        if (!recs) return false;
+        uint32_t i = wpasecLowerBound(recs, n, bssid);
+        if (i >= n || memcmp(recs[i].bssid, bssid, 6) != 0) return false;
+        out = recs[i];
+        return true;
+    }
+
+private:
+    struct Slot {
+        int32_t page;
+        uint32_t used;      // LRU stamp
+        uint32_t n;
+        WpaSecRecord recs[WPASEC_PAGE_RECORDS];
+    };
+
+    ReadFn read;
+    void* ctx;
+    uint32_t total;
+    uint32_t tick;
+    uint32_t reads;
+    Slot slots[WPASEC_CACHE_PAGES];
+    uint8_t topKeys[WPASEC_TOP_KEYS][6];   // First key of page probed at node i+1
+    uint8_t topKnown[(WPASEC_TOP_KEYS + 7) / 8];
+
+    // The last page whose first key is <= bssid (or page 0). node numbers
+    // the steps as a heap (root 1, children 2n and 2n+1) for the top keys.
+    const WpaSecRecord* searchPage(const uint8_t* bssid, uint32_t& p, uint32_t& n) {
+        uint32_t pages = (total + WPASEC_PAGE_RECORDS - 1) / WPASEC_PAGE_RECORDS;
+        uint32_t lo = 0, hi = pages;
+        uint32_t node = 1;
+        while (hi - lo > 1) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            const uint8_t* first = pageFirstKey(mid, node);
+            if (!first) return nullptr;
+            if (memcmp(first, bssid, 6) <= 0) {
+                lo = mid;
+                node = 2 * node + 1;
+            } else {
+                hi = mid;
+                node = 2 * node;
+            }
+        }
+        p = lo;
+        return page(lo, n);
+    }
+
+    const uint8_t* pageFirstKey(uint32_t p, uint32_t node) {
+        bool top = node <= WPASEC_TOP_KEYS;
+        uint32_t t = node - 1;
+        if (top && (topKnown[t / 8] & (1 << (t % 8)))) return topKeys[t];
+        uint32_t n;
+        const WpaSecRecord* recs = page(p, n);
+        if (!recs) return nullptr;
+        if (!top) return recs[0].bssid;
+        memcpy(topKeys[t], recs[0].bssid, 6);
+        topKnown[t / 8] |= (uint8_t)(1 << (t % 8));
+        return topKeys[t];
+    }
+
+    const WpaSecRecord* page(uint32_t p, uint32_t& n) {
+        if (!read || (uint64_t)p * WPASEC_PAGE_RECORDS >= total) return nullptr;
+        tick++;
+        uint8_t victim = 0;
+        for (uint8_t i = 0; i < WPASEC_CACHE_PAGES; i++) {
+            if (slots[i].page == (int32_t)p) {
+                slots[i].used = tick;
+                n = slots[i].n;
+                return slots[i].recs;
+            }
+            if (slots[i].used < slots[victim].used) victim = i;
+        }
+
+        Slot& s = slots[victim];
+        uint32_t first = p * WPASEC_PAGE_RECORDS;
+        uint32_t count = total - first < WPASEC_PAGE_RECORDS ? total - first : WPASEC_PAGE_RECORDS;
+        uint32_t offset = sizeof(WpaSecIndexHeader) + first * sizeof(WpaSecRecord);
+        reads++;
+        if (!read(offset, (uint8_t*)s.recs, count * sizeof(WpaSecRecord), ctx)) {
+            s.page = -1;
+            s.used = 0;
+            return nullptr;
+        }
+        s.page = (int32_t)p;
+        s.used = tick;
+        s.n = count;
+        n = count;
+        return s.recs;
+    }
+};
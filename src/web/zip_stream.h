@@ -0,0 +1,122 @@
+// ZIP Stream - record layout for folder downloads written straight to a socket
+// STORE method only. Each local header sets flag bit 3, so its CRC goes in
+// a data descriptor after the data: the CRC is worked out while the file
+// streams and nothing is read twice or spooled to a temp file. Sizes are
+// known up front, so the whole archive length is too (Content-Length).
+// No ZIP64: at most 65535 entries and 4GB per archive.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+static const size_t ZIP_LOCAL_HEADER_SIZE = 30;
+static const size_t ZIP_DESCRIPTOR_SIZE = 16;
+static const size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+static const size_t ZIP_END_RECORD_SIZE = 22;
+static const size_t ZIP_NAME_MAX = 255;
+static const uint32_t ZIP_MAX_ENTRIES = 0xFFFF;
+
+static const uint16_t ZIP_FLAG_DESCRIPTOR = 0x0008;  // CRC and sizes follow the data
+static const uint16_t ZIP_FLAG_UTF8 = 0x0800;        // Names are UTF-8
+static const uint16_t ZIP_VERSION = 20;              // 2.0: enough for STORE + descriptor
+
+// Unix time as MS-DOS date/time (2s resolution). Before 1980 clamps to
+// 1980-01-01 00:00, which is also what a missing timestamp becomes.
+inline void zipDosTime(uint32_t unixTime, uint16_t& dosTime, uint16_t& dosDate) {
+    const uint32_t DOS_EPOCH = 315532800;  // 1980-01-01
+    if (unixTime < DOS_EPOCH) unixTime = DOS_EPOCH;
+    uint32_t days = unixTime / 86400;
+    uint32_t secs = unixTime % 86400;
+
+    // Civil date from days since 1970 (Howard Hinnant's algorithm)
+    uint32_t z = days + 719468;
+    uint32_t era = z / 146097;
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t day = doy - (153 * mp + 2) / 5 + 1;
+    uint32_t month = mp < 10 ? mp + 3 : mp - 9;
+    uint32_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+    if (year > 2107) year = 2107;  // 7-bit year field
+
+    dosTime = (uint16_t)(((secs / 3600) << 11) | (((secs / 60) % 60) << 5) | ((secs % 60) / 2));
+    dosDate = (uint16_t)(((year - 1980) << 9) | (month << 5) | day);
+}
+
+inline void zipPut16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+inline void zipPut32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+// Local file header + name. CRC and sizes are left zero (flag bit 3).
+// out needs ZIP_LOCAL_HEADER_SIZE + nameLen bytes. Returns bytes written.
+inline size_t zipLocalHeader(uint8_t* out, const char* name, uint16_t nameLen,
+                             uint16_t dosTime, uint16_t dosDate) {
+    memset(out, 0, ZIP_LOCAL_HEADER_SIZE);
+    zipPut32(out, 0x04034B50);
+    zipPut16(out + 4, ZIP_VERSION);
+    zipPut16(out + 6, ZIP_FLAG_DESCRIPTOR | ZIP_FLAG_UTF8);
+    zipPut16(out + 8, 0);  // STORE
+    zipPut16(out + 10, dosTime);
+    zipPut16(out + 12, dosDate);
+    zipPut16(out + 26, nameLen);
+    memcpy(out + ZIP_LOCAL_HEADER_SIZE, name, nameLen);
+    return ZIP_LOCAL_HEADER_SIZE + nameLen;
+}
+
+// Data descriptor (with its optional signature - every reader accepts it)
+inline size_t zipDataDescriptor(uint8_t* out, uint32_t crc, uint32_t size) {
+    zipPut32(out, 0x08074B50);
+    zipPut32(out + 4, crc);
+    zipPut32(out + 8, size);   // Compressed
+    zipPut32(out + 12, size);  // Uncompressed
+    return ZIP_DESCRIPTOR_SIZE;
+}
+
+// Central directory header + name. out needs ZIP_CENTRAL_HEADER_SIZE + nameLen.
+inline size_t zipCentralHeader(uint8_t* out, const char* name, uint16_t nameLen, uint32_t crc,
+                               uint32_t size, uint16_t dosTime, uint16_t dosDate, uint32_t localOffset) {
+    memset(out, 0, ZIP_CENTRAL_HEADER_SIZE);
+    zipPut32(out, 0x02014B50);
+    zipPut16(out + 4, ZIP_VERSION);  // Made by: MS-DOS/FAT
+    zipPut16(out + 6, ZIP_VERSION);
+    zipPut16(out + 8, ZIP_FLAG_DESCRIPTOR | ZIP_FLAG_UTF8);
+    zipPut16(out + 10, 0);  // STORE
+    zipPut16(out + 12, dosTime);
+    zipPut16(out + 14, dosDate);
+    zipPut32(out + 16, crc);
+    zipPut32(out + 20, size);
+    zipPut32(out + 24, size);
+    zipPut16(out + 28, nameLen);
+    zipPut32(out + 42, localOffset);
+    memcpy(out + ZIP_CENTRAL_HEADER_SIZE, name, nameLen);
+    return ZIP_CENTRAL_HEADER_SIZE + nameLen;
+}
+
+inline size_t zipEndRecord(uint8_t* out, uint16_t entries, uint32_t centralSize, uint32_t centralOffset) {
+    memset(out, 0, ZIP_END_RECORD_SIZE);
+    zipPut32(out, 0x06054B50);
+    zipPut16(out + 8, entries);
+    zipPut16(out + 10, entries);
+    zipPut32(out + 12, centralSize);
+    zipPut32(out + 16, centralOffset);
+    return ZIP_END_RECORD_SIZE;
+}
+
+// Exact archive length for `entries` files whose names add up to
+// nameBytes and data to dataBytes. 0 if it would need ZIP64.
+inline uint32_t zipArchiveSize(uint32_t entries, uint64_t nameBytes, uint64_t dataBytes) {
+    if (entries > ZIP_MAX_ENTRIES) return 0;
+    uint64_t total = (uint64_t)entries * (ZIP_LOCAL_HEADER_SIZE + ZIP_DESCRIPTOR_SIZE + ZIP_CENTRAL_HEADER_SIZE) +
+                     2 * nameBytes + dataBytes + ZIP_END_RECORD_SIZE;
+    return total > 0xFFFFFFFFull ? 0 : (uint32_t)total;
+}
@@ -0,0 +1,1012 @@
+// Host benchmarks for firmware code paths that are pure logic
+// Built natively (pio run -e bench) against the real headers, so the
+// numbers track the code that ships. Host speed is not ESP32 speed:
+// compare runs against each other, not against the device.
+//
+//   bench gzip [file.csv] [--bytes N]   WiGLE upload compression
+//   bench papa [--captures N] [--loss PCT] [--interval MS] [--per-event N]
+//                                       CALL PAPA sync, both ends in loopback
+//   bench crc32 [--bytes N]             CRC-32 implementations, MB/s
+//   bench ml [--networks N] [--rounds N]
+//                                       Heuristic classifier, per network vs batched
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "../../src/core/crc32.h"
+#include "../../src/core/wardrive_format.h"
+#include "../../src/ml/ml_batch.h"
+#include "../../src/modes/papa_protocol.h"
+#include "../../src/web/gzip_stream.h"
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double msSince(BenchClock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - t0).count();
+}
+
+// Deterministic, so runs are comparable
+static uint32_t lcgState = 0x504F524B;
+static uint32_t lcg() {
+    lcgState = lcgState * 1664525u + 1013904223u;
+    return lcgState >> 8;
+}
+
+// ============ gzip ============
+
+// A day of driving as Warhog would export it: a GPS track, a rolling
+// population of nearby APs, a scan every few seconds
+static std::string synthWigle(size_t targetBytes) {
+    static const char* NAMES[] = {"NETGEAR", "xfinitywifi", "HOME-", "TP-Link_", "Starbucks WiFi",
+                                  "ATT", "DIRECT-", "Hotel Guest", "linksys", "SpectrumSetup-"};
+    static const uint8_t AUTHS[] = {0, 3, 3, 3, 4, 3, 7, 6, 2, 1};
+
+    WdlHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    strncpy(hdr.appRelease, "0.1.7_BENCH", sizeof(hdr.appRelease));
+    char row[512];
+    std::string out(row, wdlWigleHeader(row, sizeof(row), hdr));
+
+    const int NEARBY = 24;
+    uint32_t ap[NEARBY];
+    for (int i = 0; i < NEARBY; i++) ap[i] = lcg();
+    int32_t lat = 515000000, lon = -1200000;
+    uint32_t now = 1717200000;
+
+    while (out.size() < targetBytes) {
+        // Drive on: a few APs drop out of range, new ones appear
+        lat += (int32_t)(lcg() % 400) - 100;
+        lon += (int32_t)(lcg() % 400) - 100;
+        now += 3 + lcg() % 4;
+        for (int k = 0; k < 3; k++) ap[lcg() % NEARBY] = lcg();
+
+        int seen = 8 + lcg() % (NEARBY - 8);
+        for (int i = 0; i < seen; i++) {
+            uint32_t id = ap[i];
+            WdlObservation o;
+            memset(&o, 0, sizeof(o));
+            o.type = WDL_REC_OBS;
+            o.flags = WDL_OBS_GPS;
+            static const uint8_t OUIS[4][3] = {{0x00, 0x1A, 0x2B}, {0xAC, 0x84, 0xC6}, {0x3C, 0x37, 0x86}, {0xF4, 0xF2, 0x6D}};
+            memcpy(o.bssid, OUIS[id % 4], 3);
+            o.bssid[3] = (uint8_t)(id >> 16);
+            o.bssid[4] = (uint8_t)(id >> 8);
+            o.bssid[5] = (uint8_t)id;
+            o.rssi = (int8_t)(-40 - (int)(lcg() % 55));
+            o.channel = (uint8_t)(1 + id % 11);
+            o.lat = lat + (int32_t)(lcg() % 60);
+            o.lon = lon + (int32_t)(lcg() % 60);
+            o.altDm = 300 + lcg() % 40;
+            o.time = now;
+            o.accuracyDm = 30 + lcg() % 50;
+            o.auth = AUTHS[id % 10];
+
+            char ssid[33];
+            snprintf(ssid, sizeof(ssid), "%s%04X", NAMES[(id >> 4) % 10], (id >> 12) & 0xFFFF);
+            out.append(row, wdlWigleRow(row, sizeof(row), o, (id & 31) == 0 ? "" : ssid));
+        }
+    }
+    return out;
+}
+
+static bool appendSink(const uint8_t* data, size_t len, void* ctx) {
+    ((std::vector<uint8_t>*)ctx)->insert(((std::vector<uint8_t>*)ctx)->end(), data, data + len);
+    return true;
+}
+
+static bool gunzipMatches(const std::vector<uint8_t>& gz, const std::string& want) {
+    std::vector<uint8_t> out(want.size() + 1);
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, 16 + 15) != Z_OK) return false;
+    zs.next_in = (Bytef*)gz.data();
+    zs.avail_in = gz.size();
+    zs.next_out = out.data();
+    zs.avail_out = out.size();
+    int rc = inflate(&zs, Z_FINISH);
+    size_t got = zs.total_out;
+    inflateEnd(&zs);
+    return rc == Z_STREAM_END && got == want.size() && memcmp(out.data(), want.data(), got) == 0;
+}
+
+static size_t zlibGzipSize(const std::string& in, int level, double& ms) {
+    std::vector<uint8_t> out(compressBound(in.size()) + 64);
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    BenchClock::time_point t0 = BenchClock::now();
+    deflateInit2(&zs, level, Z_DEFLATED, 16 + 15, 8, Z_DEFAULT_STRATEGY);
+    zs.next_in = (Bytef*)in.data();
+    zs.avail_in = in.size();
+    zs.next_out = out.data();
+    zs.avail_out = out.size();
+    deflate(&zs, Z_FINISH);
+    size_t n = zs.total_out;
+    deflateEnd(&zs);
+    ms = msSince(t0);
+    return n;
+}
+
+static int benchGzip(int argc, char** argv) {
+    const char* path = nullptr;
+    size_t bytes = 1200000;  // Three rotated 400KB exports
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--bytes") == 0 && i + 1 < argc) bytes = strtoul(argv[++i], nullptr, 10);
+        else path = argv[i];
+    }
+
+    std::string input;
+    if (path) {
+        FILE* f = fopen(path, "rb");
+        if (!f) {
+            fprintf(stderr, "[BENCH] Can't open %s\n", path);
+            return 1;
+        }
+        char buf[65536];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) input.append(buf, n);
+        fclose(f);
+    } else {
+        input = synthWigle(bytes);
+    }
+
+    // Same 4KB reads the upload does
+    const int RUNS = 5;
+    std::vector<uint8_t> gz;
+    double best = 1e9;
+    GzipStream* stream = new GzipStream();
+    for (int run = 0; run < RUNS; run++) {
+        gz.clear();
+        BenchClock::time_point t0 = BenchClock::now();
+        stream->begin(appendSink, &gz);
+        for (size_t at = 0; at < input.size(); at += 4096) {
+            size_t n = input.size() - at < 4096 ? input.size() - at : 4096;
+            stream->write((const uint8_t*)input.data() + at, n);
+        }
+        stream->finish();
+        double ms = msSince(t0);
+        if (ms < best) best = ms;
+    }
+    delete stream;
+
+    bool ok = gunzipMatches(gz, input);
+    double mb = input.size() / 1e6;
+    printf("[BENCH] gzip %s: %zu bytes%s\n", path ? path : "synthetic WiGLE CSV", input.size(),
+           ok ? "" : "  ROUND TRIP FAILED");
+    printf("  %-16s %9s %7s %9s\n", "encoder", "bytes", "ratio", "MB/s");
+    printf("  %-16s %9zu %6.2fx %9.1f   (%zu B state)\n", "GzipStream", gz.size(),
+           (double)input.size() / gz.size(), mb / (best / 1000), sizeof(GzipStream));
+    const int LEVELS[] = {1, 6, 9};
+    for (int level : LEVELS) {
+        double ms;
+        size_t n = zlibGzipSize(input, level, ms);
+        char name[16];
+        snprintf(name, sizeof(name), "zlib -%d", level);
+        printf("  %-16s %9zu %6.2fx %9.1f\n", name, n, (double)input.size() / n, mb / (ms / 1000));
+    }
+
+    // What that means over a weak phone hotspot
+    const double KBPS[] = {250, 1000};
+    for (double kbps : KBPS) {
+        printf("  at %4.0f kbit/s: %6.1f s raw, %6.1f s gzip\n", kbps,
+               input.size() * 8 / (kbps * 1000), gz.size() * 8 / (kbps * 1000));
+    }
+    return ok ? 0 : 1;
+}
+
+// ============ papa ============
+
+// Both ends of a CALL PAPA sync over a simulated BLE link. Time moves in
+// connection events: each event carries up to perEvent notifications
+// Sirloin -> Papa and perEvent writes Papa -> Sirloin, and whatever a side
+// sends in reply goes out in the next event. Data notifications and ACK
+// writes can be dropped (controller buffers full); control traffic can't.
+// Revision 1 is modelled on call_papa.cpp and what it expects of Sirloin:
+// one chunk in flight, the next one after its CMD_ACK_CHUNK.
+
+typedef std::vector<uint8_t> Packet;
+
+enum {
+    SIM_CMD_HELLO = 0x01, SIM_CMD_START_SYNC = 0x03, SIM_CMD_ACK_CHUNK = 0x04,
+    SIM_CMD_MARK_SYNCED = 0x06, SIM_CMD_PURGE = 0x07,
+    SIM_RSP_HELLO = 0x81, SIM_RSP_SYNC_START = 0x83, SIM_RSP_PURGED = 0x87
+};
+
+struct PapaSimConfig {
+    uint16_t mtu;
+    uint8_t sirloinVersion;    // Newest revision Sirloin's firmware speaks
+    int perEvent;
+    double intervalMs;
+    double loss;               // 0..1
+    uint32_t dropAt;           // Event the link drops at (0 = never)
+    uint32_t reconnectEvents;  // Scan + connect + READY + HELLO after a drop
+};
+
+struct PapaSimResult {
+    uint32_t events;
+    uint32_t resent;
+    uint32_t airBytes;
+    uint32_t captures;
+    uint32_t skipped;
+    uint32_t bad;
+    PapaLink link;
+};
+
+static bool simDrop(double loss) {
+    return loss > 0 && (lcg() % 100000) < loss * 100000;
+}
+
+class SimSirloin {
+public:
+    SimSirloin(const std::vector<Packet>& caps, const PapaSimConfig& cfg)
+        : captures(caps), config(cfg), resent(0) {
+        linkLost();
+    }
+
+    std::deque<Packet> ctrlOut;
+
+    void linkLost() {
+        link = papaLegacyLink();
+        current = -1;
+        legacySeq = 0;
+        legacyDue = false;
+        lastHeard = 0;
+        ctrlOut.clear();
+        resent += tx.chunksResent();
+        tx = PapaTxWindow();
+    }
+
+    void onWrite(const Packet& w, uint32_t event) {
+        switch (w[0]) {
+            case SIM_CMD_HELLO: {
+                Packet rsp(8, 0);
+                rsp[0] = SIM_RSP_HELLO;
+                rsp[1] = PAPA_PROTO_LEGACY;
+                uint16_t n = (uint16_t)captures.size();
+                rsp[2] = n & 0xFF;
+                rsp[3] = n >> 8;
+                if (config.sirloinVersion >= PAPA_PROTO_WINDOWED) {
+                    link = papaAnswerHello(w.data(), w.size(), papaChunkForMtu(config.mtu), PAPA_WINDOW_DEFAULT,
+                                           config.sirloinVersion);
+                    if (link.version >= PAPA_PROTO_WINDOWED) {
+                        rsp.resize(PAPA_HELLO_RSP_LEN, 0);
+                        papaPutHelloLink(rsp.data(), link);
+                    }
+                }
+                ctrlOut.push_back(rsp);
+                break;
+            }
+            case PAPA_CMD_GET_MANIFEST: {
+                uint8_t type, count;
+                uint16_t first;
+                if (!papaParseGetManifest(w.data(), w.size(), type, first, count)) break;
+                PapaDigest digests[PAPA_MANIFEST_MAX];
+                uint8_t n = 0;
+                uint8_t fit = papaManifestFit(link.chunkSize + PAPA_PACKET_OVERHEAD);
+                for (uint32_t i = first; i < captures.size() && n < count && n < fit; i++, n++) {
+                    digests[n] = papaDigestOf(type, (uint16_t)i, captures[i].data(), (uint16_t)captures[i].size());
+                }
+                uint8_t rsp[PAPA_MANIFEST_HEADER + PAPA_MANIFEST_MAX * PAPA_MANIFEST_ENTRY];
+                ctrlOut.push_back(Packet(rsp, rsp + papaBuildManifest(rsp, type, first, digests, n)));
+                break;
+            }
+            case SIM_CMD_START_SYNC: {
+                current = w[2] | (w[3] << 8);
+                const Packet& cap = captures[current];
+                uint16_t offset = link.version >= PAPA_PROTO_RESUME ? papaStartSyncOffset(w.data(), w.size()) : 0;
+                uint32_t total;
+                if (link.version >= PAPA_PROTO_WINDOWED) {
+                    resent += tx.chunksResent();  // begin() starts the counters over
+                    tx.begin(cap.data() + offset, (uint16_t)(cap.size() - offset), link.chunkSize, link.window,
+                             crc32Update(0, cap.data(), offset));
+                    total = tx.totalChunks();
+                } else {
+                    legacySeq = 0;
+                    legacyDue = true;
+                    total = (cap.size() + PAPA_LEGACY_CHUNK - 1) / PAPA_LEGACY_CHUNK;
+                }
+                Packet rsp(5, 0);
+                rsp[0] = SIM_RSP_SYNC_START;
+                rsp[1] = total & 0xFF;
+                rsp[2] = total >> 8;
+                ctrlOut.push_back(rsp);
+                lastHeard = event;
+                break;
+            }
+            case SIM_CMD_ACK_CHUNK: {
+                uint16_t seq = w[1] | (w[2] << 8);
+                if (current >= 0 && seq == legacySeq) {
+                    legacySeq++;
+                    legacyDue = true;
+                    lastHeard = event;
+                }
+                break;
+            }
+            case PAPA_CMD_ACK_WINDOW: {
+                uint16_t next;
+                uint32_t mask;
+                uint8_t flags;
+                if (papaParseAck(w.data(), w.size(), next, mask, flags)) tx.onAck(next, mask, flags);
+                lastHeard = event;
+                break;
+            }
+            case SIM_CMD_MARK_SYNCED:
+                current = -1;
+                break;
+            case SIM_CMD_PURGE: {
+                Packet rsp(2, 0);
+                rsp[0] = SIM_RSP_PURGED;
+                ctrlOut.push_back(rsp);
+                break;
+            }
+        }
+    }
+
+    // Next data notification for this event, false if nothing to send
+    bool nextData(Packet& out, uint32_t event) {
+        if (current < 0) return false;
+        const Packet& cap = captures[current];
+        if (link.version >= PAPA_PROTO_WINDOWED) {
+            // Nothing heard for ~300ms: the tail or the end marker was lost
+            if (event - lastHeard > timeoutEvents(300)) {
+                tx.onTimeout();
+                lastHeard = event;
+            }
+            uint8_t pkt[PAPA_CHUNK_MAX + 2];
+            size_t n = tx.nextPacket(pkt);
+            if (n == 0) return false;
+            out.assign(pkt, pkt + n);
+            return true;
+        }
+        // Revision 1: resend the chunk if its ACK hasn't come within a second
+        if (!legacyDue && event - lastHeard > timeoutEvents(1000)) {
+            legacyDue = true;
+            lastHeard = event;
+            resent++;
+        }
+        if (!legacyDue) return false;
+        legacyDue = false;
+        uint32_t offset = (uint32_t)legacySeq * PAPA_LEGACY_CHUNK;
+        if (offset >= cap.size()) {
+            uint32_t crc = crc32Update(0, cap.data(), cap.size());
+            uint8_t end[6] = {0xFF, 0xFF, (uint8_t)crc, (uint8_t)(crc >> 8), (uint8_t)(crc >> 16), (uint8_t)(crc >> 24)};
+            out.assign(end, end + 6);
+            return true;
+        }
+        size_t n = cap.size() - offset < PAPA_LEGACY_CHUNK ? cap.size() - offset : PAPA_LEGACY_CHUNK;
+        out.resize(n + 2);
+        out[0] = legacySeq & 0xFF;
+        out[1] = legacySeq >> 8;
+        memcpy(out.data() + 2, cap.data() + offset, n);
+        return true;
+    }
+
+    uint32_t retransmits() const { return resent + tx.chunksResent(); }
+
+private:
+    uint32_t timeoutEvents(double ms) const { return (uint32_t)(ms / config.intervalMs) + 1; }
+
+    const std::vector<Packet>& captures;
+    PapaSimConfig config;
+    PapaLink link;
+    int current;
+    uint16_t legacySeq;
+    bool legacyDue;
+    uint32_t lastHeard;
+    uint32_t resent;
+    PapaTxWindow tx;
+};
+
+// Papa's side, following call_papa.cpp. What it saved (its SD card) and a
+// resume point outlive a dropped link, like CallPapaMode's statics do.
+class SimPapa {
+public:
+    SimPapa(const std::vector<Packet>& caps, const PapaSimConfig& cfg)
+        : captures(caps), config(cfg), bad(0), skipped(0) {
+        resume.valid = false;
+        linkLost();
+    }
+
+    std::deque<Packet> writes;
+    std::vector<PapaDigest> sd;    // Captures on Papa's SD
+
+    void linkLost() {
+        // CallPapaMode::saveResumePoint()
+        if (link.version >= PAPA_PROTO_RESUME && rx.isActive()) {
+            uint32_t bytes = resumeOffset + rx.contiguousLength();
+            if (bytes > 0) {
+                resume.valid = true;
+                resume.digest = digest;
+                resume.bytes = (uint16_t)bytes;
+                resume.crc = rx.crcValue();
+            }
+        }
+        rx.reset();
+        manifest.clear();
+        manifestPending = false;
+        manifestWanted = false;
+        link = papaLegacyLink();
+        offerChunk = PAPA_LEGACY_CHUNK;
+        index = 0;
+        rxLen = 0;
+        resumeOffset = 0;
+        lastChunk = 0;
+        done = false;
+        writes.clear();
+    }
+
+    void hello() {
+        uint8_t h[PAPA_HELLO_LEN];
+        offerChunk = papaChunkForMtu(config.mtu);
+        writes.push_back(Packet(h, h + papaBuildHello(h, offerChunk, PAPA_WINDOW_DEFAULT)));
+    }
+
+    void onNotify(const Packet& p, bool data, uint32_t event) {
+        if (!data) {
+            if (p[0] == SIM_RSP_HELLO) {
+                link = papaParseHelloRsp(p.data(), p.size(), offerChunk, PAPA_WINDOW_DEFAULT);
+                requestNext();
+            } else if (p[0] == PAPA_RSP_MANIFEST) {
+                onManifest(p);
+            } else if (p[0] == SIM_RSP_SYNC_START) {
+                uint16_t total = p[1] | (p[2] << 8);
+                rxLen = 0;
+                lastChunk = event;
+                if (link.version >= PAPA_PROTO_WINDOWED) {
+                    uint32_t crcSoFar = resumeOffset ? resume.crc : 0;
+                    if (resumeOffset == 0) resume.valid = false;
+                    rx.begin(buf + resumeOffset, sizeof(buf) - resumeOffset, link.chunkSize, total, link.window, crcSoFar);
+                }
+            } else if (p[0] == SIM_RSP_PURGED) {
+                done = true;
+            }
+            return;
+        }
+
+        uint16_t seq = p[0] | (p[1] << 8);
+        if (link.version >= PAPA_PROTO_WINDOWED) {
+            // Same steps as CallPapaMode::onWindowedData
+            if (seq == PAPA_SEQ_END) {
+                if (!rx.onEnd(p[2] | (p[3] << 8) | (p[4] << 16) | ((uint32_t)p[5] << 24))) return;
+            } else if (!rx.onChunk(seq, p.data() + 2, (uint16_t)(p.size() - 2))) {
+                return;
+            }
+            lastChunk = event;
+            if (rx.complete()) {
+                rxLen = resumeOffset + rx.length();
+                bool ok = rx.crcOk();
+                rx.reset();
+                finish(ok);
+            } else if (rx.ackDue()) {
+                uint8_t ack[PAPA_ACK_LEN];
+                writes.push_back(Packet(ack, ack + rx.takeAck(ack)));
+            }
+            return;
+        }
+
+        // Revision 1, as dataNotifyCallback does it
+        if (seq == PAPA_SEQ_END) {
+            uint32_t want = p[2] | (p[3] << 8) | (p[4] << 16) | ((uint32_t)p[5] << 24);
+            finish(crc32Update(0, buf, rxLen) == want);
+            return;
+        }
+        uint32_t offset = (uint32_t)seq * PAPA_LEGACY_CHUNK;
+        if (offset + p.size() - 2 <= sizeof(buf)) {
+            memcpy(buf + offset, p.data() + 2, p.size() - 2);
+            if (offset + p.size() - 2 > rxLen) rxLen = offset + p.size() - 2;
+        }
+        uint8_t ack[3] = {SIM_CMD_ACK_CHUNK, (uint8_t)(seq & 0xFF), (uint8_t)(seq >> 8)};
+        writes.push_back(Packet(ack, ack + 3));
+    }
+
+    // update()'s window ACK watchdog
+    void tick(uint32_t event) {
+        if (link.version >= PAPA_PROTO_WINDOWED && rx.isActive() &&
+            event - lastChunk > (uint32_t)(250 / config.intervalMs) + 1) {
+            lastChunk = event;
+            uint8_t ack[PAPA_ACK_LEN];
+            writes.push_back(Packet(ack, ack + rx.takeAck(ack)));
+        }
+    }
+
+    bool isDone() const { return done; }
+    uint32_t badCaptures() const { return bad; }
+    uint32_t skippedCaptures() const { return skipped; }
+    uint32_t synced() const { return index; }
+    const PapaLink& agreed() const { return link; }
+
+private:
+    // CallPapaMode::onManifest
+    void onManifest(const Packet& p) {
+        if (!manifest.parse(p.data(), p.size())) return;
+        manifestPending = false;
+        if (!manifestWanted) return;
+        manifestWanted = false;
+        requestNext();
+    }
+
+    // CallPapaMode::skipKnownCapture
+    bool skipKnown() {
+        const PapaDigest* d = manifest.find(0x01, (uint16_t)index);
+        if (!d) return false;
+        for (size_t i = 0; i < sd.size(); i++) {
+            if (sd[i].type == d->type && memcmp(sd[i].bssid, d->bssid, 6) == 0) {
+                skipped++;
+                uint8_t mark[4] = {SIM_CMD_MARK_SYNCED, 0x01, (uint8_t)(index & 0xFF), (uint8_t)(index >> 8)};
+                writes.push_back(Packet(mark, mark + 4));
+                index++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // CallPapaMode::startCapture
+    void start(const PapaDigest& d) {
+        digest = d;
+        resumeOffset = papaResumeOffset(resume, d);
+        uint8_t cmd[PAPA_START_SYNC_LEN];
+        writes.push_back(Packet(cmd, cmd + papaBuildStartSync(cmd, 0x01, (uint16_t)index, resumeOffset)));
+        if (manifest.endsAt(d.type, d.index)) getManifest(d.index + 1);
+    }
+
+    // CallPapaMode::sendGetManifest
+    void getManifest(uint32_t first) {
+        if (first >= captures.size()) return;
+        uint8_t fit = papaManifestFit(config.mtu);
+        uint8_t n = captures.size() - first < fit ? (uint8_t)(captures.size() - first) : fit;
+        uint8_t cmd[PAPA_GET_MANIFEST_LEN];
+        writes.push_back(Packet(cmd, cmd + papaBuildGetManifest(cmd, 0x01, (uint16_t)first, n)));
+        manifestPending = true;
+    }
+
+    void finish(bool crcOk) {
+        if (!crcOk) {
+            bad++;
+            resume.valid = false;
+            resumeOffset = 0;
+            writes.push_back(startSync(index));
+            return;
+        }
+        const Packet& want = captures[index];
+        if (rxLen != want.size() || memcmp(buf, want.data(), rxLen) != 0) bad++;
+        sd.push_back(papaDigestOf(0x01, (uint16_t)index, want.data(), (uint16_t)want.size()));
+        resume.valid = false;
+        resumeOffset = 0;
+        uint8_t mark[4] = {SIM_CMD_MARK_SYNCED, 0x01, (uint8_t)(index & 0xFF), (uint8_t)(index >> 8)};
+        writes.push_back(Packet(mark, mark + 4));
+        index++;
+        requestNext();
+    }
+
+    // CallPapaMode::requestNextCapture + requestCapture
+    void requestNext() {
+        resumeOffset = 0;
+        if (link.version >= PAPA_PROTO_RESUME) {
+            while (skipKnown()) {}
+        }
+        if (index >= captures.size()) {
+            writes.push_back(Packet(1, SIM_CMD_PURGE));
+        } else if (link.version >= PAPA_PROTO_RESUME) {
+            const PapaDigest* d = manifest.find(0x01, (uint16_t)index);
+            if (d) {
+                start(*d);
+            } else {
+                manifestWanted = true;
+                if (!manifestPending) getManifest(index);
+            }
+        } else {
+            writes.push_back(startSync(index));
+        }
+    }
+
+    static Packet startSync(uint16_t i) {
+        uint8_t cmd[4] = {SIM_CMD_START_SYNC, 0x01, (uint8_t)(i & 0xFF), (uint8_t)(i >> 8)};
+        return Packet(cmd, cmd + 4);
+    }
+
+    const std::vector<Packet>& captures;
+    PapaSimConfig config;
+    PapaLink link;
+    uint16_t offerChunk;
+    uint32_t index;
+    uint8_t buf[2048];           // CallPapaMode::RX_BUFFER_SIZE
+    uint32_t rxLen;
+    PapaRxWindow rx;
+    PapaManifest manifest;
+    bool manifestPending;
+    bool manifestWanted;
+    PapaDigest digest;
+    PapaResumePoint resume;
+    uint16_t resumeOffset;
+    uint32_t lastChunk;
+    bool done;
+    uint32_t bad;
+    uint32_t skipped;
+};
+
+// What a Sirloin buffer holds after a session: PMKIDs (65 bytes) and
+// handshakes (header + beacon + 2-4 EAPOL frames, ~0.6-1.6KB)
+static std::vector<Packet> synthCaptures(int count) {
+    std::vector<Packet> caps;
+    for (int i = 0; i < count; i++) {
+        size_t len = 65;
+        if (lcg() % 5 < 2) {
+            len = 48 + 120 + lcg() % 180;
+            int frames = 2 + lcg() % 3;
+            for (int f = 0; f < frames; f++) len += 2 + 95 + lcg() % 27 + 2 + 130 + lcg() % 31 + 6;
+        }
+        if (len > 2048) len = 2048;
+        Packet p(len);
+        for (size_t k = 0; k < len; k++) p[k] = (uint8_t)lcg();
+        caps.push_back(p);
+    }
+    return caps;
+}
+
+static PapaSimResult runPapaSim(const std::vector<Packet>& caps, const PapaSimConfig& cfg, SimPapa& papa) {
+    SimSirloin sirloin(caps, cfg);
+    PapaSimResult r;
+    memset(&r, 0, sizeof(r));
+    papa.linkLost();
+    papa.hello();
+    uint32_t skippedBefore = papa.skippedCaptures();
+
+    const uint32_t EVENT_LIMIT = 2000000;
+    uint32_t event = 0;
+    std::vector<std::pair<Packet, bool> > toPapa;
+    std::vector<Packet> toSirloin;
+    for (; !papa.isDone() && event < EVENT_LIMIT; event++) {
+        if (cfg.dropAt && event == cfg.dropAt) {
+            papa.linkLost();
+            sirloin.linkLost();
+            event += cfg.reconnectEvents;
+            papa.hello();
+        }
+        toPapa.clear();
+        toSirloin.clear();
+
+        // Sirloin -> Papa: control responses first, then data
+        int budget = cfg.perEvent;
+        while (budget > 0 && !sirloin.ctrlOut.empty()) {
+            r.airBytes += sirloin.ctrlOut.front().size();
+            toPapa.push_back(std::make_pair(sirloin.ctrlOut.front(), false));
+            sirloin.ctrlOut.pop_front();
+            budget--;
+        }
+        Packet pkt;
+        while (budget > 0 && sirloin.nextData(pkt, event)) {
+            budget--;
+            r.airBytes += pkt.size();
+            if (!simDrop(cfg.loss)) toPapa.push_back(std::make_pair(pkt, true));
+        }
+
+        // Papa -> Sirloin
+        for (int i = 0; i < cfg.perEvent && !papa.writes.empty(); i++) {
+            Packet w = papa.writes.front();
+            papa.writes.pop_front();
+            r.airBytes += w.size();
+            bool ack = (w[0] == SIM_CMD_ACK_CHUNK || w[0] == PAPA_CMD_ACK_WINDOW);
+            if (!(ack && simDrop(cfg.loss))) toSirloin.push_back(w);
+        }
+
+        // Both sides process after the event; replies wait for the next one
+        for (size_t i = 0; i < toPapa.size(); i++) papa.onNotify(toPapa[i].first, toPapa[i].second, event);
+        for (size_t i = 0; i < toSirloin.size(); i++) sirloin.onWrite(toSirloin[i], event);
+        papa.tick(event);
+    }
+
+    r.events = event;
+    r.resent = sirloin.retransmits();
+    r.captures = papa.synced();
+    r.skipped = papa.skippedCaptures() - skippedBefore;
+    r.bad = papa.badCaptures() + (papa.isDone() ? 0 : 1);
+    r.link = papa.agreed();
+    return r;
+}
+
+static int benchPapa(int argc, char** argv) {
+    int count = 50;
+    PapaSimConfig base;
+    base.mtu = PAPA_MTU_PREFERRED;
+    base.sirloinVersion = PAPA_PROTO_LATEST;
+    base.perEvent = 4;
+    base.intervalMs = 30;      // setConnectionParams(24, ...) = 30ms
+    base.loss = 0;
+    base.dropAt = 0;
+    base.reconnectEvents = 0;
+    for (int i = 0; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--captures") == 0) count = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--loss") == 0) base.loss = atof(argv[i + 1]) / 100;
+        else if (strcmp(argv[i], "--interval") == 0) base.intervalMs = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--per-event") == 0) base.perEvent = atoi(argv[i + 1]);
+    }
+    if (count < 1 || base.perEvent < 1 || base.intervalMs <= 0) {
+        fprintf(stderr, "[BENCH] Bad papa options\n");
+        return 2;
+    }
+
+    std::vector<Packet> caps = synthCaptures(count);
+    size_t total = 0;
+    for (size_t i = 0; i < caps.size(); i++) total += caps[i].size();
+    printf("[BENCH] papa: %d captures, %zu bytes, %.1fms interval, %d packets/event, %.1f%% loss\n",
+           count, total, base.intervalMs, base.perEvent, base.loss * 100);
+    printf("  %-26s %5s %6s %7s %8s %8s %7s %7s\n", "sirloin / link", "chunk", "window", "events", "seconds",
+           "air B", "resent", "skipped");
+
+    // Resync: Papa already has every capture. Cut: the link drops halfway
+    // through a fresh sync and takes ~2s to come back.
+    enum { FRESH, RESYNC, CUT };
+    struct Case { const char* name; uint8_t version; uint16_t mtu; int scenario; };
+    const Case CASES[] = {
+        {"rev 1 firmware", PAPA_PROTO_LEGACY, PAPA_MTU_PREFERRED, FRESH},
+        {"rev 2, MTU 23", PAPA_PROTO_WINDOWED, 23, FRESH},
+        {"rev 2, MTU 185", PAPA_PROTO_WINDOWED, 185, FRESH},
+        {"rev 2, MTU 247", PAPA_PROTO_WINDOWED, PAPA_MTU_PREFERRED, FRESH},
+        {"rev 3, MTU 23", PAPA_PROTO_RESUME, 23, FRESH},
+        {"rev 3, MTU 247", PAPA_PROTO_RESUME, PAPA_MTU_PREFERRED, FRESH},
+        {"rev 2, resync", PAPA_PROTO_WINDOWED, PAPA_MTU_PREFERRED, RESYNC},
+        {"rev 3, resync", PAPA_PROTO_RESUME, PAPA_MTU_PREFERRED, RESYNC},
+        {"rev 2, cut mid-sync", PAPA_PROTO_WINDOWED, PAPA_MTU_PREFERRED, CUT},
+        {"rev 3, cut mid-sync", PAPA_PROTO_RESUME, PAPA_MTU_PREFERRED, CUT},
+    };
+    bool ok = true;
+    for (const Case& c : CASES) {
+        PapaSimConfig cfg = base;
+        cfg.sirloinVersion = c.version;
+        cfg.mtu = c.mtu;
+        SimPapa* papa = new SimPapa(caps, cfg);
+        if (c.scenario == RESYNC) {
+            PapaSimConfig first = cfg;
+            first.loss = 0;
+            runPapaSim(caps, first, *papa);
+        } else if (c.scenario == CUT) {
+            cfg.dropAt = 61;
+            cfg.reconnectEvents = (uint32_t)(2000 / cfg.intervalMs);
+        }
+        lcgState = 0x53494D31;  // Same drops for every case
+        PapaSimResult r = runPapaSim(caps, cfg, *papa);
+        delete papa;
+        double sec = r.events * cfg.intervalMs / 1000;
+        bool good = r.bad == 0 && r.captures == caps.size();
+        printf("  %-26s %5u %6u %7u %8.2f %8u %7u %7u%s\n", c.name, r.link.chunkSize, r.link.window, r.events,
+               sec, r.airBytes, r.resent, r.skipped, good ? "" : "  FAILED");
+        ok &= good;
+    }
+    printf("  (HELLO and sync only - the dialogue lines add ~7.5s either way)\n");
+    return ok ? 0 : 1;
+}
+
+// ============ crc32 ============
+
+// The implementations crc32.h replaced, kept here as the baseline
+static uint32_t crcBitwise(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; j++) crc = (crc >> 1) ^ (CRC32_POLY & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static uint32_t crcNibble(uint32_t crc, const uint8_t* data, size_t len) {
+    static const uint32_t NIBBLE[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ NIBBLE[crc & 0x0F];
+        crc = (crc >> 4) ^ NIBBLE[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static uint32_t crcZlib(uint32_t crc, const uint8_t* data, size_t len) {
+    return (uint32_t)crc32(crc, data, (uInt)len);
+}
+
+static int benchCrc32(int argc, char** argv) {
+    size_t totalBytes = 64u << 20;
+    for (int i = 0; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--bytes") == 0) totalBytes = strtoul(argv[i + 1], nullptr, 10);
+    }
+    if (totalBytes == 0) {
+        fprintf(stderr, "[BENCH] Bad crc32 options\n");
+        return 2;
+    }
+
+    struct Impl { const char* name; uint32_t (*fn)(uint32_t, const uint8_t*, size_t); };
+    const Impl IMPLS[] = {
+        {"bitwise (old papa)", crcBitwise},
+        {"nibble (old zip)", crcNibble},
+        {"slice-by-8", crc32Slice8},
+        {"zlib", crcZlib},
+    };
+    // Legacy and windowed CALL PAPA chunks, a capture, SD/ZIP I/O chunks
+    const size_t SIZES[] = {17, 242, 2048, 16384, 1u << 20};
+
+    std::vector<uint8_t> data(SIZES[sizeof(SIZES) / sizeof(SIZES[0]) - 1] + 7);
+    for (size_t i = 0; i < data.size(); i++) data[i] = (uint8_t)lcg();
+    const uint8_t* base = data.data() + 1;  // Unaligned on purpose
+    crc32Tables();                          // Table build is a one-off, leave it out
+
+    printf("[BENCH] crc32: %zu bytes per cell, MB/s\n", totalBytes);
+    printf("  %-20s", "buffer");
+    for (size_t s : SIZES) printf(" %9zu", s);
+    printf("\n");
+
+    bool ok = true;
+    for (const Impl& impl : IMPLS) {
+        printf("  %-20s", impl.name);
+        for (size_t s : SIZES) {
+            if (impl.fn(0, base, s) != crcBitwise(0, base, s)) ok = false;
+            size_t rounds = totalBytes / s + 1;
+            if (impl.fn == crcBitwise) rounds = rounds / 8 + 1;  // It's slow enough already
+            uint32_t crc = 0;
+            BenchClock::time_point t0 = BenchClock::now();
+            for (size_t r = 0; r < rounds; r++) crc = impl.fn(crc, base, s);
+            double ms = msSince(t0);
+            volatile uint32_t sink = crc;
+            (void)sink;
+            printf(" %9.0f", rounds * s / (ms * 1000));
+        }
+        printf("\n");
+    }
+    if (!ok) printf("  MISMATCH against the bitwise reference\n");
+    return ok ? 0 : 1;
+}
+
+// ============ ml ============
+
+// MLInference::runInference before the batch kernel: one float feature
+// vector in, normalized scores and the winning class out
+static uint8_t mlOneAtATime(const float* input, float* scores) {
+    float rssi = input[0];
+    uint8_t channel = (uint8_t)input[3];
+    bool hasWPS = input[8] > 0.5f, hasWPA = input[9] > 0.5f, hasWPA2 = input[10] > 0.5f;
+    bool hasWPA3 = input[11] > 0.5f, isHidden = input[12] > 0.5f;
+    bool hasHT = input[20] > 0.5f, hasVHT = input[21] > 0.5f;
+    float anomaly = 0, twin = 0, vuln = 0, deauth = 0;
+    if (rssi > -30) anomaly += 0.3f;
+    if (input[5] < 50 || input[5] > 200) anomaly += 0.2f;
+    if (input[15] > 10.0f) anomaly += 0.15f;
+    if ((uint8_t)input[18] < 2) anomaly += 0.1f;
+    if (!hasWPA && !hasWPA2 && !hasWPA3 && hasWPS) anomaly += 0.25f;
+    if (channel <= 14 && channel != 1 && channel != 6 && channel != 11) anomaly += 0.05f;
+    if (hasVHT && !hasHT) anomaly += 0.2f;
+    if ((uint8_t)input[19] < 4) anomaly += 0.1f;
+    if (isHidden && rssi > -50) twin += 0.2f;
+    if (!hasWPA && !hasWPA2 && !hasWPA3) vuln += 0.5f;
+    if (hasWPA && !hasWPA2 && !hasWPA3) vuln += 0.4f;
+    if (hasWPS) vuln += 0.2f;
+    if (isHidden && vuln > 0.3f) vuln += 0.1f;
+    if (rssi > -70 && rssi < -30) deauth += 0.2f;
+    if (!hasWPA3) deauth += 0.3f;
+    scores[0] = 1.0f - (anomaly + twin + vuln) / 3.0f;
+    scores[1] = anomaly < 1.0f ? anomaly : 1.0f;
+    scores[2] = twin < 1.0f ? twin : 1.0f;
+    scores[3] = deauth < 1.0f ? deauth : 1.0f;
+    scores[4] = vuln < 1.0f ? vuln : 1.0f;
+    float sum = 0;
+    for (int i = 0; i < 5; i++) sum += scores[i];
+    for (int i = 0; i < 5; i++) scores[i] /= sum;
+    uint8_t best = 0;
+    for (uint8_t i = 1; i < 5; i++) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    return best;
+}
+
+static void synthFeatures(float* v) {
+    static const float INTERVALS[] = {100, 100, 100, 102, 20, 300};
+    static const uint8_t CHANNELS[] = {1, 6, 11, 1, 6, 11, 3, 9, 13};
+    memset(v, 0, sizeof(float) * ML_BATCH_FEATURES);
+    v[0] = -95.0f + lcg() % 70;
+    v[1] = -95.0f;
+    v[2] = v[0] - v[1];
+    v[3] = CHANNELS[lcg() % 9];
+    v[5] = INTERVALS[lcg() % 6];
+    for (int f = 8; f <= 12; f++) v[f] = (float)(lcg() % 2);
+    v[14] = (float)(lcg() % 500);
+    v[15] = (lcg() % 160) / 8.0f;
+    v[18] = (float)(lcg() % 6);
+    v[19] = (float)(4 + lcg() % 9);
+    v[20] = lcg() % 2 ? 4.0f : 0.0f;
+    v[21] = (float)(lcg() % 2);
+}
+
+static int benchMl(int argc, char** argv) {
+    int networks = 200;
+    int rounds = 2000;
+    for (int i = 0; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--networks") == 0) networks = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--rounds") == 0) rounds = atoi(argv[i + 1]);
+    }
+    if (networks < 1 || networks > 65535 || rounds < 1) {
+        fprintf(stderr, "[BENCH] Bad ml options\n");
+        return 2;
+    }
+
+    // The table as the modes hold it: one float vector per network
+    std::vector<float> rows((size_t)networks * ML_BATCH_FEATURES);
+    for (int i = 0; i < networks; i++) synthFeatures(&rows[(size_t)i * ML_BATCH_FEATURES]);
+    std::vector<float> floatCols(MLFloatBatch::bytesFor(networks) / sizeof(float));
+    std::vector<int16_t> fixedCols(MLFixedBatch::bytesFor(networks) / sizeof(int16_t));
+    MLFloatBatch floatBatch;
+    MLFixedBatch fixedBatch;
+    std::vector<MLScores> out(networks);
+    std::vector<uint8_t> labels(networks);
+
+    printf("[BENCH] ml: %d networks, %d rounds\n", networks, rounds);
+    printf("  %-24s %9s %12s %9s %9s\n", "path", "fill us", "classify us", "ns/net", "buffer B");
+
+    float scores[5];
+    BenchClock::time_point t0 = BenchClock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < networks; i++) labels[i] = mlOneAtATime(&rows[(size_t)i * ML_BATCH_FEATURES], scores);
+    }
+    double ms = msSince(t0);
+    printf("  %-24s %9s %12.2f %9.1f %9s\n", "one at a time (float)", "-", ms * 1000 / rounds,
+           ms * 1e6 / rounds / networks, "-");
+
+    bool ok = true;
+    const char* NAMES[2] = {"batch, float columns", "batch, int16 columns"};
+    for (int kind = 0; kind < 2; kind++) {
+        t0 = BenchClock::now();
+        for (int r = 0; r < rounds; r++) {
+            if (kind == 0) {
+                floatBatch.attach(floatCols.data(), networks);
+                for (int i = 0; i < networks; i++) floatBatch.add(&rows[(size_t)i * ML_BATCH_FEATURES]);
+            } else {
+                fixedBatch.attach(fixedCols.data(), networks);
+                for (int i = 0; i < networks; i++) fixedBatch.add(&rows[(size_t)i * ML_BATCH_FEATURES]);
+            }
+        }
+        double fillMs = msSince(t0);
+        t0 = BenchClock::now();
+        for (int r = 0; r < rounds; r++) {
+            if (kind == 0) mlClassifyHeuristic(floatBatch, 0, networks, out.data());
+            else mlClassifyHeuristic(fixedBatch, 0, networks, out.data());
+        }
+        ms = msSince(t0);
+        size_t bytes = kind == 0 ? MLFloatBatch::bytesFor(networks) : MLFixedBatch::bytesFor(networks);
+        printf("  %-24s %9.2f %12.2f %9.1f %9zu\n", NAMES[kind], fillMs * 1000 / rounds, ms * 1000 / rounds,
+               ms * 1e6 / rounds / networks, bytes);
+
+        // The float path breaks exact ties by rounding noise; the batch
+        // takes the first class. Anything else is a real disagreement.
+        int ties = 0, differ = 0;
+        for (int i = 0; i < networks; i++) {
+            if (out[i].label == labels[i]) continue;
+            mlOneAtATime(&rows[(size_t)i * ML_BATCH_FEATURES], scores);
+            if (fabsf(scores[out[i].label] - scores[labels[i]]) < 1e-6f) ties++;
+            else differ++;
+        }
+        if (ties) printf("  (%d exact ties settled the other way)\n", ties);
+        if (differ) {
+            printf("  %d labels differ from one-at-a-time\n", differ);
+            ok = false;
+        }
+    }
+    printf("  (host only: on device each classify() also pays micros(), PERF_SCOPE and a mood update)\n");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && strcmp(argv[1], "gzip") == 0) return benchGzip(argc - 2, argv + 2);
+    if (argc >= 2 && strcmp(argv[1], "papa") == 0) return benchPapa(argc - 2, argv + 2);
+    if (argc >= 2 && strcmp(argv[1], "crc32") == 0) return benchCrc32(argc - 2, argv + 2);
+    if (argc >= 2 && strcmp(argv[1], "ml") == 0) return benchMl(argc - 2, argv + 2);
+    fprintf(stderr, "usage: bench gzip [file.csv] [--bytes N]\n"
+                    "       bench papa [--captures N] [--loss PCT] [--interval MS] [--per-event N]\n"
+                    "       bench crc32 [--bytes N]\n"
+                    "       bench ml [--networks N] [--rounds N]\n");
+    return 2;
+}
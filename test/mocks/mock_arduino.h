@@ -7,20 +7,28 @@
 #include <cmath>
 #include <string>
 #include <cstdlib>
+#include <cstdio>
+#include <cstdarg>
+#include <algorithm>
 
 // Arduino-style type definitions
 typedef uint8_t byte;
 
-// Time functions - use static counter for deterministic testing
-inline uint32_t millis() {
+// Time functions - static counter for deterministic testing.
+// Nothing advances it except setMillis()/delay(), so a test (or the replay
+// harness) owns the clock.
+inline uint32_t& mockMillisCounter() {
     static uint32_t ms = 0;
     return ms;
 }
 
+inline uint32_t millis() {
+    return mockMillisCounter();
+}
+
 inline void setMillis(uint32_t ms) {
     // For test control - not in real Arduino
-    static uint32_t* ptr = nullptr;
-    // This is a workaround - tests can call millis() and it returns 0
+    mockMillisCounter() = ms;
 }
 
 inline uint32_t micros() {
@@ -28,7 +36,8 @@ inline uint32_t micros() {
 }
 
 inline void delay(uint32_t ms) {
-    // No-op in tests
+    // Time passes, nothing else happens
+    mockMillisCounter() += ms;
 }
 
 inline void delayMicroseconds(uint32_t us) {
@@ -57,17 +66,11 @@ inline void randomSeed(unsigned long seed) {
 #define M_PI 3.14159265358979323846
 #endif
 
-#ifndef min
-#define min(a,b) ((a)<(b)?(a):(b))
-#endif
-
-#ifndef max
-#define max(a,b) ((a)>(b)?(a):(b))
-#endif
-
-#ifndef abs
-#define abs(x) ((x)>0?(x):-(x))
-#endif
+// Arduino-ESP32 pulls these from <algorithm> instead of the classic macros,
+// which would break any standard header included after this one
+using std::min;
+using std::max;
+using std::abs;
 
 #ifndef constrain
 #define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
@@ -121,6 +124,41 @@ public:
         return pos == std::string::npos ? -1 : (int)pos;
     }
     
+    int indexOf(const char* s, size_t from = 0) const {
+        size_t pos = str.find(s, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    
+    int lastIndexOf(char c) const {
+        size_t pos = str.rfind(c);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    
+    bool startsWith(const char* s) const { return str.compare(0, strlen(s), s) == 0; }
+    bool startsWith(const String& s) const { return startsWith(s.c_str()); }
+    bool endsWith(const char* s) const {
+        size_t n = strlen(s);
+        return str.size() >= n && str.compare(str.size() - n, n, s) == 0;
+    }
+    bool endsWith(const String& s) const { return endsWith(s.c_str()); }
+    bool equals(const String& s) const { return str == s.str; }
+    bool equalsIgnoreCase(const String& s) const {
+        if (str.size() != s.str.size()) return false;
+        for (size_t i = 0; i < str.size(); i++) {
+            if (tolower(str[i]) != tolower(s.str[i])) return false;
+        }
+        return true;
+    }
+    char charAt(size_t index) const { return index < str.size() ? str[index] : 0; }
+    void reserve(size_t n) { str.reserve(n); }
+    void replace(const char* from, const char* to) {
+        size_t n = strlen(from);
+        if (n == 0) return;
+        for (size_t pos = 0; (pos = str.find(from, pos)) != std::string::npos; pos += strlen(to)) {
+            str.replace(pos, n, to);
+        }
+    }
+    
     String substring(size_t from) const { return String(str.substr(from).c_str()); }
     String substring(size_t from, size_t to) const { return String(str.substr(from, to - from).c_str()); }
     
@@ -146,37 +184,72 @@ private:
     std::string str;
 };
 
-// Serial stub
+// Serial stub - silent unless echo is set (replay harness -v)
 class SerialClass {
 public:
+    bool echo = false;
+    
     void begin(long baud) {}
     void end() {}
-    void print(const char* s) {}
-    void print(int n) {}
-    void print(unsigned int n) {}
-    void print(long n) {}
-    void print(unsigned long n) {}
-    void print(float n, int decimals = 2) {}
-    void print(double n, int decimals = 2) {}
-    void print(const String& s) {}
-    void println() {}
-    void println(const char* s) {}
-    void println(int n) {}
-    void println(unsigned int n) {}
-    void println(long n) {}
-    void println(unsigned long n) {}
-    void println(float n, int decimals = 2) {}
-    void println(double n, int decimals = 2) {}
-    void println(const String& s) {}
-    void printf(const char* format, ...) {}
+    void print(const char* s) { out("%s", s); }
+    void print(int n) { out("%d", n); }
+    void print(unsigned int n) { out("%u", n); }
+    void print(long n) { out("%ld", n); }
+    void print(unsigned long n) { out("%lu", n); }
+    void print(float n, int decimals = 2) { out("%.*f", decimals, n); }
+    void print(double n, int decimals = 2) { out("%.*f", decimals, n); }
+    void print(const String& s) { out("%s", s.c_str()); }
+    void println() { out("\n"); }
+    void println(const char* s) { out("%s\n", s); }
+    void println(int n) { out("%d\n", n); }
+    void println(unsigned int n) { out("%u\n", n); }
+    void println(long n) { out("%ld\n", n); }
+    void println(unsigned long n) { out("%lu\n", n); }
+    void println(float n, int decimals = 2) { out("%.*f\n", decimals, n); }
+    void println(double n, int decimals = 2) { out("%.*f\n", decimals, n); }
+    void println(const String& s) { out("%s\n", s.c_str()); }
+    void printf(const char* format, ...) {
+        if (!echo) return;
+        va_list args;
+        va_start(args, format);
+        vprintf(format, args);
+        va_end(args);
+    }
     int available() { return 0; }
     int read() { return -1; }
     void write(uint8_t b) {}
     void write(const uint8_t* buf, size_t len) {}
     void flush() {}
     operator bool() { return true; }
+    
+private:
+    template <typename... Args>
+    void out(const char* format, Args... args) {
+        if (echo) std::printf(format, args...);
+    }
+};
+
+// ESP system stub - heap figures are whatever the test says they are
+class EspClass {
+public:
+    uint32_t freeHeap = 200000;
+    
+    uint32_t getFreeHeap() { return freeHeap; }
+    uint32_t getMinFreeHeap() { return freeHeap; }
+    uint32_t getMaxAllocHeap() { return freeHeap; }
+    uint32_t getHeapSize() { return 320000; }
+    uint32_t getPsramSize() { return 0; }
+    uint32_t getFreePsram() { return 0; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    void restart() {}
 };
 
+inline EspClass ESP;
+
+inline uint32_t esp_random() {
+    return ((uint32_t)std::rand() << 16) ^ (uint32_t)std::rand();
+}
+
 // GPIO stubs
 #define INPUT 0
 #define OUTPUT 1
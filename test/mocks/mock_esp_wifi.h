@@ -2,6 +2,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 
 // WiFi auth modes
 typedef enum {
@@ -115,3 +116,97 @@ typedef struct {
 typedef int esp_err_t;
 #define ESP_OK 0
 #define ESP_FAIL -1
+#define ESP_ERR_WIFI_NOT_INIT 0x3001
+
+typedef enum {
+    WIFI_IF_STA = 0,
+    WIFI_IF_AP,
+} wifi_interface_t;
+
+typedef enum {
+    WIFI_MODE_NULL = 0,
+    WIFI_MODE_STA,
+    WIFI_MODE_AP,
+    WIFI_MODE_APSTA,
+} wifi_mode_t;
+
+#define WIFI_PROMIS_FILTER_MASK_ALL   0xFFFFFFFF
+#define WIFI_PROMIS_FILTER_MASK_MGMT  (1 << 0)
+#define WIFI_PROMIS_FILTER_MASK_CTRL  (1 << 1)
+#define WIFI_PROMIS_FILTER_MASK_DATA  (1 << 2)
+#define WIFI_PROMIS_FILTER_MASK_MISC  (1 << 3)
+
+typedef struct {
+    uint32_t filter_mask;
+} wifi_promiscuous_filter_t;
+
+typedef void (*wifi_promiscuous_cb_t)(void* buf, wifi_promiscuous_pkt_type_t type);
+
+// Radio state recorded by the driver stubs below. The replay harness reads
+// back the registered callback / channel and delivers frames through it.
+struct MockWiFiRadio {
+    wifi_promiscuous_cb_t rxCb;
+    bool promiscuous;
+    uint32_t filterMask;
+    uint8_t channel;
+    uint8_t mac[6];
+    uint32_t txFrames;
+};
+
+inline MockWiFiRadio& mockWiFiRadio() {
+    static MockWiFiRadio radio = {nullptr, false, WIFI_PROMIS_FILTER_MASK_ALL, 1,
+                                  {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, 0};
+    return radio;
+}
+
+inline esp_err_t esp_wifi_start() { return ESP_OK; }
+inline esp_err_t esp_wifi_stop() { return ESP_OK; }
+inline esp_err_t esp_wifi_set_mode(wifi_mode_t mode) { return ESP_OK; }
+
+inline esp_err_t esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb_t cb) {
+    mockWiFiRadio().rxCb = cb;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_set_promiscuous(bool en) {
+    mockWiFiRadio().promiscuous = en;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_get_promiscuous(bool* en) {
+    *en = mockWiFiRadio().promiscuous;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_set_promiscuous_filter(const wifi_promiscuous_filter_t* filter) {
+    mockWiFiRadio().filterMask = filter ? filter->filter_mask : WIFI_PROMIS_FILTER_MASK_ALL;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second) {
+    mockWiFiRadio().channel = primary;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_get_channel(uint8_t* primary, wifi_second_chan_t* second) {
+    *primary = mockWiFiRadio().channel;
+    if (second) *second = WIFI_SECOND_CHAN_NONE;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_80211_tx(wifi_interface_t ifx, const void* buffer, int len, bool en_sys_seq) {
+    mockWiFiRadio().txFrames++;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_get_mac(wifi_interface_t ifx, uint8_t mac[6]) {
+    memcpy(mac, mockWiFiRadio().mac, 6);
+    return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_set_mac(wifi_interface_t ifx, const uint8_t mac[6]) {
+    memcpy(mockWiFiRadio().mac, mac, 6);
+    return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_set_max_tx_power(int8_t power) { return ESP_OK; }
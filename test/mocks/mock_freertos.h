@@ -0,0 +1,44 @@
+// Mock FreeRTOS tasks for native builds
+// Single-threaded: a created task runs to completion inside the create call,
+// and vTaskDelay() just advances the mock clock.
+#pragma once
+
+#include <cstdint>
+#include "mock_arduino.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdPASS 1
+#define pdFAIL 0
+#define pdTRUE 1
+#define pdFALSE 0
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack,
+                                          void* param, UBaseType_t prio, TaskHandle_t* handle,
+                                          BaseType_t core) {
+    static int dummy;
+    if (handle) *handle = &dummy;  // Set before running - tasks clear their own handle
+    fn(param);
+    return pdPASS;
+}
+
+inline BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack,
+                              void* param, UBaseType_t prio, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, name, stack, param, prio, handle, 0);
+}
+
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
+inline void vTaskDelete(TaskHandle_t task) {}
+inline TickType_t xTaskGetTickCount() { return millis(); }
+
+// Critical sections are no-ops with a single thread
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define taskENTER_CRITICAL(mux) ((void)(mux))
+#define taskEXIT_CRITICAL(mux) ((void)(mux))
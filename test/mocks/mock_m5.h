@@ -0,0 +1,126 @@
+// Mock M5Unified / M5Cardputer for native builds
+// Drawing calls accept anything and do nothing; the keyboard never has a key
+// down. Enough for mode sources to compile and run headless.
+#pragma once
+
+#include <cstdint>
+#include "mock_arduino.h"
+
+#define TFT_BLACK   0x0000
+#define TFT_WHITE   0xFFFF
+#define TFT_RED     0xF800
+#define TFT_GREEN   0x07E0
+#define TFT_BLUE    0x001F
+#define TFT_YELLOW  0xFFE0
+#define TFT_ORANGE  0xFDA0
+#define TFT_DARKGREY 0x7BEF
+
+enum textdatum_t : uint8_t {
+    top_left = 0, top_center = 1, top_right = 2,
+    middle_left = 4, middle_center = 5, middle_right = 6,
+    bottom_left = 8, bottom_center = 9, bottom_right = 10,
+    baseline_left = 16, baseline_center = 17, baseline_right = 18
+};
+
+#define TL_DATUM top_left
+#define TC_DATUM top_center
+#define TR_DATUM top_right
+#define ML_DATUM middle_left
+#define MC_DATUM middle_center
+#define MR_DATUM middle_right
+#define BL_DATUM bottom_left
+#define BC_DATUM bottom_center
+#define BR_DATUM bottom_right
+
+#define MOCK_M5_NOOP(name) template <typename... A> void name(A...) {}
+
+class M5Canvas {
+public:
+    M5Canvas() {}
+    template <typename T> explicit M5Canvas(T*) {}
+
+    MOCK_M5_NOOP(fillSprite)
+    MOCK_M5_NOOP(fillScreen)
+    MOCK_M5_NOOP(fillRect)
+    MOCK_M5_NOOP(drawRect)
+    MOCK_M5_NOOP(fillRoundRect)
+    MOCK_M5_NOOP(drawRoundRect)
+    MOCK_M5_NOOP(fillCircle)
+    MOCK_M5_NOOP(drawCircle)
+    MOCK_M5_NOOP(fillTriangle)
+    MOCK_M5_NOOP(drawLine)
+    MOCK_M5_NOOP(drawFastHLine)
+    MOCK_M5_NOOP(drawFastVLine)
+    MOCK_M5_NOOP(drawPixel)
+    MOCK_M5_NOOP(drawString)
+    MOCK_M5_NOOP(drawCentreString)
+    MOCK_M5_NOOP(setTextColor)
+    MOCK_M5_NOOP(setTextDatum)
+    MOCK_M5_NOOP(setTextSize)
+    MOCK_M5_NOOP(setTextWrap)
+    MOCK_M5_NOOP(setFont)
+    MOCK_M5_NOOP(setCursor)
+    MOCK_M5_NOOP(setColorDepth)
+    MOCK_M5_NOOP(print)
+    MOCK_M5_NOOP(println)
+    MOCK_M5_NOOP(printf)
+    MOCK_M5_NOOP(createSprite)
+    MOCK_M5_NOOP(deleteSprite)
+    MOCK_M5_NOOP(pushSprite)
+
+    int32_t width() const { return 240; }
+    int32_t height() const { return 135; }
+    template <typename... A> int32_t textWidth(A...) const { return 0; }
+    int32_t fontHeight() const { return 8; }
+};
+
+class MockSpeaker {
+public:
+    MOCK_M5_NOOP(tone)
+    MOCK_M5_NOOP(stop)
+    MOCK_M5_NOOP(setVolume)
+    bool isPlaying() const { return false; }
+};
+
+class MockM5 {
+public:
+    MockSpeaker Speaker;
+    M5Canvas Display;
+    MOCK_M5_NOOP(update)
+};
+
+inline MockM5 M5;
+
+#define KEY_BACKSPACE 0x2A
+#define KEY_TAB       0x2B
+#define KEY_ENTER     0x28
+
+class MockKeyboard {
+public:
+    struct KeysState {
+        bool tab = false;
+        bool fn = false;
+        bool shift = false;
+        bool ctrl = false;
+        bool opt = false;
+        bool alt = false;
+        bool del = false;
+        bool enter = false;
+        bool space = false;
+    };
+
+    bool isChange() const { return false; }
+    bool isPressed() const { return false; }
+    bool isKeyPressed(char) const { return false; }
+    KeysState keysState() const { return KeysState(); }
+};
+
+class MockCardputer {
+public:
+    MockKeyboard Keyboard;
+    MockSpeaker Speaker;
+    M5Canvas Display;
+    MOCK_M5_NOOP(update)
+};
+
+inline MockCardputer M5Cardputer;
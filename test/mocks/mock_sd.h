@@ -0,0 +1,220 @@
+// Mock Arduino SD/FS for native builds
+// Paths are mapped under a host directory (mockSDRoot()), so code that saves
+// captures writes real files the test or replay harness can inspect.
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mock_arduino.h"
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+inline std::string& mockSDRoot() {
+    static std::string root = "sd";
+    return root;
+}
+
+inline std::string mockSDPath(const char* path) {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    return mockSDRoot() + p;
+}
+
+class File {
+public:
+    File() {}
+
+    static File openPath(const char* path, const char* mode) {
+        File f;
+        std::string host = mockSDPath(path);
+        struct stat st;
+        if (stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+            DIR* d = opendir(host.c_str());
+            if (!d) return f;
+            f.h = std::make_shared<Handle>();
+            f.h->dir = d;
+        } else {
+            // "r" only opens existing files; "w"/"a" create them
+            FILE* fp = fopen(host.c_str(), strcmp(mode, FILE_READ) == 0 ? "rb" :
+                                            strcmp(mode, FILE_APPEND) == 0 ? "ab+" : "wb+");
+            if (!fp) return f;
+            f.h = std::make_shared<Handle>();
+            f.h->fp = fp;
+        }
+        f.h->path = path;
+        return f;
+    }
+
+    operator bool() const { return h && (h->fp || h->dir); }
+
+    size_t write(uint8_t b) { return write(&b, 1); }
+    size_t write(const uint8_t* buf, size_t len) {
+        if (!h || !h->fp) return 0;
+        return fwrite(buf, 1, len, h->fp);
+    }
+    size_t write(const char* buf, size_t len) { return write((const uint8_t*)buf, len); }
+
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(int n) { return printf("%d", n); }
+    size_t print(unsigned int n) { return printf("%u", n); }
+    size_t print(long n) { return printf("%ld", n); }
+    size_t print(unsigned long n) { return printf("%lu", n); }
+    size_t print(double n, int decimals = 2) { return printf("%.*f", decimals, n); }
+    size_t println() { return print("\n"); }
+    template <typename T>
+    size_t println(const T& v) { size_t n = print(v); return n + print("\n"); }
+    size_t println(double n, int decimals) { size_t c = print(n, decimals); return c + print("\n"); }
+
+    size_t printf(const char* format, ...) {
+        if (!h || !h->fp) return 0;
+        va_list args;
+        va_start(args, format);
+        int n = vfprintf(h->fp, format, args);
+        va_end(args);
+        return n > 0 ? n : 0;
+    }
+
+    int read() {
+        if (!h || !h->fp) return -1;
+        return fgetc(h->fp);
+    }
+    size_t read(uint8_t* buf, size_t len) {
+        if (!h || !h->fp) return 0;
+        return fread(buf, 1, len, h->fp);
+    }
+    int peek() {
+        int c = read();
+        if (c >= 0) ungetc(c, h->fp);
+        return c;
+    }
+    int available() {
+        if (!h || !h->fp) return 0;
+        long n = (long)size() - (long)position();
+        return n > 0 ? (int)n : 0;
+    }
+
+    String readStringUntil(char terminator) {
+        std::string s;
+        int c;
+        while ((c = read()) >= 0 && c != terminator) s += (char)c;
+        return String(s.c_str());
+    }
+    String readString() {
+        std::string s;
+        int c;
+        while ((c = read()) >= 0) s += (char)c;
+        return String(s.c_str());
+    }
+
+    bool seek(uint32_t pos) { return h && h->fp && fseek(h->fp, pos, SEEK_SET) == 0; }
+    size_t position() const { return (h && h->fp) ? (size_t)ftell(h->fp) : 0; }
+    size_t size() const {
+        if (!h || !h->fp) return 0;
+        long cur = ftell(h->fp);
+        fseek(h->fp, 0, SEEK_END);
+        long end = ftell(h->fp);
+        fseek(h->fp, cur, SEEK_SET);
+        return (size_t)end;
+    }
+    void flush() { if (h && h->fp) fflush(h->fp); }
+
+    void close() {
+        if (!h) return;
+        if (h->fp) fclose(h->fp);
+        if (h->dir) closedir(h->dir);
+        h->fp = nullptr;
+        h->dir = nullptr;
+        h.reset();
+    }
+
+    const char* name() const {
+        if (!h) return "";
+        size_t slash = h->path.find_last_of('/');
+        return slash == std::string::npos ? h->path.c_str() : h->path.c_str() + slash + 1;
+    }
+    const char* path() const { return h ? h->path.c_str() : ""; }
+    bool isDirectory() const { return h && h->dir; }
+
+    File openNextFile() {
+        if (!h || !h->dir) return File();
+        struct dirent* e;
+        while ((e = readdir(h->dir)) != nullptr) {
+            if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0) continue;
+            std::string child = h->path;
+            if (child.empty() || child.back() != '/') child += "/";
+            child += e->d_name;
+            return openPath(child.c_str(), FILE_READ);
+        }
+        return File();
+    }
+    void rewindDirectory() { if (h && h->dir) rewinddir(h->dir); }
+
+private:
+    struct Handle {
+        FILE* fp = nullptr;
+        DIR* dir = nullptr;
+        std::string path;
+        ~Handle() {
+            if (fp) fclose(fp);
+            if (dir) closedir(dir);
+        }
+    };
+    std::shared_ptr<Handle> h;
+};
+
+namespace fs {
+    typedef ::File File;
+}
+
+class SDClass {
+public:
+    bool begin(...) { mkdir("/"); return true; }
+    void end() {}
+
+    File open(const char* path, const char* mode = FILE_READ) {
+        return File::openPath(path, mode);
+    }
+    File open(const String& path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+
+    bool exists(const char* path) {
+        struct stat st;
+        return stat(mockSDPath(path).c_str(), &st) == 0;
+    }
+    bool exists(const String& path) { return exists(path.c_str()); }
+
+    // Creates intermediate directories too (harmless superset of SD.mkdir)
+    bool mkdir(const char* path) {
+        std::string host = mockSDPath(path);
+        for (size_t i = 1; i <= host.size(); i++) {
+            if (i == host.size() || host[i] == '/') {
+                ::mkdir(host.substr(0, i).c_str(), 0755);
+            }
+        }
+        return exists(path);
+    }
+    bool mkdir(const String& path) { return mkdir(path.c_str()); }
+
+    bool remove(const char* path) { return ::unlink(mockSDPath(path).c_str()) == 0; }
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rmdir(const char* path) { return ::rmdir(mockSDPath(path).c_str()) == 0; }
+    bool rename(const char* from, const char* to) {
+        return ::rename(mockSDPath(from).c_str(), mockSDPath(to).c_str()) == 0;
+    }
+    bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+
+    uint64_t cardSize() { return 16ULL << 30; }
+    uint64_t totalBytes() { return 16ULL << 30; }
+    uint64_t usedBytes() { return 0; }
+};
+
+inline SDClass SD;
@@ -0,0 +1,51 @@
+// Mock Arduino WiFi (WiFiClass) for native builds
+// No radio: scans find nothing. Promiscuous traffic goes through the
+// esp_wifi_* stubs in mock_esp_wifi.h instead.
+#pragma once
+
+#include <cstdint>
+#include "mock_arduino.h"
+#include "mock_esp_wifi.h"
+
+#define WIFI_OFF   WIFI_MODE_NULL
+#define WIFI_STA   WIFI_MODE_STA
+#define WIFI_AP    WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t m) { currentMode = m; return true; }
+    wifi_mode_t getMode() const { return currentMode; }
+    bool disconnect(bool wifiOff = false, bool eraseAp = false) { return true; }
+    wl_status_t status() const { return WL_DISCONNECTED; }
+    bool isConnected() const { return false; }
+
+    int16_t scanNetworks(bool async = false, bool showHidden = false, bool passive = false,
+                         uint32_t maxMsPerChan = 300, uint8_t channel = 0) { return 0; }
+    int16_t scanComplete() const { return 0; }
+    void scanDelete() {}
+    String SSID(uint8_t i) const { return String(""); }
+    uint8_t* BSSID(uint8_t i) { return zeroBssid; }
+    int32_t RSSI(uint8_t i) const { return 0; }
+    int32_t channel(uint8_t i) const { return 0; }
+    wifi_auth_mode_t encryptionType(uint8_t i) const { return WIFI_AUTH_OPEN; }
+
+    String macAddress() const { return String("02:00:00:00:00:01"); }
+
+private:
+    wifi_mode_t currentMode = WIFI_MODE_NULL;
+    uint8_t zeroBssid[6] = {0};
+};
+
+inline WiFiClass WiFi;
@@ -0,0 +1,252 @@
+// Capture file reader for the replay harness
+// Reads classic pcap (either byte order, usec/nsec) and pcapng (SHB/IDB/EPB/
+// SPB). Link types: 802.11 (105), radiotap (127) and prism (119). Radiotap
+// flags/channel/signal/noise are decoded so frames can be delivered with the
+// same rx_ctrl metadata the ESP32 driver would have filled in.
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "../../src/core/pcapng.h"
+
+static const uint32_t PCAP_MAGIC_USEC = 0xA1B2C3D4;
+static const uint32_t PCAP_MAGIC_NSEC = 0xA1B23C4D;
+static const uint16_t LINKTYPE_IEEE802_11 = 105;
+static const uint16_t LINKTYPE_PRISM = 119;
+static const uint16_t PCAPNG_SPB_TYPE = 0x00000003;
+
+struct ReplayFrame {
+    uint64_t tsUs;
+    const uint8_t* data;   // 802.11 frame, link header stripped
+    uint16_t len;          // Includes the FCS when hasFCS
+    bool hasFCS;
+    uint8_t channel;       // 0 = unknown
+    bool hasRSSI;
+    int8_t rssi;
+    int8_t noise;
+};
+
+// Radiotap fields we care about, in present-bit order: (size, alignment)
+static const uint8_t RADIOTAP_FIELD_SIZE[] = {8, 1, 1, 4, 2, 1, 1};
+static const uint8_t RADIOTAP_FIELD_ALIGN[] = {8, 1, 1, 2, 2, 1, 1};
+
+inline bool parseRadiotap(const uint8_t* p, uint32_t caplen, ReplayFrame& f, uint16_t& hdrLen) {
+    if (caplen < 8) return false;
+    hdrLen = p[2] | (p[3] << 8);
+    if (hdrLen < 8 || hdrLen > caplen) return false;
+
+    // Skip extended present words (bit 31 chains another word)
+    uint32_t present = p[4] | (p[5] << 8) | (p[6] << 16) | ((uint32_t)p[7] << 24);
+    uint32_t off = 8;
+    uint32_t word = present;
+    while ((word & 0x80000000u) && off + 4 <= hdrLen) {
+        word = p[off] | (p[off + 1] << 8) | (p[off + 2] << 16) | ((uint32_t)p[off + 3] << 24);
+        off += 4;
+    }
+
+    for (uint8_t bit = 0; bit < sizeof(RADIOTAP_FIELD_SIZE); bit++) {
+        if (!(present & (1u << bit))) continue;
+        uint8_t align = RADIOTAP_FIELD_ALIGN[bit];
+        off = (off + align - 1) & ~(uint32_t)(align - 1);
+        if (off + RADIOTAP_FIELD_SIZE[bit] > hdrLen) break;
+        const uint8_t* v = p + off;
+        switch (bit) {
+            case 1:  // Flags
+                f.hasFCS = (v[0] & 0x10) != 0;
+                break;
+            case 3: {  // Channel frequency
+                uint16_t freq = v[0] | (v[1] << 8);
+                if (freq == 2484) f.channel = 14;
+                else if (freq >= 2412 && freq <= 2472) f.channel = (freq - 2407) / 5;
+                break;
+            }
+            case 5:
+                f.hasRSSI = true;
+                f.rssi = (int8_t)v[0];
+                break;
+            case 6:
+                f.noise = (int8_t)v[0];
+                break;
+        }
+        off += RADIOTAP_FIELD_SIZE[bit];
+    }
+    return true;
+}
+
+class CaptureReader {
+public:
+    CaptureReader() : fp(nullptr), pcapng(false), swapped(false), nsec(false), linkType(0) {}
+    ~CaptureReader() { close(); }
+
+    bool open(const char* path) {
+        fp = fopen(path, "rb");
+        if (!fp) return false;
+
+        uint32_t magic;
+        if (fread(&magic, 4, 1, fp) != 1) return false;
+
+        if (magic == PCAPNG_SHB_TYPE) {
+            pcapng = true;
+            rewind(fp);
+            return true;
+        }
+
+        if (magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC) {
+            swapped = false;
+        } else if (bswap32(magic) == PCAP_MAGIC_USEC || bswap32(magic) == PCAP_MAGIC_NSEC) {
+            swapped = true;
+            magic = bswap32(magic);
+        } else {
+            return false;
+        }
+        nsec = (magic == PCAP_MAGIC_NSEC);
+
+        uint8_t hdr[20];
+        if (fread(hdr, sizeof(hdr), 1, fp) != 1) return false;
+        linkType = (uint16_t)rd32(hdr + 16);
+        return supported(linkType);
+    }
+
+    void close() {
+        if (fp) fclose(fp);
+        fp = nullptr;
+    }
+
+    // Next 802.11 frame; skips records with unsupported link types or bad headers
+    bool next(ReplayFrame& f) {
+        while (fp) {
+            bool ok = pcapng ? nextNg(f) : nextPcap(f);
+            if (!ok) return false;
+            if (f.len >= 10) return true;
+        }
+        return false;
+    }
+
+    uint16_t getLinkType() const { return linkType; }
+    bool isPcapng() const { return pcapng; }
+
+private:
+    FILE* fp;
+    bool pcapng;
+    bool swapped;
+    bool nsec;
+    uint16_t linkType;
+    std::vector<uint8_t> buf;
+
+    struct Interface {
+        uint16_t linkType;
+        uint64_t tsPerSec;
+    };
+    std::vector<Interface> interfaces;
+
+    static uint32_t bswap32(uint32_t v) {
+        return (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24);
+    }
+    uint32_t rd32(const uint8_t* p) const {
+        uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+        return swapped ? bswap32(v) : v;
+    }
+    uint16_t rd16(const uint8_t* p) const {
+        uint16_t v = p[0] | (p[1] << 8);
+        return swapped ? (uint16_t)((v >> 8) | (v << 8)) : v;
+    }
+
+    static bool supported(uint16_t lt) {
+        return lt == LINKTYPE_IEEE802_11 || lt == PCAPNG_LINKTYPE_RADIOTAP || lt == LINKTYPE_PRISM;
+    }
+
+    bool decode(uint16_t lt, const uint8_t* p, uint32_t caplen, uint64_t tsUs, ReplayFrame& f) {
+        memset(&f, 0, sizeof(f));
+        f.tsUs = tsUs;
+        uint16_t skip = 0;
+        if (lt == PCAPNG_LINKTYPE_RADIOTAP) {
+            if (!parseRadiotap(p, caplen, f, skip)) return false;
+        } else if (lt == LINKTYPE_PRISM) {
+            skip = 144;
+        } else if (lt != LINKTYPE_IEEE802_11) {
+            return false;
+        }
+        if (caplen < skip) return false;
+        uint32_t n = caplen - skip;
+        if (n > 0xFFFF) n = 0xFFFF;
+        f.data = p + skip;
+        f.len = (uint16_t)n;
+        return true;
+    }
+
+    bool nextPcap(ReplayFrame& f) {
+        uint8_t rec[16];
+        if (fread(rec, sizeof(rec), 1, fp) != 1) return false;
+        uint32_t sec = rd32(rec);
+        uint32_t frac = rd32(rec + 4);
+        uint32_t caplen = rd32(rec + 8);
+        if (caplen > 262144) return false;  // Corrupt file
+        buf.resize(caplen);
+        if (caplen && fread(buf.data(), caplen, 1, fp) != 1) return false;
+        uint64_t ts = (uint64_t)sec * 1000000 + (nsec ? frac / 1000 : frac);
+        if (!decode(linkType, buf.data(), caplen, ts, f)) f.len = 0;
+        return true;
+    }
+
+    bool nextNg(ReplayFrame& f) {
+        uint8_t hdr[8];
+        if (fread(hdr, sizeof(hdr), 1, fp) != 1) return false;
+        uint32_t type = rd32(hdr);
+        uint32_t total = rd32(hdr + 4);
+        if (type == PCAPNG_SHB_TYPE) {
+            // Byte order magic decides how everything in this section reads
+            uint8_t bom[4];
+            if (fread(bom, 4, 1, fp) != 1) return false;
+            uint32_t raw = bom[0] | (bom[1] << 8) | (bom[2] << 16) | ((uint32_t)bom[3] << 24);
+            swapped = (raw != PCAPNG_BYTE_ORDER_MAGIC);
+            total = rd32(hdr + 4);
+            interfaces.clear();
+            if (total < 16 || fseek(fp, total - 12, SEEK_CUR) != 0) return false;
+            f.len = 0;
+            return true;
+        }
+        if (total < 12 || total > 262144) return false;
+        buf.resize(total - 8);
+        if (fread(buf.data(), total - 8, 1, fp) != 1) return false;
+        const uint8_t* b = buf.data();
+        uint32_t bodyLen = total - 12;  // Minus header + trailing length
+        f.len = 0;
+
+        if (type == PCAPNG_IDB_TYPE && bodyLen >= 8) {
+            Interface ifc = {rd16(b), 1000000};
+            // if_tsresol option (code 9)
+            uint32_t off = 8;
+            while (off + 4 <= bodyLen) {
+                uint16_t code = rd16(b + off);
+                uint16_t olen = rd16(b + off + 2);
+                if (code == 0) break;
+                if (code == 9 && olen >= 1 && off + 4 < bodyLen) {
+                    uint8_t r = b[off + 4];
+                    uint64_t tps = 1;
+                    if (r & 0x80) { for (int i = 0; i < (r & 0x7F) && i < 63; i++) tps *= 2; }
+                    else { for (int i = 0; i < r && i < 19; i++) tps *= 10; }
+                    ifc.tsPerSec = tps;
+                }
+                off += 4 + pcapngPad4(olen);
+            }
+            interfaces.push_back(ifc);
+            if (interfaces.size() == 1) linkType = ifc.linkType;
+        } else if (type == PCAPNG_EPB_TYPE && bodyLen >= 20) {
+            uint32_t ifId = rd32(b);
+            uint64_t ts = ((uint64_t)rd32(b + 4) << 32) | rd32(b + 8);
+            uint32_t caplen = rd32(b + 12);
+            if (ifId < interfaces.size() && 20 + caplen <= bodyLen) {
+                const Interface& ifc = interfaces[ifId];
+                uint64_t tsUs = ifc.tsPerSec == 1000000 ? ts : ts * 1000000 / ifc.tsPerSec;
+                if (!decode(ifc.linkType, b + 20, caplen, tsUs, f)) f.len = 0;
+            }
+        } else if (type == PCAPNG_SPB_TYPE && bodyLen >= 4 && !interfaces.empty()) {
+            uint32_t origLen = rd32(b);
+            uint32_t caplen = origLen < bodyLen - 4 ? origLen : bodyLen - 4;
+            if (!decode(interfaces[0].linkType, b + 4, caplen, 0, f)) f.len = 0;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,524 @@
+// Replay harness driver
+// Feeds a pcap/pcapng capture through a mode's real promiscuous callback on
+// the host, stepping the mock clock with the capture timestamps and calling
+// update() on 10ms ticks like the main loop would. Reports throughput,
+// callback/update latency and what the mode captured. With --expect-* it
+// exits non-zero on a shortfall, so CI can use it as a regression gate.
+//
+//   replay gen <out.pcap> [--aps N] [--clients N] [--seconds N]
+//   replay export <log.wdl> <wigle|csv|ml> <out.csv>
+//   replay <oink|dnh|spectrum|warhog> <capture> [options]
+
+#include <Arduino.h>
+#include <esp_wifi.h>
+#include <SD.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "pcap_reader.h"
+#include "../../src/core/config.h"
+#include "../../src/core/perf_trace.h"
+#include "../../src/core/wardrive_log.h"
+#include "../../src/modes/oink.h"
+#include "../../src/modes/donoham.h"
+#include "../../src/modes/spectrum.h"
+#include "../../src/modes/warhog.h"
+
+typedef std::chrono::steady_clock ReplayClock;
+
+static const uint32_t UPDATE_TICK_MS = 10;     // Main loop cadence
+static const uint32_t TRAILING_MS = 2000;      // Updates after the last frame
+static const uint16_t MAX_SIG_LEN = 4095;      // rx_ctrl.sig_len is 12 bits
+
+// ============ Mode table ============
+
+struct ReplayMode {
+    const char* name;
+    void (*start)();
+    void (*update)();
+    void (*stop)();
+    uint32_t (*networks)();
+    uint32_t (*handshakes)();
+    uint32_t (*pmkids)();
+    uint32_t (*ringDropped)();
+};
+
+static void oinkStart() { OinkMode::init(); OinkMode::start(); }
+static void dnhStart() { DoNoHamMode::init(); DoNoHamMode::start(); }
+static void warhogStart() {
+    Config::ml().collectionMode = MLCollectionMode::ENHANCED;  // Beacon capture path
+    WarhogMode::init();
+    WarhogMode::start();
+}
+
+static uint32_t none() { return 0; }
+
+static const ReplayMode MODES[] = {
+    {"oink", oinkStart, OinkMode::update, OinkMode::stop,
+     [] { return (uint32_t)OinkMode::getNetworkCount(); },
+     [] { return (uint32_t)OinkMode::getCompleteHandshakeCount(); },
+     [] { return (uint32_t)OinkMode::getPMKIDCount(); },
+     OinkMode::getRingDropped},
+    {"dnh", dnhStart, DoNoHamMode::update, DoNoHamMode::stop,
+     [] { return (uint32_t)DoNoHamMode::getNetworkCount(); },
+     [] { return (uint32_t)DoNoHamMode::getHandshakeCount(); },
+     [] { return (uint32_t)DoNoHamMode::getPMKIDCount(); },
+     none},
+    {"spectrum", SpectrumMode::start, SpectrumMode::update, SpectrumMode::stop,
+     [] { return (uint32_t)SpectrumMode::getNetworkCount(); },
+     none, none, none},
+    {"warhog", warhogStart, WarhogMode::update, WarhogMode::stop,
+     [] { return WarhogMode::getBeaconCount(); },
+     none, none, none},
+};
+
+// ============ Options ============
+
+struct ReplayOptions {
+    const ReplayMode* mode = nullptr;
+    const char* path = nullptr;
+    const char* sdDir = "replay_sd";
+    bool verbose = false;
+    bool channelFilter = false;  // Drop frames not on the radio's current channel
+    uint32_t loops = 1;
+    uint32_t rate = 0;           // Frames/sec of simulated time; 0 = capture timing
+    long expectNetworks = -1;
+    long expectHandshakes = -1;
+    long expectPMKIDs = -1;
+};
+
+static void usage() {
+    fprintf(stderr,
+            "usage: replay <oink|dnh|spectrum|warhog> <capture> [options]\n"
+            "  -v                   show mode serial output\n"
+            "  --loops N            replay the capture N times\n"
+            "  --rate FPS           ignore capture timing, deliver at FPS (simulated)\n"
+            "  --channel-filter     only deliver frames on the radio's channel\n"
+            "  --sd DIR             host directory backing the SD card (replay_sd)\n"
+            "  --expect-networks N  fail if fewer networks were found\n"
+            "  --expect-handshakes N\n"
+            "  --expect-pmkids N\n"
+            "       replay gen <out.pcap> [--aps N] [--clients N] [--seconds N]\n"
+            "       replay export <log.wdl> <wigle|csv|ml> <out.csv>\n");
+}
+
+// ============ Stats ============
+
+static uint64_t percentile(std::vector<uint32_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t idx = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + idx, v.end());
+    return v[idx];
+}
+
+static void printLatency(const char* label, std::vector<uint32_t>& ns) {
+    if (ns.empty()) {
+        printf("[REPLAY] %-9s n=0\n", label);
+        return;
+    }
+    uint64_t p50 = percentile(ns, 0.50);
+    uint64_t p90 = percentile(ns, 0.90);
+    uint64_t p99 = percentile(ns, 0.99);
+    uint64_t mx = *std::max_element(ns.begin(), ns.end());
+    printf("[REPLAY] %-9s n=%zu p50=%lluns p90=%lluns p99=%lluns max=%lluns\n",
+           label, ns.size(), (unsigned long long)p50, (unsigned long long)p90,
+           (unsigned long long)p99, (unsigned long long)mx);
+}
+
+static uint32_t countFiles(const std::string& dir) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) return 0;
+    uint32_t n = 0;
+    struct dirent* e;
+    while ((e = readdir(d)) != nullptr) {
+        if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0) continue;
+        std::string child = dir + "/" + e->d_name;
+        struct stat st;
+        if (stat(child.c_str(), &st) != 0) continue;
+        n += S_ISDIR(st.st_mode) ? countFiles(child) : 1;
+    }
+    closedir(d);
+    return n;
+}
+
+// ============ Replay ============
+
+static uint32_t elapsedNs(ReplayClock::time_point t0) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(ReplayClock::now() - t0).count();
+    return ns > 0xFFFFFFFFLL ? 0xFFFFFFFFu : (uint32_t)ns;
+}
+
+// Never move the clock backwards - modes call delay() themselves
+static void advanceTo(uint32_t ms) {
+    if (ms > millis()) setMillis(ms);
+}
+
+static wifi_promiscuous_pkt_type_t frameType(const uint8_t* frame) {
+    switch ((frame[0] >> 2) & 0x03) {
+        case 0: return WIFI_PKT_MGMT;
+        case 1: return WIFI_PKT_CTRL;
+        case 2: return WIFI_PKT_DATA;
+        default: return WIFI_PKT_MISC;
+    }
+}
+
+static int runReplay(const ReplayOptions& opt) {
+    mockSDRoot() = opt.sdDir;
+    SD.mkdir("/");
+    Serial.echo = opt.verbose;
+    setMillis(1000);
+    PerfTrace::init();
+
+    const ReplayMode& mode = *opt.mode;
+    mode.start();
+
+    MockWiFiRadio& radio = mockWiFiRadio();
+    uint32_t txBefore = radio.txFrames;
+
+    std::vector<uint32_t> cbNs;
+    std::vector<uint32_t> updNs;
+    std::vector<uint8_t> pkt;
+    uint32_t framesRead = 0, delivered = 0, filtered = 0, oversize = 0;
+    uint32_t nextTick = millis() + UPDATE_TICK_MS;
+    uint64_t busyNs = 0;
+
+    auto tickUntil = [&](uint32_t ms) {
+        while (nextTick <= ms) {
+            advanceTo(nextTick);
+            auto t0 = ReplayClock::now();
+            mode.update();
+            uint32_t ns = elapsedNs(t0);
+            updNs.push_back(ns);
+            busyNs += ns;
+            nextTick = std::max(nextTick + UPDATE_TICK_MS, millis());
+        }
+        advanceTo(ms);
+    };
+
+    for (uint32_t loop = 0; loop < opt.loops; loop++) {
+        CaptureReader reader;
+        if (!reader.open(opt.path)) {
+            fprintf(stderr, "[REPLAY] Cannot read capture: %s\n", opt.path);
+            return 2;
+        }
+
+        ReplayFrame f;
+        bool first = true;
+        uint64_t ts0 = 0;
+        uint32_t base = millis();
+        uint32_t loopFrames = 0;
+
+        while (reader.next(f)) {
+            framesRead++;
+            if (first) { ts0 = f.tsUs; first = false; }
+
+            uint32_t at = opt.rate ? base + (uint32_t)((uint64_t)loopFrames * 1000 / opt.rate)
+                                   : base + (uint32_t)((f.tsUs >= ts0 ? f.tsUs - ts0 : 0) / 1000);
+            loopFrames++;
+            tickUntil(at);
+
+            // The driver only hands frames over while promiscuous and unfiltered
+            wifi_promiscuous_pkt_type_t type = frameType(f.data);
+            if (!radio.rxCb || !radio.promiscuous || !(radio.filterMask & (1u << type)) ||
+                (opt.channelFilter && f.channel && f.channel != radio.channel)) {
+                filtered++;
+                continue;
+            }
+
+            // sig_len counts the FCS; pad one on when the capture stripped it
+            uint16_t sigLen = f.hasFCS ? f.len : f.len + 4;
+            if (sigLen > MAX_SIG_LEN) {
+                oversize++;
+                continue;
+            }
+            pkt.assign(sizeof(wifi_pkt_rx_ctrl_t) + sigLen, 0);
+            wifi_promiscuous_pkt_t* p = (wifi_promiscuous_pkt_t*)pkt.data();
+            p->rx_ctrl.rssi = f.hasRSSI ? f.rssi : -60;
+            p->rx_ctrl.noise_floor = f.noise ? f.noise : -95;
+            p->rx_ctrl.channel = f.channel ? f.channel : radio.channel;
+            p->rx_ctrl.sig_len = sigLen;
+            memcpy(p->payload, f.data, f.len);
+
+            auto t0 = ReplayClock::now();
+            radio.rxCb(p, type);
+            uint32_t ns = elapsedNs(t0);
+            cbNs.push_back(ns);
+            busyNs += ns;
+            delivered++;
+        }
+    }
+
+    tickUntil(millis() + TRAILING_MS);
+
+    uint32_t networks = mode.networks();
+    uint32_t handshakes = mode.handshakes();
+    uint32_t pmkids = mode.pmkids();
+    uint32_t dropped = mode.ringDropped();
+    mode.stop();
+
+    double busySec = busyNs / 1e9;
+    printf("[REPLAY] mode=%s capture=%s loops=%u\n", mode.name, opt.path, opt.loops);
+    printf("[REPLAY] frames=%u delivered=%u filtered=%u oversize=%u\n",
+           framesRead, delivered, filtered, oversize);
+    printf("[REPLAY] busy=%.3fs throughput=%.0f frames/s\n",
+           busySec, busySec > 0 ? delivered / busySec : 0.0);
+    printLatency("callback", cbNs);
+    printLatency("update", updNs);
+    for (uint8_t i = 0; i < PERF_SECTION_COUNT; i++) {
+        PerfStats st = PerfTrace::getStats((PerfSection)i);
+        if (st.count == 0) continue;
+        printf("[REPLAY] perf %-11s n=%lu p50=%luns p99=%luns max=%luns\n",
+               perfSectionName((PerfSection)i), (unsigned long)st.count,
+               (unsigned long)st.p50, (unsigned long)st.p99, (unsigned long)st.max);
+    }
+    printf("[REPLAY] networks=%u handshakes=%u pmkids=%u ringDropped=%u tx=%u files=%u\n",
+           networks, handshakes, pmkids, dropped, radio.txFrames - txBefore,
+           countFiles(opt.sdDir));
+
+    int rc = 0;
+    auto expect = [&](const char* what, long want, uint32_t got) {
+        if (want >= 0 && got < (uint32_t)want) {
+            printf("[REPLAY] FAIL: %s %u < expected %ld\n", what, got, want);
+            rc = 1;
+        }
+    };
+    expect("networks", opt.expectNetworks, networks);
+    expect("handshakes", opt.expectHandshakes, handshakes);
+    expect("pmkids", opt.expectPMKIDs, pmkids);
+    if (rc == 0) printf("[REPLAY] OK\n");
+    return rc;
+}
+
+// ============ Synthetic capture ============
+// Radiotap pcap with beaconing RSN APs on 1/6/11, client data traffic and
+// one full 4-way handshake per AP (PMKID in M1 on every other AP). Fixed seed
+// so the same arguments always produce the same file.
+
+struct GenRecord {
+    uint64_t tsUs;
+    std::vector<uint8_t> frame;
+    uint8_t channel;
+    int8_t rssi;
+};
+
+static uint32_t genSeed = 0x504F524B;  // "PORK"
+static uint32_t genRand() {
+    genSeed = genSeed * 1664525u + 1013904223u;
+    return genSeed >> 8;
+}
+
+static void genHeader(std::vector<uint8_t>& f, uint8_t fc0, uint8_t fc1,
+                      const uint8_t* a1, const uint8_t* a2, const uint8_t* a3) {
+    f.push_back(fc0);
+    f.push_back(fc1);
+    f.push_back(0); f.push_back(0);  // Duration
+    f.insert(f.end(), a1, a1 + 6);
+    f.insert(f.end(), a2, a2 + 6);
+    f.insert(f.end(), a3, a3 + 6);
+    uint16_t seq = (uint16_t)(genRand() & 0xFFF) << 4;
+    f.push_back(seq & 0xFF);
+    f.push_back(seq >> 8);
+}
+
+static std::vector<uint8_t> genBeacon(const uint8_t* bssid, const char* ssid, uint8_t channel) {
+    static const uint8_t BCAST[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    static const uint8_t RATES[] = {0x01, 0x08, 0x82, 0x84, 0x8B, 0x96, 0x0C, 0x12, 0x18, 0x24};
+    static const uint8_t RSN[] = {0x30, 0x14, 0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04, 0x01, 0x00,
+                                  0x00, 0x0F, 0xAC, 0x04, 0x01, 0x00, 0x00, 0x0F, 0xAC, 0x02,
+                                  0x00, 0x00};
+    std::vector<uint8_t> f;
+    genHeader(f, 0x80, 0x00, BCAST, bssid, bssid);
+    for (int i = 0; i < 8; i++) f.push_back(genRand() & 0xFF);  // Timestamp
+    f.push_back(0x64); f.push_back(0x00);                         // 102.4ms interval
+    f.push_back(0x11); f.push_back(0x04);                         // ESS + privacy
+    uint8_t ssidLen = (uint8_t)strlen(ssid);
+    f.push_back(0x00); f.push_back(ssidLen);
+    f.insert(f.end(), ssid, ssid + ssidLen);
+    f.insert(f.end(), RATES, RATES + sizeof(RATES));
+    f.push_back(0x03); f.push_back(0x01); f.push_back(channel);
+    f.insert(f.end(), RSN, RSN + sizeof(RSN));
+    return f;
+}
+
+static std::vector<uint8_t> genData(const uint8_t* bssid, const uint8_t* sta, bool toAP, uint16_t bodyLen) {
+    std::vector<uint8_t> f;
+    if (toAP) genHeader(f, 0x08, 0x41, bssid, sta, bssid);   // ToDS, protected
+    else genHeader(f, 0x08, 0x42, sta, bssid, bssid);        // FromDS, protected
+    for (uint16_t i = 0; i < bodyLen; i++) f.push_back(genRand() & 0xFF);
+    return f;
+}
+
+// EAPOL-Key frame for 4-way message 1..4
+static std::vector<uint8_t> genEAPOL(const uint8_t* bssid, const uint8_t* sta, uint8_t msg, bool pmkid) {
+    static const uint16_t KEY_INFO[5] = {0, 0x008A, 0x010A, 0x13CA, 0x030A};
+    static const uint8_t LLC[8] = {0xAA, 0xAA, 0x03, 0x00, 0x00, 0x00, 0x88, 0x8E};
+    bool fromAP = (msg == 1 || msg == 3);
+    std::vector<uint8_t> f;
+    if (fromAP) genHeader(f, 0x08, 0x02, sta, bssid, bssid);
+    else genHeader(f, 0x08, 0x01, bssid, sta, bssid);
+    f.insert(f.end(), LLC, LLC + 8);
+
+    uint16_t keyDataLen = (msg == 1 && pmkid) ? 22 : (msg == 2 ? 22 : (msg == 3 ? 56 : 0));
+    std::vector<uint8_t> e(99 + keyDataLen, 0);
+    uint16_t bodyLen = 95 + keyDataLen;
+    e[0] = 0x02;                       // 802.1X-2004
+    e[1] = 0x03;                       // EAPOL-Key
+    e[2] = bodyLen >> 8; e[3] = bodyLen & 0xFF;
+    e[4] = 0x02;                       // RSN descriptor
+    e[5] = KEY_INFO[msg] >> 8; e[6] = KEY_INFO[msg] & 0xFF;
+    e[8] = 0x10;                       // Key length 16
+    e[16] = (msg >= 3) ? 2 : 1;        // Replay counter
+    if (msg != 4) for (int i = 17; i < 49; i++) e[i] = genRand() & 0xFF;   // Nonce
+    if (msg != 1) for (int i = 81; i < 97; i++) e[i] = genRand() & 0xFF;   // MIC
+    e[97] = keyDataLen >> 8; e[98] = keyDataLen & 0xFF;
+    if (msg == 1 && pmkid) {
+        static const uint8_t KDE[6] = {0xDD, 0x14, 0x00, 0x0F, 0xAC, 0x04};
+        memcpy(&e[99], KDE, 6);
+        for (int i = 105; i < 121; i++) e[i] = genRand() & 0xFF;
+    } else {
+        for (uint16_t i = 99; i < e.size(); i++) e[i] = genRand() & 0xFF;
+    }
+    f.insert(f.end(), e.begin(), e.end());
+    return f;
+}
+
+static bool writeGenPcap(const char* path, std::vector<GenRecord>& recs) {
+    std::sort(recs.begin(), recs.end(),
+              [](const GenRecord& a, const GenRecord& b) { return a.tsUs < b.tsUs; });
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return false;
+
+    uint32_t gh[6] = {PCAP_MAGIC_USEC, 0x00040002, 0, 0, 65535, PCAPNG_LINKTYPE_RADIOTAP};
+    fwrite(gh, sizeof(gh), 1, fp);
+
+    for (const GenRecord& r : recs) {
+        // Radiotap: flags, channel, antenna signal, antenna noise
+        uint8_t rt[16] = {0, 0, 16, 0, 0x6A, 0, 0, 0};
+        uint16_t freq = r.channel == 14 ? 2484 : 2407 + 5 * r.channel;
+        rt[10] = freq & 0xFF; rt[11] = freq >> 8;
+        rt[12] = 0xA0; rt[13] = 0x00;  // 2GHz CCK
+        rt[14] = (uint8_t)r.rssi;
+        rt[15] = (uint8_t)(int8_t)-95;
+        uint32_t caplen = sizeof(rt) + r.frame.size();
+        uint32_t rh[4] = {(uint32_t)(r.tsUs / 1000000), (uint32_t)(r.tsUs % 1000000), caplen, caplen};
+        fwrite(rh, sizeof(rh), 1, fp);
+        fwrite(rt, sizeof(rt), 1, fp);
+        fwrite(r.frame.data(), r.frame.size(), 1, fp);
+    }
+    fclose(fp);
+    return true;
+}
+
+static int runGen(int argc, char** argv) {
+    if (argc < 3) { usage(); return 2; }
+    const char* out = argv[2];
+    uint32_t aps = 12, clients = 3, seconds = 20;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--aps")) aps = strtoul(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--clients")) clients = strtoul(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--seconds")) seconds = strtoul(argv[i + 1], nullptr, 10);
+        else { usage(); return 2; }
+    }
+    if (aps == 0 || aps > 250 || clients == 0 || clients > 250 || seconds == 0) { usage(); return 2; }
+
+    static const uint8_t CHANNELS[3] = {1, 6, 11};
+    std::vector<GenRecord> recs;
+    uint64_t span = (uint64_t)seconds * 1000000;
+
+    for (uint32_t a = 0; a < aps; a++) {
+        uint8_t bssid[6] = {0x02, 0x50, 0x4B, 0x00, 0x00, (uint8_t)a};
+        uint8_t ch = CHANNELS[a % 3];
+        int8_t rssi = (int8_t)(-40 - (int)(genRand() % 45));
+        char ssid[24];
+        snprintf(ssid, sizeof(ssid), "replay-ap-%02u", a);
+
+        uint64_t offset = genRand() % 102400;
+        for (uint64_t t = offset; t < span; t += 102400) {
+            recs.push_back({t, genBeacon(bssid, ssid, ch), ch, rssi});
+        }
+
+        for (uint32_t c = 0; c < clients; c++) {
+            uint8_t sta[6] = {0x02, 0x53, 0x54, (uint8_t)a, 0x00, (uint8_t)c};
+            for (uint64_t t = genRand() % 50000; t < span; t += 40000 + genRand() % 40000) {
+                bool up = genRand() & 1;
+                recs.push_back({t, genData(bssid, sta, up, 60 + genRand() % 1200), ch,
+                                (int8_t)(rssi - (up ? 8 : 0))});
+            }
+        }
+
+        // One client completes a handshake partway through
+        uint8_t sta[6] = {0x02, 0x53, 0x54, (uint8_t)a, 0x00, 0x00};
+        uint64_t hsAt = span / 4 + genRand() % (span / 2);
+        for (uint8_t m = 1; m <= 4; m++) {
+            recs.push_back({hsAt + m * 4000, genEAPOL(bssid, sta, m, (a % 2) == 0), ch, rssi});
+        }
+    }
+
+    if (!writeGenPcap(out, recs)) {
+        fprintf(stderr, "[REPLAY] Cannot write %s\n", out);
+        return 2;
+    }
+    printf("[REPLAY] Wrote %zu frames (%u APs, %u clients each, %us) to %s\n",
+           recs.size(), aps, clients, seconds, out);
+    return 0;
+}
+
+// ============ Export ============
+
+// Host path as the mock SD sees it with an empty root
+static std::string hostPath(const char* path) {
+    if (path[0] == '/') return path;
+    char cwd[4096];
+    if (!getcwd(cwd, sizeof(cwd))) return path;
+    return std::string(cwd) + "/" + path;
+}
+
+// Render a log with the firmware's own WardriveLog exporter - the reference
+// scripts/wdl_export.py is tested against
+static int runExport(int argc, char** argv) {
+    if (argc != 5) { usage(); return 2; }
+    std::string in = hostPath(argv[2]);
+    std::string out = hostPath(argv[4]);
+    mockSDRoot() = "";
+
+    bool ok;
+    if (!strcmp(argv[3], "wigle")) ok = WardriveLog::exportWigle(in.c_str(), out.c_str());
+    else if (!strcmp(argv[3], "csv")) ok = WardriveLog::exportCSV(in.c_str(), out.c_str());
+    else if (!strcmp(argv[3], "ml")) ok = WardriveLog::exportML(in.c_str(), out.c_str());
+    else { usage(); return 2; }
+    return ok ? 0 : 1;
+}
+
+// ============ Entry ============
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && !strcmp(argv[1], "gen")) return runGen(argc, argv);
+    if (argc >= 2 && !strcmp(argv[1], "export")) return runExport(argc, argv);
+    if (argc < 3) { usage(); return 2; }
+
+    ReplayOptions opt;
+    for (const ReplayMode& m : MODES) {
+        if (!strcmp(argv[1], m.name)) opt.mode = &m;
+    }
+    if (!opt.mode) { usage(); return 2; }
+    opt.path = argv[2];
+
+    for (int i = 3; i < argc; i++) {
+        bool hasArg = i + 1 < argc;
+        if (!strcmp(argv[i], "-v")) opt.verbose = true;
+        else if (!strcmp(argv[i], "--channel-filter")) opt.channelFilter = true;
+        else if (!strcmp(argv[i], "--loops") && hasArg) opt.loops = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--rate") && hasArg) opt.rate = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--sd") && hasArg) opt.sdDir = argv[++i];
+        else if (!strcmp(argv[i], "--expect-networks") && hasArg) opt.expectNetworks = strtol(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--expect-handshakes") && hasArg) opt.expectHandshakes = strtol(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--expect-pmkids") && hasArg) opt.expectPMKIDs = strtol(argv[++i], nullptr, 10);
+        else { usage(); return 2; }
+    }
+    if (opt.loops == 0) opt.loops = 1;
+    return runReplay(opt);
+}
@@ -0,0 +1,99 @@
+// Replay harness link stubs
+// The capture modes call into UI, mood, XP, GPS and config singletons that
+// need real hardware. These stand-ins keep the calls cheap and silent so the
+// timings measure packet handling, not the piglet.
+
+#include <Arduino.h>
+#include <esp_wifi.h>
+#include <cstdarg>
+#include "../../src/core/config.h"
+#include "../../src/core/sdlog.h"
+#include "../../src/core/wsl_bypasser.h"
+#include "../../src/core/xp.h"
+#include "../../src/ui/display.h"
+#include "../../src/ui/swine_stats.h"
+#include "../../src/piglet/mood.h"
+#include "../../src/piglet/avatar.h"
+#include "../../src/gps/gps.h"
+
+// ---- Config: defaults from config.h, SD always present ----
+GPSConfig Config::gpsConfig;
+MLConfig Config::mlConfig;
+WiFiConfig Config::wifiConfig;
+BLEConfig Config::bleConfig;
+PersonalityConfig Config::personalityConfig;
+
+bool Config::isSDAvailable() { return true; }
+
+// ---- SDLog: echo with Serial ----
+void SDLog::log(const char* tag, const char* format, ...) {
+    if (!Serial.echo) return;
+    va_list args;
+    va_start(args, format);
+    printf("[SDLOG %s] ", tag);
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+}
+
+// ---- WSL bypasser: injection goes through the esp_wifi_80211_tx stub ----
+namespace WSLBypasser {
+void init() {}
+void randomizeMAC() {}
+bool sendDeauthFrame(const uint8_t* bssid, uint8_t channel, const uint8_t* staMac, uint8_t reason) {
+    mockWiFiRadio().txFrames++;
+    return true;
+}
+}
+
+// ---- Display ----
+uint16_t getColorFG() { return 0xFFFF; }
+uint16_t getColorBG() { return 0x0000; }
+void Display::setWiFiStatus(bool connected) {}
+void Display::showLoot(const String& ssid) {}
+void Display::showToast(const String& message) {
+    if (Serial.echo) printf("[TOAST] %s\n", message.c_str());
+}
+void Display::resetDimTimer() {}
+void Display::showLevelUp(uint8_t oldLevel, uint8_t newLevel) {}
+
+// ---- Mood / Avatar ----
+void Mood::onHandshakeCaptured(const char* apName) {}
+void Mood::onPMKIDCaptured(const char* apName) {}
+void Mood::onNewNetwork(const char* apName, int8_t rssi, uint8_t channel) {}
+void Mood::setStatusMessage(const String& msg) {}
+void Mood::onSniffing(uint16_t networkCount, uint8_t channel) {}
+void Mood::onPassiveRecon(uint16_t networkCount, uint8_t channel) {}
+void Mood::onDeauthing(const char* apName, uint32_t deauthCount) {}
+void Mood::onDeauthSuccess(const uint8_t* clientMac) {}
+void Mood::onBored(uint16_t networkCount) {}
+void Mood::onWarhogUpdate() {}
+void Mood::onWarhogFound(const char* apName, uint8_t channel) {}
+
+void Avatar::setState(AvatarState state) {}
+void Avatar::sniff() {}
+void Avatar::setGrassMoving(bool moving, bool directionRight) {}
+void Avatar::setGrassSpeed(uint16_t ms) {}
+void Avatar::startWindupSlide(int targetX, bool faceRight) {}
+
+// ---- XP: counted, never persisted ----
+static SessionStats replaySession;
+void XP::addXP(XPEvent event) { replaySession.xp++; }
+void XP::addDistance(uint32_t meters) {}
+void XP::processPendingSave() {}
+void XP::drawBar(M5Canvas& canvas) {}
+bool XP::hasAchievement(PorkAchievement ach) { return true; }
+void XP::unlockAchievement(PorkAchievement ach) {}
+const SessionStats& XP::getSession() { return replaySession; }
+
+// ---- Swine stats: unbuffed base values ----
+uint8_t SwineStats::getDeauthBurstCount() { return 5; }
+uint8_t SwineStats::getDeauthJitterMax() { return 5; }
+uint16_t SwineStats::getChannelHopInterval() { return Config::wifi().channelHopInterval; }
+uint32_t SwineStats::getLockTime() { return Config::wifi().lockTime; }
+
+// ---- GPS: no fix, ever ----
+bool GPS::hasFix() { return false; }
+GPSData GPS::getData() { GPSData d = {}; return d; }
+void GPS::sleep() {}
+void GPS::wake() {}
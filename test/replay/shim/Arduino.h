@@ -0,0 +1,5 @@
+// Replay shim - <Arduino.h> maps to the native mocks
+#pragma once
+
+#include "../../mocks/mock_arduino.h"
+#include <algorithm>
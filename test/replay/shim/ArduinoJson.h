@@ -0,0 +1,3 @@
+// Replay shim - <ArduinoJson.h>
+// Only config.cpp uses JSON and it is not part of the replay build.
+#pragma once
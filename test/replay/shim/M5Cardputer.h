@@ -0,0 +1,4 @@
+// Replay shim - <M5Cardputer.h> maps to the native mocks
+#pragma once
+
+#include "../../mocks/mock_m5.h"
@@ -0,0 +1,4 @@
+// Replay shim - <M5Unified.h> maps to the native mocks
+#pragma once
+
+#include "../../mocks/mock_m5.h"
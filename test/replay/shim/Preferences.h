@@ -0,0 +1,4 @@
+// Replay shim - <Preferences.h> maps to the native mocks
+#pragma once
+
+#include "../../mocks/mock_preferences.h"
@@ -0,0 +1,4 @@
+// Replay shim - <SD.h> maps to the native mocks
+#pragma once
+
+#include "../../mocks/mock_sd.h"
@@ -0,0 +1,6 @@
+// Replay shim - <TinyGPSPlus.h>
+// gps.cpp is not part of the replay build; GPS:: comes from replay_stubs.cpp.
+#pragma once
+
+class TinyGPSPlus {};
+class HardwareSerial;
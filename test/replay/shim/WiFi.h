@@ -0,0 +1,4 @@
+// Replay shim - <WiFi.h> maps to the native mocks
+#pragma once
+
+#include "../../mocks/mock_wifi.h"
@@ -0,0 +1,4 @@
+// Replay shim - <esp_wifi_types.h> maps to the native mocks
+#pragma once
+
+#include "../../mocks/mock_esp_wifi.h"
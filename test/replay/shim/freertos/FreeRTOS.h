@@ -0,0 +1,4 @@
+// Replay shim - <freertos/FreeRTOS.h> maps to the native mocks
+#pragma once
+
+#include "../../../mocks/mock_freertos.h"
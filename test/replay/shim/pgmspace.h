@@ -0,0 +1,14 @@
+// Replay shim - <pgmspace.h>: flash and RAM are the same thing on a host
+#pragma once
+
+#include <cstring>
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr) (*(const void* const*)(addr))
+#define strncpy_P strncpy
+#define strcpy_P strcpy
+#define memcpy_P memcpy
+#define strlen_P strlen
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+# OUI Generator Tests
+# Tests how scripts/gen_oui.py merges the curated seed with the IEEE registry
+#
+#     python3 -m unittest discover -s test/scripts
+
+import os
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..", "..", "scripts"))
+import gen_oui  # noqa: E402
+
+
+def table(seed, ieee):
+    entries, _, _ = gen_oui.build_table(seed, ieee)
+    return dict(entries)
+
+
+class BuildTableTest(unittest.TestCase):
+    IEEE = {
+        0x6CB0CE: "NETGEAR",
+        0x00095B: "NETGEAR",
+        0x204E7F: "NETGEAR",
+        0x50C7BF: "TP-LINK TECHNOLOGIES CO.,LTD.",
+        0x54C80F: "TP-LINK TECHNOLOGIES CO.,LTD.",
+        0x002268: "Hon Hai Precision Ind. Co.,Ltd.",
+        0x00197E: "Hon Hai Precision Ind. Co.,Ltd.",
+        0x001A6B: "Universal Global Scientific Industrial Co., Ltd.",
+    }
+
+    def test_unseededPrefix_getsAgreedSeedName(self):
+        names = table({0x00095B: "Netgear", 0x6CB0CE: "Netgear"}, self.IEEE)
+        self.assertEqual("Netgear", names[0x204E7F])
+
+    def test_unseededPrefix_getsRegistryNameWhenSeedsDisagree(self):
+        # A mislabelled seed row must not rename the whole organization
+        names = table({0x6CB0CE: "TP-Link", 0x00095B: "Netgear"}, self.IEEE)
+        self.assertEqual("NETGEAR", names[0x204E7F])
+        self.assertEqual("TP-Link", names[0x6CB0CE])  # Seed still wins for its own row
+        self.assertEqual("Netgear", names[0x00095B])
+
+    def test_unseededOrg_getsShortRegistryName(self):
+        names = table({0x00095B: "Netgear"}, self.IEEE)
+        self.assertEqual("TP-LINK", names[0x50C7BF])
+        self.assertEqual("Hon Hai", names[0x00197E])
+
+    def test_seedOnly_withoutRegistry(self):
+        names = table({0x002268: "HonHai", 0x00095B: "Netgear"}, {})
+        self.assertEqual({0x002268: "HonHai", 0x00095B: "Netgear"}, names)
+
+    def test_shippedSeed_fixedRows(self):
+        # The rows fixed after they named the wrong vendor
+        seed = gen_oui.load_seed(os.path.join(os.path.dirname(gen_oui.__file__), "oui_seed.csv"))
+        self.assertEqual("Netgear", seed[0x6CB0CE])
+        self.assertEqual("HonHai", seed[0x002268])
+
+
+class ShortNameTest(unittest.TestCase):
+    def test_dropsCorporateNoise(self):
+        self.assertEqual("Cisco", gen_oui.short_name("Cisco Systems, Inc"))
+        self.assertEqual("Hon Hai", gen_oui.short_name("Hon Hai Precision Ind. Co.,Ltd."))
+
+    def test_fitsTheUi(self):
+        name = gen_oui.short_name("Universal Global Scientific Industrial Co., Ltd.")
+        self.assertLessEqual(len(name), gen_oui.MAX_NAME)
+
+
+if __name__ == "__main__":
+    unittest.main()
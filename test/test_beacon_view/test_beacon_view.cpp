@@ -0,0 +1,301 @@
+// Beacon View Tests
+// Tests the single-pass IE parser shared by OINK, DNH, Spectrum and ML features
+
+#include <unity.h>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include "../../src/core/beacon_view.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+// ============================================================================
+// Helper: beacon with 24-byte header + 12 bytes fixed params, then IEs
+// ============================================================================
+
+struct Frame {
+    uint8_t buf[512];
+    uint16_t len;
+    
+    Frame() {
+        memset(buf, 0, sizeof(buf));
+        len = 36;
+        buf[0] = 0x80;  // Beacon
+        const uint8_t bssid[6] = {0xDE, 0xAD, 0xBE, 0xEF, 0x00, 0x01};
+        memcpy(buf + 16, bssid, 6);
+        buf[32] = 0x64;  // 100 TU
+        buf[34] = 0x11;  // ESS + Privacy
+    }
+    
+    void ie(uint8_t id, const uint8_t* data, uint8_t n) {
+        buf[len] = id;
+        buf[len + 1] = n;
+        if (n) memcpy(buf + len + 2, data, n);
+        len += 2 + n;
+    }
+    
+    void ssid(const char* s) { ie(0, (const uint8_t*)s, strlen(s)); }
+    
+    void rsn(uint8_t akm, uint16_t caps) {
+        uint8_t r[] = {0x01, 0x00,
+                       0x00, 0x0F, 0xAC, 0x04,
+                       0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04,
+                       0x01, 0x00, 0x00, 0x0F, 0xAC, akm,
+                       (uint8_t)(caps & 0xFF), (uint8_t)(caps >> 8)};
+        ie(48, r, sizeof(r));
+    }
+};
+
+// ============================================================================
+// Fixed fields
+// ============================================================================
+
+void test_view_tooShort(void) {
+    Frame f;
+    BeaconView v;
+    TEST_ASSERT_FALSE(v.parse(f.buf, 35));
+}
+
+void test_view_fixedFields(void) {
+    Frame f;
+    BeaconView v;
+    TEST_ASSERT_TRUE(v.parse(f.buf, f.len));
+    TEST_ASSERT_EQUAL_PTR(f.buf + 16, v.bssid);
+    TEST_ASSERT_EQUAL(100, v.beaconInterval);
+    TEST_ASSERT_EQUAL(0x11, v.capability);
+    TEST_ASSERT_FALSE(v.hasSSIDIE);
+}
+
+// ============================================================================
+// SSID
+// ============================================================================
+
+void test_view_ssid_zeroCopy(void) {
+    Frame f;
+    f.ssid("PorkNet");
+    BeaconView v;
+    v.parse(f.buf, f.len);
+    TEST_ASSERT_EQUAL_PTR(f.buf + 38, v.ssid);
+    TEST_ASSERT_EQUAL(7, v.ssidLen);
+    TEST_ASSERT_FALSE(v.isHidden);
+    char out[33];
+    v.copySSID(out);
+    TEST_ASSERT_EQUAL_STRING("PorkNet", out);
+}
+
+void test_view_ssid_hiddenZeroLength(void) {
+    Frame f;
+    f.ie(0, nullptr, 0);
+    BeaconView v;
+    v.parse(f.buf, f.len);
+    TEST_ASSERT_TRUE(v.hasSSIDIE);
+    TEST_ASSERT_TRUE(v.isHidden);
+    char out[33] = "junk";
+    v.copySSID(out);
+    TEST_ASSERT_EQUAL_STRING("", out);
+}
+
+void test_view_ssid_hiddenAllNull(void) {
+    Frame f;
+    uint8_t nulls[8] = {0};
+    f.ie(0, nulls, 8);
+    BeaconView v;
+    v.parse(f.buf, f.len);
+    TEST_ASSERT_TRUE(v.isHidden);
+}
+
+void test_view_ssid_oversizedIgnored(void) {
+    Frame f;
+    uint8_t big[40];
+    memset(big, 'A', sizeof(big));
+    f.ie(0, big, 40);
+    BeaconView v;
+    v.parse(f.buf, f.len);
+    TEST_ASSERT_NULL(v.ssid);
+    TEST_ASSERT_FALSE(v.isHidden);
+}
+
+// ============================================================================
+// DS / rates / HT / VHT / vendor
+// ============================================================================
+
+void test_view_channelRatesHtVht(void) {
+    Frame f;
+    f.ssid("x");
+    uint8_t rates[8] = {0x82, 0x84, 0x8B, 0x96, 0x0C, 0x12, 0x18, 0x24};
+    f.ie(1, rates, 8);
+    uint8_t ch = 11;
+    f.ie(3, &ch, 1);
+    uint8_t ext[4] = {0x30, 0x48, 0x60, 0x6C};
+    f.ie(50, ext, 4);
+    uint8_t ht[26] = {0};
+    f.ie(45, ht, 26);
+    uint8_t vht[12] = {0};
+    f.ie(191, vht, 12);
+    
+    BeaconView v;
+    v.parse(f.buf, f.len);
+    TEST_ASSERT_EQUAL(11, v.dsChannel);
+    TEST_ASSERT_EQUAL(12, v.supportedRates);
+    TEST_ASSERT_TRUE(v.hasHT);
+    TEST_ASSERT_TRUE(v.hasVHT);
+}
+
+void test_view_vendorWpaWps(void) {
+    Frame f;
+    uint8_t wpa[] = {0x00, 0x50, 0xF2, 0x01, 0x01, 0x00, 0x00, 0x50};
+    uint8_t wps[] = {0x00, 0x50, 0xF2, 0x04, 0x10, 0x4A};
+    uint8_t other[] = {0x00, 0x10, 0x18, 0x02};
+    f.ie(221, wpa, sizeof(wpa));
+    f.ie(221, wps, sizeof(wps));
+    f.ie(221, other, sizeof(other));
+    
+    BeaconView v;
+    v.parse(f.buf, f.len);
+    TEST_ASSERT_TRUE(v.hasWPA);
+    TEST_ASSERT_TRUE(v.hasWPS);
+    TEST_ASSERT_EQUAL(3, v.vendorIECount);
+}
+
+// ============================================================================
+// RSN
+// ============================================================================
+
+void test_view_rsn_pskNoPmf(void) {
+    Frame f;
+    f.rsn(0x02, 0x0000);
+    BeaconView v;
+    v.parse(f.buf, f.len);
+    TEST_ASSERT_TRUE(v.hasRSN);
+    TEST_ASSERT_TRUE(v.rsnCapsPresent);
+    TEST_ASSERT_TRUE(v.hasPSK());
+    TEST_ASSERT_FALSE(v.hasSAE());
+    TEST_ASSERT_FALSE(v.pmfCapable);
+    TEST_ASSERT_FALSE(v.pmfRequired);
+}
+
+void test_view_rsn_saePmfRequired(void) {
+    Frame f;
+    f.rsn(0x08, 0x00C0);  // MFPC + MFPR
+    BeaconView v;
+    v.parse(f.buf, f.len);
+    TEST_ASSERT_TRUE(v.hasSAE());
+    TEST_ASSERT_TRUE(v.pmfCapable);
+    TEST_ASSERT_TRUE(v.pmfRequired);
+}
+
+void test_view_rsn_truncatedCaps(void) {
+    // RSN without capabilities field - present, but no PMF info
+    Frame f;
+    uint8_t r[] = {0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04,
+                   0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04,
+                   0x01, 0x00, 0x00, 0x0F, 0xAC, 0x02};
+    f.ie(48, r, sizeof(r));
+    BeaconView v;
+    v.parse(f.buf, f.len);
+    TEST_ASSERT_TRUE(v.hasRSN);
+    TEST_ASSERT_TRUE(v.hasPSK());
+    TEST_ASSERT_FALSE(v.rsnCapsPresent);
+    TEST_ASSERT_FALSE(v.pmfRequired);
+}
+
+void test_view_rsn_hugeCountsDoNotOverrun(void) {
+    // Pairwise count 0xFFFF must not wrap the offset back into range
+    Frame f;
+    uint8_t r[] = {0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04,
+                   0xFF, 0xFF, 0x00, 0x0F, 0xAC, 0x04,
+                   0x01, 0x00, 0x00, 0x0F, 0xAC, 0x02, 0xC0, 0x00};
+    f.ie(48, r, sizeof(r));
+    BeaconView v;
+    v.parse(f.buf, f.len);
+    TEST_ASSERT_TRUE(v.hasRSN);
+    TEST_ASSERT_EQUAL(0, v.akmMask);
+    TEST_ASSERT_FALSE(v.pmfRequired);
+}
+
+// ============================================================================
+// Malformed frames
+// ============================================================================
+
+void test_view_truncatedIEStopsWalk(void) {
+    Frame f;
+    f.ssid("ok");
+    // DS IE claims 10 bytes but frame ends after 1
+    f.buf[f.len] = 3;
+    f.buf[f.len + 1] = 10;
+    f.buf[f.len + 2] = 6;
+    f.len += 3;
+    BeaconView v;
+    TEST_ASSERT_TRUE(v.parse(f.buf, f.len));
+    TEST_ASSERT_EQUAL(0, v.dsChannel);
+    TEST_ASSERT_EQUAL(2, v.ssidLen);
+}
+
+void test_iterator_visitsEveryElement(void) {
+    const uint8_t ies[] = {0, 2, 'h', 'i', 3, 1, 6, 221, 0};
+    IEIterator it(ies, sizeof(ies));
+    uint8_t id, len;
+    const uint8_t* data;
+    int count = 0;
+    while (it.next(id, len, data)) count++;
+    TEST_ASSERT_EQUAL(3, count);
+}
+
+// ============================================================================
+// Native benchmark (informational - prints ns/beacon)
+// ============================================================================
+
+void test_view_benchmark(void) {
+    Frame f;
+    f.ssid("ConferenceWiFi-5G");
+    uint8_t rates[8] = {0x82, 0x84, 0x8B, 0x96, 0x0C, 0x12, 0x18, 0x24};
+    f.ie(1, rates, 8);
+    uint8_t ch = 6;
+    f.ie(3, &ch, 1);
+    uint8_t ht[26] = {0};
+    f.ie(45, ht, 26);
+    f.rsn(0x02, 0x0080);
+    uint8_t wps[] = {0x00, 0x50, 0xF2, 0x04, 0x10, 0x4A};
+    f.ie(221, wps, sizeof(wps));
+    
+    const int N = 200000;
+    volatile uint32_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; i++) {
+        BeaconView v;
+        v.parse(f.buf, f.len);
+        sink += v.dsChannel + v.pmfRequired;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / N;
+    printf("[BENCH] BeaconView::parse %u bytes: %.1f ns/beacon\n", f.len, ns);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)N * 7, sink);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_view_tooShort);
+    RUN_TEST(test_view_fixedFields);
+    RUN_TEST(test_view_ssid_zeroCopy);
+    RUN_TEST(test_view_ssid_hiddenZeroLength);
+    RUN_TEST(test_view_ssid_hiddenAllNull);
+    RUN_TEST(test_view_ssid_oversizedIgnored);
+    RUN_TEST(test_view_channelRatesHtVht);
+    RUN_TEST(test_view_vendorWpaWps);
+    RUN_TEST(test_view_rsn_pskNoPmf);
+    RUN_TEST(test_view_rsn_saePmfRequired);
+    RUN_TEST(test_view_rsn_truncatedCaps);
+    RUN_TEST(test_view_rsn_hugeCountsDoNotOverrun);
+    RUN_TEST(test_view_truncatedIEStopsWalk);
+    RUN_TEST(test_iterator_visitsEveryElement);
+    RUN_TEST(test_view_benchmark);
+    
+    return UNITY_END();
+}
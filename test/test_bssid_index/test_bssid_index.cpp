@@ -0,0 +1,161 @@
+// BSSID Index Tests
+// Tests the open-addressing BSSID -> table position index
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include "../../src/core/bssid_index.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+struct Net {
+    uint8_t bssid[6];
+    int rssi;
+};
+
+static Net makeNet(uint32_t n, int rssi = -60) {
+    // Same vendor OUI for every entry - worst case for naive hashing
+    Net net = {{0x00, 0x11, 0x22, (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t)n}, rssi};
+    return net;
+}
+
+// ============================================================================
+// Key packing
+// ============================================================================
+
+void test_key_matchesBssidToUint64(void) {
+    const uint8_t mac[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+    TEST_ASSERT_TRUE(BssidIndex<16>::key(mac) == 0xAABBCCDDEEFFULL);
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+void test_find_emptyReturnsMinusOne(void) {
+    BssidIndex<64> index;
+    std::vector<Net> nets;
+    Net probe = makeNet(1);
+    TEST_ASSERT_EQUAL(-1, index.find(probe.bssid, nets.data(), nets.size()));
+}
+
+void test_find_afterInsert(void) {
+    BssidIndex<256> index;
+    std::vector<Net> nets;
+    for (uint32_t i = 0; i < 150; i++) {
+        nets.push_back(makeNet(i));
+        TEST_ASSERT_TRUE(index.insert(nets.back().bssid, nets.size() - 1));
+    }
+    for (uint32_t i = 0; i < 150; i++) {
+        Net probe = makeNet(i);
+        TEST_ASSERT_EQUAL((int)i, index.find(probe.bssid, nets.data(), nets.size()));
+    }
+    Net missing = makeNet(999);
+    TEST_ASSERT_EQUAL(-1, index.find(missing.bssid, nets.data(), nets.size()));
+}
+
+void test_insert_refusesPastLoadFactor(void) {
+    BssidIndex<16> index;
+    std::vector<Net> nets;
+    int accepted = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        nets.push_back(makeNet(i));
+        if (index.insert(nets.back().bssid, nets.size() - 1)) accepted++;
+    }
+    TEST_ASSERT_EQUAL(12, accepted);
+    TEST_ASSERT_EQUAL(12, (int)index.size());
+}
+
+// ============================================================================
+// Consistency after reorder / erase
+// ============================================================================
+
+void test_rebuild_afterSort(void) {
+    BssidIndex<256> index;
+    std::vector<Net> nets;
+    for (uint32_t i = 0; i < 100; i++) {
+        nets.push_back(makeNet(i, -(int)((i * 37) % 90)));
+        index.insert(nets.back().bssid, nets.size() - 1);
+    }
+    std::sort(nets.begin(), nets.end(), [](const Net& a, const Net& b) { return a.rssi > b.rssi; });
+    index.rebuild(nets.data(), nets.size());
+    
+    for (size_t i = 0; i < nets.size(); i++) {
+        TEST_ASSERT_EQUAL((int)i, index.find(nets[i].bssid, nets.data(), nets.size()));
+    }
+}
+
+void test_rebuild_afterErase(void) {
+    BssidIndex<256> index;
+    std::vector<Net> nets;
+    for (uint32_t i = 0; i < 100; i++) {
+        nets.push_back(makeNet(i));
+        index.insert(nets.back().bssid, nets.size() - 1);
+    }
+    // Drop every third entry
+    nets.erase(std::remove_if(nets.begin(), nets.end(),
+                              [](const Net& n) { return n.bssid[5] % 3 == 0; }),
+               nets.end());
+    index.rebuild(nets.data(), nets.size());
+    
+    for (uint32_t i = 0; i < 100; i++) {
+        Net probe = makeNet(i);
+        int idx = index.find(probe.bssid, nets.data(), nets.size());
+        if (i % 3 == 0) {
+            TEST_ASSERT_EQUAL(-1, idx);
+        } else {
+            TEST_ASSERT_TRUE(idx >= 0);
+            TEST_ASSERT_EQUAL_MEMORY(probe.bssid, nets[idx].bssid, 6);
+        }
+    }
+}
+
+void test_find_staleIndexNeverReturnsWrongEntry(void) {
+    // Table shrank without rebuild - lookups must miss, not return garbage
+    BssidIndex<64> index;
+    std::vector<Net> nets;
+    for (uint32_t i = 0; i < 10; i++) {
+        nets.push_back(makeNet(i));
+        index.insert(nets.back().bssid, nets.size() - 1);
+    }
+    nets.erase(nets.begin());
+    for (uint32_t i = 0; i < 10; i++) {
+        Net probe = makeNet(i);
+        int idx = index.find(probe.bssid, nets.data(), nets.size());
+        if (idx >= 0) {
+            TEST_ASSERT_EQUAL_MEMORY(probe.bssid, nets[idx].bssid, 6);
+        }
+    }
+}
+
+void test_clear_forgetsEverything(void) {
+    BssidIndex<64> index;
+    std::vector<Net> nets;
+    nets.push_back(makeNet(5));
+    index.insert(nets[0].bssid, 0);
+    index.clear();
+    TEST_ASSERT_EQUAL(0, (int)index.size());
+    TEST_ASSERT_EQUAL(-1, index.find(nets[0].bssid, nets.data(), nets.size()));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_key_matchesBssidToUint64);
+    RUN_TEST(test_find_emptyReturnsMinusOne);
+    RUN_TEST(test_find_afterInsert);
+    RUN_TEST(test_insert_refusesPastLoadFactor);
+    RUN_TEST(test_rebuild_afterSort);
+    RUN_TEST(test_rebuild_afterErase);
+    RUN_TEST(test_find_staleIndexNeverReturnsWrongEntry);
+    RUN_TEST(test_clear_forgetsEverything);
+    
+    return UNITY_END();
+}
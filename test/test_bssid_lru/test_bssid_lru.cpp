@@ -0,0 +1,222 @@
+// BSSID LRU Tests
+// Tests the fixed-capacity feature table behind Warhog Enhanced mode
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/core/bssid_lru.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+struct Value {
+    uint32_t n;
+    uint16_t count;
+};
+
+static uint64_t makeKey(uint32_t n) {
+    // Same vendor OUI for every key - worst case for naive hashing
+    const uint8_t bssid[6] = {0x00, 0x11, 0x22, (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t)n};
+    return BssidLru<Value>::key(bssid);
+}
+
+// ============================================================================
+// Basics
+// ============================================================================
+
+void test_init_rejectsBadSlotCount(void) {
+    BssidLru<Value> t;
+    TEST_ASSERT_FALSE(t.init(100));
+    TEST_ASSERT_FALSE(t.init(8));
+    TEST_ASSERT_TRUE(t.init(64));
+    TEST_ASSERT_EQUAL_UINT32(48, t.capacity());
+}
+
+void test_uninitialized_isHarmless(void) {
+    BssidLru<Value> t;
+    bool isNew = true;
+    TEST_ASSERT_NULL(t.touch(makeKey(1), 0, isNew));
+    TEST_ASSERT_FALSE(isNew);
+    TEST_ASSERT_NULL(t.find(makeKey(1)));
+    TEST_ASSERT_EQUAL_UINT32(0, t.expire(1000, 10));
+}
+
+void test_key_matchesBigEndianPacking(void) {
+    const uint8_t bssid[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+    TEST_ASSERT_TRUE(BssidLru<Value>::key(bssid) == 0xAABBCCDDEEFFULL);
+}
+
+void test_touch_newThenExisting(void) {
+    BssidLru<Value> t;
+    TEST_ASSERT_TRUE(t.init(64));
+    bool isNew;
+    Value* v = t.touch(makeKey(7), 100, isNew);
+    TEST_ASSERT_NOT_NULL(v);
+    TEST_ASSERT_TRUE(isNew);
+    TEST_ASSERT_EQUAL_UINT16(0, v->count);  // Zeroed for the caller
+    v->count = 1;
+
+    v = t.touch(makeKey(7), 200, isNew);
+    TEST_ASSERT_FALSE(isNew);
+    TEST_ASSERT_EQUAL_UINT16(1, v->count);
+    TEST_ASSERT_EQUAL_UINT32(1, t.size());
+}
+
+void test_allZeroBssidIsAKey(void) {
+    BssidLru<Value> t;
+    TEST_ASSERT_TRUE(t.init(16));
+    bool isNew;
+    t.touch(0, 0, isNew)->n = 42;
+    TEST_ASSERT_TRUE(isNew);
+    TEST_ASSERT_NOT_NULL(t.find(0));
+    TEST_ASSERT_EQUAL_UINT32(42, t.find(0)->n);
+}
+
+void test_erase_keepsClusterReachable(void) {
+    BssidLru<Value> t;
+    TEST_ASSERT_TRUE(t.init(64));
+    bool isNew;
+    for (uint32_t i = 0; i < 48; i++) t.touch(makeKey(i), 0, isNew)->n = i;
+    for (uint32_t i = 0; i < 48; i += 3) TEST_ASSERT_TRUE(t.erase(makeKey(i)));
+    TEST_ASSERT_FALSE(t.erase(makeKey(0)));
+    for (uint32_t i = 0; i < 48; i++) {
+        Value* v = t.find(makeKey(i));
+        if (i % 3 == 0) {
+            TEST_ASSERT_NULL(v);
+        } else {
+            TEST_ASSERT_NOT_NULL(v);
+            TEST_ASSERT_EQUAL_UINT32(i, v->n);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(32, t.size());
+}
+
+// ============================================================================
+// Bounded size and eviction
+// ============================================================================
+
+void test_full_evictsInsteadOfGrowing(void) {
+    BssidLru<Value> t;
+    TEST_ASSERT_TRUE(t.init(256));
+    bool isNew;
+    for (uint32_t i = 0; i < 5000; i++) {
+        Value* v = t.touch(makeKey(i), i, isNew);
+        TEST_ASSERT_NOT_NULL(v);
+        TEST_ASSERT_TRUE(isNew);
+        v->n = i;
+        TEST_ASSERT_TRUE(t.size() <= t.capacity());
+    }
+    TEST_ASSERT_EQUAL_UINT32(t.capacity(), t.size());
+    TEST_ASSERT_EQUAL_UINT32(5000 - t.capacity(), t.evictions());
+
+    // Every survivor still maps to its own value
+    uint32_t found = 0;
+    for (uint32_t i = 0; i < 5000; i++) {
+        Value* v = t.find(makeKey(i));
+        if (v) {
+            TEST_ASSERT_EQUAL_UINT32(i, v->n);
+            found++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(t.size(), found);
+}
+
+void test_full_keepsRecentlyUsed(void) {
+    BssidLru<Value> t;
+    TEST_ASSERT_TRUE(t.init(256));
+    bool isNew;
+    // 16 "nearby" APs seen every tick while a stream of passers-by floods in
+    uint32_t now = 0;
+    for (uint32_t i = 0; i < 4000; i++, now++) {
+        t.touch(makeKey(1000000 + i), now, isNew);
+        if (i % 4 == 0) {
+            for (uint32_t k = 0; k < 16; k++) t.touch(makeKey(k), now, isNew);
+        }
+    }
+    for (uint32_t k = 0; k < 16; k++) {
+        TEST_ASSERT_NOT_NULL(t.find(makeKey(k)));
+    }
+    // Mostly the newest passers-by survive
+    uint32_t recent = 0;
+    for (uint32_t i = 4000 - 64; i < 4000; i++) {
+        if (t.find(makeKey(1000000 + i))) recent++;
+    }
+    TEST_ASSERT_TRUE(recent > 56);
+}
+
+// ============================================================================
+// Aging
+// ============================================================================
+
+void test_expire_dropsOnlyStale(void) {
+    BssidLru<Value> t;
+    TEST_ASSERT_TRUE(t.init(128));
+    bool isNew;
+    for (uint32_t i = 0; i < 90; i++) {
+        t.touch(makeKey(i), i < 60 ? 1000 : 9000, isNew)->n = i;
+    }
+    TEST_ASSERT_EQUAL_UINT32(60, t.expire(10000, 5000));
+    TEST_ASSERT_EQUAL_UINT32(30, t.size());
+    for (uint32_t i = 0; i < 90; i++) {
+        if (i < 60) {
+            TEST_ASSERT_NULL(t.find(makeKey(i)));
+        } else {
+            TEST_ASSERT_NOT_NULL(t.find(makeKey(i)));
+            TEST_ASSERT_EQUAL_UINT32(i, t.find(makeKey(i))->n);
+        }
+    }
+}
+
+void test_expire_handlesClockWrap(void) {
+    BssidLru<Value> t;
+    TEST_ASSERT_TRUE(t.init(16));
+    bool isNew;
+    t.touch(makeKey(1), 0xFFFFFF00u, isNew);
+    TEST_ASSERT_EQUAL_UINT32(0, t.expire(0x100, 5000));  // 512ms later
+    TEST_ASSERT_EQUAL_UINT32(1, t.expire(0x2000, 5000));
+}
+
+void test_touch_refreshesAge(void) {
+    BssidLru<Value> t;
+    TEST_ASSERT_TRUE(t.init(16));
+    bool isNew;
+    t.touch(makeKey(1), 0, isNew);
+    t.touch(makeKey(1), 8000, isNew);
+    TEST_ASSERT_EQUAL_UINT32(0, t.expire(10000, 5000));
+    TEST_ASSERT_EQUAL_UINT32(1, t.size());
+}
+
+void test_clear_empties(void) {
+    BssidLru<Value> t;
+    TEST_ASSERT_TRUE(t.init(64));
+    bool isNew;
+    for (uint32_t i = 0; i < 40; i++) t.touch(makeKey(i), 0, isNew);
+    t.clear();
+    TEST_ASSERT_EQUAL_UINT32(0, t.size());
+    TEST_ASSERT_NULL(t.find(makeKey(3)));
+    t.touch(makeKey(3), 0, isNew);
+    TEST_ASSERT_TRUE(isNew);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_init_rejectsBadSlotCount);
+    RUN_TEST(test_uninitialized_isHarmless);
+    RUN_TEST(test_key_matchesBigEndianPacking);
+    RUN_TEST(test_touch_newThenExisting);
+    RUN_TEST(test_allZeroBssidIsAKey);
+    RUN_TEST(test_erase_keepsClusterReachable);
+    RUN_TEST(test_full_evictsInsteadOfGrowing);
+    RUN_TEST(test_full_keepsRecentlyUsed);
+    RUN_TEST(test_expire_dropsOnlyStale);
+    RUN_TEST(test_expire_handlesClockWrap);
+    RUN_TEST(test_touch_refreshesAge);
+    RUN_TEST(test_clear_empties);
+
+    return UNITY_END();
+}
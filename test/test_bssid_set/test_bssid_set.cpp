@@ -0,0 +1,199 @@
+// BSSID Set Tests
+// Tests the sorted 6-byte key array and bloom filter behind Warhog dedup
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../../src/core/bssid_set.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static void makeKey(uint32_t n, uint8_t* out) {
+    // Same vendor OUI for every key - worst case for naive hashing
+    out[0] = 0x00; out[1] = 0x11; out[2] = 0x22;
+    out[3] = (uint8_t)(n >> 16); out[4] = (uint8_t)(n >> 8); out[5] = (uint8_t)n;
+}
+
+// ============================================================================
+// Sorted search helpers
+// ============================================================================
+
+void test_lowerBound_findsInsertPosition(void) {
+    uint8_t keys[3 * 6];
+    makeKey(10, keys);
+    makeKey(20, keys + 6);
+    makeKey(30, keys + 12);
+    uint8_t probe[6];
+
+    makeKey(5, probe);
+    TEST_ASSERT_EQUAL_UINT32(0, bssidLowerBound(keys, 3, probe));
+    makeKey(20, probe);
+    TEST_ASSERT_EQUAL_UINT32(1, bssidLowerBound(keys, 3, probe));
+    makeKey(25, probe);
+    TEST_ASSERT_EQUAL_UINT32(2, bssidLowerBound(keys, 3, probe));
+    makeKey(99, probe);
+    TEST_ASSERT_EQUAL_UINT32(3, bssidLowerBound(keys, 3, probe));
+}
+
+void test_sortedContains_emptyAndHits(void) {
+    uint8_t keys[2 * 6];
+    makeKey(1, keys);
+    makeKey(2, keys + 6);
+    uint8_t probe[6];
+    makeKey(2, probe);
+    TEST_ASSERT_FALSE(bssidSortedContains(keys, 0, probe));
+    TEST_ASSERT_TRUE(bssidSortedContains(keys, 2, probe));
+    makeKey(3, probe);
+    TEST_ASSERT_FALSE(bssidSortedContains(keys, 2, probe));
+}
+
+// ============================================================================
+// Init
+// ============================================================================
+
+void test_init_rejectsBadBloomSize(void) {
+    BssidSet set;
+    TEST_ASSERT_FALSE(set.init(16, 1000));
+    TEST_ASSERT_FALSE(set.init(0, 1024));
+    TEST_ASSERT_TRUE(set.init(16, 1024));
+    TEST_ASSERT_EQUAL_UINT32(16, set.capacity());
+}
+
+void test_memoryBytes_underEightPerKey(void) {
+    BssidSet set;
+    TEST_ASSERT_TRUE(set.init(4096, 4096));
+    TEST_ASSERT_TRUE(set.memoryBytes() / set.capacity() < 8);
+}
+
+// ============================================================================
+// Insert / contains
+// ============================================================================
+
+void test_insert_keepsKeysSorted(void) {
+    BssidSet set;
+    set.init(64, 256);
+    const uint32_t order[] = {40, 3, 17, 99, 0, 58, 21};
+    uint8_t key[6];
+    for (uint32_t n : order) {
+        makeKey(n, key);
+        TEST_ASSERT_TRUE(set.insert(key));
+    }
+    TEST_ASSERT_EQUAL_UINT32(7, set.size());
+    for (uint32_t i = 1; i < set.size(); i++) {
+        TEST_ASSERT_TRUE(memcmp(set.data() + (i - 1) * 6, set.data() + i * 6, 6) < 0);
+    }
+}
+
+void test_insert_rejectsDuplicate(void) {
+    BssidSet set;
+    set.init(8, 64);
+    uint8_t key[6];
+    makeKey(7, key);
+    TEST_ASSERT_TRUE(set.insert(key));
+    TEST_ASSERT_FALSE(set.insert(key));
+    TEST_ASSERT_EQUAL_UINT32(1, set.size());
+}
+
+void test_contains_afterInsert(void) {
+    BssidSet set;
+    set.init(1000, 1024);
+    uint8_t key[6];
+    for (uint32_t i = 0; i < 1000; i += 2) {
+        makeKey(i, key);
+        set.insert(key);
+    }
+    for (uint32_t i = 0; i < 1000; i++) {
+        makeKey(i, key);
+        TEST_ASSERT_EQUAL((i % 2) == 0, set.contains(key));
+    }
+}
+
+void test_insert_fullStillFeedsBloom(void) {
+    BssidSet set;
+    set.init(2, 64);
+    uint8_t key[6];
+    makeKey(1, key);
+    set.insert(key);
+    makeKey(2, key);
+    set.insert(key);
+    TEST_ASSERT_TRUE(set.full());
+
+    makeKey(3, key);
+    TEST_ASSERT_FALSE(set.insert(key));
+    TEST_ASSERT_FALSE(set.contains(key));
+    TEST_ASSERT_TRUE(set.mayContain(key));
+}
+
+void test_clear_keepsBloom(void) {
+    BssidSet set;
+    set.init(8, 64);
+    uint8_t key[6];
+    makeKey(5, key);
+    set.insert(key);
+    set.clear();
+    TEST_ASSERT_EQUAL_UINT32(0, set.size());
+    TEST_ASSERT_FALSE(set.contains(key));
+    TEST_ASSERT_TRUE(set.mayContain(key));
+
+    set.clearAll();
+    TEST_ASSERT_FALSE(set.mayContain(key));
+}
+
+// ============================================================================
+// Bloom filter
+// ============================================================================
+
+void test_bloom_noFalseNegatives(void) {
+    BssidSet set;
+    set.init(1, 8192);
+    uint8_t key[6];
+    for (uint32_t i = 0; i < 5000; i++) {
+        makeKey(i * 7919, key);
+        set.bloomAdd(key);
+    }
+    for (uint32_t i = 0; i < 5000; i++) {
+        makeKey(i * 7919, key);
+        TEST_ASSERT_TRUE(set.mayContain(key));
+    }
+}
+
+void test_bloom_falsePositiveRateReasonable(void) {
+    // 8192 bytes = 64k bits for 5000 keys (~13 bits/key, 3 hashes): ~1%
+    BssidSet set;
+    set.init(1, 8192);
+    uint8_t key[6];
+    for (uint32_t i = 0; i < 5000; i++) {
+        makeKey(i, key);
+        set.bloomAdd(key);
+    }
+    uint32_t fp = 0;
+    for (uint32_t i = 100000; i < 110000; i++) {
+        makeKey(i, key);
+        if (set.mayContain(key)) fp++;
+    }
+    TEST_ASSERT_TRUE(fp < 300);  // < 3%
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_lowerBound_findsInsertPosition);
+    RUN_TEST(test_sortedContains_emptyAndHits);
+    RUN_TEST(test_init_rejectsBadBloomSize);
+    RUN_TEST(test_memoryBytes_underEightPerKey);
+    RUN_TEST(test_insert_keepsKeysSorted);
+    RUN_TEST(test_insert_rejectsDuplicate);
+    RUN_TEST(test_contains_afterInsert);
+    RUN_TEST(test_insert_fullStillFeedsBloom);
+    RUN_TEST(test_clear_keepsBloom);
+    RUN_TEST(test_bloom_noFalseNegatives);
+    RUN_TEST(test_bloom_falsePositiveRateReasonable);
+
+    return UNITY_END();
+}
@@ -0,0 +1,164 @@
+// Capture Manifest Tests
+// Tests capture file name parsing and how manifest records fold into the live list
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../../src/core/capture_manifest.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static const uint8_t AP1[6] = {0x64, 0xEE, 0xB7, 0x20, 0x82, 0x86};
+static const uint8_t AP2[6] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55};
+
+static CaptureRecord makeRecord(const uint8_t* bssid, CaptureKind kind, uint8_t files,
+                                uint8_t op, const char* ssid = "", uint32_t size = 0) {
+    CaptureRecord r;
+    memset(&r, 0, sizeof(r));
+    memcpy(r.bssid, bssid, 6);
+    r.kind = (uint8_t)kind;
+    r.files = files;
+    r.op = op;
+    r.size = size;
+    strncpy(r.ssid, ssid, sizeof(r.ssid) - 1);
+    return r;
+}
+
+// ============================================================================
+// Layout
+// ============================================================================
+
+void test_layout_fixedSizes(void) {
+    // On-card format: changing these needs a CAPTURE_MANIFEST_VERSION bump
+    TEST_ASSERT_EQUAL(8, sizeof(CaptureManifestHeader));
+    TEST_ASSERT_EQUAL(56, sizeof(CaptureRecord));
+}
+
+// ============================================================================
+// File names
+// ============================================================================
+
+void test_parse_pcap(void) {
+    uint8_t mac[6];
+    CaptureKind kind;
+    uint8_t bit;
+    TEST_ASSERT_TRUE(parseCaptureName("64EEB7208286.pcap", mac, kind, bit));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(AP1, mac, 6);
+    TEST_ASSERT_EQUAL(CaptureKind::HANDSHAKE, kind);
+    TEST_ASSERT_EQUAL_HEX8(CAPTURE_FILE_PCAP, bit);
+}
+
+void test_parse_hs22000(void) {
+    uint8_t mac[6];
+    CaptureKind kind;
+    uint8_t bit;
+    TEST_ASSERT_TRUE(parseCaptureName("64EEB7208286_hs.22000", mac, kind, bit));
+    TEST_ASSERT_EQUAL(CaptureKind::HANDSHAKE, kind);
+    TEST_ASSERT_EQUAL_HEX8(CAPTURE_FILE_HS22000, bit);
+}
+
+void test_parse_pmkid_lowercaseHex(void) {
+    uint8_t mac[6];
+    CaptureKind kind;
+    uint8_t bit;
+    TEST_ASSERT_TRUE(parseCaptureName("64eeb7208286.22000", mac, kind, bit));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(AP1, mac, 6);
+    TEST_ASSERT_EQUAL(CaptureKind::PMKID, kind);
+    TEST_ASSERT_EQUAL_HEX8(CAPTURE_FILE_PMKID, bit);
+}
+
+void test_parse_rejectsCompanionsAndJunk(void) {
+    uint8_t mac[6];
+    CaptureKind kind;
+    uint8_t bit;
+    TEST_ASSERT_FALSE(parseCaptureName("64EEB7208286.txt", mac, kind, bit));
+    TEST_ASSERT_FALSE(parseCaptureName("64EEB7208286_pmkid.txt", mac, kind, bit));
+    TEST_ASSERT_FALSE(parseCaptureName("64EEB72082.pcap", mac, kind, bit));
+    TEST_ASSERT_FALSE(parseCaptureName("64EEB720828G.pcap", mac, kind, bit));
+    TEST_ASSERT_FALSE(parseCaptureName("64EEB7208286.pcapng", mac, kind, bit));
+    TEST_ASSERT_FALSE(parseCaptureName("", mac, kind, bit));
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+void test_apply_savesMergeFiles(void) {
+    std::vector<CaptureRecord> live;
+    captureManifestApply(live, makeRecord(AP1, CaptureKind::HANDSHAKE, CAPTURE_FILE_PCAP,
+                                          CAPTURE_OP_SAVED, "PigNet", 100));
+    captureManifestApply(live, makeRecord(AP1, CaptureKind::HANDSHAKE, CAPTURE_FILE_HS22000,
+                                          CAPTURE_OP_SAVED, "", 200));
+    TEST_ASSERT_EQUAL(1, live.size());
+    TEST_ASSERT_EQUAL_HEX8(CAPTURE_FILE_PCAP | CAPTURE_FILE_HS22000, live[0].files);
+    TEST_ASSERT_EQUAL_UINT32(200, live[0].size);
+    TEST_ASSERT_EQUAL_STRING("PigNet", live[0].ssid);  // Empty SSID doesn't clobber
+}
+
+void test_apply_saveKeepsStatus(void) {
+    std::vector<CaptureRecord> live;
+    CaptureRecord set = makeRecord(AP1, CaptureKind::HANDSHAKE, CAPTURE_FILE_PCAP, CAPTURE_OP_SET);
+    set.status = 2;
+    captureManifestApply(live, set);
+    captureManifestApply(live, makeRecord(AP1, CaptureKind::HANDSHAKE, CAPTURE_FILE_PCAP, CAPTURE_OP_SAVED));
+    TEST_ASSERT_EQUAL_UINT8(2, live[0].status);
+}
+
+void test_apply_kindsAreSeparateCaptures(void) {
+    std::vector<CaptureRecord> live;
+    captureManifestApply(live, makeRecord(AP1, CaptureKind::HANDSHAKE, CAPTURE_FILE_PCAP, CAPTURE_OP_SAVED));
+    captureManifestApply(live, makeRecord(AP1, CaptureKind::PMKID, CAPTURE_FILE_PMKID, CAPTURE_OP_SAVED));
+    captureManifestApply(live, makeRecord(AP2, CaptureKind::PMKID, CAPTURE_FILE_PMKID, CAPTURE_OP_SAVED));
+    TEST_ASSERT_EQUAL(3, live.size());
+}
+
+void test_apply_setReplacesAndDeletes(void) {
+    std::vector<CaptureRecord> live;
+    captureManifestApply(live, makeRecord(AP1, CaptureKind::HANDSHAKE,
+                                          CAPTURE_FILE_PCAP | CAPTURE_FILE_HS22000, CAPTURE_OP_SAVED));
+    captureManifestApply(live, makeRecord(AP2, CaptureKind::HANDSHAKE, CAPTURE_FILE_PCAP, CAPTURE_OP_SAVED));
+
+    captureManifestApply(live, makeRecord(AP1, CaptureKind::HANDSHAKE, CAPTURE_FILE_PCAP, CAPTURE_OP_SET));
+    TEST_ASSERT_EQUAL_HEX8(CAPTURE_FILE_PCAP, live[0].files);
+
+    captureManifestApply(live, makeRecord(AP1, CaptureKind::HANDSHAKE, 0, CAPTURE_OP_SET));
+    TEST_ASSERT_EQUAL(1, live.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(AP2, live[0].bssid, 6);
+}
+
+void test_apply_deleteOfUnknownIsNoop(void) {
+    std::vector<CaptureRecord> live;
+    captureManifestApply(live, makeRecord(AP1, CaptureKind::PMKID, 0, CAPTURE_OP_SET));
+    TEST_ASSERT_EQUAL(0, live.size());
+}
+
+void test_apply_liveRecordsAreSetOps(void) {
+    // Compaction writes the live list back verbatim, so it must replay as SET
+    std::vector<CaptureRecord> live;
+    captureManifestApply(live, makeRecord(AP1, CaptureKind::PMKID, CAPTURE_FILE_PMKID, CAPTURE_OP_SAVED));
+    TEST_ASSERT_EQUAL_UINT8(CAPTURE_OP_SET, live[0].op);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_layout_fixedSizes);
+    RUN_TEST(test_parse_pcap);
+    RUN_TEST(test_parse_hs22000);
+    RUN_TEST(test_parse_pmkid_lowercaseHex);
+    RUN_TEST(test_parse_rejectsCompanionsAndJunk);
+    RUN_TEST(test_apply_savesMergeFiles);
+    RUN_TEST(test_apply_saveKeepsStatus);
+    RUN_TEST(test_apply_kindsAreSeparateCaptures);
+    RUN_TEST(test_apply_setReplacesAndDeletes);
+    RUN_TEST(test_apply_deleteOfUnknownIsNoop);
+    RUN_TEST(test_apply_liveRecordsAreSetOps);
+
+    return UNITY_END();
+}
@@ -0,0 +1,151 @@
+// CRC32 Tests
+// Tests the shared slice-by-8 CRC-32 against published vectors and a
+// bit-at-a-time reference
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../../src/core/crc32.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+// What CallPapaMode::calculateCRC32 used to do
+static uint32_t bitwiseCrc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; j++) crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static std::vector<uint8_t> pattern(size_t len) {
+    std::vector<uint8_t> v(len);
+    uint32_t x = 0x12345678;
+    for (size_t i = 0; i < len; i++) {
+        x = x * 1103515245u + 12345u;
+        v[i] = (uint8_t)(x >> 16);
+    }
+    return v;
+}
+
+static uint32_t crcOf(const char* s) {
+    return crc32Update(0, (const uint8_t*)s, strlen(s));
+}
+
+// ============================================================================
+// Known vectors
+// ============================================================================
+
+void test_vectors_strings(void) {
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crcOf("123456789"));
+    TEST_ASSERT_EQUAL_HEX32(0xE8B7BE43, crcOf("a"));
+    TEST_ASSERT_EQUAL_HEX32(0x352441C2, crcOf("abc"));
+    TEST_ASSERT_EQUAL_HEX32(0x20159D7F, crcOf("message digest"));
+    TEST_ASSERT_EQUAL_HEX32(0x414FA339, crcOf("The quick brown fox jumps over the lazy dog"));
+}
+
+void test_vectors_fixedBytes(void) {
+    uint8_t buf[256];
+    memset(buf, 0x00, 32);
+    TEST_ASSERT_EQUAL_HEX32(0x190A55AD, crc32Update(0, buf, 32));
+    memset(buf, 0xFF, 32);
+    TEST_ASSERT_EQUAL_HEX32(0xFF6CAB0B, crc32Update(0, buf, 32));
+    for (int i = 0; i < 256; i++) buf[i] = (uint8_t)i;
+    TEST_ASSERT_EQUAL_HEX32(0x91267E8A, crc32Update(0, buf, 32));
+    TEST_ASSERT_EQUAL_HEX32(0x29058C73, crc32Update(0, buf, 256));
+}
+
+void test_empty_keepsRunningValue(void) {
+    TEST_ASSERT_EQUAL_HEX32(0, crc32Update(0, nullptr, 0));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Update(0xCBF43926, nullptr, 0));
+    TEST_ASSERT_EQUAL_HEX32(0, crc32Slice8(0, nullptr, 0));
+}
+
+void test_tables_firstRowIsClassicTable(void) {
+    const Crc32Tables& t = crc32Tables();
+    TEST_ASSERT_EQUAL_HEX32(0x00000000, t.t[0][0]);
+    TEST_ASSERT_EQUAL_HEX32(0x77073096, t.t[0][1]);
+    TEST_ASSERT_EQUAL_HEX32(0xEDB88320, t.t[0][128]);
+    TEST_ASSERT_EQUAL_HEX32(0x2D02EF8D, t.t[0][255]);
+    TEST_ASSERT_EQUAL_PTR(&t, &crc32Tables());
+}
+
+// ============================================================================
+// Slice-by-8 against the reference
+// ============================================================================
+
+void test_slice8_matchesBitwiseEveryLengthAndAlignment(void) {
+    std::vector<uint8_t> data = pattern(80);
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; len + offset <= data.size(); len++) {
+            TEST_ASSERT_EQUAL_HEX32(bitwiseCrc32(data.data() + offset, len),
+                                    crc32Slice8(0, data.data() + offset, len));
+        }
+    }
+}
+
+void test_slice8_matchesBitwiseLargeBuffer(void) {
+    std::vector<uint8_t> data = pattern(65537);
+    TEST_ASSERT_EQUAL_HEX32(bitwiseCrc32(data.data(), data.size()), crc32Update(0, data.data(), data.size()));
+}
+
+void test_continue_anySplitMatchesWhole(void) {
+    std::vector<uint8_t> data = pattern(100);
+    uint32_t whole = crc32Update(0, data.data(), data.size());
+    for (size_t split = 0; split <= data.size(); split++) {
+        uint32_t crc = crc32Update(0, data.data(), split);
+        crc = crc32Update(crc, data.data() + split, data.size() - split);
+        TEST_ASSERT_EQUAL_HEX32(whole, crc);
+    }
+}
+
+void test_continue_manySmallPieces(void) {
+    // Like CALL PAPA: 17- and 242-byte chunks folded in one at a time
+    std::vector<uint8_t> data = pattern(2048);
+    uint32_t whole = bitwiseCrc32(data.data(), data.size());
+    const size_t PIECES[] = {17, 242, 1, 7, 9};
+    for (size_t p : PIECES) {
+        uint32_t crc = 0;
+        for (size_t at = 0; at < data.size(); at += p) {
+            size_t n = data.size() - at < p ? data.size() - at : p;
+            crc = crc32Update(crc, data.data() + at, n);
+        }
+        TEST_ASSERT_EQUAL_HEX32(whole, crc);
+    }
+}
+
+void test_singleBitFlip_changesCrc(void) {
+    std::vector<uint8_t> data = pattern(512);
+    uint32_t before = crc32Update(0, data.data(), data.size());
+    for (size_t bit = 0; bit < data.size() * 8; bit += 61) {
+        data[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+        TEST_ASSERT_NOT_EQUAL(before, crc32Update(0, data.data(), data.size()));
+        data[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Known vectors
+    RUN_TEST(test_vectors_strings);
+    RUN_TEST(test_vectors_fixedBytes);
+    RUN_TEST(test_empty_keepsRunningValue);
+    RUN_TEST(test_tables_firstRowIsClassicTable);
+
+    // Slice-by-8 against the reference
+    RUN_TEST(test_slice8_matchesBitwiseEveryLengthAndAlignment);
+    RUN_TEST(test_slice8_matchesBitwiseLargeBuffer);
+    RUN_TEST(test_continue_anySplitMatchesWhole);
+    RUN_TEST(test_continue_manySmallPieces);
+    RUN_TEST(test_singleBitFlip_changesCrc);
+
+    return UNITY_END();
+}
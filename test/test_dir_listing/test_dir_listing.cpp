@@ -0,0 +1,229 @@
+// Directory Listing Tests
+// Tests JSON rows and bounded sorted pages behind the file server's /api/ls
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include "../../src/web/dir_listing.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static DirListEntry makeEntry(const char* name, uint32_t size, uint32_t mtime, uint16_t ord, bool isDir = false) {
+    DirListEntry e;
+    memset(&e, 0, sizeof(e));
+    strncpy(e.name, name, sizeof(e.name) - 1);
+    e.size = size;
+    e.mtime = mtime;
+    e.ord = ord;
+    e.isDir = isDir;
+    return e;
+}
+
+// A directory with awkward names, duplicate keys and a few folders
+static std::vector<DirListEntry> makeDir(size_t n) {
+    std::vector<DirListEntry> dir;
+    for (size_t i = 0; i < n; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "%s_%03u.pcap", (i % 3) ? "Cap" : "cap", (unsigned)((i * 37) % n));
+        dir.push_back(makeEntry(name, (uint32_t)((i * 7919) % 50), (uint32_t)(1000 + (i * 13) % 97),
+                                (uint16_t)i, i % 17 == 0));
+    }
+    return dir;
+}
+
+// Walk pages the way the file server does: one pass per page-sized step
+static std::vector<uint16_t> pagedWalk(const std::vector<DirListEntry>& dir, size_t offset, size_t limit,
+                                       DirSort sort, bool desc, size_t& passes) {
+    std::vector<DirListEntry> slots(limit);
+    std::vector<uint8_t> order(limit);
+    std::vector<uint16_t> out;
+    DirPage page;
+    DirListEntry last;
+    const DirListEntry* after = nullptr;
+    size_t skip = offset;
+    passes = 0;
+    for (;;) {
+        TEST_ASSERT_TRUE(page.begin(slots.data(), order.data(), limit, sort, desc, after));
+        for (const DirListEntry& e : dir) page.offer(e);
+        passes++;
+        size_t i = std::min(skip, page.count());
+        skip -= i;
+        for (; i < page.count() && out.size() < limit; i++) out.push_back(page.at(i).ord);
+        if (!page.full() || out.size() == limit) break;
+        last = page.last();
+        after = &last;
+    }
+    return out;
+}
+
+static std::vector<uint16_t> reference(std::vector<DirListEntry> dir, size_t offset, size_t limit,
+                                       DirSort sort, bool desc) {
+    std::sort(dir.begin(), dir.end(), [&](const DirListEntry& a, const DirListEntry& b) {
+        return dirEntryBefore(a, b, sort, desc);
+    });
+    std::vector<uint16_t> out;
+    for (size_t i = offset; i < dir.size() && out.size() < limit; i++) out.push_back(dir[i].ord);
+    return out;
+}
+
+// ============================================================================
+// JSON rows
+// ============================================================================
+
+void test_jsonEscape_quotesBackslashAndControl(void) {
+    char out[64];
+    size_t n = jsonEscape(out, sizeof(out), "a\"b\\c\x01\n");
+    out[n] = '\0';
+    TEST_ASSERT_EQUAL_STRING("a\\\"b\\\\c\\u0001\\u000a", out);
+}
+
+void test_jsonEscape_passesUtf8Through(void) {
+    char out[16];
+    size_t n = jsonEscape(out, sizeof(out), "caf\xC3\xA9");
+    TEST_ASSERT_EQUAL(5, n);
+    TEST_ASSERT_EQUAL_MEMORY("caf\xC3\xA9", out, 5);
+}
+
+void test_jsonEscape_tooSmallReturnsZero(void) {
+    char out[4];
+    TEST_ASSERT_EQUAL(0, jsonEscape(out, sizeof(out), "abcde"));
+    TEST_ASSERT_EQUAL(0, jsonEscape(out, sizeof(out), "ab\x01"));
+}
+
+void test_dirEntryJson_shortForm(void) {
+    char out[128];
+    DirListEntry e = makeEntry("x\"y.pcap", 1234, 99, 0);
+    size_t n = dirEntryJson(out, sizeof(out), e, false);
+    out[n] = '\0';
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"x\\\"y.pcap\",\"size\":1234}", out);
+}
+
+void test_dirEntryJson_fullForm(void) {
+    char out[128];
+    DirListEntry e = makeEntry("loot", 0, 1700000000, 0, true);
+    size_t n = dirEntryJson(out, sizeof(out), e, true);
+    out[n] = '\0';
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"loot\",\"size\":0,\"isDir\":true,\"mtime\":1700000000}", out);
+}
+
+void test_dirEntryJson_worstCaseNameFits(void) {
+    // Every byte a control char: the file server sizes its chunk for this
+    DirListEntry e = makeEntry("", 0xFFFFFFFFu, 0xFFFFFFFFu, 0, false);
+    memset(e.name, 0x1F, DIR_NAME_MAX - 1);
+    e.name[DIR_NAME_MAX - 1] = '\0';
+    static char out[DIR_NAME_MAX * 6 + 96];
+    TEST_ASSERT_TRUE(dirEntryJson(out, sizeof(out), e, true) > 0);
+    TEST_ASSERT_EQUAL(0, dirEntryJson(out, DIR_NAME_MAX * 6, e, true));
+}
+
+// ============================================================================
+// Sort order
+// ============================================================================
+
+void test_dirSortFromString(void) {
+    TEST_ASSERT_EQUAL(DirSort::NAME, dirSortFromString("name"));
+    TEST_ASSERT_EQUAL(DirSort::SIZE, dirSortFromString("size"));
+    TEST_ASSERT_EQUAL(DirSort::TIME, dirSortFromString("time"));
+    TEST_ASSERT_EQUAL(DirSort::NONE, dirSortFromString(""));
+    TEST_ASSERT_EQUAL(DirSort::NONE, dirSortFromString("Name"));
+    TEST_ASSERT_EQUAL(DirSort::NONE, dirSortFromString(nullptr));
+}
+
+void test_dirEntryBefore_directoriesFirstEvenDescending(void) {
+    DirListEntry d = makeEntry("zzz", 0, 0, 5, true);
+    DirListEntry f = makeEntry("aaa", 900, 0, 1);
+    TEST_ASSERT_TRUE(dirEntryBefore(d, f, DirSort::NAME, false));
+    TEST_ASSERT_TRUE(dirEntryBefore(d, f, DirSort::SIZE, true));
+}
+
+void test_dirEntryBefore_nameIgnoresCaseThenBreaksTies(void) {
+    DirListEntry a = makeEntry("apple", 0, 0, 9);
+    DirListEntry b = makeEntry("Banana", 0, 0, 1);
+    TEST_ASSERT_TRUE(dirEntryBefore(a, b, DirSort::NAME, false));
+    DirListEntry upper = makeEntry("Cap", 0, 0, 3);
+    DirListEntry lower = makeEntry("cap", 0, 0, 2);
+    TEST_ASSERT_TRUE(dirEntryBefore(upper, lower, DirSort::NAME, false));
+    TEST_ASSERT_FALSE(dirEntryBefore(lower, upper, DirSort::NAME, false));
+    TEST_ASSERT_FALSE(dirEntryBefore(a, a, DirSort::NAME, false));
+}
+
+// ============================================================================
+// Bounded pages
+// ============================================================================
+
+void test_dirPage_rejectsBadStorage(void) {
+    DirListEntry slots[4];
+    uint8_t order[4];
+    DirPage page;
+    TEST_ASSERT_FALSE(page.begin(nullptr, order, 4, DirSort::NAME, false, nullptr));
+    TEST_ASSERT_FALSE(page.begin(slots, order, 0, DirSort::NAME, false, nullptr));
+    TEST_ASSERT_FALSE(page.begin(slots, order, 256, DirSort::NAME, false, nullptr));
+    TEST_ASSERT_TRUE(page.begin(slots, order, 4, DirSort::NAME, false, nullptr));
+}
+
+void test_dirPage_keepsSmallestInOrder(void) {
+    DirListEntry slots[3];
+    uint8_t order[3];
+    DirPage page;
+    page.begin(slots, order, 3, DirSort::SIZE, false, nullptr);
+    const uint32_t sizes[] = {50, 10, 40, 30, 20, 60};
+    for (uint16_t i = 0; i < 6; i++) page.offer(makeEntry("f", sizes[i], 0, i));
+    TEST_ASSERT_EQUAL(3, page.count());
+    TEST_ASSERT_EQUAL_UINT32(10, page.at(0).size);
+    TEST_ASSERT_EQUAL_UINT32(20, page.at(1).size);
+    TEST_ASSERT_EQUAL_UINT32(30, page.at(2).size);
+}
+
+void test_dirPage_everyPageMatchesFullSort(void) {
+    std::vector<DirListEntry> dir = makeDir(230);
+    const DirSort sorts[] = {DirSort::NAME, DirSort::SIZE, DirSort::TIME};
+    for (DirSort sort : sorts) {
+        for (int desc = 0; desc < 2; desc++) {
+            for (size_t offset = 0; offset < 240; offset += 23) {
+                size_t passes;
+                std::vector<uint16_t> got = pagedWalk(dir, offset, 50, sort, desc, passes);
+                std::vector<uint16_t> want = reference(dir, offset, 50, sort, desc);
+                TEST_ASSERT_EQUAL(want.size(), got.size());
+                for (size_t i = 0; i < want.size(); i++) TEST_ASSERT_EQUAL_UINT16(want[i], got[i]);
+                TEST_ASSERT_TRUE(passes <= offset / 50 + 2);
+            }
+        }
+    }
+}
+
+void test_dirPage_duplicateKeysNotLostBetweenPages(void) {
+    // Same size and name on every file: only directory order separates them
+    std::vector<DirListEntry> dir;
+    for (uint16_t i = 0; i < 40; i++) dir.push_back(makeEntry("same.pcap", 7, 7, i));
+    size_t passes;
+    std::vector<uint16_t> got = pagedWalk(dir, 10, 25, DirSort::SIZE, false, passes);
+    TEST_ASSERT_EQUAL(25, got.size());
+    for (size_t i = 0; i < got.size(); i++) TEST_ASSERT_EQUAL_UINT16(10 + i, got[i]);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_jsonEscape_quotesBackslashAndControl);
+    RUN_TEST(test_jsonEscape_passesUtf8Through);
+    RUN_TEST(test_jsonEscape_tooSmallReturnsZero);
+    RUN_TEST(test_dirEntryJson_shortForm);
+    RUN_TEST(test_dirEntryJson_fullForm);
+    RUN_TEST(test_dirEntryJson_worstCaseNameFits);
+    RUN_TEST(test_dirSortFromString);
+    RUN_TEST(test_dirEntryBefore_directoriesFirstEvenDescending);
+    RUN_TEST(test_dirEntryBefore_nameIgnoresCaseThenBreaksTies);
+    RUN_TEST(test_dirPage_rejectsBadStorage);
+    RUN_TEST(test_dirPage_keepsSmallestInOrder);
+    RUN_TEST(test_dirPage_everyPageMatchesFullSort);
+    RUN_TEST(test_dirPage_duplicateKeysNotLostBetweenPages);
+
+    return UNITY_END();
+}
@@ -0,0 +1,176 @@
+// Frame Ring Tests
+// Tests the SPSC frame queue used between promiscuous callback and update()
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/core/frame_ring.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static uint8_t frame[600];
+
+static void fillFrame(uint8_t seed, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) frame[i] = (uint8_t)(seed + i);
+}
+
+// ============================================================================
+// Basic push/pop
+// ============================================================================
+
+void test_ring_startsEmpty(void) {
+    FrameRing<1024> ring;
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_NULL(ring.peek());
+}
+
+void test_ring_pushPop_preservesRecord(void) {
+    FrameRing<1024> ring;
+    fillFrame(7, 100);
+    TEST_ASSERT_TRUE(ring.push(0, -42, -95, 11, 12345, frame, 100, 250, false));
+    
+    const FrameRecord* rec = ring.peek();
+    TEST_ASSERT_NOT_NULL(rec);
+    TEST_ASSERT_EQUAL(100, rec->len);
+    TEST_ASSERT_EQUAL(250, rec->origLen);
+    TEST_ASSERT_EQUAL(-42, rec->rssi);
+    TEST_ASSERT_EQUAL(-95, rec->noise);
+    TEST_ASSERT_EQUAL(11, rec->channel);
+    TEST_ASSERT_EQUAL_UINT32(12345, rec->timestamp);
+    TEST_ASSERT_EQUAL_MEMORY(frame, rec->payload(), 100);
+    
+    ring.pop();
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+void test_ring_fifoOrder(void) {
+    FrameRing<1024> ring;
+    for (uint8_t i = 0; i < 5; i++) {
+        fillFrame(i, 20);
+        TEST_ASSERT_TRUE(ring.push(2, 0, -95, i, i, frame, 20, 20, false));
+    }
+    for (uint8_t i = 0; i < 5; i++) {
+        const FrameRecord* rec = ring.peek();
+        TEST_ASSERT_NOT_NULL(rec);
+        TEST_ASSERT_EQUAL(i, rec->channel);
+        TEST_ASSERT_EQUAL(i, rec->payload()[0]);
+        ring.pop();
+    }
+    TEST_ASSERT_NULL(ring.peek());
+}
+
+// ============================================================================
+// Wrap-around
+// ============================================================================
+
+void test_ring_wrapsAroundArena(void) {
+    FrameRing<1024> ring;
+    // 16 header + 200 payload = 216 bytes per record; cycle far past capacity
+    for (int i = 0; i < 50; i++) {
+        fillFrame((uint8_t)i, 200);
+        TEST_ASSERT_TRUE(ring.push(0, 0, -95, 1, i, frame, 200, 200, false));
+        fillFrame((uint8_t)(i + 100), 200);
+        TEST_ASSERT_TRUE(ring.push(0, 0, -95, 1, i + 1000, frame, 200, 200, false));
+        
+        const FrameRecord* rec = ring.peek();
+        TEST_ASSERT_NOT_NULL(rec);
+        TEST_ASSERT_EQUAL_UINT32(i, rec->timestamp);
+        TEST_ASSERT_EQUAL((uint8_t)i, rec->payload()[0]);
+        ring.pop();
+        
+        rec = ring.peek();
+        TEST_ASSERT_NOT_NULL(rec);
+        TEST_ASSERT_EQUAL_UINT32(i + 1000, rec->timestamp);
+        TEST_ASSERT_EQUAL((uint8_t)(i + 100), rec->payload()[0]);
+        ring.pop();
+    }
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.getDropped());
+    TEST_ASSERT_EQUAL_UINT32(100, ring.getPushed());
+}
+
+void test_ring_oddLengthsStayAligned(void) {
+    FrameRing<512> ring;
+    for (int i = 0; i < 200; i++) {
+        uint16_t len = (uint16_t)(1 + (i * 37) % 90);
+        fillFrame((uint8_t)i, len);
+        TEST_ASSERT_TRUE(ring.push(0, 0, -95, 0, i, frame, len, len, false));
+        const FrameRecord* rec = ring.peek();
+        TEST_ASSERT_NOT_NULL(rec);
+        TEST_ASSERT_EQUAL(0, ((uintptr_t)rec) & 3);
+        TEST_ASSERT_EQUAL(len, rec->len);
+        TEST_ASSERT_EQUAL_MEMORY(frame, rec->payload(), len);
+        ring.pop();
+    }
+}
+
+// ============================================================================
+// Overflow and priority reserve
+// ============================================================================
+
+void test_ring_dropsWhenFull(void) {
+    FrameRing<1024> ring;
+    fillFrame(0, 100);
+    int accepted = 0;
+    for (int i = 0; i < 20; i++) {
+        if (ring.push(0, 0, -95, 0, i, frame, 100, 100, false)) accepted++;
+    }
+    TEST_ASSERT_TRUE(accepted > 0);
+    TEST_ASSERT_TRUE(accepted < 20);
+    TEST_ASSERT_EQUAL_UINT32(20 - accepted, ring.getDropped());
+    TEST_ASSERT_TRUE(ring.getHighWater() < 1024);
+}
+
+void test_ring_priorityUsesReserve(void) {
+    FrameRing<1024> ring;
+    fillFrame(0, 100);
+    // Fill until normal frames are refused
+    while (ring.push(0, 0, -95, 0, 0, frame, 100, 100, false)) {}
+    // Priority (EAPOL) frame still fits in the reserved quarter
+    TEST_ASSERT_TRUE(ring.push(2, 0, -95, 0, 0, frame, 100, 100, true));
+}
+
+void test_ring_neverLooksEmptyWhenFull(void) {
+    FrameRing<256> ring;
+    fillFrame(0, 48);
+    int accepted = 0;
+    while (ring.push(0, 0, -95, 0, 0, frame, 48, 48, true)) accepted++;
+    TEST_ASSERT_TRUE(accepted > 0);
+    TEST_ASSERT_FALSE(ring.empty());
+    int popped = 0;
+    while (ring.peek()) { ring.pop(); popped++; }
+    TEST_ASSERT_EQUAL(accepted, popped);
+}
+
+void test_ring_resetClearsStats(void) {
+    FrameRing<256> ring;
+    fillFrame(0, 200);
+    ring.push(0, 0, -95, 0, 0, frame, 200, 200, false);
+    ring.push(0, 0, -95, 0, 0, frame, 200, 200, false);
+    TEST_ASSERT_TRUE(ring.getDropped() > 0);
+    ring.reset();
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.getDropped());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.getHighWater());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_ring_startsEmpty);
+    RUN_TEST(test_ring_pushPop_preservesRecord);
+    RUN_TEST(test_ring_fifoOrder);
+    RUN_TEST(test_ring_wrapsAroundArena);
+    RUN_TEST(test_ring_oddLengthsStayAligned);
+    RUN_TEST(test_ring_dropsWhenFull);
+    RUN_TEST(test_ring_priorityUsesReserve);
+    RUN_TEST(test_ring_neverLooksEmptyWhenFull);
+    RUN_TEST(test_ring_resetClearsStats);
+    
+    return UNITY_END();
+}
@@ -0,0 +1,357 @@
+// GZIP Stream Tests
+// Tests the bounded-memory gzip encoder behind compressed WiGLE uploads
+
+#include <unity.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../../src/web/gzip_stream.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+// ============================================================================
+// Reference inflater (RFC 1951), small and slow - enough to check output
+// ============================================================================
+
+struct BitReader {
+    const uint8_t* data;
+    size_t len;
+    size_t pos;
+    uint32_t bitBuf;
+    int bitCount;
+    bool bad;
+
+    int bits(int n) {
+        while (bitCount < n) {
+            if (pos >= len) {
+                bad = true;
+                return 0;
+            }
+            bitBuf |= (uint32_t)data[pos++] << bitCount;
+            bitCount += 8;
+        }
+        int v = bitBuf & ((1u << n) - 1);
+        bitBuf >>= n;
+        bitCount -= n;
+        return v;
+    }
+};
+
+struct Huffman {
+    uint16_t count[16];
+    uint16_t symbol[320];
+};
+
+// False if the lengths over-subscribe the code
+static bool buildHuffman(Huffman& h, const uint8_t* lens, int n) {
+    memset(h.count, 0, sizeof(h.count));
+    for (int i = 0; i < n; i++) h.count[lens[i]]++;
+    int left = 1;
+    for (int l = 1; l < 16; l++) {
+        left = (left << 1) - h.count[l];
+        if (left < 0) return false;
+    }
+    uint16_t offs[16];
+    offs[1] = 0;
+    for (int l = 1; l < 15; l++) offs[l + 1] = offs[l] + h.count[l];
+    for (int i = 0; i < n; i++) {
+        if (lens[i]) h.symbol[offs[lens[i]]++] = i;
+    }
+    return true;
+}
+
+static int decodeSymbol(BitReader& br, const Huffman& h) {
+    int code = 0, first = 0, index = 0;
+    for (int l = 1; l < 16; l++) {
+        code |= br.bits(1);
+        int count = h.count[l];
+        if (code - count < first) return h.symbol[index + (code - first)];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+        if (br.bad) return -1;
+    }
+    return -1;
+}
+
+static bool inflateRaw(BitReader& br, std::vector<uint8_t>& out, int& fixedBlocks, int& dynamicBlocks) {
+    static const uint16_t LBASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                       35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t LEXT[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                     3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t DBASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                       257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                       8193, 12289, 16385, 24577};
+    static const uint8_t DEXT[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                     7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    static const uint8_t ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+    int last;
+    do {
+        last = br.bits(1);
+        int type = br.bits(2);
+        Huffman lit, dist;
+        uint8_t lens[320];
+        if (type == 1) {
+            fixedBlocks++;
+            for (int i = 0; i < 288; i++) lens[i] = i < 144 ? 8 : (i < 256 ? 9 : (i < 280 ? 7 : 8));
+            buildHuffman(lit, lens, 288);
+            memset(lens, 5, 30);
+            buildHuffman(dist, lens, 30);
+        } else if (type == 2) {
+            dynamicBlocks++;
+            int hlit = br.bits(5) + 257, hdist = br.bits(5) + 1, hclen = br.bits(4) + 4;
+            uint8_t cl[19] = {0};
+            for (int i = 0; i < hclen; i++) cl[ORDER[i]] = br.bits(3);
+            Huffman clh;
+            if (!buildHuffman(clh, cl, 19)) return false;
+            int n = 0;
+            while (n < hlit + hdist) {
+                int s = decodeSymbol(br, clh);
+                if (s < 0) return false;
+                if (s < 16) {
+                    lens[n++] = s;
+                    continue;
+                }
+                int rep, val = 0;
+                if (s == 16) {
+                    if (n == 0) return false;
+                    val = lens[n - 1];
+                    rep = 3 + br.bits(2);
+                } else if (s == 17) {
+                    rep = 3 + br.bits(3);
+                } else {
+                    rep = 11 + br.bits(7);
+                }
+                if (n + rep > hlit + hdist) return false;
+                while (rep--) lens[n++] = val;
+            }
+            if (!buildHuffman(lit, lens, hlit) || !buildHuffman(dist, lens + hlit, hdist)) return false;
+        } else {
+            return false;  // The encoder never writes stored blocks
+        }
+
+        for (;;) {
+            int s = decodeSymbol(br, lit);
+            if (s < 0 || br.bad) return false;
+            if (s < 256) {
+                out.push_back((uint8_t)s);
+            } else if (s == 256) {
+                break;
+            } else {
+                s -= 257;
+                if (s >= 29) return false;
+                int len = LBASE[s] + br.bits(LEXT[s]);
+                int ds = decodeSymbol(br, dist);
+                if (ds < 0 || ds >= 30) return false;
+                size_t d = DBASE[ds] + br.bits(DEXT[ds]);
+                if (d > out.size()) return false;
+                while (len--) out.push_back(out[out.size() - d]);
+            }
+        }
+    } while (!last);
+    return !br.bad;
+}
+
+struct Gunzipped {
+    bool ok;
+    std::vector<uint8_t> data;
+    int fixedBlocks;
+    int dynamicBlocks;
+};
+
+static Gunzipped gunzip(const std::vector<uint8_t>& gz) {
+    Gunzipped r = {false, {}, 0, 0};
+    if (gz.size() < 18 || gz[0] != 0x1F || gz[1] != 0x8B || gz[2] != 8 || gz[3] != 0) return r;
+    BitReader br = {gz.data(), gz.size() - 8, 10, 0, 0, false};
+    if (!inflateRaw(br, r.data, r.fixedBlocks, r.dynamicBlocks)) return r;
+    if (br.pos != gz.size() - 8) return r;  // Trailer must follow the last block
+    const uint8_t* t = gz.data() + gz.size() - 8;
+    uint32_t crc = t[0] | (t[1] << 8) | (t[2] << 16) | ((uint32_t)t[3] << 24);
+    uint32_t isize = t[4] | (t[5] << 8) | (t[6] << 16) | ((uint32_t)t[7] << 24);
+    r.ok = crc == crc32Update(0, r.data.data(), r.data.size()) && isize == r.data.size();
+    return r;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static bool appendSink(const uint8_t* data, size_t len, void* ctx) {
+    std::vector<uint8_t>* v = (std::vector<uint8_t>*)ctx;
+    v->insert(v->end(), data, data + len);
+    return true;
+}
+
+static std::vector<uint8_t> compressIn(const std::string& input, size_t piece) {
+    std::vector<uint8_t> gz;
+    GzipStream* g = new GzipStream();
+    g->begin(appendSink, &gz);
+    for (size_t at = 0; at < input.size(); at += piece) {
+        size_t n = input.size() - at < piece ? input.size() - at : piece;
+        TEST_ASSERT_TRUE(g->write((const uint8_t*)input.data() + at, n));
+    }
+    TEST_ASSERT_TRUE(g->finish());
+    TEST_ASSERT_EQUAL_UINT32(input.size(), g->bytesIn());
+    TEST_ASSERT_EQUAL_UINT32(gz.size(), g->bytesOut());
+    delete g;
+    return gz;
+}
+
+static void assertRoundTrip(const std::string& input, size_t piece) {
+    Gunzipped r = gunzip(compressIn(input, piece));
+    TEST_ASSERT_TRUE(r.ok);
+    TEST_ASSERT_EQUAL(input.size(), r.data.size());
+    TEST_ASSERT_TRUE(memcmp(input.data(), r.data.data(), input.size()) == 0);
+}
+
+static std::string csvLike(size_t bytes) {
+    std::string s;
+    uint32_t x = 12345;
+    char row[128];
+    while (s.size() < bytes) {
+        x = x * 1103515245u + 12345u;
+        snprintf(row, sizeof(row), "AA:BB:CC:%02X:%02X:%02X,\"net%u\",[WPA2-PSK-CCMP][ESS],%d,51.5%04u\r\n",
+                 (x >> 8) & 0xFF, (x >> 16) & 0x0F, (x >> 20) & 0x3F, (x >> 24) & 7, -40 - (int)((x >> 4) & 31),
+                 (x >> 12) % 10000);
+        s += row;
+    }
+    return s;
+}
+
+static std::string noise(size_t bytes) {
+    std::string s(bytes, '\0');
+    uint32_t x = 99;
+    for (size_t i = 0; i < bytes; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        s[i] = (char)x;
+    }
+    return s;
+}
+
+// ============================================================================
+// Round trips
+// ============================================================================
+
+void test_empty_input(void) {
+    std::vector<uint8_t> gz = compressIn("", 1);
+    Gunzipped r = gunzip(gz);
+    TEST_ASSERT_TRUE(r.ok);
+    TEST_ASSERT_EQUAL(0, r.data.size());
+    TEST_ASSERT_TRUE(gz.size() <= 20);
+}
+
+void test_single_byte(void) {
+    assertRoundTrip("x", 1);
+}
+
+void test_text_roundTrips(void) {
+    assertRoundTrip(csvLike(50000), 4096);
+}
+
+void test_writeSizes_dontChangeOutput(void) {
+    std::string input = csvLike(30000);
+    std::vector<uint8_t> a = compressIn(input, 1);
+    std::vector<uint8_t> b = compressIn(input, 777);
+    std::vector<uint8_t> c = compressIn(input, input.size());
+    TEST_ASSERT_TRUE(a == b);
+    TEST_ASSERT_TRUE(b == c);
+}
+
+void test_longRuns_useMaxLengthMatches(void) {
+    std::string input(100000, 'A');
+    input += "tail";
+    std::vector<uint8_t> gz = compressIn(input, 4096);
+    TEST_ASSERT_TRUE(gz.size() < 1000);
+    Gunzipped r = gunzip(gz);
+    TEST_ASSERT_TRUE(r.ok);
+    TEST_ASSERT_EQUAL(input.size(), r.data.size());
+}
+
+void test_matchesAcrossWindowSlides(void) {
+    // Repeats at distances just under and over the window
+    std::string block = noise(3000);
+    std::string input;
+    for (int i = 0; i < 20; i++) {
+        input += block;
+        input += noise(GzipStream::WINDOW - 3100 + i * 20);
+    }
+    assertRoundTrip(input, 1000);
+}
+
+void test_incompressible_staysCloseToInputSize(void) {
+    std::string input = noise(40000);
+    std::vector<uint8_t> gz = compressIn(input, 4096);
+    // No stored blocks: Huffman-coded literals cost a little over 8 bits
+    TEST_ASSERT_TRUE(gz.size() < input.size() + input.size() / 16 + 64);
+    Gunzipped r = gunzip(gz);
+    TEST_ASSERT_TRUE(r.ok);
+}
+
+void test_allByteValues(void) {
+    std::string input;
+    for (int rep = 0; rep < 40; rep++) {
+        for (int b = 0; b < 256; b++) input += (char)((b * (rep + 1)) & 0xFF);
+    }
+    assertRoundTrip(input, 333);
+}
+
+// ============================================================================
+// Format and ratio
+// ============================================================================
+
+void test_header_isPlainGzip(void) {
+    std::vector<uint8_t> gz = compressIn("hello", 5);
+    TEST_ASSERT_EQUAL_HEX8(0x1F, gz[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x8B, gz[1]);
+    TEST_ASSERT_EQUAL_HEX8(8, gz[2]);   // Deflate
+    TEST_ASSERT_EQUAL_HEX8(0, gz[3]);   // No name/comment/extra
+}
+
+void test_csv_usesDynamicBlocksAndCompresses(void) {
+    std::string input = csvLike(200000);
+    std::vector<uint8_t> gz = compressIn(input, 4096);
+    Gunzipped r = gunzip(gz);
+    TEST_ASSERT_TRUE(r.ok);
+    TEST_ASSERT_TRUE(r.dynamicBlocks > 0);
+    TEST_ASSERT_TRUE(input.size() / gz.size() >= 3);
+}
+
+void test_sinkFailure_stopsStream(void) {
+    struct Local {
+        static bool refuse(const uint8_t*, size_t, void*) { return false; }
+    };
+    GzipStream* g = new GzipStream();
+    g->begin(Local::refuse, nullptr);
+    std::string input = noise(20000);
+    bool ok = g->write((const uint8_t*)input.data(), input.size());
+    ok = g->finish() && ok;
+    TEST_ASSERT_FALSE(ok);
+    delete g;
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty_input);
+    RUN_TEST(test_single_byte);
+    RUN_TEST(test_text_roundTrips);
+    RUN_TEST(test_writeSizes_dontChangeOutput);
+    RUN_TEST(test_longRuns_useMaxLengthMatches);
+    RUN_TEST(test_matchesAcrossWindowSlides);
+    RUN_TEST(test_incompressible_staysCloseToInputSize);
+    RUN_TEST(test_allByteValues);
+    RUN_TEST(test_header_isPlainGzip);
+    RUN_TEST(test_csv_usesDynamicBlocksAndCompresses);
+    RUN_TEST(test_sinkFailure_stopsStream);
+
+    return UNITY_END();
+}
@@ -0,0 +1,163 @@
+// HTTP Range Tests
+// Tests Range/If-Range/ETag handling behind resumable file server downloads
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/web/http_range.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static RangeResult range(const char* header, uint32_t size, uint32_t& start, uint32_t& end) {
+    start = 0xDEAD;
+    end = 0xBEEF;
+    return parseRange(header, size, start, end);
+}
+
+// ============================================================================
+// Range parsing
+// ============================================================================
+
+void test_range_closed(void) {
+    uint32_t s, e;
+    TEST_ASSERT_EQUAL(RangeResult::PARTIAL, range("bytes=0-99", 1000, s, e));
+    TEST_ASSERT_EQUAL_UINT32(0, s);
+    TEST_ASSERT_EQUAL_UINT32(99, e);
+}
+
+void test_range_openEnded(void) {
+    uint32_t s, e;
+    TEST_ASSERT_EQUAL(RangeResult::PARTIAL, range("bytes=500-", 1000, s, e));
+    TEST_ASSERT_EQUAL_UINT32(500, s);
+    TEST_ASSERT_EQUAL_UINT32(999, e);
+}
+
+void test_range_suffix(void) {
+    uint32_t s, e;
+    TEST_ASSERT_EQUAL(RangeResult::PARTIAL, range("bytes=-200", 1000, s, e));
+    TEST_ASSERT_EQUAL_UINT32(800, s);
+    TEST_ASSERT_EQUAL_UINT32(999, e);
+    // Longer than the file: the whole file
+    TEST_ASSERT_EQUAL(RangeResult::PARTIAL, range("bytes=-5000", 1000, s, e));
+    TEST_ASSERT_EQUAL_UINT32(0, s);
+    TEST_ASSERT_EQUAL_UINT32(999, e);
+}
+
+void test_range_endClampedToSize(void) {
+    uint32_t s, e;
+    TEST_ASSERT_EQUAL(RangeResult::PARTIAL, range("bytes=900-99999999999999", 1000, s, e));
+    TEST_ASSERT_EQUAL_UINT32(900, s);
+    TEST_ASSERT_EQUAL_UINT32(999, e);
+}
+
+void test_range_toleratesSpacesAndCase(void) {
+    uint32_t s, e;
+    TEST_ASSERT_EQUAL(RangeResult::PARTIAL, range(" Bytes = 10-20 ", 1000, s, e));
+    TEST_ASSERT_EQUAL_UINT32(10, s);
+    TEST_ASSERT_EQUAL_UINT32(20, e);
+}
+
+void test_range_unsatisfiable(void) {
+    uint32_t s, e;
+    TEST_ASSERT_EQUAL(RangeResult::UNSATISFIABLE, range("bytes=1000-", 1000, s, e));
+    TEST_ASSERT_EQUAL(RangeResult::UNSATISFIABLE, range("bytes=-0", 1000, s, e));
+    TEST_ASSERT_EQUAL(RangeResult::UNSATISFIABLE, range("bytes=0-", 0, s, e));
+    TEST_ASSERT_EQUAL(RangeResult::UNSATISFIABLE, range("bytes=-10", 0, s, e));
+}
+
+void test_range_ignoredWhenMalformedOrMulti(void) {
+    uint32_t s, e;
+    TEST_ASSERT_EQUAL(RangeResult::NONE, range(nullptr, 1000, s, e));
+    TEST_ASSERT_EQUAL(RangeResult::NONE, range("", 1000, s, e));
+    TEST_ASSERT_EQUAL(RangeResult::NONE, range("items=0-10", 1000, s, e));
+    TEST_ASSERT_EQUAL(RangeResult::NONE, range("bytes=0-10,20-30", 1000, s, e));
+    TEST_ASSERT_EQUAL(RangeResult::NONE, range("bytes=50-10", 1000, s, e));
+    TEST_ASSERT_EQUAL(RangeResult::NONE, range("bytes=-", 1000, s, e));
+    TEST_ASSERT_EQUAL(RangeResult::NONE, range("bytes=1x-2", 1000, s, e));
+    TEST_ASSERT_EQUAL(RangeResult::NONE, range("bytes=5-6 junk", 1000, s, e));
+    TEST_ASSERT_EQUAL_UINT32(0xDEAD, s);  // Untouched unless PARTIAL
+}
+
+// ============================================================================
+// Validators
+// ============================================================================
+
+void test_etag_format(void) {
+    char tag[24];
+    TEST_ASSERT_EQUAL(19, makeEtag(tag, sizeof(tag), 0x1234, 0x65a0b1c2));
+    TEST_ASSERT_EQUAL_STRING("\"00001234-65a0b1c2\"", tag);
+    TEST_ASSERT_EQUAL(19, makeEtag(tag, 20, 0xFFFFFFFF, 0xFFFFFFFF));
+    TEST_ASSERT_EQUAL(0, makeEtag(tag, 8, 0xFFFFFFFF, 0xFFFFFFFF));
+}
+
+void test_etagList_matches(void) {
+    const char* tag = "\"10-20\"";
+    TEST_ASSERT_TRUE(etagListMatches("\"10-20\"", tag));
+    TEST_ASSERT_TRUE(etagListMatches("\"aa-bb\", W/\"10-20\"", tag));
+    TEST_ASSERT_TRUE(etagListMatches("*", tag));
+    TEST_ASSERT_FALSE(etagListMatches("\"10-2\"", tag));
+    TEST_ASSERT_FALSE(etagListMatches("\"10-200\"", tag));
+    TEST_ASSERT_FALSE(etagListMatches("", tag));
+    TEST_ASSERT_FALSE(etagListMatches(nullptr, tag));
+}
+
+void test_ifRange_strongTagOnly(void) {
+    const char* tag = "\"10-20\"";
+    TEST_ASSERT_TRUE(ifRangeAllows(nullptr, tag));
+    TEST_ASSERT_TRUE(ifRangeAllows("", tag));
+    TEST_ASSERT_TRUE(ifRangeAllows("\"10-20\"", tag));
+    TEST_ASSERT_FALSE(ifRangeAllows("W/\"10-20\"", tag));
+    TEST_ASSERT_FALSE(ifRangeAllows("\"10-21\"", tag));
+    TEST_ASSERT_FALSE(ifRangeAllows("Wed, 21 Oct 2015 07:28:00 GMT", tag));
+}
+
+// ============================================================================
+// Read sizing
+// ============================================================================
+
+void test_alignedRead_realignsAfterOddStart(void) {
+    TEST_ASSERT_EQUAL(16384, alignedReadSize(0, 100000, 16384));
+    TEST_ASSERT_EQUAL(16384 - 100, alignedReadSize(100, 100000, 16384));
+    TEST_ASSERT_EQUAL(0u, (100 + alignedReadSize(100, 100000, 16384)) % HTTP_SECTOR_SIZE);
+    TEST_ASSERT_EQUAL(50, alignedReadSize(100, 50, 16384));
+}
+
+void test_alignedRead_walkCoversRangeExactly(void) {
+    uint32_t pos = 777;
+    uint32_t left = 123457;
+    int reads = 0;
+    while (left > 0) {
+        size_t n = alignedReadSize(pos, left, 16384);
+        TEST_ASSERT_TRUE(n > 0 && n <= 16384);
+        if (reads > 0) TEST_ASSERT_EQUAL(0u, pos % HTTP_SECTOR_SIZE);
+        pos += n;
+        left -= n;
+        reads++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(777 + 123457, pos);
+    TEST_ASSERT_EQUAL(8, reads);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_range_closed);
+    RUN_TEST(test_range_openEnded);
+    RUN_TEST(test_range_suffix);
+    RUN_TEST(test_range_endClampedToSize);
+    RUN_TEST(test_range_toleratesSpacesAndCase);
+    RUN_TEST(test_range_unsatisfiable);
+    RUN_TEST(test_range_ignoredWhenMalformedOrMulti);
+    RUN_TEST(test_etag_format);
+    RUN_TEST(test_etagList_matches);
+    RUN_TEST(test_ifRange_strongTagOnly);
+    RUN_TEST(test_alignedRead_realignsAfterOddStart);
+    RUN_TEST(test_alignedRead_walkCoversRangeExactly);
+
+    return UNITY_END();
+}
@@ -0,0 +1,111 @@
+// Log Index Tests
+// Tests the SD log index format helpers: prefix fingerprint and line tag parsing
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/core/log_format.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static bool tagOf(const char* line, char* tag, size_t tagSize = 16) {
+    return logLineTag(line, strlen(line), tag, tagSize);
+}
+
+// ============================================================================
+// Format
+// ============================================================================
+
+void test_header_isSixteenBytes(void) {
+    // Entries start right after the header; readers seek by this size
+    TEST_ASSERT_EQUAL(16, sizeof(LogIndexHeader));
+}
+
+void test_fingerprint_knownVector(void) {
+    // FNV-1a 32-bit test vectors
+    TEST_ASSERT_EQUAL_HEX32(0x811C9DC5, logIndexFingerprint((const uint8_t*)"", 0));
+    TEST_ASSERT_EQUAL_HEX32(0xE40C292C, logIndexFingerprint((const uint8_t*)"a", 1));
+    TEST_ASSERT_EQUAL_HEX32(0xBF9CF968, logIndexFingerprint((const uint8_t*)"foobar", 6));
+}
+
+void test_fingerprint_chainsAcrossCalls(void) {
+    const uint8_t* data = (const uint8_t*)"=== PORKCHOP LOG ===\n";
+    uint32_t whole = logIndexFingerprint(data, 21);
+    uint32_t split = logIndexFingerprint(data + 8, 13, logIndexFingerprint(data, 8));
+    TEST_ASSERT_EQUAL_HEX32(whole, split);
+}
+
+void test_fingerprint_differsForNewLog(void) {
+    const uint8_t* a = (const uint8_t*)"=== PORKCHOP LOG ===\nStarted at millis: 1234\n";
+    const uint8_t* b = (const uint8_t*)"=== PORKCHOP LOG ===\nStarted at millis: 1235\n";
+    TEST_ASSERT_NOT_EQUAL(logIndexFingerprint(a, 45), logIndexFingerprint(b, 45));
+}
+
+// ============================================================================
+// Line tags
+// ============================================================================
+
+void test_tag_parsesSdlogLine(void) {
+    char tag[16];
+    TEST_ASSERT_TRUE(tagOf("[123456][OINK] Handshake captured", tag));
+    TEST_ASSERT_EQUAL_STRING("OINK", tag);
+}
+
+void test_tag_ignoresTrailingNewline(void) {
+    char tag[16];
+    TEST_ASSERT_TRUE(tagOf("[1][SDLOG] Log closed\n", tag));
+    TEST_ASSERT_EQUAL_STRING("SDLOG", tag);
+}
+
+void test_tag_headerLinesHaveNone(void) {
+    char tag[16];
+    TEST_ASSERT_FALSE(tagOf("=== PORKCHOP LOG ===", tag));
+    TEST_ASSERT_FALSE(tagOf("Started at millis: 42", tag));
+    TEST_ASSERT_FALSE(tagOf("", tag));
+}
+
+void test_tag_malformedBrackets(void) {
+    char tag[16];
+    TEST_ASSERT_FALSE(tagOf("[123", tag));
+    TEST_ASSERT_FALSE(tagOf("[123] no tag", tag));
+    TEST_ASSERT_FALSE(tagOf("[123][", tag));
+    TEST_ASSERT_FALSE(tagOf("[123][]", tag));
+    TEST_ASSERT_FALSE(tagOf("[123][OPEN", tag));
+}
+
+void test_tag_truncatedToBuffer(void) {
+    char tag[5];
+    TEST_ASSERT_TRUE(tagOf("[9][VERYLONGTAG] x", tag, sizeof(tag)));
+    TEST_ASSERT_EQUAL_STRING("VERY", tag);
+}
+
+void test_tag_respectsLength(void) {
+    // Line heads from the viewer are not NUL-terminated at the line end
+    const char* buf = "[1][WARHOG] a\n[2][GPS] b\n";
+    char tag[16];
+    TEST_ASSERT_FALSE(logLineTag(buf, 6, tag, sizeof(tag)));
+    TEST_ASSERT_TRUE(logLineTag(buf + 14, 11, tag, sizeof(tag)));
+    TEST_ASSERT_EQUAL_STRING("GPS", tag);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_header_isSixteenBytes);
+    RUN_TEST(test_fingerprint_knownVector);
+    RUN_TEST(test_fingerprint_chainsAcrossCalls);
+    RUN_TEST(test_fingerprint_differsForNewLog);
+    RUN_TEST(test_tag_parsesSdlogLine);
+    RUN_TEST(test_tag_ignoresTrailingNewline);
+    RUN_TEST(test_tag_headerLinesHaveNone);
+    RUN_TEST(test_tag_malformedBrackets);
+    RUN_TEST(test_tag_truncatedToBuffer);
+    RUN_TEST(test_tag_respectsLength);
+
+    return UNITY_END();
+}
@@ -0,0 +1,360 @@
+// ML Batch Tests
+// Tests the structure-of-arrays feature batch, its int16 fixed-point
+// columns and the batched heuristic classifier
+// From: src/ml/ml_batch.h, src/ml/inference.cpp
+
+#include <unity.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "../../src/ml/ml_batch.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+// The float heuristic as MLInference::runInference had it before the
+// batch kernel: normalized scores for one feature vector
+static void referenceScores(const float* input, float* scores) {
+    float rssi = input[0];
+    uint8_t channel = (uint8_t)input[3];
+    float beaconInterval = input[5];
+    bool hasWPS = input[8] > 0.5f;
+    bool hasWPA = input[9] > 0.5f;
+    bool hasWPA2 = input[10] > 0.5f;
+    bool hasWPA3 = input[11] > 0.5f;
+    bool isHidden = input[12] > 0.5f;
+    float beaconJitter = input[15];
+    uint8_t vendorIECount = (uint8_t)input[18];
+    uint8_t supportedRates = (uint8_t)input[19];
+    bool hasHT = input[20] > 0.5f;
+    bool hasVHT = input[21] > 0.5f;
+
+    float anomalyScore = 0.0f;
+    if (rssi > -30) anomalyScore += 0.3f;
+    if (beaconInterval < 50 || beaconInterval > 200) anomalyScore += 0.2f;
+    if (beaconJitter > 10.0f) anomalyScore += 0.15f;
+    if (vendorIECount < 2) anomalyScore += 0.1f;
+    if (!hasWPA && !hasWPA2 && !hasWPA3 && hasWPS) anomalyScore += 0.25f;
+    if (channel <= 14 && channel != 1 && channel != 6 && channel != 11) anomalyScore += 0.05f;
+    if (hasVHT && !hasHT) anomalyScore += 0.2f;
+    if (supportedRates < 4) anomalyScore += 0.1f;
+
+    float evilTwinScore = 0.0f;
+    if (isHidden && rssi > -50) evilTwinScore += 0.2f;
+
+    float vulnScore = 0.0f;
+    if (!hasWPA && !hasWPA2 && !hasWPA3) vulnScore += 0.5f;
+    if (hasWPA && !hasWPA2 && !hasWPA3) vulnScore += 0.4f;
+    if (hasWPS) vulnScore += 0.2f;
+    if (isHidden && vulnScore > 0.3f) vulnScore += 0.1f;
+
+    float deauthScore = 0.0f;
+    if (rssi > -70 && rssi < -30) deauthScore += 0.2f;
+    if (!hasWPA3) deauthScore += 0.3f;
+
+    scores[0] = 1.0f - (anomalyScore + evilTwinScore + vulnScore) / 3.0f;
+    scores[1] = fminf(1.0f, anomalyScore);
+    scores[2] = fminf(1.0f, evilTwinScore);
+    scores[3] = fminf(1.0f, deauthScore);
+    scores[4] = fminf(1.0f, vulnScore);
+    float sum = 0.0f;
+    for (int i = 0; i < 5; i++) sum += scores[i];
+    for (int i = 0; i < 5; i++) scores[i] /= sum;
+}
+
+static uint32_t rngState = 0x4D4C4254;
+static uint32_t rng(uint32_t n) {
+    rngState = rngState * 1664525u + 1013904223u;
+    return (rngState >> 8) % n;
+}
+
+// A feature vector shaped like toFeatureVector's output. Jitter sits on a
+// 1/8 grid so int16 columns hold it exactly: within 1/32 of the 10.0 cut
+// fixed point may land on the other side, which is the accepted cost.
+static void randomNetwork(float* v) {
+    static const float INTERVALS[] = {100, 100, 100, 102, 20, 49, 50, 200, 201, 300};
+    static const uint8_t CHANNELS[] = {1, 6, 11, 3, 9, 13, 14, 36, 149};
+    memset(v, 0, sizeof(float) * ML_BATCH_FEATURES);
+    v[0] = -95.0f + rng(90);
+    v[1] = -95.0f;
+    v[2] = v[0] - v[1];
+    v[3] = CHANNELS[rng(9)];
+    v[5] = INTERVALS[rng(10)];
+    v[6] = (float)rng(256);
+    for (int f = 8; f <= 12; f++) v[f] = (float)rng(2);
+    v[13] = (float)rng(50000);
+    v[14] = (float)rng(70000);
+    v[15] = rng(4) == 0 ? 10.0f : rng(192) / 8.0f;
+    v[18] = (float)rng(7);
+    v[19] = (float)rng(13);
+    v[20] = rng(2) ? 4.0f : 0.0f;
+    v[21] = (float)rng(2);
+    v[22] = rng(1000) / 1000.0f;
+}
+
+// Same class as the reference, allowing either side of an exact tie
+static void assertMatchesReference(const float* row, const MLScores& s) {
+    float ref[5];
+    referenceScores(row, ref);
+    for (int k = 0; k < ML_CLASSES; k++) TEST_ASSERT_FLOAT_WITHIN(1e-5f, ref[k], mlScoreShare(s, k));
+    int refLabel = 0;
+    for (int k = 1; k < ML_CLASSES; k++) {
+        if (ref[k] > ref[refLabel]) refLabel = k;
+    }
+    if (s.label != refLabel) TEST_ASSERT_FLOAT_WITHIN(1e-5f, ref[refLabel], ref[s.label]);
+}
+
+// ============================================================================
+// Fixed point
+// ============================================================================
+
+void test_fixed_integralFeaturesAreExact(void) {
+    TEST_ASSERT_EQUAL_INT16(-67, mlToFixed(-67.0f, ML_F_RSSI));
+    TEST_ASSERT_EQUAL_INT16(100, mlToFixed(100.0f, ML_F_BEACON_INTERVAL));
+    TEST_ASSERT_EQUAL_INT16(1, mlToFixed(1.0f, ML_F_WPA2));
+    TEST_ASSERT_FLOAT_WITHIN(0.0f, -67.0f, mlFromFixed(-67, ML_F_RSSI));
+}
+
+void test_fixed_scaledFeaturesRound(void) {
+    TEST_ASSERT_EQUAL_INT16(160, mlToFixed(10.0f, ML_F_BEACON_JITTER));
+    TEST_ASSERT_EQUAL_INT16(2, mlToFixed(0.1f, ML_F_BEACON_JITTER));      // 1.6 -> 2
+    TEST_ASSERT_EQUAL_INT16(-2, mlToFixed(-0.1f, ML_F_SNR));
+    TEST_ASSERT_EQUAL_INT16(2048, mlToFixed(0.5f, ML_F_ANOMALY));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f / 16, 12.34f, mlFromFixed(mlToFixed(12.34f, ML_F_BEACON_JITTER), ML_F_BEACON_JITTER));
+}
+
+void test_fixed_saturates(void) {
+    TEST_ASSERT_EQUAL_INT16(32767, mlToFixed(70000.0f, 14));
+    TEST_ASSERT_EQUAL_INT16(-32768, mlToFixed(-1e9f, 13));
+    TEST_ASSERT_EQUAL_INT16(32767, mlToFixed(4096.0f, ML_F_BEACON_JITTER));
+}
+
+// ============================================================================
+// Batch layout
+// ============================================================================
+
+void test_batch_columnsAreContiguous(void) {
+    float buf[ML_BATCH_FEATURES * 4];
+    MLFloatBatch batch;
+    batch.attach(buf, 4);
+    float row[ML_BATCH_FEATURES];
+    for (int n = 0; n < 3; n++) {
+        for (int f = 0; f < ML_BATCH_FEATURES; f++) row[f] = n * 100.0f + f;
+        TEST_ASSERT_TRUE(batch.add(row));
+    }
+    TEST_ASSERT_EQUAL(3, batch.size());
+    TEST_ASSERT_EQUAL_PTR(buf + 5 * 4, batch.column(5));
+    TEST_ASSERT_FLOAT_WITHIN(0.0f, 205.0f, batch.column(5)[2]);
+    TEST_ASSERT_FLOAT_WITHIN(0.0f, 5.0f, buf[5 * 4]);
+    TEST_ASSERT_EQUAL(ML_BATCH_FEATURES * 4 * sizeof(float), MLFloatBatch::bytesFor(4));
+    TEST_ASSERT_EQUAL(ML_BATCH_FEATURES * 4 * sizeof(int16_t), MLFixedBatch::bytesFor(4));
+}
+
+void test_batch_refusesWhenFull(void) {
+    int16_t buf[ML_BATCH_FEATURES * 2];
+    MLFixedBatch batch;
+    batch.attach(buf, 2);
+    float row[ML_BATCH_FEATURES] = {0};
+    TEST_ASSERT_TRUE(batch.add(row));
+    TEST_ASSERT_TRUE(batch.add(row));
+    TEST_ASSERT_FALSE(batch.add(row));
+    TEST_ASSERT_EQUAL(2, batch.size());
+    batch.clear();
+    TEST_ASSERT_EQUAL(0, batch.size());
+    TEST_ASSERT_TRUE(batch.add(row));
+}
+
+void test_batch_noBufferHoldsNothing(void) {
+    MLFloatBatch batch;
+    float row[ML_BATCH_FEATURES] = {0};
+    TEST_ASSERT_FALSE(batch.add(row));
+    batch.attach(nullptr, 16);
+    TEST_ASSERT_EQUAL(0, batch.getCapacity());
+    TEST_ASSERT_FALSE(batch.add(row));
+}
+
+void test_batch_rowRoundTrip(void) {
+    int16_t buf[ML_BATCH_FEATURES * 8];
+    MLFixedBatch batch;
+    batch.attach(buf, 8);
+    float in[ML_BATCH_FEATURES], out[ML_BATCH_FEATURES];
+    randomNetwork(in);
+    in[13] = 1234.0f;
+    in[14] = 321.0f;
+    batch.add(in);
+    batch.row(0, out);
+    for (int f = 0; f < ML_BATCH_FEATURES; f++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.5f / (1 << mlFixedShift(f)), in[f], out[f]);
+    }
+}
+
+// ============================================================================
+// Heuristic classifier
+// ============================================================================
+
+void test_heuristic_wpa3RouterIsNormal(void) {
+    float buf[ML_BATCH_FEATURES];
+    MLFloatBatch batch;
+    batch.attach(buf, 1);
+    float row[ML_BATCH_FEATURES] = {0};
+    row[ML_F_RSSI] = -60;
+    row[ML_F_CHANNEL] = 6;
+    row[ML_F_BEACON_INTERVAL] = 100;
+    row[ML_F_WPA2] = 1;
+    row[ML_F_WPA3] = 1;
+    row[ML_F_BEACON_JITTER] = 1.5f;
+    row[ML_F_VENDOR_IES] = 4;
+    row[ML_F_RATES] = 8;
+    row[ML_F_HT] = 4;
+    batch.add(row);
+    MLScores s;
+    mlClassifyHeuristic(batch, 0, 1, &s);
+    TEST_ASSERT_EQUAL(0, s.label);
+    TEST_ASSERT_EQUAL(ML_SCORE_ONE, s.score[0]);
+    TEST_ASSERT_EQUAL(12, s.score[3]);     // 0.2: in deauth range, PMF though
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 60.0f / 72, mlConfidence(s));
+}
+
+void test_heuristic_openWpsIsVulnerable(void) {
+    int16_t buf[ML_BATCH_FEATURES];
+    MLFixedBatch batch;
+    batch.attach(buf, 1);
+    float row[ML_BATCH_FEATURES] = {0};
+    row[ML_F_RSSI] = -55;
+    row[ML_F_CHANNEL] = 1;
+    row[ML_F_BEACON_INTERVAL] = 100;
+    row[ML_F_WPS] = 1;
+    row[ML_F_VENDOR_IES] = 3;
+    row[ML_F_RATES] = 8;
+    row[ML_F_HT] = 4;
+    batch.add(row);
+    MLScores s;
+    mlClassifyHeuristic(batch, 0, 1, &s);
+    TEST_ASSERT_EQUAL(4, s.label);
+    TEST_ASSERT_EQUAL(42, s.score[4]);     // 0.5 open + 0.2 WPS
+    TEST_ASSERT_EQUAL(15, s.score[1]);     // Honeypot pattern
+}
+
+void test_heuristic_floatBatchMatchesReference(void) {
+    const uint16_t N = 1000;
+    std::vector<float> buf(MLFloatBatch::bytesFor(N) / sizeof(float));
+    std::vector<float> rows(N * ML_BATCH_FEATURES);
+    MLFloatBatch batch;
+    batch.attach(buf.data(), N);
+    for (uint16_t i = 0; i < N; i++) {
+        randomNetwork(&rows[i * ML_BATCH_FEATURES]);
+        batch.add(&rows[i * ML_BATCH_FEATURES]);
+    }
+    std::vector<MLScores> out(N);
+    mlClassifyHeuristic(batch, 0, N, out.data());
+    for (uint16_t i = 0; i < N; i++) assertMatchesReference(&rows[i * ML_BATCH_FEATURES], out[i]);
+}
+
+void test_heuristic_fixedBatchMatchesReference(void) {
+    const uint16_t N = 1000;
+    std::vector<int16_t> buf(MLFixedBatch::bytesFor(N) / sizeof(int16_t));
+    std::vector<float> rows(N * ML_BATCH_FEATURES);
+    MLFixedBatch batch;
+    batch.attach(buf.data(), N);
+    for (uint16_t i = 0; i < N; i++) {
+        randomNetwork(&rows[i * ML_BATCH_FEATURES]);
+        batch.add(&rows[i * ML_BATCH_FEATURES]);
+    }
+    std::vector<MLScores> out(N);
+    mlClassifyHeuristic(batch, 0, N, out.data());
+    for (uint16_t i = 0; i < N; i++) assertMatchesReference(&rows[i * ML_BATCH_FEATURES], out[i]);
+}
+
+void test_heuristic_jitterCutIsExactInFixedPoint(void) {
+    // 10.0 is "not high", anything above is - also after scaling by 16
+    int16_t buf[ML_BATCH_FEATURES * 2];
+    MLFixedBatch batch;
+    batch.attach(buf, 2);
+    float row[ML_BATCH_FEATURES] = {0};
+    row[ML_F_RSSI] = -60;
+    row[ML_F_CHANNEL] = 6;
+    row[ML_F_BEACON_INTERVAL] = 100;
+    row[ML_F_WPA2] = 1;
+    row[ML_F_VENDOR_IES] = 4;
+    row[ML_F_RATES] = 8;
+    row[ML_F_BEACON_JITTER] = 10.0f;
+    batch.add(row);
+    row[ML_F_BEACON_JITTER] = 10.07f;
+    batch.add(row);
+    MLScores s[2];
+    mlClassifyHeuristic(batch, 0, 2, s);
+    TEST_ASSERT_EQUAL(0, s[0].score[1]);
+    TEST_ASSERT_EQUAL(9, s[1].score[1]);
+}
+
+void test_heuristic_subRangeAcrossTiles(void) {
+    const uint16_t N = 100;
+    std::vector<int16_t> buf(MLFixedBatch::bytesFor(N) / sizeof(int16_t));
+    MLFixedBatch batch;
+    batch.attach(buf.data(), N);
+    float row[ML_BATCH_FEATURES];
+    for (uint16_t i = 0; i < N; i++) {
+        randomNetwork(row);
+        batch.add(row);
+    }
+    std::vector<MLScores> all(N), part(50);
+    mlClassifyHeuristic(batch, 0, N, all.data());
+    mlClassifyHeuristic(batch, 37, 50, part.data());
+    for (uint16_t i = 0; i < 50; i++) {
+        TEST_ASSERT_EQUAL(all[37 + i].label, part[i].label);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(all[37 + i].score, part[i].score, ML_CLASSES);
+    }
+}
+
+void test_heuristic_sharesSumToOne(void) {
+    float buf[ML_BATCH_FEATURES * 64];
+    MLFloatBatch batch;
+    batch.attach(buf, 64);
+    float row[ML_BATCH_FEATURES];
+    for (int i = 0; i < 64; i++) {
+        randomNetwork(row);
+        batch.add(row);
+    }
+    MLScores out[64];
+    mlClassifyHeuristic(batch, 0, 64, out);
+    for (int i = 0; i < 64; i++) {
+        float sum = 0.0f;
+        for (int k = 0; k < ML_CLASSES; k++) {
+            TEST_ASSERT_TRUE(out[i].score[k] <= ML_SCORE_ONE);
+            sum += mlScoreShare(out[i], k);
+        }
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, sum);
+        TEST_ASSERT_TRUE(out[i].score[out[i].label] >= out[i].score[0]);
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Fixed point
+    RUN_TEST(test_fixed_integralFeaturesAreExact);
+    RUN_TEST(test_fixed_scaledFeaturesRound);
+    RUN_TEST(test_fixed_saturates);
+
+    // Batch layout
+    RUN_TEST(test_batch_columnsAreContiguous);
+    RUN_TEST(test_batch_refusesWhenFull);
+    RUN_TEST(test_batch_noBufferHoldsNothing);
+    RUN_TEST(test_batch_rowRoundTrip);
+
+    // Heuristic classifier
+    RUN_TEST(test_heuristic_wpa3RouterIsNormal);
+    RUN_TEST(test_heuristic_openWpsIsVulnerable);
+    RUN_TEST(test_heuristic_floatBatchMatchesReference);
+    RUN_TEST(test_heuristic_fixedBatchMatchesReference);
+    RUN_TEST(test_heuristic_jitterCutIsExactInFixedPoint);
+    RUN_TEST(test_heuristic_subRangeAcrossTiles);
+    RUN_TEST(test_heuristic_sharesSumToOne);
+
+    return UNITY_END();
+}
@@ -0,0 +1,76 @@
+// OUI Tests
+// Tests the binary search over the generated, sorted OUI prefix table
+
+#include <unity.h>
+#include "../../src/core/oui.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static const uint8_t TABLE[][3] = {
+    {0x00, 0x00, 0x0C},
+    {0x00, 0x03, 0x93},
+    {0x00, 0x1A, 0x11},
+    {0x24, 0x0A, 0xC4},
+    {0x64, 0xEE, 0xB7},
+    {0xAC, 0xDE, 0x48},
+    {0xFC, 0xF5, 0xC4},
+};
+static const size_t TABLE_SIZE = sizeof(TABLE) / sizeof(TABLE[0]);
+
+static uint32_t key(const uint8_t* p) {
+    return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+}
+
+// ============================================================================
+// find()
+// ============================================================================
+
+void test_find_everyEntry(void) {
+    for (size_t i = 0; i < TABLE_SIZE; i++) {
+        TEST_ASSERT_EQUAL_INT32((int32_t)i, OUI::find(TABLE, TABLE_SIZE, key(TABLE[i])));
+    }
+}
+
+void test_find_missesBetweenEntries(void) {
+    TEST_ASSERT_EQUAL_INT32(-1, OUI::find(TABLE, TABLE_SIZE, 0x000394));
+    TEST_ASSERT_EQUAL_INT32(-1, OUI::find(TABLE, TABLE_SIZE, 0x64EEB6));
+}
+
+void test_find_missesOutsideRange(void) {
+    TEST_ASSERT_EQUAL_INT32(-1, OUI::find(TABLE, TABLE_SIZE, 0x000000));
+    TEST_ASSERT_EQUAL_INT32(-1, OUI::find(TABLE, TABLE_SIZE, 0xFFFFFF));
+}
+
+void test_find_emptyTable(void) {
+    TEST_ASSERT_EQUAL_INT32(-1, OUI::find(TABLE, 0, key(TABLE[0])));
+}
+
+void test_find_singleEntry(void) {
+    TEST_ASSERT_EQUAL_INT32(0, OUI::find(TABLE + 3, 1, 0x240AC4));
+    TEST_ASSERT_EQUAL_INT32(-1, OUI::find(TABLE + 3, 1, 0x240AC5));
+}
+
+void test_find_comparesAllThreeBytes(void) {
+    // Same first two bytes as an entry, different third
+    TEST_ASSERT_EQUAL_INT32(-1, OUI::find(TABLE, TABLE_SIZE, 0xACDE49));
+    TEST_ASSERT_EQUAL_INT32(-1, OUI::find(TABLE, TABLE_SIZE, 0xACDF48));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_find_everyEntry);
+    RUN_TEST(test_find_missesBetweenEntries);
+    RUN_TEST(test_find_missesOutsideRange);
+    RUN_TEST(test_find_emptyTable);
+    RUN_TEST(test_find_singleEntry);
+    RUN_TEST(test_find_comparesAllThreeBytes);
+
+    return UNITY_END();
+}
@@ -0,0 +1,512 @@
+// CALL PAPA Protocol Tests
+// Tests revision negotiation, digests/resume and the windowed send/receive sides
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../../src/modes/papa_protocol.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static std::vector<uint8_t> makeCapture(size_t len) {
+    std::vector<uint8_t> v(len);
+    for (size_t i = 0; i < len; i++) v[i] = (uint8_t)(i * 31 + 7);
+    return v;
+}
+
+// Pump every packet the sender has into the receiver, dropping the ones
+// whose index is listed. Returns packets sent.
+static int pump(PapaTxWindow& tx, PapaRxWindow& rx, const std::vector<int>& drop, int& counter) {
+    uint8_t pkt[PAPA_CHUNK_MAX + 2];
+    int n = 0;
+    size_t len;
+    while ((len = tx.nextPacket(pkt)) > 0) {
+        n++;
+        bool dropped = false;
+        for (int d : drop) dropped |= (d == counter);
+        counter++;
+        if (dropped) continue;
+        uint16_t seq = pkt[0] | (pkt[1] << 8);
+        if (seq == PAPA_SEQ_END) {
+            rx.onEnd(pkt[2] | (pkt[3] << 8) | (pkt[4] << 16) | ((uint32_t)pkt[5] << 24));
+        } else {
+            rx.onChunk(seq, pkt + 2, (uint16_t)(len - 2));
+        }
+    }
+    return n;
+}
+
+static void deliverAck(PapaRxWindow& rx, PapaTxWindow& tx) {
+    uint8_t ack[PAPA_ACK_LEN];
+    uint16_t next;
+    uint32_t mask;
+    uint8_t flags;
+    size_t n = rx.takeAck(ack);
+    TEST_ASSERT_TRUE(papaParseAck(ack, n, next, mask, flags));
+    tx.onAck(next, mask, flags);
+}
+
+// ============================================================================
+// Negotiation
+// ============================================================================
+
+void test_chunkForMtu_clampsToLimits(void) {
+    TEST_ASSERT_EQUAL_UINT16(PAPA_LEGACY_CHUNK, papaChunkForMtu(0));
+    TEST_ASSERT_EQUAL_UINT16(18, papaChunkForMtu(23));
+    TEST_ASSERT_EQUAL_UINT16(180, papaChunkForMtu(185));
+    TEST_ASSERT_EQUAL_UINT16(PAPA_CHUNK_MAX, papaChunkForMtu(517));
+}
+
+void test_hello_windowedRoundTrip(void) {
+    uint8_t hello[PAPA_HELLO_LEN];
+    papaBuildHello(hello, 242, PAPA_WINDOW_DEFAULT);
+    PapaLink sirloin = papaAnswerHello(hello, sizeof(hello), 180, 8, PAPA_PROTO_WINDOWED);
+    TEST_ASSERT_EQUAL_UINT8(PAPA_PROTO_WINDOWED, sirloin.version);
+    TEST_ASSERT_EQUAL_UINT16(180, sirloin.chunkSize);
+    TEST_ASSERT_EQUAL_UINT8(8, sirloin.window);
+
+    uint8_t rsp[PAPA_HELLO_RSP_LEN] = {PAPA_RSP_HELLO, 0, 3, 0, 1, 0, 0, 2};
+    papaPutHelloLink(rsp, sirloin);
+    PapaLink papa = papaParseHelloRsp(rsp, sizeof(rsp), 242, PAPA_WINDOW_DEFAULT);
+    TEST_ASSERT_EQUAL_UINT8(PAPA_PROTO_WINDOWED, papa.version);
+    TEST_ASSERT_EQUAL_UINT16(180, papa.chunkSize);
+    TEST_ASSERT_EQUAL_UINT8(8, papa.window);
+}
+
+void test_hello_settlesOnOlderRevision(void) {
+    uint8_t hello[PAPA_HELLO_LEN];
+    papaBuildHello(hello, 242, PAPA_WINDOW_DEFAULT);
+    TEST_ASSERT_EQUAL_UINT8(PAPA_PROTO_LATEST, papaAnswerHello(hello, sizeof(hello), 242, 16).version);
+
+    // A revision 2 Papa talking to a revision 3 Sirloin
+    hello[1] = PAPA_PROTO_WINDOWED;
+    PapaLink link = papaAnswerHello(hello, sizeof(hello), 242, 16);
+    TEST_ASSERT_EQUAL_UINT8(PAPA_PROTO_WINDOWED, link.version);
+
+    uint8_t rsp[PAPA_HELLO_RSP_LEN] = {PAPA_RSP_HELLO, 0, 0, 0, 0, 0, 0, 0};
+    PapaLink future = {PAPA_PROTO_LATEST + 1, 100, 8};
+    papaPutHelloLink(rsp, future);
+    TEST_ASSERT_EQUAL_UINT8(PAPA_PROTO_LEGACY, papaParseHelloRsp(rsp, sizeof(rsp), 242, 16).version);
+}
+
+void test_hello_oldSirloinStaysLegacy(void) {
+    // Current Sirloin: 8-byte RSP_HELLO, version 1
+    uint8_t rsp[8] = {PAPA_RSP_HELLO, 0x01, 3, 0, 1, 0, 0, 2};
+    PapaLink link = papaParseHelloRsp(rsp, sizeof(rsp), 242, PAPA_WINDOW_DEFAULT);
+    TEST_ASSERT_EQUAL_UINT8(PAPA_PROTO_LEGACY, link.version);
+    TEST_ASSERT_EQUAL_UINT16(PAPA_LEGACY_CHUNK, link.chunkSize);
+}
+
+void test_hello_bareHelloAnsweredLegacy(void) {
+    uint8_t hello[1] = {PAPA_CMD_HELLO};
+    PapaLink link = papaAnswerHello(hello, 1, 242, 16);
+    TEST_ASSERT_EQUAL_UINT8(PAPA_PROTO_LEGACY, link.version);
+}
+
+void test_hello_rejectsMoreThanOffered(void) {
+    uint8_t rsp[PAPA_HELLO_RSP_LEN] = {PAPA_RSP_HELLO, 0, 0, 0, 0, 0, 0, 0};
+    PapaLink big = {PAPA_PROTO_WINDOWED, 242, 8};
+    papaPutHelloLink(rsp, big);
+    TEST_ASSERT_EQUAL_UINT8(PAPA_PROTO_LEGACY, papaParseHelloRsp(rsp, sizeof(rsp), 100, 16).version);
+    PapaLink wide = {PAPA_PROTO_WINDOWED, 100, 64};
+    papaPutHelloLink(rsp, wide);
+    TEST_ASSERT_EQUAL_UINT8(PAPA_PROTO_LEGACY, papaParseHelloRsp(rsp, sizeof(rsp), 100, 16).version);
+}
+
+void test_ack_roundTrip(void) {
+    uint8_t ack[PAPA_ACK_LEN];
+    papaBuildAck(ack, 0x1234, 0x80000005, PAPA_ACK_END);
+    uint16_t next;
+    uint32_t mask;
+    uint8_t flags;
+    TEST_ASSERT_TRUE(papaParseAck(ack, sizeof(ack), next, mask, flags));
+    TEST_ASSERT_EQUAL_UINT16(0x1234, next);
+    TEST_ASSERT_EQUAL_HEX32(0x80000005, mask);
+    TEST_ASSERT_EQUAL_UINT8(PAPA_ACK_END, flags);
+    TEST_ASSERT_FALSE(papaParseAck(ack, 4, next, mask, flags));
+}
+
+void test_digest_ofCapture(void) {
+    std::vector<uint8_t> cap = makeCapture(300);
+    PapaDigest d = papaDigestOf(0x02, 7, cap.data(), 300);
+    TEST_ASSERT_EQUAL_MEMORY(cap.data(), d.bssid, 6);
+    TEST_ASSERT_EQUAL_HEX32(crc32Update(0, cap.data(), 300), d.crc);
+    TEST_ASSERT_EQUAL_UINT16(300, d.length);
+    TEST_ASSERT_EQUAL_UINT16(7, d.index);
+}
+
+void test_manifestFit_byMtu(void) {
+    TEST_ASSERT_EQUAL_UINT8(1, papaManifestFit(0));
+    TEST_ASSERT_EQUAL_UINT8(1, papaManifestFit(23));
+    TEST_ASSERT_EQUAL_UINT8(14, papaManifestFit(185));
+    TEST_ASSERT_EQUAL_UINT8(PAPA_MANIFEST_MAX, papaManifestFit(PAPA_MTU_PREFERRED));
+    TEST_ASSERT_EQUAL_UINT8(PAPA_MANIFEST_MAX, papaManifestFit(517));
+    // A full page fits one notification at the preferred MTU
+    TEST_ASSERT_TRUE(PAPA_MANIFEST_HEADER + PAPA_MANIFEST_MAX * PAPA_MANIFEST_ENTRY <=
+                     (size_t)(PAPA_MTU_PREFERRED - PAPA_ATT_NOTIFY_HEADER));
+}
+
+void test_manifest_roundTrip(void) {
+    uint8_t req[PAPA_GET_MANIFEST_LEN];
+    papaBuildGetManifest(req, 0x02, 0x0105, 3);
+    uint8_t type, count;
+    uint16_t first;
+    TEST_ASSERT_TRUE(papaParseGetManifest(req, sizeof(req), type, first, count));
+    TEST_ASSERT_EQUAL_UINT8(0x02, type);
+    TEST_ASSERT_EQUAL_UINT16(0x0105, first);
+    TEST_ASSERT_EQUAL_UINT8(3, count);
+    TEST_ASSERT_FALSE(papaParseGetManifest(req, 4, type, first, count));
+
+    PapaDigest sent[3];
+    std::vector<uint8_t> caps[3];
+    for (int i = 0; i < 3; i++) {
+        caps[i] = makeCapture(100 + i * 50);
+        caps[i][0] = (uint8_t)i;  // Different BSSIDs
+        sent[i] = papaDigestOf(0x02, (uint16_t)(0x0105 + i), caps[i].data(), (uint16_t)caps[i].size());
+    }
+    uint8_t rsp[PAPA_MANIFEST_HEADER + 3 * PAPA_MANIFEST_ENTRY];
+    TEST_ASSERT_EQUAL_UINT32(sizeof(rsp), papaBuildManifest(rsp, 0x02, 0x0105, sent, 3));
+
+    PapaManifest page;
+    TEST_ASSERT_TRUE(page.parse(rsp, sizeof(rsp)));
+    for (int i = 0; i < 3; i++) {
+        const PapaDigest* d = page.find(0x02, (uint16_t)(0x0105 + i));
+        TEST_ASSERT_NOT_NULL(d);
+        TEST_ASSERT_TRUE(papaSameCapture(sent[i], *d));
+        TEST_ASSERT_EQUAL_UINT16(0x0105 + i, d->index);
+    }
+    TEST_ASSERT_NULL(page.find(0x02, 0x0104));
+    TEST_ASSERT_NULL(page.find(0x02, 0x0108));
+    TEST_ASSERT_NULL(page.find(0x01, 0x0105));  // Other type, same index
+    TEST_ASSERT_FALSE(page.endsAt(0x02, 0x0106));
+    TEST_ASSERT_TRUE(page.endsAt(0x02, 0x0107));
+}
+
+void test_manifest_malformedKeepsPage(void) {
+    std::vector<uint8_t> cap = makeCapture(80);
+    PapaDigest d = papaDigestOf(0x01, 0, cap.data(), 80);
+    uint8_t rsp[PAPA_MANIFEST_HEADER + PAPA_MANIFEST_ENTRY];
+    papaBuildManifest(rsp, 0x01, 0, &d, 1);
+
+    PapaManifest page;
+    TEST_ASSERT_NULL(page.find(0x01, 0));       // Empty until the first page
+    TEST_ASSERT_TRUE(page.parse(rsp, sizeof(rsp)));
+    TEST_ASSERT_FALSE(page.parse(rsp, sizeof(rsp) - 1));   // Entry cut short
+    rsp[4] = PAPA_MANIFEST_MAX + 1;
+    TEST_ASSERT_FALSE(page.parse(rsp, sizeof(rsp)));
+    TEST_ASSERT_NOT_NULL(page.find(0x01, 0));
+
+    page.clear();
+    TEST_ASSERT_NULL(page.find(0x01, 0));
+}
+
+void test_digest_differentContentIsNotSame(void) {
+    std::vector<uint8_t> cap = makeCapture(300);
+    PapaDigest a = papaDigestOf(0x02, 0, cap.data(), 300);
+    cap[200] ^= 0xFF;
+    PapaDigest b = papaDigestOf(0x02, 3, cap.data(), 300);
+    TEST_ASSERT_FALSE(papaSameCapture(a, b));
+    cap[200] ^= 0xFF;
+    PapaDigest c = papaDigestOf(0x02, 3, cap.data(), 300);
+    TEST_ASSERT_TRUE(papaSameCapture(a, c));   // Index doesn't matter
+}
+
+void test_startSync_offset(void) {
+    uint8_t cmd[PAPA_START_SYNC_LEN];
+    papaBuildStartSync(cmd, 0x01, 5, 0x0123);
+    TEST_ASSERT_EQUAL_UINT16(0x0123, papaStartSyncOffset(cmd, sizeof(cmd)));
+    // Revision 1/2 form has no offset
+    TEST_ASSERT_EQUAL_UINT16(0, papaStartSyncOffset(cmd, 4));
+}
+
+void test_resumeOffset_onlyForSameUnfinishedCapture(void) {
+    std::vector<uint8_t> cap = makeCapture(300);
+    PapaResumePoint point;
+    point.valid = true;
+    point.digest = papaDigestOf(0x02, 4, cap.data(), 300);
+    point.bytes = 120;
+    point.crc = crc32Update(0, cap.data(), 120);
+
+    PapaDigest same = papaDigestOf(0x02, 1, cap.data(), 300);
+    TEST_ASSERT_EQUAL_UINT16(120, papaResumeOffset(point, same));
+
+    PapaDigest pmkid = papaDigestOf(0x01, 1, cap.data(), 300);
+    TEST_ASSERT_EQUAL_UINT16(0, papaResumeOffset(point, pmkid));
+
+    point.bytes = 300;   // Nothing left to fetch - start over
+    TEST_ASSERT_EQUAL_UINT16(0, papaResumeOffset(point, same));
+
+    point.bytes = 120;
+    point.valid = false;
+    TEST_ASSERT_EQUAL_UINT16(0, papaResumeOffset(point, same));
+}
+
+// ============================================================================
+// Receive side
+// ============================================================================
+
+void test_rx_outOfOrderChunksGiveSameCrc(void) {
+    std::vector<uint8_t> cap = makeCapture(100);
+    uint8_t buf[256];
+    PapaRxWindow rx;
+    TEST_ASSERT_TRUE(rx.begin(buf, sizeof(buf), 40, 3, 8));
+    TEST_ASSERT_TRUE(rx.onChunk(2, cap.data() + 80, 20));
+    TEST_ASSERT_TRUE(rx.onChunk(0, cap.data(), 40));
+    TEST_ASSERT_FALSE(rx.allReceived());
+    TEST_ASSERT_TRUE(rx.onChunk(1, cap.data() + 40, 40));
+    TEST_ASSERT_TRUE(rx.allReceived());
+    TEST_ASSERT_FALSE(rx.complete());
+
+    TEST_ASSERT_TRUE(rx.onEnd(crc32Update(0, cap.data(), cap.size())));
+    TEST_ASSERT_TRUE(rx.crcOk());
+    TEST_ASSERT_EQUAL_UINT32(100, rx.length());
+    TEST_ASSERT_EQUAL_MEMORY(cap.data(), buf, 100);
+}
+
+void test_rx_rejectsDuplicatesAndBadSizes(void) {
+    std::vector<uint8_t> cap = makeCapture(100);
+    uint8_t buf[256];
+    PapaRxWindow rx;
+    rx.begin(buf, sizeof(buf), 40, 3, 8);
+    TEST_ASSERT_TRUE(rx.onChunk(0, cap.data(), 40));
+    TEST_ASSERT_FALSE(rx.onChunk(0, cap.data(), 40));   // Duplicate
+    TEST_ASSERT_FALSE(rx.onChunk(1, cap.data(), 39));   // Short middle chunk
+    TEST_ASSERT_FALSE(rx.onChunk(2, cap.data(), 41));   // Oversize last chunk
+    TEST_ASSERT_FALSE(rx.onChunk(3, cap.data(), 10));   // Past the end
+    TEST_ASSERT_EQUAL_UINT16(1, rx.receivedCount());
+}
+
+void test_rx_refusesCaptureBiggerThanBuffer(void) {
+    uint8_t buf[100];
+    PapaRxWindow rx;
+    TEST_ASSERT_FALSE(rx.begin(buf, sizeof(buf), 40, 4, 8));
+    TEST_ASSERT_FALSE(rx.isActive());
+    TEST_ASSERT_TRUE(rx.begin(buf, sizeof(buf), 40, 3, 8));
+}
+
+void test_rx_gapRaisesNackWithMask(void) {
+    std::vector<uint8_t> cap = makeCapture(400);
+    uint8_t buf[512];
+    PapaRxWindow rx;
+    rx.begin(buf, sizeof(buf), 40, 10, 16);
+    rx.onChunk(0, cap.data(), 40);
+    TEST_ASSERT_FALSE(rx.ackDue());
+    rx.onChunk(2, cap.data() + 80, 40);   // Chunk 1 missing
+    TEST_ASSERT_TRUE(rx.ackDue());
+    rx.onChunk(4, cap.data() + 160, 40);
+
+    uint8_t ack[PAPA_ACK_LEN];
+    rx.takeAck(ack);
+    uint16_t next;
+    uint32_t mask;
+    uint8_t flags;
+    papaParseAck(ack, sizeof(ack), next, mask, flags);
+    TEST_ASSERT_EQUAL_UINT16(1, next);
+    TEST_ASSERT_EQUAL_HEX32(0x5, mask);   // Chunks 2 and 4
+    TEST_ASSERT_EQUAL_UINT8(0, flags);
+    TEST_ASSERT_FALSE(rx.ackDue());
+}
+
+void test_rx_inactiveAfterReset(void) {
+    std::vector<uint8_t> cap = makeCapture(40);
+    uint8_t buf[64];
+    PapaRxWindow rx;
+    rx.begin(buf, sizeof(buf), 40, 1, 8);
+    rx.onChunk(0, cap.data(), 40);
+    rx.onEnd(crc32Update(0, cap.data(), 40));
+    TEST_ASSERT_TRUE(rx.crcOk());
+    rx.reset();
+    // A repeated end marker for a finished capture is ignored
+    TEST_ASSERT_FALSE(rx.onEnd(0));
+    TEST_ASSERT_FALSE(rx.complete());
+}
+
+// ============================================================================
+// Send side and both together
+// ============================================================================
+
+void test_tx_respectsWindow(void) {
+    std::vector<uint8_t> cap = makeCapture(1000);
+    PapaTxWindow tx;
+    TEST_ASSERT_TRUE(tx.begin(cap.data(), 1000, 100, 4));
+    TEST_ASSERT_EQUAL_UINT16(10, tx.totalChunks());
+    uint8_t pkt[128];
+    int n = 0;
+    while (tx.nextPacket(pkt) > 0) n++;
+    TEST_ASSERT_EQUAL(4, n);
+    tx.onAck(2, 0, 0);
+    n = 0;
+    while (tx.nextPacket(pkt) > 0) n++;
+    TEST_ASSERT_EQUAL(2, n);
+}
+
+void test_tx_refusesTooManyChunks(void) {
+    std::vector<uint8_t> cap = makeCapture(PAPA_MAX_CHUNKS * 17 + 1);
+    PapaTxWindow tx;
+    TEST_ASSERT_FALSE(tx.begin(cap.data(), (uint16_t)cap.size(), 17, 16));
+}
+
+void test_loopback_cleanTransfer(void) {
+    std::vector<uint8_t> cap = makeCapture(1500);
+    uint8_t buf[2048];
+    PapaTxWindow tx;
+    PapaRxWindow rx;
+    tx.begin(cap.data(), 1500, 242, 16);
+    rx.begin(buf, sizeof(buf), 242, tx.totalChunks(), 16);
+    int counter = 0;
+    int sent = pump(tx, rx, std::vector<int>(), counter);
+    TEST_ASSERT_EQUAL(7 + 1, sent);   // Whole capture fits the window, then the end marker
+    TEST_ASSERT_TRUE(rx.crcOk());
+    TEST_ASSERT_EQUAL_UINT32(1500, rx.length());
+    TEST_ASSERT_EQUAL_MEMORY(cap.data(), buf, 1500);
+    TEST_ASSERT_EQUAL_UINT32(0, tx.chunksResent());
+}
+
+void test_loopback_selectiveNackResendsOnlyHoles(void) {
+    std::vector<uint8_t> cap = makeCapture(1500);
+    uint8_t buf[2048];
+    PapaTxWindow tx;
+    PapaRxWindow rx;
+    tx.begin(cap.data(), 1500, 100, 16);
+    rx.begin(buf, sizeof(buf), 100, tx.totalChunks(), 16);
+    int counter = 0;
+    std::vector<int> drop;
+    drop.push_back(3);
+    drop.push_back(7);
+    pump(tx, rx, drop, counter);
+    TEST_ASSERT_FALSE(rx.complete());
+
+    deliverAck(rx, tx);
+    pump(tx, rx, std::vector<int>(), counter);
+    TEST_ASSERT_TRUE(rx.crcOk());
+    TEST_ASSERT_EQUAL_UINT32(2, tx.chunksResent());
+    TEST_ASSERT_EQUAL_MEMORY(cap.data(), buf, 1500);
+}
+
+void test_loopback_lostTailRecoveredByTimeout(void) {
+    std::vector<uint8_t> cap = makeCapture(300);
+    uint8_t buf[512];
+    PapaTxWindow tx;
+    PapaRxWindow rx;
+    tx.begin(cap.data(), 300, 100, 8);
+    rx.begin(buf, sizeof(buf), 100, tx.totalChunks(), 8);
+    int counter = 0;
+    std::vector<int> drop;
+    drop.push_back(2);   // Last chunk
+    drop.push_back(3);   // End marker
+    pump(tx, rx, drop, counter);
+    TEST_ASSERT_FALSE(rx.complete());
+
+    tx.onTimeout();
+    pump(tx, rx, std::vector<int>(), counter);
+    TEST_ASSERT_TRUE(rx.crcOk());
+}
+
+void test_loopback_endFlagNacksMissingTail(void) {
+    std::vector<uint8_t> cap = makeCapture(300);
+    uint8_t buf[512];
+    PapaTxWindow tx;
+    PapaRxWindow rx;
+    tx.begin(cap.data(), 300, 100, 8);
+    rx.begin(buf, sizeof(buf), 100, tx.totalChunks(), 8);
+    int counter = 0;
+    std::vector<int> drop;
+    drop.push_back(2);   // Last chunk lost, end marker arrives
+    pump(tx, rx, drop, counter);
+    TEST_ASSERT_TRUE(rx.ackDue());
+
+    deliverAck(rx, tx);
+    pump(tx, rx, std::vector<int>(), counter);
+    TEST_ASSERT_TRUE(rx.crcOk());
+    TEST_ASSERT_EQUAL_UINT32(1, tx.chunksResent());
+}
+
+void test_loopback_resumeFromOffset(void) {
+    std::vector<uint8_t> cap = makeCapture(1000);
+    uint8_t buf[2048];
+    PapaTxWindow tx;
+    PapaRxWindow rx;
+
+    // First attempt: link drops after a few chunks, one of them out of order
+    tx.begin(cap.data(), 1000, 100, 16);
+    rx.begin(buf, sizeof(buf), 100, tx.totalChunks(), 16);
+    uint8_t pkt[128];
+    for (int i = 0; i < 5; i++) {
+        size_t n = tx.nextPacket(pkt);
+        if (i == 3) continue;   // Chunk 3 lost, 4 lands
+        rx.onChunk(pkt[0] | (pkt[1] << 8), pkt + 2, (uint16_t)(n - 2));
+    }
+    TEST_ASSERT_EQUAL_UINT32(300, rx.contiguousLength());
+    uint16_t offset = (uint16_t)rx.contiguousLength();
+    uint32_t prefixCrc = rx.crcValue();
+    TEST_ASSERT_EQUAL_HEX32(crc32Update(0, cap.data(), 300), prefixCrc);
+
+    // Reconnect: Sirloin sends from the offset, Papa appends behind the prefix
+    TEST_ASSERT_TRUE(tx.begin(cap.data() + offset, 1000 - offset, 100, 16, crc32Update(0, cap.data(), offset)));
+    TEST_ASSERT_EQUAL_UINT16(7, tx.totalChunks());
+    rx.begin(buf + offset, sizeof(buf) - offset, 100, tx.totalChunks(), 16, prefixCrc);
+    int counter = 0;
+    pump(tx, rx, std::vector<int>(), counter);
+    TEST_ASSERT_TRUE(rx.crcOk());
+    TEST_ASSERT_EQUAL_UINT32(700, rx.length());
+    TEST_ASSERT_EQUAL_MEMORY(cap.data(), buf, 1000);
+}
+
+void test_loopback_badCrcDetected(void) {
+    std::vector<uint8_t> cap = makeCapture(200);
+    uint8_t buf[256];
+    PapaRxWindow rx;
+    rx.begin(buf, sizeof(buf), 100, 2, 8);
+    rx.onChunk(0, cap.data(), 100);
+    cap[150] ^= 0x01;
+    rx.onChunk(1, cap.data() + 100, 100);
+    cap[150] ^= 0x01;
+    rx.onEnd(crc32Update(0, cap.data(), 200));
+    TEST_ASSERT_TRUE(rx.complete());
+    TEST_ASSERT_FALSE(rx.crcOk());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    // Negotiation
+    RUN_TEST(test_chunkForMtu_clampsToLimits);
+    RUN_TEST(test_hello_windowedRoundTrip);
+    RUN_TEST(test_hello_settlesOnOlderRevision);
+    RUN_TEST(test_hello_oldSirloinStaysLegacy);
+    RUN_TEST(test_hello_bareHelloAnsweredLegacy);
+    RUN_TEST(test_hello_rejectsMoreThanOffered);
+    RUN_TEST(test_ack_roundTrip);
+    RUN_TEST(test_digest_ofCapture);
+    RUN_TEST(test_manifestFit_byMtu);
+    RUN_TEST(test_manifest_roundTrip);
+    RUN_TEST(test_manifest_malformedKeepsPage);
+    RUN_TEST(test_digest_differentContentIsNotSame);
+    RUN_TEST(test_startSync_offset);
+    RUN_TEST(test_resumeOffset_onlyForSameUnfinishedCapture);
+
+    // Receive side
+    RUN_TEST(test_rx_outOfOrderChunksGiveSameCrc);
+    RUN_TEST(test_rx_rejectsDuplicatesAndBadSizes);
+    RUN_TEST(test_rx_refusesCaptureBiggerThanBuffer);
+    RUN_TEST(test_rx_gapRaisesNackWithMask);
+    RUN_TEST(test_rx_inactiveAfterReset);
+
+    // Send side and both together
+    RUN_TEST(test_tx_respectsWindow);
+    RUN_TEST(test_tx_refusesTooManyChunks);
+    RUN_TEST(test_loopback_cleanTransfer);
+    RUN_TEST(test_loopback_selectiveNackResendsOnlyHoles);
+    RUN_TEST(test_loopback_lostTailRecoveredByTimeout);
+    RUN_TEST(test_loopback_endFlagNacksMissingTail);
+    RUN_TEST(test_loopback_resumeFromOffset);
+    RUN_TEST(test_loopback_badCrcDetected);
+
+    return UNITY_END();
+}
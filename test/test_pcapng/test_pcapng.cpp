@@ -0,0 +1,253 @@
+// PCAPNG Tests
+// Tests block encoding and the sector-aligned double buffer used for session captures
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../../src/core/pcapng.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static uint32_t rd32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t rd16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+// ============================================================================
+// Block encoders
+// ============================================================================
+
+void test_shb_layout(void) {
+    uint8_t b[PCAPNG_SHB_LEN];
+    TEST_ASSERT_EQUAL(28, (int)pcapngSHB(b));
+    TEST_ASSERT_EQUAL_HEX32(0x0A0D0D0A, rd32(b));
+    TEST_ASSERT_EQUAL_UINT32(28, rd32(b + 4));
+    TEST_ASSERT_EQUAL_HEX32(0x1A2B3C4D, rd32(b + 8));
+    TEST_ASSERT_EQUAL(1, rd16(b + 12));
+    TEST_ASSERT_EQUAL(0, rd16(b + 14));
+    TEST_ASSERT_EQUAL_UINT32(28, rd32(b + 24));
+}
+
+void test_idb_layout(void) {
+    uint8_t b[PCAPNG_IDB_LEN];
+    TEST_ASSERT_EQUAL(20, (int)pcapngIDB(b, PCAPNG_LINKTYPE_RADIOTAP, 2346));
+    TEST_ASSERT_EQUAL_UINT32(1, rd32(b));
+    TEST_ASSERT_EQUAL(127, rd16(b + 8));
+    TEST_ASSERT_EQUAL_UINT32(2346, rd32(b + 12));
+    TEST_ASSERT_EQUAL_UINT32(20, rd32(b + 16));
+}
+
+void test_radiotap_fields(void) {
+    uint8_t rt[PCAPNG_RADIOTAP_LEN];
+    TEST_ASSERT_EQUAL(16, (int)pcapngRadiotap(rt, 6, -55, -92, true));
+    TEST_ASSERT_EQUAL(16, rd16(rt + 2));
+    TEST_ASSERT_EQUAL_HEX32(0x6A, rd32(rt + 4));
+    TEST_ASSERT_EQUAL_HEX8(0x10, rt[8]);
+    TEST_ASSERT_EQUAL(2437, rd16(rt + 10));
+    TEST_ASSERT_EQUAL(-55, (int8_t)rt[14]);
+    TEST_ASSERT_EQUAL(-92, (int8_t)rt[15]);
+}
+
+void test_radiotap_channel14(void) {
+    uint8_t rt[PCAPNG_RADIOTAP_LEN];
+    pcapngRadiotap(rt, 14, 0, 0, false);
+    TEST_ASSERT_EQUAL(2484, rd16(rt + 10));
+    TEST_ASSERT_EQUAL_HEX8(0x00, rt[8]);
+}
+
+void test_epb_paddingAndLengths(void) {
+    uint8_t rt[PCAPNG_RADIOTAP_LEN];
+    pcapngRadiotap(rt, 1, -40, -95, false);
+    uint8_t frame[33];
+    for (int i = 0; i < 33; i++) frame[i] = (uint8_t)i;
+    
+    uint8_t out[128];
+    memset(out, 0xEE, sizeof(out));
+    size_t n = pcapngEPB(out, 0x123456789ULL, rt, sizeof(rt), frame, 33, 120);
+    
+    // 16 + 33 = 49 -> padded 52, + 32 overhead = 84
+    TEST_ASSERT_EQUAL(84, (int)n);
+    TEST_ASSERT_EQUAL(84, (int)pcapngEPBSize(49));
+    TEST_ASSERT_EQUAL_UINT32(6, rd32(out));
+    TEST_ASSERT_EQUAL_UINT32(84, rd32(out + 4));
+    TEST_ASSERT_EQUAL_UINT32(0x1, rd32(out + 12));
+    TEST_ASSERT_EQUAL_HEX32(0x23456789, rd32(out + 16));
+    TEST_ASSERT_EQUAL_UINT32(49, rd32(out + 20));
+    TEST_ASSERT_EQUAL_UINT32(136, rd32(out + 24));  // radiotap + on-air length
+    TEST_ASSERT_EQUAL_MEMORY(frame, out + 28 + 16, 33);
+    TEST_ASSERT_EQUAL(0, out[28 + 49]);
+    TEST_ASSERT_EQUAL(0, out[28 + 51]);
+    TEST_ASSERT_EQUAL_UINT32(84, rd32(out + 80));
+}
+
+void test_epb_ringTrimmedFrameWithinSnaplen(void) {
+    // A data frame the OINK ring cut to 32 of its 1400 bytes, in a session
+    // whose longest trim is 1500: packet fits the IDB snaplen, and the EPB
+    // still says how long the frame was on air
+    uint32_t snaplen = pcapngSnapLen(1500);
+    TEST_ASSERT_EQUAL_UINT32(1516, snaplen);
+    
+    uint8_t rt[PCAPNG_RADIOTAP_LEN];
+    pcapngRadiotap(rt, 6, -60, -92, false);
+    uint8_t frame[32];
+    memset(frame, 0x88, sizeof(frame));
+    uint8_t out[96];
+    pcapngEPB(out, 0, rt, sizeof(rt), frame, 32, 1400);
+    
+    uint32_t capLen = rd32(out + 20);
+    uint32_t origLen = rd32(out + 24);
+    TEST_ASSERT_EQUAL_UINT32(48, capLen);
+    TEST_ASSERT_EQUAL_UINT32(1416, origLen);
+    TEST_ASSERT_TRUE(capLen <= snaplen);
+    TEST_ASSERT_TRUE(capLen < origLen);
+}
+
+void test_frameEpb_untrimmedFrameHasNoFcsFlag(void) {
+    // A whole EAPOL frame as the ring holds it: FCS already stripped, so
+    // capLen == origLen and nothing at the end may be read as an FCS
+    uint8_t frame[121];
+    for (int i = 0; i < 121; i++) frame[i] = (uint8_t)(i + 1);
+    uint8_t out[256];
+    size_t n = pcapngFrameEPB(out, 0, frame, 121, 121, 6, -50, -92);
+    
+    TEST_ASSERT_EQUAL(172, (int)n);
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[28 + 8]);   // Radiotap flags
+    TEST_ASSERT_EQUAL_UINT32(16 + 121, rd32(out + 20));
+    TEST_ASSERT_EQUAL_UINT32(16 + 121, rd32(out + 24));
+    TEST_ASSERT_EQUAL_MEMORY(frame, out + 28 + 16, 121);
+}
+
+void test_frameEpb_trimmedFrameHasNoFcsFlag(void) {
+    uint8_t frame[32];
+    memset(frame, 0x88, sizeof(frame));
+    uint8_t out[96];
+    pcapngFrameEPB(out, 0, frame, 32, 1400, 11, -70, -95);
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[28 + 8]);
+    TEST_ASSERT_EQUAL_UINT32(16 + 1400, rd32(out + 24));
+}
+
+// ============================================================================
+// Double buffer
+// ============================================================================
+
+// Drain the buffer like PcapngSession::service() and collect the file image
+struct FakeFile {
+    std::vector<uint8_t> data;
+    std::vector<size_t> writeOffsets;
+    std::vector<size_t> writeSizes;
+    
+    void write(const uint8_t* p, size_t n) {
+        writeOffsets.push_back(data.size());
+        writeSizes.push_back(n);
+        data.insert(data.end(), p, p + n);
+    }
+};
+
+template <size_t B>
+static void serviceFull(PcapngBlockBuffer<B>& buf, FakeFile& f) {
+    if (buf.hasFullBlock()) {
+        size_t n;
+        const uint8_t* p = buf.fullBlock(n);
+        f.write(p, n);
+        buf.releaseFullBlock();
+    }
+}
+
+template <size_t B>
+static void flushPartial(PcapngBlockBuffer<B>& buf, FakeFile& f) {
+    size_t n;
+    const uint8_t* p = buf.partial(n);
+    if (n) f.write(p, n);
+    buf.markPartialFlushed();
+}
+
+void test_buffer_blockWritesAreAligned(void) {
+    PcapngBlockBuffer<512> buf;
+    FakeFile f;
+    std::vector<uint8_t> expect;
+    uint8_t rec[100];
+    for (int i = 0; i < 40; i++) {
+        memset(rec, i, sizeof(rec));
+        TEST_ASSERT_TRUE(buf.fits(sizeof(rec)));
+        buf.put(rec, sizeof(rec));
+        expect.insert(expect.end(), rec, rec + sizeof(rec));
+        serviceFull(buf, f);
+    }
+    for (size_t i = 0; i < f.writeSizes.size(); i++) {
+        TEST_ASSERT_EQUAL(512, (int)f.writeSizes[i]);
+        TEST_ASSERT_EQUAL(0, (int)(f.writeOffsets[i] % 512));
+    }
+    flushPartial(buf, f);
+    TEST_ASSERT_EQUAL((int)expect.size(), (int)f.data.size());
+    TEST_ASSERT_EQUAL_MEMORY(expect.data(), f.data.data(), expect.size());
+}
+
+void test_buffer_partialFlushKeepsAlignment(void) {
+    PcapngBlockBuffer<512> buf;
+    FakeFile f;
+    std::vector<uint8_t> expect;
+    uint8_t rec[70];
+    for (int i = 0; i < 30; i++) {
+        memset(rec, 0x40 + i, sizeof(rec));
+        buf.put(rec, sizeof(rec));
+        expect.insert(expect.end(), rec, rec + sizeof(rec));
+        serviceFull(buf, f);
+        if (i % 4 == 3) flushPartial(buf, f);  // Periodic flush
+    }
+    flushPartial(buf, f);
+    TEST_ASSERT_EQUAL_MEMORY(expect.data(), f.data.data(), expect.size());
+    
+    // Every write that ends a block ends exactly on a 512 boundary
+    for (size_t i = 0; i < f.writeSizes.size(); i++) {
+        size_t end = f.writeOffsets[i] + f.writeSizes[i];
+        size_t start = f.writeOffsets[i];
+        TEST_ASSERT_TRUE(start / 512 == (end - 1) / 512);  // Never straddles a block
+    }
+}
+
+void test_buffer_refusesWhenSdBehind(void) {
+    PcapngBlockBuffer<512> buf;
+    uint8_t rec[200];
+    memset(rec, 1, sizeof(rec));
+    int accepted = 0;
+    // No servicing - both buffers fill up
+    for (int i = 0; i < 10; i++) {
+        if (buf.fits(sizeof(rec))) {
+            buf.put(rec, sizeof(rec));
+            accepted++;
+        }
+    }
+    TEST_ASSERT_TRUE(buf.hasFullBlock());
+    TEST_ASSERT_EQUAL(5, accepted);  // 1000 bytes: 512 full + 488 in second
+    
+    FakeFile f;
+    serviceFull(buf, f);
+    TEST_ASSERT_TRUE(buf.fits(sizeof(rec)));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_shb_layout);
+    RUN_TEST(test_idb_layout);
+    RUN_TEST(test_radiotap_fields);
+    RUN_TEST(test_radiotap_channel14);
+    RUN_TEST(test_epb_paddingAndLengths);
+    RUN_TEST(test_epb_ringTrimmedFrameWithinSnaplen);
+    RUN_TEST(test_frameEpb_untrimmedFrameHasNoFcsFlag);
+    RUN_TEST(test_frameEpb_trimmedFrameHasNoFcsFlag);
+    RUN_TEST(test_buffer_blockWritesAreAligned);
+    RUN_TEST(test_buffer_partialFlushKeepsAlignment);
+    RUN_TEST(test_buffer_refusesWhenSdBehind);
+    
+    return UNITY_END();
+}
@@ -0,0 +1,143 @@
+// Perf Trace Tests
+// Tests the log-linear latency histogram behind the hot-path timers
+
+#include <unity.h>
+#include "../../src/core/perf_trace.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+// ============================================================================
+// Buckets
+// ============================================================================
+
+void test_bucket_smallValuesAreExact(void) {
+    for (uint32_t v = 0; v < 8; v++) {
+        TEST_ASSERT_EQUAL_UINT32(v, PerfHistogram::bucketLow(PerfHistogram::bucketFor(v)));
+    }
+}
+
+void test_bucket_boundsContainValue(void) {
+    uint32_t values[] = {9, 100, 1000, 4095, 4096, 123456, 9999999, 1u << 29};
+    for (uint32_t v : values) {
+        uint8_t idx = PerfHistogram::bucketFor(v);
+        TEST_ASSERT_TRUE(PerfHistogram::bucketLow(idx) <= v);
+        TEST_ASSERT_TRUE(PerfHistogram::bucketLow(idx + 1) > v);
+    }
+}
+
+void test_bucket_monotonic(void) {
+    uint8_t prev = 0;
+    for (uint32_t v = 1; v < 200000; v += 7) {
+        uint8_t idx = PerfHistogram::bucketFor(v);
+        TEST_ASSERT_TRUE(idx >= prev);
+        prev = idx;
+    }
+}
+
+void test_bucket_hugeValuesClampToLast(void) {
+    TEST_ASSERT_EQUAL(PERF_BUCKETS - 1, PerfHistogram::bucketFor(0xFFFFFFFFu));
+    TEST_ASSERT_EQUAL(PERF_BUCKETS - 1, PerfHistogram::bucketFor(1u << 31));
+}
+
+// ============================================================================
+// Stats
+// ============================================================================
+
+void test_stats_emptyIsZero(void) {
+    PerfHistogram h;
+    PerfStats s = h.stats();
+    TEST_ASSERT_EQUAL_UINT32(0, s.count);
+    TEST_ASSERT_EQUAL_UINT32(0, s.min);
+    TEST_ASSERT_EQUAL_UINT32(0, s.max);
+    TEST_ASSERT_EQUAL_UINT32(0, s.p50);
+    TEST_ASSERT_EQUAL_UINT32(0, s.p99);
+}
+
+void test_stats_minMaxAvgExact(void) {
+    PerfHistogram h;
+    h.record(100);
+    h.record(300);
+    h.record(200);
+    PerfStats s = h.stats();
+    TEST_ASSERT_EQUAL_UINT32(3, s.count);
+    TEST_ASSERT_EQUAL_UINT32(100, s.min);
+    TEST_ASSERT_EQUAL_UINT32(300, s.max);
+    TEST_ASSERT_EQUAL_UINT32(200, s.avg);
+}
+
+void test_stats_singleValuePercentilesClampToValue(void) {
+    PerfHistogram h;
+    for (int i = 0; i < 50; i++) h.record(1000);
+    PerfStats s = h.stats();
+    TEST_ASSERT_EQUAL_UINT32(1000, s.p50);
+    TEST_ASSERT_EQUAL_UINT32(1000, s.p99);
+}
+
+void test_stats_percentilesWithinBucketError(void) {
+    PerfHistogram h;
+    // 1..10000: p50 ~5000, p99 ~9900
+    for (uint32_t v = 1; v <= 10000; v++) h.record(v);
+    PerfStats s = h.stats();
+    TEST_ASSERT_UINT32_WITHIN(5000 / 8, 5000, s.p50);
+    TEST_ASSERT_UINT32_WITHIN(9900 / 8, 9900, s.p99);
+}
+
+void test_stats_tailShowsInP99NotP50(void) {
+    PerfHistogram h;
+    for (int i = 0; i < 980; i++) h.record(2000);
+    for (int i = 0; i < 20; i++) h.record(500000);  // 2% stalls
+    PerfStats s = h.stats();
+    TEST_ASSERT_UINT32_WITHIN(250, 2000, s.p50);
+    TEST_ASSERT_UINT32_WITHIN(500000 / 8, 500000, s.p99);
+    TEST_ASSERT_EQUAL_UINT32(500000, s.max);
+}
+
+void test_saturation_halvesButKeepsShape(void) {
+    PerfHistogram h;
+    for (uint32_t i = 0; i < 200000; i++) h.record(i % 10 == 0 ? 64000 : 1000);
+    PerfStats s = h.stats();
+    TEST_ASSERT_EQUAL_UINT32(200000, s.count);
+    TEST_ASSERT_UINT32_WITHIN(125, 1000, s.p50);
+    TEST_ASSERT_UINT32_WITHIN(8000, 64000, s.p99);
+}
+
+void test_reset_clearsEverything(void) {
+    PerfHistogram h;
+    h.record(12345);
+    h.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, h.getCount());
+    TEST_ASSERT_EQUAL_UINT32(0, h.stats().max);
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentile(0.5f));
+}
+
+void test_sectionNames_coverAllSections(void) {
+    for (uint8_t i = 0; i < PERF_SECTION_COUNT; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, strcmp("?", perfSectionName((PerfSection)i)));
+    }
+    TEST_ASSERT_EQUAL_STRING("?", perfSectionName(PerfSection::COUNT));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_bucket_smallValuesAreExact);
+    RUN_TEST(test_bucket_boundsContainValue);
+    RUN_TEST(test_bucket_monotonic);
+    RUN_TEST(test_bucket_hugeValuesClampToLast);
+    RUN_TEST(test_stats_emptyIsZero);
+    RUN_TEST(test_stats_minMaxAvgExact);
+    RUN_TEST(test_stats_singleValuePercentilesClampToValue);
+    RUN_TEST(test_stats_percentilesWithinBucketError);
+    RUN_TEST(test_stats_tailShowsInP99NotP50);
+    RUN_TEST(test_saturation_halvesButKeepsShape);
+    RUN_TEST(test_reset_clearsEverything);
+    RUN_TEST(test_sectionNames_coverAllSections);
+
+    return UNITY_END();
+}
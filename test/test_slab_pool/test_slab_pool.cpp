@@ -0,0 +1,147 @@
+// Slab Pool Tests
+// Tests the page/cell allocator behind pooled EAPOL frame storage
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../../src/core/slab_pool.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+typedef SlabPool<32, 4> Pool;  // 2KB pages, 8KB max
+
+// ============================================================================
+// Allocation
+// ============================================================================
+
+void test_alloc_roundsUpToCells(void) {
+    Pool pool;
+    uint8_t* a = pool.alloc(1);
+    uint8_t* b = pool.alloc(33);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL(32 + 64, (int)pool.getBytesUsed());
+    TEST_ASSERT_EQUAL(1, (int)pool.getPageCount());
+    TEST_ASSERT_EQUAL_PTR(a + 32, b);  // Packed back to back
+}
+
+void test_alloc_rejectsZeroAndOversize(void) {
+    Pool pool;
+    TEST_ASSERT_NULL(pool.alloc(0));
+    TEST_ASSERT_NULL(pool.alloc(Pool::maxSlice() + 1));
+    TEST_ASSERT_EQUAL(2, (int)pool.getFailures());
+    TEST_ASSERT_NOT_NULL(pool.alloc(Pool::maxSlice()));
+}
+
+void test_alloc_slicesDoNotOverlap(void) {
+    Pool pool;
+    std::vector<uint8_t*> slices;
+    for (int i = 0; i < 40; i++) {
+        uint8_t* p = pool.alloc(100 + i);
+        TEST_ASSERT_NOT_NULL(p);
+        memset(p, i, 100 + i);
+        slices.push_back(p);
+    }
+    for (int i = 0; i < 40; i++) {
+        for (int j = 0; j < 100 + i; j++) {
+            TEST_ASSERT_EQUAL_UINT8(i, slices[i][j]);
+        }
+    }
+}
+
+void test_alloc_exhaustionReturnsNull(void) {
+    Pool pool;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_NOT_NULL(pool.alloc(Pool::maxSlice()));
+    }
+    TEST_ASSERT_NULL(pool.alloc(1));
+    TEST_ASSERT_EQUAL((int)Pool::capacity(), (int)pool.getBytesReserved());
+}
+
+void test_alloc_noGrowUsesExistingPagesOnly(void) {
+    Pool pool;
+    TEST_ASSERT_NULL(pool.alloc(64, false));  // No pages yet
+    TEST_ASSERT_NOT_NULL(pool.alloc(64));
+    TEST_ASSERT_NOT_NULL(pool.alloc(64, false));  // Fits in the page we have
+    TEST_ASSERT_NULL(pool.alloc(Pool::maxSlice(), false));
+    TEST_ASSERT_EQUAL(1, (int)pool.getPageCount());
+}
+
+// ============================================================================
+// Release
+// ============================================================================
+
+void test_release_reusesHole(void) {
+    Pool pool;
+    uint8_t* a = pool.alloc(200);
+    uint8_t* b = pool.alloc(200);
+    pool.alloc(200);
+    pool.release(b, 200);
+    uint8_t* c = pool.alloc(150);  // First fit lands in b's hole
+    TEST_ASSERT_EQUAL_PTR(b, c);
+    TEST_ASSERT_NOT_EQUAL(a, c);
+}
+
+void test_release_emptyPageGoesBackToHeap(void) {
+    Pool pool;
+    uint8_t* a = pool.alloc(500);
+    uint8_t* b = pool.alloc(500);
+    TEST_ASSERT_EQUAL(1, (int)pool.getPageCount());
+    pool.release(a, 500);
+    TEST_ASSERT_EQUAL(1, (int)pool.getPageCount());
+    pool.release(b, 500);
+    TEST_ASSERT_EQUAL(0, (int)pool.getPageCount());
+    TEST_ASSERT_EQUAL(0, (int)pool.getBytesUsed());
+}
+
+void test_release_ignoresNullAndForeignPointers(void) {
+    Pool pool;
+    uint8_t* a = pool.alloc(64);
+    uint8_t foreign[64];
+    pool.release(nullptr, 64);
+    pool.release(foreign, 64);
+    TEST_ASSERT_EQUAL(64, (int)pool.getBytesUsed());
+    pool.release(a, 64);
+    TEST_ASSERT_EQUAL(0, (int)pool.getBytesUsed());
+}
+
+void test_churn_fragmentationStaysBounded(void) {
+    // Handshake-like churn: mixed sizes, oldest freed first
+    Pool pool;
+    std::vector<std::pair<uint8_t*, size_t>> live;
+    for (int round = 0; round < 2000; round++) {
+        size_t len = 120 + (round * 37) % 180;
+        uint8_t* p = pool.alloc(len);
+        if (!p || live.size() >= 20) {
+            pool.release(live.front().first, live.front().second);
+            live.erase(live.begin());
+            if (!p) p = pool.alloc(len);
+        }
+        TEST_ASSERT_NOT_NULL(p);
+        live.push_back(std::make_pair(p, len));
+    }
+    for (auto& s : live) pool.release(s.first, s.second);
+    TEST_ASSERT_EQUAL(0, (int)pool.getPageCount());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_alloc_roundsUpToCells);
+    RUN_TEST(test_alloc_rejectsZeroAndOversize);
+    RUN_TEST(test_alloc_slicesDoNotOverlap);
+    RUN_TEST(test_alloc_exhaustionReturnsNull);
+    RUN_TEST(test_alloc_noGrowUsesExistingPagesOnly);
+    RUN_TEST(test_release_reusesHole);
+    RUN_TEST(test_release_emptyPageGoesBackToHeap);
+    RUN_TEST(test_release_ignoresNullAndForeignPointers);
+    RUN_TEST(test_churn_fragmentationStaysBounded);
+
+    return UNITY_END();
+}
@@ -0,0 +1,301 @@
+// Wardrive Format Tests
+// Tests the .wdl record framing, SSID dictionary and the text row renderers
+
+#include <unity.h>
+#include <cstring>
+#include <string>
+#include "../../src/core/wardrive_format.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static WdlObservation makeObs(void) {
+    WdlObservation o;
+    memset(&o, 0, sizeof(o));
+    o.type = WDL_REC_OBS;
+    o.flags = WDL_OBS_GPS;
+    const uint8_t bssid[6] = {0xAA, 0xBB, 0xCC, 0x01, 0x02, 0x03};
+    memcpy(o.bssid, bssid, 6);
+    o.rssi = -67;
+    o.channel = 6;
+    o.lat = wdlFixed(51.5, 1e7);
+    o.lon = wdlFixed(-0.12, 1e7);
+    o.altDm = 305;
+    o.accuracyDm = 50;
+    o.auth = 3;  // WPA2
+    o.uptimeMs = 123456;
+    return o;
+}
+
+// ============================================================================
+// Record framing
+// ============================================================================
+
+void test_recordLength_fixedRecords(void) {
+    uint8_t buf[64] = {0};
+    buf[0] = WDL_REC_OBS;
+    TEST_ASSERT_EQUAL_UINT32(sizeof(WdlObservation), wdlRecordLength(buf, sizeof(buf)));
+    buf[0] = WDL_REC_FEATURES;
+    TEST_ASSERT_EQUAL_UINT32(sizeof(WdlFeatures), wdlRecordLength(buf, sizeof(buf)));
+}
+
+void test_recordLength_ssidRecord(void) {
+    uint8_t buf[40] = {WDL_REC_SSID, 5, 1, 0, 'h', 'e', 'l', 'l', 'o'};
+    TEST_ASSERT_EQUAL_UINT32(9, wdlRecordLength(buf, sizeof(buf)));
+    buf[1] = 33;  // Longer than any SSID
+    TEST_ASSERT_EQUAL_UINT32(0, wdlRecordLength(buf, sizeof(buf)));
+}
+
+void test_recordLength_tornRecordIsZero(void) {
+    uint8_t buf[64] = {0};
+    buf[0] = WDL_REC_OBS;
+    TEST_ASSERT_EQUAL_UINT32(0, wdlRecordLength(buf, sizeof(WdlObservation) - 1));
+    uint8_t ssid[9] = {WDL_REC_SSID, 5, 1, 0, 'h', 'e', 'l', 'l', 'o'};
+    TEST_ASSERT_EQUAL_UINT32(0, wdlRecordLength(ssid, 8));
+    TEST_ASSERT_EQUAL_UINT32(0, wdlRecordLength(ssid, 2));
+    TEST_ASSERT_EQUAL_UINT32(0, wdlRecordLength(ssid, 0));
+}
+
+void test_recordLength_unknownTypeIsZero(void) {
+    uint8_t buf[64] = {0};
+    TEST_ASSERT_EQUAL_UINT32(0, wdlRecordLength(buf, sizeof(buf)));
+    buf[0] = 0xFF;
+    TEST_ASSERT_EQUAL_UINT32(0, wdlRecordLength(buf, sizeof(buf)));
+}
+
+// ============================================================================
+// Encoding helpers
+// ============================================================================
+
+void test_fixed_roundsBothSigns(void) {
+    TEST_ASSERT_EQUAL_INT32(515000000, wdlFixed(51.5, 1e7));
+    TEST_ASSERT_EQUAL_INT32(-1200000, wdlFixed(-0.12, 1e7));
+    TEST_ASSERT_EQUAL_INT32(3, wdlFixed(0.25, 10));
+    TEST_ASSERT_EQUAL_INT32(-3, wdlFixed(-0.25, 10));
+}
+
+void test_unixFromGps_knownDates(void) {
+    // 01/01/2000 00:00:00 and 29/02/2024 12:34:56
+    TEST_ASSERT_EQUAL_UINT32(946684800u, wdlUnixFromGps(10100, 1));  // 0 would read as unset
+    TEST_ASSERT_EQUAL_UINT32(1709210096u, wdlUnixFromGps(290224, 12345600));
+}
+
+void test_unixFromGps_unsetIsZero(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, wdlUnixFromGps(0, 12345600));
+    TEST_ASSERT_EQUAL_UINT32(0, wdlUnixFromGps(290224, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, wdlUnixFromGps(291324, 12345600));  // Month 13
+}
+
+// ============================================================================
+// SSID dictionary
+// ============================================================================
+
+void test_dict_assignsStableIds(void) {
+    WdlSsidDict dict;
+    TEST_ASSERT_TRUE(dict.init(64));
+    bool isNew;
+    uint16_t a = dict.lookup("home", 4, isNew);
+    TEST_ASSERT_TRUE(isNew);
+    uint16_t b = dict.lookup("cafe", 4, isNew);
+    TEST_ASSERT_TRUE(isNew);
+    TEST_ASSERT_NOT_EQUAL(a, b);
+    TEST_ASSERT_EQUAL_UINT16(a, dict.lookup("home", 4, isNew));
+    TEST_ASSERT_FALSE(isNew);
+    TEST_ASSERT_EQUAL_UINT16(2, dict.idsUsed());
+}
+
+void test_dict_emptySsidIsNone(void) {
+    WdlSsidDict dict;
+    TEST_ASSERT_TRUE(dict.init(64));
+    bool isNew = true;
+    TEST_ASSERT_EQUAL_UINT16(WDL_SSID_NONE, dict.lookup("", 0, isNew));
+    TEST_ASSERT_FALSE(isNew);
+}
+
+void test_dict_resetStartsOver(void) {
+    WdlSsidDict dict;
+    TEST_ASSERT_TRUE(dict.init(64));
+    bool isNew;
+    uint16_t first = dict.lookup("home", 4, isNew);
+    dict.lookup("cafe", 4, isNew);
+    dict.reset();
+    TEST_ASSERT_EQUAL_UINT16(first, dict.lookup("cafe", 4, isNew));
+    TEST_ASSERT_TRUE(isNew);
+}
+
+void test_dict_fullKeepsIssuingIds(void) {
+    WdlSsidDict dict;
+    TEST_ASSERT_TRUE(dict.init(16));
+    bool isNew;
+    char name[8];
+    for (int i = 0; i < 20; i++) {
+        snprintf(name, sizeof(name), "n%d", i);
+        TEST_ASSERT_EQUAL_UINT16(i + 1, dict.lookup(name, strlen(name), isNew));
+        TEST_ASSERT_TRUE(isNew);
+    }
+    // Remembered ones still resolve; forgotten ones get a fresh definition
+    TEST_ASSERT_EQUAL_UINT16(1, dict.lookup("n0", 2, isNew));
+    TEST_ASSERT_FALSE(isNew);
+    dict.lookup("n19", 3, isNew);
+    TEST_ASSERT_TRUE(isNew);
+}
+
+void test_dict_rejectsBadSlotCount(void) {
+    WdlSsidDict dict;
+    TEST_ASSERT_FALSE(dict.init(100));
+    TEST_ASSERT_FALSE(dict.init(8));
+    // Without a table every SSID is new - still a valid log
+    bool isNew;
+    uint16_t a = dict.lookup("home", 4, isNew);
+    TEST_ASSERT_TRUE(isNew);
+    TEST_ASSERT_NOT_EQUAL(a, dict.lookup("home", 4, isNew));
+}
+
+// ============================================================================
+// Text rendering
+// ============================================================================
+
+void test_authTables_matchEspEnum(void) {
+    TEST_ASSERT_EQUAL_STRING("OPEN", wdlAuthName(0));
+    TEST_ASSERT_EQUAL_STRING("WPA2", wdlAuthName(3));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", wdlAuthName(5));  // WPA2 Enterprise
+    TEST_ASSERT_EQUAL_STRING("WPA2/WPA3", wdlAuthName(7));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", wdlAuthName(200));
+    TEST_ASSERT_EQUAL_STRING("[WPA3-SAE][ESS]", wdlAuthWigle(6));
+    TEST_ASSERT_EQUAL_STRING("[ESS]", wdlAuthWigle(200));
+}
+
+void test_csvField_escapesQuotesAndControls(void) {
+    char out[80];
+    TEST_ASSERT_EQUAL_UINT32(9, wdlCsvField(out, "a\"b\"\nc"));
+    TEST_ASSERT_EQUAL_STRING("\"a\"\"b\"\"c\"", out);
+}
+
+void test_csvField_keepsUtf8(void) {
+    // Signed char must not turn 0xC3 0xA9 into "control characters"
+    char out[80];
+    TEST_ASSERT_EQUAL_UINT32(7, wdlCsvField(out, "caf\xC3\xA9"));
+    TEST_ASSERT_EQUAL_STRING("\"caf\xC3\xA9\"", out);
+}
+
+void test_csvField_capsAt32Chars(void) {
+    char out[80];
+    char ssid[40];
+    memset(ssid, 'x', 39);
+    ssid[39] = '\0';
+    TEST_ASSERT_EQUAL_UINT32(34, wdlCsvField(out, ssid));
+}
+
+void test_wigleRow_gpsTime(void) {
+    WdlObservation o = makeObs();
+    o.time = wdlUnixFromGps(290224, 12345600);
+    char row[256];
+    size_t n = wdlWigleRow(row, sizeof(row), o, "home");
+    TEST_ASSERT_EQUAL_UINT32(strlen(row), n);
+    TEST_ASSERT_EQUAL_STRING(
+        "AA:BB:CC:01:02:03,\"home\",[WPA2-PSK-CCMP][ESS],2024-02-29 12:34:56,6,2437,-67,"
+        "51.500000,-0.120000,30.5,5.0,,,WIFI\r\n", row);
+}
+
+void test_wigleRow_noGpsTimeFallsBack(void) {
+    WdlObservation o = makeObs();
+    o.channel = 14;
+    o.accuracyDm = 0;
+    char row[256];
+    wdlWigleRow(row, sizeof(row), o, "");
+    TEST_ASSERT_EQUAL_STRING(
+        "AA:BB:CC:01:02:03,\"\",[WPA2-PSK-CCMP][ESS],1970-01-01 00:00:03,14,2484,-67,"
+        "51.500000,-0.120000,30.5,10.0,,,WIFI\r\n", row);
+}
+
+void test_wigleRow_dateRoundTrip(void) {
+    // Every day of a leap-year span renders back as the GPS date it came from
+    WdlObservation o = makeObs();
+    char row[256];
+    static const uint8_t DAYS[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    for (unsigned m = 1; m <= 12; m++) {
+        for (unsigned d = 1; d <= DAYS[m - 1]; d++) {
+            o.time = wdlUnixFromGps(d * 10000 + m * 100 + 24, 23595900);
+            wdlWigleRow(row, sizeof(row), o, "x");
+            char want[32];
+            snprintf(want, sizeof(want), ",2024-%02u-%02u 23:59:59,", m, d);
+            TEST_ASSERT_NOT_NULL(strstr(row, want));
+        }
+    }
+}
+
+void test_csvRow_format(void) {
+    WdlObservation o = makeObs();
+    char row[256];
+    wdlCsvRow(row, sizeof(row), o, "home");
+    TEST_ASSERT_EQUAL_STRING("AA:BB:CC:01:02:03,\"home\",-67,6,WPA2,51.500000,-0.120000,30.5,123456\n", row);
+}
+
+void test_mlRow_noGpsZeroesPosition(void) {
+    WdlObservation o = makeObs();
+    o.flags = WDL_OBS_FEATURES;
+    o.label = 4;
+    float values[WDL_ML_VALUES] = {0};
+    values[0] = -67.0f;
+    values[2] = 28.5f;
+    char row[640];
+    size_t n = wdlMlRow(row, sizeof(row), o, "home", values);
+    TEST_ASSERT_EQUAL_UINT32(strlen(row), n);
+    std::string s(row);
+    TEST_ASSERT_EQUAL(0u, s.find("AA:BB:CC:01:02:03,\"home\",-67.0000,0.0000,28.5000,"));
+    TEST_ASSERT_TRUE(s.size() > 20 && s.compare(s.size() - 21, 21, ",4,0.000000,0.000000\n") == 0);
+}
+
+void test_rows_tooSmallBufferIsZero(void) {
+    WdlObservation o = makeObs();
+    char row[60];
+    TEST_ASSERT_EQUAL_UINT32(0, wdlWigleRow(row, sizeof(row), o, "home"));
+    TEST_ASSERT_EQUAL_UINT32(0, wdlCsvRow(row, 40, o, "home"));
+}
+
+void test_wigleHeader_usesRelease(void) {
+    WdlHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    char out[512];
+    wdlWigleHeader(out, sizeof(out), hdr);
+    TEST_ASSERT_EQUAL(0, strncmp(out, "WigleWifi-1.6,appRelease=0.1.x,", 31));
+    memcpy(hdr.appRelease, "0123456789ABCDEF", 16);  // Not NUL-terminated
+    wdlWigleHeader(out, sizeof(out), hdr);
+    TEST_ASSERT_EQUAL(0, strncmp(out, "WigleWifi-1.6,appRelease=0123456789ABCDEF,", 42));
+    TEST_ASSERT_NOT_NULL(strstr(out, "\nMAC,SSID,AuthMode,"));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_recordLength_fixedRecords);
+    RUN_TEST(test_recordLength_ssidRecord);
+    RUN_TEST(test_recordLength_tornRecordIsZero);
+    RUN_TEST(test_recordLength_unknownTypeIsZero);
+    RUN_TEST(test_fixed_roundsBothSigns);
+    RUN_TEST(test_unixFromGps_knownDates);
+    RUN_TEST(test_unixFromGps_unsetIsZero);
+    RUN_TEST(test_dict_assignsStableIds);
+    RUN_TEST(test_dict_emptySsidIsNone);
+    RUN_TEST(test_dict_resetStartsOver);
+    RUN_TEST(test_dict_fullKeepsIssuingIds);
+    RUN_TEST(test_dict_rejectsBadSlotCount);
+    RUN_TEST(test_authTables_matchEspEnum);
+    RUN_TEST(test_csvField_escapesQuotesAndControls);
+    RUN_TEST(test_csvField_keepsUtf8);
+    RUN_TEST(test_csvField_capsAt32Chars);
+    RUN_TEST(test_wigleRow_gpsTime);
+    RUN_TEST(test_wigleRow_noGpsTimeFallsBack);
+    RUN_TEST(test_wigleRow_dateRoundTrip);
+    RUN_TEST(test_csvRow_format);
+    RUN_TEST(test_mlRow_noGpsZeroesPosition);
+    RUN_TEST(test_rows_tooSmallBufferIsZero);
+    RUN_TEST(test_wigleHeader_usesRelease);
+
+    return UNITY_END();
+}
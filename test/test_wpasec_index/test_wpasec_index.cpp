@@ -0,0 +1,435 @@
+// WPA-SEC Index Tests
+// Tests the on-SD results index format, potfile parsing and paged lookups
+
+#include <unity.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../../src/web/wpasec_index.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+// In-memory index file
+struct MemFile {
+    std::vector<uint8_t> bytes;
+    bool fail;
+};
+
+static bool memRead(uint32_t offset, uint8_t* buf, size_t len, void* ctx) {
+    MemFile* f = (MemFile*)ctx;
+    if (f->fail || offset + len > f->bytes.size()) return false;
+    memcpy(buf, f->bytes.data() + offset, len);
+    return true;
+}
+
+static void makeKey(uint32_t n, uint8_t* out) {
+    // Spread over the key space, shared OUI like a real neighbourhood
+    uint32_t x = n * 2654435761u;
+    const uint8_t k[6] = {0x00, 0x11, 0x22, (uint8_t)(x >> 24), (uint8_t)(x >> 16), (uint8_t)(x >> 8)};
+    memcpy(out, k, 6);
+}
+
+// Records 0, 2, 4 .. 2*(n-1) as an index image (odd keys stay absent)
+static void buildIndex(MemFile& f, uint32_t n) {
+    std::vector<WpaSecRecord> recs;
+    uint32_t cap = n + 1;
+    recs.resize(cap);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        WpaSecRecord r;
+        memset(&r, 0, sizeof(r));
+        makeKey(2 * i, r.bssid);
+        r.flags = WPASEC_FLAG_UPLOADED;
+        r.strOffset = 2 * i;
+        TEST_ASSERT_TRUE(wpasecBatchInsert(recs.data(), count, cap, r));
+    }
+    WpaSecIndexHeader hdr = {WPASEC_INDEX_MAGIC, WPASEC_INDEX_VERSION, sizeof(WpaSecRecord), count, 0};
+    f.fail = false;
+    f.bytes.assign((const uint8_t*)&hdr, (const uint8_t*)&hdr + sizeof(hdr));
+    f.bytes.insert(f.bytes.end(), (const uint8_t*)recs.data(), (const uint8_t*)(recs.data() + count));
+}
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+void test_parseBssid_acceptsCommonForms(void) {
+    uint8_t b[6];
+    const uint8_t want[6] = {0xAA, 0xBB, 0xCC, 0x11, 0x22, 0x33};
+    TEST_ASSERT_TRUE(wpasecParseBssid("AABBCC112233", 12, b));
+    TEST_ASSERT_EQUAL_MEMORY(want, b, 6);
+    TEST_ASSERT_TRUE(wpasecParseBssid("aa:bb:cc:11:22:33", 17, b));
+    TEST_ASSERT_EQUAL_MEMORY(want, b, 6);
+    TEST_ASSERT_TRUE(wpasecParseBssid("aa-bb-cc-11-22-33", 17, b));
+    TEST_ASSERT_EQUAL_MEMORY(want, b, 6);
+}
+
+void test_parseBssid_rejectsJunk(void) {
+    uint8_t b[6];
+    TEST_ASSERT_FALSE(wpasecParseBssid("AABBCC11223", 11, b));
+    TEST_ASSERT_FALSE(wpasecParseBssid("AABBCC1122334", 13, b));
+    TEST_ASSERT_FALSE(wpasecParseBssid("AABBCC11223G", 12, b));
+    TEST_ASSERT_FALSE(wpasecParseBssid("AABBCC112233_hs", 15, b));
+    TEST_ASSERT_FALSE(wpasecParseBssid("", 0, b));
+}
+
+void test_parsePotLine_splitsOnLastColon(void) {
+    const char* line = "e848b8f87e98:809d6557b0be:cafe:wifi:hunter2\r";
+    uint8_t b[6];
+    const char *ssid, *pass;
+    size_t ssidLen, passLen;
+    TEST_ASSERT_TRUE(wpasecParsePotLine(line, strlen(line), b, ssid, ssidLen, pass, passLen));
+    const uint8_t want[6] = {0xE8, 0x48, 0xB8, 0xF8, 0x7E, 0x98};
+    TEST_ASSERT_EQUAL_MEMORY(want, b, 6);
+    TEST_ASSERT_EQUAL(9, ssidLen);
+    TEST_ASSERT_EQUAL_MEMORY("cafe:wifi", ssid, 9);
+    TEST_ASSERT_EQUAL(7, passLen);
+    TEST_ASSERT_EQUAL_MEMORY("hunter2", pass, 7);
+}
+
+void test_parsePotLine_rejectsMalformed(void) {
+    uint8_t b[6];
+    const char *ssid, *pass;
+    size_t ssidLen, passLen;
+    const char* bad[] = {
+        "e848b8f87e98:809d6557b0be:ssid:",          // No password
+        "e848b8f87e98:809d6557b0be::pass",          // No SSID
+        "e848b8f87e98:809d6557b0be:nopassword",     // One field
+        "e848b8f87e9Z:809d6557b0be:ssid:pass",      // Bad BSSID
+        "e848b8f87e98-809d6557b0be:ssid:pass",      // Bad separator
+        "<html><body>error</body></html>",
+        "",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        TEST_ASSERT_FALSE(wpasecParsePotLine(bad[i], strlen(bad[i]), b, ssid, ssidLen, pass, passLen));
+    }
+    // Longer than any SSID can be
+    char longLine[128];
+    snprintf(longLine, sizeof(longLine), "e848b8f87e98:809d6557b0be:%s:pass", "0123456789012345678901234567890123");
+    TEST_ASSERT_FALSE(wpasecParsePotLine(longLine, strlen(longLine), b, ssid, ssidLen, pass, passLen));
+}
+
+void test_parseCacheLine_readsLegacyFormat(void) {
+    const char* line = "AABBCC112233:Home:Net:pa:ss";
+    uint8_t b[6];
+    const char *ssid, *pass;
+    size_t ssidLen, passLen;
+    TEST_ASSERT_TRUE(wpasecParseCacheLine(line, strlen(line), b, ssid, ssidLen, pass, passLen));
+    TEST_ASSERT_EQUAL(11, ssidLen);
+    TEST_ASSERT_EQUAL_MEMORY("Home:Net:pa", ssid, 11);
+    TEST_ASSERT_EQUAL(2, passLen);
+    TEST_ASSERT_FALSE(wpasecParseCacheLine("AABBCC112233", 12, b, ssid, ssidLen, pass, passLen));
+}
+
+// ============================================================================
+// Streaming potfile parser
+// ============================================================================
+
+struct Collected {
+    std::vector<std::string> lines;  // "bssidhex|ssid|pass"
+};
+
+static void collectEntry(const uint8_t* bssid, const char* ssid, size_t ssidLen,
+                         const char* pass, size_t passLen, void* ctx) {
+    char hex[13];
+    snprintf(hex, sizeof(hex), "%02x%02x%02x%02x%02x%02x", bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
+    ((Collected*)ctx)->lines.push_back(std::string(hex) + "|" + std::string(ssid, ssidLen) + "|" +
+                                       std::string(pass, passLen));
+}
+
+static const char* POTFILE =
+    "e848b8f87e98:809d6557b0be:pxs.pl_4586:79768559\r\n"
+    "\r\n"
+    "001122334455:66778899aabb:a:b:c:password1\n"
+    "not a potfile line\n"
+    "0011223344ff:66778899aabb:last:nonl";
+
+void test_potParser_anyChunking_sameEntries(void) {
+    Collected whole;
+    WpaSecPotParser p;
+    p.begin(collectEntry, &whole);
+    p.feed((const uint8_t*)POTFILE, strlen(POTFILE));
+    p.finish();
+    TEST_ASSERT_EQUAL(3, whole.lines.size());
+    TEST_ASSERT_EQUAL_STRING("e848b8f87e98|pxs.pl_4586|79768559", whole.lines[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("001122334455|a:b:c|password1", whole.lines[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("0011223344ff|last|nonl", whole.lines[2].c_str());
+    TEST_ASSERT_EQUAL_UINT32(3, p.entries());
+    TEST_ASSERT_EQUAL_UINT32(1, p.rejected());
+
+    for (size_t chunk = 1; chunk <= 17; chunk++) {
+        Collected c;
+        p.begin(collectEntry, &c);
+        for (size_t at = 0; at < strlen(POTFILE); at += chunk) {
+            size_t n = strlen(POTFILE) - at < chunk ? strlen(POTFILE) - at : chunk;
+            p.feed((const uint8_t*)POTFILE + at, n);
+        }
+        p.finish();
+        TEST_ASSERT_TRUE(c.lines == whole.lines);
+    }
+}
+
+void test_potParser_skipsOverlongLines(void) {
+    std::string body = "001122334455:66778899aabb:";
+    body += std::string(2000, 'x');
+    body += ":pass\n001122334466:66778899aabb:ok:fine\n";
+    Collected c;
+    WpaSecPotParser p;
+    p.begin(collectEntry, &c);
+    p.feed((const uint8_t*)body.data(), body.size());
+    p.finish();
+    TEST_ASSERT_EQUAL(1, c.lines.size());
+    TEST_ASSERT_EQUAL_STRING("001122334466|ok|fine", c.lines[0].c_str());
+    TEST_ASSERT_EQUAL_UINT32(1, p.rejected());
+}
+
+void test_potParser_longestValidLineFits(void) {
+    std::string line = "001122334455:66778899aabb:" + std::string(WPASEC_SSID_MAX, 's') + ":" +
+                       std::string(WPASEC_PASS_MAX, 'p') + "\r\n";
+    Collected c;
+    WpaSecPotParser p;
+    p.begin(collectEntry, &c);
+    p.feed((const uint8_t*)line.data(), line.size());
+    p.finish();
+    TEST_ASSERT_EQUAL(1, c.lines.size());
+}
+
+// ============================================================================
+// Records and batches
+// ============================================================================
+
+void test_stringHash_separatesFields(void) {
+    uint16_t a = wpasecStringHash("ab", 2, "c", 1);
+    uint16_t b = wpasecStringHash("a", 1, "bc", 2);
+    TEST_ASSERT_NOT_EQUAL(a, b);
+    TEST_ASSERT_EQUAL_UINT16(a, wpasecStringHash("ab", 2, "c", 1));
+}
+
+void test_combine_keepsFlagsTakesNewestCrack(void) {
+    WpaSecRecord a, b;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    a.flags = WPASEC_FLAG_CRACKED;
+    a.strOffset = 10;
+    b.flags = WPASEC_FLAG_UPLOADED;
+    b.strOffset = 99;
+    wpasecCombine(a, b);
+    TEST_ASSERT_EQUAL_UINT8(WPASEC_FLAG_CRACKED | WPASEC_FLAG_UPLOADED, a.flags);
+    TEST_ASSERT_EQUAL_UINT32(10, a.strOffset);  // An upload mark doesn't touch strings
+
+    b.flags = WPASEC_FLAG_CRACKED;
+    b.strOffset = 50;
+    wpasecCombine(a, b);
+    TEST_ASSERT_EQUAL_UINT8(WPASEC_FLAG_CRACKED | WPASEC_FLAG_UPLOADED, a.flags);
+    TEST_ASSERT_EQUAL_UINT32(50, a.strOffset);
+}
+
+void test_batchInsert_sortsAndDedupes(void) {
+    WpaSecRecord batch[64];
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+        WpaSecRecord r;
+        memset(&r, 0, sizeof(r));
+        makeKey(i % 40, r.bssid);
+        r.flags = WPASEC_FLAG_UPLOADED;
+        TEST_ASSERT_TRUE(wpasecBatchInsert(batch, n, 64, r));
+    }
+    TEST_ASSERT_EQUAL_UINT32(40, n);
+    for (uint32_t i = 1; i < n; i++) {
+        TEST_ASSERT_TRUE(memcmp(batch[i - 1].bssid, batch[i].bssid, 6) < 0);
+    }
+}
+
+void test_batchInsert_fullRejectsOnlyNewKeys(void) {
+    WpaSecRecord batch[4];
+    uint32_t n = 0;
+    WpaSecRecord r;
+    memset(&r, 0, sizeof(r));
+    for (uint32_t i = 0; i < 4; i++) {
+        makeKey(i, r.bssid);
+        TEST_ASSERT_TRUE(wpasecBatchInsert(batch, n, 4, r));
+    }
+    makeKey(2, r.bssid);
+    r.flags = WPASEC_FLAG_CRACKED;
+    TEST_ASSERT_TRUE(wpasecBatchInsert(batch, n, 4, r));
+    makeKey(9, r.bssid);
+    TEST_ASSERT_FALSE(wpasecBatchInsert(batch, n, 4, r));
+    TEST_ASSERT_EQUAL_UINT32(4, n);
+}
+
+// ============================================================================
+// Paged lookups
+// ============================================================================
+
+void test_reader_emptyAndDetached(void) {
+    WpaSecIndexReader r;
+    uint8_t key[6];
+    makeKey(1, key);
+    WpaSecRecord out;
+    TEST_ASSERT_FALSE(r.find(key, out));
+    uint32_t pos = 99;
+    TEST_ASSERT_TRUE(r.lowerBound(key, pos));
+    TEST_ASSERT_EQUAL_UINT32(0, pos);
+}
+
+void test_reader_findsEveryKeyAndNoOthers(void) {
+    MemFile f;
+    buildIndex(f, 1000);  // 31.25 pages: last one partial
+    WpaSecIndexReader r;
+    r.attach(memRead, &f, 1000);
+    for (uint32_t i = 0; i < 2000; i++) {
+        uint8_t key[6];
+        makeKey(i, key);
+        WpaSecRecord out;
+        bool found = r.find(key, out);
+        if (i % 2 == 0) {
+            TEST_ASSERT_TRUE(found);
+            TEST_ASSERT_EQUAL_UINT32(i, out.strOffset);
+        } else {
+            TEST_ASSERT_FALSE(found);
+        }
+    }
+}
+
+void test_reader_lowerBoundAtEdges(void) {
+    MemFile f;
+    buildIndex(f, 64);
+    WpaSecIndexReader r;
+    r.attach(memRead, &f, 64);
+    uint32_t pos;
+    const uint8_t low[6] = {0, 0, 0, 0, 0, 0};
+    const uint8_t high[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    TEST_ASSERT_TRUE(r.lowerBound(low, pos));
+    TEST_ASSERT_EQUAL_UINT32(0, pos);
+    TEST_ASSERT_TRUE(r.lowerBound(high, pos));
+    TEST_ASSERT_EQUAL_UINT32(64, pos);
+
+    // Just past the last key of the first page lands on the second page
+    WpaSecRecord last;
+    TEST_ASSERT_TRUE(r.record(WPASEC_PAGE_RECORDS - 1, last));
+    last.bssid[5]++;
+    TEST_ASSERT_TRUE(r.lowerBound(last.bssid, pos));
+    TEST_ASSERT_EQUAL_UINT32(WPASEC_PAGE_RECORDS, pos);
+}
+
+void test_reader_pageReadsAreLogarithmic(void) {
+    const uint32_t N = 20000;  // 625 pages, 320KB on SD
+    MemFile f;
+    buildIndex(f, N);
+    WpaSecIndexReader r;
+    r.attach(memRead, &f, N);
+    uint32_t lookups = 0;
+    for (uint32_t i = 0; i < 2 * N; i += 37) {
+        uint8_t key[6];
+        makeKey(i, key);
+        WpaSecRecord out;
+        TEST_ASSERT_EQUAL(i % 2 == 0, r.find(key, out));
+        lookups++;
+    }
+    // log2(625) ~ 10 steps, 8 of them remembered: at most 2 more + the
+    // page itself. Warm-up (filling the top keys) is amortized.
+    TEST_ASSERT_TRUE(r.pageReads() <= lookups * 3 + 255);
+
+    // Same key again: all cached
+    uint8_t key[6];
+    makeKey(0, key);
+    WpaSecRecord out;
+    r.find(key, out);
+    uint32_t before = r.pageReads();
+    TEST_ASSERT_TRUE(r.find(key, out));
+    TEST_ASSERT_EQUAL_UINT32(before, r.pageReads());
+}
+
+void test_reader_smallIndex_onePageReadPerLookup(void) {
+    const uint32_t N = 8000;  // 250 pages: whole search tree fits the top keys
+    MemFile f;
+    buildIndex(f, N);
+    WpaSecIndexReader r;
+    r.attach(memRead, &f, N);
+    for (uint32_t i = 0; i < 2 * N; i += 3) {  // Warm up
+        uint8_t key[6];
+        makeKey(i, key);
+        WpaSecRecord out;
+        r.find(key, out);
+    }
+    uint32_t before = r.pageReads();
+    uint32_t lookups = 0;
+    for (uint32_t i = 1; i < 2 * N; i += 7, lookups++) {
+        uint8_t key[6];
+        makeKey(i, key);
+        WpaSecRecord out;
+        r.find(key, out);
+    }
+    TEST_ASSERT_TRUE(r.pageReads() - before <= lookups);
+}
+
+void test_reader_invalidateForgetsTopKeys(void) {
+    MemFile f;
+    buildIndex(f, 3000);
+    WpaSecIndexReader r;
+    r.attach(memRead, &f, 3000);
+    uint8_t key[6];
+    makeKey(100, key);
+    WpaSecRecord out;
+    TEST_ASSERT_TRUE(r.find(key, out));
+
+    // Same size, different keys: stale top keys would misroute the search
+    for (size_t off = sizeof(WpaSecIndexHeader); off < f.bytes.size(); off += sizeof(WpaSecRecord)) {
+        f.bytes[off] = 0x7A;
+    }
+    r.invalidate();
+    TEST_ASSERT_FALSE(r.find(key, out));
+    key[0] = 0x7A;
+    TEST_ASSERT_TRUE(r.find(key, out));
+    TEST_ASSERT_EQUAL_UINT32(100, out.strOffset);
+}
+
+void test_reader_readErrorIsNotFound(void) {
+    MemFile f;
+    buildIndex(f, 200);
+    WpaSecIndexReader r;
+    r.attach(memRead, &f, 200);
+    f.fail = true;
+    uint8_t key[6];
+    makeKey(0, key);
+    WpaSecRecord out;
+    TEST_ASSERT_FALSE(r.find(key, out));
+    uint32_t pos;
+    TEST_ASSERT_FALSE(r.lowerBound(key, pos));
+
+    // Recovers once reads work again - the failed page wasn't cached
+    f.fail = false;
+    TEST_ASSERT_TRUE(r.find(key, out));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_parseBssid_acceptsCommonForms);
+    RUN_TEST(test_parseBssid_rejectsJunk);
+    RUN_TEST(test_parsePotLine_splitsOnLastColon);
+    RUN_TEST(test_parsePotLine_rejectsMalformed);
+    RUN_TEST(test_parseCacheLine_readsLegacyFormat);
+    RUN_TEST(test_potParser_anyChunking_sameEntries);
+    RUN_TEST(test_potParser_skipsOverlongLines);
+    RUN_TEST(test_potParser_longestValidLineFits);
+    RUN_TEST(test_stringHash_separatesFields);
+    RUN_TEST(test_combine_keepsFlagsTakesNewestCrack);
+    RUN_TEST(test_batchInsert_sortsAndDedupes);
+    RUN_TEST(test_batchInsert_fullRejectsOnlyNewKeys);
+    RUN_TEST(test_reader_emptyAndDetached);
+    RUN_TEST(test_reader_findsEveryKeyAndNoOthers);
+    RUN_TEST(test_reader_lowerBoundAtEdges);
+    RUN_TEST(test_reader_pageReadsAreLogarithmic);
+    RUN_TEST(test_reader_smallIndex_onePageReadPerLookup);
+    RUN_TEST(test_reader_invalidateForgetsTopKeys);
+    RUN_TEST(test_reader_readErrorIsNotFound);
+
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+// ZIP Stream Tests
+// Tests the record layout behind the file server's folder ZIP download
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include <string>
+#include "../../src/core/crc32.h"
+#include "../../src/web/zip_stream.h"
+
+void setUp(void) {
+    // No setup needed
+}
+
+void tearDown(void) {
+    // No teardown needed
+}
+
+static uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t get32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+struct TestFile {
+    std::string name;
+    std::string data;
+};
+
+// Assemble an archive the way the file server streams it
+static std::vector<uint8_t> buildArchive(const std::vector<TestFile>& files) {
+    std::vector<uint8_t> out;
+    std::vector<uint32_t> offsets, crcs;
+    uint8_t buf[512];
+    for (const TestFile& f : files) {
+        offsets.push_back(out.size());
+        size_t n = zipLocalHeader(buf, f.name.c_str(), f.name.size(), 0x6000, 0x5821);
+        out.insert(out.end(), buf, buf + n);
+        // CRC in uneven pieces, as reads come back from the card
+        uint32_t crc = 0;
+        for (size_t at = 0; at < f.data.size(); at += 7) {
+            size_t len = f.data.size() - at < 7 ? f.data.size() - at : 7;
+            crc = crc32Update(crc, (const uint8_t*)f.data.data() + at, len);
+        }
+        crcs.push_back(crc);
+        out.insert(out.end(), f.data.begin(), f.data.end());
+        n = zipDataDescriptor(buf, crc, f.data.size());
+        out.insert(out.end(), buf, buf + n);
+    }
+    uint32_t central = out.size();
+    for (size_t i = 0; i < files.size(); i++) {
+        size_t n = zipCentralHeader(buf, files[i].name.c_str(), files[i].name.size(), crcs[i],
+                                    files[i].data.size(), 0x6000, 0x5821, offsets[i]);
+        out.insert(out.end(), buf, buf + n);
+    }
+    size_t n = zipEndRecord(buf, files.size(), out.size() - central, central);
+    out.insert(out.end(), buf, buf + n);
+    return out;
+}
+
+// ============================================================================
+// CRC-32
+// ============================================================================
+
+void test_crc32_checkValue(void) {
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Update(0, (const uint8_t*)"123456789", 9));
+}
+
+void test_crc32_emptyIsZero(void) {
+    TEST_ASSERT_EQUAL_HEX32(0, crc32Update(0, nullptr, 0));
+}
+
+void test_crc32_knownStrings(void) {
+    const char* fox = "The quick brown fox jumps over the lazy dog";
+    TEST_ASSERT_EQUAL_HEX32(0x414FA339, crc32Update(0, (const uint8_t*)fox, strlen(fox)));
+    uint8_t zeros[32] = {0};
+    TEST_ASSERT_EQUAL_HEX32(0x190A55AD, crc32Update(0, zeros, sizeof(zeros)));
+}
+
+void test_crc32_continuesAcrossChunks(void) {
+    uint8_t data[1000];
+    for (int i = 0; i < 1000; i++) data[i] = (uint8_t)(i * 31 + 7);
+    uint32_t whole = crc32Update(0, data, sizeof(data));
+    uint32_t crc = 0;
+    crc = crc32Update(crc, data, 1);
+    crc = crc32Update(crc, data + 1, 510);
+    crc = crc32Update(crc, data + 511, 489);
+    TEST_ASSERT_EQUAL_HEX32(whole, crc);
+}
+
+// ============================================================================
+// DOS timestamps
+// ============================================================================
+
+void test_dosTime_knownDate(void) {
+    // 2024-02-29 13:45:31 UTC
+    uint16_t t, d;
+    zipDosTime(1709214331, t, d);
+    TEST_ASSERT_EQUAL_HEX16((13 << 11) | (45 << 5) | 15, t);
+    TEST_ASSERT_EQUAL_HEX16(((2024 - 1980) << 9) | (2 << 5) | 29, d);
+}
+
+void test_dosTime_clampsBefore1980(void) {
+    uint16_t t, d;
+    zipDosTime(0, t, d);
+    TEST_ASSERT_EQUAL_HEX16(0, t);
+    TEST_ASSERT_EQUAL_HEX16((1 << 5) | 1, d);
+}
+
+void test_dosTime_endOfYear(void) {
+    // 1999-12-31 23:59:58
+    uint16_t t, d;
+    zipDosTime(946684798, t, d);
+    TEST_ASSERT_EQUAL_HEX16((23 << 11) | (59 << 5) | 29, t);
+    TEST_ASSERT_EQUAL_HEX16((19 << 9) | (12 << 5) | 31, d);
+}
+
+// ============================================================================
+// Records
+// ============================================================================
+
+void test_localHeader_layout(void) {
+    uint8_t buf[64];
+    size_t n = zipLocalHeader(buf, "a/b.pcap", 8, 0x1234, 0x5678);
+    TEST_ASSERT_EQUAL(ZIP_LOCAL_HEADER_SIZE + 8, n);
+    TEST_ASSERT_EQUAL_HEX32(0x04034B50, get32(buf));
+    TEST_ASSERT_EQUAL_HEX16(ZIP_FLAG_DESCRIPTOR | ZIP_FLAG_UTF8, get16(buf + 6));
+    TEST_ASSERT_EQUAL_HEX16(0, get16(buf + 8));           // STORE
+    TEST_ASSERT_EQUAL_HEX16(0x1234, get16(buf + 10));
+    TEST_ASSERT_EQUAL_HEX16(0x5678, get16(buf + 12));
+    TEST_ASSERT_EQUAL_HEX32(0, get32(buf + 14));          // CRC deferred
+    TEST_ASSERT_EQUAL_HEX32(0, get32(buf + 18));
+    TEST_ASSERT_EQUAL(8, get16(buf + 26));
+    TEST_ASSERT_EQUAL(0, get16(buf + 28));                // No extra field
+    TEST_ASSERT_EQUAL_MEMORY("a/b.pcap", buf + 30, 8);
+}
+
+void test_centralHeader_layout(void) {
+    uint8_t buf[64];
+    size_t n = zipCentralHeader(buf, "x", 1, 0xDEADBEEF, 4096, 1, 2, 0x010203);
+    TEST_ASSERT_EQUAL(ZIP_CENTRAL_HEADER_SIZE + 1, n);
+    TEST_ASSERT_EQUAL_HEX32(0x02014B50, get32(buf));
+    TEST_ASSERT_EQUAL_HEX32(0xDEADBEEF, get32(buf + 16));
+    TEST_ASSERT_EQUAL_UINT32(4096, get32(buf + 20));
+    TEST_ASSERT_EQUAL_UINT32(4096, get32(buf + 24));
+    TEST_ASSERT_EQUAL_UINT32(0x010203, get32(buf + 42));
+    TEST_ASSERT_EQUAL('x', buf[46]);
+}
+
+void test_archiveSize_matchesBuiltArchive(void) {
+    std::vector<TestFile> files = {
+        {"loot/a.pcap", std::string(1000, 'a')},
+        {"loot/sub/b.22000", "WPA*02*..."},
+        {"loot/empty.txt", ""},
+    };
+    std::vector<uint8_t> zip = buildArchive(files);
+    uint64_t names = 0, data = 0;
+    for (const TestFile& f : files) {
+        names += f.name.size();
+        data += f.data.size();
+    }
+    TEST_ASSERT_EQUAL_UINT32(zip.size(), zipArchiveSize(files.size(), names, data));
+}
+
+void test_archiveSize_refusesZip64(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, zipArchiveSize(70000, 0, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, zipArchiveSize(1, 10, 0xFFFFFFF0ull));
+    TEST_ASSERT_EQUAL_UINT32(ZIP_END_RECORD_SIZE, zipArchiveSize(0, 0, 0));
+}
+
+void test_archive_centralDirectoryPointsAtEntries(void) {
+    std::vector<TestFile> files = {
+        {"d/one", "first file"},
+        {"d/two", std::string(300, 'z')},
+    };
+    std::vector<uint8_t> zip = buildArchive(files);
+    const uint8_t* end = zip.data() + zip.size() - ZIP_END_RECORD_SIZE;
+    TEST_ASSERT_EQUAL_HEX32(0x06054B50, get32(end));
+    TEST_ASSERT_EQUAL(2, get16(end + 10));
+    uint32_t cdSize = get32(end + 12);
+    uint32_t cdOffset = get32(end + 16);
+    TEST_ASSERT_EQUAL_UINT32(zip.size() - ZIP_END_RECORD_SIZE, cdOffset + cdSize);
+
+    const uint8_t* cd = zip.data() + cdOffset;
+    for (size_t i = 0; i < files.size(); i++) {
+        TEST_ASSERT_EQUAL_HEX32(0x02014B50, get32(cd));
+        uint16_t nameLen = get16(cd + 28);
+        uint32_t local = get32(cd + 42);
+        uint32_t size = get32(cd + 24);
+        uint32_t crc = get32(cd + 16);
+        TEST_ASSERT_EQUAL_HEX32(0x04034B50, get32(zip.data() + local));
+        TEST_ASSERT_EQUAL_MEMORY(files[i].name.data(), zip.data() + local + 30, nameLen);
+        const uint8_t* data = zip.data() + local + 30 + nameLen;
+        TEST_ASSERT_EQUAL_HEX32(crc32Update(0, data, size), crc);
+        const uint8_t* desc = data + size;
+        TEST_ASSERT_EQUAL_HEX32(0x08074B50, get32(desc));
+        TEST_ASSERT_EQUAL_HEX32(crc, get32(desc + 4));
+        cd += ZIP_CENTRAL_HEADER_SIZE + nameLen;
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_crc32_checkValue);
+    RUN_TEST(test_crc32_emptyIsZero);
+    RUN_TEST(test_crc32_knownStrings);
+    RUN_TEST(test_crc32_continuesAcrossChunks);
+    RUN_TEST(test_dosTime_knownDate);
+    RUN_TEST(test_dosTime_clampsBefore1980);
+    RUN_TEST(test_dosTime_endOfYear);
+    RUN_TEST(test_localHeader_layout);
+    RUN_TEST(test_centralHeader_layout);
+    RUN_TEST(test_archiveSize_matchesBuiltArchive);
+    RUN_TEST(test_archiveSize_refusesZip64);
+    RUN_TEST(test_archive_centralDirectoryPointsAtEntries);
+
+    return UNITY_END();
+}